@@ -5,25 +5,50 @@
 // Dictionary is a lightweight handle (shared_ptr to DictionaryStorage), so
 // copies share the same underlying data — matching C# reference semantics.
 //
-// Uses chained hashing with a separate buckets vector and an append-only
-// entries vector.  New entries are always appended at entries[count++],
-// so iteration over entries[0..count-1] yields insertion order.  Each
-// bucket holds the index of the first entry in its chain; entries are
-// linked via their `next` field (-1 = end of chain, -2 = removed/hole).
+// Storage is split in two:
 //
-// On resize, entries are copied in index order and holes are compacted,
-// preserving insertion order.  On remove, the entry is unlinked from its
-// bucket chain and marked as a hole (next = -2); freeCount tracks the
-// number of holes so that Count() returns count - freeCount.
+//   entries  the key/value pairs, in insertion order.  New entries are always
+//            appended, so iterating entries[0..count-1] yields insertion
+//            order.  Remove leaves a hole (hashCode = -1) rather than moving
+//            anything, so an entry's index is stable until the next rebuild.
 //
-// See also: value_map.c, which uses the same algorithm for the runtime
-// MiniScript map type (with GC-allocated arrays instead of std::vector).
+//   index    an open-addressing table in the style of Abseil's Swiss tables:
+//            one control byte per slot (EMPTY, DELETED, or the top 7 bits of
+//            the key's mixed hash, "H2"), plus the entry index stored in that
+//            slot.  Slots come in groups of 16 and a probe examines a whole
+//            group at once -- one SSE2 (or NEON) compare finds every slot
+//            whose H2 matches, and only those entries have their full hash
+//            and key compared.  Groups are visited in triangular order, which
+//            reaches every group of a power-of-two table.
+//
+// Small dictionaries have no index at all: with at most kDictLinearMax
+// entries, a lookup is a linear scan of the entries comparing the stored hash
+// first.  That is as fast as probing at this size, and most MiniScript maps
+// (objects, small records) never grow past it.  The index is built when the
+// entries outgrow the linear layout, and rebuilt (with holes compacted out of
+// the entries, preserving order) whenever it runs out of room.
+//
+// The position accessors (KeyAtPosition / ValueAtPosition) let the runtime's
+// GCMap walk a map by position in enumeration order, as it does in C#, in
+// O(1) per step; see GCMap in GCItems.cs.  A position is not an entry index:
+// positions count live entries only, so removing a key shifts the ones after
+// it down by one, and compacting the entries changes none of them.
 
 #pragma once
 #include <memory>
 #include <vector>
 #include <initializer_list>
 #include <utility>  // for std::pair
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define DICT_GROUP_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+	#define DICT_GROUP_NEON 1
+#endif
 
 namespace MiniScript {
 
@@ -37,15 +62,16 @@ struct Value;  // defined in value.h; needed for the Hash/DictKeyEqual overloads
 // Forward declaration
 template<typename TKey, typename TValue> class Dictionary;
 
-// Entry for hash table
+// Entry in insertion order.  hashCode is the key's (non-negative) hash, or
+// -1 for a hole left by Remove.
 template<typename TKey, typename TValue>
 struct DictEntry {
 	TKey key;
 	TValue value;
-	int next;  // Index of next entry in chain, or -1
 	int hashCode;
 
-	DictEntry() : next(-1), hashCode(0) {}
+	DictEntry() : hashCode(-1) {}
+	DictEntry(const TKey& k, const TValue& v, int h) : key(k), value(v), hashCode(h) {}
 };
 
 // Hash functions for different key types
@@ -73,67 +99,294 @@ template<typename T>
 inline bool DictKeyEqual(const T& a, const T& b) { return a == b; }
 bool DictKeyEqual(Value a, Value b);
 
+// ── Control-byte groups ───────────────────────────────────────────────────
+// A control byte is EMPTY, DELETED, or (high bit clear) the H2 tag of the key
+// in that slot.  EMPTY ends a probe; DELETED (left by Remove) does not.
+
+static const uint8_t kDictCtrlEmpty   = 0x80;
+static const uint8_t kDictCtrlDeleted = 0xFE;
+static const int     kDictGroupWidth  = 16;
+static const int     kDictLinearMax   = 8;   // max entries with no index
+
+// Index of the lowest set bit of a nonzero mask.
+inline int DictLowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(mask);
+#else
+	int i = 0;
+	while (!(mask & 1)) { mask >>= 1; i++; }
+	return i;
+#endif
+}
+
+// Sixteen control bytes, loaded once and matched as a unit.  Each Match*
+// returns a bitmask with bit i set when byte i qualifies.
+struct DictCtrlGroup {
+#if DICT_GROUP_SSE2
+	__m128i ctrl;
+	explicit DictCtrlGroup(const uint8_t* p)
+		: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+	uint32_t Match(uint8_t h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+	}
+	uint32_t MatchEmpty() const { return Match(kDictCtrlEmpty); }
+	// EMPTY and DELETED are the only bytes with the high bit set.
+	uint32_t MatchEmptyOrDeleted() const { return (uint32_t)_mm_movemask_epi8(ctrl); }
+#elif DICT_GROUP_NEON
+	uint8x16_t ctrl;
+	explicit DictCtrlGroup(const uint8_t* p) : ctrl(vld1q_u8(p)) {}
+	// NEON has no movemask: weight each lane by its bit, then sum each half.
+	static uint32_t ToMask(uint8x16_t lanes) {
+		static const uint8_t kBits[16] = {1,2,4,8,16,32,64,128, 1,2,4,8,16,32,64,128};
+		uint8x16_t m = vandq_u8(lanes, vld1q_u8(kBits));
+		return (uint32_t)vaddv_u8(vget_low_u8(m)) | ((uint32_t)vaddv_u8(vget_high_u8(m)) << 8);
+	}
+	uint32_t Match(uint8_t h2) const { return ToMask(vceqq_u8(ctrl, vdupq_n_u8(h2))); }
+	uint32_t MatchEmpty() const { return Match(kDictCtrlEmpty); }
+	uint32_t MatchEmptyOrDeleted() const {
+		return ToMask(vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(ctrl), 7)));
+	}
+#else
+	uint8_t ctrl[kDictGroupWidth];
+	explicit DictCtrlGroup(const uint8_t* p) { memcpy(ctrl, p, kDictGroupWidth); }
+	uint32_t Match(uint8_t h2) const {
+		uint32_t m = 0;
+		for (int i = 0; i < kDictGroupWidth; i++) if (ctrl[i] == h2) m |= 1u << i;
+		return m;
+	}
+	uint32_t MatchEmpty() const { return Match(kDictCtrlEmpty); }
+	uint32_t MatchEmptyOrDeleted() const {
+		uint32_t m = 0;
+		for (int i = 0; i < kDictGroupWidth; i++) if (ctrl[i] & 0x80) m |= 1u << i;
+		return m;
+	}
+#endif
+};
+
+// Split a key hash into the starting group (H1) and the 7-bit tag (H2).
+// Hash(int) is the identity, so mix first: otherwise sequential integer keys
+// would share a tag and defeat the group filter.
+inline uint32_t DictMix(int hashCode) {
+	return (uint32_t)hashCode * 0x9E3779B1u;
+}
+inline uint32_t DictH1(uint32_t mixed) { return mixed >> 7; }
+inline uint8_t  DictH2(uint32_t mixed) { return (uint8_t)(mixed >> 25); }
+
 // Shared storage for Dictionary — holds all mutable state so that
 // copied Dictionary handles see the same data (C# reference semantics).
 template<typename TKey, typename TValue>
 class DictionaryStorage {
 	friend class Dictionary<TKey, TValue>;
   public:
-	DictionaryStorage() : count(0), freeCount(0) {}
+	DictionaryStorage() : freeCount(0), groupMask(0), growthLeft(0), cursorPos(-1), cursorEntry(0) {}
   private:
-	std::vector<int> buckets;
-	std::vector<DictEntry<TKey, TValue> > entries;
-	int count;      // high-water mark: next free index in entries[]
-	int freeCount;  // number of removed entries (holes)
-
-	void createStorage(int initialCapacity) {
-		if (initialCapacity < 4) initialCapacity = 4;
-		buckets.assign(initialCapacity, -1);
-		entries.resize(initialCapacity);
-		count = 0;
+	std::vector<DictEntry<TKey, TValue> > entries;  // insertion order, with holes
+	int freeCount;  // number of holes in entries
+
+	// The index; both vectors are empty while the dictionary is linear.
+	std::vector<uint8_t> ctrl;   // one control byte per slot
+	std::vector<int> slots;      // entry index held in each full slot
+	int groupMask;               // (number of groups) - 1
+	int growthLeft;              // EMPTY slots we may still fill before a rebuild
+
+	// Where the last entryAtPosition lookup landed (cursorPos -1: nowhere),
+	// so a walk in order costs O(1) per step even with holes.  Only used
+	// while there are holes; without them a position is its entry index.
+	mutable int cursorPos;
+	mutable int cursorEntry;
+
+	int count() const { return static_cast<int>(entries.size()); }
+
+	// Make room for `capacity` live entries without further rebuilds.
+	void reserve(int capacity) {
+		entries.reserve(capacity);
+		if (capacity <= kDictLinearMax) return;
+		if (ctrl.empty() || growthLeft < capacity - (count() - freeCount)) rebuildIndex(capacity);
+	}
+
+	// Become a copy of `src`.  Without holes this is three straight vector
+	// copies (memcpy-class for trivially copyable keys and values), since the
+	// index refers to entries by position; otherwise copy the live entries
+	// and rebuild the index for them.
+	void copyFrom(const DictionaryStorage<TKey, TValue>& src) {
+		cursorPos = -1;
+		if (src.freeCount == 0) {
+			entries = src.entries;
+			freeCount = 0;
+			ctrl = src.ctrl;
+			slots = src.slots;
+			groupMask = src.groupMask;
+			growthLeft = src.growthLeft;
+			return;
+		}
+		entries.clear();
+		entries.reserve(src.count() - src.freeCount);
+		for (int i = 0; i < src.count(); i++) {
+			if (src.entries[i].hashCode >= 0) entries.push_back(src.entries[i]);
+		}
 		freeCount = 0;
+		dropIndex();
+		if (count() > kDictLinearMax) rebuildIndex(count());
+	}
+
+	// Find the slot holding entry `entryIdx` (which must be indexed).
+	int findSlot(int entryIdx) const {
+		uint32_t mixed = DictMix(entries[entryIdx].hashCode);
+		uint8_t h2 = DictH2(mixed);
+		uint32_t g = DictH1(mixed) & groupMask;
+		for (uint32_t step = 1; ; step++) {
+			const uint8_t* base = &ctrl[g * kDictGroupWidth];
+			for (uint32_t m = DictCtrlGroup(base).Match(h2); m; m &= m - 1) {
+				int slot = (int)(g * kDictGroupWidth) + DictLowestBit(m);
+				if (slots[slot] == entryIdx) return slot;
+			}
+			g = (g + step) & groupMask;
+		}
 	}
 
-	void resize() {
-		int oldCapacity = static_cast<int>(buckets.size());
-		int newCapacity = oldCapacity * 2;
-		if (newCapacity < 4) newCapacity = 4;
-
-		std::vector<int> newBuckets(newCapacity, -1);
-		std::vector<DictEntry<TKey, TValue> > newEntries(newCapacity);
-
-		// Rehash entries in index order to preserve insertion order
-		int newIndex = 0;
-		for (int i = 0; i < count; i++) {
-			if (entries[i].next == -2) continue;  // skip removed entries
-			int newBucket = entries[i].hashCode % newCapacity;
-			newEntries[newIndex].key = entries[i].key;
-			newEntries[newIndex].value = entries[i].value;
-			newEntries[newIndex].hashCode = entries[i].hashCode;
-			newEntries[newIndex].next = newBuckets[newBucket];
-			newBuckets[newBucket] = newIndex;
-			newIndex++;
+	// Put entry `entryIdx` into the first EMPTY or DELETED slot on its probe
+	// path.  Only reusing an EMPTY slot consumes growth.
+	void insertIntoIndex(int entryIdx) {
+		uint32_t mixed = DictMix(entries[entryIdx].hashCode);
+		uint32_t g = DictH1(mixed) & groupMask;
+		for (uint32_t step = 1; ; step++) {
+			uint32_t m = DictCtrlGroup(&ctrl[g * kDictGroupWidth]).MatchEmptyOrDeleted();
+			if (m) {
+				int slot = (int)(g * kDictGroupWidth) + DictLowestBit(m);
+				if (ctrl[slot] == kDictCtrlEmpty) growthLeft--;
+				ctrl[slot] = DictH2(mixed);
+				slots[slot] = entryIdx;
+				return;
+			}
+			g = (g + step) & groupMask;
 		}
+	}
 
-		buckets = std::move(newBuckets);
-		entries = std::move(newEntries);
-		count = newIndex;
+	// Squeeze the holes out of entries, keeping order.
+	void compactEntries() {
+		if (freeCount == 0) return;
+		int n = count(), dst = 0;
+		for (int i = 0; i < n; i++) {
+			if (entries[i].hashCode < 0) continue;
+			if (dst != i) entries[dst] = std::move(entries[i]);
+			dst++;
+		}
+		entries.resize(dst);
 		freeCount = 0;
+		cursorPos = -1;
+	}
+
+	// Compact the entries and build a fresh index with room for at least
+	// `minCapacity` live entries at a 7/8 maximum load.
+	void rebuildIndex(int minCapacity) {
+		compactEntries();
+		int n = count();
+		if (minCapacity < n) minCapacity = n;
+		int slotCount = kDictGroupWidth;
+		while (slotCount * 7 / 8 < minCapacity) slotCount *= 2;
+		ctrl.assign(slotCount, kDictCtrlEmpty);
+		slots.assign(slotCount, -1);
+		groupMask = slotCount / kDictGroupWidth - 1;
+		growthLeft = slotCount * 7 / 8;
+		for (int i = 0; i < n; i++) insertIntoIndex(i);
+	}
+
+	void dropIndex() {
+		ctrl.clear();
+		slots.clear();
+		groupMask = 0;
+		growthLeft = 0;
 	}
 
 	int findEntry(const TKey& key) const {
-		if (buckets.empty()) return -1;
+		return findEntry(key, Hash(key) & 0x7FFFFFFF);
+	}
 
-		int hashCode = Hash(key);
-		int capacity = static_cast<int>(buckets.size());
-		int bucket = hashCode % capacity;
+	int findEntry(const TKey& key, int hashCode) const {
+		if (ctrl.empty()) {
+			int n = count();
+			for (int i = 0; i < n; i++) {
+				if (entries[i].hashCode == hashCode && DictKeyEqual(entries[i].key, key)) return i;
+			}
+			return -1;
+		}
+		uint32_t mixed = DictMix(hashCode);
+		uint8_t h2 = DictH2(mixed);
+		uint32_t g = DictH1(mixed) & groupMask;
+		for (uint32_t step = 1; ; step++) {
+			DictCtrlGroup group(&ctrl[g * kDictGroupWidth]);
+			for (uint32_t m = group.Match(h2); m; m &= m - 1) {
+				int e = slots[g * kDictGroupWidth + DictLowestBit(m)];
+				if (entries[e].hashCode == hashCode && DictKeyEqual(entries[e].key, key)) return e;
+			}
+			if (group.MatchEmpty()) return -1;
+			g = (g + step) & groupMask;
+		}
+	}
+
+	// Append a brand-new entry; the key must not already be present.
+	// Returns its entry index.
+	int addNewEntry(const TKey& key, const TValue& value) {
+		return addNewEntry(key, value, Hash(key) & 0x7FFFFFFF);
+	}
 
-		for (int i = buckets[bucket]; i >= 0; i = entries[i].next) {
-			if (entries[i].hashCode == hashCode && DictKeyEqual(entries[i].key, key)) {
-				return i;
+	int addNewEntry(const TKey& key, const TValue& value, int hashCode) {
+		if (ctrl.empty()) {
+			if (count() >= kDictLinearMax) {
+				if (freeCount > 0) compactEntries();
+				if (count() >= kDictLinearMax) rebuildIndex((count() + 1) * 2);
 			}
+		} else if (growthLeft == 0) {
+			// Out of EMPTY slots.  Double, unless DELETED slots make up at
+			// least half the load, in which case a same-size rebuild clears them.
+			int live = count() - freeCount;
+			int capacity = static_cast<int>(ctrl.size()) * 7 / 8;
+			rebuildIndex(live * 2 > capacity ? capacity * 2 : capacity);
 		}
-		return -1;
+		entries.push_back(DictEntry<TKey, TValue>(key, value, hashCode));
+		int idx = count() - 1;
+		if (!ctrl.empty()) insertIntoIndex(idx);
+		return idx;
+	}
+
+	void removeEntry(int idx) {
+		if (!ctrl.empty()) ctrl[findSlot(idx)] = kDictCtrlDeleted;
+		if (cursorPos >= 0) {
+			if (idx < cursorEntry) cursorPos--;
+			else if (idx == cursorEntry) cursorPos = -1;
+		}
+		entries[idx].key = TKey();
+		entries[idx].value = TValue();
+		entries[idx].hashCode = -1;
+		freeCount++;
+		// Trailing holes can simply be dropped (and usually are: removing the
+		// most recently added key is common).  This never moves a live entry.
+		while (!entries.empty() && entries.back().hashCode < 0) {
+			entries.pop_back();
+			freeCount--;
+		}
+	}
+
+	// Index of the live entry at position `pos` in enumeration order, or -1.
+	int entryAtPosition(int pos) const {
+		int n = count();
+		if (pos < 0 || pos >= n - freeCount) return -1;
+		if (freeCount == 0) return pos;
+		int p = 0, e = 0;
+		if (cursorPos >= 0 && cursorPos <= pos) {
+			p = cursorPos;
+			e = cursorEntry;
+		} else {
+			while (entries[e].hashCode < 0) e++;
+		}
+		while (p < pos) {
+			e++;
+			while (entries[e].hashCode < 0) e++;
+			p++;
+		}
+		cursorPos = p;
+		cursorEntry = e;
+		return e;
 	}
 };
 
@@ -144,12 +397,7 @@ private:
 	std::shared_ptr<DictionaryStorage<TKey, TValue> > data;
 
 	void ensureData() {
-		if (!data) {
-			data = std::make_shared<DictionaryStorage<TKey, TValue> >();
-			data->createStorage(4);
-		} else if (data->buckets.empty()) {
-			data->createStorage(4);
-		}
+		if (!data) data = std::make_shared<DictionaryStorage<TKey, TValue> >();
 	}
 
 public:
@@ -158,14 +406,19 @@ public:
 
     // Factory method - allocates (matches C# "new Dictionary<K,V>()").
     // `initialCapacity` is sized so that that many items can be inserted
-    // without triggering a resize (table resizes at 75% load, so we scale
-    // up by 4/3); minimum allocated capacity is 4.
+    // without triggering a resize.
     static Dictionary<TKey, TValue> New(int initialCapacity = 0) {
         Dictionary<TKey, TValue> result;
         result.data = std::make_shared<DictionaryStorage<TKey, TValue> >();
-        int cap = initialCapacity * 4 / 3 + 1;
-        if (cap < 4) cap = 4;
-        result.data->createStorage(cap);
+        if (initialCapacity > 0) result.data->reserve(initialCapacity);
+        return result;
+    }
+
+    // Factory method - copies (matches C# "new Dictionary<K,V>(other)").
+    static Dictionary<TKey, TValue> New(const Dictionary<TKey, TValue>& other) {
+        Dictionary<TKey, TValue> result;
+        result.data = std::make_shared<DictionaryStorage<TKey, TValue> >();
+        if (other.data) result.data->copyFrom(*other.data);
         return result;
     }
 
@@ -192,62 +445,29 @@ public:
 
 	// Properties
 	int Count() const {
-		return data ? data->count - data->freeCount : 0;
+		return data ? data->count() - data->freeCount : 0;
 	}
 
 	bool Empty() const { return Count() == 0; }
 
-private:
-	// Insert a brand-new entry for `key`. ASSUMES the key does not already
-	// exist in the dictionary; callers must guarantee this (e.g. operator[]
-	// only calls this after findEntry has failed). Does not check for or
-	// update an existing entry.
-	void AddNewEntry(const TKey& key, const TValue& value) {
-		ensureData();
-
-		int hashCode = Hash(key);
-		int capacity = static_cast<int>(data->buckets.size());
-		int bucket = hashCode % capacity;
-
-		// Add new entry - resize if needed (use threshold = 3/4 of capacity)
-		if (data->count * 4 >= capacity * 3) {
-			data->resize();
-			capacity = static_cast<int>(data->buckets.size());
-			bucket = hashCode % capacity;
-		}
-
-		int index = data->count;
-		data->entries[index].key = key;
-		data->entries[index].value = value;
-		data->entries[index].hashCode = hashCode;
-		data->entries[index].next = data->buckets[bucket];
-		data->buckets[bucket] = index;
-		data->count++;
-	}
-
-public:
 	// Indexer - get value by key (returns default if not found)
 	TValue& operator[](const TKey& key) {
 		ensureData();
 		int index = data->findEntry(key);
-		if (index >= 0) {
-			return data->entries[index].value;
+		if (index < 0) {
+			// Key not found - add with default value, and return a reference
+			// to the value in the map so that it can be assigned to.
+			index = data->addNewEntry(key, TValue());
 		}
-		// Key not found - add with default value, then look it up
-		// again and return a reference to the value in the map
-		// so that it can be assigned to.
-		static TValue defaultValue = TValue();
-		AddNewEntry(key, defaultValue);
-		index = data->findEntry(key);
-		if (index >= 0) {
-			return data->entries[index].value;
-		}
-		return defaultValue;
+		return data->entries[index].value;
 	}
 
 	// SetValue - add or update, MS1-compatible alias for `dict[key] = value`.
 	void SetValue(const TKey& key, const TValue& value) {
-		(*this)[key] = value;
+		ensureData();
+		int index = data->findEntry(key);
+		if (index >= 0) data->entries[index].value = value;
+		else data->addNewEntry(key, value);
 	}
 
 	const TValue& operator[](const TKey& key) const {
@@ -293,37 +513,63 @@ public:
 	// Remove
 	bool Remove(const TKey& key) {
 		if (!data) return false;
+		int index = data->findEntry(key);
+		if (index < 0) return false;
+		data->removeEntry(index);
+		return true;
+	}
 
-		int hashCode = Hash(key);
-		int capacity = static_cast<int>(data->buckets.size());
-		int bucket = hashCode % capacity;
-
-		int last = -1;
-		for (int i = data->buckets[bucket]; i >= 0; last = i, i = data->entries[i].next) {
-			if (data->entries[i].hashCode == hashCode && DictKeyEqual(data->entries[i].key, key)) {
-				if (last < 0) {
-					data->buckets[bucket] = data->entries[i].next;
-				} else {
-					data->entries[last].next = data->entries[i].next;
-				}
-				data->entries[i].next = -2;  // Mark as removed
-				data->freeCount++;
-				return true;
-			}
+	// EnsureCapacity - make room for `capacity` entries in all; returns the
+	// capacity, like C#'s.
+	int EnsureCapacity(int capacity) {
+		ensureData();
+		data->reserve(capacity);
+		return capacity > Count() ? capacity : Count();
+	}
+
+	// SetAll - store every entry of `other` here, as if by `this[k] = v` in
+	// other's order.  Room is made once up front, and other's stored hashes
+	// are reused rather than recomputed.  (No C# equivalent; C# callers loop.)
+	void SetAll(const Dictionary<TKey, TValue>& other) {
+		if (!other.data || other.data == data) return;
+		ensureData();
+		const DictionaryStorage<TKey, TValue>& src = *other.data;
+		data->reserve(Count() + other.Count());
+		for (int i = 0; i < src.count(); i++) {
+			const DictEntry<TKey, TValue>& e = src.entries[i];
+			if (e.hashCode < 0) continue;
+			int index = data->findEntry(e.key, e.hashCode);
+			if (index >= 0) data->entries[index].value = e.value;
+			else data->addNewEntry(e.key, e.value, e.hashCode);
 		}
-		return false;
 	}
 
 	// Clear
 	void Clear() {
 		if (!data) return;
-
-		int capacity = static_cast<int>(data->buckets.size());
-		for (int i = 0; i < capacity; i++) {
-			data->buckets[i] = -1;
-		}
-		data->count = 0;
+		data->entries.clear();
 		data->freeCount = 0;
+		data->cursorPos = -1;
+		data->dropIndex();
+	}
+
+	// ── Position access ─────────────────────────────────────────────────
+	// Position i is the i-th key or value in enumeration order, as C# code
+	// reaches it by counting through Keys or Values (see GCMap).  Stepping
+	// through positions in order is O(1) per step.  Not for use from more
+	// than one thread at once unless the dictionary has no holes (the
+	// lookup moves a cursor).
+
+	// Key or value at position `i`; the default for a position out of range.
+	TKey KeyAtPosition(int i) const {
+		int e = data ? data->entryAtPosition(i) : -1;
+		if (e < 0) return TKey();
+		return data->entries[e].key;
+	}
+	TValue ValueAtPosition(int i) const {
+		int e = data ? data->entryAtPosition(i) : -1;
+		if (e < 0) return TValue();
+		return data->entries[e].value;
 	}
 
 	// Iterator support - simple key iteration
@@ -334,7 +580,7 @@ public:
 
 		void findNext() {
 			if (!storage) return;
-			while (index < storage->count && storage->entries[index].next < -1) {
+			while (index < storage->count() && storage->entries[index].hashCode < 0) {
 				index++;
 			}
 		}
@@ -366,7 +612,7 @@ public:
 		KeyCollection(const DictionaryStorage<TKey, TValue>* s) : storage(s) {}
 		KeyIterator begin() const { return KeyIterator(storage, 0); }
 		KeyIterator end() const {
-			return KeyIterator(storage, storage ? storage->count : 0);
+			return KeyIterator(storage, storage ? storage->count() : 0);
 		}
 	};
 
@@ -385,7 +631,7 @@ public:
 
 		void findNext() {
 			if (!storage) return;
-			while (index < storage->count && storage->entries[index].next < -1) {
+			while (index < storage->count() && storage->entries[index].hashCode < 0) {
 				index++;
 			}
 		}
@@ -417,7 +663,7 @@ public:
 		ValueCollection(const DictionaryStorage<TKey, TValue>* s) : storage(s) {}
 		ValueIterator begin() const { return ValueIterator(storage, 0); }
 		ValueIterator end() const {
-			return ValueIterator(storage, storage ? storage->count : 0);
+			return ValueIterator(storage, storage ? storage->count() : 0);
 		}
 	};
 
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <vector>
 #include <initializer_list>
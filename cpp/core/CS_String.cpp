@@ -23,6 +23,7 @@ StringStorageSPtr ss_createShared(int byteLen) {
     rawPtr->lenB = byteLen;
     rawPtr->lenC = -1;  // Will be computed when needed
     rawPtr->hash = 0;   // Will be computed when needed
+    rawPtr->cursor = 0;
     rawPtr->data[byteLen] = '\0';  // Ensure null termination
 
     return std::shared_ptr<StringStorage>(rawPtr, [](StringStorage* p) { ::free(p); });
@@ -39,6 +40,7 @@ StringStorageSPtr ss_createShared(const char *cstr, int byteLen) {
     rawPtr->lenB = byteLen;
     rawPtr->lenC = -1;  // Will be computed when needed
     rawPtr->hash = 0;   // Will be computed when needed
+    rawPtr->cursor = 0;
     memcpy(rawPtr->data, cstr, byteLen);
     rawPtr->data[byteLen] = '\0';  // Ensure null termination
 
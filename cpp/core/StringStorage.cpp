@@ -27,8 +27,7 @@ StringStorage* ss_create(const char* cstr, StringStorageAllocator allocator) {
     storage->lenB = len;
     storage->lenC = -1;  // Compute lazily when needed
     storage->hash = 0;   // Compute lazily when needed
-    storage->cursorCharIdx = 0;
-    storage->cursorByteIdx = 0;
+    storage->cursor = 0;
     strcpy(storage->data, cstr);
     
     return storage;
@@ -46,8 +45,7 @@ StringStorage* ss_createWithLength(int byteLen, StringStorageAllocator allocator
     storage->lenB = byteLen;
     storage->lenC = -1;  // Will be computed when needed
     storage->hash = 0;   // Will be computed when needed
-    storage->cursorCharIdx = 0;
-    storage->cursorByteIdx = 0;
+    storage->cursor = 0;
     storage->data[byteLen] = '\0';  // Ensure null termination
     
     return storage;
@@ -66,14 +64,15 @@ int ss_lengthC(const StringStorage* storage) {
     if (!storage) return 0;
     
     // If character count hasn't been computed yet, compute and cache it
-    if (storage->lenC < 0) {
+    int lenC = SS_LOAD(storage->lenC);
+    if (lenC < 0) {
         // We need to cast away const to cache the result
         StringStorage* mutable_storage = (StringStorage*)storage;
-        mutable_storage->lenC = UTF8CharacterCount(
-          (const unsigned char*)storage->data, storage->lenB);
+        lenC = UTF8CharacterCount((const unsigned char*)storage->data, storage->lenB);
+        SS_STORE(mutable_storage->lenC, lenC);
     }
     
-    return storage->lenC;
+    return lenC;
 }
 
 bool ss_isEmpty(const StringStorage* storage) {
@@ -89,7 +88,7 @@ uint32_t ss_codePointAt(const StringStorage* storage, int charIndex) {
     if (!storage || charIndex < 0) return 0;
 
     // Fast path: ASCII-only string (all chars are single bytes)
-    if (storage->lenC >= 0 && storage->lenC == storage->lenB) {
+    if (SS_LOAD(storage->lenC) == storage->lenB) {
         if (charIndex >= storage->lenB) return 0;
         return (uint32_t)(unsigned char)storage->data[charIndex];
     }
@@ -101,18 +100,23 @@ uint32_t ss_codePointAt(const StringStorage* storage, int charIndex) {
     unsigned char* end = base + storage->lenB;
     unsigned char* ptr;
 
+    // The cursor's two halves are read and written together, so a cursor
+    // left by another thread is stale at worst, never mismatched.
+    uint64_t cursor = SS_LOAD(mut->cursor);
+    int cursorCharIdx = (int)(cursor >> 32);
+    int cursorByteIdx = (int)(uint32_t)cursor;
     int distFromStart = charIndex;
-    int distFromCursor = charIndex - mut->cursorCharIdx;
+    int distFromCursor = charIndex - cursorCharIdx;
 
     if (distFromCursor == 0) {
-        ptr = base + mut->cursorByteIdx;
+        ptr = base + cursorByteIdx;
     } else if (distFromCursor > 0 && distFromCursor < distFromStart) {
         // Forward from cursor is shorter than scanning from the start
-        ptr = base + mut->cursorByteIdx;
+        ptr = base + cursorByteIdx;
         AdvanceUTF8(&ptr, end, distFromCursor);
     } else if (distFromCursor < 0 && (-distFromCursor) < distFromStart) {
         // Backward from cursor is shorter than scanning from the start
-        ptr = base + mut->cursorByteIdx;
+        ptr = base + cursorByteIdx;
         BackupUTF8(&ptr, base, -distFromCursor);
     } else {
         ptr = base;
@@ -121,8 +125,7 @@ uint32_t ss_codePointAt(const StringStorage* storage, int charIndex) {
 
     if (ptr < base || ptr >= end) return 0;
 
-    mut->cursorCharIdx = charIndex;
-    mut->cursorByteIdx = (int)(ptr - base);
+    SS_STORE(mut->cursor, ((uint64_t)(uint32_t)charIndex << 32) | (uint32_t)(ptr - base));
 
     return (uint32_t)UTF8Decode(ptr);
 }
@@ -313,7 +316,7 @@ StringStorage* ss_toLower(const StringStorage* storage, StringStorageAllocator a
     if (!result) return NULL;
     memcpy(result->data, newBuf, (size_t)newLenB);
     result->lenB = newLenB;
-    result->lenC = storage->lenC;  // (assume same number of characters)
+    result->lenC = SS_LOAD(storage->lenC);  // (assume same number of characters)
     
     return result;
 }
@@ -340,7 +343,7 @@ StringStorage* ss_toUpper(const StringStorage* storage, StringStorageAllocator a
     if (!result) return NULL;
     memcpy(result->data, newBuf, (size_t)newLenB);
     result->lenB = newLenB;
-    result->lenC = storage->lenC;  // (assume same number of characters)
+    result->lenC = SS_LOAD(storage->lenC);  // (assume same number of characters)
     
     return result;
 }
@@ -527,7 +530,7 @@ static StringStorage* ss_copyOf(const StringStorage* storage, StringStorageAlloc
     if (!result) return NULL;  // (empty, or out of memory)
 
     memcpy(result->data, storage->data, storage->lenB);
-    result->lenC = storage->lenC;  // same bytes, so same character count
+    result->lenC = SS_LOAD(storage->lenC);  // same bytes, so same character count
     return result;
 }
 
@@ -22,11 +22,18 @@ typedef struct StringStorage {
     int lenB;           // Length in bytes
     int lenC;           // Length in characters (UTF-8); -1 if not yet computed
     uint32_t hash;      // String hash for fast comparison; 0 if not yet computed
-    int cursorCharIdx;  // Most recently accessed character index (for sequential access)
-    int cursorByteIdx;  // Byte offset corresponding to cursorCharIdx
+    uint64_t cursor;    // Most recently accessed character index (high 32 bits) and its byte offset (low 32)
     char data[];        // Flexible array member for string data
 } StringStorage;
 
+// lenC, hash and cursor are caches, filled in lazily by readers -- and a
+// string may be read from more than one thread at once (a host String
+// constant, say, by two isolates compiling).  So they are read and written
+// with relaxed atomics: free on the usual hardware, but no torn values, and
+// any thread that fills one in computes the same answer.
+#define SS_LOAD(field) __atomic_load_n(&(field), __ATOMIC_RELAXED)
+#define SS_STORE(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELAXED)
+
 // Allocator function type for StringStorage
 // size: total number of bytes to allocate (sizeof(StringStorage) + stringLenB + 1)
 // Returns: allocated memory block, or NULL on failure
@@ -99,12 +106,16 @@ StringStorage** ss_splitStr(const StringStorage* storage, const StringStorage* s
 uint32_t ss_computeHash(const StringStorage* storage);
 static inline uint32_t ss_hash(StringStorage* storage) {
 	if (!storage) return 0;
-	if (storage->hash == 0) storage->hash = ss_computeHash(storage);
-	return storage->hash;
+	uint32_t h = SS_LOAD(storage->hash);
+	if (h == 0) {
+		h = ss_computeHash(storage);
+		SS_STORE(storage->hash, h);
+	}
+	return h;
 }
 inline void ss_ensureHashComputed(StringStorage* storage) {
-    if (storage && storage->hash == 0) {
-        storage->hash = ss_computeHash(storage);
+    if (storage && SS_LOAD(storage->hash) == 0) {
+        SS_STORE(storage->hash, ss_computeHash(storage));
     }
 }
 
@@ -25,6 +25,8 @@
 // the lifetime above.  Nested / re-entrant callbacks (e.g. VM::RunFunction)
 // nest correctly: each invocation saves its own Mark and restores it on exit,
 // so an inner call's Reset never frees an outer call's still-live pointers.
+// The one exception is a simple intrinsic (Intrinsic.SimpleCode), which is
+// called without a bracket and so must not use c_str() at all.
 //
 // This file is the ONLY owner of that storage.  Value::c_str() (and any future
 // Context::GetArgCStr helper) must be thin wrappers over Copy(); nothing else
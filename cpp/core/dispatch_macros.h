@@ -42,6 +42,7 @@
 	X(LOADC_rA_rB_kC) \
 	X(LOADV_rA_rB_rC) \
 	X(LOADC_rA_rB_rC) \
+	X(LOADC_rA_rB) \
 	X(FUNCREF_iA_iBC) \
 	X(ASSIGN_rA_rB_kC) \
 	X(NAME_rA_kBC) \
@@ -101,12 +102,14 @@
 	X(IFEQ_rA_iBC) \
 	X(IFNE_rA_rB) \
 	X(IFNE_rA_iBC) \
+	X(IFFUNC_rA_kBC) \
 	X(NEXT_rA_rB) \
 	X(ARGBLK_iABC) \
 	X(ARG_rA) \
 	X(ARG_iABC) \
 	X(CALLF_iA_iBC) \
 	X(CALL_rA_rB_rC) \
+	X(CALLINTRINSIC_rA_rB_iC) \
 	X(RETURN) \
 	X(NEW_rA_rB) \
 	X(ISA_rA_rB_rC) \
@@ -115,6 +118,7 @@
 	X(SETSELF_rA) \
 	X(CALLIFREF_rA) \
 	X(ITERGET_rA_rB_rC) \
+	X(ITERNEXT_rA_rB_rC) \
 	X(ERRCHK_rA)
 
 
@@ -0,0 +1,78 @@
+// lex_scan.h - byte-level scanning helpers for the lexer (Lexer.cs).
+//
+// In C++ the lexer reads its source as UTF-8 bytes, by byte offset, so that
+// reading a character or slicing out a token never has to count characters
+// from the start of the string.  These helpers find the end of a run of ASCII
+// bytes of one class; any byte outside the class (including every non-ASCII
+// byte) ends the run, and the lexer deals with it a character at a time.
+// Runs are short -- a typical identifier is a handful of bytes -- so a plain
+// loop does as well here as 16-byte vector compares.
+
+#ifndef LEX_SCAN_H
+#define LEX_SCAN_H
+
+#include <stdint.h>
+#include <string.h>
+
+// This file is part of Layer 0 (foundation utilities)
+#define CORE_LAYER_0
+
+namespace MiniScript {
+
+// Number of bytes in the UTF-8 sequence starting at src[pos], clipped to the
+// end of the buffer.  A stray continuation byte counts as one.
+static inline int LexCharSize(const char* src, int pos, int len) {
+	unsigned char b = (unsigned char)src[pos];
+	int size = 1;
+	if (b >= 0xF0) size = 4;
+	else if (b >= 0xE0) size = 3;
+	else if (b >= 0xC0) size = 2;
+	if (pos + size > len) size = len - pos;
+	return size < 1 ? 1 : size;
+}
+
+// The code point starting at src[pos], or 0 at or past the end.
+static inline uint32_t LexCharAt(const char* src, int pos, int len) {
+	if (pos >= len) return 0;
+	unsigned char b = (unsigned char)src[pos];
+	if (b < 0x80) return b;
+	int size = LexCharSize(src, pos, len);
+	if (size == 1) return b;
+	uint32_t c = (size == 2) ? (b & 0x1F) : (size == 3) ? (b & 0x0F) : (b & 0x07);
+	for (int i = 1; i < size; i++) c = (c << 6) | ((unsigned char)src[pos + i] & 0x3F);
+	return c;
+}
+
+// End of the run of ASCII identifier bytes (letters, digits, '_') at pos.
+static inline int LexScanIdentifier(const char* src, int pos, int len) {
+	while (pos < len) {
+		unsigned char b = (unsigned char)src[pos];
+		unsigned char lower = b | 0x20;
+		if (!((lower >= 'a' && lower <= 'z') || (b >= '0' && b <= '9') || b == '_')) break;
+		pos++;
+	}
+	return pos;
+}
+
+// End of the run of ASCII digits at pos.
+static inline int LexScanDigits(const char* src, int pos, int len) {
+	while (pos < len && (unsigned char)(src[pos] - '0') < 10) pos++;
+	return pos;
+}
+
+// End of the run of spaces and tabs at pos.
+static inline int LexScanBlanks(const char* src, int pos, int len) {
+	while (pos < len && (src[pos] == ' ' || src[pos] == '\t')) pos++;
+	return pos;
+}
+
+// Position of the first occurrence of byte ch at or after pos, or -1.
+static inline int LexFindByte(const char* src, int pos, int len, char ch) {
+	if (pos >= len) return -1;
+	const void* p = memchr(src + pos, ch, (size_t)(len - pos));
+	return p ? (int)((const char*)p - src) : -1;
+}
+
+}  // namespace MiniScript
+
+#endif
@@ -0,0 +1,67 @@
+#include "mapped_file.h"
+
+#include "layer_defs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MiniScript {
+#if LAYER_0_VIOLATIONS
+#error "mapped_file.h (Layer 0) cannot depend on any higher layer"
+#endif
+
+std::shared_ptr<MappedFile> MappedFile::Open(const char* path) {
+	std::shared_ptr<MappedFile> result(new MappedFile());
+#ifndef _WIN32
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return nullptr;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);   // the mapping stays valid without the descriptor
+	if (p == MAP_FAILED) return nullptr;
+	result->_data = (const uint8_t*)p;
+	result->_size = (size_t)st.st_size;
+	result->_mapped = true;
+#else
+	FILE* f = fopen(path, "rb");
+	if (!f) return nullptr;
+	long size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+	if (size <= 0 || fseek(f, 0, SEEK_SET) != 0) {
+		fclose(f);
+		return nullptr;
+	}
+	uint8_t* buf = (uint8_t*)malloc((size_t)size);
+	if (!buf || fread(buf, 1, (size_t)size, f) != (size_t)size) {
+		free(buf);
+		fclose(f);
+		return nullptr;
+	}
+	fclose(f);
+	result->_data = buf;
+	result->_size = (size_t)size;
+#endif
+	return result;
+}
+
+MappedFile::~MappedFile() {
+	if (!_data) return;
+#ifndef _WIN32
+	if (_mapped) {
+		munmap((void*)_data, _size);
+		return;
+	}
+#endif
+	free((void*)_data);
+}
+
+}  // namespace MiniScript
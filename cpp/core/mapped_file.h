@@ -0,0 +1,44 @@
+// mapped_file.h - read-only memory mapping of a whole file.
+//
+// Used by the bytecode cache (BytecodeCache.cs) so that a cache entry's
+// instructions can be executed straight out of the file.  A mapping is backed
+// by the OS page cache, so every process mapping the same file shares one
+// physical copy of it.
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+
+// This file is part of Layer 0 (foundation utilities)
+#define CORE_LAYER_0
+
+namespace MiniScript {
+
+class MappedFile {
+public:
+	// Map the whole of the file at path, or return null if it cannot be opened
+	// or is empty.  Where mmap is unavailable, the file is read into memory
+	// instead; callers cannot tell the difference.
+	static std::shared_ptr<MappedFile> Open(const char* path);
+
+	~MappedFile();
+
+	const uint8_t* Data() const { return _data; }
+	size_t Size() const { return _size; }
+
+private:
+	MappedFile() {}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const uint8_t* _data = nullptr;
+	size_t _size = 0;
+	bool _mapped = false;   // true: munmap on release; false: free
+};
+
+}  // namespace MiniScript
+
+#endif
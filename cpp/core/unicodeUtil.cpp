@@ -176,14 +176,13 @@ static unsigned short sLowerTable[] = {
 // sLowerTable is not sorted, so we can't binary-search it directly; instead we
 // build this auxiliary table once and sort it by lower value.
 typedef struct { unsigned short lower; unsigned short upper; } LowerUpperPair;
-static LowerUpperPair *sReverseLookupTable = NULL;
-static int sReverseLookupCount = 0;
+typedef struct { LowerUpperPair *pairs; int count; } ReverseLookupTable;
 
 static int compareLowerUpperPair(const void *a, const void *b) {
     return (int)((const LowerUpperPair*)a)->lower - (int)((const LowerUpperPair*)b)->lower;
 }
 
-static void buildReverseLookupTable(void) {
+static ReverseLookupTable buildReverseLookupTable(void) {
     LowerUpperPair *tmp = (LowerUpperPair *)malloc(CASE_TABLE_SIZE * sizeof(LowerUpperPair));
     int count = 0;
     for (int i = 0; i < CASE_TABLE_SIZE; i++) {
@@ -200,10 +199,15 @@ static void buildReverseLookupTable(void) {
         }
     }
     qsort(tmp, count, sizeof(LowerUpperPair), compareLowerUpperPair);
-    sReverseLookupTable = tmp;
-    sReverseLookupCount = count;
-    // Note: not thread-safe; concurrent first calls would both build identical
-    // tables, leaking one allocation. Acceptable for this use case.
+    ReverseLookupTable result = { tmp, count };
+    return result;
+}
+
+// The table, built on first use.  (A function-local static, so that threads
+// running separate interpreters can both get here first safely.)
+static const ReverseLookupTable& reverseLookupTable(void) {
+    static const ReverseLookupTable table = buildReverseLookupTable();
+    return table;
 }
 
 static int compareUShort(const void *a, const void *b) {
@@ -216,9 +220,9 @@ static unsigned short findLowerInUpperTable(unsigned short lower) {
         if (lower >= 'a' && lower <= 'z') return lower - 32;
         return lower;
     }
-    if (!sReverseLookupTable) buildReverseLookupTable();
+    const ReverseLookupTable& table = reverseLookupTable();
     LowerUpperPair key = { lower, 0 };
-    LowerUpperPair *result = (LowerUpperPair *)bsearch(&key, sReverseLookupTable, sReverseLookupCount,
+    LowerUpperPair *result = (LowerUpperPair *)bsearch(&key, table.pairs, table.count,
                                       sizeof(LowerUpperPair), compareLowerUpperPair);
     return result ? result->upper : lower;
 }
@@ -278,6 +278,8 @@ bool Value::RecursiveEqual(Value rhs) const {
             int aCount = pa.ListCount();
             if (pb.ListCount() != aCount) return false;
             if (pa.RefEquals(pb)) continue;  // same list object: nothing to do
+            // Two frozen lists carry cached hashes; differing ones settle it.
+            if (pa.IsFrozen() && pb.IsFrozen() && list_hash(pa) != list_hash(pb)) return false;
             for (int i = 0; i < aCount; i++) {
                 ValuePair np; np.a = pa.ListGet(i); np.b = pb.ListGet(i);
                 if (!visited_contains(visited, np)) toDo.push_back(np);
@@ -288,6 +290,7 @@ bool Value::RecursiveEqual(Value rhs) const {
             GCMap mB = GCManager::Maps.Get(pb.ItemIndex());
             if (mA.Count() != mB.Count()) return false;
             if (pa.RefEquals(pb)) continue;  // same map object: nothing to do
+            if (mA.Frozen && mB.Frozen && map_hash(pa) != map_hash(pb)) return false;
             for (int i = mA.NextEntry(-1); i != -1; i = mA.NextEntry(i)) {
                 Value bv;
                 if (!mB.TryGet(mA.KeyAt(i), &bv)) return false;
@@ -335,9 +338,11 @@ Value value_shl(Value v, int shift) {
 
 namespace {
 
-ShortNameLookupFn g_short_name_lookup = nullptr;
-RuntimeErrorMakerFn g_runtime_error_maker = nullptr;
-StackTraceFn g_stack_trace_hook = nullptr;
+// Hooks into the VM layer, installed by each VM as it starts.  Per thread,
+// since every thread that runs VMs installs them (see GCManager on isolates).
+thread_local ShortNameLookupFn g_short_name_lookup = nullptr;
+thread_local RuntimeErrorMakerFn g_runtime_error_maker = nullptr;
+thread_local StackTraceFn g_stack_trace_hook = nullptr;
 
 Value find_short_name(void* vm, Value v) {
     if (!vm || !g_short_name_lookup) return Value::null;
@@ -538,6 +543,12 @@ uint32_t value_hash(Value v) {
     return uint64_hash(v.bits);
 }
 
+uint32_t value_shallow_hash(Value v) {
+    if (v.IsList()) return 0x4C495354u ^ (uint32_t)v.ListCount();   // 'LIST'
+    if (v.IsMap())  return 0x4D415020u ^ (uint32_t)v.MapCount();    // 'MAP '
+    return value_hash(v);
+}
+
 // ── Frozen ──────────────────────────────────────────────────────────────
 
 bool Value::IsFrozen() const {
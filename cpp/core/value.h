@@ -79,7 +79,7 @@ typedef struct Value {
     // defined out-of-line below, where the NaN-box constants and the make_*
     // helpers are visible.  These mirror MiniScript 1.x: a default Value is
     // null, Value(1.0) is a number, Value("x") is a string.
-    Value() noexcept;                 // null
+    constexpr Value() noexcept;       // null (constexpr, so a static or thread_local Value needs no run-time init)
     Value(double number) noexcept;    // a number
     Value(int i) noexcept;            // integer (delegates to double; prevents 0→null-ptr ambiguity)
     Value(unsigned int u) noexcept;   // unsigned integer (delegates to double)
@@ -155,6 +155,8 @@ typedef struct Value {
     inline bool         IsTinyString()const noexcept;
     inline bool         IsGCObject()  const noexcept;
     inline bool         IsHeapString()const noexcept;
+    inline bool         IsInternedString()const noexcept;
+    inline bool         IsShared()    const noexcept;
     inline bool         IsInt()       const noexcept;
     inline int          AsInt()       const noexcept;
     inline double       AsDouble()    const noexcept;
@@ -203,6 +205,9 @@ typedef struct Value {
     // Strings (instance form, mirroring cs/Value.cs)
     static Value  make_string(const char* str);
     static Value  make_string(const String& s);
+    static Value  make_interned_string(const char* str);   // literals and identifiers
+    static Value  make_interned_string(const String& s);
+    static uint32_t StringHash(const String& s);  // content hash, as get_string_hash
     String        ToString(void* vm = nullptr) const;
     const char*   AsCString() const;
     // Like ToString().c_str() but SAFE: copies the bytes into the per-call
@@ -368,11 +373,17 @@ static_assert(std::is_standard_layout<Value>::value,
 #define MAP_SET      2
 #define ERROR_SET    3
 #define FUNCREF_SET  4
-// InternedStringSet = 5 (semi-immortal; referenced via GCManager::InternedStringSet)
+#define INTERNED_STRING_SET 5   // semi-immortal; see GCManager::InternString
 #define HANDLE_SET   6
 
+// Item indices from here up, in the string, list and map sets, are items of
+// the process-wide SharedHeap rather than of this thread's heap (IMPORTANT:
+// must match SharedHeap.FirstIndex in cs/SharedHeap.cs).
+#define SHARED_ITEM_BASE 0x40000000
+
 // Composite tag patterns (top-16 + 3-bit set). Useful for legacy code.
 #define STRING_TAG_PATTERN  (GC_TAG | ((uint64_t)STRING_SET  << 32))
+#define INTERNED_STRING_TAG_PATTERN (GC_TAG | ((uint64_t)INTERNED_STRING_SET << 32))
 #define LIST_TAG_PATTERN    (GC_TAG | ((uint64_t)LIST_SET    << 32))
 #define MAP_TAG_PATTERN     (GC_TAG | ((uint64_t)MAP_SET     << 32))
 #define ERROR_TAG_PATTERN   (GC_TAG | ((uint64_t)ERROR_SET   << 32))
@@ -405,7 +416,17 @@ inline bool Value::IsGCObject() const noexcept {
 }
 
 inline bool Value::IsHeapString() const noexcept {
-    return (bits & GC_TYPE_MASK) == STRING_TAG_PATTERN;
+    uint64_t masked = bits & GC_TYPE_MASK;
+    return masked == STRING_TAG_PATTERN || masked == INTERNED_STRING_TAG_PATTERN;
+}
+
+inline bool Value::IsInternedString() const noexcept {
+    return (bits & GC_TYPE_MASK) == INTERNED_STRING_TAG_PATTERN;
+}
+
+// A string, list or map published to the SharedHeap (see cs/SharedHeap.cs).
+inline bool Value::IsShared() const noexcept {
+    return IsGCObject() && ItemIndex() >= SHARED_ITEM_BASE;
 }
 
 // ── Forward declarations for runtime functions ──────────────────────────
@@ -621,6 +642,11 @@ Value value_shl(Value v, int shift);
 // ── Hashing & frozen ────────────────────────────────────────────────────
 uint32_t value_hash(Value v);
 
+// Hash of a value as an element of a list or map (used by list_hash/map_hash).
+// Nested containers contribute only their type and count, which keeps container
+// hashing O(n) and cycle-safe, and lets a frozen container cache its hash.
+uint32_t value_shallow_hash(Value v);
+
 // Content-aware Hash and equality overloads for Value, used by
 // Dictionary<Value, Value>. Without these, Dictionary would fall back to
 // bitwise hash/equality (via Hash(int) narrowing and uint64_t ==), which
@@ -629,14 +655,23 @@ uint32_t value_hash(Value v);
 inline int Hash(Value v) {
     return (int)(value_hash(v) & 0x7FFFFFFFU);
 }
+//
+// Keys are compared by bits first.  A string that fits in a tiny string always
+// is one, and GCMap.Set interns every short string key, so once the hashes
+// match, differing bits are a definite miss when either key is tiny or both
+// are interned -- the common identifier-like key never reaches a content
+// comparison.  Any other pair of strings is compared by content.
 inline bool DictKeyEqual(Value a, Value b) {
+    if (a.bits == b.bits) return true;
+    if (a.IsTinyString() || b.IsTinyString()) return false;
+    if (a.IsInternedString() && b.IsInternedString()) return false;
     return a.RecursiveEqual(b);
 }
 
 // ── MiniScript 1.x-compatible constructors (declared in struct Value) ──────
 // Defined here, where NULL_VALUE and the make_* helpers are visible.  A default
 // Value is null; Value(1.0) is a number; Value("x") copies the C string.
-inline Value::Value() noexcept : bits(NULL_VALUE) {}
+inline constexpr Value::Value() noexcept : bits(NULL_VALUE) {}
 inline Value::Value(double number) noexcept { memcpy(&bits, &number, sizeof bits); }
 inline Value::Value(int i) noexcept { double d = (double)i; memcpy(&bits, &d, sizeof bits); }
 inline Value::Value(unsigned int u) noexcept { double d = (double)u; memcpy(&bits, &d, sizeof bits); }
@@ -685,6 +720,7 @@ inline unsigned int Value::Hash()        const noexcept { return value_hash(*thi
 // ── String-typed Value methods (need the host String class) ──────────────
 // These mirror cs/Value.cs.  Defined inline here since String is now visible.
 inline Value Value::make_string(const String& s) { return Value::make_string(s.c_str()); }
+inline Value Value::make_interned_string(const String& s) { return Value::make_interned_string(s.c_str()); }
 
 inline String Value::ToString(void* vm) const {
     return String(ToStringValue(vm).AsCString());
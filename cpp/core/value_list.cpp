@@ -263,10 +263,22 @@ void Value::SortByKey(Value byKey, bool ascending) const {
 
 // ── Hash & display ──────────────────────────────────────────────────────
 
+// Content hash, consistent with RecursiveEqual: an ordered FNV-style combine of
+// the elements' shallow hashes (see value_shallow_hash), so it never recurses.
+// A frozen list cannot change, so its hash is computed once and cached in the
+// GCList; 0 is reserved to mean "not cached".
 uint32_t list_hash(Value list_val) {
     if (!list_val.IsList()) return 0;
-    // Identity hash — content hashing risks O(n²) recursion on cycles.
-    return uint64_hash(list_val.bits);
+    int32_t idx = list_val.ItemIndex();
+    uint32_t h = GCManager::Lists.GetHashCache(idx);
+    if (h != 0) return h;
+    GCList l = GCManager::Lists.Get(idx);
+    int n = l.Count();
+    h = 0x4C495354u ^ (uint32_t)n;
+    for (int i = 0; i < n; i++) h = (h ^ value_shallow_hash(l.Get(i))) * 16777619u;
+    if (h == 0) h = 1;
+    if (l.Frozen) GCManager::Lists.SetHashCache(idx, h);
+    return h;
 }
 
 Value list_to_string(Value list_val, void* vm) {
@@ -145,28 +145,20 @@ void Value::Clear() const {
     m.Clear();
 }
 
+// Both copy the source table wholesale (GCMap::CopyItems) rather than
+// re-inserting entry by entry; map_concat then stores b over it in one bulk
+// pass that reuses b's stored hashes (GCMap::SetAll).
 Value map_copy(Value map_val) {
     if (!map_val.IsMap()) return Value::null;
     GCMap src = GCManager::Maps.Get(map_val.ItemIndex());
-    Value newMap = Value::make_map(src.Count());
-    GCMap dst = GCManager::Maps.Get(newMap.ItemIndex());
-    for (int i = src.NextEntry(-1); i != -1; i = src.NextEntry(i))
-        dst.Set(src.KeyAt(i), src.ValueAt(i));
-    return newMap;
+    return GCManager::NewMapFromDict(src.CopyItems());
 }
 
 Value map_concat(Value a, Value b) {
-    Value result = Value::make_empty_map();
-    GCMap dst = GCManager::Maps.Get(result.ItemIndex());
-    if (a.IsMap()) {
-        GCMap la = GCManager::Maps.Get(a.ItemIndex());
-        for (int i = la.NextEntry(-1); i != -1; i = la.NextEntry(i))
-            dst.Set(la.KeyAt(i), la.ValueAt(i));
-    }
+    Value result = a.IsMap() ? map_copy(a) : Value::make_empty_map();
     if (b.IsMap()) {
-        GCMap lb = GCManager::Maps.Get(b.ItemIndex());
-        for (int i = lb.NextEntry(-1); i != -1; i = lb.NextEntry(i))
-            dst.Set(lb.KeyAt(i), lb.ValueAt(i));
+        GCMap dst = GCManager::Maps.Get(result.ItemIndex());
+        dst.SetAll(GCManager::Maps.Get(b.ItemIndex()));
     }
     return result;
 }
@@ -200,12 +192,11 @@ bool map_iterator_next(MapIterator* iter, Value* out_key, Value* out_value) {
         if (out_value) *out_value = Value::null;
         return false;
     }
-    GCMap m = GCManager::Maps.Get(iter->map_idx);
-    int next = m.NextEntry(iter->iter);
+    int next = GCManager::Maps.NextEntry(iter->map_idx, iter->iter);
     if (next < 0) { iter->iter = Value::MAP_ITER_DONE; return false; }
     iter->iter = next;
-    if (out_key)   *out_key   = m.KeyAt(next);
-    if (out_value) *out_value = m.ValueAt(next);
+    if (out_key)   *out_key   = GCManager::Maps.KeyAt(iter->map_idx, next);
+    if (out_value) *out_value = GCManager::Maps.ValueAt(iter->map_idx, next);
     return true;
 }
 
@@ -231,26 +222,39 @@ Value Value::NthEntry(int n) const {
 int Value::IterNext(int iter) const {
     Value map_val = *this;
     if (!map_val.IsMap() || iter == Value::MAP_ITER_DONE) return Value::MAP_ITER_DONE;
-    GCMap m = GCManager::Maps.Get(map_val.ItemIndex());
-    int next = m.NextEntry(iter);
+    int next = GCManager::Maps.NextEntry(map_val.ItemIndex(), iter);
     return next < 0 ? Value::MAP_ITER_DONE : next;
 }
 
 Value Value::IterEntry(int iter) const {
     Value map_val = *this;
     if (!map_val.IsMap() || iter == Value::MAP_ITER_DONE) return Value::null;
-    GCMap m = GCManager::Maps.Get(map_val.ItemIndex());
     Value entry = Value::make_map(4);
-    entry.MapSet(Value::make_string("key"),   m.KeyAt(iter));
-    entry.MapSet(Value::make_string("value"), m.ValueAt(iter));
+    entry.MapSet(Value::keyString,   GCManager::Maps.KeyAt(map_val.ItemIndex(), iter));
+    entry.MapSet(Value::valueString, GCManager::Maps.ValueAt(map_val.ItemIndex(), iter));
     return entry;
 }
 
 // ── Hash & display ──────────────────────────────────────────────────────
 
+// Content hash, consistent with RecursiveEqual: an order-independent sum over
+// entries of the key's mixed shallow hash combined with the value's, so maps
+// with the same entries in different insertion order hash alike.  Cached once
+// the map is frozen, as with list_hash.
 uint32_t map_hash(Value map_val) {
     if (!map_val.IsMap()) return 0;
-    return uint64_hash(map_val.bits);
+    int32_t idx = map_val.ItemIndex();
+    uint32_t h = GCManager::Maps.GetHashCache(idx);
+    if (h != 0) return h;
+    GCMap m = GCManager::Maps.Get(idx);
+    h = 0x4D415020u ^ (uint32_t)m.Count();
+    for (int i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+        uint32_t kh = value_shallow_hash(m.KeyAt(i)) * 0x9E3779B1u;
+        h += (kh ^ (kh >> 15)) ^ value_shallow_hash(m.ValueAt(i));
+    }
+    if (h == 0) h = 1;
+    if (m.Frozen) GCManager::Maps.SetHashCache(idx, h);
+    return h;
 }
 
 Value map_to_string(Value map_val, void* vm) {
@@ -1,7 +1,8 @@
 // value_string.cpp — string operations on NaN-boxed Values, layered over
 // the shared StringStorage / ss_* primitives so behaviour matches CS_String.
 //
-// Heap Value strings are GCManager.BigStrings slots, each owning a String
+// Heap Value strings are GCManager.BigStrings slots, or InternedStrings slots
+// for short literals, identifiers and map keys, each owning a String
 // (which wraps a shared_ptr<StringStorage>). We reach the underlying
 // StringStorage via String::getStorageRaw() so existing ss_* call sites
 // continue to work; the shared_ptr layer is a temporary cost while we
@@ -31,7 +32,7 @@ namespace {
 
 // Get the raw StringStorage* for a heap-string Value (borrowed; do not free).
 const StringStorage* heap_string_storage(Value v) {
-    GCString s = GCManager::BigStrings.Get(v.ItemIndex());
+    GCString s = GCManager::GetString(v);
     return s.Data.getStorageRaw();
 }
 
@@ -121,6 +122,16 @@ Value Value::make_string(const char* str) {
     return make_heap_string_bytes(str, lenB);
 }
 
+// As make_string, but a heap string under INTERN_THRESHOLD bytes is interned
+// (see GCManager::InternString), as make_interned_string does in cs/Value.cs.
+Value Value::make_interned_string(const char* str) {
+    if (str == nullptr) return Value::null;
+    int lenB = (int)std::strlen(str);
+    if (lenB <= TINY_STRING_MAX_LEN) return make_tiny_string(str, lenB);
+    if (lenB < INTERN_THRESHOLD) return GCManager::InternString(String(str));
+    return make_heap_string_bytes(str, lenB);
+}
+
 Value make_string_n(const char* str, int len) {
     if (str == nullptr || len < 0) return Value::null;
     if (len <= TINY_STRING_MAX_LEN) return make_tiny_string(str, len);
@@ -213,8 +224,11 @@ const char* get_string_data_nullterm(const Value* v_ptr, char* tiny_buffer) {
 
 bool string_equals(Value a, Value b) {
     if (!a.IsString() || !b.IsString()) return false;
-    if (a.RefEquals(b)) return true;  // identical bits → equal (interning makes this common)
-    if (a.IsTinyString() && b.IsTinyString()) return false;
+    if (a.RefEquals(b)) return true;  // identical bits → equal
+    // A tiny string differs from any other Value's bits, and two interned
+    // strings with different bits differ in content (see DictKeyEqual).
+    if (a.IsTinyString() || b.IsTinyString()) return false;
+    if (a.IsInternedString() && b.IsInternedString()) return false;
     TempStorage ta(a), tb(b);
     return ss_equals(ta, tb);
 }
@@ -490,9 +504,14 @@ uint32_t get_string_hash(Value v) {
             buf[i] = (char)((v.bits >> (8 * (i + 1))) & 0xFF);
         return string_hash(buf, len);
     }
+    if (v.IsInternedString()) return GCManager::InternedStrings.GetHash(v.ItemIndex());
     if (v.IsHeapString())
         return ss_hash(const_cast<StringStorage*>(heap_string_storage(v)));
     return 0;
 }
 
+uint32_t Value::StringHash(const String& s) {
+    return ss_hash(const_cast<StringStorage*>(s.getStorageRaw()));
+}
+
 }  // namespace MiniScript
@@ -15,8 +15,8 @@
 namespace MiniScript {
 
 
-// Strings shorter than this are interned; longer ones bypass the intern
-// table. The same threshold is used by GCManager.
+// Literals, identifiers and map keys shorter than this are interned; longer
+// ones bypass the intern table. The same threshold is used by GCManager.
 #define INTERN_THRESHOLD 128
 
 // ── Creation ────────────────────────────────────────────────────────────
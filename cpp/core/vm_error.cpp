@@ -7,7 +7,8 @@
 
 namespace MiniScript {
 
-static vm_error_callback_t s_error_callback = NULL;
+// Per thread: each thread that runs VMs installs its own (see VM InitVM).
+static thread_local vm_error_callback_t s_error_callback = NULL;
 
 void vm_error_set_callback(vm_error_callback_t callback) {
     s_error_callback = callback;
@@ -3,6 +3,7 @@
 
 using System;
 using System.Collections.Generic;
+// H: #include "FuncDef.g.h"
 
 // CPP: #include "StringUtils.g.h"
 // CPP: #include "CS_Math.h"
@@ -186,6 +187,10 @@ public class IdentifierNode : ASTNode {
 	}
 
 	public override ASTNode Simplify() {
+		// The keywords true and false are just the numbers 1 and 0 (the code
+		// generator loads them that way), so folding can see through them.
+		if (Name == "true") return CopyLine(new NumberNode(1));
+		if (Name == "false") return CopyLine(new NumberNode(0));
 		return this;
 	}
 
@@ -292,10 +297,10 @@ public class UnaryOpNode : ASTNode {
 		NumberNode num = simplifiedOperand as NumberNode;
 		if (num != null) {
 			if (Op == MiniScript.Op.MINUS) {
-				return new NumberNode(-num.Value);
+				return CopyLine(new NumberNode(-num.Value));
 			} else if (Op == MiniScript.Op.NOT) {
 				// Fuzzy logic NOT: 1 - AbsClamp01(value)
-				return new NumberNode(1.0 - Value.AbsClamp01(num.Value));
+				return CopyLine(new NumberNode(1.0 - Value.AbsClamp01(num.Value)));
 			}
 		}
 
@@ -407,6 +412,28 @@ public class BinaryOpNode : ASTNode {
 			return new StringNode(result);
 		}
 
+		// String equality (ordering is left to the VM's string comparison)
+		if (leftStr != null && rightStr != null && Op == MiniScript.Op.EQUALS) {
+			return CopyLine(new NumberNode(leftStr.Value == rightStr.Value ? 1 : 0));
+		}
+		if (leftStr != null && rightStr != null && Op == MiniScript.Op.NOT_EQUAL) {
+			return CopyLine(new NumberNode(leftStr.Value != rightStr.Value ? 1 : 0));
+		}
+
+		// Algebraic identities: x + 0, x - 0, x * 1, x / 1, x ^ 1 and their
+		// mirror images are just x -- but only where x is known to be a number,
+		// since the same operators mean other things for strings and lists.
+		if (rightNum != null && ASTSimplifier.IsKnownNumber(simplifiedLeft)) {
+			Double r = rightNum.Value;
+			if (r == 0 && (Op == MiniScript.Op.PLUS || Op == MiniScript.Op.MINUS)) return simplifiedLeft;
+			if (r == 1 && (Op == MiniScript.Op.TIMES || Op == MiniScript.Op.DIVIDE || Op == MiniScript.Op.POWER)) return simplifiedLeft;
+		}
+		if (leftNum != null && ASTSimplifier.IsKnownNumber(simplifiedRight)) {
+			Double l = leftNum.Value;
+			if (l == 0 && Op == MiniScript.Op.PLUS) return simplifiedRight;
+			if (l == 1 && Op == MiniScript.Op.TIMES) return simplifiedRight;
+		}
+
 		// Otherwise return binary op with simplified operands
 		return CopyLine(new BinaryOpNode(Op, simplifiedLeft, simplifiedRight));
 	}
@@ -445,8 +472,31 @@ public class ComparisonChainNode : ASTNode {
 
 	public override ASTNode Simplify() {
 		List<ASTNode> simplifiedOperands = new List<ASTNode>();
+		List<Double> numbers = new List<Double>();
 		for (Int32 i = 0; i < Operands.Count; i++) {
-			simplifiedOperands.Add(Operands[i].Simplify());
+			ASTNode operand = Operands[i].Simplify();
+			NumberNode num = operand as NumberNode;
+			if (num != null) numbers.Add(num.Value);
+			simplifiedOperands.Add(operand);
+		}
+
+		// A chain of number literals folds to the product of its comparisons.
+		if (numbers.Count == Operands.Count) {
+			Double result = 1;
+			for (Int32 i = 0; i < Operators.Count; i++) {
+				Double a = numbers[i];
+				Double b = numbers[i + 1];
+				String op = Operators[i];
+				Boolean holds = false;
+				if (op == MiniScript.Op.EQUALS) holds = (a == b);
+				else if (op == MiniScript.Op.NOT_EQUAL) holds = (a != b);
+				else if (op == MiniScript.Op.LESS_THAN) holds = (a < b);
+				else if (op == MiniScript.Op.GREATER_THAN) holds = (a > b);
+				else if (op == MiniScript.Op.LESS_EQUAL) holds = (a <= b);
+				else if (op == MiniScript.Op.GREATER_EQUAL) holds = (a >= b);
+				if (!holds) result = 0;
+			}
+			return CopyLine(new NumberNode(result));
 		}
 		return CopyLine(new ComparisonChainNode(simplifiedOperands, Operators));
 	}
@@ -927,6 +977,18 @@ public class IfNode : ASTNode {
 		for (Int32 i = 0; i < ElseBody.Count; i++) {
 			simplifiedElseBody.Add(ElseBody[i].Simplify());
 		}
+
+		// A constant condition settles which arm runs.  Drop the other one, and
+		// keep the survivor as the body of an `if 1` with no else, which the code
+		// generator compiles as a plain block (no test, no branch).  It stays an
+		// IfNode so that it is still a statement -- e.g. the REPL must not echo
+		// `if true then 42` as though it were the expression `42`.
+		Int32 truth = ASTSimplifier.ConstantTruth(simplifiedCondition);
+		if (truth == 1) {
+			return CopyLine(new IfNode(CopyLine(new NumberNode(1)), simplifiedThenBody, new List<ASTNode>()));
+		} else if (truth == 0) {
+			return CopyLine(new IfNode(CopyLine(new NumberNode(1)), simplifiedElseBody, new List<ASTNode>()));
+		}
 		return CopyLine(new IfNode(simplifiedCondition, simplifiedThenBody, simplifiedElseBody));
 	}
 
@@ -1220,4 +1282,537 @@ public class ReturnNode : ASTNode {
 	}
 }
 
+// The AST optimization pass, run between parsing and code generation.  The
+// work itself is done by each node's Simplify method; this holds the entry
+// point and the judgments those methods share.
+public static class ASTSimplifier {
+	// Simplify every statement of a program (or REPL entry) in place, and return
+	// how many AST nodes that removed, as counted by NodeCounter.
+	public static Int32 SimplifyAll(List<ASTNode> statements) {
+		NodeCounter counter = new NodeCounter();
+		Int32 before = 0;
+		Int32 after = 0;
+		for (Int32 i = 0; i < statements.Count; i++) {
+			before += statements[i].Accept(counter);
+			statements[i] = statements[i].Simplify();
+			after += statements[i].Accept(counter);
+		}
+		return before - after;
+	}
+
+	// What a simplified condition is known to be, judged by the rule the VM's
+	// branches apply (a nonzero number or nonempty string is true; null is
+	// false): 1 if always true, 0 if always false, -1 if it depends on run time.
+	// Only literals qualify; the keywords true and false have already become
+	// numbers by the time anything asks.
+	public static Int32 ConstantTruth(ASTNode node) {
+		NumberNode num = node as NumberNode;
+		if (num != null) return num.Value != 0 ? 1 : 0;
+		StringNode str = node as StringNode;
+		if (str != null) return str.Value != "" ? 1 : 0;
+		IdentifierNode ident = node as IdentifierNode;
+		if (ident != null && ident.Name == "null") return 0;
+		return -1;
+	}
+
+	// Is this (simplified) expression certain to yield a number that is not
+	// negative zero -- or else an error, which arithmetic passes through
+	// unchanged?  Comparisons and the fuzzy-logic operators always do; most
+	// other operators depend on their operand types (+ concatenates strings,
+	// - negates to -0, and so on), which we cannot know.  This is what makes
+	// identities like x + 0 safe to apply.
+	public static Boolean IsKnownNumber(ASTNode node) {
+		ComparisonChainNode chain = node as ComparisonChainNode;
+		if (chain != null) return true;
+		UnaryOpNode unary = node as UnaryOpNode;
+		if (unary != null) return unary.Op == MiniScript.Op.NOT;
+		BinaryOpNode binary = node as BinaryOpNode;
+		if (binary == null) return false;
+		String op = binary.Op;
+		return op == MiniScript.Op.EQUALS || op == MiniScript.Op.NOT_EQUAL
+			|| op == MiniScript.Op.LESS_THAN || op == MiniScript.Op.GREATER_THAN
+			|| op == MiniScript.Op.LESS_EQUAL || op == MiniScript.Op.GREATER_EQUAL
+			|| op == MiniScript.Op.AND || op == MiniScript.Op.OR || op == MiniScript.Op.ISA;
+	}
+}
+
+// Counts the nodes in a tree: the node visited plus everything below it.
+// ASTSimplifier.SimplifyAll uses it to report how much simplification removed.
+public class NodeCounter : IASTVisitor {
+	public NodeCounter() {
+	}
+
+	private Int32 CountAll(List<ASTNode> nodes) {
+		Int32 count = 0;
+		for (Int32 i = 0; i < nodes.Count; i++) {
+			ASTNode node = nodes[i];
+			if (node != null) count += node.Accept(this);
+		}
+		return count;
+	}
+
+	public Int32 Visit(NumberNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(StringNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(IdentifierNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(AssignmentNode node) {
+		return 1 + node.Value.Accept(this);
+	}
+
+	public Int32 Visit(UnaryOpNode node) {
+		return 1 + node.Operand.Accept(this);
+	}
+
+	public Int32 Visit(BinaryOpNode node) {
+		return 1 + node.Left.Accept(this) + node.Right.Accept(this);
+	}
+
+	public Int32 Visit(CallNode node) {
+		return 1 + CountAll(node.Arguments);
+	}
+
+	public Int32 Visit(GroupNode node) {
+		return 1 + node.Expression.Accept(this);
+	}
+
+	public Int32 Visit(ListNode node) {
+		return 1 + CountAll(node.Elements);
+	}
+
+	public Int32 Visit(MapNode node) {
+		return 1 + CountAll(node.Keys) + CountAll(node.Values);
+	}
+
+	public Int32 Visit(IndexNode node) {
+		return 1 + node.Target.Accept(this) + node.Index.Accept(this);
+	}
+
+	public Int32 Visit(SliceNode node) {
+		Int32 count = 1 + node.Target.Accept(this);
+		if (node.StartIndex != null) count += node.StartIndex.Accept(this);
+		if (node.EndIndex != null) count += node.EndIndex.Accept(this);
+		return count;
+	}
+
+	public Int32 Visit(MemberNode node) {
+		return 1 + node.Target.Accept(this);
+	}
+
+	public Int32 Visit(MethodCallNode node) {
+		return 1 + node.Target.Accept(this) + CountAll(node.Arguments);
+	}
+
+	public Int32 Visit(ExprCallNode node) {
+		return 1 + node.Function.Accept(this) + CountAll(node.Arguments);
+	}
+
+	public Int32 Visit(WhileNode node) {
+		return 1 + node.Condition.Accept(this) + CountAll(node.Body);
+	}
+
+	public Int32 Visit(IfNode node) {
+		return 1 + node.Condition.Accept(this) + CountAll(node.ThenBody) + CountAll(node.ElseBody);
+	}
+
+	public Int32 Visit(ForNode node) {
+		return 1 + node.Iterable.Accept(this) + CountAll(node.Body);
+	}
+
+	public Int32 Visit(BreakNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(ContinueNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(FunctionNode node) {
+		return 1 + CountAll(node.ParamDefaults) + CountAll(node.Body);
+	}
+
+	public Int32 Visit(ReturnNode node) {
+		return (node.Value != null) ? 1 + node.Value.Accept(this) : 1;
+	}
+
+	public Int32 Visit(IndexedAssignmentNode node) {
+		return 1 + node.Target.Accept(this) + node.Index.Accept(this) + node.Value.Accept(this);
+	}
+
+	public Int32 Visit(SelfNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(SuperNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(ScopeNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(ComparisonChainNode node) {
+		return 1 + CountAll(node.Operands);
+	}
+}
+
+// A function whose calls may be compiled inline: one that just returns a small
+// expression of its parameters.  See CodeGenerator.MakeInlineCandidate.
+public class InlineCandidate {
+	public FuncDef Func;                // the compiled function
+	public Value Template;              // its template funcref, for the IFFUNC guard
+	public List<String> ParamNames;
+	public ASTNode Body;                // the expression it returns
+	public Int32 Line;                  // source line of its return statement
+
+	public InlineCandidate(FuncDef func, Value funcTemplate, List<String> paramNames, ASTNode body, Int32 line) {
+		Func = func;
+		Template = funcTemplate;
+		ParamNames = paramNames;
+		Body = body;
+		Line = line;
+	}
+}
+
+// Decides whether an expression can be compiled inline, in place of a call to
+// the function whose body returns it (see CodeGenerator.EmitInlinedCall): that
+// is, whether it reads nothing but the function's parameters and constants,
+// and calls nothing.  Visit returns 1 if the node qualifies, 0 if not.
+public class InlineChecker : IASTVisitor {
+	private List<String> _paramNames;
+
+	public InlineChecker(List<String> paramNames) {
+		_paramNames = paramNames;
+	}
+
+	private Int32 CheckAll(List<ASTNode> nodes) {
+		for (Int32 i = 0; i < nodes.Count; i++) {
+			ASTNode node = nodes[i];
+			if (node != null && node.Accept(this) == 0) return 0;
+		}
+		return 1;
+	}
+
+	public Int32 Visit(NumberNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(StringNode node) {
+		return 1;
+	}
+
+	public Int32 Visit(IdentifierNode node) {
+		if (node.Name == "null" || node.Name == "true" || node.Name == "false") return 1;
+		for (Int32 i = 0; i < _paramNames.Count; i++) {
+			if (_paramNames[i] == node.Name) return 1;
+		}
+		return 0;
+	}
+
+	public Int32 Visit(AssignmentNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(UnaryOpNode node) {
+		return node.Operand.Accept(this);
+	}
+
+	public Int32 Visit(BinaryOpNode node) {
+		if (node.Left.Accept(this) == 0) return 0;
+		return node.Right.Accept(this);
+	}
+
+	public Int32 Visit(CallNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(GroupNode node) {
+		return node.Expression.Accept(this);
+	}
+
+	public Int32 Visit(ListNode node) {
+		return CheckAll(node.Elements);
+	}
+
+	public Int32 Visit(MapNode node) {
+		if (CheckAll(node.Keys) == 0) return 0;
+		return CheckAll(node.Values);
+	}
+
+	public Int32 Visit(IndexNode node) {
+		if (node.Target.Accept(this) == 0) return 0;
+		return node.Index.Accept(this);
+	}
+
+	public Int32 Visit(SliceNode node) {
+		if (node.Target.Accept(this) == 0) return 0;
+		if (node.StartIndex != null && node.StartIndex.Accept(this) == 0) return 0;
+		if (node.EndIndex != null && node.EndIndex.Accept(this) == 0) return 0;
+		return 1;
+	}
+
+	public Int32 Visit(MemberNode node) {
+		return node.Target.Accept(this);
+	}
+
+	public Int32 Visit(MethodCallNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ExprCallNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(WhileNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(IfNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ForNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(BreakNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ContinueNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(FunctionNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ReturnNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(IndexedAssignmentNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(SelfNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(SuperNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ScopeNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ComparisonChainNode node) {
+		return CheckAll(node.Operands);
+	}
+}
+
+// Gathers the constants a loop reads as operands -- either side of an
+// arithmetic or comparison operator, an index, a member name -- so that the
+// loop's preheader can load each into a register once (see
+// CodeGenerator.HoistLoopConstants).  Values holds them in order of first
+// appearance, without duplicates.  Nested function bodies are skipped: they
+// are compiled on their own, and run in their own frame.
+public class LoopConstantCollector : IASTVisitor {
+	public List<Value> Values;
+
+	public LoopConstantCollector() {
+		Values = new List<Value>();
+	}
+
+	public void CollectAll(List<ASTNode> nodes) {
+		for (Int32 i = 0; i < nodes.Count; i++) {
+			ASTNode node = nodes[i];
+			if (node != null) node.Accept(this);
+		}
+	}
+
+	// Record node if it is a literal number or string.  NaN is left alone: it
+	// equals nothing, itself included, so it could never be found again.
+	private void NoteOperand(ASTNode node) {
+		NumberNode num = node as NumberNode;
+		if (num != null) {
+			if (Double.IsNaN(num.Value)) return; // CPP: if (std::isnan(num.Value())) return;
+			Note(new Value(num.Value));
+			return;
+		}
+		StringNode str = node as StringNode;
+		if (str != null) Note(Value.make_interned_string(str.Value));
+	}
+
+	private void Note(Value value) {
+		for (Int32 i = 0; i < Values.Count; i++) {
+			if (SameConstant(Values[i], value)) return;
+		}
+		Values.Add(value);
+	}
+
+	// Whether two constants can share a register.  This is stricter than `==`,
+	// which counts -0 and 0 as equal: numbers must match bit for bit.
+	public static Boolean SameConstant(Value a, Value b) {
+		if (a.IsNumber() && b.IsNumber()) return a.Bits() == b.Bits();
+		return a.IsString() && b.IsString() && a == b;
+	}
+
+	public Int32 Visit(NumberNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(StringNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(IdentifierNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(AssignmentNode node) {
+		node.Value.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(UnaryOpNode node) {
+		node.Operand.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(BinaryOpNode node) {
+		// `and` and `or` compile their operands straight into the result.
+		if (node.Op != MiniScript.Op.AND && node.Op != MiniScript.Op.OR) {
+			NoteOperand(node.Left);
+			NoteOperand(node.Right);
+		}
+		node.Left.Accept(this);
+		node.Right.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(CallNode node) {
+		CollectAll(node.Arguments);
+		return 0;
+	}
+
+	public Int32 Visit(GroupNode node) {
+		node.Expression.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(ListNode node) {
+		CollectAll(node.Elements);
+		return 0;
+	}
+
+	public Int32 Visit(MapNode node) {
+		CollectAll(node.Keys);
+		CollectAll(node.Values);
+		return 0;
+	}
+
+	public Int32 Visit(IndexNode node) {
+		NoteOperand(node.Index);
+		node.Target.Accept(this);
+		node.Index.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(SliceNode node) {
+		node.Target.Accept(this);
+		if (node.StartIndex != null) node.StartIndex.Accept(this);
+		if (node.EndIndex != null) node.EndIndex.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(MemberNode node) {
+		Note(Value.make_interned_string(node.Member));
+		node.Target.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(MethodCallNode node) {
+		Note(Value.make_interned_string(node.Method));
+		node.Target.Accept(this);
+		CollectAll(node.Arguments);
+		return 0;
+	}
+
+	public Int32 Visit(ExprCallNode node) {
+		node.Function.Accept(this);
+		CollectAll(node.Arguments);
+		return 0;
+	}
+
+	public Int32 Visit(WhileNode node) {
+		node.Condition.Accept(this);
+		CollectAll(node.Body);
+		return 0;
+	}
+
+	public Int32 Visit(IfNode node) {
+		node.Condition.Accept(this);
+		CollectAll(node.ThenBody);
+		CollectAll(node.ElseBody);
+		return 0;
+	}
+
+	public Int32 Visit(ForNode node) {
+		node.Iterable.Accept(this);
+		CollectAll(node.Body);
+		return 0;
+	}
+
+	public Int32 Visit(BreakNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ContinueNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(FunctionNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ReturnNode node) {
+		if (node.Value != null) node.Value.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(IndexedAssignmentNode node) {
+		NoteOperand(node.Index);
+		node.Target.Accept(this);
+		node.Index.Accept(this);
+		node.Value.Accept(this);
+		return 0;
+	}
+
+	public Int32 Visit(SelfNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(SuperNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ScopeNode node) {
+		return 0;
+	}
+
+	public Int32 Visit(ComparisonChainNode node) {
+		CollectAll(node.Operands);
+		return 0;
+	}
+}
+
 }
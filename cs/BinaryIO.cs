@@ -0,0 +1,223 @@
+// BinaryIO.cs
+//
+// Little-endian binary reading and writing, as used by the bytecode cache
+// (BytecodeCache.cs).  A ByteReader can read either a byte list or a whole
+// file; in C++ the file is memory-mapped (see core/mapped_file.h) rather than
+// copied, so data in it can be used in place for as long as the reader lives.
+
+using System;
+using System.Collections.Generic;
+// H: #include "mapped_file.h"
+// CPP: #include <cstring>
+
+namespace MiniScript {
+
+// Appends little-endian binary data to a byte list.
+public class ByteWriter {
+	public List<Byte> Data = new List<Byte>();
+
+	public ByteWriter() {
+	}
+
+	public void WriteU8(Byte b) {
+		Data.Add(b);
+	}
+
+	public void WriteU16(UInt16 v) {
+		Data.Add((Byte)(v & 0xFF));
+		Data.Add((Byte)(v >> 8));
+	}
+
+	public void WriteU32(UInt32 v) {
+		Data.Add((Byte)(v & 0xFF));
+		Data.Add((Byte)((v >> 8) & 0xFF));
+		Data.Add((Byte)((v >> 16) & 0xFF));
+		Data.Add((Byte)(v >> 24));
+	}
+
+	public void WriteU64(UInt64 v) {
+		WriteU32((UInt32)(v & 0xFFFFFFFF));
+		WriteU32((UInt32)(v >> 32));
+	}
+
+	public void WriteDouble(Double d) {
+		UInt64 bits = (UInt64)BitConverter.DoubleToInt64Bits(d); // CPP: UInt64 bits; memcpy(&bits, &d, sizeof(bits));
+		WriteU64(bits);
+	}
+
+	// A string is its UTF-8 byte length followed by the bytes.
+	public void WriteString(String s) {
+		//*** BEGIN CS_ONLY ***
+		Byte[] bytes = System.Text.Encoding.UTF8.GetBytes(s == null ? "" : s);
+		WriteU32((UInt32)bytes.Length);
+		Data.AddRange(bytes);
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		Int32 len = s.LengthB();
+		WriteU32((UInt32)len);
+		const char* p = s.c_str();
+		for (Int32 i = 0; i < len; i++) Data.Add((Byte)p[i]);
+		*** END CPP_ONLY ***/
+	}
+
+	// Overwrite four bytes already written at pos (e.g. a length that was not
+	// known until what follows it had been written).
+	public void PatchU32(Int32 pos, UInt32 v) {
+		Data[pos] = (Byte)(v & 0xFF);
+		Data[pos + 1] = (Byte)((v >> 8) & 0xFF);
+		Data[pos + 2] = (Byte)((v >> 16) & 0xFF);
+		Data[pos + 3] = (Byte)(v >> 24);
+	}
+
+	// Write zero bytes until the length is a multiple of the given size.
+	public void Align(Int32 size) {
+		while (Data.Count % size != 0) Data.Add(0);
+	}
+}
+
+// Reads little-endian binary data.  Reading past the end sets Failed (and
+// yields zeros) rather than throwing, so truncated or corrupt data can be
+// detected once, by checking Failed after a batch of reads.
+public class ByteReader {
+	//*** BEGIN CS_ONLY ***
+	private Byte[] _bytes;
+	//*** END CS_ONLY ***
+	// H: private: const Byte* _bytes = nullptr;
+	// H: private: std::shared_ptr<MappedFile> _file;  // owns _bytes, when reading a file
+	private List<Byte> _list = null;  // owns _bytes (in C++), when reading a list
+	public Int32 Count = 0;
+	public Int32 Pos = 0;
+	public Boolean Failed = false;
+
+	// H_WRAPPER: public: ByteReaderStorage* get_storage() const { return storage.get(); }
+	// H: public: const Byte* BytesAt(Int32 pos) const { return _bytes + pos; }
+
+	public ByteReader() {
+	}
+
+	// Read from a byte list, which must not change while the reader is in use.
+	public static ByteReader FromList(List<Byte> data) {
+		ByteReader r = new ByteReader();
+		r._list = data;
+		r.Count = data.Count;
+		r._bytes = data.ToArray(); // CPP: r.get_storage()->_bytes = r.Count() > 0 ? &data[0] : nullptr;
+		return r;
+	}
+
+	// Read a whole file (mapped into memory, in C++), or return null if it
+	// cannot be read.
+	public static ByteReader FromFile(String path) {
+		ByteReader r = new ByteReader();
+		//*** BEGIN CS_ONLY ***
+		try {
+			if (!System.IO.File.Exists(path)) return null;
+			r._bytes = System.IO.File.ReadAllBytes(path);
+		} catch (Exception) {
+			return null;
+		}
+		r.Count = r._bytes.Length;
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		std::shared_ptr<MappedFile> file = MappedFile::Open(path.c_str());
+		if (!file || file->Size() > 0x7FFFFFFF) return nullptr;
+		r.get_storage()->_file = file;
+		r.get_storage()->_bytes = file->Data();
+		r.set_Count((Int32)file->Size());
+		*** END CPP_ONLY ***/
+		return r;
+	}
+
+	// A second reader of the same data, starting at the given position.  It
+	// keeps the data alive for as long as it lives, just as this one does.
+	public ByteReader Cursor(Int32 pos) {
+		ByteReader r = new ByteReader();
+		r._bytes = _bytes; // CPP: r.get_storage()->_bytes = _bytes; r.get_storage()->_file = _file;
+		r._list = _list;
+		r.Count = Count;
+		r.Pos = pos;
+		return r;
+	}
+
+	public Boolean AtEnd() {
+		return Pos >= Count;
+	}
+
+	private Boolean Need(Int32 byteCount) {
+		if (Failed || byteCount < 0 || byteCount > Count - Pos) {
+			Failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	public Byte ReadU8() {
+		if (!Need(1)) return 0;
+		Byte b = _bytes[Pos];
+		Pos += 1;
+		return b;
+	}
+
+	public UInt16 ReadU16() {
+		if (!Need(2)) return 0;
+		UInt16 v = (UInt16)(_bytes[Pos] | (_bytes[Pos + 1] << 8));
+		Pos += 2;
+		return v;
+	}
+
+	public UInt32 ReadU32() {
+		if (!Need(4)) return 0;
+		UInt32 v = (UInt32)_bytes[Pos] | ((UInt32)_bytes[Pos + 1] << 8)
+			| ((UInt32)_bytes[Pos + 2] << 16) | ((UInt32)_bytes[Pos + 3] << 24);
+		Pos += 4;
+		return v;
+	}
+
+	public UInt64 ReadU64() {
+		UInt64 lo = ReadU32();
+		UInt64 hi = ReadU32();
+		return lo | (hi << 32);
+	}
+
+	public Double ReadDouble() {
+		UInt64 bits = ReadU64();
+		return BitConverter.Int64BitsToDouble((Int64)bits); // CPP: Double d; memcpy(&d, &bits, sizeof(d)); return d;
+	}
+
+	// Read a count (a U32 sizing what follows), failing if it is larger than
+	// the bytes remaining could possibly hold.
+	public Int32 ReadCount() {
+		UInt32 n = ReadU32();
+		if (n > (UInt32)(Count - Pos)) {
+			Failed = true;
+			return 0;
+		}
+		return (Int32)n;
+	}
+
+	public String ReadString() {
+		Int32 len = ReadCount();
+		if (!Need(len)) return "";
+		String result = System.Text.Encoding.UTF8.GetString(_bytes, Pos, len); // CPP: String result((const char*)(_bytes + Pos), (size_t)len);
+		Pos += len;
+		return result;
+	}
+
+	public void Skip(Int32 byteCount) {
+		if (Need(byteCount)) Pos += byteCount;
+	}
+
+	// Skip to the next multiple of the given size (see ByteWriter.Align).
+	public void Align(Int32 size) {
+		Int32 extra = Pos % size;
+		if (extra != 0) Skip(size - extra);
+	}
+
+	// 64-bit FNV-1a over the bytes from start to the end of the data.
+	public UInt64 Checksum(Int32 start) {
+		UInt64 h = 0xCBF29CE484222325UL;
+		for (Int32 i = start; i < Count; i++) h = (h ^ _bytes[i]) * 0x100000001B3UL;
+		return h;
+	}
+}
+
+}
@@ -27,6 +27,7 @@ public enum Opcode : Byte {
 	LOADC_rA_rB_kC,
 	LOADV_rA_rB_rC,
 	LOADC_rA_rB_rC,
+	LOADC_rA_rB,
 	FUNCREF_iA_iBC,
 	ASSIGN_rA_rB_kC,
 	NAME_rA_kBC,
@@ -86,12 +87,14 @@ public enum Opcode : Byte {
 	IFEQ_rA_iBC,
 	IFNE_rA_rB,
 	IFNE_rA_iBC,
+	IFFUNC_rA_kBC,
 	NEXT_rA_rB,
 	ARGBLK_iABC,
 	ARG_rA,
 	ARG_iABC,
 	CALLF_iA_iBC,
 	CALL_rA_rB_rC,
+	CALLINTRINSIC_rA_rB_iC,
 	RETURN,
 	NEW_rA_rB,
 	ISA_rA_rB_rC,
@@ -100,6 +103,7 @@ public enum Opcode : Byte {
 	SETSELF_rA,
 	CALLIFREF_rA,
 	ITERGET_rA_rB_rC,
+	ITERNEXT_rA_rB_rC,
 	ERRCHK_rA,
 	OP__COUNT  // Not an opcode, but rather how many opcodes we have.
 }
@@ -148,12 +152,24 @@ public static class BytecodeUtil {
 		return EmitPattern.None;
 	}
 
+	// GetEmitPattern for every opcode, indexed by opcode.  Working it out from
+	// the mnemonic takes a dozen substring searches, far too many to repeat on
+	// every instruction emitted, so CheckEmitPattern fills this on first use
+	// (on each thread, so that isolates compiling at once do not race on it).
+	[ThreadStatic] private static List<EmitPattern> _emitPatterns;
+
 	// Validate that an opcode matches the expected emit pattern
 	// Returns true if valid, false if mismatch (and prints error)
 	public static Boolean CheckEmitPattern(Opcode opcode, EmitPattern expected) {
 		if (!ValidateOpcodes) return true;
 
-		EmitPattern actual = GetEmitPattern(opcode);
+		if (_emitPatterns == null) {
+			_emitPatterns = new List<EmitPattern>();
+			for (Int32 i = 0; i < (Int32)Opcode.OP__COUNT; i++) {
+				_emitPatterns.Add(GetEmitPattern((Opcode)i));
+			}
+		}
+		EmitPattern actual = _emitPatterns[(Int32)opcode];
 		if (actual == expected) return true;
 
 		// Mismatch - report error
@@ -231,6 +247,7 @@ public static class BytecodeUtil {
 			case Opcode.LOADC_rA_rB_kC: return "LOADC_rA_rB_kC";
 			case Opcode.LOADV_rA_rB_rC: return "LOADV_rA_rB_rC";
 			case Opcode.LOADC_rA_rB_rC: return "LOADC_rA_rB_rC";
+			case Opcode.LOADC_rA_rB:    return "LOADC_rA_rB";
 			case Opcode.FUNCREF_iA_iBC: return "FUNCREF_iA_iBC";
 			case Opcode.ASSIGN_rA_rB_kC:return "ASSIGN_rA_rB_kC";
 			case Opcode.NAME_rA_kBC:    return "NAME_rA_kBC";
@@ -290,12 +307,14 @@ public static class BytecodeUtil {
 			case Opcode.IFEQ_rA_iBC:    return "IFEQ_rA_iBC";
 			case Opcode.IFNE_rA_rB:     return "IFNE_rA_rB";
 			case Opcode.IFNE_rA_iBC:    return "IFNE_rA_iBC";
+			case Opcode.IFFUNC_rA_kBC:  return "IFFUNC_rA_kBC";
 			case Opcode.NEXT_rA_rB:     return "NEXT_rA_rB";
 			case Opcode.ARGBLK_iABC:  return "ARGBLK_iABC";
 			case Opcode.ARG_rA:         return "ARG_rA";
 			case Opcode.ARG_iABC:       return "ARG_iABC";
 			case Opcode.CALLF_iA_iBC:   return "CALLF_iA_iBC";
 			case Opcode.CALL_rA_rB_rC:  return "CALL_rA_rB_rC";
+			case Opcode.CALLINTRINSIC_rA_rB_iC: return "CALLINTRINSIC_rA_rB_iC";
 			case Opcode.RETURN:         return "RETURN";
 			case Opcode.NEW_rA_rB:      return "NEW_rA_rB";
 			case Opcode.ISA_rA_rB_rC:   return "ISA_rA_rB_rC";
@@ -304,6 +323,7 @@ public static class BytecodeUtil {
 			case Opcode.SETSELF_rA:     return "SETSELF_rA";
 			case Opcode.CALLIFREF_rA:   return "CALLIFREF_rA";
 			case Opcode.ITERGET_rA_rB_rC: return "ITERGET_rA_rB_rC";
+			case Opcode.ITERNEXT_rA_rB_rC: return "ITERNEXT_rA_rB_rC";
 			case Opcode.ERRCHK_rA:      return "ERRCHK_rA";
 			default:
 				return "Unknown opcode";
@@ -320,6 +340,7 @@ public static class BytecodeUtil {
 		if (s == "LOADC_rA_rB_kC")  return Opcode.LOADC_rA_rB_kC;
 		if (s == "LOADV_rA_rB_rC")  return Opcode.LOADV_rA_rB_rC;
 		if (s == "LOADC_rA_rB_rC")  return Opcode.LOADC_rA_rB_rC;
+		if (s == "LOADC_rA_rB")     return Opcode.LOADC_rA_rB;
 		if (s == "FUNCREF_iA_iBC")  return Opcode.FUNCREF_iA_iBC;
 		if (s == "ASSIGN_rA_rB_kC") return Opcode.ASSIGN_rA_rB_kC;
 		if (s == "NAME_rA_kBC")     return Opcode.NAME_rA_kBC;
@@ -379,12 +400,14 @@ public static class BytecodeUtil {
 		if (s == "IFEQ_rA_iBC")     return Opcode.IFEQ_rA_iBC;
 		if (s == "IFNE_rA_rB")      return Opcode.IFNE_rA_rB;
 		if (s == "IFNE_rA_iBC")     return Opcode.IFNE_rA_iBC;
+		if (s == "IFFUNC_rA_kBC")   return Opcode.IFFUNC_rA_kBC;
 		if (s == "NEXT_rA_rB")      return Opcode.NEXT_rA_rB;
 		if (s == "ARGBLK_iABC")     return Opcode.ARGBLK_iABC;
 		if (s == "ARG_rA")          return Opcode.ARG_rA;
 		if (s == "ARG_iABC")        return Opcode.ARG_iABC;
 		if (s == "CALLF_iA_iBC")    return Opcode.CALLF_iA_iBC;
 		if (s == "CALL_rA_rB_rC")   return Opcode.CALL_rA_rB_rC;
+		if (s == "CALLINTRINSIC_rA_rB_iC") return Opcode.CALLINTRINSIC_rA_rB_iC;
 		if (s == "RETURN")          return Opcode.RETURN;
 		if (s == "NEW_rA_rB")       return Opcode.NEW_rA_rB;
 		if (s == "ISA_rA_rB_rC")    return Opcode.ISA_rA_rB_rC;
@@ -393,6 +416,7 @@ public static class BytecodeUtil {
 		if (s == "SETSELF_rA")      return Opcode.SETSELF_rA;
 		if (s == "CALLIFREF_rA")    return Opcode.CALLIFREF_rA;
 		if (s == "ITERGET_rA_rB_rC") return Opcode.ITERGET_rA_rB_rC;
+		if (s == "ITERNEXT_rA_rB_rC") return Opcode.ITERNEXT_rA_rB_rC;
 		if (s == "ERRCHK_rA")       return Opcode.ERRCHK_rA;
 		return Opcode.NOOP;
 	}
@@ -0,0 +1,637 @@
+// BytecodeCache.cs
+//
+// A compact binary form of compiled code (the list of FuncDefs produced for a
+// program or an imported module), and an on-disk cache of it, so that a
+// script compiled once need not be lexed, parsed, and code-generated again on
+// the next run.  The text .msa format (Assembler/Disassembler) stays the
+// human-readable form; this one exists only for speed.
+//
+// The cache is off unless a directory is given, either by the host (set
+// BytecodeCache.CacheDirectory) or by the MS_BYTECODE_CACHE environment variable.
+// Entries are keyed by a hash of the source, its file name, the compile mode,
+// and the compiler build, so a stale entry is simply never found.  Loading is
+// lazy: a function's constants are decoded only when it first runs, and (in
+// C++) its code is executed straight out of the memory-mapped file.  See
+// notes/BYTECODE_CACHE.md for the file format.
+
+using System;
+using System.Collections.Generic;
+// H: #include "value.h"
+// H: #include "FuncDef.g.h"
+// H: #include "BinaryIO.g.h"
+// CPP: #include "Bytecode.g.h"
+// CPP: #include "CoreIntrinsics.g.h"
+// CPP: #include "Intrinsic.g.h"
+// CPP: #include "StringUtils.g.h"
+// CPP: #include <cstdio>
+// CPP: #include <cstdlib>
+// CPP: #include <mutex>
+// CPP: #include <string>
+// CPP: #include <sys/stat.h>
+/*** BEGIN CPP_ONLY ***
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+*** END CPP_ONLY ***/
+
+namespace MiniScript {
+
+public static class BytecodeCache {
+	// "MSBC" in little-endian byte order, then the format version.  Bump the
+	// version whenever the layout below changes.
+	public const UInt32 kMagic = 0x4342534D;
+	public const UInt32 kFormatVersion = 4;
+
+	// Size of the file header: magic, version, key, and checksum.  A multiple
+	// of 4, so code aligned in the payload is aligned in the file.
+	private const Int32 kHeaderSize = 24;
+
+	// Tags for serialized constant values.
+	private const Byte kTagNull = 0;
+	private const Byte kTagNumber = 1;
+	private const Byte kTagString = 2;
+	private const Byte kTagFuncRef = 3;
+	private const Byte kTagList = 4;
+	private const Byte kTagMap = 5;
+
+	// Cache directory; empty means caching is off.  Hosts may set this
+	// directly; if they do not, it is read once from MS_BYTECODE_CACHE.
+	public static String CacheDirectory = "";
+	private static Boolean _directoryResolved = false;
+
+	// CompilerVersion, once worked out.
+	private static String _compilerVersion = "";
+
+	// Count of temporary files this process has started to write; see
+	// WriteFileBytes.
+	private static Int32 _tempFileCount = 0;
+
+	// Guards _directoryResolved, _compilerVersion and _tempFileCount, which
+	// any thread that compiles may be the one to change.
+	//*** BEGIN CS_ONLY ***
+	private static readonly Object _lock = new Object();
+	//*** END CS_ONLY ***
+	/*** BEGIN CPP_ONLY ***
+	static std::mutex _mutex;
+
+	// Size and modification time of the running executable, which change
+	// whenever it is relinked.  Where that cannot be found, the build time
+	// of this file stands in for it.
+	static String BinaryStamp() {
+		char buf[64];
+		struct stat st;
+		#if defined(__linux__)
+		if (stat("/proc/self/exe", &st) == 0) {
+			snprintf(buf, sizeof(buf), "%lld.%lld.%ld", (long long)st.st_size,
+				(long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec);
+			return String(buf);
+		}
+		#elif defined(__APPLE__)
+		char exePath[1024];
+		uint32_t exePathSize = sizeof(exePath);
+		if (_NSGetExecutablePath(exePath, &exePathSize) == 0 && stat(exePath, &st) == 0) {
+			snprintf(buf, sizeof(buf), "%lld.%lld.%ld", (long long)st.st_size,
+				(long long)st.st_mtimespec.tv_sec, (long)st.st_mtimespec.tv_nsec);
+			return String(buf);
+		}
+		#endif
+		(void)buf; (void)st;
+		return String("C++ " __DATE__ " " __TIME__);
+	}
+	*** END CPP_ONLY ***/
+
+	public static String GetDirectory() {
+		Lock();
+		if (!_directoryResolved) {
+			_directoryResolved = true;
+			if (CacheDirectory.Length == 0) {
+				//*** BEGIN CS_ONLY ***
+				String env = System.Environment.GetEnvironmentVariable("MS_BYTECODE_CACHE");
+				if (env != null) CacheDirectory = env;
+				//*** END CS_ONLY ***
+				/*** BEGIN CPP_ONLY ***
+				const char* env = getenv("MS_BYTECODE_CACHE");
+				if (env) CacheDirectory = String(env);
+				*** END CPP_ONLY ***/
+			}
+		}
+		String dir = CacheDirectory;
+		Unlock();
+		return dir;
+	}
+
+	// ── Keys ─────────────────────────────────────────────────────────────────
+
+	// 64-bit FNV-1a over the UTF-8 bytes of s, continuing from hash h.
+	private static UInt64 HashString(UInt64 h, String s) {
+		//*** BEGIN CS_ONLY ***
+		Byte[] bytes = System.Text.Encoding.UTF8.GetBytes(s == null ? "" : s);
+		for (Int32 i = 0; i < bytes.Length; i++) {
+			h = unchecked((h ^ bytes[i]) * 0x100000001B3UL);
+		}
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		const unsigned char* p = (const unsigned char*)s.c_str();
+		Int32 len = s.LengthB();
+		for (Int32 i = 0; i < len; i++) h = (h ^ p[i]) * 0x100000001B3ULL;
+		*** END CPP_ONLY ***/
+		return (h ^ 0xFF) * 0x100000001B3UL;   // terminator, so "ab"+"c" != "a"+"bc"
+	}
+
+	// Identifies the exact compiler build.  Bytecode is only valid for the
+	// build that produced it, so besides the version numbers this hashes the
+	// opcode table and the core intrinsics (a CALLINTRINSIC operand is an
+	// index among them), and names the binary itself, which changes whenever
+	// it is rebuilt: any change to the compiler may change what it generates.
+	public static String CompilerVersion() {
+		Lock();
+		String version = _compilerVersion;
+		Unlock();
+		if (version.Length > 0) return version;
+
+		UInt64 h = 0xCBF29CE484222325UL;
+		for (Int32 i = 0; i < (Int32)Opcode.OP__COUNT; i++) {
+			h = HashString(h, BytecodeUtil.ToMnemonic((Opcode)i));
+		}
+		Int32 count = Intrinsic.Count();
+		for (Int32 i = 0; i < count; i++) {
+			Intrinsic intr = Intrinsic.GetByIndex(i);
+			if (intr.Core) h = HashString(h, intr.Name);
+		}
+		String build = System.Reflection.Assembly.GetExecutingAssembly().ManifestModule.ModuleVersionId.ToString(); // CPP: String build = BinaryStamp();
+		version = StringUtils.Format("{0}/{1}/{2}/{3}/{4}", CoreIntrinsics.hostVersion,
+			kFormatVersion, StringUtils.ToHex((UInt32)(h >> 32)),
+			StringUtils.ToHex((UInt32)(h & 0xFFFFFFFF)), build);
+
+		Lock();
+		_compilerVersion = version;
+		Unlock();
+		return version;
+	}
+
+	// Cache key for the given source, as compiled under the given file name
+	// either as a program (isImport false) or as an imported module.
+	public static UInt64 SourceKey(String source, String fileName, Boolean isImport) {
+		UInt64 h = 0xCBF29CE484222325UL;
+		h = HashString(h, CompilerVersion());
+		h = HashString(h, isImport ? "import" : "program");
+		h = HashString(h, fileName);
+		h = HashString(h, source);
+		return h;
+	}
+
+	public static String CachePath(String dir, UInt64 key) {
+		String sep = (dir.EndsWith("/") || dir.EndsWith("\\")) ? "" : "/";
+		return dir + sep + StringUtils.ToHex((UInt32)(key >> 32))
+			+ StringUtils.ToHex((UInt32)(key & 0xFFFFFFFF)) + ".msc";
+	}
+
+	// ── Cache lookup and storage ─────────────────────────────────────────────
+
+	// Return the cached functions for this source, or null if caching is off
+	// or there is no valid entry.  functions[0] is the @main.
+	public static List<FuncDef> Load(String source, String fileName, Boolean isImport) {
+		String dir = GetDirectory();
+		if (dir.Length == 0) return null;
+		UInt64 key = SourceKey(source, fileName, isImport);
+		ByteReader data = ByteReader.FromFile(CachePath(dir, key));
+		if (data == null) return null;
+		return DeserializeFrom(data, key);
+	}
+
+	// Save freshly compiled functions for this source.  Quietly does nothing
+	// if caching is off, the functions cannot be serialized, or the write fails;
+	// a cache is never a reason for a program to fail.
+	public static void Store(String source, String fileName, Boolean isImport, List<FuncDef> functions) {
+		String dir = GetDirectory();
+		if (dir.Length == 0) return;
+		UInt64 key = SourceKey(source, fileName, isImport);
+		List<Byte> data = Serialize(functions, key);
+		if (data == null) return;
+		WriteFileBytes(dir, CachePath(dir, key), data);
+	}
+
+	// ── Serialization ────────────────────────────────────────────────────────
+
+	// Serialize a function list (as produced by CodeGenerator) into the cache
+	// format.  Returns null if anything in it has no serialized form -- e.g. a
+	// constant that refers to a function outside the list.
+	public static List<Byte> Serialize(List<FuncDef> functions, UInt64 key) {
+		ByteWriter w = new ByteWriter();
+		w.WriteU32(kMagic);
+		w.WriteU32(kFormatVersion);
+		w.WriteU64(key);
+		w.WriteU64(0);		// checksum, patched below
+		w.WriteU32((UInt32)functions.Count);
+		List<Int32> childCounts = new List<Int32>();
+		for (Int32 i = 0; i < functions.Count; i++) {
+			if (!WriteFunction(w, i, functions, childCounts)) return null;
+		}
+		UInt64 checksum = ByteReader.FromList(w.Data).Checksum(kHeaderSize);
+		w.PatchU32(kHeaderSize - 8, (UInt32)(checksum & 0xFFFFFFFF));
+		w.PatchU32(kHeaderSize - 4, (UInt32)(checksum >> 32));
+		return w.Data;
+	}
+
+	// childCounts holds the size of each earlier function's children table, and
+	// gets this function's added to it.
+	private static Boolean WriteFunction(ByteWriter w, Int32 index, List<FuncDef> functions, List<Int32> childCounts) {
+		FuncDef f = functions[index];
+		if (f.NativeCallback != null) return false;
+		f.EnsureConstants();
+		w.WriteString(f.Name);
+		w.WriteString(f.FileName);
+		w.WriteString(f.Note);
+		w.WriteString(f.SourceLoc);
+		w.WriteU16(f.MaxRegs);
+		w.WriteU16((UInt16)f.SelfReg);
+		w.WriteU16((UInt16)f.SuperReg);
+
+		Int32 runs = f.LineRunCount();
+		w.WriteU32((UInt32)runs);
+		for (Int32 i = 0; i < runs; i++) {
+			w.WriteU32((UInt32)f.LineRunPC(i));
+			w.WriteU32((UInt32)f.LineRunLine(i));
+		}
+
+		Int32 inlines = f.InlineRangeCount();
+		w.WriteU32((UInt32)inlines);
+		for (Int32 i = 0; i < inlines; i++) {
+			w.WriteU32((UInt32)f.InlineRangeStart(i));
+			w.WriteU32((UInt32)f.InlineRangeEnd(i));
+			w.WriteU32((UInt32)f.InlineRangeCallLine(i));
+		}
+
+		// The values go into blocks of their own first, because writing them
+		// is what discovers the children table that has to precede them.
+		List<Int32> children = new List<Int32>();
+		ByteWriter header = new ByteWriter();
+		if (!WriteValues(header, f.ParamNames, functions, children)) return false;
+		if (!WriteValues(header, f.ParamDefaults, functions, children)) return false;
+		if (!WriteValues(header, f.GlobalNames, functions, children)) return false;
+		ByteWriter constants = new ByteWriter();
+		if (!WriteValues(constants, f.Constants, functions, children)) return false;
+
+		// A function mostly refers to templates of the functions nested in it,
+		// which CodeGenerator places after it in the list.  The exception is the
+		// guard of an inlined call, which names a function compiled earlier; but
+		// only a function with no templates of its own can be inlined.  Insisting
+		// on one or the other keeps the loaded functions' LazyChildren links free
+		// of cycles.
+		w.WriteU32((UInt32)children.Count);
+		for (Int32 i = 0; i < children.Count; i++) {
+			Int32 child = children[i];
+			if (child == index) return false;
+			if (child < index && childCounts[child] != 0) return false;
+			w.WriteU32((UInt32)child);
+		}
+		childCounts.Add(children.Count);
+		w.WriteU32((UInt32)header.Data.Count);
+		w.Data.AddRange(header.Data);
+		w.WriteU32((UInt32)constants.Data.Count);
+		w.Data.AddRange(constants.Data);
+
+		// Code is 4-byte aligned in the file, so that it can be used in place.
+		Int32 codeCount = f.CodeCount();
+		w.WriteU32((UInt32)codeCount);
+		w.Align(4);
+		for (Int32 i = 0; i < codeCount; i++) w.WriteU32(f.CodeAt(i));
+		return true;
+	}
+
+	private static Boolean WriteValues(ByteWriter w, List<Value> values, List<FuncDef> functions, List<Int32> children) {
+		w.WriteU32((UInt32)values.Count);
+		for (Int32 i = 0; i < values.Count; i++) {
+			if (!WriteValue(w, values[i], functions, children)) return false;
+		}
+		return true;
+	}
+
+	// Constants are only ever null, numbers, strings, function templates, and
+	// the frozen lists/maps that constant folding builds; anything else fails.
+	// A template is written as an index into the function's children table
+	// (the list indexes of the functions it refers to), adding to it as needed.
+	private static Boolean WriteValue(ByteWriter w, Value v, List<FuncDef> functions, List<Int32> children) {
+		if (v.IsNull()) {
+			w.WriteU8(kTagNull);
+		} else if (v.IsNumber()) {
+			w.WriteU8(kTagNumber);
+			w.WriteDouble(v.AsDouble());
+		} else if (v.IsString()) {
+			w.WriteU8(kTagString);
+			w.WriteString(v.AsCString());
+		} else if (v.IsFuncRef()) {
+			if (!v.OuterVars().IsNull()) return false;
+			FuncDef target = v.FunctionDef();
+			Int32 index = -1;
+			for (Int32 i = 0; i < functions.Count; i++) {
+				// (Compare storage, not FuncDefs: in C++ those convert to bool.)
+				if (functions[i] == target) { index = i; break; } // CPP: if (functions[i].get_storage() == target.get_storage()) { index = i; break; }
+			}
+			if (index < 0) return false;
+			Int32 child = children.IndexOf(index);
+			if (child < 0) {
+				child = children.Count;
+				children.Add(index);
+			}
+			w.WriteU8(kTagFuncRef);
+			w.WriteU32((UInt32)child);
+		} else if (v.IsList()) {
+			w.WriteU8(kTagList);
+			Int32 count = v.ListCount();
+			w.WriteU32((UInt32)count);
+			for (Int32 i = 0; i < count; i++) {
+				if (!WriteValue(w, v.ListGet(i), functions, children)) return false;
+			}
+		} else if (v.IsMap()) {
+			w.WriteU8(kTagMap);
+			GCMap m = GCManager.Maps.Get(v.ItemIndex());
+			w.WriteU32((UInt32)m.Count());
+			for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+				if (!WriteValue(w, m.KeyAt(i), functions, children)) return false;
+				if (!WriteValue(w, m.ValueAt(i), functions, children)) return false;
+			}
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	// ── Deserialization ──────────────────────────────────────────────────────
+
+	// Rebuild a function list from cache data.  Returns null if the data is not
+	// a complete, well-formed entry for the given key.  The data must not
+	// change while any of the returned functions is in use.
+	public static List<FuncDef> Deserialize(List<Byte> data, UInt64 key) {
+		return DeserializeFrom(ByteReader.FromList(data), key);
+	}
+
+	// The payload must match the checksum in the header, so an entry that was
+	// damaged or edited after it was written is rejected before any of it is
+	// used.  Its structure is checked as well: every count and offset, the
+	// registers and code positions each function names, and the constants,
+	// decoded later by DecodeConstants, which are thus known to be well formed.
+	// The instruction words themselves are covered only by the checksum.  The
+	// functions keep r (and so the data it reads) alive until they no longer
+	// need it.
+	public static List<FuncDef> DeserializeFrom(ByteReader r, UInt64 key) {
+		if (r.ReadU32() != kMagic) return null;
+		if (r.ReadU32() != kFormatVersion) return null;
+		if (r.ReadU64() != key) return null;
+		UInt64 checksum = r.ReadU64();
+		if (r.Failed || r.Checksum(kHeaderSize) != checksum) return null;
+		Int32 count = r.ReadCount();
+		if (r.Failed || count == 0) return null;
+
+		// Create every FuncDef first, so function templates can refer forward.
+		List<FuncDef> functions = new List<FuncDef>();
+		for (Int32 i = 0; i < count; i++) functions.Add(new FuncDef());
+		for (Int32 i = 0; i < count; i++) {
+			if (!ReadFunction(r, i, functions)) return null;
+		}
+		if (r.Failed || !r.AtEnd()) return null;
+		return functions;
+	}
+
+	private static Boolean ReadFunction(ByteReader r, Int32 index, List<FuncDef> functions) {
+		FuncDef f = functions[index];
+		f.Name = r.ReadString();
+		f.FileName = r.ReadString();
+		f.Note = r.ReadString();
+		f.SourceLoc = r.ReadString();
+		f.MaxRegs = r.ReadU16();
+		f.SelfReg = (Int16)r.ReadU16();
+		f.SuperReg = (Int16)r.ReadU16();
+		if (f.SelfReg < -1 || f.SelfReg >= f.MaxRegs) return false;
+		if (f.SuperReg < -1 || f.SuperReg >= f.MaxRegs) return false;
+
+		Int32 runs = r.ReadCount();
+		for (Int32 i = 0; i < runs; i++) {
+			Int32 pc = (Int32)r.ReadU32();
+			f.AddLineRun(pc, (Int32)r.ReadU32());
+		}
+
+		Int32 inlines = r.ReadCount();
+		for (Int32 i = 0; i < inlines; i++) {
+			Int32 startPC = (Int32)r.ReadU32();
+			Int32 endPC = (Int32)r.ReadU32();
+			f.AddInlineRange(startPC, endPC, (Int32)r.ReadU32());
+		}
+
+		// Children are later functions, or earlier ones with no children (see
+		// WriteFunction).  Earlier functions have been read, so that can be
+		// checked here.
+		Int32 childCount = r.ReadCount();
+		List<FuncDef> children = new List<FuncDef>();
+		for (Int32 i = 0; i < childCount; i++) {
+			UInt32 child = r.ReadU32();
+			if (child == (UInt32)index || child >= (UInt32)functions.Count) return false;
+			FuncDef childFunc = functions[(Int32)child];
+			if (child < (UInt32)index && childFunc.LazyChildren.Count != 0) return false;
+			children.Add(childFunc);
+		}
+
+		// Parameters and global names are small, and wanted as soon as anything
+		// calls the function, so decode them now.
+		Int32 headerEnd = r.ReadCount();
+		headerEnd += r.Pos;
+		if (!ReadValues(r, f.ParamNames, children)) return false;
+		if (!ReadValues(r, f.ParamDefaults, children)) return false;
+		if (!ReadValues(r, f.GlobalNames, children)) return false;
+		if (r.Pos != headerEnd || f.ParamDefaults.Count != f.ParamNames.Count) return false;
+		for (Int32 i = 0; i < f.GlobalNames.Count; i++) {
+			f.GlobalSlots.Add(-1);
+			f.GlobalIntrinsics.Add(Value.Null);
+		}
+
+		// The constant pool is only checked, and left for DecodeConstants.
+		Int32 constantsEnd = r.ReadCount();
+		constantsEnd += r.Pos;
+		Int32 constantsPos = r.Pos;
+		Int32 constantCount = r.ReadCount();
+		for (Int32 i = 0; i < constantCount && !r.Failed; i++) SkipValue(r, childCount);
+		if (r.Failed || r.Pos != constantsEnd) return false;
+		f.CacheSource = r;
+		f.LazyConstantsPos = constantsPos;
+		f.LazyChildren = children;
+
+		Int32 codeCount = r.ReadCount();
+		r.Align(4);
+		if (r.Failed || codeCount > (r.Count - r.Pos) / 4) return false;
+		for (Int32 i = 0; i < runs; i++) {
+			if ((UInt32)f.LineRunPC(i) > (UInt32)codeCount) return false;
+		}
+		for (Int32 i = 0; i < inlines; i++) {
+			UInt32 startPC = (UInt32)f.InlineRangeStart(i);
+			if (startPC > (UInt32)f.InlineRangeEnd(i) || (UInt32)f.InlineRangeEnd(i) > (UInt32)codeCount) return false;
+		}
+		//*** BEGIN CS_ONLY ***
+		for (Int32 i = 0; i < codeCount; i++) f.Code.Add(r.ReadU32());
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		// The file's words are already in this host's order: run them in place.
+		f.get_storage()->BorrowedCode = (const UInt32*)r.get_storage()->BytesAt(r.Pos());
+		f.get_storage()->BorrowedCount = codeCount;
+		r.Skip(codeCount * 4);
+		#else
+		for (Int32 i = 0; i < codeCount; i++) f.Code().Add(r.ReadU32());
+		#endif
+		*** END CPP_ONLY ***/
+		return !r.Failed;
+	}
+
+	// Decode a cached function's constant pool (see FuncDef.EnsureConstants).
+	// DeserializeFrom has already checked it, so this cannot fail.
+	public static void DecodeConstants(FuncDef f) {
+		ByteReader r = f.CacheSource.Cursor(f.LazyConstantsPos);
+		f.LazyConstantsPos = -1;
+		ReadValues(r, f.Constants, f.LazyChildren);
+		f.LazyChildren = null;
+		// Once its constants are in, a function needs the data only for code
+		// it runs in place, which C# never does.
+		f.CacheSource = null; // CPP: if (!f.get_storage()->BorrowedCode) f.set_CacheSource(nullptr);
+	}
+
+	private static Boolean ReadValues(ByteReader r, List<Value> values, List<FuncDef> children) {
+		Int32 count = r.ReadCount();
+		for (Int32 i = 0; i < count && !r.Failed; i++) values.Add(ReadValue(r, children));
+		return !r.Failed;
+	}
+
+	// Read one value; on bad data, sets r.Failed and returns null.
+	private static Value ReadValue(ByteReader r, List<FuncDef> children) {
+		Byte tag = r.ReadU8();
+		if (tag == kTagNull) return Value.Null;
+		if (tag == kTagNumber) return new Value(r.ReadDouble());
+		if (tag == kTagString) return Value.make_interned_string(r.ReadString());
+		if (tag == kTagFuncRef) {
+			UInt32 index = r.ReadU32();
+			if (index >= (UInt32)children.Count) {
+				r.Failed = true;
+				return Value.Null;
+			}
+			return Value.make_funcref(children[(Int32)index], Value.Null);
+		}
+		if (tag == kTagList) {
+			Int32 count = r.ReadCount();
+			Value list = Value.make_list(count);
+			for (Int32 i = 0; i < count && !r.Failed; i++) list.Push(ReadValue(r, children));
+			list.Freeze();
+			return list;
+		}
+		if (tag == kTagMap) {
+			Int32 count = r.ReadCount();
+			Value map = Value.make_map(count);
+			for (Int32 i = 0; i < count && !r.Failed; i++) {
+				Value k = ReadValue(r, children);
+				map.MapSet(k, ReadValue(r, children));
+			}
+			map.Freeze();
+			return map;
+		}
+		r.Failed = true;
+		return Value.Null;
+	}
+
+	// Step over one value without building it, checking it as ReadValue would.
+	private static void SkipValue(ByteReader r, Int32 childCount) {
+		Byte tag = r.ReadU8();
+		if (tag == kTagNull) return;
+		if (tag == kTagNumber) {
+			r.Skip(8);
+		} else if (tag == kTagString) {
+			r.Skip(r.ReadCount());
+		} else if (tag == kTagFuncRef) {
+			if (r.ReadU32() >= (UInt32)childCount) r.Failed = true;
+		} else if (tag == kTagList) {
+			Int32 count = r.ReadCount();
+			for (Int32 i = 0; i < count && !r.Failed; i++) SkipValue(r, childCount);
+		} else if (tag == kTagMap) {
+			Int32 count = r.ReadCount();
+			for (Int32 i = 0; i < count && !r.Failed; i++) {
+				SkipValue(r, childCount);
+				SkipValue(r, childCount);
+			}
+		} else {
+			r.Failed = true;
+		}
+	}
+
+	// ── File access ──────────────────────────────────────────────────────────
+
+	/*** BEGIN CPP_ONLY ***
+	// Create dir and any missing parents, as Directory.CreateDirectory does.
+	// Failures are left for the write that follows to find.
+	static void MakeDirectories(const String& dir) {
+		std::string path(dir.c_str());
+		for (size_t i = 1; i <= path.size(); i++) {
+			if (i < path.size() && path[i] != '/' && path[i] != '\\') continue;
+			if (path[i - 1] == '/' || path[i - 1] == '\\' || path[i - 1] == ':') continue;
+			std::string prefix = path.substr(0, i);
+			#ifdef _WIN32
+			_mkdir(prefix.c_str());
+			#else
+			mkdir(prefix.c_str(), 0777);
+			#endif
+		}
+	}
+	*** END CPP_ONLY ***/
+
+	// Write a file by way of a temporary name and a rename, so that another
+	// process reading the same cache never sees a half-written entry.  The
+	// temporary name holds the process id and a count, so no two writers --
+	// in other processes, or on other threads of this one -- share it.
+	private static void WriteFileBytes(String dir, String path, List<Byte> data) {
+		Lock();
+		_tempFileCount++;
+		Int32 tempNum = _tempFileCount;
+		Unlock();
+		//*** BEGIN CS_ONLY ***
+		try {
+			System.IO.Directory.CreateDirectory(dir);
+			String tmp = path + ".tmp" + System.Environment.ProcessId.ToString() + "." + tempNum.ToString();
+			System.IO.File.WriteAllBytes(tmp, data.ToArray());
+			System.IO.File.Move(tmp, path, true);
+		} catch (Exception) {
+			// (cache write failures are ignored)
+		}
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		MakeDirectories(dir);
+		#ifdef _WIN32
+		String tmp = path + ".tmp" + StringUtils::Format("{0}.{1}", (Int32)_getpid(), tempNum);
+		#else
+		String tmp = path + ".tmp" + StringUtils::Format("{0}.{1}", (Int32)getpid(), tempNum);
+		#endif
+		FILE* handle = fopen(tmp.c_str(), "wb");
+		if (!handle) return;
+		size_t n = (size_t)data.Count();
+		Boolean ok = (n == 0 || fwrite(&data[0], 1, n, handle) == n);
+		ok = (fclose(handle) == 0) && ok;
+		if (ok) {
+			#ifdef _WIN32
+			remove(path.c_str());
+			#endif
+			ok = (rename(tmp.c_str(), path.c_str()) == 0);
+		}
+		if (!ok) remove(tmp.c_str());
+		*** END CPP_ONLY ***/
+	}
+
+	private static void Lock() {
+		System.Threading.Monitor.Enter(_lock); // CPP: _mutex.lock();
+	}
+
+	private static void Unlock() {
+		System.Threading.Monitor.Exit(_lock); // CPP: _mutex.unlock();
+	}
+}
+
+}
@@ -0,0 +1,318 @@
+// Channel.cs
+//
+// Channels carry values between isolates: interpreters running at the same
+// time, each on its own thread with its own GC heap (see GCManager).  A
+// Channel is a bounded queue that any number of threads may send to and
+// receive from at once, without locks: a ring of slots, each with a sequence
+// number that says whose turn it is (Vyukov's bounded MPMC queue).  Send and
+// receive never wait; they report a full or empty channel, and the script
+// intrinsics built on them (send, receive) wait by yielding, so a script
+// waiting on a channel never blocks its thread.
+//
+// A Value is an index into its own isolate's heap, so a value cannot simply
+// be put in a channel.  ChannelMessage.Pack records it in a form that
+// belongs to no heap, and Unpack rebuilds it on the receiver's.  Numbers,
+// null, tiny strings and values published to the SharedHeap are the same in
+// every isolate, so they travel as they are, with nothing copied; that is how
+// a frozen value moves without a copy (publish it first, with `share`).
+// Anything else is copied: strings by content, lists and maps structurally,
+// keeping shared structure and cycles, and a frozen list or map arrives
+// frozen.  Functions, errors, handles, and globals or locals maps cannot be
+// sent.
+//
+// Channels are found by name (see Channels), since a name is a string and
+// so can be handed from one isolate to another like any other data.
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+using System;
+using System.Collections.Generic;
+// H: #include "value.h"
+// H: #include <atomic>
+// H: #include <memory>
+// CPP: #include "GCManager.g.h"
+// CPP: #include "StringUtils.g.h"
+/*** BEGIN CPP_ONLY ***
+#include <mutex>
+*** END CPP_ONLY ***/
+
+namespace MiniScript {
+
+// A value in transit: a structural copy that belongs to no isolate.
+public class ChannelMessage {
+	// Ops in the copy, each followed by its operands.
+	private const Int32 OpScalar = 0;	// index in _scalars
+	private const Int32 OpString = 1;	// index in _strings
+	private const Int32 OpList = 2;	// count, frozen (0 or 1); then count items
+	private const Int32 OpMap = 3;	// count, frozen (0 or 1); then count keys and values
+	private const Int32 OpRef = 4;	// a list or map already in the copy, by number
+
+	private Value _root = Value.Null;	// the whole value, when it needs no copy
+	private List<Int32> _ops = null;	// otherwise, the copy
+	private List<Value> _scalars = null;	// values the same in every isolate
+	private List<String> _strings = null;	// string contents
+	private Int32 _containerCount = 0;	// lists and maps in the copy
+
+	// While unpacking (in a reader: see Unpack): the next op, and each list
+	// and map made so far.
+	private Int32 _pos = 0;
+	private List<Value> _made = null;
+
+	public ChannelMessage() {
+	}
+
+	// A message carrying v, a value on the calling thread's heap; or null if
+	// v is or holds something that cannot be sent.
+	public static ChannelMessage Pack(Value v) {
+		ChannelMessage msg = new ChannelMessage();
+		if (!v.IsGCObject() || v.IsShared()) {
+			msg._root = v;
+			return msg;
+		}
+		msg._ops = new List<Int32>();
+		msg._scalars = new List<Value>();
+		msg._strings = new List<String>();
+		Dictionary<Int32, Int32> lists = new Dictionary<Int32, Int32>();
+		Dictionary<Int32, Int32> maps = new Dictionary<Int32, Int32>();
+		if (!msg.Add(v, lists, maps)) return null;
+		return msg;
+	}
+
+	// Append the ops for v; lists and maps number those already in the copy.
+	private Boolean Add(Value v, Dictionary<Int32, Int32> lists, Dictionary<Int32, Int32> maps) {
+		if (!v.IsGCObject() || v.IsShared()) {
+			_ops.Add(OpScalar);
+			_ops.Add(_scalars.Count);
+			_scalars.Add(v);
+			return true;
+		}
+		if (v.IsString()) {
+			_ops.Add(OpString);
+			_ops.Add(_strings.Count);
+			_strings.Add(GCManager.GetString(v).Data);	// (a heap string: tiny ones are not GC objects)
+			return true;
+		}
+		Int32 id;
+		if (v.IsList()) {
+			if (lists.TryGetValue(v.ItemIndex(), out id)) {
+				_ops.Add(OpRef);
+				_ops.Add(id);
+				return true;
+			}
+			lists[v.ItemIndex()] = _containerCount++;
+			GCList src = GCManager.Lists.Get(v.ItemIndex());
+			Int32 count = src.Count();
+			_ops.Add(OpList);
+			_ops.Add(count);
+			_ops.Add(src.Frozen ? 1 : 0);
+			for (Int32 i = 0; i < count; i++) {
+				if (!Add(src.Get(i), lists, maps)) return false;
+			}
+			return true;
+		}
+		if (v.IsMap()) {
+			if (maps.TryGetValue(v.ItemIndex(), out id)) {
+				_ops.Add(OpRef);
+				_ops.Add(id);
+				return true;
+			}
+			GCMap m = GCManager.Maps.Get(v.ItemIndex());
+			if (m._vmb != null || m._gb != null) return false;
+			maps[v.ItemIndex()] = _containerCount++;
+			_ops.Add(OpMap);
+			_ops.Add(m.Count());
+			_ops.Add(m.Frozen ? 1 : 0);
+			for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+				if (!Add(m.KeyAt(i), lists, maps)) return false;
+				if (!Add(m.ValueAt(i), lists, maps)) return false;
+			}
+			return true;
+		}
+		return false;	// function, error or handle
+	}
+
+	// The value, made on the calling thread's heap.  The message itself is
+	// not changed, so it may be unpacked any number of times, by any number
+	// of threads at once: the position and the containers made so far are
+	// kept in a reader of its own.
+	public Value Unpack() {
+		if (_ops == null) return _root;
+		ChannelMessage reader = new ChannelMessage();
+		reader._ops = _ops;
+		reader._scalars = _scalars;
+		reader._strings = _strings;
+		reader._made = new List<Value>();
+		return reader.Take();
+	}
+
+	// Make the value whose ops start at _pos, and move past them.
+	private Value Take() {
+		Int32 op = _ops[_pos];
+		Int32 arg = _ops[_pos + 1];
+		if (op == OpScalar) {
+			_pos += 2;
+			return _scalars[arg];
+		}
+		if (op == OpString) {
+			_pos += 2;
+			return Value.make_string(_strings[arg]);
+		}
+		if (op == OpRef) {
+			_pos += 2;
+			return _made[arg];
+		}
+		Int32 count = arg;
+		Boolean frozen = _ops[_pos + 2] != 0;
+		_pos += 3;
+		Value result;
+		if (op == OpList) {
+			result = Value.make_list(count);
+			_made.Add(result);
+			for (Int32 i = 0; i < count; i++) result.Push(Take());
+			if (frozen) GCManager.Lists.SetFrozen(result.ItemIndex(), true);
+		} else {
+			result = Value.make_map(count);
+			_made.Add(result);
+			for (Int32 i = 0; i < count; i++) {
+				Value key = Take();
+				result.MapSet(key, Take());
+			}
+			if (frozen) GCManager.Maps.SetFrozen(result.ItemIndex(), true);
+		}
+		return result;
+	}
+}
+
+// A bounded multi-producer, multi-consumer queue of messages, safe to use
+// from any number of threads at once.  Slot i of the ring holds position p
+// (p & mask == i) when its sequence number says so: p when it is free for
+// the sender of p, p+1 once that message is in it.  A sender or receiver
+// claims a position by advancing _tail or _head with a compare-and-swap, and
+// hands the slot on by storing the next sequence number.
+public class Channel {
+	private Int32 _mask;	// ring size - 1 (the size is a power of 2)
+
+	//*** BEGIN CS_ONLY ***
+	private ChannelMessage[] _slots;
+	private Int64[] _seq;
+	private Int64 _tail;	// next position to send to
+	private Int64 _head;	// next position to receive from
+	//*** END CS_ONLY ***
+	// H: private: std::unique_ptr<ChannelMessage[]> _slots;
+	// H: private: std::unique_ptr<std::atomic<Int64>[]> _seq;
+	// H: private: std::atomic<Int64> _tail{0};	// next position to send to
+	// H: private: std::atomic<Int64> _head{0};	// next position to receive from
+
+	// A channel with room for at least `capacity` messages (1 or more).
+	public Channel(Int32 capacity) {
+		Int32 size = 1;
+		while (size < capacity) size <<= 1;
+		_mask = size - 1;
+		_slots = new ChannelMessage[size]; // CPP: _slots.reset(new ChannelMessage[size]);
+		_seq = new Int64[size]; // CPP: _seq.reset(new std::atomic<Int64>[size]);
+		for (Int32 i = 0; i < size; i++) _seq[i] = i; // CPP: for (Int32 i = 0; i < size; i++) _seq[i].store(i, std::memory_order_relaxed);
+	}
+
+	public Int32 Capacity() {
+		return _mask + 1;
+	}
+
+	// Add msg to the channel.  Returns false, adding nothing, if it is full.
+	public Boolean TrySend(ChannelMessage msg) {
+		Int64 pos = System.Threading.Volatile.Read(ref _tail); // CPP: Int64 pos = _tail.load(std::memory_order_relaxed);
+		Int32 idx;
+		while (true) {
+			idx = (Int32)(pos & _mask);
+			Int64 seq = System.Threading.Volatile.Read(ref _seq[idx]); // CPP: Int64 seq = _seq[idx].load(std::memory_order_acquire);
+			if (seq == pos) {
+				Int64 seen = System.Threading.Interlocked.CompareExchange(ref _tail, pos + 1, pos); // CPP: Int64 seen = pos; _tail.compare_exchange_strong(seen, pos + 1, std::memory_order_relaxed);
+				if (seen == pos) break;
+				pos = seen;
+			} else if (seq < pos) {
+				return false;	// the slot still holds the message from a lap ago
+			} else {
+				pos = System.Threading.Volatile.Read(ref _tail); // CPP: pos = _tail.load(std::memory_order_relaxed);
+			}
+		}
+		_slots[idx] = msg;
+		System.Threading.Volatile.Write(ref _seq[idx], pos + 1); // CPP: _seq[idx].store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Take the oldest message from the channel; or null if it is empty.
+	public ChannelMessage TryReceive() {
+		Int64 pos = System.Threading.Volatile.Read(ref _head); // CPP: Int64 pos = _head.load(std::memory_order_relaxed);
+		Int32 idx;
+		while (true) {
+			idx = (Int32)(pos & _mask);
+			Int64 seq = System.Threading.Volatile.Read(ref _seq[idx]); // CPP: Int64 seq = _seq[idx].load(std::memory_order_acquire);
+			if (seq == pos + 1) {
+				Int64 seen = System.Threading.Interlocked.CompareExchange(ref _head, pos + 1, pos); // CPP: Int64 seen = pos; _head.compare_exchange_strong(seen, pos + 1, std::memory_order_relaxed);
+				if (seen == pos) break;
+				pos = seen;
+			} else if (seq < pos + 1) {
+				return null;	// nothing sent to this position yet
+			} else {
+				pos = System.Threading.Volatile.Read(ref _head); // CPP: pos = _head.load(std::memory_order_relaxed);
+			}
+		}
+		ChannelMessage msg = _slots[idx];
+		_slots[idx] = null;
+		System.Threading.Volatile.Write(ref _seq[idx], pos + _mask + 1); // CPP: _seq[idx].store(pos + _mask + 1, std::memory_order_release);
+		return msg;
+	}
+}
+
+// The process's channels, by name.  A channel is made the first time its
+// name is used, and lives until the process exits.  Each thread remembers
+// the channels it has looked up, so only a thread's first use of a name
+// takes the lock.
+public static class Channels {
+	public const Int32 DefaultCapacity = 64;
+	public const Int32 MaxCapacity = 1048576;
+
+	private static Dictionary<String, Channel> _all = new Dictionary<String, Channel>();	// guarded by the lock
+	private static Int32 _unnamedCount = 0;	// guarded by the lock
+	[ThreadStatic] private static Dictionary<String, Channel> _known;	// this thread's lookups
+
+	//*** BEGIN CS_ONLY ***
+	private static readonly Object _lock = new Object();
+	//*** END CS_ONLY ***
+	/*** BEGIN CPP_ONLY ***
+	static std::mutex _mutex;
+	*** END CPP_ONLY ***/
+
+	// The channel with the given name, made with room for `capacity`
+	// messages if there is none yet.
+	public static Channel Find(String name, Int32 capacity) {
+		if (_known == null) _known = new Dictionary<String, Channel>();
+		Channel ch;
+		if (_known.TryGetValue(name, out ch)) return ch;
+		Lock();
+		if (!_all.TryGetValue(name, out ch)) {
+			ch = new Channel(capacity);
+			_all[name] = ch;
+		}
+		Unlock();
+		_known[name] = ch;
+		return ch;
+	}
+
+	// A name that no channel has, for a new channel.
+	public static String NewName() {
+		Lock();
+		_unnamedCount++;
+		Int32 n = _unnamedCount;
+		Unlock();
+		return StringUtils.Format("channel#{0}", n);
+	}
+
+	private static void Lock() {
+		System.Threading.Monitor.Enter(_lock); // CPP: _mutex.lock();
+	}
+
+	private static void Unlock() {
+		System.Threading.Monitor.Exit(_lock); // CPP: _mutex.unlock();
+	}
+}
+
+}
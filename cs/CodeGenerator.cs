@@ -8,10 +8,10 @@ using System.Collections.Generic;
 // H: #include "ErrorTypes.g.h"
 // CPP: #include "StringUtils.g.h"
 // CPP: #include "CS_Math.h"
+// CPP: #include "Intrinsic.g.h"
 
 namespace MiniScript {
 
-
 // Compiles AST nodes to bytecode
 public class CodeGenerator : IASTVisitor {
 	private CodeEmitterBase _emitter;
@@ -38,10 +38,21 @@ public class CodeGenerator : IASTVisitor {
 	// reservation's first index.  See MayBeAssignedByEarlierIteration.
 	private List<String> _loopReserved;
 	private List<Int32> _loopReservedStarts;
+	// Constants the open loops' preheaders loaded into registers, and those
+	// registers: stacked end to end, innermost last, with _loopConstStarts giving
+	// each loop's first index.  See HoistLoopConstants.
+	private List<Value> _loopConstValues;
+	private List<Int32> _loopConstRegs;
+	private List<Int32> _loopConstStarts;
 	private Int32 _targetReg;           // Target register for next expression (-1 = allocate)
 	private List<Int32> _loopExitLabels;      // Stack of loop exit labels for break
 	private List<Int32> _loopContinueLabels;  // Stack of loop continue labels for continue
 	private List<FuncDef> _functions;          // Compile-time registry of all functions (for naming + disassembly)
+	// Functions whose calls may be compiled inline, by the name each was last
+	// assigned to.  Shared with nested generators, like _functions.
+	private Dictionary<String, InlineCandidate> _inlineCandidates;
+	private InlineCandidate _lastFunctionInline;    // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+	private Dictionary<String, Int32> _inlineParams;  // while compiling an inlined body: parameter name -> register of its argument
 
 	// True while compiling code whose named variables are GLOBALS rather than
 	// registers -- that is, @main and only @main.  A module compiled for `import`
@@ -74,10 +85,16 @@ public class CodeGenerator : IASTVisitor {
 		_loopNameMarks = new List<Int32>();
 		_loopReserved = new List<String>();
 		_loopReservedStarts = new List<Int32>();
+		_loopConstValues = new List<Value>();
+		_loopConstRegs = new List<Int32>();
+		_loopConstStarts = new List<Int32>();
 		_targetReg = -1;
 		_loopExitLabels = new List<Int32>();
 		_loopContinueLabels = new List<Int32>();
 		_functions = new List<FuncDef>();
+		_inlineCandidates = new Dictionary<String, InlineCandidate>();
+		_lastFunctionInline = null;
+		_inlineParams = new Dictionary<String, Int32>();
 		_globalScope = false;
 		Error = Value.Null;
 	}
@@ -113,6 +130,13 @@ public class CodeGenerator : IASTVisitor {
 		return reg;
 	}
 
+	// Mark a register in use again after FreeReg, when the caller knows nothing
+	// has been allocated since (see EmitInlinedCall).
+	private void ClaimReg(Int32 reg) {
+		_regInUse[reg] = true;
+		if (reg > _maxRegUsed) _maxRegUsed = reg;
+	}
+
 	// Free a register so it can be reused
 	private void FreeReg(Int32 reg) {
 		if (reg < 0 || reg >= _regInUse.Count) return;
@@ -194,6 +218,17 @@ public class CodeGenerator : IASTVisitor {
 		return false;
 	}
 
+	// Are all of these expressions constants (see TryEvaluateConstant)?  Such an
+	// expression reads no register, so nothing it does can see a destination
+	// that was written early.
+	private static Boolean AllConstant(List<ASTNode> nodes) {
+		Value unused;
+		for (Int32 i = 0; i < nodes.Count; i++) {
+			if (!TryEvaluateConstant(nodes[i], out unused)) return false;
+		}
+		return true;
+	}
+
 	// Compile an expression into a specific target register
 	// The target register should already be allocated by the caller
 	private Int32 CompileInto(ASTNode node, Int32 targetReg) {
@@ -212,6 +247,26 @@ public class CodeGenerator : IASTVisitor {
 		return AllocReg();
 	}
 
+	// Take the target register, if one was set, WITHOUT allocating one.  This is
+	// the other half of live-range reuse: a Visit method whose instruction reads
+	// all its operands before writing its result calls this at the start (for the
+	// same reason as GetTargetOrAlloc), evaluates and frees its operands, and only
+	// then calls ResultReg.  An operand's live range ends at the instruction that
+	// consumes it, so the result can take its register -- `a[i-1] + b` then needs
+	// three temps rather than five, and MaxRegs shrinks with the nesting depth.
+	private Int32 TakeTarget() {
+		Int32 target = _targetReg;
+		_targetReg = -1;
+		return target;
+	}
+
+	// The result register for a target taken by TakeTarget: the target itself, or
+	// the lowest free register.  Call after freeing the operands.
+	private Int32 ResultReg(Int32 target) {
+		if (target >= 0) return target;
+		return AllocReg();
+	}
+
 	// Compile an expression, placing result in a newly allocated register
 	// Returns the register number holding the result
 	public Int32 Compile(ASTNode ast) {
@@ -219,17 +274,25 @@ public class CodeGenerator : IASTVisitor {
 	}
 
 	// Reset temporary registers before compiling a new statement.
-	// Keeps r0 and all variable registers; frees everything else.
+	// Keeps r0 and all variable registers; frees everything else.  Temps are
+	// allocated lowest-first, so they fill any gaps between variable registers
+	// before going above them.  _maxRegUsed drops back to the highest variable
+	// register too; left at the previous statement's high water mark, it would
+	// put every later call's frame (see EmitCallSequence) needlessly high.
 	private void ResetTempRegisters() {
 		_regInUse.Clear();
 		_regInUse.Add(true);  // r0
 		_firstAvailable = 1;
+		_maxRegUsed = 0;
 		foreach (Int32 reg in _variableRegs.Values) { // CPP: for (Int32 reg : _variableRegs.GetValues()) {
 			while (_regInUse.Count <= reg) {
 				_regInUse.Add(false);
 			}
 			_regInUse[reg] = true;
-			if (reg >= _firstAvailable) _firstAvailable = reg + 1;
+			if (reg > _maxRegUsed) _maxRegUsed = reg;
+		}
+		while (_firstAvailable < _regInUse.Count && _regInUse[_firstAvailable]) {
+			_firstAvailable = _firstAvailable + 1;
 		}
 	}
 
@@ -569,7 +632,7 @@ public class CodeGenerator : IASTVisitor {
 		for (Int32 i = 0; i < names.Count; i++) {
 			Int32 reg;
 			if (!_variableRegs.TryGetValue(PendingVarRegKey(names[i]), out reg)) continue;
-			Int32 nameIdx = _emitter.AddConstant(Value.make_string(names[i]));
+			Int32 nameIdx = _emitter.AddConstant(Value.make_interned_string(names[i]));
 			_emitter.EmitAB(Opcode.NAME_rA_kBC, reg, nameIdx,
 				$"use r{reg} for {names[i]} (hoisted)");
 			PushName(names[i], true);
@@ -577,6 +640,132 @@ public class CodeGenerator : IASTVisitor {
 		return mark;
 	}
 
+	// ── Loop-invariant constants ─────────────────────────────────────────────
+	//
+	// An operand that is a literal -- the 1 in `j = j + 1`, the "k" in `m.k` --
+	// compiles to a LOAD into a temp right before the instruction that reads it,
+	// so in a loop it is reloaded on every iteration.  A constant is the one kind
+	// of operand that is invariant by construction, so the loop's preheader can
+	// load it into a register once and the body can read that register instead,
+	// saving a dispatch per use per iteration.
+	//
+	// Nothing else a loop reads can be hoisted this way without a guard.  Reading
+	// any variable may call a function (a funcref is invoked when read), and that
+	// function may rebind a global or change a list or map, so neither a global's
+	// value nor `len` of a list nor `m["k"]` is provably the same on the next
+	// iteration.  Global loads are made cheap where they are instead: see
+	// FuncDef.GlobalIntrinsics.
+	//
+	// The registers are parked in _variableRegs under internal keys, as the `for`
+	// loop's hidden registers are, so ResetTempRegisters keeps them live through
+	// the body, and IsLiveVariableReg counts them.  Only CompileOperand hands one
+	// out, and only to an instruction that reads it; such callers release it with
+	// FreeOperand, which leaves it alone.
+	private const Int32 kMaxLoopConstants = 8;
+
+	private static String LoopConstRegKey(Int32 index) {
+		return StringUtils.Format("@const {0}", index);
+	}
+
+	// Load the constants these loop nodes read as operands into registers, ahead
+	// of the loop, and open this loop's span of the table.  Constants an enclosing
+	// loop already holds are not loaded again.  Must be paired with
+	// ReleaseLoopConstants once the loop is closed.
+	private void HoistLoopConstants(ASTNode condition, List<ASTNode> body) {
+		_loopConstStarts.Add(_loopConstValues.Count);
+
+		LoopConstantCollector collector = new LoopConstantCollector();
+		if (condition != null) condition.Accept(collector);
+		collector.CollectAll(body);
+
+		Int32 hoisted = 0;
+		for (Int32 i = 0; i < collector.Values.Count && hoisted < kMaxLoopConstants; i++) {
+			Value value = collector.Values[i];
+			if (FindLoopConst(value) >= 0) continue;
+			Int32 reg = AllocReg();
+			_variableRegs[LoopConstRegKey(_loopConstValues.Count)] = reg;
+			_loopConstValues.Add(value);
+			_loopConstRegs.Add(reg);
+			EmitLoadConstant(reg, value, "(loop constant)");
+			hoisted++;
+		}
+	}
+
+	// Close the innermost loop's span of the table and free its registers.
+	private void ReleaseLoopConstants() {
+		Int32 start = _loopConstStarts[_loopConstStarts.Count - 1];
+		_loopConstStarts.RemoveAt(_loopConstStarts.Count - 1);
+		while (_loopConstValues.Count > start) {
+			Int32 last = _loopConstValues.Count - 1;
+			_variableRegs.Remove(LoopConstRegKey(last));
+			FreeReg(_loopConstRegs[last]);
+			_loopConstValues.RemoveAt(last);
+			_loopConstRegs.RemoveAt(last);
+		}
+	}
+
+	// The register an open loop holds this constant in, or -1.
+	private Int32 FindLoopConst(Value value) {
+		for (Int32 i = 0; i < _loopConstValues.Count; i++) {
+			if (LoopConstantCollector.SameConstant(_loopConstValues[i], value)) return _loopConstRegs[i];
+		}
+		return -1;
+	}
+
+	private Boolean IsLoopConstReg(Int32 reg) {
+		for (Int32 i = 0; i < _loopConstRegs.Count; i++) {
+			if (_loopConstRegs[i] == reg) return true;
+		}
+		return false;
+	}
+
+	// Compile an operand that the consuming instruction only reads.  A literal an
+	// open loop has hoisted comes back as the register holding it; anything else
+	// is compiled as usual.  Release the result with FreeOperand.
+	private Int32 CompileOperand(ASTNode node) {
+		if (_loopConstRegs.Count > 0) {
+			Int32 reg = -1;
+			NumberNode num = node as NumberNode;
+			StringNode str = node as StringNode;
+			if (num != null) reg = FindLoopConst(new Value(num.Value));
+			else if (str != null) reg = FindLoopConst(Value.make_interned_string(str.Value));
+			if (reg >= 0) return reg;
+		}
+		return node.Accept(this);
+	}
+
+	private void FreeOperand(Int32 reg) {
+		if (IsLoopConstReg(reg)) return;
+		FreeReg(reg);
+	}
+
+	// A register holding a member or method name, for METHFIND: an open loop's
+	// hoisted copy, or a temp loaded here.  Release it with FreeOperand.
+	private Int32 CompileKeyOperand(String key) {
+		Value keyVal = Value.make_interned_string(key);
+		Int32 reg = FindLoopConst(keyVal);
+		if (reg >= 0) return reg;
+		reg = AllocReg();
+		Int32 constIdx = _emitter.AddConstant(keyVal);
+		_emitter.EmitAB(Opcode.LOAD_rA_kBC, reg, constIdx, $"r{reg} = \"{key}\"");
+		return reg;
+	}
+
+	// Load a number or string constant into reg, as Visit(NumberNode) and
+	// Visit(StringNode) would.
+	private void EmitLoadConstant(Int32 reg, Value value, String note) {
+		if (value.IsNumber()) {
+			Double d = value.AsDouble();
+			if (d == Math.Floor(d) && d >= -32768 && d <= 32767) {
+				_emitter.EmitAB(Opcode.LOAD_rA_iBC, reg, (Int32)d, $"r{reg} = {d} {note}");
+				return;
+			}
+		}
+		Int32 constIdx = _emitter.AddConstant(value);
+		String text = value.Repr(null).AsCString();
+		_emitter.EmitAB(Opcode.LOAD_rA_kBC, reg, constIdx, $"r{reg} = {text} {note}");
+	}
+
 	// ── Definite assignment ──────────────────────────────────────────────────
 	//
 	// _namedStack holds the variables that are definitely assigned at the current
@@ -633,7 +822,7 @@ public class CodeGenerator : IASTVisitor {
 	// assigns the variable (e.g. both branches of a single-line if).
 	private void EnsureNamed(String varName, Int32 varReg) {
 		if (IsRegisterNamed(varName)) return;
-		Int32 nameIdx = _emitter.AddConstant(Value.make_string(varName));
+		Int32 nameIdx = _emitter.AddConstant(Value.make_interned_string(varName));
 		_emitter.EmitAB(Opcode.NAME_rA_kBC, varReg, nameIdx, $"use r{varReg} for {varName}");
 		PushName(varName, true);
 	}
@@ -777,7 +966,7 @@ public class CodeGenerator : IASTVisitor {
 	// operand of GLOADC/GLOADV/GSTORE is an index into that table, resolved to a
 	// slot number the first time the function runs against a given namespace.
 	private Int32 AddGlobalRef(String varName) {
-		Int32 refIdx = _emitter.AddGlobalRef(Value.make_string(varName));
+		Int32 refIdx = _emitter.AddGlobalRef(Value.make_interned_string(varName));
 		if (refIdx > 65535 && Error.IsNull()) {
 			Error = ErrorTypes.CompilerError("too many distinct global variables in one function", FileName, _emitter.CurrentLine);
 		}
@@ -851,6 +1040,7 @@ public class CodeGenerator : IASTVisitor {
 
 		_functions.Clear();
 		_functions.Add(null);
+		_inlineCandidates.Clear();
 
 		for (Int32 i = 0; i < statements.Count; i++) {
 			ResetTempRegisters();
@@ -881,6 +1071,7 @@ public class CodeGenerator : IASTVisitor {
 		// Reserve index 0 for @main
 		_functions.Clear();
 		_functions.Add(null);
+		_inlineCandidates.Clear();
 
 		BeginGlobalScope();
 
@@ -919,7 +1110,7 @@ public class CodeGenerator : IASTVisitor {
 
 	public Int32 Visit(StringNode node) {
 		Int32 reg = GetTargetOrAlloc();
-		Int32 constIdx = _emitter.AddConstant(Value.make_string(node.Value));
+		Int32 constIdx = _emitter.AddConstant(Value.make_interned_string(node.Value));
 		_emitter.EmitAB(Opcode.LOAD_rA_kBC, reg, constIdx, $"r{reg} = \"{node.Value}\"");
 		return reg;
 	}
@@ -941,6 +1132,19 @@ public class CodeGenerator : IASTVisitor {
 			return resultReg;
 		}
 
+		// A parameter of a function being compiled inline: it is the register its
+		// argument was evaluated into.  That is a temp, with no name to check, so
+		// this is the plain LOAD/LOADC rather than the name-checked forms.
+		Int32 paramReg;
+		if (_inlineParams.TryGetValue(node.Name, out paramReg)) {
+			if (addressOf) {
+				_emitter.EmitABC(Opcode.LOAD_rA_rB, resultReg, paramReg, 0, $"r{resultReg} = @{node.Name} (inlined param)");
+			} else {
+				_emitter.EmitABC(Opcode.LOADC_rA_rB, resultReg, paramReg, 0, $"r{resultReg} = {node.Name} (inlined param)");
+			}
+			return resultReg;
+		}
+
 		// Reading the variable that the assignment we are inside is creating.  The
 		// local does not exist yet, so this can only mean the enclosing scope's
 		// variable of the same name -- and on the next time through a loop it would
@@ -964,7 +1168,7 @@ public class CodeGenerator : IASTVisitor {
 			}
 			Int32 checkReg;
 			if (_variableRegs.TryGetValue(node.Name, out checkReg)) {
-				Int32 checkIdx = _emitter.AddConstant(Value.make_string(node.Name));
+				Int32 checkIdx = _emitter.AddConstant(Value.make_interned_string(node.Name));
 				_emitter.EmitAB(Opcode.CHKNAME_rA_kBC, checkReg, checkIdx,
 					$"require r{checkReg} to be holding {node.Name}");
 			}
@@ -974,7 +1178,7 @@ public class CodeGenerator : IASTVisitor {
 		String at = addressOf ? "@" : "";
 		if (_variableRegs.TryGetValue(node.Name, out varReg)) {
 			// Variable found - emit LOADC (load-and-call for implicit function invocation)
-			EmitNamedLoad(addressOf, resultReg, varReg, Value.make_string(node.Name),
+			EmitNamedLoad(addressOf, resultReg, varReg, Value.make_interned_string(node.Name),
 				$"r{resultReg} = {at}{node.Name}");
 		} else if (_variableRegs.TryGetValue(PendingVarRegKey(node.Name), out varReg)) {
 			// The local does not exist yet, but an enclosing loop has reserved the
@@ -985,7 +1189,7 @@ public class CodeGenerator : IASTVisitor {
 			// makes the guard match, so until the assignment has run once this falls
 			// back to the run-time search and finds the enclosing scope, and from then
 			// on it finds the local that now shadows it.
-			EmitNamedLoad(addressOf, resultReg, varReg, Value.make_string(node.Name),
+			EmitNamedLoad(addressOf, resultReg, varReg, Value.make_interned_string(node.Name),
 				$"r{resultReg} = {at}{node.Name} (outer until assigned)");
 		} else {
 			// Variable has no register here: at global scope it is a slot, and
@@ -1135,6 +1339,7 @@ public class CodeGenerator : IASTVisitor {
 		if (rhsFunc != null && funcIndexBeforeRHS < _functions.Count) {
 			FuncDef rhsFuncDef = _functions[funcIndexBeforeRHS];
 			if (rhsFuncDef != null) rhsFuncDef.Name = node.Variable;
+			NoteFunctionAssignment(node.Variable);
 		}
 
 		// Note that we don't FreeReg(varReg) here, as we need this register to
@@ -1171,6 +1376,7 @@ public class CodeGenerator : IASTVisitor {
 		if (rhsFunc != null && funcIndexBeforeRHS < _functions.Count) {
 			FuncDef rhsFuncDef = _functions[funcIndexBeforeRHS];
 			if (rhsFuncDef != null) rhsFuncDef.Name = node.Variable;
+			NoteFunctionAssignment(node.Variable);
 		}
 
 		EmitGlobalStore(node.Variable, valueReg);
@@ -1179,7 +1385,7 @@ public class CodeGenerator : IASTVisitor {
 
 	public Int32 Visit(IndexedAssignmentNode node) {
 		Int32 containerReg = node.Target.Accept(this);
-		Int32 indexReg = node.Index.Accept(this);
+		Int32 indexReg = CompileOperand(node.Index);
 
 		// If the RHS is a function expression, note the current function count so we
 		// can assign a name to the resulting FuncDef afterward.
@@ -1214,7 +1420,7 @@ public class CodeGenerator : IASTVisitor {
 		}
 
 		FreeReg(valueReg);
-		FreeReg(indexReg);
+		FreeOperand(indexReg);
 		return containerReg;
 	}
 
@@ -1231,7 +1437,8 @@ public class CodeGenerator : IASTVisitor {
 			return node.Operand.Accept(this);
 		}
 			
-		Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
+		Int32 target = TakeTarget();  // Capture target before any recursive calls
+		Int32 resultReg;
 
 		Int32 operandReg = node.Operand.Accept(this);
 
@@ -1239,23 +1446,27 @@ public class CodeGenerator : IASTVisitor {
 			// Negate: result = 0 - operand
 			Int32 zeroReg = AllocReg();
 			_emitter.EmitAB(Opcode.LOAD_rA_iBC, zeroReg, 0, "r{zeroReg} = 0 (for negation)");
-			_emitter.EmitABC(Opcode.SUB_rA_rB_rC, resultReg, zeroReg, operandReg, $"r{resultReg} = -{node.Operand.ToStr()}");
 			FreeReg(zeroReg);
 			FreeReg(operandReg);
+			resultReg = ResultReg(target);
+			_emitter.EmitABC(Opcode.SUB_rA_rB_rC, resultReg, zeroReg, operandReg, $"r{resultReg} = -{node.Operand.ToStr()}");
 			return resultReg;
 		} else if (node.Op == Op.NOT) {
 			// Fuzzy logic NOT: 1 - AbsClamp01(operand)
-			_emitter.EmitABC(Opcode.NOT_rA_rB, resultReg, operandReg, 0, $"not {node.Operand.ToStr()}");
 			FreeReg(operandReg);
+			resultReg = ResultReg(target);
+			_emitter.EmitABC(Opcode.NOT_rA_rB, resultReg, operandReg, 0, $"not {node.Operand.ToStr()}");
 			return resultReg;
 		} else if (node.Op == Op.NEW) {
 			// new: create a map with __isa set to the operand
-			_emitter.EmitABC(Opcode.NEW_rA_rB, resultReg, operandReg, 0, $"new {node.Operand.ToStr()}");
 			FreeReg(operandReg);
+			resultReg = ResultReg(target);
+			_emitter.EmitABC(Opcode.NEW_rA_rB, resultReg, operandReg, 0, $"new {node.Operand.ToStr()}");
 			return resultReg;
 		}
 
 		// Unknown unary operator - move operand to result if needed
+		resultReg = ResultReg(target);
 		if (Error.IsNull()) Error = ErrorTypes.CompilerError("unknown unary operator", FileName, _emitter.CurrentLine);
 		if (operandReg != resultReg) {
 			_emitter.EmitABC(Opcode.LOAD_rA_rB, resultReg, operandReg, 0, "move to target");
@@ -1271,9 +1482,12 @@ public class CodeGenerator : IASTVisitor {
 			return CompileShortCircuit(node);
 		}
 
-		Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
-		Int32 leftReg = node.Left.Accept(this);
-		Int32 rightReg = node.Right.Accept(this);
+		Int32 target = TakeTarget();  // Capture target before any recursive calls
+		Int32 leftReg = CompileOperand(node.Left);
+		Int32 rightReg = CompileOperand(node.Right);
+		FreeOperand(rightReg);
+		FreeOperand(leftReg);
+		Int32 resultReg = ResultReg(target);
 
 		Opcode op = Opcode.NOOP;
 		String opSymbol = "?";
@@ -1334,8 +1548,6 @@ public class CodeGenerator : IASTVisitor {
 				$"r{resultReg} = {node.Left.ToStr()} {opSymbol} {node.Right.ToStr()}");
 		}
 
-		FreeReg(rightReg);
-		FreeReg(leftReg);
 		return resultReg;
 	}
 
@@ -1349,9 +1561,30 @@ public class CodeGenerator : IASTVisitor {
 		Int32 resultReg = GetTargetOrAlloc();
 		Int32 doneLabel = _emitter.CreateLabel();
 
-		Int32 leftReg = node.Left.Accept(this);
+		// Evaluate the left operand straight into the result register when nothing
+		// can tell the difference: every path either keeps the left value as the
+		// result or overwrites it, and only a variable's register (which the right
+		// operand might read) has to stay untouched until the end.  That saves a
+		// register, and for 'and' the copy on the error path.
+		Int32 leftReg;
+		if (IsLiveVariableReg(resultReg)) leftReg = node.Left.Accept(this);
+		else leftReg = CompileInto(node.Left, resultReg);
+
+		if (isAnd && leftReg == resultReg) {
+			// As below, but an error left is already the result.
+			Int32 zeroLabel = _emitter.CreateLabel();
+			_emitter.EmitBranch(Opcode.BRERR_rA_iBC, leftReg, doneLabel, "short-circuit 'and': left is error");
+			_emitter.EmitBranch(Opcode.BRFALSE_rA_iBC, leftReg, zeroLabel, "short-circuit 'and': left is false");
 
-		if (isAnd) {
+			Int32 rightReg = node.Right.Accept(this);
+			_emitter.EmitABC(Opcode.AND_rA_rB_rC, resultReg, leftReg, rightReg,
+				$"r{resultReg} = {node.Left.ToStr()} and {node.Right.ToStr()}");
+			FreeReg(rightReg);
+			_emitter.EmitJump(Opcode.JUMP_iABC, doneLabel, "skip short-circuit value");
+
+			_emitter.PlaceLabel(zeroLabel);
+			_emitter.EmitAB(Opcode.LOAD_rA_iBC, resultReg, 0, $"r{resultReg} = 0 (short-circuit)");
+		} else if (isAnd) {
 			// 'and': error left -> result is the error; false left -> result 0;
 			// true left -> evaluate right and combine with the fuzzy AND op.
 			Int32 errLabel = _emitter.CreateLabel();
@@ -1399,19 +1632,22 @@ public class CodeGenerator : IASTVisitor {
 			_emitter.EmitAB(Opcode.LOAD_rA_iBC, resultReg, 1, $"r{resultReg} = 1 (short-circuit)");
 		}
 
-		FreeReg(leftReg);
+		if (leftReg != resultReg) FreeReg(leftReg);
 		_emitter.PlaceLabel(doneLabel);
 		return resultReg;
 	}
 
 	public Int32 Visit(ComparisonChainNode node) {
-		Int32 resultReg = GetTargetOrAlloc();
+		Int32 target = TakeTarget();
 
-		// Evaluate ALL operands first (each exactly once)
+		// Evaluate ALL operands first (each exactly once).  The first is read only
+		// by the first comparison, so the result may share its register.
 		List<Int32> valueRegs = new List<Int32>();
 		for (Int32 i = 0; i < node.Operands.Count; i++) {
 			valueRegs.Add(node.Operands[i].Accept(this));
 		}
+		FreeReg(valueRegs[0]);
+		Int32 resultReg = ResultReg(target);
 
 		// First comparison → resultReg
 		EmitComparison(node.Operators[0], resultReg, valueRegs[0], valueRegs[1]);
@@ -1425,7 +1661,7 @@ public class CodeGenerator : IASTVisitor {
 		}
 
 		// Free operand registers
-		for (Int32 i = 0; i < valueRegs.Count; i++) {
+		for (Int32 i = 1; i < valueRegs.Count; i++) {
 			FreeReg(valueRegs[i]);
 		}
 
@@ -1461,6 +1697,16 @@ public class CodeGenerator : IASTVisitor {
 			return CompileUserCall(node, funcVarReg, explicitTarget);
 		}
 
+		// A built-in intrinsic (that is not about to be inlined in its place):
+		// call it by number, without fetching the funcref by name.
+		Int32 intrinsicIdx = Intrinsic.DirectCallIndex(node.Function);
+		InlineCandidate inlined = FindInlineCandidate(node);
+		if (intrinsicIdx >= 0 && intrinsicIdx <= 255 && inlined == null) {
+			List<Int32> argRegs = CompileArguments(node.Arguments);
+			return EmitArgsAndCall(Opcode.CALLINTRINSIC_rA_rB_iC, intrinsicIdx, argRegs, explicitTarget,
+				$"call intrinsic {node.Function}");
+		}
+
 		// Not a known local — fetch the funcref by name, without auto-invoking it
 		// (so, the LOADV/GLOADV side of the pair rather than LOADC/GLOADC).
 		Int32 funcReg = AllocReg();
@@ -1475,9 +1721,126 @@ public class CodeGenerator : IASTVisitor {
 	// Compile a call to a user-defined function (funcref in a register)
 	private Int32 CompileUserCall(CallNode node, Int32 funcVarReg, Int32 explicitTarget) {
 		List<Int32> argRegs = CompileArguments(node.Arguments);
+		InlineCandidate candidate = FindInlineCandidate(node);
+		if (candidate != null) return EmitInlinedCall(node, candidate, funcVarReg, argRegs, explicitTarget);
 		return EmitCallSequence(funcVarReg, argRegs, explicitTarget, $"call {node.Function}");
 	}
 
+	// ── Inlining ─────────────────────────────────────────────────────────────
+
+	// Largest returned expression (in AST nodes, as NodeCounter counts them)
+	// that a call may be replaced with.
+	private const Int32 kMaxInlineNodes = 16;
+
+	// If calls to the function compiled from this node may be compiled inline,
+	// return what that takes; otherwise null.  The body must be a single
+	// `return` of a small expression that reads nothing but the parameters
+	// (InlineChecker).  So it makes no calls -- it is not recursive, and has no
+	// frame of its own to be missed -- and it needs nothing from the callee's
+	// scope, so it means the same in the caller's.
+	private static InlineCandidate MakeInlineCandidate(FunctionNode node, FuncDef funcDef, Value funcTemplate) {
+		if (node.Body.Count != 1) return null;
+		ReturnNode ret = node.Body[0] as ReturnNode;
+		if (ret == null || ret.Value == null) return null;
+		if (node.ParamNames.Contains("self")) return null;
+		NodeCounter counter = new NodeCounter();
+		if (ret.Value.Accept(counter) > kMaxInlineNodes) return null;
+		InlineChecker checker = new InlineChecker(node.ParamNames);
+		if (ret.Value.Accept(checker) == 0) return null;
+		return new InlineCandidate(funcDef, funcTemplate, node.ParamNames, ret.Value, ret.Line);
+	}
+
+	// After compiling `name = function ...`, note whether that function can be
+	// inlined where name is called.  The binding is only a guess (name may be
+	// reassigned, or mean a different variable where it is called), which is
+	// fine: the inlined code checks it (see EmitInlinedCall).
+	private void NoteFunctionAssignment(String name) {
+		if (_lastFunctionInline != null) {
+			_inlineCandidates[name] = _lastFunctionInline;
+		} else {
+			_inlineCandidates.Remove(name);
+		}
+	}
+
+	// The function this call may be inlined from, or null.
+	private InlineCandidate FindInlineCandidate(CallNode node) {
+		if (!_inlineCandidates.ContainsKey(node.Function)) return null;
+		InlineCandidate candidate = _inlineCandidates[node.Function];
+		// Too many arguments is an error, which the real call reports.
+		if (node.Arguments.Count > candidate.ParamNames.Count) return null;
+		return candidate;
+	}
+
+	// Compile a call to a function that may be inlined.  What the name refers to
+	// is only known at run time, so the inlined body is guarded: it runs when
+	// IFFUNC finds the funcref being called is (a closure of) the function we
+	// inlined, and otherwise the call is made as usual:
+	//
+	//     IFFUNC rF, k          ; rF still the function in k?
+	//     JUMP   inline
+	//     ARGBLK/ARG/CALL       ; no: call whatever it is now
+	//     JUMP   done
+	//   inline:
+	//     (the body, reading the argument registers as its parameters)
+	//   done:
+	//
+	// The body's code carries the callee's line numbers, and its PC range is
+	// recorded in the caller (FuncDef.AddInlineRange), so a stack trace taken
+	// inside it still shows both the function and the call.
+	private Int32 EmitInlinedCall(CallNode node, InlineCandidate candidate, Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget) {
+		// Choose the result register while the arguments are live: the body may
+		// write it (e.g. LIST) before it has read them all.
+		Int32 resultReg = ResultReg(explicitTarget);
+		Int32 guardIdx = _emitter.AddConstant(candidate.Template);
+		Int32 inlineLabel = _emitter.CreateLabel();
+		Int32 doneLabel = _emitter.CreateLabel();
+
+		_emitter.EmitAB(Opcode.IFFUNC_rA_kBC, funcReg, guardIdx, $"is {node.Function} still {candidate.Func.Name}?");
+		_emitter.EmitJump(Opcode.JUMP_iABC, inlineLabel, "yes: inline it");
+		EmitCallSequence(funcReg, argRegs, resultReg, $"call {node.Function}");
+		_emitter.EmitJump(Opcode.JUMP_iABC, doneLabel, null);
+
+		// EmitCallSequence freed the arguments, and nothing has been allocated
+		// since; the inlined body reads them, so take them back.
+		_emitter.PlaceLabel(inlineLabel);
+		for (Int32 i = 0; i < argRegs.Count; i++) ClaimReg(argRegs[i]);
+		List<Int32> paramRegs = new List<Int32>();
+		for (Int32 i = 0; i < candidate.ParamNames.Count; i++) {
+			Int32 reg;
+			if (i < argRegs.Count) {
+				reg = argRegs[i];
+			} else {
+				// Omitted argument: its default, which is always a constant.
+				reg = AllocReg();
+				Value defaultVal = candidate.Func.ParamDefaults[i];
+				if (defaultVal.IsNull()) {
+					_emitter.EmitA(Opcode.LOADNULL_rA, reg, $"r{reg} = null (default)");
+				} else {
+					Int32 constIdx = _emitter.AddConstant(defaultVal);
+					_emitter.EmitAB(Opcode.LOAD_rA_kBC, reg, constIdx, $"r{reg} = default for {candidate.ParamNames[i]}");
+				}
+			}
+			paramRegs.Add(reg);
+			String paramName = candidate.ParamNames[i];
+			_inlineParams[paramName] = reg;
+		}
+
+		Int32 callLine = _emitter.CurrentLine;
+		Int32 startPC = _emitter.PendingFunc.Code.Count;
+		if (candidate.Line != 0) _emitter.CurrentLine = candidate.Line;
+		Int32 bodyReg = CompileInto(candidate.Body, resultReg);
+		if (bodyReg != resultReg) {
+			_emitter.EmitABC(Opcode.LOAD_rA_rB, resultReg, bodyReg, 0, $"r{resultReg} = r{bodyReg}");
+		}
+		_emitter.CurrentLine = callLine;
+		_emitter.PendingFunc.AddInlineRange(startPC, _emitter.PendingFunc.Code.Count, callLine);
+		_inlineParams.Clear();
+		for (Int32 i = 0; i < paramRegs.Count; i++) FreeReg(paramRegs[i]);
+
+		_emitter.PlaceLabel(doneLabel);
+		return resultReg;
+	}
+
 	// Compile argument expressions into temporary registers.
 	private List<Int32> CompileArguments(List<ASTNode> arguments) {
 		List<Int32> argRegs = new List<Int32>();
@@ -1490,6 +1853,15 @@ public class CodeGenerator : IASTVisitor {
 	// Emit ARGBLK + ARG instructions, compute callee frame, emit CALL, and free
 	// the argument registers.  Returns the result register.
 	private Int32 EmitCallSequence(Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget, String comment) {
+		return EmitArgsAndCall(Opcode.CALL_rA_rB_rC, funcReg, argRegs, explicitTarget, comment);
+	}
+
+	// The same, ending in the given call opcode: CALL, with the funcref
+	// register as its C operand, or CALLINTRINSIC, with the intrinsic's index.
+	// A name bound to an intrinsic at compile time can still be shadowed by
+	// the time the call runs, so CALLINTRINSIC checks that it is not, and if
+	// it is, calls what the name means then, with these same arguments.
+	private Int32 EmitArgsAndCall(Opcode callOp, Int32 operandC, List<Int32> argRegs, Int32 explicitTarget, String comment) {
 		Int32 argCount = argRegs.Count;
 
 		// Emit ARGBLK + ARG instructions
@@ -1502,17 +1874,18 @@ public class CodeGenerator : IASTVisitor {
 		Int32 calleeBase = _maxRegUsed + 1;
 		_emitter.ReserveRegister(calleeBase);
 
-		// Determine result register
-		Int32 resultReg = (explicitTarget >= 0) ? explicitTarget : AllocReg();
-
-		// Emit CALL: result in rA, callee frame at rB, funcref in rC
-		_emitter.EmitABC(Opcode.CALL_rA_rB_rC, resultReg, calleeBase, funcReg,
-			$"{comment}, result to r{resultReg}");
-
-		// Free argument registers
+		// The arguments are dead once ARG has copied them into the callee frame, so
+		// the result may take one of their registers (the CALL writes it only when
+		// the callee returns).  The frame base above was chosen while they were
+		// still live, which keeps it clear of them.
 		for (Int32 i = 0; i < argCount; i++) {
 			FreeReg(argRegs[i]);
 		}
+		Int32 resultReg = ResultReg(explicitTarget);
+
+		// Emit CALL: result in rA, callee frame at rB, funcref (or intrinsic) in C
+		_emitter.EmitABC(callOp, resultReg, calleeBase, operandC,
+			$"{comment}, result to r{resultReg}");
 
 		return resultReg;
 	}
@@ -1528,9 +1901,11 @@ public class CodeGenerator : IASTVisitor {
 		// LIST writes its destination before the elements are evaluated, so if the
 		// destination holds a live variable, an element that reads that variable would
 		// see the new (empty) list instead -- e.g. "x = [x]" would build a list
-		// containing itself.  Build in a temp and copy at the end.
+		// containing itself.  Build in a temp and copy at the end -- unless every
+		// element is a constant, so that nothing can read the variable (`x = []`,
+		// the common case, needs no copy).
 		Int32 buildReg = listReg;
-		if (IsLiveVariableReg(listReg)) buildReg = AllocReg();
+		if (IsLiveVariableReg(listReg) && !AllConstant(node.Elements)) buildReg = AllocReg();
 
 		// Create a list with the given number of elements
 		Int32 count = node.Elements.Count;
@@ -1555,9 +1930,12 @@ public class CodeGenerator : IASTVisitor {
 		Int32 mapReg = GetTargetOrAlloc();
 
 		// As in Visit(ListNode): MAP writes its destination before the keys and values
-		// are evaluated, so build in a temp when the destination is live.
+		// are evaluated, so build in a temp when the destination is live and some key
+		// or value could read it.
 		Int32 buildReg = mapReg;
-		if (IsLiveVariableReg(mapReg)) buildReg = AllocReg();
+		if (IsLiveVariableReg(mapReg) && !(AllConstant(node.Keys) && AllConstant(node.Values))) {
+			buildReg = AllocReg();
+		}
 
 		// Create a map
 		Int32 count = node.Keys.Count;
@@ -1586,20 +1964,20 @@ public class CodeGenerator : IASTVisitor {
 
 	// Compile index access, optionally as address-of (no auto-invoke)
 	private Int32 VisitIndex(IndexNode node, bool addressOf) {
-		Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
+		Int32 target = TakeTarget();  // Capture target before any recursive calls
 		Int32 targetReg = node.Target.Accept(this);
-		Int32 indexReg = node.Index.Accept(this);
+		Int32 indexReg = CompileOperand(node.Index);
 		String comment = $"{node.Target.ToStr()}[{node.Index.ToStr()}]";
 
-		EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, false, node.Target, comment);
-
-		FreeReg(indexReg);
+		FreeOperand(indexReg);
 		FreeReg(targetReg);
+		Int32 resultReg = ResultReg(target);
+		EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, false, node.Target, comment);
 		return resultReg;
 	}
 
 	public Int32 Visit(SliceNode node) {
-		Int32 resultReg = GetTargetOrAlloc();
+		Int32 target = TakeTarget();
 		Int32 containerReg = node.Target.Accept(this);
 
 		// Allocate two consecutive registers for start and end indices
@@ -1618,12 +1996,12 @@ public class CodeGenerator : IASTVisitor {
 			_emitter.EmitA(Opcode.LOADNULL_rA, endReg, $"r{endReg} = null (slice end)");
 		}
 
-		_emitter.EmitABC(Opcode.SLICE_rA_rB_rC, resultReg, containerReg, startReg,
-			$"r{resultReg} = {node.Target.ToStr()}[{node.ToStr()}]");
-
 		FreeReg(endReg);
 		FreeReg(startReg);
 		FreeReg(containerReg);
+		Int32 resultReg = ResultReg(target);
+		_emitter.EmitABC(Opcode.SLICE_rA_rB_rC, resultReg, containerReg, startReg,
+			$"r{resultReg} = {node.Target.ToStr()}[{node.ToStr()}]");
 		return resultReg;
 	}
 
@@ -1633,17 +2011,15 @@ public class CodeGenerator : IASTVisitor {
 
 	// Compile member access, optionally as address-of (no auto-invoke)
 	private Int32 VisitMember(MemberNode node, bool addressOf) {
-		Int32 resultReg = GetTargetOrAlloc();
+		Int32 target = TakeTarget();
 		Int32 targetReg = node.Target.Accept(this);
-		Int32 indexReg = AllocReg();
-		Int32 constIdx = _emitter.AddConstant(Value.make_string(node.Member));
-		_emitter.EmitAB(Opcode.LOAD_rA_kBC, indexReg, constIdx, $"r{indexReg} = \"{node.Member}\"");
+		Int32 indexReg = CompileKeyOperand(node.Member);
 		String comment = $"{node.Target.ToStr()}.{node.Member}";
 
-		EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, true, node.Target, comment);
-
-		FreeReg(indexReg);
+		FreeOperand(indexReg);
 		FreeReg(targetReg);
+		Int32 resultReg = ResultReg(target);
+		EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, true, node.Target, comment);
 		return resultReg;
 	}
 
@@ -1760,6 +2136,7 @@ public class CodeGenerator : IASTVisitor {
 		// at the bottom of the body, so the steady state costs one branch per
 		// iteration instead of a branch plus an unconditional jump.
 		//
+		//       [loop constants]
 		//       [evaluate condition]     <-- preheader copy
 		//       BRFALSE condReg, afterLoop
 		//       [hoisted NAME ops]
@@ -1798,8 +2175,10 @@ public class CodeGenerator : IASTVisitor {
 		// ReserveBodyVarRegs.
 		List<String> reserved = ReserveBodyVarRegs(node.Body);
 
-		// Preheader: the entry test.  A constant-true condition needs none -- the
+		// Preheader: the constants the loop reads (see HoistLoopConstants), then
+		// the entry test.  A constant-true condition needs no test -- the
 		// body always runs -- and emitting one would only add dead code.
+		HoistLoopConstants(node.Condition, node.Body);
 		if (!alwaysRuns) {
 			Int32 condReg = node.Condition.Accept(this);
 			_emitter.EmitBranch(Opcode.BRFALSE_rA_iBC, condReg, afterLoop, "skip loop if false");
@@ -1825,6 +2204,7 @@ public class CodeGenerator : IASTVisitor {
 			FreeReg(backReg);
 		}
 
+		ReleaseLoopConstants();
 		ReleaseBodyVarRegs(reserved);
 		_emitter.PlaceLabel(afterLoop);
 
@@ -1852,6 +2232,16 @@ public class CodeGenerator : IASTVisitor {
 		//       [else body]
 		//   afterIf:
 
+		// A condition that always holds needs no test, and then the body is not
+		// conditional at all: its assignments stand afterward, as if it had been
+		// written inline.  IfNode.Simplify leaves a constant-condition if in
+		// this form (having dropped whichever arm cannot run).
+		NumberNode literal = node.Condition as NumberNode;
+		if (literal != null && literal.Value != 0 && node.ElseBody.Count == 0) {
+			CompileBody(node.ThenBody);
+			return -1;
+		}
+
 		Int32 afterIf = _emitter.CreateLabel();
 		Int32 elseLabel = (node.ElseBody.Count > 0) ? _emitter.CreateLabel() : afterIf;
 
@@ -1901,24 +2291,27 @@ public class CodeGenerator : IASTVisitor {
 	}
 
 	public Int32 Visit(ForNode node) {
-		// For loop generates (using NEXT opcode for performance):
+		// For loop generates (using the fused ITERNEXT opcode for performance):
 		//   [evaluate iterable into listReg]
-		//   indexReg = -1  (NEXT increments before checking)
+		//   indexReg = -1  (ITERNEXT increments before checking)
 		// loopStart:
-		//   NEXT indexReg, listReg  (indexReg++; if indexReg >= len(listReg) skip next)
+		//   ITERNEXT varReg, listReg, indexReg  (indexReg++; if there is an
+		//                           element there, varReg = it and skip next)
 		//   JUMP afterLoop          (skipped unless we've reached the end)
-		//   varReg = listReg[indexReg]
 		//   [body statements]
 		//   JUMP loopStart
 		// afterLoop:
 		//
-		// At function scope the first NEXT/ITERGET is peeled off into a preheader, so
+		// ITERNEXT steps a computed `range` list with plain arithmetic, so a `for`
+		// over `range(n)` costs about what a `while` loop on a counter does: one
+		// ITERNEXT and one JUMP per iteration, with nothing materialized.
+		//
+		// At function scope the first ITERNEXT is peeled off into a preheader, so
 		// that the loop variable's NAME has somewhere to sit that runs once and only
 		// when there is a first element:
 		//
-		//   NEXT indexReg, listReg
+		//   ITERNEXT varReg, listReg, indexReg
 		//   JUMP afterLoop          (zero iterations: the variable never comes to be)
-		//   varReg = listReg[indexReg]
 		//   NAME varReg, "v"
 		//   JUMP bodyStart
 		// loopStart:
@@ -1931,7 +2324,7 @@ public class CodeGenerator : IASTVisitor {
 		// times, because NAME is what makes a variable exist -- emitting it ahead of
 		// the loop outright left `for j in []` with a defined `j` where MiniScript 1
 		// raises Undefined Identifier (bugs.md entry 6).  Peeling satisfies both, at
-		// four instructions of code size and nothing per iteration.
+		// three instructions of code size and nothing per iteration.
 		//
 		// Global scope keeps the plain layout: top-level names are slots in the
 		// Globals table, no NAME is emitted for them, and the zero-iteration case is
@@ -1949,7 +2342,7 @@ public class CodeGenerator : IASTVisitor {
 		// Evaluate iterable expression
 		Int32 listReg = node.Iterable.Accept(this);
 
-		// Allocate hidden index register (starts at -1; NEXT will increment to 0)
+		// Allocate hidden index register (starts at -1; ITERNEXT will increment to 0)
 		Int32 indexReg = AllocReg();
 		_emitter.EmitAB(Opcode.LOAD_rA_iBC, indexReg, -1, "for loop index = -1");
 
@@ -1962,7 +2355,7 @@ public class CodeGenerator : IASTVisitor {
 
 		// Get or create register for loop variable.  At global scope the loop
 		// variable is a global like any other top-level name, so the register is
-		// only where ITERGET drops each element on its way to the slot; it is
+		// only where ITERNEXT drops each element on its way to the slot; it is
 		// parked under an internal key so the body's ResetTempRegisters leaves it
 		// alone, and it is never findable by the user's name.
 		Int32 varReg;
@@ -1985,17 +2378,19 @@ public class CodeGenerator : IASTVisitor {
 		// value the previous iteration stored.  See ReserveBodyVarRegs.
 		List<String> reserved = ReserveBodyVarRegs(node.Body);
 
-		// Peel the first iteration's NEXT/ITERGET when the loop variable still needs
-		// a NAME, so the NAME lands on a path taken only when the body will run.  If
+		// Load the constants the body reads; see HoistLoopConstants.
+		HoistLoopConstants(null, node.Body);
+
+		// Peel the first iteration's ITERNEXT when the loop variable still needs a
+		// NAME, so the NAME lands on a path taken only when the body will run.  If
 		// a NAME already dominates -- the variable existed before the loop -- there
 		// is nothing to place and the plain layout is smaller.
 		Int32 nameMark = _namedStack.Count;
 		Boolean peelFirst = !_globalScope && !IsRegisterNamed(node.Variable);
 		if (peelFirst) {
-			_emitter.EmitABC(Opcode.NEXT_rA_rB, indexReg, listReg, 0, "index++; skip next if done");
+			_emitter.EmitABC(Opcode.ITERNEXT_rA_rB_rC, varReg, listReg, indexReg,
+				$"index++; {node.Variable} = next element, or skip next if done");
 			_emitter.EmitJump(Opcode.JUMP_iABC, afterLoop, "no iterations: leave the loop variable undefined");
-			_emitter.EmitABC(Opcode.ITERGET_rA_rB_rC, varReg, listReg, indexReg,
-				$"{node.Variable} = iterget(container, index)");
 			EnsureNamed(node.Variable, varReg);
 			_emitter.EmitJump(Opcode.JUMP_iABC, bodyStart, "enter the body");
 		}
@@ -2003,14 +2398,13 @@ public class CodeGenerator : IASTVisitor {
 		// Place loopStart label
 		_emitter.PlaceLabel(loopStart);
 
-		// NEXT: increment index, skip next if done
-		_emitter.EmitABC(Opcode.NEXT_rA_rB, indexReg, listReg, 0, "index++; skip next if done");
+		// ITERNEXT: increment index and fetch the element at it into varReg (for
+		// lists/strings the same as INDEX; for maps a {"key":k, "value":v} map),
+		// or skip the next instruction if there is none
+		_emitter.EmitABC(Opcode.ITERNEXT_rA_rB_rC, varReg, listReg, indexReg,
+			$"index++; {node.Variable} = next element, or skip next if done");
 		_emitter.EmitJump(Opcode.JUMP_iABC, afterLoop, "exit loop");
 
-		// Get current element by position: varReg = iterget(listReg, indexReg)
-		// For lists/strings this is the same as INDEX; for maps it returns {"key":k, "value":v}
-		_emitter.EmitABC(Opcode.ITERGET_rA_rB_rC, varReg, listReg, indexReg, $"{node.Variable} = iterget(container, index)");
-
 		// At global scope, publish the element as a global before running the body.
 		if (_globalScope) EmitGlobalStore(node.Variable, varReg);
 
@@ -2021,6 +2415,7 @@ public class CodeGenerator : IASTVisitor {
 		// Jump back to loopStart
 		_emitter.EmitJump(Opcode.JUMP_iABC, loopStart, "loop back");
 
+		ReleaseLoopConstants();
 		ReleaseBodyVarRegs(reserved);
 
 		// Place afterLoop label
@@ -2092,7 +2487,7 @@ public class CodeGenerator : IASTVisitor {
 		}
 		StringNode strNode = node as StringNode;
 		if (strNode != null) {
-			result = Value.make_string(strNode.Value);
+			result = Value.make_interned_string(strNode.Value);
 			return true;
 		}
 		IdentifierNode idNode = node as IdentifierNode;
@@ -2153,6 +2548,7 @@ public class CodeGenerator : IASTVisitor {
 		BytecodeEmitter innerEmitter = new BytecodeEmitter();
 		CodeGenerator innerGen = new CodeGenerator(innerEmitter);
 		innerGen._functions = _functions;  // share the function registry
+		innerGen._inlineCandidates = _inlineCandidates;
 		innerGen.FileName = FileName;      // share the source file name
 
 		// Reserve r0 for return value, then set up param registers (r1, r2, ...)
@@ -2161,7 +2557,7 @@ public class CodeGenerator : IASTVisitor {
 			Int32 paramReg = innerGen.AllocReg();  // r1, r2, ...
 			String name = node.ParamNames[i];
 			innerGen._variableRegs[name] = paramReg;
-			Int32 nameIdx = innerEmitter.AddConstant(Value.make_string(name));
+			Int32 nameIdx = innerEmitter.AddConstant(Value.make_interned_string(name));
 			innerEmitter.EmitAB(Opcode.NAME_rA_kBC, paramReg, nameIdx, $"param {name}");
 			// Params are named unconditionally at function entry, so reassigning
 			// one in the body needn't re-emit NAME.
@@ -2202,7 +2598,7 @@ public class CodeGenerator : IASTVisitor {
 		// Set parameter info on the FuncDef
 		Value defaultVal;
 		for (Int32 i = 0; i < node.ParamNames.Count; i++) {
-			funcDef.ParamNames.Add(Value.make_string(node.ParamNames[i]));
+			funcDef.ParamNames.Add(Value.make_interned_string(node.ParamNames[i]));
 			ASTNode defaultNode = node.ParamDefaults[i];
 			if (defaultNode != null) {
 				if (TryEvaluateConstant(defaultNode, out defaultVal)) {
@@ -2232,6 +2628,7 @@ public class CodeGenerator : IASTVisitor {
 		_emitter.EmitAB(Opcode.FUNCREF_iA_iBC, resultReg, templateConst,
 			$"r{resultReg} = funcref {funcName}");
 
+		_lastFunctionInline = MakeInlineCandidate(node, funcDef, funcTemplate);
 		return resultReg;
 	}
 
@@ -2416,13 +2813,11 @@ public class CodeGenerator : IASTVisitor {
 		List<Int32> argRegs = CompileArguments(arguments);
 
 		// Look up the method using METHFIND (walks __isa chain, sets pending self/super)
-		Int32 keyReg = AllocReg();
-		Int32 constIdx = _emitter.AddConstant(Value.make_string(methodKey));
-		_emitter.EmitAB(Opcode.LOAD_rA_kBC, keyReg, constIdx, $"r{keyReg} = \"{methodKey}\"");
+		Int32 keyReg = CompileKeyOperand(methodKey);
 		Int32 funcReg = AllocReg();
 		_emitter.EmitABC(Opcode.METHFIND_rA_rB_rC, funcReg, receiverReg, keyReg,
 			$"r{funcReg} = {methodKey} (method lookup)");
-		FreeReg(keyReg);
+		FreeOperand(keyReg);
 
 		// For super.method() calls, override pendingSelf with the current self
 		if (preserveSelf) {
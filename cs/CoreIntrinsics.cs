@@ -17,6 +17,10 @@ using System.Collections.Generic;
 // CPP: #include "CS_value_util.h"
 // CPP: #include "Interpreter.g.h"
 // CPP: #include "PRNG.g.h"
+// CPP: #include "Channel.g.h"
+// CPP: #include "Coroutine.g.h"
+// CPP: #include "SharedHeap.g.h"
+// CPP: #include "ParallelMap.g.h"
 
 /*** BEGIN CPP_ONLY ***
 #if defined(__APPLE__)
@@ -130,6 +134,40 @@ public static class CoreIntrinsics {
 	// is the wrong type (not a number or string), or a FormatError when it is a
 	// string that does not parse as a number.  Callers should check/propagate
 	// v.IsError() before calling this.
+	// Check the arguments of parallelMap or parallelFilter, and start it.
+	private static IntrinsicResult StartParallel(Context ctx, Boolean filter) {
+		String name = filter ? "parallelFilter" : "parallelMap";
+		Value list = ctx.GetArg(0);
+		if (list.IsError()) return ctx.vm.RaiseUncaughtError(list);
+		if (!list.IsList()) return new IntrinsicResult(ErrorTypes.TypeError("list", list));
+		Value func = ctx.GetArg(1);
+		if (func.IsError()) return ctx.vm.RaiseUncaughtError(func);
+		if (!func.IsFuncRef()) return new IntrinsicResult(ErrorTypes.TypeError("function", func));
+		FuncDef def = func.FunctionDef();
+		if (def.NativeCallback != null) {
+			return new IntrinsicResult(ErrorTypes.RuntimeError(
+				StringUtils.Format("{0}: func must be a script function, not an intrinsic (wrap it in one)", name)));
+		}
+		String outside = ParallelMap.OutsideName(func, ctx.vm.GetGlobals());
+		if (outside != null) {
+			return new IntrinsicResult(ErrorTypes.RuntimeError(
+				StringUtils.Format("{0}: func uses '{1}', which a worker thread cannot see; it may use only its argument, its own variables, and intrinsics", name, outside)));
+		}
+		Value vChunkSize = ctx.GetArg(2);
+		Int32 chunkSize = 0;
+		if (!vChunkSize.IsNull()) {
+			double d;
+			Value e = RequireNumber(vChunkSize, out d);
+			if (!e.IsNull()) return new IntrinsicResult(e);
+			if (d < 1) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError(
+					StringUtils.Format("{0}: chunkSize must be at least 1", name)));
+			}
+			chunkSize = (Int32)d;
+		}
+		return ParallelMap.Start(ctx, list, func, chunkSize, filter);
+	}
+
 	private static Value RequireNumber(Value v, out double result) {
 		if (v.IsNumber()) { result = v.NumericVal(); return Value.Null; }
 		if (v.IsString()) {
@@ -176,7 +214,7 @@ public static class CoreIntrinsics {
 		}
 		return _listType;
 	}
-	private static Value _listType = Value.Null;
+	[ThreadStatic] private static Value _listType;
 
 	// 
 	// StringType: a static map that represents the `string` type, and provides
@@ -202,7 +240,7 @@ public static class CoreIntrinsics {
 		}
 		return _stringType;
 	}
-	private static Value _stringType = Value.Null;
+	[ThreadStatic] private static Value _stringType;
 
 	// 
 	// MapType: a static map that represents the `map` type, and provides
@@ -227,7 +265,7 @@ public static class CoreIntrinsics {
 		}
 		return _mapType;
 	}
-	private static Value _mapType = Value.Null;
+	[ThreadStatic] private static Value _mapType;
 	
 	// 
 	// NumberType: a static map that represents the `number` type.
@@ -239,7 +277,7 @@ public static class CoreIntrinsics {
 		}
 		return _numberType;
 	}
-	private static Value _numberType = Value.Null;	
+	[ThreadStatic] private static Value _numberType;
 
 	// 
 	// FunctionType: a static map that represents the `funcRef` type.
@@ -251,7 +289,7 @@ public static class CoreIntrinsics {
 		}
 		return _functionType;
 	}
-	private static Value _functionType = Value.Null;
+	[ThreadStatic] private static Value _functionType;
 
 	//
 	// ErrorType: a static map that represents the `error` type, and provides
@@ -268,14 +306,14 @@ public static class CoreIntrinsics {
 		}
 		return _errorType;
 	}
-	private static Value _errorType = Value.Null;
-	private static Intrinsic _errorErrIntr = null;
+	[ThreadStatic] private static Value _errorType;
+	[ThreadStatic] private static Intrinsic _errorErrIntr;
 
 	private static Value _EOL = Value.make_string("\n");
 
 	// REPL history lists, set by App.RunREPL at startup and by the reset intrinsic.
-	public static Value replInList = Value.Null;
-	public static Value replOutList = Value.Null;
+	[ThreadStatic] public static Value replInList;
+	[ThreadStatic] public static Value replOutList;
 
 	public static void MarkRoots(object user_data) {
 		GCManager.Mark(_listType);
@@ -290,8 +328,15 @@ public static class CoreIntrinsics {
 		GCManager.Mark(replOutList);
 	}
 
+	// Define the core intrinsics.  Called once per thread, by Intrinsic.Count
+	// or Intrinsic.RegisterAll: like the GC heap, the intrinsics and every
+	// cached map here are per isolate (see GCManager).
 	public static void Init() {
 		GCManager.RegisterMarkCallback(MarkRoots, null); // CPP: GCManager::RegisterMarkCallback(CoreIntrinsics::MarkRoots, nullptr);
+		// A thread-static Value starts out as 0 in C#, not null; start clean.
+		replInList = Value.Null;
+		replOutList = Value.Null;
+		InvalidateTypeMaps();
 
 		Intrinsic f;
 
@@ -485,9 +530,9 @@ public static class CoreIntrinsics {
 		// len(x)
 		f = Intrinsic.Create("len");
 		f.AddParam("self");
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value container = ctx.GetArg(0);
-			if (container.IsError()) return new IntrinsicResult(container);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value container = args[0];
+			if (container.IsError()) return container;
 			Value result = Value.Null;
 			if (container.IsList()) {
 				result = new Value(container.ListCount());
@@ -496,7 +541,7 @@ public static class CoreIntrinsics {
 			} else if (container.IsMap()) {
 				result = new Value(container.MapCount());
 			}
-			return new IntrinsicResult(result);
+			return result;
 		};
 
 		// remove(self, index)
@@ -548,13 +593,13 @@ public static class CoreIntrinsics {
 		// abs(x=0)
 		f = Intrinsic.Create("abs");
 		f.AddParam("x", Value.zero);
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value v = ctx.GetArg(0);
-			if (v.IsError()) return new IntrinsicResult(v);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value v = args[0];
+			if (v.IsError()) return v;
 			double x;
 			Value e = RequireNumber(v, out x);
-			if (!e.IsNull()) return new IntrinsicResult(e);
-			return new IntrinsicResult(new Value(Math.Abs(x)));
+			if (!e.IsNull()) return e;
+			return new Value(Math.Abs(x));
 		};
 
 		// acos(x=0)
@@ -626,13 +671,13 @@ public static class CoreIntrinsics {
 		// floor(x=0)
 		f = Intrinsic.Create("floor");
 		f.AddParam("x", Value.zero);
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value v = ctx.GetArg(0);
-			if (v.IsError()) return new IntrinsicResult(v);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value v = args[0];
+			if (v.IsError()) return v;
 			double x;
 			Value e = RequireNumber(v, out x);
-			if (!e.IsNull()) return new IntrinsicResult(e);
-			return new IntrinsicResult(new Value(Math.Floor(x)));
+			if (!e.IsNull()) return e;
+			return new Value(Math.Floor(x));
 		};
 
 		// log(x=0, base=10)
@@ -733,13 +778,13 @@ public static class CoreIntrinsics {
 		// sqrt(x=0)
 		f = Intrinsic.Create("sqrt");
 		f.AddParam("x", Value.zero);
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value v = ctx.GetArg(0);
-			if (v.IsError()) return new IntrinsicResult(v);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value v = args[0];
+			if (v.IsError()) return v;
 			double x;
 			Value e = RequireNumber(v, out x);
-			if (!e.IsNull()) return new IntrinsicResult(e);
-			return new IntrinsicResult(new Value(Math.Sqrt(x)));
+			if (!e.IsNull()) return e;
+			return new Value(Math.Sqrt(x));
 		};
 
 		// tan(radians=0)
@@ -757,18 +802,21 @@ public static class CoreIntrinsics {
 		f = Intrinsic.Create("push");
 		f.AddParam("self");
 		f.AddParam("value");
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value self = ctx.GetArg(0);
-			if (self.IsError()) return ctx.vm.RaiseUncaughtError(self);
-			Value value = ctx.GetArg(1);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value self = args[0];
+			if (self.IsError()) {
+				VM.ActiveVM().RaiseUncaughtError(self); // CPP: VMStorage::ActiveVM().RaiseUncaughtError(self);
+				return Value.Null;
+			}
+			Value value = args[1];
 			if (self.IsList()) {
 				self.Push(value);
-				return new IntrinsicResult(self);
+				return self;
 			} else if (self.IsMap()) {
 				self.MapSet(value, Value.one);
-				return new IntrinsicResult(self);
+				return self;
 			}
-			return new IntrinsicResult(ErrorTypes.TypeError("list or map", self));
+			return ErrorTypes.TypeError("list or map", self);
 		};
 
 		// pop(self)
@@ -839,11 +887,11 @@ public static class CoreIntrinsics {
 		f.AddParam("self");
 		f.AddParam("value");
 		f.AddParam("after");
-		f.Code = (Context ctx, IntrinsicResult partialResult) => {
-			Value self = ctx.GetArg(0);
-			if (self.IsError()) return new IntrinsicResult(self);
-			Value value = ctx.GetArg(1);
-			Value after = ctx.GetArg(2);
+		f.SimpleCode = (Span<Value> args, Int32 argCount) => {
+			Value self = args[0];
+			if (self.IsError()) return self;
+			Value value = args[1];
+			Value after = args[2];
 			Value result = Value.Null;
 			// CPP: Value iterKey, iterVal;
 			if (self.IsList()) {
@@ -855,7 +903,7 @@ public static class CoreIntrinsics {
 				int idx = self.ListIndexOf(value, afterIdx);
 				if (idx >= 0) result = new Value(idx);
 			} else if (self.IsString()) {
-				if (!value.IsString()) return new IntrinsicResult(Value.Null);
+				if (!value.IsString()) return Value.Null;
 				int afterIdx = -1;
 				if (!after.IsNull()) {
 					afterIdx = (int)after.NumericVal();
@@ -880,9 +928,9 @@ public static class CoreIntrinsics {
 					}
 				}
 			} else {
-				return new IntrinsicResult(ErrorTypes.TypeError("list, string, or map", self));
+				return ErrorTypes.TypeError("list, string, or map", self);
 			}
-			return new IntrinsicResult(result);
+			return result;
 		};
 
 		// sort(self, byKey=null, ascending=1)
@@ -1081,7 +1129,6 @@ public static class CoreIntrinsics {
 			Value self = ctx.GetArg(0);
 			if (self.IsError()) return new IntrinsicResult(self);
 			Value result = Value.Null;
-			// CPP: Value iterKey;
 			if (self.IsList()) {
 				int count = self.ListCount();
 				result = Value.make_list(count);
@@ -1098,10 +1145,8 @@ public static class CoreIntrinsics {
 				return new IntrinsicResult(result);
 			} else if (self.IsMap()) {
 				result = Value.make_list(self.MapCount());
-				MapIterator iter = self.Iterator();
-				while (Value.map_iterator_next(ref iter)) { // CPP: while (map_iterator_next(&iter, &iterKey, nullptr)) {
-					result.Push(iter.Key);  // CPP: result.Push(iterKey);
-				}
+				GCManager.Maps.Get(self.ItemIndex()).CopyKeysTo(
+					GCManager.Lists.Get(result.ItemIndex()).Items);
 			} else {
 				return new IntrinsicResult(ErrorTypes.TypeError("list, string, or map", self));
 			}
@@ -1139,13 +1184,10 @@ public static class CoreIntrinsics {
 			Value self = ctx.GetArg(0);
 			if (self.IsError()) return new IntrinsicResult(self);
 			Value result = self;
-			// CPP: Value iterVal;
 			if (self.IsMap()) {
 				result = Value.make_list(self.MapCount());
-				MapIterator iter = self.Iterator();
-				while (Value.map_iterator_next(ref iter)) { // CPP: while (map_iterator_next(&iter, nullptr, &iterVal)) {
-					result.Push(iter.Val);      // CPP: result.Push(iterVal);
-				}
+				GCManager.Maps.Get(self.ItemIndex()).CopyValuesTo(
+					GCManager.Lists.Get(result.ItemIndex()).Items);
 			} else if (self.IsString()) {
 				int slen = self.Length();
 				result = Value.make_list(slen);
@@ -1280,25 +1322,252 @@ public static class CoreIntrinsics {
 				vSeconds = ctx.GetArg(0);
 				if (vSeconds.IsError()) return ctx.vm.RaiseUncaughtError(vSeconds);
 				double interval = vSeconds.NumericVal();
+				ctx.vm.wakeTime = now + interval;	// (so the host can sleep till then)
 				return new IntrinsicResult(new Value(now + interval), false);
 			} else {
 				// Continuation: check if we've waited long enough
 				if (now > partialResult.result.NumericVal()) return IntrinsicResult.Null;
+				ctx.vm.wakeTime = partialResult.result.NumericVal();
 				return partialResult;
 			}
 		};
 
-		// yield
+		// yield(value=null)
 		//    Pause execution of the script until the next "tick" of the
 		//    host app.  In Mini Micro, for example, this waits until the
 		//    next 60Hz frame.  If you're doing something in a tight loop,
 		//    calling yield is polite to the host app or other scripts.
+		//    In a coroutine, yield instead stops the coroutine, and the
+		//    resume that ran it returns value; yield then returns the
+		//    value passed to the next resume.
+		// value (default null): what resume returns, in a coroutine
+		// See also: wait, coroutine, resume
 		f = Intrinsic.Create("yield");
+		f.AddParam("value");
 		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			if (ctx.vm.InCoroutine()) return ctx.vm.YieldCoroutine(ctx.GetArg(0));
 			ctx.vm.yielding = true;
 			return IntrinsicResult.Null;
 		};
 
+		// coroutine(func)
+		//    Return a new coroutine: a task that runs func in turns with the
+		//    rest of the program.  Nothing runs until it is resumed; then
+		//    func runs until it yields or returns, and resume returns the
+		//    value it yielded or returned.  The next resume carries on from
+		//    where it stopped.  A coroutine costs about as much to make as a
+		//    function call, so a script can keep thousands of them.
+		// func: a function of at most one argument (the first value resumed with)
+		// See also: resume, yield, coroutineStatus
+		f = Intrinsic.Create("coroutine");
+		f.AddParam("func");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value func = ctx.GetArg(0);
+			if (func.IsError()) return ctx.vm.RaiseUncaughtError(func);
+			if (!func.IsFuncRef()) return new IntrinsicResult(ErrorTypes.TypeError("function", func));
+			FuncDef def = func.FunctionDef();
+			if (def.NativeCallback != null) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError(
+					"coroutine: func must be a script function, not an intrinsic (wrap it in one)"));
+			}
+			return new IntrinsicResult(VM.MakeCoroutine(func));
+		};
+
+		// resume(co, value=null)
+		//    Run a coroutine until it yields or finishes.  Returns the value
+		//    it yielded, or, when it finishes, its function's result.  value
+		//    becomes the result of the yield it stopped at -- or, the first
+		//    time, the function's first argument.
+		// co: a coroutine, made by `coroutine`
+		// value (default null): the value to hand to the coroutine
+		// See also: coroutine, yield, coroutineStatus
+		f = Intrinsic.Create("resume");
+		f.AddParam("co");
+		f.AddParam("value");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vCo = ctx.GetArg(0);
+			if (vCo.IsError()) return ctx.vm.RaiseUncaughtError(vCo);
+			Coroutine co = VM.GetCoroutine(vCo);
+			if (co == null) return new IntrinsicResult(ErrorTypes.TypeError("coroutine", vCo));
+			return ctx.vm.ResumeCoroutine(co, ctx.GetArg(1), !partialResult.done);
+		};
+
+		// coroutineStatus(co)
+		//    Return the status of a coroutine: "suspended" (not yet started,
+		//    or stopped at a yield), "running" (the one running now),
+		//    "normal" (waiting for a coroutine it resumed), or "dead"
+		//    (finished, or stopped by an error).
+		// co: a coroutine, made by `coroutine`
+		// See also: coroutine, resume
+		f = Intrinsic.Create("coroutineStatus");
+		f.AddParam("co");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vCo = ctx.GetArg(0);
+			Coroutine co = VM.GetCoroutine(vCo);
+			if (co == null) return new IntrinsicResult(ErrorTypes.TypeError("coroutine", vCo));
+			return new IntrinsicResult(Value.make_string(co.StatusName()));
+		};
+
+		// channel(name="", capacity=64)
+		//    Return the name of a channel: a queue of values that scripts
+		//    running at the same time, on different threads, can send to
+		//    and receive from.  A channel is known by its name everywhere in
+		//    the process, and is made, with room for `capacity` values, the
+		//    first time its name is used (by this or by send, receive or
+		//    tryReceive).  With no name, makes a new channel.
+		// name (default ""): the channel's name
+		// capacity (default 64): how many values it holds before send waits
+		// See also: send, receive, tryReceive, share
+		f = Intrinsic.Create("channel");
+		f.AddParam("name", Value.make_string(""));
+		f.AddParam("capacity", new Value(Channels.DefaultCapacity));
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vName = ctx.GetArg(0);
+			if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+			if (!vName.IsString()) return new IntrinsicResult(ErrorTypes.TypeError("string", vName));
+			Value vCapacity = ctx.GetArg(1);
+			if (vCapacity.IsError()) return ctx.vm.RaiseUncaughtError(vCapacity);
+			double capacity;
+			Value e = RequireNumber(vCapacity, out capacity);
+			if (!e.IsNull()) return new IntrinsicResult(e);
+			if (capacity < 1 || capacity > Channels.MaxCapacity) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError(
+					StringUtils.Format("channel capacity must be from 1 to {0}", Channels.MaxCapacity)));
+			}
+			String name = vName.ToString(null);
+			if (name == "") name = Channels.NewName();
+			Channels.Find(name, (Int32)capacity);
+			return new IntrinsicResult(Value.make_string(name));
+		};
+
+		// send(channel, value)
+		//    Put a value on a channel, waiting (without blocking other
+		//    scripts or the host) while the channel is full.  Numbers,
+		//    strings, null and shared values go as they are; a list or map
+		//    is copied, and its copy is frozen if it is.  Functions, errors
+		//    and handles cannot be sent.
+		// channel: name of the channel (see channel)
+		// value: the value to send
+		// See also: receive, share
+		f = Intrinsic.Create("send");
+		f.AddParam("channel");
+		f.AddParam("value");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vName = ctx.GetArg(0);
+			if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+			if (!vName.IsString()) return new IntrinsicResult(ErrorTypes.TypeError("string", vName));
+			Value v = ctx.GetArg(1);
+			if (v.IsError()) return ctx.vm.RaiseUncaughtError(v);
+			// (Packed again on each try: the value may have changed meanwhile,
+			// and a message cannot be kept in the partial result.)
+			ChannelMessage msg = ChannelMessage.Pack(v);
+			if (msg == null) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError(
+					"send: value cannot be sent (it is or holds a function, error, handle, or variable map)"));
+			}
+			Channel ch = Channels.Find(vName.ToString(null), Channels.DefaultCapacity);
+			if (ch.TrySend(msg)) return IntrinsicResult.Null;
+			ctx.vm.yielding = true;		// full: let the host run something else
+			return new IntrinsicResult(Value.Null, false);
+		};
+
+		// receive(channel)
+		//    Take the oldest value from a channel, waiting (without blocking
+		//    other scripts or the host) until there is one.
+		// channel: name of the channel (see channel)
+		// See also: send, tryReceive
+		f = Intrinsic.Create("receive");
+		f.AddParam("channel");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vName = ctx.GetArg(0);
+			if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+			if (!vName.IsString()) return new IntrinsicResult(ErrorTypes.TypeError("string", vName));
+			Channel ch = Channels.Find(vName.ToString(null), Channels.DefaultCapacity);
+			ChannelMessage msg = ch.TryReceive();
+			if (msg != null) return new IntrinsicResult(msg.Unpack());
+			ctx.vm.yielding = true;		// empty: let the host run something else
+			return new IntrinsicResult(Value.Null, false);
+		};
+
+		// tryReceive(channel, default=null)
+		//    Take the oldest value from a channel if it has one; otherwise
+		//    return `default` at once.
+		// channel: name of the channel (see channel)
+		// default (default null): what to return if the channel is empty
+		// See also: receive
+		f = Intrinsic.Create("tryReceive");
+		f.AddParam("channel");
+		f.AddParam("default", Value.Null);
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value vName = ctx.GetArg(0);
+			if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+			if (!vName.IsString()) return new IntrinsicResult(ErrorTypes.TypeError("string", vName));
+			Channel ch = Channels.Find(vName.ToString(null), Channels.DefaultCapacity);
+			ChannelMessage msg = ch.TryReceive();
+			if (msg == null) return new IntrinsicResult(ctx.GetArg(1));
+			return new IntrinsicResult(msg.Unpack());
+		};
+
+		// share(x)
+		//    Publish a frozen value to the shared heap, and return its
+		//    published form, which every thread can read in place: sending
+		//    it on a channel copies nothing.  Published values are never
+		//    freed, so share data that lasts, not a value per message.
+		// x: the value to publish; a list or map must be frozen
+		// See also: freeze, send
+		f = Intrinsic.Create("share");
+		f.AddParam("x");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			Value v = ctx.GetArg(0);
+			if (v.IsError()) return new IntrinsicResult(v);
+			Value shared;
+			if (!SharedHeap.TryPublish(v, out shared)) {
+				if (SharedHeap.Shareable(v)) {
+					return new IntrinsicResult(ErrorTypes.RuntimeError("share: the shared heap is full"));
+				}
+				return new IntrinsicResult(ErrorTypes.RuntimeError(
+					"share: value must be frozen, and cannot hold a function, error, handle, or variable map"));
+			}
+			return new IntrinsicResult(shared);
+		};
+
+		// parallelMap(list, func, chunkSize=null)
+		//    Call func on each item of a list, spreading the calls over
+		//    worker threads, and return a list of the results, in order.
+		//    On a worker, func runs with only its argument: it cannot see
+		//    the caller's globals or local variables, so it must compute
+		//    its result from the item alone.  A func that uses any name
+		//    other than its own variables and intrinsics is an error.
+		// list: the items to call func on
+		// func: a function of one argument
+		// chunkSize (default null): how many items a thread takes at a
+		//    time; null picks a size to suit the number of threads
+		// See also: parallelFilter
+		f = Intrinsic.Create("parallelMap");
+		f.AddParam("list");
+		f.AddParam("func");
+		f.AddParam("chunkSize");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			if (!partialResult.done) return ParallelMap.Continue(ctx, partialResult.result, false);
+			return StartParallel(ctx, false);
+		};
+
+		// parallelFilter(list, func, chunkSize=null)
+		//    Like parallelMap, but return the items of the list for which
+		//    func returned a true value, in order.
+		// list: the items to test
+		// func: a function of one argument
+		// chunkSize (default null): how many items a thread takes at a time
+		// See also: parallelMap
+		f = Intrinsic.Create("parallelFilter");
+		f.AddParam("list");
+		f.AddParam("func");
+		f.AddParam("chunkSize");
+		f.Code = (Context ctx, IntrinsicResult partialResult) => {
+			if (!partialResult.done) return ParallelMap.Continue(ctx, partialResult.result, true);
+			return StartParallel(ctx, true);
+		};
+
 		// stackTrace
 		//    Return the current call stack as a list of strings, innermost
 		//    (most recent) call first.  Each string has the form
@@ -1515,7 +1784,7 @@ public static class CoreIntrinsics {
 		}
 		return _intrinsicsMap;
 	}
-	private static Value _intrinsicsMap = Value.Null;
+	[ThreadStatic] private static Value _intrinsicsMap;
 
 	public static Value GCMap() {
 		if (_gcMap.IsNull()) {
@@ -1526,13 +1795,13 @@ public static class CoreIntrinsics {
 		}
 		return _gcMap;
 	}
-	private static Value _gcMap = Value.Null;
-	private static Intrinsic _gcCollectIntr = null;
-	private static Intrinsic _gcStatsIntr = null;
-	private static Value _versionMap = Value.Null;
+	[ThreadStatic] private static Value _gcMap;
+	[ThreadStatic] private static Intrinsic _gcCollectIntr;
+	[ThreadStatic] private static Intrinsic _gcStatsIntr;
+	[ThreadStatic] private static Value _versionMap;
 
 	public delegate void VoidCallback(); // H: 
-	private static List<VoidCallback> _invalidateCallbacks = null;
+	[ThreadStatic] private static List<VoidCallback> _invalidateCallbacks;
 
 	public static void RegisterInvalidateCallback(VoidCallback callback) {
 		if (_invalidateCallbacks == null) _invalidateCallbacks = new List<VoidCallback>();
@@ -0,0 +1,83 @@
+// Coroutine.cs
+//
+// A coroutine: a script function that runs in turns inside one VM.  It can
+// stop partway (yield), handing a value back to whoever resumed it, and
+// later carry on from where it stopped (resume).  Each has registers and a
+// call stack of its own, so switching to it is just swapping those, and the
+// frame state that goes with them, into the VM; the switching itself is
+// done by VM.ResumeCoroutine.
+//
+// The fields hold whichever execution state the VM is not using.  While the
+// coroutine is suspended, that is its own; while it runs, the VM has its
+// state, and these hold the state of whoever resumed it, which goes back
+// into the VM when the coroutine yields or finishes.
+//
+// Scripts see a coroutine as a handle (see VM.MakeCoroutine), whose Marker
+// keeps the Values in a suspended coroutine's registers alive.
+
+using System;
+using System.Collections.Generic;
+// H: #include "FuncDef.g.h"
+// CPP: #include "VM.g.h"
+
+namespace MiniScript {
+
+// How far a coroutine has got.
+public enum CoroutineStatus : Int32 {
+	NotStarted,	// made, but never resumed
+	Suspended,	// stopped at a yield
+	Running,	// the one the VM is running
+	Normal,	// resumed another, and waiting for it
+	Dead	// finished, or stopped by an error
+}
+
+public class Coroutine {
+	public CoroutineStatus Status = CoroutineStatus.NotStarted;
+	public Value Function = Value.Null;	// the function it runs
+
+	// Registers and call stack: the coroutine's own while it is suspended,
+	// its resumer's while it runs.  Null until first resumed.
+	public List<Value> Stack = null;
+	public List<Value> Names = null;
+	public List<CallInfo> CallStack = null;
+	public Int32 CallStackTop = 0;
+
+	// Frame state that goes with them.
+	public Int32 PC = 0;
+	public Int32 BaseIndex = 0;
+	public FuncDef CurrentFunction = null;
+	public Int32 NativeFrameTop = 0;
+	public Value PendingSelf = Value.Null;
+	public Value PendingSuper = Value.Null;
+	public Boolean HasPendingContext = false;
+
+	// Pending intrinsic continuation (see VM._pendingCallback); a coroutine
+	// suspended in a `wait` has one.
+	public NativeCallbackDelegate PendingCallback = null;
+	public FuncDef PendingCallee = null;
+	public Int32 PendingCalleeBase = 0;
+	public Int32 PendingArgCount = 0;
+	public Int32 PendingResultIndex = 0;
+	public Boolean PendingIsManual = false;
+	public Boolean HasPendingManualCall = false;
+	public Int32 PendingManualCallDepth = 0;
+	public Value ManualCallResult = Value.Null;
+	public List<PendingCallState> PendingCallStack = null;
+
+	// Where, in Stack, the value passed to the next resume goes: the result
+	// register of the yield it is suspended in.
+	public Int32 YieldResultIndex = -1;
+
+	public Coroutine() {
+	}
+
+	// Status as a script sees it (see the coroutineStatus intrinsic).
+	public String StatusName() {
+		if (Status == CoroutineStatus.Running) return "running";
+		if (Status == CoroutineStatus.Normal) return "normal";
+		if (Status == CoroutineStatus.Dead) return "dead";
+		return "suspended";
+	}
+}
+
+}
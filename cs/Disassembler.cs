@@ -21,6 +21,7 @@ public static class Disassembler {
 			case Opcode.LOADC_rA_rB_kC: return "LOADC";
 			case Opcode.LOADV_rA_rB_rC: return "LOADV";
 			case Opcode.LOADC_rA_rB_rC: return "LOADC";
+			case Opcode.LOADC_rA_rB:   return "LOADC";
 			case Opcode.FUNCREF_iA_iBC: return "FUNCREF";
 			case Opcode.ASSIGN_rA_rB_kC: return "ASSIGN";
 			case Opcode.NAME_rA_kBC:   return "NAME";
@@ -80,12 +81,14 @@ public static class Disassembler {
 			case Opcode.IFEQ_rA_iBC:   return "IFEQ";
 			case Opcode.IFNE_rA_rB:
 			case Opcode.IFNE_rA_iBC:   return "IFNE";
+			case Opcode.IFFUNC_rA_kBC: return "IFFUNC";
 			case Opcode.NEXT_rA_rB:    return "NEXT";
 			case Opcode.ARGBLK_iABC:   return "ARGBLK";
 			case Opcode.ARG_rA:
 			case Opcode.ARG_iABC:      return "ARG";
 			case Opcode.CALLF_iA_iBC:  return "CALLF";
 			case Opcode.CALL_rA_rB_rC: return "CALL";
+			case Opcode.CALLINTRINSIC_rA_rB_iC: return "CALLINTRINSIC";
 			case Opcode.RETURN:        return "RETURN";
 			case Opcode.NEW_rA_rB:     return "NEW";
 			case Opcode.ISA_rA_rB_rC:  return "ISA";
@@ -94,6 +97,7 @@ public static class Disassembler {
 			case Opcode.SETSELF_rA:    return "SETSELF";
 			case Opcode.CALLIFREF_rA:  return "CALLIFREF";
 			case Opcode.ITERGET_rA_rB_rC: return "ITERGET";
+			case Opcode.ITERNEXT_rA_rB_rC: return "ITERNEXT";
 			case Opcode.ERRCHK_rA:     return "ERRCHK";
 			default:
 				return "Unknown opcode";
@@ -143,6 +147,7 @@ public static class Disassembler {
 			case Opcode.IFEQ_rA_rB:
 			case Opcode.IFNE_rA_rB:
 			case Opcode.NEXT_rA_rB:
+			case Opcode.LOADC_rA_rB:
 				return StringUtils.Format("{0} r{1}, r{2}",
 					mnemonic,
 					(Int32)BytecodeUtil.Au(instruction),
@@ -157,6 +162,7 @@ public static class Disassembler {
 					(Int32)BytecodeUtil.BCu(instruction));
 			// rA, kBC (constant-pool index)
 			case Opcode.FUNCREF_iA_iBC:
+			case Opcode.IFFUNC_rA_kBC:
 				return StringUtils.Format("{0} r{1}, k{2}",
 					mnemonic,
 					(Int32)BytecodeUtil.Au(instruction),
@@ -232,6 +238,7 @@ public static class Disassembler {
 			case Opcode.METHFIND_rA_rB_rC:
 			case Opcode.IDXGET_rA_rB_rC:
 			case Opcode.ITERGET_rA_rB_rC:
+			case Opcode.ITERNEXT_rA_rB_rC:
 			case Opcode.LOADV_rA_rB_rC:
 			case Opcode.LOADC_rA_rB_rC:
 				return StringUtils.Format("{0} r{1}, r{2}, r{3}",
@@ -248,6 +255,7 @@ public static class Disassembler {
 			case Opcode.BRLE_rA_rB_iC:
 			case Opcode.BREQ_rA_rB_iC:
 			case Opcode.BRNE_rA_rB_iC:
+			case Opcode.CALLINTRINSIC_rA_rB_iC:
 				return StringUtils.Format("{0} r{1}, r{2}, {3}",
 					mnemonic,
 					(Int32)BytecodeUtil.Au(instruction),
@@ -296,6 +304,7 @@ public static class Disassembler {
 	// Disassemble the given function.  If detailed=true, include extra
 	// details for debugging, like line numbers and instruction hex code.
 	public static void Disassemble(FuncDef funcDef, List<String> output, Boolean detailed=true) {
+		funcDef.EnsureConstants();
 		output.Add(StringUtils.Format("Local var registers: {0}", funcDef.MaxRegs));
 		output.Add(StringUtils.Format("Constants ({0}):", funcDef.Constants.Count));
 		for (Int32 i = 0; i < funcDef.Constants.Count; i++) {
@@ -309,12 +318,12 @@ public static class Disassembler {
 			}
 		}
 
-		output.Add(StringUtils.Format("Instructions ({0}):", funcDef.Code.Count));
-		for (Int32 i = 0; i < funcDef.Code.Count; i++) {				
-			String s = ToString(funcDef.Code[i]);
+		output.Add(StringUtils.Format("Instructions ({0}):", funcDef.CodeCount()));
+		for (Int32 i = 0; i < funcDef.CodeCount(); i++) {				
+			String s = ToString(funcDef.CodeAt(i));
 			if (detailed) {
 				s = StringUtils.ZeroPad(i, 4) + ":  "
-				  + StringUtils.ToHex(funcDef.Code[i]) + " | "
+				  + StringUtils.ToHex(funcDef.CodeAt(i)) + " | "
 				  + s;
 			}
 			output.Add(s);
@@ -13,34 +13,33 @@ using System;
 namespace MiniScript {
 
 public static class ErrorTypes {
-	public static Value compiler = Value.Null;
-	public static Value runtime = Value.Null;
+	[ThreadStatic] public static Value compiler;
+	[ThreadStatic] public static Value runtime;
 
-	private static bool _markRootsRegistered = false;
+	// Whether compiler and runtime are set up on this thread.  (A flag rather
+	// than a null check: a thread-static Value starts out as 0, not null, in C#.)
+	[ThreadStatic] private static bool _initialized;
 
 	// Initialize the compiler and runtime prototype error values.
 	// Safe to call multiple times (no-op if already initialized).
 	// Must be called after gc_init() in C++; in C# this is called lazily.
+	// Like the GC heap they live in, these are per thread (see GCManager):
+	// each isolate makes its own.
 	public static void Init() {
-		if (!_markRootsRegistered) {
-			GCManager.RegisterMarkCallback(MarkRoots, null); // CPP: GCManager::RegisterMarkCallback(ErrorTypes::MarkRoots, nullptr);
-			_markRootsRegistered = true;
-		}
-		if (compiler.IsNull()) {
-			compiler = Value.make_error(Value.make_string("Compiler Error"), Value.Null, Value.Null, Value.Null);
-			compiler.Freeze();
-		}
-		if (runtime.IsNull()) {
-			runtime = Value.make_error(Value.make_string("Runtime Error"), Value.Null, Value.Null, Value.Null);
-			runtime.Freeze();
-		}
+		if (_initialized) return;
+		_initialized = true;
+		GCManager.RegisterMarkCallback(MarkRoots, null); // CPP: GCManager::RegisterMarkCallback(ErrorTypes::MarkRoots, nullptr);
+		compiler = Value.make_error(Value.make_string("Compiler Error"), Value.Null, Value.Null, Value.Null);
+		compiler.Freeze();
+		runtime = Value.make_error(Value.make_string("Runtime Error"), Value.Null, Value.Null, Value.Null);
+		runtime.Freeze();
 	}
 
 	// Create a compiler error value with the given message.  Carries no stack
 	// trace: compilation normally happens before the program runs, so there is
 	// no call stack to report.
 	public static Value CompilerError(String msg) {
-		if (compiler.IsNull()) Init();
+		if (!_initialized) Init();
 		return Value.make_error(Value.make_string(msg), Value.Null, Value.Null, compiler);
 	}
 
@@ -52,7 +51,7 @@ public static class ErrorTypes {
 	// DescribeError compose the location for compile-time errors the same way
 	// they do for runtime ones, and no caller has to bake it into the message.
 	public static Value CompilerError(String msg, String fileName, Int32 lineNum) {
-		if (compiler.IsNull()) Init();
+		if (!_initialized) Init();
 		String file = fileName;
 		if (file == "") file = "(current program)";
 		Value stack = Value.make_list(1);
@@ -67,13 +66,13 @@ public static class ErrorTypes {
 	// line that asked for the module), and the underlying parse error is worth
 	// keeping as the inner error.
 	public static Value CompilerError(String msg, Value inner) {
-		if (compiler.IsNull()) Init();
+		if (!_initialized) Init();
 		return Value.make_error(Value.make_string(msg), inner, Value.value_current_stack_trace(), compiler);
 	}
 
 	// Create a runtime error value with the given message and stack trace.
 	public static Value RuntimeError(String msg, Value stack) {
-		if (runtime.IsNull()) Init();
+		if (!_initialized) Init();
 		return Value.make_error(Value.make_string(msg), Value.Null, stack, runtime);
 	}
 
@@ -83,7 +82,7 @@ public static class ErrorTypes {
 	// the VM itself -- carries an accurate trace.  Returns Value.Null stack if no
 	// VM is running (e.g. errors built during setup, before execution).
 	public static Value RuntimeError(String msg) {
-		if (runtime.IsNull()) Init();
+		if (!_initialized) Init();
 		return Value.make_error(Value.make_string(msg), Value.Null, Value.value_current_stack_trace(), runtime);
 	}
 	
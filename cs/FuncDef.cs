@@ -3,8 +3,10 @@ using System.Collections.Generic;
 using System.Runtime.CompilerServices;
 using static System.Runtime.CompilerServices.MethodImplOptions;
 // H: #include "value.h"
+// H: #include "BinaryIO.g.h"
 // CPP: #include "StringUtils.g.h"
 // CPP: #include "IntrinsicAPI.g.h"
+// CPP: #include "BytecodeCache.g.h"
 
 namespace MiniScript {
 
@@ -15,6 +17,13 @@ namespace MiniScript {
 // H: inline bool IsNull(NativeCallbackDelegate f) { return f == nullptr; }
 public delegate IntrinsicResult NativeCallbackDelegate(Context context, IntrinsicResult partialResult); // CPP:
 
+// Simple native callback: a lighter kind of intrinsic, for one that always
+// finishes at once.  It gets its argument registers in place (one per
+// declared parameter, defaults filled in) and returns its result directly.
+// H: typedef Value (*SimpleCallbackDelegate)(Value* args, Int32 argCount);
+// H: inline bool IsNull(SimpleCallbackDelegate f) { return f == nullptr; }
+public delegate Value SimpleCallbackDelegate(Span<Value> args, Int32 argCount); // CPP:
+
 // Function definition: code, constants, and how many registers it needs
 public class FuncDef {
 	public String Name = "";
@@ -41,8 +50,18 @@ public class FuncDef {
 	// cross-interpreter seeding work.
 	//
 	// Id 0 is never issued (Globals pre-increments), so 0 means "never resolved".
+	//
+	// GlobalIntrinsics remembers, per reference, the intrinsic a name resolved to
+	// when its slot turned out to be unassigned (see VM.GlobalMiss), so a loop
+	// calling `len` or `sqrt` looks the name up once rather than on every
+	// iteration.  The intrinsic table is per thread, so what is cached is this
+	// thread's funcref (a permanent GC root of its heap); that holds because a
+	// FuncDef never crosses isolates -- IsolateFunction sends a copy, whose
+	// cache starts empty.  The slot is still checked first on every access,
+	// so a global that shadows the intrinsic later is seen at once.
 	public List<Value> GlobalNames = new List<Value>();
 	public List<Int32> GlobalSlots = new List<Int32>();
+	public List<Value> GlobalIntrinsics = new List<Value>();
 	public Int32 GlobalCacheId = 0;
 
 	// Intern a name into the global-reference table, returning its index.  Used
@@ -53,6 +72,7 @@ public class FuncDef {
 		}
 		GlobalNames.Add(name);
 		GlobalSlots.Add(-1);
+		GlobalIntrinsics.Add(Value.Null);
 		return GlobalNames.Count - 1;
 	}
 
@@ -85,11 +105,98 @@ public class FuncDef {
 		return result;
 	}
 
+	// Raw access to the line table, for BytecodeCache to save and restore it:
+	// the number of runs, each run's first PC and line, and appending a run.
+	public Int32 LineRunCount() {
+		return _lineRLEPC.Count;
+	}
+	public Int32 LineRunPC(Int32 i) {
+		return _lineRLEPC[i];
+	}
+	public Int32 LineRunLine(Int32 i) {
+		return _lineRLELine[i];
+	}
+	public void AddLineRun(Int32 pc, Int32 lineNumber) {
+		_lineRLEPC.Add(pc);
+		_lineRLELine.Add(lineNumber);
+	}
+
+	// Inlined calls: the code generator may compile a small function's body
+	// straight into its caller (see CodeGenerator.EmitInlinedCall).  Each entry
+	// records the PC range [start, end) of one inlined body and the line of the
+	// call it replaced, so a stack trace can still show the call.  The lines
+	// within the range are the callee's own, from the line table as usual.
+	private List<Int32> _inlineStartPC = new List<Int32>();
+	private List<Int32> _inlineEndPC = new List<Int32>();
+	private List<Int32> _inlineCallLine = new List<Int32>();
+
+	public void AddInlineRange(Int32 startPC, Int32 endPC, Int32 callLine) {
+		_inlineStartPC.Add(startPC);
+		_inlineEndPC.Add(endPC);
+		_inlineCallLine.Add(callLine);
+	}
+	public Int32 InlineRangeCount() {
+		return _inlineStartPC.Count;
+	}
+	public Int32 InlineRangeStart(Int32 i) {
+		return _inlineStartPC[i];
+	}
+	public Int32 InlineRangeEnd(Int32 i) {
+		return _inlineEndPC[i];
+	}
+	public Int32 InlineRangeCallLine(Int32 i) {
+		return _inlineCallLine[i];
+	}
+
+	// Return the line of the inlined call whose body contains the given PC, or
+	// 0 if the PC is not in an inlined body.  Inlined bodies contain no calls,
+	// so they never nest.
+	public Int32 GetInlineCallLine(Int32 pc) {
+		for (Int32 i = 0; i < _inlineStartPC.Count; i++) {
+			if (pc >= _inlineStartPC[i] && pc < _inlineEndPC[i]) return _inlineCallLine[i];
+		}
+		return 0;
+	}
+
+	// ── Loading from the bytecode cache ──────────────────────────────────────
+	//
+	// A FuncDef loaded by BytecodeCache does not decode its constant pool until
+	// it is first needed: until then LazyConstantsPos is the position of the
+	// encoded pool in CacheSource, and LazyChildren holds the functions that
+	// the pool's templates refer to.  Call EnsureConstants before reading
+	// Constants of a function that may have come from the cache (the VM does so
+	// on entering a function).  In C++, the code itself may be left in place in
+	// the mapped cache file (BorrowedCode), so read it through CodeCount and
+	// CodeAt rather than Code.
+	public ByteReader CacheSource = null;
+	public Int32 LazyConstantsPos = -1;
+	public List<FuncDef> LazyChildren = null;
+	// H: public: const UInt32* BorrowedCode = nullptr;
+	// H: public: Int32 BorrowedCount = 0;
+
+	[MethodImpl(AggressiveInlining)]
+	public Int32 CodeCount() {
+		return Code.Count; // CPP: return BorrowedCode ? BorrowedCount : Code.Count();
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public UInt32 CodeAt(Int32 pc) {
+		return Code[pc]; // CPP: return BorrowedCode ? BorrowedCode[pc] : Code[pc];
+	}
+
+	public void EnsureConstants() {
+		if (LazyConstantsPos >= 0) BytecodeCache.DecodeConstants(this);
+	}
+
 	// Native callback for intrinsic functions. When non-null, this FuncDef
 	// represents a built-in function: CALL invokes the callback directly
 	// instead of executing bytecode.  Parameters are in stack[baseIndex+1..].
 	public NativeCallbackDelegate NativeCallback = null;
 
+	// Set, as well as NativeCallback, for a simple intrinsic: the VM calls
+	// this instead, without making a Context or IntrinsicResult.
+	public SimpleCallbackDelegate SimpleCallback = null;
+
 	public FuncDef() {
 	}
 
@@ -98,6 +205,33 @@ public class FuncDef {
 		if (MaxRegs < impliedCount) MaxRegs = impliedCount;
 	}
 
+	// A copy of this function for another isolate to run (see ParallelMap).
+	// The code and the line and inline tables are shared, since nothing
+	// changes them once the function is built.  Everything made of Values --
+	// constants, parameters, global names -- belongs to this isolate's heap,
+	// so the copy starts with those empty, for the caller to fill from the
+	// other one's; and it gets a global-reference cache of its own.  Call
+	// EnsureConstants first if the function may have come from the cache.
+	public FuncDef CopyForIsolate() {
+		FuncDef copy = new FuncDef();
+		copy.Name = Name;
+		copy.Code = Code;
+		// CPP: copy.get_storage()->BorrowedCode = BorrowedCode;
+		// CPP: copy.get_storage()->BorrowedCount = BorrowedCount;
+		copy.MaxRegs = MaxRegs;
+		copy.SelfReg = SelfReg;
+		copy.SuperReg = SuperReg;
+		copy.Note = Note;
+		copy.SourceLoc = SourceLoc;
+		copy.FileName = FileName;
+		copy._lineRLEPC = _lineRLEPC;
+		copy._lineRLELine = _lineRLELine;
+		copy._inlineStartPC = _inlineStartPC;
+		copy._inlineEndPC = _inlineEndPC;
+		copy._inlineCallLine = _inlineCallLine;
+		return copy;
+	}
+
 	// Returns a string like "functionName(a, b=1, c=0)"
 	public override String ToString() {
 		String result = Name + "(";
@@ -7,6 +7,11 @@ namespace MiniScript {
 // H: inline bool IsNull(HandleFinalizer f) { return f == nullptr; }
 public delegate void HandleFinalizer(object userData);
 
+// Callback invoked during the Mark phase for a GCHandle whose native object
+// holds Values of its own; it must GCManager.Mark each of them.
+// H: typedef void (*HandleMarker)(void* userData);
+public delegate void HandleMarker(object userData);
+
 // Interface for items managed by a GCSet.
 // Must be implemented by every GC-managed struct type.
 public interface IGCItem {
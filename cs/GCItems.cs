@@ -47,11 +47,16 @@ public struct GCList : IGCItem {
 	public Boolean Frozen;
 	public Boolean Computed;
 
+	// Content hash, cached on first use once the list is frozen (see
+	// Value.ListHash); 0 = not cached.  Cleared whenever Frozen changes.
+	public UInt32 HashCache;
+
 	[MethodImpl(AggressiveInlining)]
 	public void Init(Int32 capacity = 8) {
 		Items    = new List<Value>(Math.Max(capacity, 4));
 		Frozen   = false;
 		Computed = false;
+		HashCache = 0;
 	}
 
 	// Construct a computed list.  increment may be Value.Null to repeat baseVal.
@@ -62,6 +67,7 @@ public struct GCList : IGCItem {
 		Items.Add(new Value(length));
 		Frozen   = false;
 		Computed = true;
+		HashCache = 0;
 	}
 
 	// Replace a computed list with the equivalent materialized list.  No-op for
@@ -151,6 +157,24 @@ public struct GCList : IGCItem {
 		return result;
 	}
 
+	// Report the parameters of a computed list with a numeric increment (what
+	// `range` builds), so a caller can step through its elements with plain
+	// Double arithmetic instead of a Get per element.  Returns false for a
+	// materialized list, and for a repeating `[x] * n` list (null increment).
+	[MethodImpl(AggressiveInlining)]
+	public Boolean GetRange(out Double baseVal, out Double increment, out Int32 length) {
+		if (!Computed || Items[1].IsNull()) {
+			baseVal = 0;
+			increment = 0;
+			length = 0;
+			return false;
+		}
+		baseVal = Items[0].NumericVal();
+		increment = Items[1].NumericVal();
+		length = (Int32)Items[2].NumericVal();
+		return true;
+	}
+
 	public Int32 IndexOf(Value item, Int32 afterIdx) {
 		Int32 n = Count();
 		for (Int32 i = afterIdx + 1; i < n; i++) {
@@ -172,6 +196,7 @@ public struct GCList : IGCItem {
 		Items    = null;
 		Frozen   = false;
 		Computed = false;
+		HashCache = 0;
 	}
 }
 
@@ -198,6 +223,10 @@ public struct GCMap : IGCItem {
 	public Dictionary<Value, Value> Items;
 	public Boolean Frozen;
 
+	// Content hash, cached on first use once the map is frozen (see
+	// Value.MapHash); 0 = not cached.  Cleared whenever Frozen changes.
+	public UInt32 HashCache;
+
 	// Non-null for VarMap-backed maps (call-frame locals, closure contexts).
 	public VarMapBacking _vmb;
 
@@ -216,6 +245,7 @@ public struct GCMap : IGCItem {
 		Frozen = false;
 		_vmb   = null;
 		_gb    = null;
+		HashCache = 0;
 	}
 
 	// Initialize this slot as the view onto a global slot table.  Items stays
@@ -226,6 +256,7 @@ public struct GCMap : IGCItem {
 		Frozen = false;
 		_vmb   = null;
 		_gb    = g;
+		HashCache = 0;
 	}
 
 	public Boolean TryGet(Value key, out Value value) {
@@ -241,11 +272,18 @@ public struct GCMap : IGCItem {
 	}
 
 	public void Set(Value key, Value value) {
+		// A short string key is interned (GCManager.Intern), so that looking it
+		// up with a literal or identifier matches by bits alone.
+		key = GCManager.Intern(key);
 		if (_gb != null) { _gb.Set(key, value); return; }
 
 		// Store in register if VarMap-backed and key is register-mapped.
 		if (_vmb != null && _vmb.TrySet(key, value)) return;
 
+		// A list or map key is stored as a frozen copy (notes/FROZEN_VALUES.md),
+		// so later changes to the caller's container cannot invalidate its hash.
+		if (key.IsList() || key.IsMap()) key = key.FrozenCopy();
+
 		if (Items == null) Init();
 		Items[key] = value;
 	}
@@ -272,8 +310,12 @@ public struct GCMap : IGCItem {
 	// ── Iteration ─────────────────────────────────────────────────────────────
 	// iter = -1: start
 	// iter < -1: VarMap register entry -(i+2) where i is the reg-entry index
-	// iter >= 0: index into Items (in enumeration order), or -- for a globals
+	// iter >= 0: position in Items (in enumeration order), or -- for a globals
 	//            map, where Items is null -- a slot index in the global table
+	//
+	// In C++, the Dictionary finds a position in O(1) when it is stepped
+	// through in order (see KeyAtPosition in CS_Dictionary.h); in C# it is
+	// found by counting through the keys or values.
 
 	public Int32 NextEntry(Int32 after) {
 		// Globals: iter is the slot index directly.  Unassigned slots are
@@ -301,12 +343,15 @@ public struct GCMap : IGCItem {
 			return _vmb.GetRegEntryKey(regIdx);
 		}
 		if (Items == null) return Value.Null;
+		//*** BEGIN CS_ONLY ***
 		Int32 j = 0;
 		foreach (Value k in Items.Keys) {
 			if (j == i) return k;
 			j++;
 		}
 		return Value.Null;
+		//*** END CS_ONLY ***
+		// CPP: return Items.KeyAtPosition(i);
 	}
 
 	public Value ValueAt(Int32 i) {
@@ -316,12 +361,74 @@ public struct GCMap : IGCItem {
 			return _vmb.GetRegEntryValue(regIdx);
 		}
 		if (Items == null) return Value.Null;
+		//*** BEGIN CS_ONLY ***
 		Int32 j = 0;
 		foreach (Value v in Items.Values) {
 			if (j == i) return v;
 			j++;
 		}
 		return Value.Null;
+		//*** END CS_ONLY ***
+		// CPP: return Items.ValueAtPosition(i);
+	}
+
+	// ── Bulk operations ───────────────────────────────────────────────────────
+	// These work on the Dictionary as a whole when all entries live in Items
+	// (no VarMap or globals backing), instead of one NextEntry/KeyAt/Set round
+	// trip per entry.  A backed map falls back to that entry-at-a-time walk.
+
+	// Append every key to dst, in iteration order.
+	public void CopyKeysTo(List<Value> dst) {
+		if (_gb != null || _vmb != null) {
+			for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) dst.Add(KeyAt(i));
+			return;
+		}
+		if (Items == null) return;
+		foreach (Value k in Items.Keys) {
+			dst.Add(k);
+		}
+	}
+
+	// Append every value to dst, in iteration order.
+	public void CopyValuesTo(List<Value> dst) {
+		if (_gb != null || _vmb != null) {
+			for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) dst.Add(ValueAt(i));
+			return;
+		}
+		if (Items == null) return;
+		foreach (Value v in Items.Values) {
+			dst.Add(v);
+		}
+	}
+
+	// A new, unshared dictionary holding this map's entries in order.  For an
+	// unbacked map this copies the table wholesale.
+	public Dictionary<Value, Value> CopyItems() {
+		if (_gb == null && _vmb == null && Items != null) {
+			return new Dictionary<Value, Value>(Items);
+		}
+		Dictionary<Value, Value> result = new Dictionary<Value, Value>(Math.Max(Count(), 4));
+		for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) result[KeyAt(i)] = ValueAt(i);
+		return result;
+	}
+
+	// Store every entry of src in this map, as by Set, in src's order.
+	public void SetAll(GCMap src) {
+		if (_gb != null || _vmb != null || src._gb != null || src._vmb != null) {
+			for (Int32 i = src.NextEntry(-1); i != -1; i = src.NextEntry(i)) {
+				Set(src.KeyAt(i), src.ValueAt(i));
+			}
+			return;
+		}
+		if (src.Items == null) return;
+		if (Items == null) Init(src.Items.Count);
+		//*** BEGIN CS_ONLY ***
+		Items.EnsureCapacity(Items.Count + src.Items.Count);
+		foreach (KeyValuePair<Value, Value> kv in src.Items) {
+			Items[kv.Key] = kv.Value;
+		}
+		//*** END CS_ONLY ***
+		// CPP: Items.SetAll(src.Items);
 	}
 
 	// ── GC ────────────────────────────────────────────────────────────────────
@@ -344,6 +451,7 @@ public struct GCMap : IGCItem {
 		Frozen = false;
 		_vmb   = null;
 		_gb    = null;
+		HashCache = 0;
 	}
 }
 
@@ -404,15 +512,18 @@ public struct GCFunction : IGCItem {
 }
 
 // ── GCHandle ──────────────────────────────────────────────────────────────────
-// A leaf GC type wrapping an arbitrary native object (void* in C++, object in C#).
+// A GC type wrapping an arbitrary native object (void* in C++, object in C#).
 // When swept, invokes Callback(UserData) so the host can free native resources.
+// Usually a leaf; but a native object that holds Values (a coroutine's
+// registers, say) gives a Marker, which marks them whenever the handle is.
 
 public struct GCHandle : IGCItem {
 	public object UserData;
 	public HandleFinalizer Callback;
+	public HandleMarker Marker;
 
 	public void MarkChildren() {
-		// handles have no child Values
+		if (Marker != null) Marker(UserData);
 	}
 
 	[MethodImpl(AggressiveInlining)]
@@ -420,6 +531,7 @@ public struct GCHandle : IGCItem {
 		if (Callback != null) Callback(UserData);
 		UserData = null;
 		Callback = null;
+		Marker = null;
 	}
 }
 
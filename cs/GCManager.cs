@@ -15,6 +15,16 @@ namespace MiniScript {
 // Mark(Value) dispatches to the right GCSet using the GCSet index baked into
 // the Value bits — no switch statement, just array indexing.
 //
+// The heap is per thread: every field below is thread-static, and Init makes
+// the calling thread's own sets, roots and intern table.  A thread with its
+// own heap is an isolate -- it can run interpreters in parallel with other
+// isolates, with no locking, because no GC state is shared.  (C++ keeps its
+// C-string arena per thread too; see cstr_arena.h.)  The catch is that a
+// Value is only an index into its own thread's sets: a Value, or anything
+// holding one, must not be handed to another isolate -- unless it has been
+// published to the SharedHeap, which every isolate can read.  See
+// notes/MEMORY_SYSTEMS.md, "Isolates".
+//
 public static class GCManager {
 
 	// GCSet indices — these constants define the encoding baked into every GC Value.
@@ -31,25 +41,26 @@ public static class GCManager {
 	// Strings of Length >= InternThreshold go into the ordinary BigStrings set.
 	public const Int32 InternThreshold = 128;
 
-	// Typed accessors; use these to allocate new objects.
-	public static GCStringSet BigStrings = null;
-	public static GCStringSet InternedStrings = null;
-	public static GCListSet Lists = null;
-	public static GCMapSet Maps = null;
-	public static GCErrorSet Errors = null;
-	public static GCFuncRefSet Functions = null;
-	public static GCHandleSet Handles = null;
+	// Typed accessors; use these to allocate new objects.  (These, and the
+	// rest of the state, are this thread's; see above.)
+	[ThreadStatic] public static GCStringSet BigStrings;
+	[ThreadStatic] public static GCStringSet InternedStrings;
+	[ThreadStatic] public static GCListSet Lists;
+	[ThreadStatic] public static GCMapSet Maps;
+	[ThreadStatic] public static GCErrorSet Errors;
+	[ThreadStatic] public static GCFuncRefSet Functions;
+	[ThreadStatic] public static GCHandleSet Handles;
 
 	// Content-addressed intern table for short heap strings.
 	// Maps string content → InternedStrings slot index.
-	private static Dictionary<String, Int32> _internTable = null;
+	[ThreadStatic] private static Dictionary<String, Int32> _internTable;
 
 
 	// When true, the current GC pass is a full collection that also marks
 	// and sweeps the InternedStrings set.  Normal cycles leave it untouched.
-	private static Boolean _fullCollection = false;
+	[ThreadStatic] private static Boolean _fullCollection;
 
-	private static List<Value> _roots = null;
+	[ThreadStatic] private static List<Value> _roots;
 
 	// ── Mark callbacks ───────────────────────────────────────────────────────
 	// Callback registered by a VM (or any other root provider) and invoked once
@@ -57,11 +68,14 @@ public static class GCManager {
 	// every root Value it owns.
 	public delegate void MarkCallback(object userData);
 
-	private static List<MarkCallback> _markCallbackFns = null;
-	private static List<object> _markCallbackData = null;
+	[ThreadStatic] private static List<MarkCallback> _markCallbackFns;
+	[ThreadStatic] private static List<object> _markCallbackData;
 
+	// Make the calling thread's heap, if it has none yet.  Call this first on
+	// every thread that will run MiniScript code (then ErrorTypes.Init, and
+	// the host's own intrinsics, as on the main thread).
 	public static void Init() {
-		if (_roots != null) return;	// already initialized
+		if (_roots != null) return;	// already initialized on this thread
 		BigStrings      = new GCStringSet();
 		InternedStrings = new GCStringSet();
 		Lists           = new GCListSet();
@@ -80,10 +94,17 @@ public static class GCManager {
 		// who can allocate a funcref and root it.  A bare FuncDef is all we can
 		// build without reaching into the VM layer -- Globals installs the
 		// reporting callback on it.
+		//
+		// Each heap gets its own sentinel, but as the first funcref made in a
+		// fresh heap it has the same bits in all of them, so the one shared
+		// Value.Unassigned is right everywhere.  It is written only by the
+		// first Init in the process, which must finish before any other thread
+		// starts its own.
 		FuncDef unassignedFunc = new FuncDef();
 		unassignedFunc.Name = "<unassigned>";
-		Value.Unassigned = NewFuncRef(unassignedFunc, Value.Null);
-		AddRoot(Value.Unassigned);
+		Value sentinel = NewFuncRef(unassignedFunc, Value.Null);
+		if (Value.Unassigned.Bits() != sentinel.Bits()) Value.Unassigned = sentinel;
+		AddRoot(sentinel);
 	}
 
 	// ── Value factories ──────────────────────────────────────────────────────
@@ -102,11 +123,24 @@ public static class GCManager {
 			return Value.make_gc(InternedStringSet, idx);
 		}
 		idx = InternedStrings.AllocItem();
-		InternedStrings.SetData(idx, s);
+		InternedStrings.SetInterned(idx, s, Value.StringHash(s));
 		_internTable[s] = idx;
 		return Value.make_gc(InternedStringSet, idx);
 	}
 
+	// Return the interned equivalent of v if it is a heap string under
+	// InternThreshold that is not interned yet; otherwise v itself.  Strings
+	// built at run time are not interned when made, only when they become a
+	// map key (GCMap.Set), so most of them never touch the intern table.
+	// A shared string is left as it is: it may be a key of a shared map,
+	// which every isolate reads, and interned slots belong to this thread.
+	public static Value Intern(Value v) {
+		if (!v.IsHeapString() || v.IsInternedString() || v.IsShared()) return v;
+		String s = GetString(v).Data;
+		if (s == null || s.Length >= InternThreshold) return v;
+		return InternString(s);
+	}
+
 	public static Value NewList(Int32 capacity = 8) {
 		Int32 idx = Lists.AllocItem();
 		Lists.Init(idx, capacity);
@@ -167,6 +201,14 @@ public static class GCManager {
 		return Value.make_gc(HandleSet, idx);
 	}
 
+	// A handle whose native object holds Values: marker marks them (see GCHandle).
+	public static Value NewHandle(object userData, HandleFinalizer callback, HandleMarker marker) {
+		Int32 idx = Handles.AllocItem();
+		Handles.SetFields(idx, userData, callback);
+		Handles.SetMarker(idx, marker);
+		return Value.make_gc(HandleSet, idx);
+	}
+
 	// ── Retain / Release ─────────────────────────────────────────────────────
 
 	public static void Retain(Value v) {
@@ -215,6 +257,7 @@ public static class GCManager {
 	}
 
 	private static void DispatchMark(Int32 setIdx, Int32 itemIdx) {
+		if (itemIdx >= SharedHeap.FirstIndex) return;	// immortal; see SharedHeap
 		switch (setIdx) {
 			case BigStringSet:  BigStrings.Mark(itemIdx);  break;
 			case ListSet:    Lists.Mark(itemIdx);    break;
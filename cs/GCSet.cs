@@ -4,6 +4,7 @@ using System.Runtime.CompilerServices;
 using static System.Runtime.CompilerServices.MethodImplOptions;
 // H: #include "GCInterfaces.g.h"
 // H: #include "GCItems.g.h"
+// H: #include "SharedHeap.g.h"
 
 namespace MiniScript {
 
@@ -13,6 +14,11 @@ namespace MiniScript {
 // Subclasses supply the typed item list and the three abstract item operations.
 // Satisfies the IGCSet conceptual interface (see GCInterfaces.cs).
 //
+// Indices from SharedHeap.FirstIndex up are not this set's items but shared,
+// immortal ones (see SharedHeap.cs).  The string, list and map sets read
+// those from the SharedHeap; they are never retained, marked or swept, and
+// the calls that would change one do nothing.
+//
 public abstract class GCSetBase {
 	protected List<Boolean> _inUse = new List<Boolean>();
 	protected List<Boolean> _marked = new List<Boolean>();
@@ -51,11 +57,13 @@ public abstract class GCSetBase {
 	// ── Retain / Release ─────────────────────────────────────────────────────
 
 	public void Retain(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return;
 		if (_retainCounts[idx] == 255) throw new InvalidOperationException("GCSet retained > 255 times"); // CPP: 
 		_retainCounts[idx]++;
 	}
 
 	public void Release(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return;
 		if (_retainCounts[idx] == 0) throw new InvalidOperationException("GCSet released more than retained"); // CPP: 
 		_retainCounts[idx]--;
 	}
@@ -92,6 +100,7 @@ public abstract class GCSetBase {
 	// True if slot idx is currently in use and will survive the next Sweep
 	// (either it was marked this cycle, or it has a non-zero retain count).
 	public Boolean IsLiveSlot(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return true;
 		return _inUse[idx] && (_marked[idx] || _retainCounts[idx] > 0);
 	}
 
@@ -109,8 +118,14 @@ public abstract class GCSetBase {
 public class GCStringSet : GCSetBase {
 	private List<GCString> _items;
 
+	// Content hash of each interned item (see SetInterned), so that hashing an
+	// interned Value (e.g. as a map key) is a read.  Kept apart from _items so
+	// that the BigStrings set, which never fills it in, pays nothing for it.
+	private List<UInt32> _hashes;
+
 	public GCStringSet(Int32 initialCapacity = 64) {
 		_items = new List<GCString>(initialCapacity);
+		_hashes = new List<UInt32>();
 	}
 
 	protected override void CallMarkChildren(Int32 idx) {
@@ -127,6 +142,7 @@ public class GCStringSet : GCSetBase {
 
 	[MethodImpl(AggressiveInlining)]
 	public GCString Get(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetString(idx);
 		return _items[idx];
 	}
 
@@ -136,6 +152,19 @@ public class GCStringSet : GCSetBase {
 		item.Data = s;
 		_items[idx] = item;
 	}
+
+	// Store an interned string together with its content hash.
+	public void SetInterned(Int32 idx, String s, UInt32 hash) {
+		SetData(idx, s);
+		while (_hashes.Count <= idx) _hashes.Add(0);
+		_hashes[idx] = hash;
+	}
+
+	// Stored content hash of interned item idx (see SetInterned).
+	[MethodImpl(AggressiveInlining)]
+	public UInt32 GetHash(Int32 idx) {
+		return _hashes[idx];
+	}
 }
 
 // ── GCListSet ─────────────────────────────────────────────────────────────────
@@ -161,9 +190,18 @@ public class GCListSet : GCSetBase {
 
 	[MethodImpl(AggressiveInlining)]
 	public GCList Get(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetList(idx);
 		return _items[idx];
 	}
 
+	// Range parameters of list idx, read in place (see GCList.GetRange).  Used
+	// by the VM's `for` loop, which must not copy the GCList each iteration.
+	[MethodImpl(AggressiveInlining)]
+	public Boolean GetRange(Int32 idx, out Double baseVal, out Double increment, out Int32 length) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetList(idx).GetRange(out baseVal, out increment, out length);
+		return _items[idx].GetRange(out baseVal, out increment, out length);
+	}
+
 	public void Init(Int32 idx, Int32 capacity) {
 		GCList item = _items[idx];
 		item.Init(capacity);
@@ -172,8 +210,33 @@ public class GCListSet : GCSetBase {
 
 	[MethodImpl(AggressiveInlining)]
 	public void SetFrozen(Int32 idx, Boolean frozen) {
+		if (idx >= SharedHeap.FirstIndex) return;
 		GCList item = _items[idx];
 		item.Frozen = frozen;
+		item.HashCache = 0;
+		_items[idx] = item;
+	}
+
+	// Frozen flag and cached content hash of item idx, read in place.
+	[MethodImpl(AggressiveInlining)]
+	public Boolean IsFrozen(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return true;
+		return _items[idx].Frozen;
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public UInt32 GetHashCache(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetList(idx).HashCache;
+		return _items[idx].HashCache;
+	}
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	[MethodImpl(AggressiveInlining)]
+	public void SetHashCache(Int32 idx, UInt32 hash) {
+		if (idx >= SharedHeap.FirstIndex) return;
+		GCList item = _items[idx];
+		item.HashCache = hash;
 		_items[idx] = item;
 	}
 
@@ -182,6 +245,7 @@ public class GCListSet : GCSetBase {
 	// cleared Computed flag are not lost to struct-copy semantics.
 	[MethodImpl(AggressiveInlining)]
 	public void Set(Int32 idx, GCList item) {
+		if (idx >= SharedHeap.FirstIndex) return;
 		_items[idx] = item;
 	}
 }
@@ -209,6 +273,7 @@ public class GCMapSet : GCSetBase {
 
 	[MethodImpl(AggressiveInlining)]
 	public GCMap Get(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetMap(idx);
 		return _items[idx];
 	}
 
@@ -227,8 +292,33 @@ public class GCMapSet : GCSetBase {
 
 	[MethodImpl(AggressiveInlining)]
 	public void SetFrozen(Int32 idx, Boolean frozen) {
+		if (idx >= SharedHeap.FirstIndex) return;
 		GCMap item = _items[idx];
 		item.Frozen = frozen;
+		item.HashCache = 0;
+		_items[idx] = item;
+	}
+
+	// Frozen flag and cached content hash of item idx, read in place.
+	[MethodImpl(AggressiveInlining)]
+	public Boolean IsFrozen(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return true;
+		return _items[idx].Frozen;
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public UInt32 GetHashCache(Int32 idx) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetMap(idx).HashCache;
+		return _items[idx].HashCache;
+	}
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	[MethodImpl(AggressiveInlining)]
+	public void SetHashCache(Int32 idx, UInt32 hash) {
+		if (idx >= SharedHeap.FirstIndex) return;
+		GCMap item = _items[idx];
+		item.HashCache = hash;
 		_items[idx] = item;
 	}
 
@@ -239,6 +329,27 @@ public class GCMapSet : GCSetBase {
 		_items[idx] = item;
 	}
 
+	// Iteration over map idx, read in place (see GCMap.NextEntry).  Used by
+	// the VM's `for` loop and map iterators, which must not copy the GCMap on
+	// every step.
+	[MethodImpl(AggressiveInlining)]
+	public Int32 NextEntry(Int32 idx, Int32 after) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetMap(idx).NextEntry(after);
+		return _items[idx].NextEntry(after);
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public Value KeyAt(Int32 idx, Int32 i) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetMap(idx).KeyAt(i);
+		return _items[idx].KeyAt(i);
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public Value ValueAt(Int32 idx, Int32 i) {
+		if (idx >= SharedHeap.FirstIndex) return SharedHeap.GetMap(idx).ValueAt(i);
+		return _items[idx].ValueAt(i);
+	}
+
 	// Attach an existing dictionary as this slot's contents, sharing its
 	// storage rather than copying entries (Dictionary assignment shares the
 	// underlying table).  Leaves Frozen and _vmb untouched, so this is meant
@@ -319,6 +430,14 @@ public class GCHandleSet : GCSetBase {
 		GCHandle item = _items[idx];
 		item.UserData = userData;
 		item.Callback = callback;
+		item.Marker = null;
+		_items[idx] = item;
+	}
+
+	[MethodImpl(AggressiveInlining)]
+	public void SetMarker(Int32 idx, HandleMarker marker) {
+		GCHandle item = _items[idx];
+		item.Marker = marker;
 		_items[idx] = item;
 	}
 }
@@ -75,7 +75,10 @@ public class Globals {
 	// Pre-incremented, so the first Globals gets Id 1 and 0 is never a valid Id
 	// -- which lets a not-yet-resolved slot cache use 0 as its "never resolved"
 	// marker.
-	private static Int32 _lastId = 0;
+	//
+	// Per thread: an Id need only be unique among the namespaces of one
+	// isolate (see GCManager), and the isolates must not race on it.
+	[ThreadStatic] private static Int32 _lastId;
 
 	//
 	// Make a new, empty global namespace.  Use this rather than `new Globals()`
@@ -287,6 +290,78 @@ public class Globals {
 		return -1;
 	}
 
+	// ── Cloning ───────────────────────────────────────────────────────────────
+
+	// A new namespace holding a copy of every global here, for another
+	// interpreter to start from (see Interpreter.Clone).  The copy must be one
+	// the clone can change freely without the change showing up here, so
+	// mutable lists and maps are copied, however deeply nested, and a structure
+	// shared or cyclic here is shared or cyclic in the copy.  Everything
+	// immutable -- numbers, strings, frozen lists and maps, FuncDefs -- is
+	// shared, so a prelude that freezes its tables costs next to nothing to
+	// clone.  A function whose closure is this namespace gets the copy instead,
+	// so a top-level function defined here sees the clone's globals.
+	//
+	// Slots are made in the same order, so the copy numbers its names exactly
+	// as this one does; it still gets its own Id, since the two grow apart.
+	public Globals Clone() {
+		Globals g = Create();
+		g.CopyFrom(this);
+		return g;
+	}
+
+	// Make this namespace a copy of src, as Clone does, but in place: every
+	// global not in src is unbound, and this object keeps its Id and its slots.
+	// Reusing a namespace this way (see Interpreter.Recycle) costs no more
+	// than copying src's mutable data, and keeps valid every slot resolution
+	// compiled code has already made against it.
+	public void CopyFrom(Globals src) {
+		Clear();
+		Dictionary<Int32, Value> lists = new Dictionary<Int32, Value>();  // list index -> its copy
+		Dictionary<Int32, Value> maps = new Dictionary<Int32, Value>();   // map index -> its copy
+		maps[src.AsMap().ItemIndex()] = _mapValue;
+		Int32 count = src.SlotCount();
+		for (Int32 i = 0; i < count; i++) {
+			Int32 slot = Resolve(src.NameAtSlot(i));	// (unassigned ones too, to keep the numbering)
+			Value v = src.ValueAtSlot(i);
+			if (!v.IsUnassigned()) SetSlot(slot, CloneValue(v, lists, maps));
+		}
+	}
+
+	// A copy of v for CopyFrom, made at most once per list or map.
+	private static Value CloneValue(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps) {
+		Value copy;
+		if (v.IsList()) {
+			if (v.IsFrozen()) return v;
+			if (lists.TryGetValue(v.ItemIndex(), out copy)) return copy;
+			Int32 count = v.ListCount();
+			copy = Value.make_list(count);
+			lists[v.ItemIndex()] = copy;	// (before the items, which may lead back here)
+			for (Int32 i = 0; i < count; i++) copy.Push(CloneValue(v.ListGet(i), lists, maps));
+			return copy;
+		}
+		if (v.IsMap()) {
+			if (v.IsFrozen()) return v;
+			if (maps.TryGetValue(v.ItemIndex(), out copy)) return copy;
+			GCMap m = GCManager.Maps.Get(v.ItemIndex());
+			if (m._gb != null) return v;	// some other interpreter's globals
+			copy = Value.make_map(m.Count());
+			maps[v.ItemIndex()] = copy;
+			for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+				copy.MapSet(m.KeyAt(i), CloneValue(m.ValueAt(i), lists, maps));
+			}
+			return copy;
+		}
+		if (v.IsFuncRef() && !v.IsUnassigned()) {
+			Value outer = v.OuterVars();
+			if (outer.IsNull()) return v;
+			Value outerCopy = CloneValue(outer, lists, maps);
+			if (outerCopy.RefEquals(outer)) return v;
+			return Value.make_funcref(v.FunctionDef(), outerCopy);
+		}
+		return v;
+	}
+
 	// ── GC ────────────────────────────────────────────────────────────────────
 
 	// Mark every name and value held here.  Reached from GCMap.MarkChildren on
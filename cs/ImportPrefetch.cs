@@ -0,0 +1,304 @@
+// ImportPrefetch.cs
+//
+// Background parsing of the modules a script imports.  `import` compiles a
+// module only when the import runs, so a script that imports dozens of
+// modules parses them one after another on the VM thread.  When the shell
+// loads a script it hands the source to ImportPrefetch.Start, which sets
+// worker threads to finding each `import "name"` with a literal name, and to
+// reading and parsing those modules (and, in turn, the modules they import).
+// When the import itself runs, the import intrinsic finds and reads the
+// module just as before, and takes the prefetched statements only if they
+// were parsed from exactly that source.  Code generation, and running the
+// module, stay on the VM thread.  So the order and effect of imports do not
+// change: a prefetch that guessed wrong (MS_IMPORT_PATH changed by then, the
+// file changed, the import never reached) simply goes unused.
+//
+// Only the front end runs on the workers.  Code generation makes Values --
+// constants, function templates -- and the GC heap belongs to the VM thread.
+// For the same reason a worker's parser runs Detached: a parse error is only
+// noted, and the import parses the module again itself to report it.
+//
+// The number of workers is ThreadCount.  Hosts may set it; if they do not, it
+// is read once from the MS_IMPORT_PREFETCH environment variable.  It is 0
+// (prefetching off) unless set, because in C++ a second thread is not free:
+// once a process has started one, libstdc++ makes every shared_ptr copy an
+// atomic operation for the rest of the run, which costs the VM far more than
+// it saves a script that mostly computes (see notes/POTENTIAL_ISSUES.md).
+
+using System;
+using System.Collections.Generic;
+// H: #include "AST.g.h"
+// CPP: #include "Parser.g.h"
+// CPP: #include "Lexer.g.h"
+// CPP: #include "ShellIntrinsics.g.h"
+// CPP: #include <cstdlib>
+/*** BEGIN CPP_ONLY ***
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+*** END CPP_ONLY ***/
+
+namespace MiniScript {
+
+public static class ImportPrefetch {
+	// Worker threads to use; -1 until resolved (see GetThreadCount).
+	public static Int32 ThreadCount = -1;
+
+	// The jobs, one per module name, in the order they were found.  A job with
+	// an empty name is a script handed to Start: it is only scanned for
+	// imports.  Everything here is shared with the workers, and guarded by the
+	// lock (see Lock and Unlock).  A job's statements are a run of _statements,
+	// since a list of lists is more than the transpiler can take.
+	private static List<String> _names = new List<String>();      // library name
+	private static List<String> _sources = new List<String>();    // its source, once read ("" if not found)
+	private static List<Int32> _firstStatement = new List<Int32>(); // its statements in _statements, or -1
+	private static List<Int32> _statementCount = new List<Int32>();
+	private static List<ASTNode> _statements = new List<ASTNode>();
+	private static List<Boolean> _claimed = new List<Boolean>();  // a worker (or Take) has it
+	private static List<Boolean> _done = new List<Boolean>();     // its source and statements are final
+	private static Int32 _nextJob = 0;          // no job before this one is unclaimed
+	private static List<String> _dirs = new List<String>();       // where to look, in search order
+	private static Boolean _stopping = false;
+	private static Boolean _started = false;    // (VM thread only) Start has been called
+	private static Int32 _threadsRunning = 0;
+
+	//*** BEGIN CS_ONLY ***
+	private static readonly Object _lock = new Object();
+	private static List<System.Threading.Thread> _threads = new List<System.Threading.Thread>();
+	//*** END CS_ONLY ***
+	/*** BEGIN CPP_ONLY ***
+	static std::mutex _mutex;
+	static std::condition_variable_any _changed;
+	// Made on first use, so that it is destroyed (joining the workers) before
+	// the job lists above, which the workers may still be using.
+	struct PrefetchThreads {
+		std::vector<std::thread> threads;
+		~PrefetchThreads() { ImportPrefetch::Stop(); }
+	};
+	static PrefetchThreads& Threads() {
+		static PrefetchThreads threads;
+		return threads;
+	}
+	*** END CPP_ONLY ***/
+
+	public static Int32 GetThreadCount() {
+		if (ThreadCount < 0) {
+			ThreadCount = 0;
+			//*** BEGIN CS_ONLY ***
+			String env = Environment.GetEnvironmentVariable("MS_IMPORT_PREFETCH");
+			Int32 n;
+			if (env != null && Int32.TryParse(env, out n)) ThreadCount = n;
+			//*** END CS_ONLY ***
+			/*** BEGIN CPP_ONLY ***
+			const char* env = getenv("MS_IMPORT_PREFETCH");
+			if (env) ThreadCount = atoi(env);
+			*** END CPP_ONLY ***/
+			if (ThreadCount < 0) ThreadCount = 0;
+		}
+		return ThreadCount;
+	}
+
+	// Start prefetching the modules that `source` imports, looking for them in
+	// `dirs`: directory prefixes, already expanded, each ending in a separator
+	// (or empty, for the current directory).  Returns at once.
+	public static void Start(String source, List<String> dirs) {
+		if (GetThreadCount() <= 0) return;
+		_started = true;
+		Lock();
+		_dirs = dirs;
+		AddJob("", source);
+		Notify();
+		Unlock();
+		StartThreads();
+	}
+
+	// The statements of module `name`, if they were prefetched from exactly
+	// `source`; otherwise null, and the caller should parse it as usual.  Waits
+	// if a worker is still on it.  A module is handed out only once, so a
+	// second import of it parses afresh.
+	public static List<ASTNode> Take(String name, String source) {
+		if (!_started) return null;
+		List<ASTNode> result = null;
+		Lock();
+		Int32 job = _names.IndexOf(name);
+		if (job >= 0 && !_claimed[job]) {
+			// Not begun yet: quicker to parse it on the spot than to wait.
+			_claimed[job] = true;
+			_done[job] = true;
+		}
+		if (job >= 0) {
+			while (!_done[job] && !_stopping) Wait();
+			Int32 first = _firstStatement[job];
+			if (_done[job] && first >= 0) {
+				if (_sources[job] == source) result = new List<ASTNode>();
+				for (Int32 i = first; i < first + _statementCount[job]; i++) {
+					if (result != null) result.Add(_statements[i]);
+					_statements[i] = null;
+				}
+			}
+			_firstStatement[job] = -1;
+			_sources[job] = "";
+		}
+		Unlock();
+		return result;
+	}
+
+	// Stop the workers and wait for them to finish, dropping any prefetched
+	// modules not yet taken.  Happens by itself at exit.
+	public static void Stop() {
+		Lock();
+		_stopping = true;
+		Notify();
+		Unlock();
+		//*** BEGIN CS_ONLY ***
+		for (Int32 i = 0; i < _threads.Count; i++) _threads[i].Join();
+		_threads.Clear();
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		std::vector<std::thread>& threads = Threads().threads;
+		for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+		threads.clear();
+		*** END CPP_ONLY ***/
+		Lock();
+		_names.Clear();
+		_sources.Clear();
+		_firstStatement.Clear();
+		_statementCount.Clear();
+		_statements.Clear();
+		_claimed.Clear();
+		_done.Clear();
+		_nextJob = 0;
+		_threadsRunning = 0;
+		_stopping = false;
+		Unlock();
+		_started = false;
+	}
+
+	// ── Workers ──────────────────────────────────────────────────────────────
+
+	private static void StartThreads() {
+		while (_threadsRunning < ThreadCount) {
+			_threadsRunning++;
+			//*** BEGIN CS_ONLY ***
+			System.Threading.Thread t = new System.Threading.Thread(WorkerLoop);
+			t.IsBackground = true;
+			t.Start();
+			_threads.Add(t);
+			//*** END CS_ONLY ***
+			// CPP: Threads().threads.push_back(std::thread(&ImportPrefetch::WorkerLoop));
+		}
+	}
+
+	// Add a job (under the lock).  A module already known is not added again.
+	private static void AddJob(String name, String source) {
+		if (name.Length > 0 && _names.IndexOf(name) >= 0) return;
+		_names.Add(name);
+		_sources.Add(source);
+		_firstStatement.Add(-1);
+		_statementCount.Add(0);
+		_claimed.Add(false);
+		_done.Add(false);
+	}
+
+	// Body of each worker: claim jobs in order until told to stop.
+	private static void WorkerLoop() {
+		Lock();
+		while (true) {
+			while (_nextJob < _names.Count && _claimed[_nextJob]) _nextJob++;
+			if (_stopping) break;
+			if (_nextJob >= _names.Count) {
+				Wait();
+				continue;
+			}
+			Int32 job = _nextJob;
+			_claimed[job] = true;
+			String name = _names[job];
+			String source = _sources[job];
+			List<String> dirs = _dirs;
+			Unlock();
+
+			List<ASTNode> statements = null;
+			if (name.Length > 0) {
+				source = ReadModule(name, dirs);
+				if (source.Length > 0) statements = Parse(source, name + ".ms");
+			}
+			List<String> imports = FindImports(source);
+
+			Lock();
+			_sources[job] = name.Length > 0 ? source : "";
+			if (statements != null) {
+				_firstStatement[job] = _statements.Count;
+				_statementCount[job] = statements.Count;
+				for (Int32 i = 0; i < statements.Count; i++) _statements.Add(statements[i]);
+			}
+			_done[job] = true;
+			for (Int32 i = 0; i < imports.Count; i++) AddJob(imports[i], "");
+			Notify();
+		}
+		Unlock();
+	}
+
+	// Find and read module `name`, as the import intrinsic would; "" if not found.
+	private static String ReadModule(String name, List<String> dirs) {
+		for (Int32 i = 0; i < dirs.Count; i++) {
+			String src = ShellIntrinsics.TryReadSource(dirs[i] + name + ".ms");
+			if (src == null) continue; // CPP: if (src.LengthB() == 0) continue;
+			return src;
+		}
+		return "";
+	}
+
+	// Parse and simplify a module, as Interpreter.CompileToFunc would; null on
+	// any error.
+	private static List<ASTNode> Parse(String source, String fileName) {
+		Parser parser = new Parser();
+		parser.Detached = true;
+		parser.Init(source, fileName);
+		List<ASTNode> statements = parser.ParseProgram();
+		parser.RequireComplete();
+		if (parser.HadError()) return null;
+		ASTSimplifier.SimplifyAll(statements);
+		return statements;
+	}
+
+	// The literal names imported by `import "name"` or `import("name")` in
+	// source.  Found from the tokens alone, so an occasional false hit is
+	// possible; it only costs an unused prefetch.
+	private static List<String> FindImports(String source) {
+		List<String> result = new List<String>();
+		Lexer lexer = new Lexer(source);
+		lexer.Detached = true;
+		Int32 state = 0;   // 1: just after `import`; 2: after `import(`
+		while (true) {
+			Token tok = lexer.NextToken();
+			if (tok.Type == TokenType.END_OF_INPUT || lexer.HadError()) break;
+			if (tok.Type == TokenType.STRING && state > 0) result.Add(tok.Text);
+			if (tok.Type == TokenType.IDENTIFIER && tok.Text == "import") state = 1;
+			else if (tok.Type == TokenType.LPAREN && state == 1) state = 2;
+			else state = 0;
+		}
+		return result;
+	}
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private static void Lock() {
+		System.Threading.Monitor.Enter(_lock); // CPP: _mutex.lock();
+	}
+
+	private static void Unlock() {
+		System.Threading.Monitor.Exit(_lock); // CPP: _mutex.unlock();
+	}
+
+	// Wait (holding the lock) until some other thread calls Notify.
+	private static void Wait() {
+		System.Threading.Monitor.Wait(_lock); // CPP: _changed.wait(_mutex);
+	}
+
+	private static void Notify() {
+		System.Threading.Monitor.PulseAll(_lock); // CPP: _changed.notify_all();
+	}
+}
+
+}
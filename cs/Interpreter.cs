@@ -15,9 +15,11 @@ using System.Collections.Generic;
 // H: #include "IOHelper.g.h"
 // H: #include "Bytecode.g.h"
 // H: #include "CodeGenerator.g.h"
+// H: #include "BytecodeCache.g.h"
 // CPP: #include "StringUtils.g.h"
 // CPP: #include "CS_value_util.h"
 // CPP: #include "CoreIntrinsics.g.h"
+// CPP: #include <thread>
 
 namespace MiniScript {
 
@@ -88,6 +90,14 @@ public class Interpreter {
 	// 
 	public Value Error;
 
+	// 
+	// How many AST nodes simplification (constant folding, dead-branch removal,
+	// and so on) removed from the most recently compiled source, or -1 if that
+	// source was loaded from the bytecode cache, so was not simplified here.
+	// Reported by the app under --debug.
+	// 
+	public Int32 SimplifiedNodeCount = 0;
+
 	// 
 	// The Value produced by the last complete REPL interaction that had implicit
 	// output (a bare expression as the last statement), or Value.Null otherwise.
@@ -105,6 +115,10 @@ public class Interpreter {
 	// Handed to each VM at Reset.  See notes/GLOBALS.md.
 	private Globals _globals;
 
+	// A VM kept by Recycle for the next compile to run on, so that a new job
+	// does not have to allocate fresh register and call stacks; null if none.
+	private VM _spareVM;
+
 	// H_WRAPPER: public: Interpreter(InterpreterStorage* p) : storage(p ? p->shared_from_this() : nullptr) {}  
   
 	// 
@@ -147,7 +161,32 @@ public class Interpreter {
 		if (_globals != null) _globals.Clear();
 	}
 
-	// 
+	//
+	// Make a new interpreter for the given source that starts where this one
+	// stands: its globals are a copy of ours (see Globals.Clone).  This is for
+	// hosts that run many short scripts against the same prelude -- run the
+	// prelude (imports, helper functions, classes) once in a template
+	// interpreter, then clone the template for each job, rather than compiling
+	// and running the prelude again every time.  Nothing the job does reaches
+	// the template, so it can be cloned again and again.
+	//
+	// Cloning is cheap in proportion to the prelude's mutable data; functions,
+	// strings and frozen lists and maps are shared, not copied.  The template
+	// should be idle (not partway through running) when cloned, and the clone
+	// belongs to the same thread, since it shares the template's heap.  The
+	// output delegates are the ones given here, as with the constructor;
+	// implicitOutput, hostData and SourceFile are carried over.
+	//
+	public Interpreter Clone(String source, TextOutputMethod standardOutput=null, TextOutputMethod errorOutput=null) {
+		Interpreter result = new Interpreter(source, standardOutput, errorOutput);
+		result.implicitOutput = implicitOutput;
+		result.hostData = hostData;
+		result.SourceFile = SourceFile;
+		result._globals = GetGlobals().Clone();
+		return result;
+	}
+
+	//
 	// Constructor taking source code in the form of a list of strings.
 	// 
 	public Interpreter(List<String> sourceList, TextOutputMethod standardOutput=null, TextOutputMethod errorOutput=null) {
@@ -223,6 +262,59 @@ public class Interpreter {
 		Compile();
 	}
 
+	//
+	// Get ready to run the given source as a new job, unrelated to the last
+	// one, keeping whatever the last one built that a new job can use: the
+	// VM, with its register and call stacks; the parser; the global namespace
+	// object (emptied); and, when the source is the same as last time, the
+	// compiled code, so that no compile is needed at all.  If startFrom is
+	// given, the globals start as a copy of it (see Globals.CopyFrom) -- a
+	// prelude's, say -- and otherwise empty.  This is Reset for hosts that run
+	// job after job, usually through an InterpreterPool; in the steady state,
+	// with a source already seen and no prelude data to copy, it allocates
+	// nothing.
+	//
+	// Not for use while this interpreter is running (from an intrinsic, say):
+	// the VM it keeps may be the one running.  ResetPreservingGlobals is the
+	// way to chain from inside a program.
+	//
+	public void Recycle(String _source, Globals startFrom=null) {
+		if (vm != null && (_source != source || compiledFunctions == null)) {
+			_spareVM = vm;	// the next Compile runs on it
+			vm = null;
+		}
+		if (vm == null) compiledFunctions = null;
+		source = _source;
+		Error = Value.Null;
+		lastImplicitResult = Value.Null;
+		_pendingSource = null;
+		Globals g = GetGlobals();
+		if (startFrom != null) g.CopyFrom(startFrom);
+		else g.Clear();
+		if (vm != null) vm.Reset(compiledFunctions, g);
+	}
+
+	//
+	// Stop, and let go of everything the current job holds -- its globals'
+	// values, and whatever its VM's registers and frames still refer to -- so
+	// that an interpreter kept idle for Recycle does not keep that job's data
+	// from being collected.
+	//
+	public void Retire() {
+		if (vm != null) vm.Idle();
+		ClearGlobals();
+		lastImplicitResult = Value.Null;
+		Error = Value.Null;
+	}
+
+	// The VM for a new program: the one Recycle kept, if any, else a new one.
+	private VM TakeVM() {
+		VM result = _spareVM;
+		_spareVM = null;
+		if (result == null) result = new VM();
+		return result;
+	}
+
 	// 
 	// Reset the interpreter with pre-compiled functions (e.g. from an assembler).
 	// The list must contain a FuncDef named "@main".
@@ -240,7 +332,7 @@ public class Interpreter {
 		}
 
 		// Create and configure VM
-		vm = new VM();
+		vm = TakeVM();
 		vm.SetInterpreter(this);
 		vm.Reset(functions, GetGlobals());
 	}
@@ -254,6 +346,17 @@ public class Interpreter {
 
 		Error = Value.Null;
 
+		// A cached compile of this exact source skips parsing and code generation.
+		List<FuncDef> cached = BytecodeCache.Load(source, SourceFile, false);
+		if (cached != null) {
+			SimplifiedNodeCount = -1;
+			compiledFunctions = cached;
+			vm = TakeVM();
+			vm.SetInterpreter(this);
+			vm.Reset(compiledFunctions, GetGlobals());
+			return;
+		}
+
 		if (parser == null) parser = new Parser();
 		parser.Init(source, SourceFile);
 		List<ASTNode> statements = parser.ParseProgram();
@@ -268,9 +371,7 @@ public class Interpreter {
 		if (statements.Count == 0) return;
 
 		// Simplify AST (constant folding, etc.)
-		for (Int32 i = 0; i < statements.Count; i++) {
-			statements[i] = statements[i].Simplify();
-		}
+		SimplifiedNodeCount = ASTSimplifier.SimplifyAll(statements);
 
 		// Compile to bytecode (offset past intrinsics so indices don't collide)
 		BytecodeEmitter emitter = new BytecodeEmitter();
@@ -285,11 +386,12 @@ public class Interpreter {
 		}
 
 		compiledFunctions = generator.GetFunctions();
+		BytecodeCache.Store(source, SourceFile, false, compiledFunctions);
 
 		// Create and configure VM, running in this interpreter's namespace --
 		// which already holds anything a host seeded, or (via
 		// ResetPreservingGlobals) the outgoing program's globals.
-		vm = new VM();
+		vm = TakeVM();
 		vm.SetInterpreter(this);
 		vm.Reset(compiledFunctions, GetGlobals());
 	}
@@ -305,18 +407,28 @@ public class Interpreter {
 	// and sets `error` to the error Value (Value.Null on success).
 	//
 	public static FuncDef CompileToFunc(String source, String fileName, out Value error) {
+		return CompileToFunc(source, fileName, null, out error);
+	}
+
+	// As above, but `parsed` may give the source's statements already parsed
+	// and simplified (as by ImportPrefetch), so that only code generation is
+	// left to do here.  Pass null to parse the source as usual.
+	public static FuncDef CompileToFunc(String source, String fileName, List<ASTNode> parsed, out Value error) {
 		error = Value.Null;
-		Parser parser = new Parser();
-		parser.Init(source, fileName);
-		List<ASTNode> statements = parser.ParseProgram();
-		parser.RequireComplete();   // a module file ends where it ends
-		if (parser.HadError()) {
-			error = parser.Error;
-			return null;
-		}
-		// Simplify AST (constant folding, etc.)
-		for (Int32 i = 0; i < statements.Count; i++) {
-			statements[i] = statements[i].Simplify();
+		List<FuncDef> cached = BytecodeCache.Load(source, fileName, true);
+		if (cached != null) return cached[0];
+		List<ASTNode> statements = parsed;
+		if (statements == null) {
+			Parser parser = new Parser();
+			parser.Init(source, fileName);
+			statements = parser.ParseProgram();
+			parser.RequireComplete();   // a module file ends where it ends
+			if (parser.HadError()) {
+				error = parser.Error;
+				return null;
+			}
+			// Simplify AST (constant folding, etc.)
+			ASTSimplifier.SimplifyAll(statements);
 		}
 		BytecodeEmitter emitter = new BytecodeEmitter();
 		CodeGenerator generator = new CodeGenerator(emitter);
@@ -327,6 +439,7 @@ public class Interpreter {
 			return null;
 		}
 		if (functions.Count == 0) return null;
+		BytecodeCache.Store(source, fileName, true, functions);
 		return functions[0];   // the module's @main
 	}
 
@@ -373,6 +486,22 @@ public class Interpreter {
 	// <param name="timeLimit">maximum amount of time to run before returning, in seconds</param>
 	// <param name="returnEarly">if true, return as soon as the VM yields</param>
 	public void RunUntilDone(double timeLimit=60, bool returnEarly=true) {
+		RunFor(timeLimit, returnEarly, false);
+	}
+
+	//
+	// Run for at most timeLimit seconds, returning as soon as the script
+	// yields, starts a wait, or is left blocked in an intrinsic such as
+	// receive (or ends).  This is for a host that takes turns among many
+	// interpreters on one thread -- see Scheduler -- and so wants control
+	// back, rather than sleeping or spinning, when this one has nothing to
+	// do; vm.SecondsToWake then says when it next will.
+	//
+	public void RunSlice(double timeLimit) {
+		RunFor(timeLimit, true, true);
+	}
+
+	private void RunFor(double timeLimit, bool returnEarly, bool returnOnWait) {
 		if (vm == null) {
 			Compile();
 			if (vm == null) return;		// (must have been some error)
@@ -389,6 +518,15 @@ public class Interpreter {
 				return;
 			}
 			if (returnEarly && vm.yielding) return;		// waiting for something
+			// In a wait, sleep until it is due (or our time is up) rather than
+			// spinning on the VM.
+			double wake = vm.SecondsToWake();
+			if (returnOnWait && (wake > 0 || vm.IsBlocked())) return;
+			if (wake > 0) {
+				double left = timeLimit - (vm.ElapsedTime() - startTime);
+				if (wake > left) wake = left;
+				if (wake > 0) System.Threading.Thread.Sleep(TimeSpan.FromSeconds(wake)); // CPP: if (wake > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wake));
+			}
 		}
 	}
 
@@ -415,6 +553,13 @@ public class Interpreter {
 	// <param name="sourceLine">line of source code to parse and run</param>
 	// <param name="timeLimit">time limit in seconds</param>
 	public void REPL(String sourceLine, double timeLimit=60) {
+		// An empty line is not nothing: with no VM yet it is how a host asks for
+		// one, so that globals can be seeded before any user code runs (see the
+		// empty-statements case below).  Null is treated the same, and must be:
+		// the C++ port represents an empty string AS null (CS_String.cpp), so
+		// there a caller passing "" arrives here indistinguishable from null,
+		// and bailing out would make that bootstrap impossible on that side.
+		// Parsing empty source is a path Compile() already relies on.
 		if (sourceLine == null) sourceLine = "";
 
 		// Accumulate source lines
@@ -451,9 +596,7 @@ public class Interpreter {
 		}
 
 		// Simplify AST
-		for (Int32 i = 0; i < statements.Count; i++) {
-			statements[i] = statements[i].Simplify();
-		}
+		SimplifiedNodeCount = ASTSimplifier.SimplifyAll(statements);
 
 		// Detect implicit output: last statement is a bare expression
 		// (not an assignment, block statement, break, continue, or return)
@@ -486,7 +629,7 @@ public class Interpreter {
 		// Create/reset VM.  The namespace is the interpreter's, so it is the same
 		// one every line -- there is no first-line special case, and nothing is
 		// rebound onto the new @main's registers.
-		if (vm == null) vm = new VM();
+		if (vm == null) vm = TakeVM();
 		vm.SetInterpreter(this);
 		vm.Reset(functions, GetGlobals());
 
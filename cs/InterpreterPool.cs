@@ -0,0 +1,85 @@
+// InterpreterPool.cs
+//
+// A pool of interpreters for hosts that run one short script after another
+// (a job per request, say).  Making an Interpreter for each job costs a VM --
+// a 10240-slot register stack and a 256-slot call stack -- plus a parser, a
+// global namespace and a compile.  Lease hands out an interpreter that an
+// earlier job has Returned, Recycled for the new source, so all of that is
+// reused: in the steady state, running a job whose source the interpreter
+// has run before needs no compile and no allocation beyond what the script
+// itself does.
+//
+// A pool may be given a prelude: an interpreter that has already run the
+// code every job needs (imports, helper functions, classes).  Each leased
+// interpreter then starts with a copy of the prelude's globals, as with
+// Interpreter.Clone, and the prelude itself is never changed by a job.
+//
+// Everything here belongs to one thread, like the heap it works on (see
+// GCManager).  A host with several threads keeps a pool on each.
+
+using System;
+using System.Collections.Generic;
+// H: #include "Interpreter.g.h"
+
+namespace MiniScript {
+
+public class InterpreterPool {
+
+	private List<Interpreter> _idle;   // Returned, and ready to Lease again
+	private Interpreter _prelude;      // whose globals each job starts from, or null
+
+	// Output delegates given to every interpreter the pool makes.  A host
+	// that wants a job's output kept apart may set them on the leased
+	// interpreter instead; they are left as they are on Return.
+	public TextOutputMethod standardOutput = null;
+	public TextOutputMethod errorOutput = null;
+
+	public InterpreterPool(Interpreter prelude=null) {
+		_idle = new List<Interpreter>();
+		_prelude = prelude;
+		standardOutput = null;
+		errorOutput = null;
+	}
+
+	// An interpreter ready to run the given source (call RunUntilDone), with
+	// fresh globals -- or a fresh copy of the prelude's.  Hand it back with
+	// Return when the job is over.
+	public Interpreter Lease(String source) {
+		Interpreter interp;
+		if (_idle.Count > 0) {
+			interp = _idle[_idle.Count - 1];
+			_idle.RemoveAt(_idle.Count - 1);
+		} else {
+			interp = new Interpreter("", standardOutput, errorOutput);
+			if (_prelude != null) {
+				interp.SourceFile = _prelude.SourceFile;
+				interp.hostData = _prelude.hostData;
+			}
+		}
+		Globals startFrom = null;
+		if (_prelude != null) startFrom = _prelude.GetGlobals();
+		interp.Recycle(source, startFrom);
+		return interp;
+	}
+
+	// Take back an interpreter from Lease.  Its job is stopped if it is still
+	// running, and what the job held is let go (see Interpreter.Retire); the
+	// interpreter must not be used again until it is leased again.
+	public void Return(Interpreter interp) {
+		interp.Retire();
+		_idle.Add(interp);
+	}
+
+	// How many interpreters are waiting to be leased.
+	public Int32 IdleCount() {
+		return _idle.Count;
+	}
+
+	// Drop every idle interpreter (and the memory its VM holds).
+	public void Clear() {
+		for (Int32 i = 0; i < _idle.Count; i++) _idle[i].Reset("");	// (releases its globals)
+		_idle.Clear();
+	}
+}
+
+}
@@ -3,11 +3,20 @@
 //   f = Intrinsic.Create("name");
 //   f.AddParam("paramName", defaultValue);
 //   f.Code = (stk, bi, ac) => { ... };
+// An intrinsic that always finishes at once, and needs nothing from the VM
+// but its arguments, can instead be defined as a simple intrinsic:
+//   f.SimpleCode = (Span<Value> args, Int32 argCount) => { ... };
+// which gets its arguments in place (a raw Value* in C++) and returns its
+// result directly.  The VM calls it without making a Context or an
+// IntrinsicResult for each call, which is worth it for the hottest ones.
+// A simple intrinsic reports an error through VM.ActiveVM(), and must not
+// use Value.c_str (its call is not bracketed by a CStrArena mark).
 
 using System;
 using System.Collections.Generic;
 // H: #include "value.h"
 // H: #include "FuncDef.g.h"
+// H: #include "IntrinsicAPI.g.h"
 // CPP: #include "CoreIntrinsics.g.h"
 
 namespace MiniScript {
@@ -16,26 +25,36 @@ public class Intrinsic {
 	public String Name;
 
 	public NativeCallbackDelegate Code;
+	public SimpleCallbackDelegate SimpleCode = null;
+
+	// Position in the registry (see GetByIndex), and whether this is one of
+	// the built-ins defined by CoreIntrinsics.Init, which every thread defines
+	// in the same order.
+	public Int32 Index = -1;
+	public Boolean Core = false;
 
 	private List<String> _paramNames;
 	private List<Value> _paramDefaults;
 	private FuncDef _funcDef = null;
 	private Value _funcRef = Value.Null;
 
-	private static List<Intrinsic> _all = new List<Intrinsic>();
-	private static Dictionary<String, Intrinsic> _byName = new Dictionary<String, Intrinsic>();
-	private static Boolean _initialized = false;
-	private static Boolean _markCallbackRegistered = false;
+	// The registry is per thread, like the GC heap its funcrefs live in (see
+	// GCManager): each isolate defines and builds its own set of intrinsics.
+	// Made on first use on each thread (see EnsureRegistry).
+	[ThreadStatic] private static List<Intrinsic> _all;
+	[ThreadStatic] private static Dictionary<String, Intrinsic> _byName;
+	[ThreadStatic] private static Boolean _initialized;
+	[ThreadStatic] private static Boolean _definingCore;
 
 	// Short-name registry: maps known Values (e.g. type maps) to display names.
-	private static List<Value> _shortNameKeys = new List<Value>();
-	private static List<String> _shortNameVals = new List<String>();
+	[ThreadStatic] private static List<Value> _shortNameKeys;
+	[ThreadStatic] private static List<String> _shortNameVals;
 
 	// Mark the Values this class owns.  Parameter defaults are created when an
 	// intrinsic is *defined*, which is long before the first VM exists; without
 	// this they are unreachable until EnsureBuilt copies them into a FuncDef and
 	// roots the funcref, and any collection in that window frees them out from
-	// under us.  Registered on first use (see EnsureMarkCallback).
+	// under us.  Registered on first use (see EnsureRegistry).
 	public static void MarkRoots(object user_data) {
 		for (Int32 i = 0; i < _all.Count; i++) {
 			List<Value> defaults = _all[i]._paramDefaults;
@@ -44,24 +63,29 @@ public class Intrinsic {
 		for (Int32 i = 0; i < _shortNameKeys.Count; i++) GCManager.Mark(_shortNameKeys[i]);
 	}
 
-	private static void EnsureMarkCallback() {
-		if (_markCallbackRegistered) return;
-		_markCallbackRegistered = true;
+	private static void EnsureRegistry() {
+		if (_all != null) return;
+		_all = new List<Intrinsic>();
+		_byName = new Dictionary<String, Intrinsic>();
+		_shortNameKeys = new List<Value>();
+		_shortNameVals = new List<String>();
 		GCManager.RegisterMarkCallback(MarkRoots, null); // CPP: GCManager::RegisterMarkCallback(Intrinsic::MarkRoots, nullptr);
 	}
 
 	public static void AddShortName(Value v, String name) {
-		EnsureMarkCallback();
+		EnsureRegistry();
 		_shortNameKeys.Add(v);
 		_shortNameVals.Add(name);
 	}
 
 	public static void ClearShortNames() {
+		if (_shortNameKeys == null) return;
 		_shortNameKeys.Clear();
 		_shortNameVals.Clear();
 	}
 
 	public static String GetShortName(Value v) {
+		if (_shortNameKeys == null) return null;
 		for (Int32 i = 0; i < _shortNameKeys.Count; i++) {
 			if (_shortNameKeys[i].RefEquals(v)) return _shortNameVals[i];
 		}
@@ -70,19 +94,26 @@ public class Intrinsic {
 
 	public Intrinsic() {}
 
+	private static void EnsureInitialized() {
+		if (_initialized) return;
+		_definingCore = true;
+		CoreIntrinsics.Init();
+		_definingCore = false;
+		_initialized = true;
+	}
+
 	// Return the number of intrinsics (initializing them if needed).
 	public static Int32 Count() {
-		if (!_initialized) {
-			CoreIntrinsics.Init();
-			_initialized = true;
-		}
+		EnsureInitialized();
 		return _all.Count;
 	}
 
 	public static Intrinsic Create(String name) {
-		EnsureMarkCallback();
+		EnsureRegistry();
 		Intrinsic result = new Intrinsic();
 		result.Name = name;
+		result.Index = _all.Count;
+		result.Core = _definingCore;
 		result._paramNames = new List<String>();
 		result._paramDefaults = new List<Value>();
 		_all.Add(result);
@@ -101,6 +132,7 @@ public class Intrinsic {
 	}
 
 	public static Intrinsic GetByName(String name) {
+		if (_byName == null) return null;
 		Intrinsic result;
 		if (_byName.TryGetValue(name, out result)) return result;
 		return null;
@@ -110,9 +142,20 @@ public class Intrinsic {
 		return _all[i];
 	}
 
+	// The index of the intrinsic with the given name, if a call to it may be
+	// compiled to CALLINTRINSIC, or else -1.  That takes a simple, built-in
+	// intrinsic: the VM calls it straight from its registry index, so the
+	// index must mean the same thing on every thread the code may run on.
+	public static Int32 DirectCallIndex(String name) {
+		EnsureInitialized();
+		Intrinsic intr = GetByName(name);
+		if (intr == null || !intr.Core || intr.SimpleCode == null) return -1;
+		return intr.Index;
+	}
+
 	// Build (once) this intrinsic's FuncDef and a stable funcref Value.
 	// The funcref is added as a permanent GC root: intrinsics live for the
-	// lifetime of the process and are shared across VMs and resets.
+	// lifetime of the thread and are shared across its VMs and resets.
 	private void EnsureBuilt() {
 		if (_funcDef == null) {
 			_funcDef = BuildFuncDef();
@@ -131,21 +174,30 @@ public class Intrinsic {
 		FuncDef def = new FuncDef();
 		def.Name = Name;
 		for (Int32 i = 0; i < _paramNames.Count; i++) {
-			def.ParamNames.Add(Value.make_string(_paramNames[i]));
+			def.ParamNames.Add(Value.make_interned_string(_paramNames[i]));
 			def.ParamDefaults.Add(_paramDefaults[i]);
 		}
 		def.MaxRegs = (UInt16)(_paramNames.Count + 1); // r0 + params
 		def.NativeCallback = Code;
+		if (SimpleCode != null) {
+			def.SimpleCallback = SimpleCode;
+			def.NativeCallback = SimpleMarker;
+		}
 		return def;
 	}
 
+	// The NativeCallback of a simple intrinsic's FuncDef.  It is never called
+	// (the VM calls the SimpleCallback instead), but a FuncDef with a
+	// NativeCallback is how the rest of the code knows a native function.
+	private static IntrinsicResult SimpleMarker(Context context, IntrinsicResult partialResult) {
+		return IntrinsicResult.Null;
+	}
+
 	// Populate the VM's intrinsics name->funcref table.  Intrinsic FuncDefs and
-	// their funcref Values are built once (lazily) and shared across all VMs.
+	// their funcref Values are built once (lazily) and shared across all VMs
+	// on this thread.
 	public static void RegisterAll(Dictionary<String, Value> intrinsics) {
-		if (!_initialized) {
-			CoreIntrinsics.Init();
-			_initialized = true;
-		}
+		EnsureInitialized();
 		intrinsics.Clear();
 		for (Int32 i = 0; i < _all.Count; i++) {
 			Intrinsic intr = _all[i];
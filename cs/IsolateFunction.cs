@@ -0,0 +1,100 @@
+// IsolateFunction.cs
+//
+// A script function packed to run in another isolate (see ParallelMap).
+// Code is never changed once built, so the copy shares it; the Values a
+// function holds -- constants, parameter names and defaults, global names
+// -- are on its own isolate's heap, so they travel as a ChannelMessage and
+// are made again on the other side.  Nested functions (the templates among
+// the constants) go along, the same way.  The function's outer variables
+// do not: the rebuilt function has none.
+
+using System;
+using System.Collections.Generic;
+// H: #include "Channel.g.h"
+// H: #include "FuncDef.g.h"
+// CPP: #include "GCManager.g.h"
+
+namespace MiniScript {
+
+// The FuncDef of a function and of each function nested in it, with the
+// Values each one holds packed in a message.
+public class IsolateFunction {
+	private List<FuncDef> _defs = new List<FuncDef>();	// the function, then those nested in it
+	private List<ChannelMessage> _values = new List<ChannelMessage>();	// per def: [constants, param names, param defaults, global names]
+
+	// Nested-function templates among the constants (sent as null): for
+	// each, the def whose constant it is, the constant's index, and the def
+	// it refers to.
+	private List<Int32> _templateOwner = new List<Int32>();
+	private List<Int32> _templateIndex = new List<Int32>();
+	private List<Int32> _templateDef = new List<Int32>();
+
+	public IsolateFunction() {
+	}
+
+	// The function `func` refers to, ready to send; or null if it is an
+	// intrinsic, or holds a constant that cannot be sent.
+	public static IsolateFunction Pack(Value func) {
+		IsolateFunction result = new IsolateFunction();
+		result._defs.Add(func.FunctionDef());
+		for (Int32 d = 0; d < result._defs.Count; d++) {	// (_defs grows as nested functions turn up)
+			FuncDef def = result._defs[d];
+			if (def.NativeCallback != null) return null;
+			def.EnsureConstants();
+			Value constants = Value.make_list(def.Constants.Count);
+			for (Int32 i = 0; i < def.Constants.Count; i++) {
+				Value c = def.Constants[i];
+				if (c.IsFuncRef()) {
+					result._templateOwner.Add(d);
+					result._templateIndex.Add(i);
+					result._templateDef.Add(result._defs.Count);
+					result._defs.Add(c.FunctionDef());
+					c = Value.Null;
+				}
+				constants.Push(c);
+			}
+			Value values = Value.make_list(4);
+			values.Push(constants);
+			values.Push(ListOf(def.ParamNames));
+			values.Push(ListOf(def.ParamDefaults));
+			values.Push(ListOf(def.GlobalNames));
+			ChannelMessage msg = ChannelMessage.Pack(values);
+			if (msg == null) return null;
+			result._values.Add(msg);
+		}
+		return result;
+	}
+
+	// The function, made on the calling thread's heap, as a funcref with no
+	// outer variables.  Safe to call from any number of threads at once.
+	public Value Unpack() {
+		List<FuncDef> copies = new List<FuncDef>();
+		for (Int32 d = 0; d < _defs.Count; d++) {
+			FuncDef copy = _defs[d].CopyForIsolate();
+			Value values = _values[d].Unpack();
+			Value list = values.ListGet(0);
+			for (Int32 i = 0; i < list.ListCount(); i++) copy.Constants.Add(list.ListGet(i));
+			list = values.ListGet(1);
+			for (Int32 i = 0; i < list.ListCount(); i++) copy.ParamNames.Add(list.ListGet(i));
+			list = values.ListGet(2);
+			for (Int32 i = 0; i < list.ListCount(); i++) copy.ParamDefaults.Add(list.ListGet(i));
+			list = values.ListGet(3);
+			for (Int32 i = 0; i < list.ListCount(); i++) copy.AddGlobalRef(list.ListGet(i));
+			copies.Add(copy);
+		}
+		for (Int32 t = 0; t < _templateOwner.Count; t++) {
+			Int32 owner = _templateOwner[t];
+			Int32 child = _templateDef[t];
+			copies[owner].Constants[_templateIndex[t]] = Value.make_funcref(copies[child], Value.Null);
+		}
+		return Value.make_funcref(copies[0], Value.Null);
+	}
+
+	private static Value ListOf(List<Value> items) {
+		Value result = Value.make_list(items.Count);
+		for (Int32 i = 0; i < items.Count; i++) result.Push(items[i]);
+		return result;
+	}
+}
+
+}
@@ -9,57 +9,147 @@ using static System.Runtime.CompilerServices.MethodImplOptions;
 // H: #include "ErrorTypes.g.h"
 // CPP: #include "StringUtils.g.h"
 // CPP: #include "IOHelper.g.h"
+// H: #include "lex_scan.h"
 
 namespace MiniScript {
 
-// Represents a single token from the lexer
+// Represents a single token from the lexer.  A token is a view of the source:
+// Start and Length locate it there, and Lexer.TextOf recovers its text.  Only
+// identifiers and string literals carry a Text, since theirs is the only text
+// the parser keeps; a number carries its DoubleValue, and every other token is
+// fully described by its Type.
 public struct Token {
 	public TokenType Type;
-	public String Text;
+	public String Text;         // identifier name or string contents; else null
 	public Double DoubleValue;
+	public Int32 Start;         // position in the lexer's source (see Lexer)
+	public Int32 Length;        // length there, in the same units
 	public Int32 Line;
 	public Int32 Column;
 	public Boolean AfterSpace;  // True if whitespace preceded this token
 
 	// H: public: Token() {}
-	public Token(TokenType type, String text, Int32 line, Int32 column) {
+	public Token(TokenType type, Int32 start, Int32 length, Int32 line, Int32 column) {
 		Type = type;
-		Text = text;
+		Text = null;
 		DoubleValue = 0;
+		Start = start;
+		Length = length;
 		Line = line;
 		Column = column;
 		AfterSpace = false;
 	}
 }
 
+// Positions in the source (_position, Token.Start) count UTF-16 code units in
+// C#, and bytes of the UTF-8 text in C++, so that reading a character or
+// slicing out a token takes constant time in both.  (Counting characters from
+// the start of the string made lexing quadratic in C++.)  The C++ side also
+// scans runs of identifier characters, digits, and blanks with the helpers in
+// core/lex_scan.h.
 public struct Lexer {
 	private String _input;
+	private Int32 _length;      // length of _input, in position units
+	// H: private: const char* _src = nullptr;  // _input's bytes
 	private Int32 _position;
 	private Int32 _line;
 	private Int32 _column;
 	public Value Error;
 	public String FileName;   // source file name, for error locations ("" if unnamed)
 
+	// Set when lexing off the VM thread (see ImportPrefetch).  An error is then
+	// only noted, not made into an error Value, since that would allocate from
+	// the GC heap, which belongs to the VM thread.
+	public Boolean Detached;
+	private Boolean _detachedError;
+
+	// Names seen so far, so that an identifier which recurs is returned as the
+	// same String rather than copied out of the source each time.  Keywords are
+	// entered up front, with their token types, so that recognizing a keyword
+	// needs no String at all.  Open addressing: _nameSlots (a power of two in
+	// size) holds indexes into the other three lists, or -1 if empty.
+	private List<Int32> _nameSlots;
+	private List<String> _names;
+	private List<UInt32> _nameHashes;
+	private List<TokenType> _nameTypes;
+
 	// H: public: Lexer() {}
 	public Lexer(String source) {
+		// (C# wants every field set before a method may be called.)
+		_input = null;
+		_length = 0;
+		_position = 0;
+		_line = 0;
+		_column = 0;
+		Error = Value.Null;
+		FileName = "";
+		Detached = false;
+		_detachedError = false;
+		_nameSlots = null;
+		_names = null;
+		_nameHashes = null;
+		_nameTypes = null;
+		Reset(source);
+	}
+
+	// Start over on new source.  The name table is kept: the keywords, and
+	// any names already seen, serve the next source as well as the last, so a
+	// Parser fed one REPL line after another builds the table only once.
+	public void Reset(String source) {
 		_input = source.Replace("\r\n", "\n").Replace("\r", "\n");
+		_length = _input.Length; // CPP: _length = _input.LengthB(); _src = _input.c_str();
 		_position = 0;
 		_line = 1;
 		_column = 1;
 		Error = Value.Null;
 		FileName = "";
+		_detachedError = false;
+		if (_nameSlots != null) return;
+		_nameSlots = new List<Int32>();
+		_names = new List<String>();
+		_nameHashes = new List<UInt32>();
+		_nameTypes = new List<TokenType>();
+		for (Int32 i = 0; i < 64; i++) _nameSlots.Add(-1);
+		AddKeyword("and", TokenType.AND);
+		AddKeyword("or", TokenType.OR);
+		AddKeyword("not", TokenType.NOT);
+		AddKeyword("while", TokenType.WHILE);
+		AddKeyword("for", TokenType.FOR);
+		AddKeyword("in", TokenType.IN);
+		AddKeyword("if", TokenType.IF);
+		AddKeyword("then", TokenType.THEN);
+		AddKeyword("else", TokenType.ELSE);
+		AddKeyword("break", TokenType.BREAK);
+		AddKeyword("continue", TokenType.CONTINUE);
+		AddKeyword("function", TokenType.FUNCTION);
+		AddKeyword("return", TokenType.RETURN);
+		AddKeyword("new", TokenType.NEW);
+		AddKeyword("isa", TokenType.ISA);
+		AddKeyword("self", TokenType.SELF);
+		AddKeyword("super", TokenType.SUPER);
+		AddKeyword("locals", TokenType.LOCALS);
+		AddKeyword("outer", TokenType.OUTER);
+		AddKeyword("globals", TokenType.GLOBALS);
+		AddKeyword("end", TokenType.END);
+	}
+
+	// Return the character at the given position, or '\0' past the end.
+	[MethodImpl(AggressiveInlining)]
+	private Char CharAt(Int32 pos) {
+		if (pos >= _length) return '\0';
+		return _input[pos]; // CPP: return LexCharAt(_src, pos, _length);
 	}
 
 	// Peek at current character without advancing
+	[MethodImpl(AggressiveInlining)]
 	private Char Peek() {
-		if (_position >= _input.Length) return '\0';
-		return _input[_position];
+		return CharAt(_position);
 	}
 
 	// Advance to next character
 	private Char Advance() {
 		Char c = Peek();
-		_position++;
+		_position++; // CPP: _position += (_position < _length ? LexCharSize(_src, _position, _length) : 1);
 		if (c == '\n') {
 			_line++;
 			_column = 1;
@@ -69,16 +159,154 @@ public struct Lexer {
 		return c;
 	}
 
+	// Skip ahead to the given position, over characters known to be ASCII and
+	// not newlines, so that each is one position and one column.
+	[MethodImpl(AggressiveInlining)]
+	private void SkipTo(Int32 pos) {
+		_column += pos - _position;
+		_position = pos;
+	}
+
+	// Return the source text from start up to (not including) end.
+	private String Slice(Int32 start, Int32 end) {
+		if (end <= start) return "";
+		return _input.Substring(start, end - start); // CPP: return String(_src + start, (size_t)(end - start));
+	}
+
+	// Return the source text of the given token: what it was lexed from, which
+	// for a string literal includes the quotes.
+	public String TextOf(Token tok) {
+		return Slice(tok.Start, tok.Start + tok.Length);
+	}
+
+	// ── Runs of ASCII characters ─────────────────────────────────────────────
+	// Each returns the end of the run starting at pos.  A character outside the
+	// class (including any non-ASCII one) ends the run.
+
+	private Int32 ScanIdentifierRun(Int32 pos) {
+		//*** BEGIN CS_ONLY ***
+		while (pos < _length) {
+			Char c = _input[pos];
+			if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || IsDigit(c))) break;
+			pos++;
+		}
+		return pos;
+		//*** END CS_ONLY ***
+		// CPP: return LexScanIdentifier(_src, pos, _length);
+	}
+
+	private Int32 ScanDigitRun(Int32 pos) {
+		//*** BEGIN CS_ONLY ***
+		while (pos < _length && IsDigit(_input[pos])) pos++;
+		return pos;
+		//*** END CS_ONLY ***
+		// CPP: return LexScanDigits(_src, pos, _length);
+	}
+
+	private Int32 ScanBlankRun(Int32 pos) {
+		//*** BEGIN CS_ONLY ***
+		while (pos < _length && (_input[pos] == ' ' || _input[pos] == '\t')) pos++;
+		return pos;
+		//*** END CS_ONLY ***
+		// CPP: return LexScanBlanks(_src, pos, _length);
+	}
+
+	// Return the position of the next newline at or after pos, or the end of
+	// the source if there is none.
+	private Int32 FindLineEnd(Int32 pos) {
+		Int32 found = _input.IndexOf('\n', pos); // CPP: Int32 found = LexFindByte(_src, pos, _length, '\n');
+		if (found < 0) return _length;
+		return found;
+	}
+
+	// ── Name table ───────────────────────────────────────────────────────────
+
+	// FNV-1a over the source from start up to (not including) end.
+	private UInt32 HashRange(Int32 start, Int32 end) {
+		UInt32 h = 2166136261u;
+		for (Int32 i = start; i < end; i++) {
+			h = unchecked((h ^ (UInt32)_input[i]) * 16777619u); // CPP: h = (h ^ (UInt32)(unsigned char)_src[i]) * 16777619u;
+		}
+		return h;
+	}
+
+	// The same hash over a String, in the same units as HashRange.
+	private static UInt32 HashText(String s) {
+		UInt32 h = 2166136261u;
+		//*** BEGIN CS_ONLY ***
+		for (Int32 i = 0; i < s.Length; i++) {
+			h = unchecked((h ^ (UInt32)s[i]) * 16777619u);
+		}
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		const char* p = s.c_str();
+		Int32 len = s.LengthB();
+		for (Int32 i = 0; i < len; i++) h = (h ^ (UInt32)(unsigned char)p[i]) * 16777619u;
+		*** END CPP_ONLY ***/
+		return h;
+	}
+
+	// Return whether entry idx of the name table has the text [start, end).
+	private Boolean NameMatches(Int32 idx, Int32 start, Int32 end) {
+		//*** BEGIN CS_ONLY ***
+		String name = _names[idx];
+		return name.Length == end - start && String.CompareOrdinal(name, 0, _input, start, end - start) == 0;
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		const String& name = _names[idx];
+		return name.LengthB() == end - start && memcmp(name.c_str(), _src + start, end - start) == 0;
+		*** END CPP_ONLY ***/
+	}
+
+	// Return the name-table slot for the given hash and source range: the slot
+	// holding that name, or the empty slot where it belongs.
+	private Int32 FindNameSlot(UInt32 hash, Int32 start, Int32 end) {
+		Int32 mask = _nameSlots.Count - 1;
+		Int32 slot = (Int32)(hash & (UInt32)mask);
+		while (_nameSlots[slot] >= 0) {
+			Int32 idx = _nameSlots[slot];
+			if (_nameHashes[idx] == hash && NameMatches(idx, start, end)) break;
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	// Add a name to the table at the given (empty) slot, growing the table
+	// when it gets half full.
+	private void AddName(Int32 slot, String name, UInt32 hash, TokenType type) {
+		_nameSlots[slot] = _names.Count;
+		_names.Add(name);
+		_nameHashes.Add(hash);
+		_nameTypes.Add(type);
+		if (_names.Count * 2 <= _nameSlots.Count) return;
+		Int32 size = _nameSlots.Count * 2;
+		_nameSlots.Clear();
+		for (Int32 i = 0; i < size; i++) _nameSlots.Add(-1);
+		for (Int32 i = 0; i < _names.Count; i++) {
+			Int32 s = (Int32)(_nameHashes[i] & (UInt32)(size - 1));
+			while (_nameSlots[s] >= 0) s = (s + 1) & (size - 1);
+			_nameSlots[s] = i;
+		}
+	}
+
+	private void AddKeyword(String word, TokenType type) {
+		UInt32 hash = HashText(word);
+		Int32 mask = _nameSlots.Count - 1;
+		Int32 slot = (Int32)(hash & (UInt32)mask);
+		while (_nameSlots[slot] >= 0) slot = (slot + 1) & mask;
+		AddName(slot, word, hash, type);
+	}
+
 	[MethodImpl(AggressiveInlining)]
 	public static Boolean IsDigit(Char c) {
 		return '0' <= c && c <= '9';
 	}
-	
+
 	[MethodImpl(AggressiveInlining)]
 	public static Boolean IsWhiteSpace(Char c) {
 		return Char.IsWhiteSpace(c); // CPP: return UnicodeCharIsWhitespace((long)c);
 	}
-		
+
 	[MethodImpl(AggressiveInlining)]
 	public static Boolean IsIdentifierStartChar(Char c) {
 		return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'
@@ -94,125 +322,93 @@ public struct Lexer {
 	// Returns true if any whitespace was skipped
 	[MethodImpl(AggressiveInlining)]
 	private Boolean SkipWhitespace() {
-		Boolean skipped = false;
-		while (_position < _input.Length) {
-			Char ch = _input[_position];
-			if (ch == '\n') break;  // newlines are significant
-			if (!IsWhiteSpace(ch)) break;
+		Int32 start = _position;
+		while (true) {
+			SkipTo(ScanBlankRun(_position));
+			Char ch = Peek();
+			if (ch == '\n' || !IsWhiteSpace(ch)) break;  // newlines are significant
 			Advance();
-			skipped = true;
 		}
-		return skipped;
+		return _position > start;
 	}
 
 	// Get the next token from _input
 	public Token NextToken() {
 		Boolean hadWhitespace = SkipWhitespace();
 
+		Int32 startPos = _position;
 		Int32 startLine = _line;
 		Int32 startColumn = _column;
+		Token tok;
 
 		// End of _input
-		if (_position >= _input.Length) {
-			Token eofTok = new Token(TokenType.END_OF_INPUT, "", startLine, startColumn);
-			eofTok.AfterSpace = hadWhitespace;
-			return eofTok;
+		if (_position >= _length) {
+			tok = new Token(TokenType.END_OF_INPUT, startPos, 0, startLine, startColumn);
+			tok.AfterSpace = hadWhitespace;
+			return tok;
 		}
 
 		Char c = Peek();
 
 		// Numbers
 		if (IsDigit(c)) {
-			Int32 start = _position;
-			while (_position < _input.Length && IsDigit(_input[_position])) {
-				Advance();
-			}
+			SkipTo(ScanDigitRun(_position));
+			Boolean isInteger = true;
 			// Check for decimal point
-			if (Peek() == '.' && _position + 1 < _input.Length && IsDigit(_input[_position + 1])) {
+			if (Peek() == '.' && IsDigit(CharAt(_position + 1))) {
+				isInteger = false;
 				Advance(); // consume '.'
-				while (_position < _input.Length && IsDigit(_input[_position])) {
-					Advance();
-				}
+				SkipTo(ScanDigitRun(_position));
 			}
 			// Check for exponent (e.g. 1E-12, 2.5e6)
-			if (_position < _input.Length && (_input[_position] == 'E' || _input[_position] == 'e')) {
+			if (Peek() == 'E' || Peek() == 'e') {
 				Int32 savedPos = _position;
+				Int32 savedColumn = _column;
 				Advance(); // consume 'E'/'e'
-				if (_position < _input.Length && (_input[_position] == '+' || _input[_position] == '-')) {
+				if (Peek() == '+' || Peek() == '-') {
 					Advance(); // consume sign
 				}
-				if (_position < _input.Length && IsDigit(_input[_position])) {
-					while (_position < _input.Length && IsDigit(_input[_position])) {
-						Advance();
-					}
+				if (IsDigit(Peek())) {
+					isInteger = false;
+					SkipTo(ScanDigitRun(_position));
 				} else {
 					_position = savedPos; // not a valid exponent; backtrack
+					_column = savedColumn;
 				}
 			}
-			String numStr = _input.Substring(start, _position - start);
-			Token tok = new Token(TokenType.NUMBER, numStr, startLine, startColumn);
+			tok = new Token(TokenType.NUMBER, startPos, _position - startPos, startLine, startColumn);
 			tok.AfterSpace = hadWhitespace;
-			// Always derive the value as a double; this stores our best
-			// approximation for magnitudes too large to represent exactly,
-			// just as we do for fractional literals like 2.5.
-			tok.DoubleValue = StringUtils.ParseDouble(numStr);
+			if (isInteger && _position - startPos <= 15) {
+				// Up to 15 digits is exact in a double, so add it up directly.
+				Double value = 0;
+				for (Int32 i = startPos; i < _position; i++) value = value * 10 + (CharAt(i) - '0');
+				tok.DoubleValue = value;
+			} else {
+				// Always derive the value as a double; this stores our best
+				// approximation for magnitudes too large to represent exactly,
+				// just as we do for fractional literals like 2.5.
+				tok.DoubleValue = StringUtils.ParseDouble(Slice(startPos, _position));
+			}
 			return tok;
 		}
 
 		// Identifiers and keywords
 		if (IsIdentifierStartChar(c)) {
-			Int32 start = _position;
-			while (_position < _input.Length && IsIdentifierChar(_input[_position])) {
+			while (true) {
+				SkipTo(ScanIdentifierRun(_position));
+				Char ch = Peek();
+				if ((int)ch < 128 || !IsIdentifierChar(ch)) break;
 				Advance();
 			}
-			String text = _input.Substring(start, _position - start);
-			Token tok;
-			// Check for keywords
-			if (text == "and") {
-				tok = new Token(TokenType.AND, text, startLine, startColumn);
-			} else if (text == "or") {
-				tok = new Token(TokenType.OR, text, startLine, startColumn);
-			} else if (text == "not") {
-				tok = new Token(TokenType.NOT, text, startLine, startColumn);
-			} else if (text == "while") {
-				tok = new Token(TokenType.WHILE, text, startLine, startColumn);
-			} else if (text == "for") {
-				tok = new Token(TokenType.FOR, text, startLine, startColumn);
-			} else if (text == "in") {
-				tok = new Token(TokenType.IN, text, startLine, startColumn);
-			} else if (text == "if") {
-				tok = new Token(TokenType.IF, text, startLine, startColumn);
-			} else if (text == "then") {
-				tok = new Token(TokenType.THEN, text, startLine, startColumn);
-			} else if (text == "else") {
-				tok = new Token(TokenType.ELSE, text, startLine, startColumn);
-			} else if (text == "break") {
-				tok = new Token(TokenType.BREAK, text, startLine, startColumn);
-			} else if (text == "continue") {
-				tok = new Token(TokenType.CONTINUE, text, startLine, startColumn);
-			} else if (text == "function") {
-				tok = new Token(TokenType.FUNCTION, text, startLine, startColumn);
-			} else if (text == "return") {
-				tok = new Token(TokenType.RETURN, text, startLine, startColumn);
-			} else if (text == "new") {
-				tok = new Token(TokenType.NEW, text, startLine, startColumn);
-			} else if (text == "isa") {
-				tok = new Token(TokenType.ISA, text, startLine, startColumn);
-			} else if (text == "self") {
-				tok = new Token(TokenType.SELF, text, startLine, startColumn);
-			} else if (text == "super") {
-				tok = new Token(TokenType.SUPER, text, startLine, startColumn);
-			} else if (text == "locals") {
-				tok = new Token(TokenType.LOCALS, text, startLine, startColumn);
-			} else if (text == "outer") {
-				tok = new Token(TokenType.OUTER, text, startLine, startColumn);
-			} else if (text == "globals") {
-				tok = new Token(TokenType.GLOBALS, text, startLine, startColumn);
-			} else if (text == "end") {
-				tok = new Token(TokenType.END, text, startLine, startColumn);
-			} else {
-				tok = new Token(TokenType.IDENTIFIER, text, startLine, startColumn);
+			UInt32 hash = HashRange(startPos, _position);
+			Int32 slot = FindNameSlot(hash, startPos, _position);
+			Int32 idx = _nameSlots[slot];
+			if (idx < 0) {
+				AddName(slot, Slice(startPos, _position), hash, TokenType.IDENTIFIER);
+				idx = _names.Count - 1;
 			}
+			tok = new Token(_nameTypes[idx], startPos, _position - startPos, startLine, startColumn);
+			if (tok.Type == TokenType.IDENTIFIER) tok.Text = _names[idx];
 			tok.AfterSpace = hadWhitespace;
 			return tok;
 		}
@@ -222,12 +418,13 @@ public struct Lexer {
 			Advance(); // consume opening quote
 			Int32 start = _position;
 			List<String> parts = null;
-			while (_position < _input.Length) {
-				if (_input[_position] == '"') {
+			while (_position < _length) {
+				Char ch = Peek();
+				if (ch == '"') {
 					// Check for doubled quote (escaped literal quote)
-					if (_position + 1 < _input.Length && _input[_position + 1] == '"') {
+					if (CharAt(_position + 1) == '"') {
 						if (parts == null) parts = new List<String>();
-						parts.Add(_input.Substring(start, _position - start));
+						parts.Add(Slice(start, _position));
 						parts.Add("\"");
 						Advance(); Advance(); // skip both quotes
 						start = _position;
@@ -239,129 +436,106 @@ public struct Lexer {
 			}
 			String text;
 			if (parts == null) {
-				text = _input.Substring(start, _position - start);
+				text = Slice(start, _position);
 			} else {
-				parts.Add(_input.Substring(start, _position - start));
+				parts.Add(Slice(start, _position));
 				text = String.Join("", parts);
 			}
 			if (Peek() == '"') Advance(); // consume closing quote
-			Token tok = new Token(TokenType.STRING, text, startLine, startColumn);
+			tok = new Token(TokenType.STRING, startPos, _position - startPos, startLine, startColumn);
+			tok.Text = text;
 			tok.AfterSpace = hadWhitespace;
 			return tok;
 		}
 
-		// Multi-character operators (check before consuming)
-		Token multiTok;
-		if (c == '=' && _position + 1 < _input.Length && _input[_position + 1] == '=') {
-			Advance(); Advance();
-			multiTok = new Token(TokenType.EQUALS, "==", startLine, startColumn);
-			multiTok.AfterSpace = hadWhitespace;
-			return multiTok;
-		}
-		if (c == '!' && _position + 1 < _input.Length && _input[_position + 1] == '=') {
-			Advance(); Advance();
-			multiTok = new Token(TokenType.NOT_EQUAL, "!=", startLine, startColumn);
-			multiTok.AfterSpace = hadWhitespace;
-			return multiTok;
-		}
-		if (c == '<' && _position + 1 < _input.Length && _input[_position + 1] == '=') {
-			Advance(); Advance();
-			multiTok = new Token(TokenType.LESS_EQUAL, "<=", startLine, startColumn);
-			multiTok.AfterSpace = hadWhitespace;
-			return multiTok;
-		}
-		if (c == '>' && _position + 1 < _input.Length && _input[_position + 1] == '=') {
-			Advance(); Advance();
-			multiTok = new Token(TokenType.GREATER_EQUAL, ">=", startLine, startColumn);
-			multiTok.AfterSpace = hadWhitespace;
-			return multiTok;
+		// Comments: // to end of line (must check before /= which is handled below).
+		// The newline itself is not part of the comment.
+		Char next = CharAt(_position + 1);
+		if (c == '/' && next == '/') {
+			Int32 end = FindLineEnd(_position);
+			_column += end - _position;
+			_position = end;
+			tok = new Token(TokenType.COMMENT, startPos, end - startPos, startLine, startColumn);
+			tok.AfterSpace = hadWhitespace;
+			return tok;
 		}
 
-		// Compound assignment operators: +=, -=, *=, /=, %=, ^=
-		if (_position + 1 < _input.Length && _input[_position + 1] == '=') {
-			TokenType compoundType = TokenType.ERROR;
-			String compoundText = "";
-			if (c == '+') { compoundType = TokenType.PLUS_ASSIGN; compoundText = "+="; }
-			else if (c == '-') { compoundType = TokenType.MINUS_ASSIGN; compoundText = "-="; }
-			else if (c == '*') { compoundType = TokenType.TIMES_ASSIGN; compoundText = "*="; }
-			else if (c == '/') { compoundType = TokenType.DIVIDE_ASSIGN; compoundText = "/="; }
-			else if (c == '%') { compoundType = TokenType.MOD_ASSIGN; compoundText = "%="; }
-			else if (c == '^') { compoundType = TokenType.POWER_ASSIGN; compoundText = "^="; }
-			if (compoundType != TokenType.ERROR) {
-				Advance(); Advance();
-				multiTok = new Token(compoundType, compoundText, startLine, startColumn);
-				multiTok.AfterSpace = hadWhitespace;
-				return multiTok;
-			}
+		// Operators and punctuation.  Work out the type first; then consume it.
+		TokenType type = TokenType.ERROR;
+		Int32 size = 1;
+		if (next == '=') {
+			// Two-character operators ending in '=', including the compound
+			// assignments +=, -=, *=, /=, %=, ^=
+			size = 2;
+			if (c == '=') type = TokenType.EQUALS;
+			else if (c == '!') type = TokenType.NOT_EQUAL;
+			else if (c == '<') type = TokenType.LESS_EQUAL;
+			else if (c == '>') type = TokenType.GREATER_EQUAL;
+			else if (c == '+') type = TokenType.PLUS_ASSIGN;
+			else if (c == '-') type = TokenType.MINUS_ASSIGN;
+			else if (c == '*') type = TokenType.TIMES_ASSIGN;
+			else if (c == '/') type = TokenType.DIVIDE_ASSIGN;
+			else if (c == '%') type = TokenType.MOD_ASSIGN;
+			else if (c == '^') type = TokenType.POWER_ASSIGN;
+			else size = 1;
 		}
-
-		// Comments: // to end of line (must check before /= which is handled below)
-		if (c == '/' && _position + 1 < _input.Length && _input[_position + 1] == '/') {
-			Int32 start = _position;
-			// Consume until end of line (but not the newline itself)
-			while (_position < _input.Length && _input[_position] != '\n') {
-				Advance();
+		if (size == 1) {
+			switch (c) {
+				case '+': type = TokenType.PLUS; break;
+				case '-':
+					// A '-' that is preceded by whitespace but *not* followed by
+					// whitespace binds tightly to what follows, and so can only be
+					// negation, never subtraction: "f -5" is a call, while "f - 5",
+					// "f- 5" and "f-5" all subtract.  The lexer settles that here,
+					// by returning a distinct token type, so that the grammar need
+					// not know where a statement began.
+					// See notes/UNARY_MINUS_QUIRK.md.
+					if (hadWhitespace && _position + 1 < _length && !IsWhiteSpace(next)) {
+						type = TokenType.STRONG_NEGATE;
+					} else {
+						type = TokenType.MINUS;
+					}
+					break;
+				case '*': type = TokenType.TIMES; break;
+				case '/': type = TokenType.DIVIDE; break;
+				case '%': type = TokenType.MOD; break;
+				case '^': type = TokenType.CARET; break;
+				case '(': type = TokenType.LPAREN; break;
+				case ')': type = TokenType.RPAREN; break;
+				case '[': type = TokenType.LBRACKET; break;
+				case ']': type = TokenType.RBRACKET; break;
+				case '{': type = TokenType.LBRACE; break;
+				case '}': type = TokenType.RBRACE; break;
+				case '=': type = TokenType.ASSIGN; break;
+				case '<': type = TokenType.LESS_THAN; break;
+				case '>': type = TokenType.GREATER_THAN; break;
+				case ',': type = TokenType.COMMA; break;
+				case ':': type = TokenType.COLON; break;
+				case '.': type = TokenType.DOT; break;
+				case '@': type = TokenType.ADDRESS_OF; break;
+				case ';': type = TokenType.EOL; break;
+				case '\n': type = TokenType.EOL; break;
+				default: type = TokenType.ERROR; break;
 			}
-			String text = _input.Substring(start, _position - start);
-			Token commentTok = new Token(TokenType.COMMENT, text, startLine, startColumn);
-			commentTok.AfterSpace = hadWhitespace;
-			return commentTok;
 		}
-
-		// A '-' that is preceded by whitespace but *not* followed by whitespace
-		// binds tightly to what follows, and so can only be negation, never
-		// subtraction: "f -5" is a call, while "f - 5", "f- 5" and "f-5" all
-		// subtract.  The lexer settles that here, by returning a distinct token
-		// type, so that the grammar need not know where a statement began.
-		// See notes/UNARY_MINUS_QUIRK.md.
-		Boolean strongNegate = (c == '-' && hadWhitespace
-			&& _position + 1 < _input.Length && !IsWhiteSpace(_input[_position + 1]));
-
-		// Single-character operators and punctuation
 		Advance();
-		Token singleTok;
-		switch (c) {
-			case '+': singleTok = new Token(TokenType.PLUS, "+", startLine, startColumn); break;
-			case '-':
-				if (strongNegate) {
-					singleTok = new Token(TokenType.STRONG_NEGATE, "-", startLine, startColumn);
-				} else {
-					singleTok = new Token(TokenType.MINUS, "-", startLine, startColumn);
-				}
-				break;
-			case '*': singleTok = new Token(TokenType.TIMES, "*", startLine, startColumn); break;
-			case '/': singleTok = new Token(TokenType.DIVIDE, "/", startLine, startColumn); break;
-			case '%': singleTok = new Token(TokenType.MOD, "%", startLine, startColumn); break;
-			case '^': singleTok = new Token(TokenType.CARET, "^", startLine, startColumn); break;
-			case '(': singleTok = new Token(TokenType.LPAREN, "(", startLine, startColumn); break;
-			case ')': singleTok = new Token(TokenType.RPAREN, ")", startLine, startColumn); break;
-			case '[': singleTok = new Token(TokenType.LBRACKET, "[", startLine, startColumn); break;
-			case ']': singleTok = new Token(TokenType.RBRACKET, "]", startLine, startColumn); break;
-			case '{': singleTok = new Token(TokenType.LBRACE, "{", startLine, startColumn); break;
-			case '}': singleTok = new Token(TokenType.RBRACE, "}", startLine, startColumn); break;
-			case '=': singleTok = new Token(TokenType.ASSIGN, "=", startLine, startColumn); break;
-			case '<': singleTok = new Token(TokenType.LESS_THAN, "<", startLine, startColumn); break;
-			case '>': singleTok = new Token(TokenType.GREATER_THAN, ">", startLine, startColumn); break;
-			case ',': singleTok = new Token(TokenType.COMMA, ",", startLine, startColumn); break;
-			case ':': singleTok = new Token(TokenType.COLON, ":", startLine, startColumn); break;
-			case '.': singleTok = new Token(TokenType.DOT, ".", startLine, startColumn); break;
-			case '@': singleTok = new Token(TokenType.ADDRESS_OF, "@", startLine, startColumn); break;
-			case ';': singleTok = new Token(TokenType.EOL, ";", startLine, startColumn); break;
-			case '\n': singleTok = new Token(TokenType.EOL, "\n", startLine, startColumn); break;
-			default:
-				singleTok = new Token(TokenType.ERROR, StringUtils.Str(c), startLine, startColumn); break;
-		}
-		singleTok.AfterSpace = hadWhitespace;
-		return singleTok;
+		if (size == 2) Advance();
+		tok = new Token(type, startPos, _position - startPos, startLine, startColumn);
+		tok.AfterSpace = hadWhitespace;
+		return tok;
 	}
 
 	// Record a compiler error.  Only the first error is kept.
 	public void ReportError(String message) {
+		if (Detached) {
+			_detachedError = true;
+			return;
+		}
 		if (Error.IsNull()) Error = ErrorTypes.CompilerError(message, FileName, _line);
 	}
 
 	public Boolean HadError() {
-		return !Error.IsNull();
+		return _detachedError || !Error.IsNull();
 	}
 }
 
@@ -10,11 +10,13 @@ namespace MiniScript {
 
 public static class PRNG {
 
-	private static UInt64 _s0 = 0;
-	private static UInt64 _s1 = 0;
-	private static UInt64 _s2 = 0;
-	private static UInt64 _s3 = 0;
-	private static Boolean _seeded = false;
+	// Generator state, per thread: each isolate (see GCManager) has its own
+	// sequence, and seeding one does not disturb another.
+	[ThreadStatic] private static UInt64 _s0;
+	[ThreadStatic] private static UInt64 _s1;
+	[ThreadStatic] private static UInt64 _s2;
+	[ThreadStatic] private static UInt64 _s3;
+	[ThreadStatic] private static Boolean _seeded;
 
 	// Seed from a single 64-bit value, expanded to the full 256-bit
 	// state with splitmix64 as recommended by the xoshiro authors.
@@ -0,0 +1,468 @@
+// ParallelMap.cs
+//
+// The parallelMap and parallelFilter intrinsics: call a function on each
+// item of a list, spreading the calls over a pool of worker threads.  Each
+// worker is an isolate (see GCManager) with an interpreter of its own, kept
+// for the life of the process.  The list is cut into chunks; the calling
+// thread packs each chunk as a ChannelMessage and posts it for the workers,
+// then runs whatever chunks no worker has taken yet itself (with
+// VM.RunFunction, on the original items).  Each worker unpacks the chunks it
+// takes onto its own heap, calls the function on each item, and packs the
+// results; the caller unpacks those into place, so the results come back in
+// the order of the list, whichever thread made them.
+//
+// A function's code is shared with the workers as it is: nothing changes
+// code once it is built.  But its constants, parameter defaults and global
+// names are Values on the caller's heap, and its global-reference cache is
+// written as it runs, so a worker runs a copy of the FuncDef (and of each
+// function nested in it) made by FuncDef.CopyForIsolate and filled from a
+// message (see IsolateFunction.cs).  What the function cannot take with it is
+// its context: on a worker it runs with no outer variables and with the
+// worker's own (empty) globals, so it must work from its argument alone.
+// The calling thread runs its chunks in the caller's context as usual, so
+// that every chunk sees the same names, a function that reads anything from
+// that context is refused at the call, whoever would have run its chunks
+// (see OutsideName).
+//
+// Where a worker cannot help, the work is simply done on the calling
+// thread: with no workers, a list of one chunk, a function whose constants
+// cannot be sent, or a chunk holding an item that cannot be sent (a
+// function, say).  A call made on a worker also runs there, serially.
+//
+// The number of workers is ThreadCount.  Hosts may set it; if they do not, it
+// is read once from the MS_PARALLEL_THREADS environment variable, and
+// otherwise is one less than the number of hardware threads.  The workers are
+// started by the first call that can use them, so a script that never calls
+// parallelMap never pays for a second thread (see ImportPrefetch).
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+using System;
+using System.Collections.Generic;
+// H: #include "IsolateFunction.g.h"
+// H: #include "IntrinsicAPI.g.h"
+// CPP: #include "Bytecode.g.h"
+// CPP: #include "GCManager.g.h"
+// CPP: #include "ErrorTypes.g.h"
+// CPP: #include "Interpreter.g.h"
+// CPP: #include "Intrinsic.g.h"
+// CPP: #include "StringUtils.g.h"
+// CPP: #include "VM.g.h"
+// CPP: #include <cstdlib>
+/*** BEGIN CPP_ONLY ***
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+*** END CPP_ONLY ***/
+
+namespace MiniScript {
+
+// One parallelMap or parallelFilter call in progress.  Shared with the
+// workers, and guarded by ParallelMap's lock.
+public class ParallelJob {
+	public Int32 Id = 0;
+	public IsolateFunction Function = null;	// set before the job is posted; never changed
+	public Boolean Filter = false;	// results are only wanted as true or false
+	public List<ChannelMessage> Chunks = new List<ChannelMessage>();	// each chunk's items; null if only the caller can run it
+	public List<Boolean> Claimed = new List<Boolean>();
+	public List<ChannelMessage> Results = new List<ChannelMessage>();	// a worker's results for each chunk
+	public Int32 Running = 0;	// chunks claimed by a worker and not yet finished
+	public String WorkerError = "";	// the first error on a worker, described
+	public Boolean Cancelled = false;	// the caller hit an error, and wants no more
+
+	public ParallelJob() {
+	}
+}
+
+public static class ParallelMap {
+	// Worker threads to use; -1 until resolved (see GetThreadCount).
+	public static Int32 ThreadCount = -1;
+
+	// What a worker's interpreter is compiled from.  It is never run; the
+	// worker only calls functions on its VM.
+	private const String kWorkerSource = "null";
+
+	// The jobs posted and not yet ended, and the workers.  Guarded by the lock.
+	private static List<ParallelJob> _jobs = new List<ParallelJob>();
+	private static Int32 _lastJobId = 0;
+	private static Boolean _stopping = false;
+	private static Int32 _threadsRunning = 0;
+
+	[ThreadStatic] private static Boolean _isWorker;	// this thread is one of the workers
+
+	//*** BEGIN CS_ONLY ***
+	private static readonly Object _lock = new Object();
+	private static List<System.Threading.Thread> _threads = new List<System.Threading.Thread>();
+	//*** END CS_ONLY ***
+	/*** BEGIN CPP_ONLY ***
+	static std::mutex _mutex;
+	static std::condition_variable_any _changed;
+	// Made on first use, so that it is destroyed (joining the workers) before
+	// the job list above, which the workers may still be using.
+	struct WorkerThreads {
+		std::vector<std::thread> threads;
+		~WorkerThreads() { ParallelMap::Stop(); }
+	};
+	static WorkerThreads& Threads() {
+		static WorkerThreads threads;
+		return threads;
+	}
+	*** END CPP_ONLY ***/
+
+	public static Int32 GetThreadCount() {
+		if (ThreadCount < 0) {
+			//*** BEGIN CS_ONLY ***
+			ThreadCount = Environment.ProcessorCount - 1;
+			String env = Environment.GetEnvironmentVariable("MS_PARALLEL_THREADS");
+			Int32 n;
+			if (env != null && Int32.TryParse(env, out n)) ThreadCount = n;
+			//*** END CS_ONLY ***
+			/*** BEGIN CPP_ONLY ***
+			ThreadCount = (Int32)std::thread::hardware_concurrency() - 1;
+			const char* env = getenv("MS_PARALLEL_THREADS");
+			if (env) ThreadCount = atoi(env);
+			*** END CPP_ONLY ***/
+			if (ThreadCount < 0) ThreadCount = 0;
+		}
+		return ThreadCount;
+	}
+
+	// The first name that func, or a function nested in it, reads from
+	// outside itself, or null if there is none.  On the calling thread such a
+	// name would be found in the caller's context, and on a worker it would
+	// not, so the result would depend on which thread ran each chunk.  Outside
+	// means `globals`, `outer`, a global the caller has bound (which may shadow
+	// an intrinsic), or any other name that is not an intrinsic -- except that
+	// a nested function may read the variables of the functions it is nested
+	// in, which go along with it.
+	public static String OutsideName(Value func, Globals globals) {
+		List<FuncDef> defs = new List<FuncDef>();
+		List<Int32> parents = new List<Int32>();	// per def, the index of the def it is nested in, or -1
+		defs.Add(func.FunctionDef());
+		parents.Add(-1);
+		for (Int32 d = 0; d < defs.Count; d++) {	// (defs grows as nested functions turn up)
+			FuncDef def = defs[d];
+			def.EnsureConstants();
+			for (Int32 i = 0; i < def.Constants.Count; i++) {
+				Value c = def.Constants[i];
+				if (!c.IsFuncRef()) continue;
+				defs.Add(c.FunctionDef());
+				parents.Add(d);
+			}
+			Int32 codeCount = def.CodeCount();
+			for (Int32 pc = 0; pc < codeCount; pc++) {
+				UInt32 instr = def.CodeAt(pc);
+				Opcode op = (Opcode)BytecodeUtil.OP(instr);
+				if (op == Opcode.OUTER_rA) return "outer";
+				if (op == Opcode.GLOBALS_rA) return "globals";
+				if (op == Opcode.CALLINTRINSIC_rA_rB_iC) {
+					Intrinsic called = Intrinsic.GetByIndex(BytecodeUtil.Cu(instr));
+					if (globals.HasKey(Value.make_string(called.Name))) return called.Name;
+				}
+			}
+			for (Int32 i = 0; i < def.GlobalNames.Count; i++) {
+				Value name = def.GlobalNames[i];
+				if (BoundByEnclosing(defs, parents, d, name)) continue;
+				if (globals.HasKey(name)) return name.AsCString();
+				Intrinsic intrinsic = Intrinsic.GetByName(name.AsCString());
+				if (intrinsic == null) return name.AsCString();
+			}
+		}
+		return null;
+	}
+
+	// Whether a function that defs[d] is nested in has a parameter or local
+	// variable with the given name.
+	private static Boolean BoundByEnclosing(List<FuncDef> defs, List<Int32> parents, Int32 d, Value name) {
+		for (Int32 p = parents[d]; p >= 0; p = parents[p]) {
+			FuncDef def = defs[p];
+			for (Int32 i = 0; i < def.ParamNames.Count; i++) {
+				if (def.ParamNames[i] == name) return true;
+			}
+			Int32 codeCount = def.CodeCount();
+			for (Int32 pc = 0; pc < codeCount; pc++) {
+				UInt32 instr = def.CodeAt(pc);
+				if ((Opcode)BytecodeUtil.OP(instr) != Opcode.NAME_rA_kBC) continue;
+				if (def.Constants[BytecodeUtil.BCu(instr)] == name) return true;
+			}
+		}
+		return false;
+	}
+
+	// Begin a call of func on each item of list, for the parallelMap (or, if
+	// filter, parallelFilter) intrinsic, chunkSize items at a time (0 for a
+	// size to suit the number of workers).  The result is final unless some
+	// chunks are still running on workers; then pass the partial result to
+	// Continue until it is.
+	public static IntrinsicResult Start(Context ctx, Value list, Value func, Int32 chunkSize, Boolean filter) {
+		Int32 count = list.ListCount();
+		Int32 threads = _isWorker ? 0 : GetThreadCount();
+		if (chunkSize <= 0) chunkSize = (count + 4 * threads + 3) / (4 * threads + 4);	// about 4 chunks per thread
+		if (chunkSize <= 0) chunkSize = 1;
+		Value results = Value.make_list(count);
+		for (Int32 i = 0; i < count; i++) results.Push(Value.Null);
+		GCManager.AddRoot(results);		// (func may collect garbage)
+
+		IsolateFunction portable = null;
+		if (threads > 0 && count > chunkSize) portable = IsolateFunction.Pack(func);
+		if (portable == null) {
+			Boolean ok = RunChunk(ctx, list, func, results, 0, count);
+			GCManager.RemoveRoot(results);
+			if (!ok) return IntrinsicResult.Null;
+			return new IntrinsicResult(Finish(list, results, filter));
+		}
+
+		StartThreads();
+		ParallelJob job = new ParallelJob();
+		job.Function = portable;
+		job.Filter = filter;
+		Lock();
+		_lastJobId++;
+		job.Id = _lastJobId;
+		_jobs.Add(job);
+		Unlock();
+		for (Int32 start = 0; start < count; start += chunkSize) {
+			Int32 end = start + chunkSize;
+			if (end > count) end = count;
+			ChannelMessage msg = ChannelMessage.Pack(list.ListSlice(start, end));
+			Lock();
+			job.Chunks.Add(msg);
+			job.Claimed.Add(false);
+			job.Results.Add(null);
+			Notify();
+			Unlock();
+		}
+
+		// Run the chunks no worker has taken yet right here.
+		while (true) {
+			Lock();
+			Int32 chunk = ClaimChunk(job, true);
+			Unlock();
+			if (chunk < 0) break;
+			Int32 end = (chunk + 1) * chunkSize;
+			if (end > count) end = count;
+			if (!RunChunk(ctx, list, func, results, chunk * chunkSize, end)) {
+				Lock();
+				job.Cancelled = true;
+				RemoveJob(job.Id);
+				Unlock();
+				GCManager.RemoveRoot(results);
+				return IntrinsicResult.Null;
+			}
+		}
+		GCManager.RemoveRoot(results);
+
+		// From here, the partial result (on the VM's stack) holds the results.
+		Value state = Value.make_list(3);
+		state.Push(new Value(job.Id));
+		state.Push(new Value(chunkSize));
+		state.Push(results);
+		return Continue(ctx, state, filter);
+	}
+
+	// Finish a call begun by Start, whose partial result is `state`, if the
+	// workers are done with it.
+	public static IntrinsicResult Continue(Context ctx, Value state, Boolean filter) {
+		Int32 id = state.ListGet(0).IntValue();
+		ParallelJob job = null;
+		Lock();
+		for (Int32 i = 0; i < _jobs.Count; i++) {
+			if (_jobs[i].Id == id) job = _jobs[i];
+		}
+		if (job != null && job.Running > 0 && job.WorkerError == "") {
+			Unlock();
+			return new IntrinsicResult(state, false);	// still running: poll again
+		}
+		RemoveJob(id);
+		Unlock();
+		if (job == null) return new IntrinsicResult(ErrorTypes.RuntimeError("parallelMap: job not found"));
+		if (job.WorkerError != "") {
+			ctx.vm.RaiseRuntimeError(job.WorkerError);
+			return IntrinsicResult.Null;
+		}
+
+		Int32 chunkSize = state.ListGet(1).IntValue();
+		Value results = state.ListGet(2);
+		for (Int32 c = 0; c < job.Results.Count; c++) {
+			ChannelMessage msg = job.Results[c];
+			if (msg == null) continue;	// (run by the caller)
+			Value part = msg.Unpack();
+			Int32 start = c * chunkSize;
+			for (Int32 i = 0; i < part.ListCount(); i++) results.ListSet(start + i, part.ListGet(i));
+		}
+		return new IntrinsicResult(Finish(ctx.GetArg(0), results, filter));
+	}
+
+	// Call func on list[start:end] on this thread, storing the results.
+	// Returns false if it raised an error (which the VM now holds).
+	private static Boolean RunChunk(Context ctx, Value list, Value func, Value results, Int32 start, Int32 end) {
+		List<Value> args = new List<Value>();
+		args.Add(Value.Null);
+		for (Int32 i = start; i < end; i++) {
+			args[0] = list.ListGet(i);
+			Value result = ctx.vm.RunFunction(func, args);
+			if (ctx.vm.Error.IsError()) return false;
+			results.ListSet(i, result);
+		}
+		return true;
+	}
+
+	// The value of the call: the results, or for a filter, the items whose
+	// results were true.
+	private static Value Finish(Value list, Value results, Boolean filter) {
+		if (!filter) return results;
+		Value kept = Value.make_list(0);
+		for (Int32 i = 0; i < results.ListCount(); i++) {
+			if (results.ListGet(i).BoolValue()) kept.Push(list.ListGet(i));
+		}
+		return kept;
+	}
+
+	// Drop the job with the given id from the list (under the lock).  A
+	// worker still running one of its chunks finishes it, to no effect.
+	private static void RemoveJob(Int32 id) {
+		for (Int32 i = 0; i < _jobs.Count; i++) {
+			if (_jobs[i].Id != id) continue;
+			_jobs.RemoveAt(i);
+			return;
+		}
+	}
+
+	// Claim the next chunk of job not yet claimed (under the lock), or return
+	// -1 if there is none.  A worker cannot take a chunk that was not packed.
+	private static Int32 ClaimChunk(ParallelJob job, Boolean forCaller) {
+		if (job.Cancelled || job.WorkerError != "") return -1;
+		for (Int32 c = 0; c < job.Chunks.Count; c++) {
+			ChannelMessage items = job.Chunks[c];
+			if (job.Claimed[c] || (!forCaller && items == null)) continue;
+			job.Claimed[c] = true;
+			return c;
+		}
+		return -1;
+	}
+
+	// Stop the workers and wait for them to finish.  Happens by itself at exit.
+	public static void Stop() {
+		Lock();
+		_stopping = true;
+		Notify();
+		Unlock();
+		//*** BEGIN CS_ONLY ***
+		for (Int32 i = 0; i < _threads.Count; i++) _threads[i].Join();
+		_threads.Clear();
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		std::vector<std::thread>& threads = Threads().threads;
+		for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+		threads.clear();
+		*** END CPP_ONLY ***/
+		Lock();
+		_jobs.Clear();
+		_threadsRunning = 0;
+		_stopping = false;
+		Unlock();
+	}
+
+	// ── Workers ──────────────────────────────────────────────────────────────
+
+	private static void StartThreads() {
+		while (_threadsRunning < ThreadCount) {
+			_threadsRunning++;
+			//*** BEGIN CS_ONLY ***
+			System.Threading.Thread t = new System.Threading.Thread(WorkerLoop);
+			t.IsBackground = true;
+			t.Start();
+			_threads.Add(t);
+			//*** END CS_ONLY ***
+			// CPP: Threads().threads.push_back(std::thread(&ParallelMap::WorkerLoop));
+		}
+	}
+
+	// Body of each worker: claim chunks, oldest job first, until told to stop.
+	private static void WorkerLoop() {
+		GCManager.Init();
+		ErrorTypes.Init();
+		_isWorker = true;
+		Interpreter interp = new Interpreter(kWorkerSource);
+		interp.Compile();
+		List<Value> args = new List<Value>();
+		args.Add(Value.Null);
+		Int32 funcJob = 0;		// the job that func was unpacked for
+		Value func = Value.Null;
+
+		Lock();
+		while (true) {
+			if (_stopping) break;
+			ParallelJob job = null;
+			Int32 chunk = -1;
+			for (Int32 j = 0; j < _jobs.Count && chunk < 0; j++) {
+				job = _jobs[j];
+				chunk = ClaimChunk(job, false);
+			}
+			if (chunk < 0) {
+				Wait();
+				continue;
+			}
+			job.Running = job.Running + 1;
+			ChannelMessage msg = job.Chunks[chunk];
+			Unlock();
+
+			if (job.Id != funcJob) {
+				if (!func.IsNull()) GCManager.RemoveRoot(func);
+				func = job.Function.Unpack();
+				GCManager.AddRoot(func);
+				funcJob = job.Id;
+			}
+			Value items = msg.Unpack();
+			Value results = Value.make_list(items.ListCount());
+			String error = "";
+			for (Int32 i = 0; i < items.ListCount(); i++) {
+				args[0] = items.ListGet(i);
+				Value result = interp.RunFunction(func, args);
+				Value err = interp.vm.Error;
+				if (err.IsError()) {
+					String loc = ErrorTypes.ErrorLocation(err);
+					if (loc == "") error = StringUtils.Format("{0} (in a parallelMap worker)", err.Message());
+					else error = StringUtils.Format("{0} (at {1} in a parallelMap worker)", err.Message(), loc);
+					interp.Restart();
+					break;
+				}
+				if (job.Filter) result = Value.Truth(result.BoolValue());
+				results.Push(result);
+			}
+			ChannelMessage packed = null;
+			if (error == "") {
+				packed = ChannelMessage.Pack(results);
+				if (packed == null) error = "parallelMap: function result cannot be sent from a worker (it is or holds a function, error, handle, or variable map)";
+			}
+			GCManager.CollectGarbage();
+
+			Lock();
+			job.Running = job.Running - 1;
+			job.Results[chunk] = packed;
+			if (error != "" && job.WorkerError == "") job.WorkerError = error;
+		}
+		Unlock();
+	}
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private static void Lock() {
+		System.Threading.Monitor.Enter(_lock); // CPP: _mutex.lock();
+	}
+
+	private static void Unlock() {
+		System.Threading.Monitor.Exit(_lock); // CPP: _mutex.unlock();
+	}
+
+	// Wait (holding the lock) until some other thread calls Notify.
+	private static void Wait() {
+		System.Threading.Monitor.Wait(_lock); // CPP: _changed.wait(_mutex);
+	}
+
+	private static void Notify() {
+		System.Threading.Monitor.PulseAll(_lock); // CPP: _changed.notify_all();
+	}
+}
+
+}
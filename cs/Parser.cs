@@ -24,12 +24,18 @@ namespace MiniScript {
 // Uses a Pratt parser algorithm with parselets to handle operator precedence.
 public class Parser : IParser {
 	private Lexer _lexer;
+	private Boolean _lexerReady = false;   // _lexer has been made, and can be Reset
 	private Token _current;
 	private TokenType _previousType;
 	private Boolean _needMoreInput;
 	public Value Error;
 	public String FileName;    // source file name, for error locations ("" if unnamed)
 
+	// Set to parse off the VM thread (see ImportPrefetch).  As in the Lexer, an
+	// error is then only noted: HadError reports it, but Error stays null.
+	public Boolean Detached = false;
+	private Boolean _detachedError = false;
+
 	// Parselet tables - indexed by TokenType
 	private Dictionary<TokenType, PrefixParselet> _prefixParselets;
 	private Dictionary<TokenType, InfixParselet> _infixParselets;
@@ -115,10 +121,17 @@ public class Parser : IParser {
 	// Initialize the parser with source code and the name of the file it came
 	// from, so parse errors can report their location as "{file} line {N}".
 	public void Init(String source, String fileName) {
-		_lexer = new Lexer(source);
+		if (_lexerReady) {
+			_lexer.Reset(source);
+		} else {
+			_lexer = new Lexer(source);
+			_lexerReady = true;
+		}
 		_lexer.FileName = fileName;
+		_lexer.Detached = Detached;
 		FileName = fileName;
 		Error = Value.Null;
+		_detachedError = false;
 		_needMoreInput = false;
 		Advance();  // Prime the pump with the first token
 	}
@@ -143,6 +156,10 @@ public class Parser : IParser {
 	//
 	public void RequireComplete() {
 		if (!NeedMoreInput()) return;
+		if (Detached) {
+			_detachedError = true;
+			return;
+		}
 		Error = ErrorTypes.CompilerError("unexpected end of file", FileName, _current.Line);
 	}
 
@@ -153,7 +170,10 @@ public class Parser : IParser {
 		_previousType = _current.Type;
 		do {
 			_current = _lexer.NextToken();
-			if (Error.IsNull() && _lexer.HadError()) Error = _lexer.Error;
+			if (_lexer.HadError() && !HadError()) {
+				if (Detached) _detachedError = true;
+				else Error = _lexer.Error;
+			}
 		} while (_current.Type == TokenType.COMMENT
 			|| (_current.Type == TokenType.EOL && AllowsLineContinuation(_previousType)));
 		// If the last meaningful token allows line continuation and we've run out
@@ -246,7 +266,9 @@ public class Parser : IParser {
 			return tok;
 		}
 		ReportError(errorMessage);
-		return new Token(TokenType.ERROR, "", _current.Line, _current.Column);
+		Token errTok = new Token(TokenType.ERROR, _current.Start, 0, _current.Line, _current.Column);
+		errTok.Text = "";
+		return errTok;
 	}
 
 	// Get the precedence of the infix parselet for the current token.
@@ -564,7 +586,7 @@ public class Parser : IParser {
 
 			// Expect EOL after statement
 			if (_current.Type != TokenType.EOL && !IsBlockTerminator(terminator1, terminator2)) {
-				ReportError($"Expected end of line, got: {_current.Text}");
+				ReportError($"Expected end of line, got: {_lexer.TextOf(_current)}");
 				// Try to recover by skipping to next line
 				while (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
 					Advance();
@@ -650,7 +672,7 @@ public class Parser : IParser {
 		} else {
 			// plain else - expect EOL then body
 			if (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
-				ReportError($"Expected end of line after 'else', got: {_current.Text}");
+				ReportError($"Expected end of line after 'else', got: {_lexer.TextOf(_current)}");
 			}
 			elseBody = ParseBlock(TokenType.END, TokenType.END);  // only END terminates
 		}
@@ -696,7 +718,7 @@ public class Parser : IParser {
 
 		// Expect EOL after condition
 		if (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
-			ReportError($"Expected end of line after while condition, got: {_current.Text}");
+			ReportError($"Expected end of line after while condition, got: {_lexer.TextOf(_current)}");
 		}
 
 		List<ASTNode> body = ParseBlock(TokenType.END, TokenType.END);
@@ -710,7 +732,7 @@ public class Parser : IParser {
 	private ASTNode ParseForStatement() {
 		// Expect identifier (loop variable)
 		if (_current.Type != TokenType.IDENTIFIER) {
-			ReportError($"Expected identifier after 'for', got: {_current.Text}");
+			ReportError($"Expected identifier after 'for', got: {_lexer.TextOf(_current)}");
 			return new ForNode("_", new NumberNode(0), new List<ASTNode>());
 		}
 		String varName = _current.Text;
@@ -728,7 +750,7 @@ public class Parser : IParser {
 
 		// Expect EOL after expression
 		if (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
-			ReportError($"Expected end of line after for expression, got: {_current.Text}");
+			ReportError($"Expected end of line after for expression, got: {_lexer.TextOf(_current)}");
 		}
 
 		List<ASTNode> body = ParseBlock(TokenType.END, TokenType.END);
@@ -766,7 +788,7 @@ public class Parser : IParser {
 
 		// Expect EOL after parameter list
 		if (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
-			ReportError($"Expected end of line after function parameters, got: {_current.Text}");
+			ReportError($"Expected end of line after function parameters, got: {_lexer.TextOf(_current)}");
 		}
 
 		// Parse body until "end function"
@@ -828,7 +850,7 @@ public class Parser : IParser {
 			// Expect EOL or EOF after statement
 			// (block statements like while handle their own EOL consumption)
 			if (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
-				ReportError($"Expected end of line, got: {_current.Text}");
+				ReportError($"Expected end of line, got: {_lexer.TextOf(_current)}");
 				// Try to recover by skipping to next line
 				while (_current.Type != TokenType.EOL && _current.Type != TokenType.END_OF_INPUT) {
 					Advance();
@@ -854,7 +876,7 @@ public class Parser : IParser {
 
 		// Check for trailing tokens (except END_OF_INPUT or EOL)
 		if (_current.Type != TokenType.END_OF_INPUT && _current.Type != TokenType.EOL) {
-			ReportError($"Unexpected token after statement: {_current.Text}");
+			ReportError($"Unexpected token after statement: {_lexer.TextOf(_current)}");
 		}
 
 		return result;
@@ -863,7 +885,7 @@ public class Parser : IParser {
 	// Describe a token for use in error messages, matching MiniScript 1.x format
 	private String TokenDescription(Token tok) {
 		if (tok.Type == TokenType.EOL || tok.Type == TokenType.END_OF_INPUT) return "EOL";
-		if (tok.Type == TokenType.NUMBER) return tok.Text;
+		if (tok.Type == TokenType.NUMBER) return _lexer.TextOf(tok);
 		if (tok.Type == TokenType.STRING) return StringUtils.Format("\"{0}\"", tok.Text);
 		if (tok.Type == TokenType.IDENTIFIER) return tok.Text;
 		// Keywords
@@ -883,7 +905,7 @@ public class Parser : IParser {
 		if (tok.Type == TokenType.NOT) return "Keyword(not)";
 		if (tok.Type == TokenType.NEW) return "Keyword(new)";
 		if (tok.Type == TokenType.ISA) return "Keyword(isa)";
-		return tok.Text;
+		return _lexer.TextOf(tok);
 	}
 
 	// Format an error in the 1.x style: "got X where Y is required"
@@ -893,12 +915,16 @@ public class Parser : IParser {
 
 	// Report an error.  Only the first error is kept.
 	public void ReportError(String message) {
+		if (Detached) {
+			_detachedError = true;
+			return;
+		}
 		if (Error.IsNull()) Error = ErrorTypes.CompilerError(message, FileName, _current.Line);
 	}
 
 	// Check if any errors occurred
 	public Boolean HadError() {
-		return !Error.IsNull();
+		return _detachedError || !Error.IsNull();
 	}
 }
 
@@ -0,0 +1,231 @@
+// Scheduler.cs
+//
+// Runs many interpreters on one thread, taking turns -- for a host with a
+// script per game agent, say, where most scripts spend most of their time
+// in `wait`.  Driving each interpreter with RunUntilDone would have the
+// thread sit through every wait in turn; the scheduler instead runs only
+// the interpreters that have something to do.  Each gets a turn of up to
+// timeSlice seconds (Interpreter.RunSlice), which ends early if the script
+// yields or starts a wait.  One that is waiting goes into a timer heap,
+// keyed by when its wait is due (VM.SecondsToWake), and is not run again
+// until then; one that yielded goes to the back of the ready list, to run
+// in the next round.  When nothing is ready, RunUntilDone sleeps until the
+// earliest wait is due.  A task left blocked in some other intrinsic, such
+// as receive on an empty channel, has no time to wake; it stays on the
+// ready list, and when a round runs nothing but such tasks, RunUntilDone
+// backs off, sleeping a little longer each such round in a row.
+//
+// The scheduler also keeps the time spent running each interpreter, so a
+// host can see which scripts are costing it.
+//
+// Like the interpreters it runs, a scheduler belongs to one thread.
+
+using System;
+using System.Collections.Generic;
+// H: #include "Interpreter.g.h"
+// H: #include <chrono>
+// CPP: #include "VM.g.h"
+// CPP: #include <thread>
+
+namespace MiniScript {
+
+public class Scheduler {
+
+	// Longest turn an interpreter gets before the next one runs, in seconds.
+	public double timeSlice = 0.01;
+
+	// Shortest and longest sleep after a round in which every task that ran
+	// was left blocked, in seconds.
+	public double minIdleSleep = 0.0005;
+	public double maxIdleSleep = 0.01;
+
+	private List<Interpreter> _tasks;	// every interpreter added, by task number
+	private List<double> _runTime;	// seconds spent running each task
+	private List<double> _wakeAt;	// for a task in _timers, when (by Now) its wait is due
+	private List<Int32> _ready;	// tasks to run, in order, from _readyHead on
+	private Int32 _readyHead = 0;
+	private List<Int32> _timers;	// waiting tasks: a binary min-heap on _wakeAt
+	private Int32 _liveCount = 0;	// tasks not yet done
+	private Int32 _blockedCount = 0;	// tasks left blocked in the last round
+
+	//*** BEGIN CS_ONLY ***
+	private System.Diagnostics.Stopwatch _stopwatch = new System.Diagnostics.Stopwatch();
+	//*** END CS_ONLY ***
+	// H: private: std::chrono::steady_clock::time_point _startTime;
+
+	public Scheduler() {
+		_tasks = new List<Interpreter>();
+		_runTime = new List<double>();
+		_wakeAt = new List<double>();
+		_ready = new List<Int32>();
+		_timers = new List<Int32>();
+		_stopwatch.Start(); // CPP: _startTime = std::chrono::steady_clock::now();
+	}
+
+	// Add an interpreter (not yet run, or partway through), ready to run.
+	// Returns its task number.
+	public Int32 Add(Interpreter interp) {
+		_tasks.Add(interp);
+		_runTime.Add(0);
+		_wakeAt.Add(0);
+		_ready.Add(_tasks.Count - 1);
+		_liveCount++;
+		return _tasks.Count - 1;
+	}
+
+	public Int32 TaskCount() {
+		return _tasks.Count;
+	}
+
+	public Interpreter GetTask(Int32 task) {
+		return _tasks[task];
+	}
+
+	// How many tasks have not finished.
+	public Int32 LiveCount() {
+		return _liveCount;
+	}
+
+	// How many tasks are in a wait that is not yet due.
+	public Int32 WaitingCount() {
+		return _timers.Count;
+	}
+
+	// Seconds spent running the given task so far.
+	public double RunTime(Int32 task) {
+		return _runTime[task];
+	}
+
+	// Seconds until some task is next ready to run: 0 if one is ready now,
+	// or -1 if every task has finished.
+	public double SecondsToNextWake() {
+		WakeDue();
+		if (_readyHead < _ready.Count) return 0;
+		if (_timers.Count == 0) return -1;
+		double seconds = WakeAt(0) - Now();
+		return seconds > 0 ? seconds : 0;
+	}
+
+	// Give each task that is ready now one turn.  Tasks that yield during
+	// this round wait for the next one.  Returns how many tasks ran.
+	public Int32 RunOnce() {
+		WakeDue();
+		_blockedCount = 0;
+		Int32 count = _ready.Count - _readyHead;
+		for (Int32 i = 0; i < count; i++) {
+			Int32 task = _ready[_readyHead];
+			_readyHead++;
+			RunTask(task);
+		}
+		if (_readyHead == _ready.Count) {
+			_ready.Clear();
+			_readyHead = 0;
+		} else if (_readyHead > 1024 && _readyHead * 2 > _ready.Count) {
+			_ready.RemoveRange(0, _readyHead); // CPP: _ready.RemoveRange(0, _readyHead);
+			_readyHead = 0;
+		}
+		return count;
+	}
+
+	// Run until every task has finished, or timeLimit seconds have passed,
+	// sleeping whenever no task is ready, or every task that ran is blocked.
+	public void RunUntilDone(double timeLimit=60) {
+		double endTime = Now() + timeLimit;
+		double idleSleep = 0;
+		while (_liveCount > 0) {
+			Int32 ran = RunOnce();
+			double wait = SecondsToNextWake();
+			if (wait < 0) break;
+			double left = endTime - Now();
+			if (left <= 0) break;
+			if (wait == 0 && ran > 0 && _blockedCount == ran) {
+				// Nothing could go on; back off rather than spin, but not past
+				// the earliest wait.
+				idleSleep = idleSleep * 2;
+				if (idleSleep < minIdleSleep) idleSleep = minIdleSleep;
+				if (idleSleep > maxIdleSleep) idleSleep = maxIdleSleep;
+				wait = idleSleep;
+				if (_timers.Count > 0 && WakeAt(0) - Now() < wait) wait = WakeAt(0) - Now();
+			} else {
+				idleSleep = 0;
+			}
+			if (wait > left) wait = left;
+			if (wait > 0) System.Threading.Thread.Sleep(TimeSpan.FromSeconds(wait)); // CPP: if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+		}
+	}
+
+	// ── Internals ────────────────────────────────────────────────────────────
+
+	private double Now() {
+		// CPP: auto now = std::chrono::steady_clock::now();
+		return _stopwatch.Elapsed.TotalSeconds; // CPP: return std::chrono::duration<double>(now - _startTime).count();
+	}
+
+	// Run one turn of a task, then file it as done, waiting, or ready.
+	private void RunTask(Int32 task) {
+		Interpreter interp = _tasks[task];
+		double start = Now();
+		interp.RunSlice(timeSlice);
+		double end = Now();
+		_runTime[task] = _runTime[task] + (end - start);
+		if (interp.Done()) {
+			_liveCount--;
+			return;
+		}
+		double wake = interp.vm.SecondsToWake();
+		if (wake > 0) {
+			_wakeAt[task] = end + wake;
+			PushTimer(task);
+		} else {
+			if (interp.vm.IsBlocked()) _blockedCount++;
+			_ready.Add(task);
+		}
+	}
+
+	// Move each waiting task whose wait is due to the ready list.
+	private void WakeDue() {
+		if (_timers.Count == 0) return;
+		double now = Now();
+		while (_timers.Count > 0 && WakeAt(0) <= now) _ready.Add(PopTimer());
+	}
+
+	// When the task at the given position in the heap is due.
+	private double WakeAt(Int32 heapPos) {
+		Int32 task = _timers[heapPos];
+		return _wakeAt[task];
+	}
+
+	private void PushTimer(Int32 task) {
+		_timers.Add(task);
+		Int32 pos = _timers.Count - 1;
+		while (pos > 0) {
+			Int32 parent = (pos - 1) / 2;
+			if (WakeAt(parent) <= WakeAt(pos)) break;
+			_timers[pos] = _timers[parent];
+			_timers[parent] = task;
+			pos = parent;
+		}
+	}
+
+	private Int32 PopTimer() {
+		Int32 result = _timers[0];
+		Int32 last = _timers[_timers.Count - 1];
+		_timers.RemoveAt(_timers.Count - 1);
+		Int32 count = _timers.Count;
+		if (count == 0) return result;
+		_timers[0] = last;
+		Int32 pos = 0;
+		while (true) {
+			Int32 child = pos * 2 + 1;
+			if (child >= count) break;
+			if (child + 1 < count && WakeAt(child + 1) < WakeAt(child)) child++;
+			if (WakeAt(pos) <= WakeAt(child)) break;
+			_timers[pos] = _timers[child];
+			_timers[child] = last;
+			pos = child;
+		}
+		return result;
+	}
+}
+
+}
@@ -0,0 +1,300 @@
+// SharedHeap.cs
+//
+// A heap region that every isolate can read.  Each thread's GC heap is its
+// own (see GCManager), so a Value made on one thread means nothing on
+// another -- but a host often has large read-only data (config tables,
+// lookup maps, word lists) that every interpreter needs, and copying it into
+// each isolate wastes time and memory.  A frozen value can instead be
+// published here once, with TryPublish; the Value that comes back may then
+// be handed to any number of isolates, which read it in place, with no
+// copying and no locking.
+//
+// A shared item is an item of the ordinary BigStrings, Lists or Maps set
+// whose index is FirstIndex or above.  The sets send such an index here
+// instead of to their own items (see GCSet.cs), so a shared value is a
+// string, list or map like any other to all the code that uses one.  What
+// it is not is mutable or collectable: a shared list or map is always
+// frozen, and the region is immortal -- its items are never marked, swept,
+// or freed, and live until the process exits.  So publish data that lives
+// as long as the host does, not a value per request.
+//
+// Publishing deep-copies the value into the region (under a lock; it is
+// the only thing here that takes one).  A list or map must be frozen, and
+// so must every list or map it holds; functions, errors and handles cannot
+// be published, nor can a globals or locals map.  Strings are shared by
+// content, so a string published twice is stored once.  Numbers, null, tiny
+// strings and values already shared are their own published form.  When the
+// region has no room for a value, publishing it fails and changes nothing.
+//
+// Reading needs no lock because nothing a reader can reach ever changes:
+// items are written once, before TryPublish returns, into chunks that never
+// move.  The host must still pass the published Value to the other thread
+// by something that synchronizes (starting the thread, a lock, a queue), as
+// with any data one thread hands another.
+//
+// Short strings are not canonical across the region: a shared string is a
+// big heap string whatever its length, while its isolate-local twin may be
+// interned.  Equality allows for this (see Value.ScalarEqual).
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+using System;
+using System.Collections.Generic;
+// H: #include "GCItems.g.h"
+// CPP: #include "GCManager.g.h"
+// CPP: #include "value.h"
+/*** BEGIN CPP_ONLY ***
+#include <mutex>
+*** END CPP_ONLY ***/
+
+namespace MiniScript {
+
+public static class SharedHeap {
+
+	// Item indices from here up are shared (must match SHARED_ITEM_BASE in
+	// value.h).  No isolate's own set grows anywhere near this far.
+	public const Int32 FirstIndex = 0x40000000;
+
+	// Items are stored in chunks of ChunkSize, each allocated when needed
+	// and never moved or resized, so a reader never sees storage reallocate.
+	private const Int32 ChunkBits = 12;
+	private const Int32 ChunkSize = 4096;	// 1 << ChunkBits
+	private const Int32 ChunkMask = 4095;
+	public const Int32 MaxChunks = 4096;	// so up to 16M items per set
+
+	// The most items each set may hold.  A host may lower it, before
+	// publishing anything, to bound the memory the region can take.
+	public static Int32 SetCapacity = MaxChunks * ChunkSize;
+
+	// Items in use in each set.  Written only under the lock.
+	private static Int32 _stringCount = 0;
+	private static Int32 _listCount = 0;
+	private static Int32 _mapCount = 0;
+
+	// Shared string slot by content, so each distinct string is stored once.
+	private static Dictionary<String, Int32> _stringSlots = new Dictionary<String, Int32>();
+
+	//*** BEGIN CS_ONLY ***
+	private static readonly Object _lock = new Object();
+	private static GCString[][] _strings = new GCString[MaxChunks][];
+	private static GCList[][] _lists = new GCList[MaxChunks][];
+	private static GCMap[][] _maps = new GCMap[MaxChunks][];
+	//*** END CS_ONLY ***
+	/*** BEGIN CPP_ONLY ***
+	static std::mutex _mutex;
+	static GCString* _strings[SharedHeap::MaxChunks];
+	static GCList* _lists[SharedHeap::MaxChunks];
+	static GCMap* _maps[SharedHeap::MaxChunks];
+	*** END CPP_ONLY ***/
+
+	// ── Reading (any thread) ──────────────────────────────────────────────────
+
+	public static GCString GetString(Int32 idx) {
+		idx -= FirstIndex;
+		return _strings[idx >> ChunkBits][idx & ChunkMask];
+	}
+
+	public static GCList GetList(Int32 idx) {
+		idx -= FirstIndex;
+		return _lists[idx >> ChunkBits][idx & ChunkMask];
+	}
+
+	public static GCMap GetMap(Int32 idx) {
+		idx -= FirstIndex;
+		return _maps[idx >> ChunkBits][idx & ChunkMask];
+	}
+
+	// Number of items in the region (all three sets).
+	public static Int32 ItemCount() {
+		Lock();
+		Int32 n = _stringCount + _listCount + _mapCount;
+		Unlock();
+		return n;
+	}
+
+	// ── Publishing ───────────────────────────────────────────────────────────
+
+	// Publish v, a value on the calling thread's heap, and set `shared` to
+	// its published form.  Returns false, publishing nothing, if v is or holds
+	// something that cannot be shared (see above), or if the region has no
+	// room for it; then `shared` is v.  Shareable tells the two apart.
+	public static Boolean TryPublish(Value v, out Value shared) {
+		shared = v;
+		if (!v.IsGCObject() || v.IsShared()) return true;
+		Dictionary<Int32, Value> lists = new Dictionary<Int32, Value>();
+		Dictionary<Int32, Value> maps = new Dictionary<Int32, Value>();
+		Dictionary<String, Boolean> strings = new Dictionary<String, Boolean>();
+		List<String> stringList = new List<String>();
+		if (!CanPublish(v, lists, maps, strings, stringList)) return false;
+		Int32 listsNeeded = lists.Count;
+		Int32 mapsNeeded = maps.Count;
+		lists.Clear();
+		maps.Clear();
+		List<Value> made = new List<Value>();
+		Lock();
+		// Check for room first, so that a value too big to fit leaves the
+		// region as it was (Copy claims slots as it goes).
+		Int32 capacity = SetCapacity < MaxChunks * ChunkSize ? SetCapacity : MaxChunks * ChunkSize;
+		Int32 stringsNeeded = 0;
+		for (Int32 i = 0; i < stringList.Count; i++) {
+			if (!_stringSlots.ContainsKey(stringList[i])) stringsNeeded++;
+		}
+		if (stringsNeeded > capacity - _stringCount || listsNeeded > capacity - _listCount
+				|| mapsNeeded > capacity - _mapCount) {
+			Unlock();
+			return false;
+		}
+		shared = Copy(v, lists, maps, made);
+		// Cache each new container's hash now, with the whole graph in place
+		// (a hash looks at the counts of nested containers), since a shared
+		// item is never written again.
+		for (Int32 i = 0; i < made.Count; i++) StoreHash(made[i]);
+		Unlock();
+		return true;
+	}
+
+	// Whether v is or holds only things that can be published, so that
+	// TryPublish fails on it only if the region is full.
+	public static Boolean Shareable(Value v) {
+		return CanPublish(v, new Dictionary<Int32, Value>(), new Dictionary<Int32, Value>(),
+			new Dictionary<String, Boolean>(), new List<String>());
+	}
+
+	// Whether v can be published; lists and maps hold those already checked.
+	// Each distinct heap string found is added to stringList (and strings).
+	private static Boolean CanPublish(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps, Dictionary<String, Boolean> strings, List<String> stringList) {
+		if (!v.IsGCObject() || v.IsShared()) return true;
+		if (v.IsString()) {
+			String s = GCManager.GetString(v).Data;
+			if (!strings.ContainsKey(s)) {
+				strings[s] = true;
+				stringList.Add(s);
+			}
+			return true;
+		}
+		if (v.IsList()) {
+			if (lists.ContainsKey(v.ItemIndex())) return true;
+			GCList l = GCManager.Lists.Get(v.ItemIndex());
+			if (!l.Frozen) return false;
+			lists[v.ItemIndex()] = v;
+			Int32 count = l.Count();
+			for (Int32 i = 0; i < count; i++) {
+				if (!CanPublish(l.Get(i), lists, maps, strings, stringList)) return false;
+			}
+			return true;
+		}
+		if (v.IsMap()) {
+			if (maps.ContainsKey(v.ItemIndex())) return true;
+			GCMap m = GCManager.Maps.Get(v.ItemIndex());
+			if (!m.Frozen || m._vmb != null || m._gb != null) return false;
+			maps[v.ItemIndex()] = v;
+			for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+				if (!CanPublish(m.KeyAt(i), lists, maps, strings, stringList)) return false;
+				if (!CanPublish(m.ValueAt(i), lists, maps, strings, stringList)) return false;
+			}
+			return true;
+		}
+		return false;	// function, error or handle
+	}
+
+	// The shared copy of v (under the lock), made at most once per list or
+	// map.  Each new list and map is added to `made`.  A computed list is
+	// stored materialized.
+	private static Value Copy(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps, List<Value> made) {
+		if (!v.IsGCObject() || v.IsShared()) return v;
+		if (v.IsString()) return ShareString(GCManager.GetString(v).Data);	// (a heap string: tiny ones are not GC objects)
+		Value copy;
+		Int32 slot;
+		if (v.IsList()) {
+			if (lists.TryGetValue(v.ItemIndex(), out copy)) return copy;
+			GCList src = GCManager.Lists.Get(v.ItemIndex());
+			Int32 count = src.Count();
+			slot = NewSlot(GCManager.ListSet);
+			copy = Value.make_gc(GCManager.ListSet, FirstIndex + slot);
+			lists[v.ItemIndex()] = copy;	// (before the items, which may lead back here)
+			made.Add(copy);
+			GCList item = new GCList();
+			item.Init(count);
+			for (Int32 i = 0; i < count; i++) item.Push(Copy(src.Get(i), lists, maps, made));
+			item.Frozen = true;
+			_lists[slot >> ChunkBits][slot & ChunkMask] = item;
+			return copy;
+		}
+		if (v.IsMap()) {
+			if (maps.TryGetValue(v.ItemIndex(), out copy)) return copy;
+			GCMap src = GCManager.Maps.Get(v.ItemIndex());
+			slot = NewSlot(GCManager.MapSet);
+			copy = Value.make_gc(GCManager.MapSet, FirstIndex + slot);
+			maps[v.ItemIndex()] = copy;
+			made.Add(copy);
+			GCMap item = new GCMap();
+			item.Init(src.Count());
+			for (Int32 i = src.NextEntry(-1); i != -1; i = src.NextEntry(i)) {
+				Value key = Copy(src.KeyAt(i), lists, maps, made);
+				item.Set(key, Copy(src.ValueAt(i), lists, maps, made));
+			}
+			item.Frozen = true;
+			_maps[slot >> ChunkBits][slot & ChunkMask] = item;
+			return copy;
+		}
+		return v;
+	}
+
+	// Compute and store the hash of a container made by Copy (under the lock).
+	private static void StoreHash(Value v) {
+		UInt32 h = (UInt32)v.Hash();	// (not cached by the set: see GCListSet.SetHashCache)
+		Int32 slot = v.ItemIndex() - FirstIndex;
+		if (v.IsList()) {
+			GCList item = _lists[slot >> ChunkBits][slot & ChunkMask];
+			item.HashCache = h;
+			_lists[slot >> ChunkBits][slot & ChunkMask] = item;
+		} else {
+			GCMap item = _maps[slot >> ChunkBits][slot & ChunkMask];
+			item.HashCache = h;
+			_maps[slot >> ChunkBits][slot & ChunkMask] = item;
+		}
+	}
+
+	// The shared string with content s (under the lock).
+	private static Value ShareString(String s) {
+		Int32 slot;
+		if (!_stringSlots.TryGetValue(s, out slot)) {
+			slot = NewSlot(GCManager.BigStringSet);
+			GCString item = new GCString();
+			item.Data = s;
+			_strings[slot >> ChunkBits][slot & ChunkMask] = item;
+			_stringSlots[s] = slot;
+		}
+		return Value.make_gc(GCManager.BigStringSet, FirstIndex + slot);
+	}
+
+	// Claim the next slot of the given set (under the lock), allocating a
+	// new chunk when the last one is full.  Returns the slot number, counting
+	// from 0 (the item index is FirstIndex + slot).  TryPublish has already
+	// made sure there is room.
+	private static Int32 NewSlot(Int32 setIdx) {
+		Int32 slot;
+		if (setIdx == GCManager.ListSet) {
+			slot = _listCount++;
+			if ((slot & ChunkMask) == 0) _lists[slot >> ChunkBits] = new GCList[ChunkSize]; // CPP: if ((slot & ChunkMask) == 0) _lists[slot >> ChunkBits] = new GCList[ChunkSize];
+		} else if (setIdx == GCManager.MapSet) {
+			slot = _mapCount++;
+			if ((slot & ChunkMask) == 0) _maps[slot >> ChunkBits] = new GCMap[ChunkSize]; // CPP: if ((slot & ChunkMask) == 0) _maps[slot >> ChunkBits] = new GCMap[ChunkSize];
+		} else {
+			slot = _stringCount++;
+			if ((slot & ChunkMask) == 0) _strings[slot >> ChunkBits] = new GCString[ChunkSize]; // CPP: if ((slot & ChunkMask) == 0) _strings[slot >> ChunkBits] = new GCString[ChunkSize];
+		}
+		return slot;
+	}
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private static void Lock() {
+		System.Threading.Monitor.Enter(_lock); // CPP: _mutex.lock();
+	}
+
+	private static void Unlock() {
+		System.Threading.Monitor.Exit(_lock); // CPP: _mutex.unlock();
+	}
+}
+
+}
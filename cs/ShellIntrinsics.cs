@@ -10,6 +10,7 @@ using System.Collections.Generic;
 // CPP: #include "IntrinsicAPI.g.h"
 // CPP: #include "VM.g.h"
 // CPP: #include "Interpreter.g.h"
+// CPP: #include "ImportPrefetch.g.h"
 // CPP: #include "Parser.g.h"
 // CPP: #include "CodeGenerator.g.h"
 // CPP: #include "CodeEmitter.g.h"
@@ -66,9 +67,13 @@ using System.Collections.Generic;
 namespace MiniScript {
 
 public static class ShellIntrinsics {
+	// The argument strings are the process's, set once before any isolate
+	// starts.  Everything else here that holds a Value, or refers to an
+	// intrinsic by index, is per thread, like the GC heap (see GCManager), and
+	// is set up by Init on each thread.
 	private static List<String> _shellArgStrings = null;
-	private static Value _shellArgs = Value.Null;
-	private static Value _envMap = Value.Null;
+	[ThreadStatic] private static Value _shellArgs;
+	[ThreadStatic] private static Value _envMap;
 
 	// Default import search path, used when MS_IMPORT_PATH is not already set in
 	// the environment.  Variables are expanded at import time, not here.
@@ -76,34 +81,36 @@ public static class ShellIntrinsics {
 
 	//*** BEGIN CS_ONLY ***
 	// C# exec state: one slot per running job; slots accumulate and are never reused.
-	private static List<System.Diagnostics.Process> _csExecProcs = null;
-	private static List<String> _csExecOutputs = null;
-	private static List<String> _csExecErrors = null;
-	private static List<Boolean> _csExecOutDone = null;
-	private static List<Boolean> _csExecErrDone = null;
+	[ThreadStatic] private static List<System.Diagnostics.Process> _csExecProcs;
+	[ThreadStatic] private static List<String> _csExecOutputs;
+	[ThreadStatic] private static List<String> _csExecErrors;
+	[ThreadStatic] private static List<Boolean> _csExecOutDone;
+	[ThreadStatic] private static List<Boolean> _csExecErrDone;
 	//*** END CS_ONLY ***
 	/*** BEGIN CPP_ONLY ***
 	// C++ exec state: parallel arrays capped at 64 concurrent jobs.
-	static FILE* _cppExecPipes[64];
-	static String _cppExecOutputs[64];
-	static Int32 _cppExecStatus[64];
-	static bool _cppExecDone[64];
-	static Int32 _execJobCount = 0;
+	static thread_local FILE* _cppExecPipes[64];
+	static thread_local String _cppExecOutputs[64];
+	static thread_local Int32 _cppExecStatus[64];
+	static thread_local bool _cppExecDone[64];
+	static thread_local Int32 _execJobCount = 0;
 	*** END CPP_ONLY ***/
 
 	// ── File module static fields ─────────────────────────────────────────────
-	private static Value _fileModuleMap = Value.Null;
-	private static Value _fileHandleClassMap = Value.Null;
-	private static Value _rawDataClassMap = Value.Null;
-	private static Int32 _rdStart = -1, _fhStart = -1, _fmStart = -1;
-	private static List<String> _rdKeys = null;
-	private static List<String> _fhKeys = null;
-	private static List<String> _fmKeys = null;
+	[ThreadStatic] private static Value _fileModuleMap;
+	[ThreadStatic] private static Value _fileHandleClassMap;
+	[ThreadStatic] private static Value _rawDataClassMap;
+	[ThreadStatic] private static Int32 _rdStart;
+	[ThreadStatic] private static Int32 _fhStart;
+	[ThreadStatic] private static Int32 _fmStart;
+	[ThreadStatic] private static List<String> _rdKeys;
+	[ThreadStatic] private static List<String> _fhKeys;
+	[ThreadStatic] private static List<String> _fmKeys;
 
 	// ── Key module static fields ──────────────────────────────────────────────
-	private static Value _keyModuleMap = Value.Null;
-	private static Int32 _keyStart = -1;
-	private static List<String> _keyKeys = null;
+	[ThreadStatic] private static Value _keyModuleMap;
+	[ThreadStatic] private static Int32 _keyStart;
+	[ThreadStatic] private static List<String> _keyKeys;
 
 	// Platform-specific wrapper types for FileHandle and RawData.
 	//*** BEGIN CS_ONLY ***
@@ -394,6 +401,37 @@ public static class ShellIntrinsics {
 		return result;
 	}
 
+	// The directories import searches, in order, from MS_IMPORT_PATH: each
+	// with its variables expanded and a trailing separator, so that a library
+	// file's path is the entry plus its name.  An empty entry is the current
+	// directory.
+	private static List<String> ImportSearchDirs() {
+		Value pathVal;
+		String searchPath;
+		if (!GetEnvMap().TryGet(Value.make_string("MS_IMPORT_PATH"), out pathVal) || pathVal.IsNull()) {
+			searchPath = kDefaultImportPath;	// (shouldn't happen; GetEnvMap seeds it)
+		} else {
+			searchPath = pathVal.AsCString();
+		}
+		List<String> libDirs = SplitImportPath(searchPath);
+		List<String> result = new List<String>();
+		for (Int32 i = 0; i < libDirs.Count; i++) {
+			String dir = libDirs[i];
+			if (dir.Length == 0) dir = ".";
+			else if (!dir.EndsWith("/") && !dir.EndsWith("\\")) dir += "/";
+			result.Add(ExpandVariables(dir));
+		}
+		return result;
+	}
+
+	// Start parsing, in the background, the libraries the given script source
+	// imports by literal name (see ImportPrefetch).  Call once the environment
+	// (MS_SCRIPT_DIR etc.) is set up for the script, before compiling it.
+	public static void PrefetchImports(String source) {
+		if (ImportPrefetch.GetThreadCount() <= 0) return;
+		ImportPrefetch.Start(source, ImportSearchDirs());
+	}
+
 	// Expand shell variable references ($VAR, ${VAR}) in a path string,
 	// looking up values in the cached env map.
 	private static String ExpandVariables(String path) {
@@ -435,8 +473,9 @@ public static class ShellIntrinsics {
 	}
 
 	// Try to read a source file. Returns the file contents if the file exists,
-	// or null (empty string in C++) if it does not.  Used by the import intrinsic.
-	private static String TryReadSource(String path) {
+	// or null (empty string in C++) if it does not.  Used by the import intrinsic
+	// and by ImportPrefetch (so must not touch the GC heap).
+	public static String TryReadSource(String path) {
 		//*** BEGIN CS_ONLY ***
 		if (!System.IO.File.Exists(path)) return null;
 		return System.IO.File.ReadAllText(path);
@@ -444,11 +483,12 @@ public static class ShellIntrinsics {
 		/*** BEGIN CPP_ONLY ***
 		FILE* handle = fopen(path.c_str(), "r");
 		if (!handle) return String("");
-		String result;
+		std::string text;
 		char buf[4096];
-		while (fgets(buf, sizeof(buf), handle)) result += buf;
+		size_t n;
+		while ((n = fread(buf, 1, sizeof(buf), handle)) > 0) text.append(buf, n);
 		fclose(handle);
-		return result;
+		return String(text.data(), text.size());
 		*** END CPP_ONLY ***/
 	}
 
@@ -2226,8 +2266,10 @@ public static class ShellIntrinsics {
 		*** END CPP_ONLY ***/
 	}
 
-	// Register all shell intrinsics.  Must be called before any Interpreter is Reset.
+	// Register all shell intrinsics.  Must be called before any Interpreter is
+	// Reset, once on each thread that runs one (after GCManager.Init).
 	public static void Init() {
+		InvalidateCaches();	// (a thread-static Value starts out as 0 in C#, not null)
 		GCManager.RegisterMarkCallback(MarkRoots, null); // CPP: GCManager::RegisterMarkCallback(ShellIntrinsics::MarkRoots, nullptr);
 		CoreIntrinsics.RegisterInvalidateCallback(InvalidateCaches); // CPP: CoreIntrinsics::RegisterInvalidateCallback(ShellIntrinsics::InvalidateCaches);
 		InitFileIntrinsics();
@@ -2363,23 +2405,12 @@ public static class ShellIntrinsics {
 			if (libname.Length == 0) {
 				return new IntrinsicResult(ErrorTypes.FileError("import: no library name given"));
 			}
-			// Determine the search path.
-			Value pathVal;
-			String searchPath;
-			if (!GetEnvMap().TryGet(Value.make_string("MS_IMPORT_PATH"), out pathVal) || pathVal.IsNull()) {
-				searchPath = kDefaultImportPath;	// (shouldn't happen; GetEnvMap seeds it)
-			} else {
-				searchPath = pathVal.AsCString();
-			}
-			List<String> libDirs = SplitImportPath(searchPath);
 			// Find and read the module source file.
+			List<String> libDirs = ImportSearchDirs();
 			String source = "";
 			Boolean found = false;
 			for (Int32 i = 0; i < libDirs.Count; i++) {
-				String dir = libDirs[i];
-				if (dir.Length == 0) dir = ".";
-				else if (!dir.EndsWith("/") && !dir.EndsWith("\\")) dir += "/";
-				String path = ExpandVariables(dir) + libname + ".ms";
+				String path = libDirs[i] + libname + ".ms";
 				String src = TryReadSource(path);
 				if (src == null) continue; // CPP: if (src.LengthB() == 0) continue;
 				source = src;
@@ -2389,9 +2420,11 @@ public static class ShellIntrinsics {
 			if (!found) {
 				return new IntrinsicResult(ErrorTypes.FileError(StringUtils.Format("import: library not found: {0}", libname)));
 			}
-			// Parse and compile the module to its @main FuncDef.
+			// Parse and compile the module to its @main FuncDef -- or only
+			// compile it, if ImportPrefetch has already parsed this source.
 			Value compileErr;
-			FuncDef moduleMain = Interpreter.CompileToFunc(source, libname + ".ms", out compileErr);
+			List<ASTNode> parsed = ImportPrefetch.Take(libname, source);
+			FuncDef moduleMain = Interpreter.CompileToFunc(source, libname + ".ms", parsed, out compileErr);
 			if (moduleMain == null) {
 				// Return the error as our result: as a bare statement (the usual
 				// form) the discarded value halts the program via ERRCHK, while
@@ -16,6 +16,13 @@ using System.Collections.Generic;
 // CPP: #include "Interpreter.g.h"
 // CPP: #include "Intrinsic.g.h"
 // CPP: #include "CoreIntrinsics.g.h"
+// CPP: #include "BytecodeCache.g.h"
+// CPP: #include "ErrorTypes.g.h"
+// CPP: #include "InterpreterPool.g.h"
+// CPP: #include "Scheduler.g.h"
+// CPP: #include "SharedHeap.g.h"
+// CPP: #include "ParallelMap.g.h"
+// CPP: #include <thread>
 
 namespace MiniScript {
 
@@ -393,6 +400,16 @@ public static class UnitTests {
 		ok = ok && CheckParse(parser, "not 0", "1");
 		ok = ok && CheckParse(parser, "not 1", "0");
 
+		ok = ok && CheckParse(parser, "not true", "0");
+		ok = ok && CheckParse(parser, "true and false", "0");
+
+		// Test strings and comparison chains
+		ok = ok && CheckParse(parser, "\"pre\" + \"fix\"", "\"prefix\"");
+		ok = ok && CheckParse(parser, "\"a\" == \"a\"", "1");
+		ok = ok && CheckParse(parser, "\"a\" != \"a\"", "0");
+		ok = ok && CheckParse(parser, "1 < 2 <= 2", "1");
+		ok = ok && CheckParse(parser, "1 < 3 < 2", "0");
+
 		// Test identifiers (these don't simplify, just return as-is)
 		ok = ok && CheckParse(parser, "x", "x");
 		ok = ok && CheckParse(parser, "foo", "foo");
@@ -401,6 +418,17 @@ public static class UnitTests {
 		ok = ok && CheckParse(parser, "x + 0", "PLUS(x, 0)");
 		ok = ok && CheckParse(parser, "2 + x", "PLUS(2, x)");
 
+		// Identities apply only where the other operand must be a number
+		ok = ok && CheckParse(parser, "x * 1", "TIMES(x, 1)");
+		ok = ok && CheckParse(parser, "(x == y) * 1", "EQUALS(x, y)");
+		ok = ok && CheckParse(parser, "0 + (x < y)", "LESS_THAN(x, y)");
+		ok = ok && CheckParse(parser, "-x + 0", "PLUS(MINUS(x), 0)");
+
+		// A constant condition keeps only the arm that runs
+		ok = ok && CheckParse(parser, "if 2 > 3 then x = 1 else x = 2", "if 1 then\n  x = 2\nend if");
+		ok = ok && CheckParse(parser, "if \"yes\" then x = 1 else x = 2", "if 1 then\n  x = 1\nend if");
+		ok = ok && CheckParse(parser, "if y then x = 1 else x = 2", "if y then\n  x = 1\nelse\n  x = 2\nend if");
+
 		// Test string literals
 		ok = ok && CheckParse(parser, "\"hello\"", "\"hello\"");
 
@@ -538,60 +566,61 @@ public static class UnitTests {
 			"  RETURN"
 		}); // CPP: }));
 
-		// Test assembly output for addition (resultReg r0 allocated first)
+		// Test assembly output for addition (operands first; the result reuses
+		// the left operand's register, r0)
 		ok = ok && CheckCodeGen(parser, "2 + 3", new List<String> {
-			"  LOAD_rA_iBC r1, 2",
-			"  LOAD_rA_iBC r2, 3",
-			"  ADD_rA_rB_rC r0, r1, r2",
+			"  LOAD_rA_iBC r0, 2",
+			"  LOAD_rA_iBC r1, 3",
+			"  ADD_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test subtraction
 		ok = ok && CheckCodeGen(parser, "10 - 4", new List<String> {
-			"  LOAD_rA_iBC r1, 10",
-			"  LOAD_rA_iBC r2, 4",
-			"  SUB_rA_rB_rC r0, r1, r2",
+			"  LOAD_rA_iBC r0, 10",
+			"  LOAD_rA_iBC r1, 4",
+			"  SUB_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test multiplication
 		ok = ok && CheckCodeGen(parser, "6 * 7", new List<String> {
-			"  LOAD_rA_iBC r1, 6",
-			"  LOAD_rA_iBC r2, 7",
-			"  MUL_rA_rB_rC r0, r1, r2",
+			"  LOAD_rA_iBC r0, 6",
+			"  LOAD_rA_iBC r1, 7",
+			"  MUL_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test division
 		ok = ok && CheckCodeGen(parser, "20 / 4", new List<String> {
-			"  LOAD_rA_iBC r1, 20",
-			"  LOAD_rA_iBC r2, 4",
-			"  DIV_rA_rB_rC r0, r1, r2",
+			"  LOAD_rA_iBC r0, 20",
+			"  LOAD_rA_iBC r1, 4",
+			"  DIV_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test comparison (less than)
 		ok = ok && CheckCodeGen(parser, "3 < 5", new List<String> {
-			"  LOAD_rA_iBC r1, 3",
-			"  LOAD_rA_iBC r2, 5",
-			"  LT_rA_rB_rC r0, r1, r2",
+			"  LOAD_rA_iBC r0, 3",
+			"  LOAD_rA_iBC r1, 5",
+			"  LT_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test comparison (greater than - uses swapped LT)
 		ok = ok && CheckCodeGen(parser, "5 > 3", new List<String> {
-			"  LOAD_rA_iBC r1, 5",
-			"  LOAD_rA_iBC r2, 3",
-			"  LT_rA_rB_rC r0, r2, r1",  // swapped: r2 < r1
+			"  LOAD_rA_iBC r0, 5",
+			"  LOAD_rA_iBC r1, 3",
+			"  LT_rA_rB_rC r0, r1, r0",  // swapped: r1 < r0
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test unary minus
-		// r0 = result, r1 = 5, r2 = 0, SUB r0, r2, r1 (result = 0 - 5)
+		// r0 = 5, r1 = 0, SUB r0, r1, r0 (result = 0 - 5, into the operand's register)
 		ok = ok && CheckCodeGen(parser, "-5", new List<String> {
-			"  LOAD_rA_iBC r1, 5",
-			"  LOAD_rA_iBC r2, 0",
-			"  SUB_rA_rB_rC r0, r2, r1",
+			"  LOAD_rA_iBC r0, 5",
+			"  LOAD_rA_iBC r1, 0",
+			"  SUB_rA_rB_rC r0, r1, r0",
 			"  RETURN"
 		}); // CPP: }));
 
@@ -622,24 +651,33 @@ public static class UnitTests {
 		// Test map literal
 		ok = ok && CheckBytecodeGen(parser, "{}", 2, 0);  // MAP + RETURN
 
-		// Test index access (resultReg r0 allocated first)
+		// Test index access (the result reuses the container's register)
 		ok = ok && CheckCodeGen(parser, "x[0]", new List<String> {
-			"  GLOADC_rA_iBC r1, 0",   // x: free name, so a global reference
-			"  LOAD_rA_iBC r2, 0",   // index 0
-			"  IDXGET_rA_rB_rC r0, r1, r2",
+			"  GLOADC_rA_iBC r0, 0",   // x: free name, so a global reference
+			"  LOAD_rA_iBC r1, 0",   // index 0
+			"  IDXGET_rA_rB_rC r0, r0, r1",
 			"  RETURN"
 		}); // CPP: }));
 
 		// Test nested expression (precedence)
-		// 2 + 3 * 4: outer result r0, load 2 into r1, inner mult result r2, load 3,4 into r3,r4
-		// LOAD r1,2; LOAD r3,3; LOAD r4,4; MUL r2,r3,r4; ADD r0,r1,r2; RETURN
+		// 2 + 3 * 4: load 2 into r0, 3 and 4 into r1 and r2, the product into r1
+		// LOAD r0,2; LOAD r1,3; LOAD r2,4; MUL r1,r1,r2; ADD r0,r0,r1; RETURN
 		ok = ok && CheckBytecodeGen(parser, "2 + 3 * 4", 6, 0);
 
 		// Test register reuse with nested expressions
-		// (1 + 2) + (3 + 4): outer r0, first group r1 (with r2,r3 for operands),
-		// second group r2 (reused after freeing r2,r3), with r3,r4 for operands
-		// LOAD r2,1; LOAD r3,2; ADD r1,r2,r3; LOAD r3,3; LOAD r4,4; ADD r2,r3,r4; ADD r0,r1,r2; RETURN
-		ok = ok && CheckBytecodeGen(parser, "(1 + 2) + (3 + 4)", 8, 0);
+		// (1 + 2) + (3 + 4): each sum lands in its left operand's register, so the
+		// whole expression needs only three
+		// LOAD r0,1; LOAD r1,2; ADD r0,r0,r1; LOAD r1,3; LOAD r2,4; ADD r1,r1,r2; ADD r0,r0,r1; RETURN
+		ok = ok && CheckCodeGen(parser, "(1 + 2) + (3 + 4)", new List<String> {
+			"  LOAD_rA_iBC r0, 1",
+			"  LOAD_rA_iBC r1, 2",
+			"  ADD_rA_rB_rC r0, r0, r1",
+			"  LOAD_rA_iBC r1, 3",
+			"  LOAD_rA_iBC r2, 4",
+			"  ADD_rA_rB_rC r1, r1, r2",
+			"  ADD_rA_rB_rC r0, r0, r1",
+			"  RETURN"
+		}); // CPP: }));
 
 		return ok;
 	}
@@ -683,14 +721,14 @@ public static class UnitTests {
 		lexer = new Lexer("42");
 		tok = lexer.NextToken();
 		ok = ok && Assert(tok.Type == TokenType.NUMBER, "Expected NUMBER token");
-		ok = ok && AssertEqual(tok.Text, "42");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "42");
 		ok = ok && AssertEqual(tok.DoubleValue, 42);
 
 		// Test float
 		lexer = new Lexer("3.14");
 		tok = lexer.NextToken();
 		ok = ok && Assert(tok.Type == TokenType.NUMBER, "Expected NUMBER token for float");
-		ok = ok && AssertEqual(tok.Text, "3.14");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "3.14");
 
 		// Test string
 		lexer = new Lexer("\"hello\"");
@@ -704,6 +742,20 @@ public static class UnitTests {
 		ok = ok && Assert(tok.Type == TokenType.IDENTIFIER, "Expected IDENTIFIER token");
 		ok = ok && AssertEqual(tok.Text, "myVar");
 
+		// Test names: keywords only as whole words, and non-ASCII names
+		lexer = new Lexer("ends end naïve x naïve");
+		tok = lexer.NextToken();
+		ok = ok && Assert(tok.Type == TokenType.IDENTIFIER, "Expected IDENTIFIER for 'ends'");
+		ok = ok && AssertEqual(tok.Text, "ends");
+		ok = ok && Assert(lexer.NextToken().Type == TokenType.END, "Expected END");
+		tok = lexer.NextToken();
+		ok = ok && AssertEqual(tok.Text, "naïve");
+		ok = ok && AssertEqual(lexer.NextToken().Text, "x");
+		tok = lexer.NextToken();
+		ok = ok && AssertEqual(tok.Text, "naïve");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "naïve");
+		ok = ok && Assert(lexer.NextToken().Type == TokenType.END_OF_INPUT, "Expected END_OF_INPUT after names");
+
 		// Test operators
 		lexer = new Lexer("+ - * / %");
 		ok = ok && Assert(lexer.NextToken().Type == TokenType.PLUS, "Expected PLUS");
@@ -731,16 +783,16 @@ public static class UnitTests {
 		lexer = new Lexer("42 // this is a comment");
 		tok = lexer.NextToken();
 		ok = ok && Assert(tok.Type == TokenType.NUMBER, "Expected NUMBER before comment");
-		ok = ok && AssertEqual(tok.Text, "42");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "42");
 		tok = lexer.NextToken();
 		ok = ok && Assert(tok.Type == TokenType.COMMENT, "Expected COMMENT token");
-		ok = ok && AssertEqual(tok.Text, "// this is a comment");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "// this is a comment");
 
 		// Test comment-only line
 		lexer = new Lexer("// just a comment");
 		tok = lexer.NextToken();
 		ok = ok && Assert(tok.Type == TokenType.COMMENT, "Expected COMMENT token for comment-only");
-		ok = ok && AssertEqual(tok.Text, "// just a comment");
+		ok = ok && AssertEqual(lexer.TextOf(tok), "// just a comment");
 
 		// Test comment followed by newline and more code
 		lexer = new Lexer("x // comment\ny");
@@ -1086,6 +1138,249 @@ public static class UnitTests {
 		return ok;
 	}
 
+	// ── Cloning an interpreter ──────────────────────────────────────────────────
+
+	// A clone starts with the template's globals -- its classes, functions and
+	// data -- but changes nothing in the template, so every clone starts the
+	// same.  Frozen data is shared rather than copied, and a top-level function
+	// from the template works on the clone's globals, not the template's.
+	public static Boolean TestClone() {
+		Boolean ok = true;
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter prelude;
+		prelude = new Interpreter("Counter = {\"n\": 0}\nCounter.bump = function; self.n += 1; return self.n; end function\nlog = []\ntable = frozenCopy([1, 2, 3])\naddLog = function(x); log.push x; return log.len; end function");
+		prelude.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: prelude.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		prelude.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: prelude.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		prelude.RunUntilDone(10, false);
+		ok = ok && Assert(output.Count == 0, "the template program should print nothing");
+
+		String job = "c = new Counter\nprint c.bump + Counter.bump\nprint addLog(\"a\")\nlog.push \"b\"\nprint log.len\nprint table[2]";
+		for (Int32 run = 0; run < 2; run++) {
+			Interpreter clone = prelude.Clone(job);
+			clone.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+			// CPP: clone.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+			clone.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+			// CPP: clone.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+			ok = ok && Assert(clone.GetGlobalValue("table").RefEquals(prelude.GetGlobalValue("table")),
+				"a frozen global should be shared, not copied");
+			// The copies must be rooted through the clone's globals alone.
+			GCManager.CollectGarbage();
+			clone.RunUntilDone(10, false);
+			ok = ok && AssertEqual(String.Join(" ", output), "2 1 2 3");
+			output.Clear();
+			clone.Reset("");	// (releases its globals)
+		}
+
+		ok = ok && Assert(prelude.GetGlobalValue("log").ListCount() == 0,
+			"the clones' list pushes should not reach the template");
+		ok = ok && Assert(prelude.GetGlobalValue("Counter").MapGet(Value.make_string("n")) == new Value(0),
+			"the clones' map changes should not reach the template");
+
+		if (!ok) IOHelper.Print("TestClone FAILED");
+		return ok;
+	}
+
+	// ── Interpreter pool ─────────────────────────────────────────────────────────
+
+	// A leased interpreter is a returned one, recycled: same VM, and for the
+	// same source no compile at all.  Each job still starts from a fresh copy
+	// of the prelude's globals, with nothing left over from the job before.
+	public static Boolean TestInterpreterPool() {
+		Boolean ok = true;
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter prelude;
+		prelude = new Interpreter("greeting = \"hi\"\nseen = []");
+		prelude.RunUntilDone(10, false);
+
+		InterpreterPool pool = new InterpreterPool(prelude);
+		pool.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: pool.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		pool.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: pool.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+
+		String job = "print globals.hasIndex(\"mine\")\nseen.push 1\nprint greeting + \" \" + seen.len\nmine = 5";
+		Interpreter first = pool.Lease(job);
+		first.RunUntilDone(10, false);
+		VM firstVM = first.vm;
+		pool.Return(first);
+		ok = ok && Assert(pool.IdleCount() == 1, "a returned interpreter should be idle");
+
+		Interpreter second = pool.Lease(job);
+		ok = ok && Assert(pool.IdleCount() == 0, "leasing should take the idle interpreter");
+		ok = ok && Assert(!second.Done(), "the same source should be ready to run without a compile");
+		VM secondVM = second.vm;
+		ok = ok && Assert(secondVM == firstVM, "a recycled interpreter should keep its VM"); // CPP: ok = ok && Assert((void*)secondVM == (void*)firstVM, "a recycled interpreter should keep its VM");
+		GCManager.CollectGarbage();
+		second.RunUntilDone(10, false);
+		pool.Return(second);
+
+		Interpreter third = pool.Lease("print seen.len + mine");
+		third.RunUntilDone(10, false);
+		secondVM = third.vm;
+		ok = ok && Assert(secondVM == firstVM, "a new source should still run on the kept VM"); // CPP: ok = ok && Assert((void*)secondVM == (void*)firstVM, "a new source should still run on the kept VM");
+		pool.Return(third);
+
+		ok = ok && AssertEqual(String.Join(" ", output),
+			"0 hi 1 0 hi 1 Runtime Error: Undefined Identifier: 'mine' is unknown in this context [line 1]");
+		ok = ok && Assert(prelude.GetGlobalValue("seen").ListCount() == 0,
+			"jobs should not change the prelude");
+		pool.Clear();
+
+		if (!ok) IOHelper.Print("TestInterpreterPool FAILED");
+		return ok;
+	}
+
+	// ── Scheduler ────────────────────────────────────────────────────────────────
+
+	// Each task waits three times; one after another that would take 15
+	// seconds, but waiting tasks cost the scheduler nothing, so they all
+	// wait at once.
+	private const String kSchedulerTask = "n = 0\nfor i in range(1, 3)\n  wait 0.05\n  n += 1\n  yield\nend for\nprint n";
+
+	public static Boolean TestScheduler() {
+		Boolean ok = true;
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Scheduler scheduler = new Scheduler();
+		for (Int32 i = 0; i < 100; i++) {
+			Interpreter interp = new Interpreter(kSchedulerTask);
+			interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+			// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+			interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+			// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+			scheduler.Add(interp);
+		}
+		scheduler.RunOnce();
+		ok = ok && Assert(scheduler.WaitingCount() == 100, "every task should be waiting after its first turn");
+		scheduler.RunUntilDone(5);
+		ok = ok && Assert(scheduler.LiveCount() == 0, "all tasks should finish, their waits overlapping");
+		ok = ok && Assert(output.Count == 100 && output[0] == "3" && output[99] == "3",
+			"each task should run to the end");
+		ok = ok && Assert(scheduler.RunTime(0) > 0 && scheduler.RunTime(0) < 1,
+			"a task's run time should count only its turns, not its waits");
+		ok = ok && Assert(scheduler.SecondsToNextWake() == -1, "a finished scheduler has nothing to wake");
+
+		// A wait cut short leaves no deadline behind for the host to sleep on.
+		Interpreter waiter = new Interpreter("wait 10");
+		waiter.RunSlice(0.01);
+		ok = ok && Assert(waiter.vm.SecondsToWake() > 0, "a task in a wait should have a time to wake");
+		waiter.Stop();
+		ok = ok && Assert(waiter.vm.SecondsToWake() == 0, "a stopped task should have no time to wake");
+
+		if (!ok) IOHelper.Print("TestScheduler FAILED");
+		return ok;
+	}
+
+	// The receiver is blocked until the sender's wait is over; the scheduler
+	// should sleep through that rather than spin on it.
+	private const String kSchedulerSender = "c = channel(\"schedulerTestChannel\")\nwait 0.2\nsend c, 42";
+	private const String kSchedulerReceiver = "print receive(channel(\"schedulerTestChannel\"))";
+
+	public static Boolean TestSchedulerBlocked() {
+		Boolean ok = true;
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Scheduler scheduler = new Scheduler();
+		Interpreter sender = new Interpreter(kSchedulerSender);
+		Interpreter receiver = new Interpreter(kSchedulerReceiver);
+		receiver.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: receiver.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		scheduler.Add(sender);
+		Int32 task = scheduler.Add(receiver);
+		scheduler.RunUntilDone(5);
+		ok = ok && Assert(scheduler.LiveCount() == 0 && output.Count == 1 && output[0] == "42",
+			"the receiver should get what the sender sends after its wait");
+		ok = ok && Assert(scheduler.RunTime(task) < 0.1,
+			"a task blocked in receive should not be run over and over");
+
+		if (!ok) IOHelper.Print("TestSchedulerBlocked FAILED");
+		return ok;
+	}
+
+	// ── Binary bytecode round trip ──────────────────────────────────────────────
+
+	// BytecodeCache must reproduce a compiled program exactly: same disassembly
+	// (code, constants, nested function templates), and the same behavior when
+	// run -- including parameter defaults, a frozen-list constant, global names,
+	// an inlined call, and line numbers in a runtime error.  Damaged or edited
+	// data must be rejected.
+	public static Boolean TestBytecodeCache() {
+		Boolean ok = true;
+		String source = new String("f = function(a, b=[1, \"two\"], c=0.25)\n")
+			+ "  return a + b[1] + c\n"
+			+ "end function\n"
+			+ "g = 123456.5\n"
+			+ "print f(\"x\") + \" \" + g\n"
+			+ "print [1,2].len / 0 + undefinedName";
+		Parser parser = new Parser();
+		parser.Init(source, "cached.ms");
+		List<ASTNode> statements = parser.ParseProgram();
+		BytecodeEmitter emitter = new BytecodeEmitter();
+		CodeGenerator generator = new CodeGenerator(emitter);
+		generator.FileName = "cached.ms";
+		generator.CompileProgram(statements, "@main");
+		List<FuncDef> original = generator.GetFunctions();
+
+		UInt64 key = BytecodeCache.SourceKey(source, "cached.ms", false);
+		List<Byte> data = BytecodeCache.Serialize(original, key);
+		ok = ok && Assert(data != null, "program should serialize");
+		if (!ok) return false;
+		List<FuncDef> loaded = BytecodeCache.Deserialize(data, key);
+		ok = ok && Assert(loaded != null, "serialized program should deserialize");
+		if (!ok) return false;
+		FuncDef inner = loaded[1];
+		ok = ok && Assert(inner.LazyConstantsPos >= 0, "constants should be decoded only when needed");
+		ok = ok && AssertEqual(Disassembler.Disassemble(loaded), Disassembler.Disassemble(original));
+		// The call to f is inlined, so @main refers back to f for its guard, and
+		// has an inline range to keep.
+		FuncDef loadedMain = loaded[0];
+		FuncDef originalMain = original[0];
+		ok = ok && Assert(originalMain.InlineRangeCount() == 1, "f(\"x\") should be inlined");
+		ok = ok && Assert(loadedMain.InlineRangeCount() == 1
+			&& loadedMain.InlineRangeStart(0) == originalMain.InlineRangeStart(0)
+			&& loadedMain.InlineRangeEnd(0) == originalMain.InlineRangeEnd(0)
+			&& loadedMain.InlineRangeCallLine(0) == 5, "inline range should survive the round trip");
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter interp = new Interpreter();
+		interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.Reset(loaded);
+		interp.RunUntilDone(10, false);
+		ok = ok && Assert(output.Count == 2 && output[0] == "xtwo0.25 123456.5",
+			StringUtils.Format("deserialized program output: got '{0}'",
+				output.Count > 0 ? output[0] : "(no output)"));
+		ok = ok && Assert(output.Count == 2 && output[1].Contains("line 6"),
+			StringUtils.Format("runtime error should report line 6, got '{0}'",
+				output.Count > 1 ? output[1] : "(no output)"));
+
+		// A different key, or any truncation, is a miss rather than a bad program.
+		List<FuncDef> rejected = BytecodeCache.Deserialize(data, key + 1);
+		ok = ok && Assert(rejected == null, "data for another key should be rejected");
+		// So is a changed byte anywhere in the payload: here, in an operand of
+		// the last instruction, which only the checksum would notice.
+		Int32 last = data.Count - 4;
+		data[last] = (Byte)(data[last] ^ 0x01);
+		rejected = BytecodeCache.Deserialize(data, key);
+		ok = ok && Assert(rejected == null, "data with a changed instruction should be rejected");
+		data[last] = (Byte)(data[last] ^ 0x01);
+		data.RemoveAt(data.Count - 1);
+		rejected = BytecodeCache.Deserialize(data, key);
+		ok = ok && Assert(rejected == null, "truncated data should be rejected");
+
+		if (!ok) IOHelper.Print("TestBytecodeCache FAILED");
+		return ok;
+	}
+
 	// ── Running one program against two global namespaces ────────────────────────
 
 	// Compiled code caches its (name -> slot) resolutions in the FuncDef, guarded
@@ -1199,6 +1494,12 @@ public static class UnitTests {
 		_handleFinalizerCallCount++;
 	}
 
+	// What the handle in TestGCHandle's native object holds, for its Marker.
+	private static Value _handleHeld = Value.Null;
+	private static void TestHandleMarker(object userData) {
+		GCManager.Mark(_handleHeld);
+	}
+
 	public static Boolean TestGCHandle() {
 		Boolean ok = true;
 		_handleFinalizerCallCount = 0;
@@ -1221,10 +1522,271 @@ public static class UnitTests {
 		ok = ok && Assert(_handleFinalizerCallCount == 1,
 			"callback should fire exactly once when handle is collected");
 
+		// A handle with a Marker keeps what its native object holds alive
+		// for as long as the handle is, and no longer.
+		Value held = GCManager.NewHandle(null, TestHandleFinalizer, TestHandleMarker);
+		_handleHeld = Value.make_list(1);
+		_handleHeld.Push(Value.make_string("held by a handle's native object"));
+		GCManager.Handles.Retain(held.ItemIndex());
+		GCManager.CollectGarbage();
+		ok = ok && Assert(GCManager.Lists.IsLiveSlot(_handleHeld.ItemIndex()),
+			"a handle's Marker should keep what it marks alive");
+		GCManager.Handles.Release(held.ItemIndex());
+		GCManager.CollectGarbage();
+		ok = ok && Assert(!GCManager.Lists.IsLiveSlot(_handleHeld.ItemIndex()),
+			"what a swept handle marked should be swept too");
+		ok = ok && Assert(_handleFinalizerCallCount == 2, "the marked handle should be finalized");
+		_handleHeld = Value.Null;
+
 		if (!ok) IOHelper.Print("TestGCHandle FAILED");
 		return ok;
 	}
 
+	// ── Isolates ─────────────────────────────────────────────────────────────────
+
+	// Run by both threads in TestIsolates: enough allocation, and full
+	// collections, that two threads sharing any GC state would trip over it.
+	private const String kIsolateProgram = "words = []\nfor i in range(1, 3000)\n  words.push \"word\" + i\n  if i % 500 == 0 then gc.collect true\nend for\nm = {}\nfor w in words\n  m[w] = w.len\nend for\nprint words.len + \" \" + m.len + \" \" + words[-1] + \" \" + m.word42\nprint words isa list";
+
+	private static List<String> _isolateOutput = null;	// written only by the second thread
+
+	// Body of the second thread: set up this thread's own heap, as any host
+	// thread must, then run the program there.
+	private static void RunIsolate() {
+		GCManager.Init();
+		ErrorTypes.Init();
+		_isolateOutput = new List<String>();
+		Interpreter interp = new Interpreter(kIsolateProgram);
+		interp.standardOutput = (String s, bool eol) => { _isolateOutput.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { _isolateOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { _isolateOutput.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { _isolateOutput.Add(s); });
+		interp.RunUntilDone(60, false);
+	}
+
+	// Two interpreters, each on its own thread with its own GC heap, run at
+	// the same time and must neither see nor disturb each other's objects.
+	public static Boolean TestIsolates() {
+		Boolean ok = true;
+
+		// An object on this thread's heap, to check afterwards.
+		Value kept = Value.make_list(1);
+		kept.Push(Value.make_string("still here after the other isolate ran"));
+		GCManager.AddRoot(kept);
+
+		System.Threading.Thread other = new System.Threading.Thread(RunIsolate); // CPP: std::thread other(&UnitTests::RunIsolate);
+		other.Start(); // CPP:
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter interp = new Interpreter(kIsolateProgram);
+		interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.RunUntilDone(60, false);
+
+		other.Join(); // CPP: other.join();
+
+		List<String> expected = new List<String>();
+		expected.Add("3000 3000 word3000 6");
+		expected.Add("1");
+		ok = ok && AssertEqual(output, expected);
+		ok = ok && AssertEqual(_isolateOutput, expected);
+
+		GCManager.CollectGarbage();
+		ok = ok && Assert(kept.ListCount() == 1
+			&& kept.ListGet(0) == Value.make_string("still here after the other isolate ran"),
+			"an object on this thread's heap should be untouched by the other isolate");
+		GCManager.RemoveRoot(kept);
+
+		if (!ok) IOHelper.Print("TestIsolates FAILED");
+		return ok;
+	}
+
+	// ── Shared heap ──────────────────────────────────────────────────────────────
+
+	// Run by both threads in TestSharedHeap, on a published `data`: lookups
+	// with this isolate's own keys (tiny, interned) in a shared map, full
+	// collections while shared values are in use, and a write that must fail.
+	private const String kSharedProgram = "n = 0\nfor i in range(1, 200)\n  for w in data.words\n    n += data.lookup[w]\n  end for\n  if i % 50 == 0 then gc.collect true\nend for\nprint n\nprint data.words.indexOf(\"gamma_three\") + \" \" + data.lookup.epsilon_two + \" \" + data.nested[1].k\ndata.words.push 5";
+
+	private static Value _sharedData = Value.Null;	// published before the reader starts
+	private static List<String> _sharedOutput = null;	// written only by the reader
+
+	// Body of the reader thread in TestSharedHeap.
+	private static void RunSharedReader() {
+		GCManager.Init();
+		ErrorTypes.Init();
+		_sharedOutput = new List<String>();
+		Interpreter interp = new Interpreter(kSharedProgram);
+		interp.standardOutput = (String s, bool eol) => { _sharedOutput.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { _sharedOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { _sharedOutput.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { _sharedOutput.Add(s); });
+		interp.SetGlobalValue("data", _sharedData);
+		interp.RunUntilDone(60, false);
+	}
+
+	// A frozen value published to the SharedHeap is read, in place, by two
+	// isolates at once; only frozen data can be published.
+	public static Boolean TestSharedHeap() {
+		Boolean ok = true;
+
+		Interpreter maker;
+		maker = new Interpreter("long = \"abcdefghij\" * 13\ndata = {\"words\": [\"alpha\", \"epsilon_two\", \"gamma_three\", long], \"lookup\": {\"alpha\": 1, \"epsilon_two\": 2, \"gamma_three\": 3, long: 4}, \"nested\": [[1, 2], {\"k\": \"v\"}]}\nfreeze data\nscratch = [1, 2]");
+		maker.RunUntilDone(10, false);
+		Value data = maker.GetGlobalValue("data");
+		Value shared;
+		Boolean published = SharedHeap.TryPublish(maker.GetGlobalValue("scratch"), out shared);
+		ok = ok && Assert(!published, "a list that is not frozen should not publish");
+		published = SharedHeap.TryPublish(data, out shared);
+		ok = ok && Assert(published, "a frozen map should publish");
+		ok = ok && Assert(shared.IsShared() && !data.IsShared(), "the published form should be shared");
+		ok = ok && Assert(shared == data, "the published form should equal the original");
+		Value again;
+		published = SharedHeap.TryPublish(shared, out again);
+		ok = ok && Assert(published && again.Bits() == shared.Bits(),
+			"a shared value should be its own published form");
+		_sharedData = shared;
+
+		// A full region refuses a value, and takes none of it.
+		Interpreter moreMaker = new Interpreter("more = [\"another long string, to make a heap string\", [3], {4: 5}]\nfreeze more");
+		moreMaker.RunUntilDone(10, false);
+		Value more = moreMaker.GetGlobalValue("more");
+		Int32 before = SharedHeap.ItemCount();
+		Int32 capacity = SharedHeap.SetCapacity;
+		SharedHeap.SetCapacity = 0;
+		published = SharedHeap.TryPublish(more, out again);
+		ok = ok && Assert(!published && SharedHeap.Shareable(more) && SharedHeap.ItemCount() == before,
+			"a value should not publish, even in part, when the region is full");
+		SharedHeap.SetCapacity = capacity;
+		published = SharedHeap.TryPublish(more, out again);
+		ok = ok && Assert(published && SharedHeap.ItemCount() == before + 4,
+			"a value should publish once there is room");
+
+		System.Threading.Thread other = new System.Threading.Thread(RunSharedReader); // CPP: std::thread other(&UnitTests::RunSharedReader);
+		other.Start(); // CPP:
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter interp = new Interpreter(kSharedProgram);
+		interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.SetGlobalValue("data", shared);
+		interp.RunUntilDone(60, false);
+
+		other.Join(); // CPP: other.join();
+
+		List<String> expected = new List<String>();
+		expected.Add("2000");
+		expected.Add("2 2 v");
+		expected.Add("Runtime Error: Attempt to modify a frozen list [line 10]");
+		ok = ok && AssertEqual(output, expected);
+		ok = ok && AssertEqual(_sharedOutput, expected);
+
+		if (!ok) IOHelper.Print("TestSharedHeap FAILED");
+		return ok;
+	}
+
+	// ── Channels ─────────────────────────────────────────────────────────────────
+
+	// The sender and receiver in TestChannels.  The channel is small, so each
+	// side often finds it full or empty and must wait for the other.
+	private const String kChannelSender = "c = channel(\"unitTestChannel\", 4)\nfor i in range(1, 300)\n  item = {\"i\": i, \"name\": \"item number \" + i, \"tags\": [i % 3, \"x\"]}\n  item.me = item\n  if i % 2 then freeze item\n  send c, item\nend for\nsend c, null";
+	private const String kChannelReceiver = "c = channel(\"unitTestChannel\", 4)\nn = 0\ntotal = 0\nfrozen = 0\nwhile true\n  item = receive(c)\n  if item == null then break\n  n += 1\n  total += item.i + item.tags[0]\n  if item.name != \"item number \" + item.i or not refEquals(item.me, item) then print \"bad item \" + n\n  frozen += isFrozen(item)\n  if n % 100 == 0 then gc.collect true\nend while\nprint n + \" \" + total + \" \" + frozen";
+
+	private static List<String> _channelOutput = null;	// written only by the sender
+
+	// Run an interpreter to the end, resuming it each time it yields.
+	private static void RunYielding(Interpreter interp) {
+		interp.RunUntilDone(60, true);
+		while (!interp.Done()) {
+			System.Threading.Thread.Yield(); // CPP: std::this_thread::yield();
+			interp.RunUntilDone(60, true);
+		}
+	}
+
+	// Body of the sender thread in TestChannels.
+	private static void RunChannelSender() {
+		GCManager.Init();
+		ErrorTypes.Init();
+		_channelOutput = new List<String>();
+		Interpreter interp = new Interpreter(kChannelSender);
+		interp.standardOutput = (String s, bool eol) => { _channelOutput.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { _channelOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { _channelOutput.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { _channelOutput.Add(s); });
+		RunYielding(interp);
+	}
+
+	// Two isolates pass values through a channel: each arrives whole, in
+	// order, as a copy on the receiver's heap, frozen if it was sent frozen.
+	public static Boolean TestChannels() {
+		Boolean ok = true;
+
+		System.Threading.Thread other = new System.Threading.Thread(RunChannelSender); // CPP: std::thread other(&UnitTests::RunChannelSender);
+		other.Start(); // CPP:
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter interp = new Interpreter(kChannelReceiver);
+		interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		RunYielding(interp);
+
+		other.Join(); // CPP: other.join();
+
+		List<String> expected = new List<String>();
+		expected.Add("300 45450 150");
+		ok = ok && AssertEqual(output, expected);
+		ok = ok && AssertEqual(_channelOutput, new List<String>());
+
+		if (!ok) IOHelper.Print("TestChannels FAILED");
+		return ok;
+	}
+
+	// ── Parallel map ─────────────────────────────────────────────────────────────
+
+	// Maps and lists on the way in and out, a nested function, a filter,
+	// garbage collected mid-run, and an error raised by func.
+	private const String kParallelProgram = "describe = function(n)\n  s = \"abcdef\"[:n % 7]\n  return {\"n\": n, \"s\": s, \"tags\": [n % 2, s.len]}\nend function\nr = parallelMap(range(1, 400), @describe, 7)\ntotal = 0\nok = 1\nfor i in r.indexes\n  total += r[i].tags[1]\n  ok = ok and r[i].n == i + 1\nend for\nprint r.len + \" \" + total + \" \" + ok + \" \" + r[5].s\nisOdd = function(m)\n  return m.tags[0]\nend function\nodd = parallelFilter(r, @isOdd, 9)\ngc.collect true\nprint odd.len + \" \" + odd[0].n + \" \" + odd[-1].n\nbad = function(x)\n  return x.foo\nend function\nprint parallelMap(range(1, 300), @bad, 10)";
+
+	// parallelMap with workers forced on (whatever this machine's core
+	// count): results come back whole and in order, and an error on any
+	// thread stops the script.
+	public static Boolean TestParallelMap() {
+		Boolean ok = true;
+		Int32 savedThreadCount = ParallelMap.ThreadCount;
+		ParallelMap.ThreadCount = 3;
+
+		List<String> output = new List<String>();
+		// CPP: gTestOutput = output;
+		Interpreter interp = new Interpreter(kParallelProgram);
+		interp.standardOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.errorOutput = (String s, bool eol) => { output.Add(s); }; // CPP:
+		// CPP: interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.RunUntilDone(60, false);
+
+		ParallelMap.Stop();
+		ParallelMap.ThreadCount = savedThreadCount;
+
+		ok = ok && Assert(output.Count == 3, "parallelMap test should print 3 lines");
+		ok = ok && Assert(output[0] == "400 1198 1 abcdef", "parallelMap results should be whole and in order");
+		ok = ok && Assert(output[1] == "200 1 399", "parallelFilter should keep the right items, in order");
+		// (Raised on a worker or on this thread, whichever got there first.)
+		String prefix = "Runtime Error: Key Not Found: 'foo' not found in map";
+		ok = ok && Assert(output[2].Left(prefix.Length) == prefix, "an error in func should stop the script");
+
+		if (!ok) IOHelper.Print("TestParallelMap FAILED");
+		return ok;
+	}
+
 	// Helper for MayReadVar tests: parse an assignment, then ask its RHS.
 	private static Boolean CheckMayReadVar(Parser parser, String input, String varName, Boolean expected) {
 		ASTNode ast = parser.Parse(input);
@@ -1535,8 +2097,17 @@ public static class UnitTests {
 			&& TestREPL()
 			&& TestResetPreservingGlobals()
 		&& TestHostGlobals()
+		&& TestClone()
+		&& TestInterpreterPool()
+		&& TestScheduler()
+		&& TestSchedulerBlocked()
 		&& TestGlobalsSwitch()
-			&& TestGCHandle();
+		&& TestBytecodeCache()
+			&& TestGCHandle()
+			&& TestIsolates()
+			&& TestSharedHeap()
+			&& TestChannels()
+			&& TestParallelMap();
 	}
 }
 
@@ -12,6 +12,7 @@ using static System.Runtime.CompilerServices.MethodImplOptions;
 // H: #include <chrono>
 // H: #include "GCManager.g.h"
 // H: #include "Globals.g.h"
+// H: #include "Coroutine.g.h"
 // CPP: #include "value_list.h"
 // CPP: #include "value_string.h"
 // CPP: #include "Bytecode.g.h"
@@ -129,6 +130,13 @@ public class VM {
 
 	private Dictionary<String, Value> _intrinsics; // intrinsic name -> FuncRef Value
 
+	// Intrinsics by registry index, for CALLINTRINSIC; and the slot each one's
+	// name has in _globals, or -1 if not looked up yet (valid while
+	// _intrinsicSlotsId is _globals' Id; see IntrinsicSlot).
+	private List<FuncDef> _intrinsicDefs;
+	private List<Int32> _intrinsicSlots;
+	private Int32 _intrinsicSlotsId = 0;
+
 	// Execution state (persistent across RunSteps calls)
 	public Int32 PC { get; private set; }
 	public FuncDef CurrentFunction { get; private set; }
@@ -230,6 +238,36 @@ public class VM {
 	// Set by the "yield" intrinsic; host app can check and clear this.
 	public bool yielding = false;
 
+	// While the "wait" intrinsic is pending: the ElapsedTime at which it is
+	// due to finish.  Nothing happens in the VM before then, so a host need
+	// not run it, and may sleep instead (see SecondsToWake).  Cleared before
+	// each call of an intrinsic's callback, so it only ever describes the
+	// pending call that set it (wait sets it again on every continuation).
+	public double wakeTime = 0;
+
+	// Coroutines (see Coroutine.cs and ResumeCoroutine).  Each has a register
+	// stack and call stack of its own.  They start much smaller than the VM's,
+	// so that thousands can be suspended at once, and grow as the coroutine
+	// goes deeper, up to the size of the VM's own (see GrowStack).
+	public Int32 coroutineStackSlots = 128;
+	public Int32 coroutineCallSlots = 32;
+	private List<Coroutine> _coroutines;	// those running now, innermost last
+	private List<Coroutine> _spareCoroutines;	// finished ones, whose stacks are reused
+
+	// The most registers and call frames any stack may have: the size the
+	// VM's own stacks are made at.  Only a coroutine's stacks are smaller.
+	private Int32 _stackSlotLimit = 0;
+	private Int32 _callSlotLimit = 0;
+	// How many times a stack has grown, and so moved.  RunInner holds a pointer
+	// into the stack (localStack); when anything it calls out to may have run
+	// script code, it compares this with the count it last saw, and finds its
+	// frame again if they differ.
+	private Int32 _stackMoves = 0;
+	private const Int32 MaxSpareCoroutines = 64;
+	private FuncDef _coroutineExit = null;	// a bare RETURN, below each coroutine's function
+	private Boolean _coroutineYielded = false;	// set by yield in a coroutine
+	private Value _coroutineYieldValue = Value.Null;
+
 	// Wall-clock start time, set in Reset(), used by the "time" intrinsic.
 	//*** BEGIN CS_ONLY ***
 	private System.Diagnostics.Stopwatch _stopwatch = new System.Diagnostics.Stopwatch();
@@ -243,6 +281,20 @@ public class VM {
 		return _stopwatch.Elapsed.TotalSeconds; // CPP: return std::chrono::duration<double>(now - _startTime).count();
 	}
 
+	// True when an intrinsic has said it is not done yet (receive on an empty
+	// channel, say), so the next Run will only call it again.
+	public Boolean IsBlocked() {
+		return _pendingCallback != null && !_hasPendingManualCall;
+	}
+
+	// Seconds until a pending wait is due to finish; 0 if the VM is not in a
+	// wait, or the wait is due now.
+	public double SecondsToWake() {
+		if (_pendingCallback == null || wakeTime <= 0) return 0;
+		double seconds = wakeTime - ElapsedTime();
+		return seconds > 0 ? seconds : 0;
+	}
+
 	// Thread-local active VM: set during Run(), so value operations
 	// (like list_push) can report errors via the VM.
 	[ThreadStatic] private static VM _activeVM;
@@ -309,6 +361,10 @@ public class VM {
 		_globals = null;   // created (or adopted) at Reset
 		_globalsId = 0;
 		_pendingCallStack = new List<PendingCallState>();
+		_coroutines = new List<Coroutine>();
+		_spareCoroutines = new List<Coroutine>();
+		_stackSlotLimit = stackSlots;
+		_callSlotLimit = callSlots;
 		Error = Value.Null;
 
 		// Initialize stack with null values
@@ -377,40 +433,69 @@ public class VM {
 	public static void MarkRoots(object user_data) {
 		VM vm = (VM)user_data; // CPP: VM vm(static_cast<VMStorage*>(user_data)->shared_from_this());
 		Int32 liveTop = (vm.CurrentFunction != null) ? vm.BaseIndex + vm.CurrentFunction.MaxRegs : 0;
-		for (Int32 i = 0; i < liveTop; i++) {
-			GCManager.Mark(vm.stack[i]);
-			GCManager.Mark(vm.names[i]);
-		}
+		MarkFrames(vm.stack, vm.names, liveTop, vm.callStack, vm.callStackTop, vm.CurrentFunction);
 		// Intrinsic funcrefs are permanent GC roots (added via GCManager.AddRoot in
 		// Intrinsic.EnsureBuilt), so they don't need to be marked here.
+		GCManager.Mark(vm.ManualCallResult);
+		// The global namespace is not on the register stack, so mark it here.
+		// (Globals.AttachMap also roots the map directly, which covers a Globals
+		// that no VM has adopted yet; this mark is what keeps it alive for a VM
+		// that outlives its creator.)
+		if (vm._globals != null) GCManager.Mark(vm._globals.AsMap());
+		// Manual-call results saved on the pending-call stack (nested imports).
+		MarkPendingCalls(vm._pendingCallStack);
+		// While a coroutine runs, the state of whoever resumed it is kept in
+		// its Coroutine, which nothing else may reach (see Coroutine.cs).
+		for (Int32 i = 0; i < vm._coroutines.Count; i++) MarkCoroutine(vm._coroutines[i]);
+		GCManager.Mark(vm._coroutineYieldValue);
+	}
+
+	// Mark the live registers (below liveTop) of a register stack, and what
+	// its call frames hold.
+	private static void MarkFrames(List<Value> stack, List<Value> names, Int32 liveTop, List<CallInfo> callStack, Int32 callStackTop, FuncDef currentFunc) {
+		for (Int32 i = 0; i < liveTop; i++) {
+			GCManager.Mark(stack[i]);
+			GCManager.Mark(names[i]);
+		}
 		// Mark compile-time constants of every function on the call chain.
 		// Marking a function's constants reaches its nested-function templates
 		// (themselves funcrefs), which cascade through GCFunction.MarkChildren —
 		// so this transitively keeps the whole reachable FuncDef graph alive.
-		vm.MarkFuncConstants(vm.CurrentFunction);
+		MarkFuncConstants(currentFunc);
 		// Mark LocalVarMap and OuterVarMap stored in CallInfo structs, plus the
 		// caller FuncDef recorded in each frame.  These are not reachable from
 		// the stack scan and must be marked explicitly.
-		for (Int32 ci = 0; ci < vm.callStackTop; ci++) {
-			GCManager.Mark(vm.callStack[ci].LocalVarMap);
-			GCManager.Mark(vm.callStack[ci].OuterVarMap);
-			vm.MarkFuncConstants(vm.callStack[ci].ReturnFunc);
+		for (Int32 ci = 0; ci < callStackTop; ci++) {
+			GCManager.Mark(callStack[ci].LocalVarMap);
+			GCManager.Mark(callStack[ci].OuterVarMap);
+			MarkFuncConstants(callStack[ci].ReturnFunc);
 		}
-		GCManager.Mark(vm.ManualCallResult);
-		// The global namespace is not on the register stack, so mark it here.
-		// (Globals.AttachMap also roots the map directly, which covers a Globals
-		// that no VM has adopted yet; this mark is what keeps it alive for a VM
-		// that outlives its creator.)
-		if (vm._globals != null) GCManager.Mark(vm._globals.AsMap());
-		// Manual-call results saved on the pending-call stack (nested imports).
-		for (Int32 pi = 0; pi < vm._pendingCallStack.Count; pi++) {
-			GCManager.Mark(vm._pendingCallStack[pi].ManualResult);
+	}
+
+	private static void MarkPendingCalls(List<PendingCallState> pending) {
+		for (Int32 pi = 0; pi < pending.Count; pi++) {
+			GCManager.Mark(pending[pi].ManualResult);
 		}
 	}
 
+	// Mark the execution state held in a Coroutine: its own, if suspended,
+	// or its resumer's, if running.  (A resumer is inside the resume call, so
+	// its live registers run up to the top of that call's frame.)
+	private static void MarkCoroutine(Coroutine co) {
+		GCManager.Mark(co.Function);
+		if (co.Stack == null) return;
+		Int32 liveTop = (co.CurrentFunction != null) ? co.BaseIndex + co.CurrentFunction.MaxRegs : 0;
+		if (co.NativeFrameTop > liveTop) liveTop = co.NativeFrameTop;
+		MarkFrames(co.Stack, co.Names, liveTop, co.CallStack, co.CallStackTop, co.CurrentFunction);
+		GCManager.Mark(co.PendingSelf);
+		GCManager.Mark(co.PendingSuper);
+		GCManager.Mark(co.ManualCallResult);
+		MarkPendingCalls(co.PendingCallStack);
+	}
+
 	// Mark a function's compile-time constants (used by the GC root scan).
 	// Recursion into nested-function templates happens via GCFunction.MarkChildren.
-	private void MarkFuncConstants(FuncDef func) {
+	private static void MarkFuncConstants(FuncDef func) {
 		if (func == null) return;
 		List<Value> consts = func.Constants;
 		for (Int32 i = 0; i < consts.Count; i++) GCManager.Mark(consts[i]);
@@ -620,6 +705,312 @@ public class VM {
 	}
 
 
+	// ── Coroutines ──────────────────────────────────────────────────────────
+	//
+	// A coroutine runs nested inside the resume call, much as RunFunction runs
+	// its function: ResumeCoroutine swaps the coroutine's registers, call
+	// stack and frame state into the VM (SwapCoroutine), drives RunInner until
+	// the coroutine yields or finishes, and swaps back.  Its function runs as
+	// an ordinary call at depth 1, over a bare RETURN (_coroutineExit) at
+	// depth 0 -- so when the function returns, RunInner ends just as it does
+	// at the end of @main.  A yield is an intrinsic that does not finish
+	// (YieldCoroutine): RunInner stops at once, and the value passed to the
+	// next resume is stored as its result.
+	//
+	// A coroutine that starts a wait, or runs for longer than a batch, also
+	// swaps out, and the resume call is left not done, so the interpreter
+	// waits (or takes its turn) as usual; the resume intrinsic's continuation
+	// then swaps it back in to carry on.  The exception is a resume made under
+	// RunFunction, which must finish before it returns: there, the coroutine
+	// simply runs until it yields or finishes.
+
+	// How many instructions a coroutine runs before it swaps out, letting the
+	// host see the time (see above).
+	private const UInt32 CoroutineBatch = 1000;
+
+	// Make a new coroutine to run func, as a handle for scripts to hold.
+	public static Value MakeCoroutine(Value func) {
+		Coroutine co = new Coroutine();
+		co.Function = func;
+		return GCManager.NewHandle(co, CoroutineFinalizer, MarkCoroutineHandle); // CPP: return GCManager::NewHandle(new Coroutine(co), VMStorage::CoroutineFinalizer, VMStorage::MarkCoroutineHandle);
+	}
+
+	// The coroutine a handle made by MakeCoroutine stands for, or null if the
+	// value is not one.
+	public static Coroutine GetCoroutine(Value v) {
+		if (!v.IsHandle()) return null;
+		GCHandle h = GCManager.GetHandle(v);
+		//*** BEGIN CS_ONLY ***
+		return h.UserData as Coroutine;
+		//*** END CS_ONLY ***
+		/*** BEGIN CPP_ONLY ***
+		if (h.Marker != VMStorage::MarkCoroutineHandle) return nullptr;
+		return *static_cast<Coroutine*>(h.UserData);
+		*** END CPP_ONLY ***/
+	}
+
+	public static void MarkCoroutineHandle(object userData) {
+		Coroutine co = (Coroutine)userData; // CPP: Coroutine co = *static_cast<Coroutine*>(userData);
+		MarkCoroutine(co);
+	}
+
+	public static void CoroutineFinalizer(object userData) {
+		// CPP: delete static_cast<Coroutine*>(userData);
+	}
+
+	// True while a coroutine is running (so yield means "back to the resumer").
+	public Boolean InCoroutine() {
+		return _coroutines.Count > 0;
+	}
+
+	// Stop the running coroutine, giving value to its resumer.  The yield
+	// intrinsic returns what this returns: a result that is not done, which
+	// stops RunInner straight after the call.
+	public IntrinsicResult YieldCoroutine(Value value) {
+		_coroutineYielded = true;
+		_coroutineYieldValue = value;
+		return new IntrinsicResult(Value.Null, false);
+	}
+
+	// Run a coroutine until it yields or finishes, and return what it yielded
+	// or returned.  value is the result of the yield it is suspended in -- or,
+	// when it first starts, its function's first argument (if not null).  The
+	// resume intrinsic passes continuing = true when it is re-invoked after a
+	// previous call was left not done (see above).
+	public IntrinsicResult ResumeCoroutine(Coroutine co, Value value, Boolean continuing) {
+		if (!continuing) {
+			if (co.Status == CoroutineStatus.Dead) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError("resume: the coroutine has finished"));
+			}
+			if (co.Status == CoroutineStatus.Running || co.Status == CoroutineStatus.Normal) {
+				return new IntrinsicResult(ErrorTypes.RuntimeError("resume: the coroutine is already running"));
+			}
+			if (co.Status == CoroutineStatus.NotStarted && !StartCoroutine(co, value)) return IntrinsicResult.Null;
+		}
+		Boolean mustFinish = _hasPendingManualCall;
+		Boolean savedRunning = IsRunning;
+		Value savedError = Error;
+
+		SwapCoroutine(co);
+		if (_coroutines.Count > 0) {
+			Coroutine resumer = _coroutines[_coroutines.Count - 1];
+			resumer.Status = CoroutineStatus.Normal;
+		}
+		_coroutines.Add(co);
+		co.Status = CoroutineStatus.Running;
+		IsRunning = true;
+		Error = Value.Null;
+		if (!continuing && co.YieldResultIndex >= 0) {
+			stack[co.YieldResultIndex] = value;
+			co.YieldResultIndex = -1;
+		}
+
+		Value result = Value.Null;
+		Boolean ready = !continuing || FinishPendingCall();
+		while (true) {
+			if (ready) result = RunInner(mustFinish ? 0 : CoroutineBatch);
+			if (_coroutineYielded || !IsRunning || !mustFinish) break;
+			ready = FinishPendingCall();
+		}
+
+		// Now it has yielded, finished (or failed), or is to carry on later.
+		CoroutineStatus status = CoroutineStatus.Running;
+		if (_coroutineYielded) {
+			status = CoroutineStatus.Suspended;
+			result = _coroutineYieldValue;
+			_coroutineYielded = false;
+			_coroutineYieldValue = Value.Null;
+			co.YieldResultIndex = _pendingResultIndex;
+			_pendingCallback = null;
+		} else if (!IsRunning) {
+			status = CoroutineStatus.Dead;
+		}
+		Value coError = Error;
+
+		_coroutines.RemoveAt(_coroutines.Count - 1);
+		SwapCoroutine(co);
+		if (_coroutines.Count > 0) {
+			Coroutine resumer = _coroutines[_coroutines.Count - 1];
+			resumer.Status = CoroutineStatus.Running;
+		}
+		co.Status = status;
+		IsRunning = savedRunning;
+		Error = savedError;
+
+		if (status == CoroutineStatus.Running) return new IntrinsicResult(Value.Null, false);
+		if (status == CoroutineStatus.Dead) {
+			if (coError.IsError() || ExitRequested) {
+				// Stop the resumer's run too -- surfacing the error there, as
+				// RunFunction does.
+				ReleaseCoroutine(co, false);
+				if (coError.IsError()) Error = coError;
+				IsRunning = false;
+				return IntrinsicResult.Null;
+			}
+			ReleaseCoroutine(co, true);
+		}
+		return new IntrinsicResult(result);
+	}
+
+	// Give a coroutine that has not run yet its stacks, and set up the call
+	// to its function (see above).  Returns false on error.
+	private Boolean StartCoroutine(Coroutine co, Value value) {
+		Value func = co.Function;
+		FuncDef callee = func.FunctionDef();
+		if (callee.MaxRegs > _stackSlotLimit) {
+			RaiseRuntimeError("Stack Overflow");
+			return false;
+		}
+		if (_coroutineExit == null) {
+			_coroutineExit = new FuncDef();
+			_coroutineExit.Name = "@coroutine";
+			_coroutineExit.AddInstruction(BytecodeUtil.INS(Opcode.RETURN), 0);
+			_coroutineExit.MaxRegs = 1;
+		}
+		if (_spareCoroutines.Count > 0) {
+			Coroutine spare = _spareCoroutines[_spareCoroutines.Count - 1];
+			_spareCoroutines.RemoveAt(_spareCoroutines.Count - 1);
+			co.Stack = spare.Stack;
+			co.Names = spare.Names;
+			co.CallStack = spare.CallStack;
+			co.PendingCallStack = spare.PendingCallStack;
+			spare.Stack = null;
+			spare.Names = null;
+			spare.CallStack = null;
+			spare.PendingCallStack = null;
+		} else {
+			List<Value> newRegs = new List<Value>(coroutineStackSlots);
+			List<Value> newNames = new List<Value>(coroutineStackSlots);
+			for (Int32 i = 0; i < coroutineStackSlots; i++) {
+				newRegs.Add(Value.Null);
+				newNames.Add(Value.Null);
+			}
+			List<CallInfo> newFrames = new List<CallInfo>(coroutineCallSlots);
+			for (Int32 i = 0; i < coroutineCallSlots; i++) {
+				newFrames.Add(new CallInfo(0, 0, null));
+			}
+			co.Stack = newRegs;
+			co.Names = newNames;
+			co.CallStack = newFrames;
+			co.PendingCallStack = new List<PendingCallState>();
+		}
+
+		// The function's frame, at base 0, as ProcessArguments + SetupCallFrame
+		// would leave it.
+		List<Value> regs = co.Stack;
+		List<Value> regNames = co.Names;
+		List<CallInfo> frames = co.CallStack;
+		while (regs.Count < callee.MaxRegs) {
+			regs.Add(Value.Null);
+			regNames.Add(Value.Null);
+		}
+		regs[0] = Value.Null;
+		regNames[0] = Value.Null;
+		Int32 paramCount = callee.ParamNames.Count;
+		for (Int32 i = 0; i < paramCount; i++) {
+			regs[1 + i] = (i == 0 && !value.IsNull()) ? value : callee.ParamDefaults[i];
+			regNames[1 + i] = callee.ParamNames[i];
+		}
+		for (Int32 i = paramCount + 1; i < callee.MaxRegs; i++) {
+			regs[i] = Value.Null;
+			regNames[i] = Value.Null;
+		}
+		frames[0] = new CallInfo(0, 0, _coroutineExit);
+		frames[1] = new CallInfo(0, 0, _coroutineExit, 0, func.OuterVars());
+		co.CallStackTop = 2;
+		co.PC = 0;
+		co.BaseIndex = 0;
+		co.CurrentFunction = callee;
+		co.Status = CoroutineStatus.Suspended;
+		return true;
+	}
+
+	// Exchange the VM's registers, call stack and frame state with those
+	// held in a Coroutine (see Coroutine.cs).
+	private void SwapCoroutine(Coroutine co) {
+		List<Value> regs = stack;
+		stack = co.Stack;
+		co.Stack = regs;
+		regs = names;
+		names = co.Names;
+		co.Names = regs;
+		List<CallInfo> frames = callStack;
+		callStack = co.CallStack;
+		co.CallStack = frames;
+		Int32 n = callStackTop;
+		callStackTop = co.CallStackTop;
+		co.CallStackTop = n;
+		n = PC;
+		PC = co.PC;
+		co.PC = n;
+		n = BaseIndex;
+		BaseIndex = co.BaseIndex;
+		co.BaseIndex = n;
+		FuncDef func = CurrentFunction;
+		CurrentFunction = co.CurrentFunction;
+		co.CurrentFunction = func;
+		n = _nativeFrameTop;
+		_nativeFrameTop = co.NativeFrameTop;
+		co.NativeFrameTop = n;
+		Value v = pendingSelf;
+		pendingSelf = co.PendingSelf;
+		co.PendingSelf = v;
+		v = pendingSuper;
+		pendingSuper = co.PendingSuper;
+		co.PendingSuper = v;
+		Boolean b = hasPendingContext;
+		hasPendingContext = co.HasPendingContext;
+		co.HasPendingContext = b;
+
+		NativeCallbackDelegate callback = _pendingCallback;
+		_pendingCallback = co.PendingCallback;
+		co.PendingCallback = callback;
+		func = _pendingCallee;
+		_pendingCallee = co.PendingCallee;
+		co.PendingCallee = func;
+		n = _pendingCalleeBase;
+		_pendingCalleeBase = co.PendingCalleeBase;
+		co.PendingCalleeBase = n;
+		n = _pendingArgCount;
+		_pendingArgCount = co.PendingArgCount;
+		co.PendingArgCount = n;
+		n = _pendingResultIndex;
+		_pendingResultIndex = co.PendingResultIndex;
+		co.PendingResultIndex = n;
+		b = _pendingIsManual;
+		_pendingIsManual = co.PendingIsManual;
+		co.PendingIsManual = b;
+		b = _hasPendingManualCall;
+		_hasPendingManualCall = co.HasPendingManualCall;
+		co.HasPendingManualCall = b;
+		n = _pendingManualCallDepth;
+		_pendingManualCallDepth = co.PendingManualCallDepth;
+		co.PendingManualCallDepth = n;
+		v = ManualCallResult;
+		ManualCallResult = co.ManualCallResult;
+		co.ManualCallResult = v;
+		List<PendingCallState> pending = _pendingCallStack;
+		_pendingCallStack = co.PendingCallStack;
+		co.PendingCallStack = pending;
+	}
+
+	// A coroutine has finished: let go of its stacks, or, if reuse, keep them
+	// for the next one to start (unless enough are kept already).  Reuse only
+	// those of one that returned normally, so that no frame's locals map
+	// still refers to its registers.
+	private void ReleaseCoroutine(Coroutine co, Boolean reuse) {
+		co.CurrentFunction = null;
+		co.CallStackTop = 0;
+		if (reuse && _spareCoroutines.Count < MaxSpareCoroutines) {
+			_spareCoroutines.Add(co);
+		} else {
+			co.Stack = null;
+			co.Names = null;
+			co.CallStack = null;
+			co.PendingCallStack = null;
+		}
+	}
+
 	public void Reset(List<FuncDef> allFunctions) {
 		Reset(allFunctions, null);
 	}
@@ -649,6 +1040,15 @@ public class VM {
 		if (_intrinsics == null) {
 			_intrinsics = new Dictionary<String, Value>();
 			Intrinsic.RegisterAll(_intrinsics);
+			_intrinsicDefs = new List<FuncDef>();
+			_intrinsicSlots = new List<Int32>();
+			Int32 intrinsicCount = Intrinsic.Count();
+			for (Int32 i = 0; i < intrinsicCount; i++) {
+				Intrinsic intr = Intrinsic.GetByIndex(i);
+				Value func = intr.GetFunc();
+				_intrinsicDefs.Add(func.FunctionDef());
+				_intrinsicSlots.Add(-1);
+			}
 		}
 
 		// Basic validation
@@ -657,7 +1057,7 @@ public class VM {
 			return;
 		}
 
-		if (mainFunc.Code.Count == 0) {
+		if (mainFunc.CodeCount() == 0) {
 			IOHelper.Print("Entry function has no code");
 			return;
 		}
@@ -683,9 +1083,12 @@ public class VM {
 
 		// Clear any pending intrinsic/manual-call state left over from an aborted run.
 		_pendingCallback = null;
+		wakeTime = 0;
 		_hasPendingManualCall = false;
 		_pendingIsManual = false;
 		_pendingCallStack.Clear();
+		_coroutines.Clear();
+		_coroutineYielded = false;
 
 		EnsureFrame(BaseIndex, CurrentFunction.MaxRegs);
 
@@ -699,6 +1102,25 @@ public class VM {
 
 	public void Stop() {
 		IsRunning = false;
+		wakeTime = 0;
+	}
+
+	// Stop, and forget the frames of the last run, so that nothing it left in
+	// the registers or call stack is a GC root any more (MarkRoots scans only
+	// the live frames).  The stacks themselves are kept, for the next Reset.
+	public void Idle() {
+		IsRunning = false;
+		CurrentFunction = null;
+		BaseIndex = 0;
+		callStackTop = 0;
+		ManualCallResult = Value.Null;
+		_pendingCallback = null;
+		wakeTime = 0;
+		_hasPendingManualCall = false;
+		_pendingIsManual = false;
+		_pendingCallStack.Clear();
+		_coroutines.Clear();
+		_coroutineYielded = false;
 	}
 
 	// Stop the VM, recording that its code asked the host to exit and with what
@@ -791,23 +1213,49 @@ public class VM {
 		Value result = Value.make_list(8);
 		Int32 callSitePC = PC - 1;
 		if (callSitePC < 0) callSitePC = 0;
-		String curFile = CurrentFunction.FileName;
-		if (curFile == "") curFile = "(current program)";
-		result.Push(Value.make_string(StringUtils.Format("{0} line {1}", curFile, CurrentFunction.GetLineNumber(callSitePC))));
-		// callStack[0] is @main's own frame (not a caller), so stop at i=1.
-		for (Int32 i = CallStackDepth() - 1; i >= 1; i--) {
-			CallInfo ci = GetCallStackFrame(i);
-			FuncDef callerFunc = ci.ReturnFunc;
-			Int32 callerPC = ci.ReturnPC - 1;
-			if (callerPC < 0) callerPC = 0;
-			String callerFile = callerFunc.FileName;
-			if (callerFile == "") callerFile = "(current program)";
-			result.Push(Value.make_string(StringUtils.Format("{0} line {1}", callerFile, callerFunc.GetLineNumber(callerPC))));
+		PushTraceLines(result, CurrentFunction, callSitePC);
+		// callStack[0] is @main's own frame (not a caller), so stop at i=1 --
+		// or, in a coroutine, at i=2, as frame 1 returns to _coroutineExit.
+		// Then go on to the frames of whoever resumed it.
+		Int32 level = _coroutines.Count;
+		PushFrameTraces(result, callStack, callStackTop, level > 0 ? 2 : 1);
+		while (level > 0) {
+			level--;
+			Coroutine resumer = _coroutines[level];
+			callSitePC = resumer.PC - 1;
+			if (callSitePC < 0) callSitePC = 0;
+			PushTraceLines(result, resumer.CurrentFunction, callSitePC);
+			PushFrameTraces(result, resumer.CallStack, resumer.CallStackTop, level > 0 ? 2 : 1);
 		}
 		result.Freeze();
 		return result;
 	}
 
+	// Add the stack-trace entries for the callers recorded in call frames
+	// bottom..top-1, innermost first.
+	private static void PushFrameTraces(Value result, List<CallInfo> frames, Int32 top, Int32 bottom) {
+		for (Int32 i = top - 1; i >= bottom; i--) {
+			CallInfo ci = frames[i];
+			Int32 callerPC = ci.ReturnPC - 1;
+			if (callerPC < 0) callerPC = 0;
+			PushTraceLines(result, ci.ReturnFunc, callerPC);
+		}
+	}
+
+	// Add the stack-trace entry for one frame, stopped at the given PC.  If that
+	// PC is in the body of an inlined call, the frame stands for two: the
+	// inlined function (whose line the line table gives) and, below it, the
+	// caller at the line of the call.
+	private static void PushTraceLines(Value result, FuncDef func, Int32 pc) {
+		String file = func.FileName;
+		if (file == "") file = "(current program)";
+		result.Push(Value.make_string(StringUtils.Format("{0} line {1}", file, func.GetLineNumber(pc))));
+		Int32 callLine = func.GetInlineCallLine(pc);
+		if (callLine > 0) {
+			result.Push(Value.make_string(StringUtils.Format("{0} line {1}", file, callLine)));
+		}
+	}
+
 	// Collect every function reachable from @main, by walking constant pools
 	// for funcref templates.  Used for disassembly and debug output.
 	public List<FuncDef> GetFunctions() {
@@ -822,6 +1270,7 @@ public class VM {
 			if (outList[i].Name == func.Name) return;  // already collected
 		}
 		outList.Add(func);
+		func.EnsureConstants();
 		List<Value> consts = func.Constants;
 		for (Int32 i = 0; i < consts.Count; i++) {
 			if (consts[i].IsFuncRef()) CollectFunctions(consts[i].FunctionDef(), outList);
@@ -840,7 +1289,7 @@ public class VM {
 		return 0;
 	}
 
-	private Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, List<UInt32> code) {
+	private Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, FuncDef caller) {
 		Int32 paramCount = callee.ParamNames.Count;
 
 		// Step 1: Validate argument count (selfParam accounts for the injected self)
@@ -856,7 +1305,7 @@ public class VM {
 		Int32 currentPC = startPC;
 		Value argValue = Value.Null;  // Declared outside loop for GC safety
 		for (Int32 i = 0; i < argCount; i++) {
-			UInt32 argInstruction = code[currentPC];
+			UInt32 argInstruction = caller.CodeAt(currentPC);
 			Opcode argOp = (Opcode)BytecodeUtil.OP(argInstruction);
 
 			argValue = Value.Null;
@@ -968,7 +1417,7 @@ public class VM {
 		}
 
 		// User function: push CallInfo and set up callee frame
-		if (callStackTop >= callStack.Count) {
+		if (callStackTop >= callStack.Count && !GrowCallStack()) {
 			RaiseRuntimeError("Call stack overflow");
 			return -1;
 		}
@@ -989,6 +1438,15 @@ public class VM {
 	// result to stack[absoluteResultIndex] and returns true.  If not done,
 	// stores the pending state for re-invocation and returns false.
 	private bool InvokeNativeCallback(NativeCallbackDelegate callback, FuncDef callee, Int32 calleeBase, Int32 argCount, IntrinsicResult partialResult, Int32 absoluteResultIndex) {
+		// A simple intrinsic always finishes at once, and gets just its argument
+		// registers: no Context, IntrinsicResult, or CStrArena bracket.
+		SimpleCallbackDelegate simple = callee.SimpleCallback;
+		if (simple != null) {
+			Int32 paramCount = callee.ParamNames.Count;
+			Value result = simple(CollectionsMarshal.AsSpan(stack).Slice(calleeBase + 1, paramCount), paramCount); // CPP: Value result = simple(&stack[calleeBase + 1], paramCount);
+			stack[absoluteResultIndex] = result;
+			return true;
+		}
 		Context context = new Context(
 			this, // CPP: *this,
 			stack,
@@ -1002,6 +1460,7 @@ public class VM {
 		// Bracket the callback with a CStrArena mark/reset so any Value::c_str()
 		// the intrinsic makes is freed when it returns (C++ only; see cstr_arena.h).
 		// CPP: CStrArena::Mark _cstrArenaMark = CStrArena::GetMark();
+		wakeTime = 0;
 		IntrinsicResult ir = callback(context, partialResult);
 		// CPP: CStrArena::Reset(_cstrArenaMark);
 		_nativeFrameTop = savedNativeTop;
@@ -1036,40 +1495,11 @@ public class VM {
 		VM previousVM = _activeVM;
 		_activeVM = this;
 
-		// If we have a pending intrinsic continuation, handle it.
-		if (_pendingCallback != null) {
-			if (_hasPendingManualCall) {
-				// A manually-pushed call (e.g. from the import intrinsic) is still
-				// running.  Fall through to RunInner so the module code can execute.
-			} else {
-				// Normal case: re-invoke the pending intrinsic callback.
-				IntrinsicResult partialResult = new IntrinsicResult(stack[_pendingResultIndex], false);
-				if (!InvokeNativeCallback(_pendingCallback, _pendingCallee, _pendingCalleeBase, _pendingArgCount, partialResult, _pendingResultIndex)) {
-					// Still not done; return without running any bytecode
-					_activeVM = previousVM;
-					return Value.Null;
-				}
-				// The continuation completed.  If it was a nested manual call
-				// (import), restore the outer pending call we saved when it was
-				// pushed, so the outer import resumes (its module keeps running,
-				// then its own continuation fires).  Otherwise, just clear.
-				if (_pendingIsManual && _pendingCallStack.Count > 0) {
-					PendingCallState saved = _pendingCallStack[_pendingCallStack.Count - 1];
-					_pendingCallStack.RemoveAt(_pendingCallStack.Count - 1);
-					_pendingCallback = saved.Callback;
-					_pendingCallee = saved.Callee;
-					_pendingCalleeBase = saved.CalleeBase;
-					_pendingArgCount = saved.ArgCount;
-					_pendingResultIndex = saved.ResultIndex;
-					_pendingIsManual = saved.IsManual;
-					_hasPendingManualCall = saved.HasManual;
-					_pendingManualCallDepth = saved.ManualDepth;
-					ManualCallResult = saved.ManualResult;
-				} else {
-					_pendingCallback = null;
-					_pendingIsManual = false;
-				}
-			}
+		// If we have a pending intrinsic continuation, handle it; if it is
+		// still not done, return without running any bytecode.
+		if (!FinishPendingCall()) {
+			_activeVM = previousVM;
+			return Value.Null;
 		}
 
 		Value runResult = RunInner(maxCycles);
@@ -1077,13 +1507,49 @@ public class VM {
 		return runResult;
 	}
 
+	// Re-invoke the pending intrinsic continuation, if there is one.  Returns
+	// false if it is still not done.
+	private Boolean FinishPendingCall() {
+		if (_pendingCallback == null) return true;
+		if (_hasPendingManualCall) {
+			// A manually-pushed call (e.g. from the import intrinsic) is still
+			// running.  Fall through to RunInner so the module code can execute.
+			return true;
+		}
+		// Normal case: re-invoke the pending intrinsic callback.
+		IntrinsicResult partialResult = new IntrinsicResult(stack[_pendingResultIndex], false);
+		if (!InvokeNativeCallback(_pendingCallback, _pendingCallee, _pendingCalleeBase, _pendingArgCount, partialResult, _pendingResultIndex)) {
+			return false;
+		}
+		// The continuation completed.  If it was a nested manual call
+		// (import), restore the outer pending call we saved when it was
+		// pushed, so the outer import resumes (its module keeps running,
+		// then its own continuation fires).  Otherwise, just clear.
+		if (_pendingIsManual && _pendingCallStack.Count > 0) {
+			PendingCallState saved = _pendingCallStack[_pendingCallStack.Count - 1];
+			_pendingCallStack.RemoveAt(_pendingCallStack.Count - 1);
+			_pendingCallback = saved.Callback;
+			_pendingCallee = saved.Callee;
+			_pendingCalleeBase = saved.CalleeBase;
+			_pendingArgCount = saved.ArgCount;
+			_pendingResultIndex = saved.ResultIndex;
+			_pendingIsManual = saved.IsManual;
+			_hasPendingManualCall = saved.HasManual;
+			_pendingManualCallDepth = saved.ManualDepth;
+			ManualCallResult = saved.ManualResult;
+		} else {
+			_pendingCallback = null;
+			_pendingIsManual = false;
+		}
+		return true;
+	}
+
 	private Value RunInner(UInt32 maxCycles) {
 		// Copy instance variables to locals for performance
 		Int32 pc = PC;
 		Int32 baseIndex = BaseIndex;
 		FuncDef currentFunc = CurrentFunction;
 
-		// CPP: Value* stackPtr = &stack[0];
 		// Note: CollectionsMarshal.AsSpan requires .NET 5+; not compatible with Mono.
 		// This gives us direct array access without copying, for performance.
 		
@@ -1095,7 +1561,9 @@ public class VM {
 		Span<Value> localStack = default; // CPP: Value* localStack = nullptr;
 		
 		SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-		// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+		// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+
+		Int32 stackMoves = _stackMoves;
 
 		UInt32 cyclesLeft = maxCycles;
 		if (maxCycles == 0) cyclesLeft--;  // wraps to MAX_UINT32
@@ -1253,7 +1721,12 @@ public class VM {
 							pc = 0;
 							currentFunc = autoCallee;
 							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						} else if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 						}
 					}
 					break;
@@ -1317,7 +1790,49 @@ public class VM {
 							pc = 0;
 							currentFunc = autoCallee;
 							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						} else if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						}
+					}
+					break;
+				}
+
+				case Opcode.LOADC_rA_rB: {
+					// R[A] = R[B], calling the function if the value is a function
+					// reference.  LOADC_rA_rB_kC without the name check: the code
+					// generator uses it for a register it knows holds the value (a
+					// parameter of an inlined function, bound to a temporary), where
+					// there is no variable name to verify.
+					Byte a = BytecodeUtil.Au(instruction);
+					Byte b = BytecodeUtil.Bu(instruction);
+					valB = localStack[b];
+
+					if (!valB.IsFuncRef()) {
+						// Simple case: value is not a funcref, so just copy it
+						localStack[a] = valB;
+					} else {
+						// Value is a funcref — auto-invoke with zero args
+						FuncDef autoCallee = null;
+						Int32 status = AutoInvokeFuncRef(valB, a, pc, baseIndex, currentFunc, ref autoCallee);
+						if (status == -2) {
+							// Native callback pending — exit RunInner
+							cyclesLeft = 0;
+						} else if (status == 0) {
+							// Frame was pushed — switch to callee
+							baseIndex += curFunc.MaxRegs; // CPP: baseIndex += curFuncRaw->MaxRegs;
+							pc = 0;
+							currentFunc = autoCallee;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						} else if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 						}
 					}
 					break;
@@ -1677,7 +2192,12 @@ public class VM {
 							pc = 0;
 							currentFunc = autoCallee;
 							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						} else if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 						}
 					}
 					break;
@@ -2107,6 +2627,21 @@ public class VM {
 					break;
 				}
 
+				case Opcode.IFFUNC_rA_kBC: {
+					// if R[A] is not a funcref to the function of the template at
+					// constants[BC], skip next instruction.  This guards an inlined
+					// call: the captured closure doesn't matter, only which function
+					// the name is bound to right now.
+					Byte a = BytecodeUtil.Au(instruction);
+					UInt16 constIdx = BytecodeUtil.BCu(instruction);
+					FuncDef expected = curConstants[constIdx].FunctionDef();
+					FuncDef actual = localStack[a].FunctionDef();
+					if (actual != expected) { // CPP: if (actual.get_storage() != expected.get_storage()) {
+						pc++; // Skip next instruction
+					}
+					break; // CPP: VM_NEXT();
+				}
+
 				case Opcode.NEXT_rA_rB: {
 					// Advance iterator R[A] to next entry in collection R[B].
 					// If there is a next entry, skip next instruction (the JUMP to end).
@@ -2149,7 +2684,7 @@ public class VM {
 					}
 					UInt32 callInstruction = curCode[callPC];
 					Opcode callOp = (Opcode)BytecodeUtil.OP(callInstruction);
-					if (callOp != Opcode.CALL_rA_rB_rC) {
+					if (callOp != Opcode.CALL_rA_rB_rC && callOp != Opcode.CALLINTRINSIC_rA_rB_iC) {
 						RaiseRuntimeError("ARGBLK must be followed by CALL");
 						return Value.Null;
 					}
@@ -2159,7 +2694,54 @@ public class VM {
 					Byte b = BytecodeUtil.Bu(callInstruction);
 					Byte c = BytecodeUtil.Cu(callInstruction);
 
-					valC = localStack[c];  // func ref
+					if (callOp == Opcode.CALLINTRINSIC_rA_rB_iC) {
+						// CALLINTRINSIC r[A], r[B], C: call intrinsic C, frame at r[B],
+						// result to r[A].  While its name still means the intrinsic
+						// here -- nothing in front of globals could shadow it (the
+						// frame test GLOADC makes), and its global slot is unassigned
+						// -- call its SimpleCallback on the arguments in place: no
+						// funcref to load, and no Context to build.  Otherwise, call
+						// whatever the name means now, as CALL would.
+						if (c >= _intrinsicDefs.Count) {
+							RaiseRuntimeError("CALLINTRINSIC: Unknown intrinsic");
+							return Value.Null;
+						}
+						FuncDef intrinsic = _intrinsicDefs[c];
+						Int32 slot = (_intrinsicSlotsId == _globalsId) ? _intrinsicSlots[c] : -1;
+						if (slot < 0) slot = IntrinsicSlot(c);
+						Boolean frameClear = (callStackTop <= 1 || GlobalFastPath());
+						Int32 paramCount = intrinsic.ParamNames.Count;
+						if (frameClear && !hasPendingContext && argCount <= paramCount && _globals.ValueAtSlot(slot).IsUnassigned()) {
+							Int32 argBase = baseIndex + b + 1;
+							if (!EnsureFrame(baseIndex + b, intrinsic.MaxRegs)) return Value.Null;
+							if (stackMoves != _stackMoves) {
+								// Making room for the frame grew the stack; find this frame again.
+								stackMoves = _stackMoves;
+								SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+								// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+							}
+							for (Int32 i = 0; i < argCount; i++) {
+								UInt32 argInstruction = curCode[pc + i];
+								if ((Opcode)BytecodeUtil.OP(argInstruction) == Opcode.ARG_rA) {
+									stack[argBase + i] = localStack[BytecodeUtil.Au(argInstruction)];
+								} else {
+									stack[argBase + i] = new Value(BytecodeUtil.ABCs(argInstruction));
+								}
+							}
+							for (Int32 i = argCount; i < paramCount; i++) {
+								stack[argBase + i] = intrinsic.ParamDefaults[i];
+							}
+							SimpleCallbackDelegate simple = intrinsic.SimpleCallback;
+							val = simple(localStack.Slice(b + 1, paramCount), paramCount); // CPP: val = simple(localStack + b + 1, paramCount);
+							localStack[a] = val;
+							pc = callPC + 1;
+							break;
+						}
+						valC = LookupVariable(_globals.NameAtSlot(slot));
+						if (!IsRunning) return Value.Null;
+					} else {
+						valC = localStack[c];  // func ref
+					}
 					if (!valC.IsFuncRef()) {
 						RaiseRuntimeError("ARGBLK/CALL: Not a function reference");
 						return Value.Null;
@@ -2180,7 +2762,7 @@ public class VM {
 					// defaults into it (otherwise deep recursion writes out of range).
 					if (!EnsureFrame(calleeBase, callee.MaxRegs)) return Value.Null;
 					Int32 nextPC = ProcessArguments(argCount, selfParam, pc, baseIndex, calleeBase, callee,
-					  curFunc.Code); // CPP: curFuncRaw->Code);
+					  currentFunc);
 					if (nextPC < 0) return Value.Null; // Error already raised
 					if (selfParam > 0) {
 						stack[calleeBase + 1] = pendingSelf;
@@ -2204,16 +2786,22 @@ public class VM {
 								baseIndex = BaseIndex;
 								currentFunc = CurrentFunction;
 								SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-								// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+								// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 							} else {
 								cyclesLeft = 0;
 							}
 						}
+						if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						}
 						break;
 					}
 
 					// Now execute the CALL (step 6): push CallInfo and switch to callee
-					if (callStackTop >= callStack.Count) {
+					if (callStackTop >= callStack.Count && !GrowCallStack()) {
 						RaiseRuntimeError("Call stack overflow");
 						break;
 					}
@@ -2226,7 +2814,7 @@ public class VM {
 					currentFunc = callee; // Switch to callee function
 					pc = 0; // Start at beginning of callee code
 					SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					break;
 				}
 
@@ -2259,7 +2847,7 @@ public class VM {
 					}
 
 					// Push return info
-					if (callStackTop >= callStack.Count) {
+					if (callStackTop >= callStack.Count && !GrowCallStack()) {
 						RaiseRuntimeError("Call stack overflow");
 						break;
 					}
@@ -2271,12 +2859,13 @@ public class VM {
 					// Note: ApplyPendingContext skipped for CALLF (only needed for method dispatch via CALL)
 					pc = 0; // Start at beginning of callee code
 					currentFunc = callee; // Switch to callee function
-					SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
 
 					// No frame writes happen before the next opcode, so just verify
-					// (it raises and halts on overflow) and fall through to break.
+					// (it raises and halts on overflow).  That may grow the stack, so
+					// switch frames after it.
 					EnsureFrame(baseIndex, callee.MaxRegs);
+					SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					break;
 				}
 
@@ -2325,15 +2914,21 @@ public class VM {
 								baseIndex = BaseIndex;
 								currentFunc = CurrentFunction;
 								SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-								// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+								// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 							} else {
 								cyclesLeft = 0;
 							}
 						}
+						if (stackMoves != _stackMoves) {
+							// The intrinsic ran script code that grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+							// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						}
 						break;
 					}
 
-					if (callStackTop >= callStack.Count) {
+					if (callStackTop >= callStack.Count && !GrowCallStack()) {
 						RaiseRuntimeError("Call stack overflow");
 						break;
 					}
@@ -2345,7 +2940,13 @@ public class VM {
 					pc = 0; // Start at beginning of callee code
 					currentFunc = callee; // Switch to callee function
 					SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					break;
+				}
+
+				case Opcode.CALLINTRINSIC_rA_rB_iC: {
+					// Like ARG, this is processed as part of the ARGBLK opcode.
+					RaiseRuntimeError("Internal error: CALLINTRINSIC without ARGBLK");
 					break;
 				}
 
@@ -2585,7 +3186,12 @@ public class VM {
 						pc = 0;
 						currentFunc = autoCallee;
 						SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-						// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+						// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					} else if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
+						// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					}
 					break; // CPP: VM_NEXT();
 				}
@@ -2618,7 +3224,7 @@ public class VM {
 					baseIndex = callInfo.ReturnBase;
 					currentFunc = callInfo.ReturnFunc;
 					SwitchFrame(currentFunc, baseIndex, ref curFunc, ref codeCount, ref curCode, ref curConstants, ref localStack); // CPP:
-					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+					// CPP: SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 
 					if (callInfo.CopyResultToReg >= 0) {
 						stack[baseIndex + callInfo.CopyResultToReg] = val;
@@ -2657,6 +3263,51 @@ public class VM {
 					break;
 				}
 
+				case Opcode.ITERNEXT_rA_rB_rC: {
+					// NEXT and ITERGET fused: advance iterator R[C] over container
+					// R[B]; if there is a next entry, load it into R[A] and skip the
+					// next instruction (the JUMP to the end of the loop).  This is
+					// what `for` loops emit, so each iteration is one dispatch.
+					//
+					// A computed numeric list -- what `range` returns -- is stepped
+					// with plain Double arithmetic, read in place: no materializing,
+					// no copy of the GCList, no generic Value math per element.
+					Byte a = BytecodeUtil.Au(instruction);
+					Byte b = BytecodeUtil.Bu(instruction);
+					Byte c = BytecodeUtil.Cu(instruction);
+					Int32 iter = localStack[c].IntValue();
+					valB = localStack[b];  // collection
+					if (valB.IsList()) {
+						Double rangeBase;
+						Double rangeStep;
+						Int32 rangeCount;
+						iter++;
+						if (GCManager.Lists.GetRange(valB.ItemIndex(), out rangeBase, out rangeStep, out rangeCount)) {
+							if (iter < rangeCount) {
+								localStack[a] = new Value(rangeBase + rangeStep * iter);
+								pc++;
+							}
+						} else if (iter < valB.ListCount()) {
+							localStack[a] = valB.ListGet(iter);
+							pc++;
+						}
+					} else if (valB.IsMap()) {
+						iter = valB.IterNext(iter);
+						if (iter != Value.MAP_ITER_DONE) {
+							localStack[a] = valB.IterEntry(iter);
+							pc++;
+						}
+					} else if (valB.IsString()) {
+						iter++;
+						if (iter < valB.Length()) {
+							localStack[a] = valB.Substring(iter, 1);
+							pc++;
+						}
+					}
+					localStack[c] = new Value(iter);
+					break;
+				}
+
 				case Opcode.ERRCHK_rA: {
 					// Halt if R[A] holds an error.  Emitted after any expression
 					// compiled as a bare statement: its value goes nowhere, so an
@@ -2691,13 +3342,39 @@ public class VM {
 	// opcode handler on its own.
 	[MethodImpl(AggressiveInlining)]
 	private bool EnsureFrame(Int32 baseIndex, UInt16 neededRegs) {
-		if (baseIndex + neededRegs > stack.Count) {
+		if (baseIndex + neededRegs > stack.Count && !GrowStack(baseIndex + neededRegs)) {
 			RaiseRuntimeError("Stack Overflow");
 			return false;
 		}
 		return true;
 	}
 
+	// Make the register stack at least `needed` slots long, if that is within
+	// _stackSlotLimit (so this only ever grows a coroutine's).  It at least
+	// doubles, so a deepening recursion moves it only a few times; each move
+	// bumps _stackMoves.  Returns false if the limit is in the way.
+	private bool GrowStack(Int32 needed) {
+		if (needed > _stackSlotLimit) return false;
+		Int32 newCount = stack.Count * 2;
+		if (newCount < needed) newCount = needed;
+		if (newCount > _stackSlotLimit) newCount = _stackSlotLimit;
+		while (stack.Count < newCount) {
+			stack.Add(Value.Null);
+			names.Add(Value.Null);
+		}
+		_stackMoves++;
+		return true;
+	}
+
+	// Likewise for the call stack, which nothing holds a pointer into.
+	private bool GrowCallStack() {
+		if (callStack.Count >= _callSlotLimit) return false;
+		Int32 newCount = callStack.Count * 2;
+		if (newCount > _callSlotLimit) newCount = _callSlotLimit;
+		while (callStack.Count < newCount) callStack.Add(new CallInfo(0, 0, null));
+		return true;
+	}
+
 	// Switch all frame-local execution state to the given function.
 	//*** BEGIN CS_ONLY ***
 	[MethodImpl(AggressiveInlining)]
@@ -2710,27 +3387,35 @@ public class VM {
 		CurrentFunction = currentFunc;
 		BaseIndex = baseIndex;
 		curFunc = currentFunc;
+		if (curFunc.LazyConstantsPos >= 0) curFunc.EnsureConstants();
 		codeCount = curFunc.Code.Count;
 		curCode = curFunc.Code;
 		curConstants = curFunc.Constants;
 		localStack = CollectionsMarshal.AsSpan(stack).Slice(baseIndex);
 	}
 	//*** END CS_ONLY ***
-	// H: void SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex, FuncDefStorage* &curFuncRaw, Int32 &codeCount, UInt32* &curCode, Value* &curConstants, Value* &localStack, Value* stackPtr);
+	// H: void SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex, FuncDefStorage* &curFuncRaw, Int32 &codeCount, UInt32* &curCode, Value* &curConstants, Value* &localStack);
 	/*** BEGIN CPP_ONLY ***
 	FORCE_INLINE void VMStorage::SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex,
 			FuncDefStorage* &curFuncRaw, Int32 &codeCount,
 			UInt32* &curCode, Value* &curConstants,
-			Value* &localStack, Value* stackPtr) {
+			Value* &localStack) {
 		// Keep the frame-identifying fields current at every frame switch, so
 		// BuildStackTrace is accurate at any point (paired with PC = pc in the loop).
 		CurrentFunction = currentFunc;
 		BaseIndex = baseIndex;
 		curFuncRaw = currentFunc.get_storage();
-		codeCount = curFuncRaw->Code.Count();
-		curCode = &curFuncRaw->Code[0];
+		if (curFuncRaw->LazyConstantsPos >= 0) curFuncRaw->EnsureConstants();
+		if (curFuncRaw->BorrowedCode) {
+			// Code left in place in a mapped bytecode-cache file (see FuncDef).
+			codeCount = curFuncRaw->BorrowedCount;
+			curCode = (UInt32*)curFuncRaw->BorrowedCode;
+		} else {
+			codeCount = curFuncRaw->Code.Count();
+			curCode = &curFuncRaw->Code[0];
+		}
 		curConstants = curFuncRaw->Constants.Count() > 0 ? &curFuncRaw->Constants[0] : nullptr;
-		localStack = stackPtr + baseIndex;
+		localStack = &stack[0] + baseIndex;
 	}
 	*** END CPP_ONLY ***/
 
@@ -2771,16 +3456,42 @@ public class VM {
 		return frame.OuterVarMap.RefEquals(_globals.AsMap());
 	}
 
+	// The slot the name of intrinsic idx has in _globals (made, unassigned, if
+	// the name has none yet), for CALLINTRINSIC to check that no global has
+	// taken the name.  Looked up once per intrinsic per namespace, as
+	// ResolveGlobalRef does for a function's references.
+	private Int32 IntrinsicSlot(Int32 idx) {
+		if (_intrinsicSlotsId != _globalsId) {
+			for (Int32 i = 0; i < _intrinsicSlots.Count; i++) _intrinsicSlots[i] = -1;
+			_intrinsicSlotsId = _globalsId;
+		}
+		Int32 slot = _intrinsicSlots[idx];
+		if (slot < 0) {
+			FuncDef def = _intrinsicDefs[idx];
+			slot = _globals.Resolve(Value.make_string(def.Name));
+			_intrinsicSlots[idx] = slot;
+		}
+		return slot;
+	}
+
 	// A global reference whose slot is unassigned: either the name has never been
 	// bound, or it was removed.  Intrinsics deliberately do not occupy slots (so
 	// `globals.indexes` does not list 150 built-ins), so this is where they are
-	// found -- one never-taken branch on the hot path, and the same cost as the
-	// intrinsic step of LookupVariable when it is taken.
+	// found.  The name is looked up only the first time: the function remembers
+	// the intrinsic the reference resolved to (FuncDef.GlobalIntrinsics), so
+	// calling `len` in a loop costs the slot check and a list index per iteration
+	// rather than a string hash.
 	private Value GlobalMiss(FuncDef func, Int32 refIdx) {
+		Value cached = func.GlobalIntrinsics[refIdx];
+		if (!cached.IsNull()) return cached;
+
 		Value name = func.GlobalNames[refIdx];
 		Value result;
 		String nameStr = name.AsCString();
-		if (_intrinsics.TryGetValue(nameStr, out result)) return result;
+		if (_intrinsics.TryGetValue(nameStr, out result)) {
+			func.GlobalIntrinsics[refIdx] = result;
+			return result;
+		}
 
 		// self/super read as null outside a method, matching LookupVariable.
 		if (name == Value.selfString || name == Value.superString) return Value.Null;
@@ -112,12 +112,12 @@ public struct VMVis {
 
 		// Draw code, with current line in bold
 		Int32 startLine = Math.Max(0, pc - (_screenHeight - 4) / 2);
-		Int32 endLine = Math.Min(func.Code.Count - 1, startLine + _screenHeight - 4);
+		Int32 endLine = Math.Min(func.CodeCount() - 1, startLine + _screenHeight - 4);
 
 		for (Int32 i = startLine; i <= endLine; i++) {
 			String prefix = (i == pc) ? "PC: " + Bold : "    ";
 			String addr = StringUtils.ZeroPad(i, 4);
-			String instruction = Disassembler.ToString(func.Code[i]);
+			String instruction = Disassembler.ToString(func.CodeAt(i));
 			String line = prefix + addr + ": " + instruction;
 			if (i == pc) line += Normal;
 
@@ -155,7 +155,14 @@ public readonly struct Value {
 	public static Value make_gc(int gcSet, int itemIdx) =>
 		FromBits(GC_TAG | ((ulong)gcSet << 32) | (uint)itemIdx);
 
-	public static Value make_string(string str) {
+	public static Value make_string(string str) => make_string(str, false);
+
+	// As make_string, but a heap string under InternThreshold is interned, so
+	// equal ones are the same Value.  For literals and identifiers; strings
+	// built at run time are interned only if stored as a map key (GCMap.Set).
+	public static Value make_interned_string(string str) => make_string(str, true);
+
+	private static Value make_string(string str, bool intern) {
 		// A null string makes the empty string, not a crash.  This matches the
 		// C++ side, where String::c_str() on a null String already yields "".
 		if (str == null) str = "";
@@ -165,7 +172,7 @@ public readonly struct Value {
 			int byteCount = Encoding.UTF8.GetBytes(str, buf);
 			if (byteCount <= 5) return make_tiny_utf8(buf.Slice(0, byteCount));
 		}
-		if (str.Length < GCManager.InternThreshold) return GCManager.InternString(str);
+		if (intern && str.Length < GCManager.InternThreshold) return GCManager.InternString(str);
 		return GCManager.NewString(str);
 	}
 
@@ -286,6 +293,11 @@ public readonly struct Value {
 	public bool IsInternedString() =>
 		(_u & GC_TYPE_MASK) == (GC_TAG | ((ulong)GCManager.InternedStringSet << 32));
 
+	// True for a string, list or map published to the SharedHeap, which any
+	// isolate may read (see cs/SharedHeap.cs).
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	public bool IsShared() => IsGCObject() && ItemIndex() >= SharedHeap.FirstIndex;
+
 	// ==== NUMERIC ACCESSORS ==================================================
 	[MethodImpl(MethodImplOptions.AggressiveInlining)]
 	public int AsInt() => (int)AsDouble();
@@ -691,10 +703,15 @@ public readonly struct Value {
 	private static bool ScalarEqual(Value a, Value b) {
 		if (a.RefEquals(b)) return true;
 		if (a.IsNumber() && b.IsNumber()) return a.AsDouble() == b.AsDouble();
-		// Two tiny strings with differing bits already differ in content.
-		if (a.IsTinyString() && b.IsTinyString()) return false;
-		if (a.IsString() && b.IsString())
+		if (a.IsString() && b.IsString()) {
+			// A string that fits in a tiny string always is one, and two
+			// interned strings are equal only if they are the same slot.  So
+			// differing bits decide those cases; any other pair of heap strings
+			// is compared by content.
+			if (a.IsTinyString() || b.IsTinyString()) return false;
+			if (a.IsInternedString() && b.IsInternedString()) return false;
 			return string.Equals(a.AsCString(), b.AsCString(), StringComparison.Ordinal);
+		}
 		if (a.IsNull() && b.IsNull()) return true;
 		// Same-type non-container reference values compare by identity; RefEquals
 		// already failed above, so two distinct such values are not equal.
@@ -740,6 +757,8 @@ public readonly struct Value {
 				int aCount = pa.ListCount();
 				if (pb.ListCount() != aCount) return false;
 				if (pa.RefEquals(pb)) continue;  // same list object: nothing to do
+				// Two frozen lists carry cached hashes; differing ones settle it.
+				if (pa.IsFrozen() && pb.IsFrozen() && ListHash(pa) != ListHash(pb)) return false;
 				for (int i = 0; i < aCount; i++) {
 					var np = new ValuePair { a = pa.ListGet(i), b = pb.ListGet(i) };
 					if (!visited.Contains(np)) toDo.Push(np);
@@ -750,6 +769,7 @@ public readonly struct Value {
 				GCMap mapB = GCManager.Maps.Get(pb.ItemIndex());
 				if (mapA.Count() != mapB.Count()) return false;
 				if (pa.RefEquals(pb)) continue;  // same map object: nothing to do
+				if (mapA.Frozen && mapB.Frozen && MapHash(pa) != MapHash(pb)) return false;
 				for (int iter = mapA.NextEntry(-1); iter != -1; iter = mapA.NextEntry(iter)) {
 					Value key = mapA.KeyAt(iter);
 					if (!mapB.TryGet(key, out Value bVal)) return false;
@@ -1052,18 +1072,17 @@ public readonly struct Value {
 
 	public int IterNext(int iter) {
 		if (!IsMap() || iter == MAP_ITER_DONE) return MAP_ITER_DONE;
-		int next = GCManager.Maps.Get(ItemIndex()).NextEntry(iter);
+		int next = GCManager.Maps.NextEntry(ItemIndex(), iter);
 		return next == -1 ? MAP_ITER_DONE : next;
 	}
 
 	public Value IterEntry(int iter) {
 		if (!IsMap() || iter == MAP_ITER_DONE) return Value.Null;
-		GCMap m = GCManager.Maps.Get(ItemIndex());
-		Value key = m.KeyAt(iter);
-		Value val = m.ValueAt(iter);
+		Value key = GCManager.Maps.KeyAt(ItemIndex(), iter);
+		Value val = GCManager.Maps.ValueAt(ItemIndex(), iter);
 		Value result = make_map(4);
-		result.MapSet("key",   key);
-		result.MapSet("value", val);
+		result.MapSet(keyString,   key);
+		result.MapSet(valueString, val);
 		return result;
 	}
 
@@ -1150,18 +1169,16 @@ public readonly struct Value {
 	}
 
 	// ==== MAP CONCAT =========================================================
+	// The result starts as a wholesale copy of a's table; b's entries are then
+	// stored over it in one bulk pass (see GCMap.CopyItems / SetAll).
 	public Value MapConcat(Value b) {
 		Value a = this;
-		Value result = make_map(0);
-		if (a.IsMap()) {
-			GCMap mapA = GCManager.Maps.Get(a.ItemIndex());
-			for (int iter = mapA.NextEntry(-1); iter != -1; iter = mapA.NextEntry(iter))
-				result.MapSet(mapA.KeyAt(iter), mapA.ValueAt(iter));
-		}
+		Value result = a.IsMap()
+			? GCManager.NewMapFromDict(GCManager.Maps.Get(a.ItemIndex()).CopyItems())
+			: make_map(0);
 		if (b.IsMap()) {
-			GCMap mapB = GCManager.Maps.Get(b.ItemIndex());
-			for (int iter = mapB.NextEntry(-1); iter != -1; iter = mapB.NextEntry(iter))
-				result.MapSet(mapB.KeyAt(iter), mapB.ValueAt(iter));
+			GCMap dst = GCManager.Maps.Get(result.ItemIndex());
+			dst.SetAll(GCManager.Maps.Get(b.ItemIndex()));
 		}
 		return result;
 	}
@@ -1335,12 +1352,11 @@ public readonly struct Value {
 
 	public static bool map_iterator_next(ref MapIterator iter) {
 		if (iter.MapIndex < 0 || iter.Iter == MAP_ITER_DONE) return false;
-		int next = GCManager.Maps.Get(iter.MapIndex).NextEntry(iter.Iter);
+		int next = GCManager.Maps.NextEntry(iter.MapIndex, iter.Iter);
 		if (next == -1) { iter.Iter = MAP_ITER_DONE; return false; }
 		iter.Iter = next;
-		GCMap m = GCManager.Maps.Get(iter.MapIndex);
-		iter.Key = m.KeyAt(next);
-		iter.Val = m.ValueAt(next);
+		iter.Key = GCManager.Maps.KeyAt(iter.MapIndex, next);
+		iter.Val = GCManager.Maps.ValueAt(iter.MapIndex, next);
 		return true;
 	}
 
@@ -1362,12 +1378,63 @@ public readonly struct Value {
 	}
 
 	public override int GetHashCode() {
-		if (this.IsString()) {
-			string s = GCManager.GetStringContent(this);
-			return s.GetHashCode(System.StringComparison.Ordinal);
-		}
+		if (IsInternedString()) return (int)GCManager.InternedStrings.GetHash(ItemIndex());
+		if (this.IsString()) return (int)StringHash(GCManager.GetStringContent(this));
+		if (IsList()) return (int)ListHash(this);
+		if (IsMap()) return (int)MapHash(this);
 		return (int)(_u ^ (_u >> 32));
 	}
+
+	// Hash of a value as an element of a list or map.  Nested containers
+	// contribute only their type and count, which keeps container hashing O(n)
+	// and cycle-safe, and lets a frozen container cache its hash.
+	private static uint ShallowHash(Value v) {
+		if (v.IsList()) return 0x4C495354u ^ (uint)v.ListCount();
+		if (v.IsMap()) return 0x4D415020u ^ (uint)v.MapCount();
+		return (uint)v.GetHashCode();
+	}
+
+	// Content hash of a list: an ordered combine of its elements' shallow
+	// hashes, cached in the GCList once the list is frozen (0 = not cached).
+	private static uint ListHash(Value v) {
+		int idx = v.ItemIndex();
+		uint h = GCManager.Lists.GetHashCache(idx);
+		if (h != 0) return h;
+		GCList list = GCManager.Lists.Get(idx);
+		int n = list.Count();
+		h = 0x4C495354u ^ (uint)n;
+		unchecked {
+			for (int i = 0; i < n; i++) h = (h ^ ShallowHash(list.Get(i))) * 16777619u;
+		}
+		if (h == 0) h = 1;
+		if (list.Frozen) GCManager.Lists.SetHashCache(idx, h);
+		return h;
+	}
+
+	// Content hash of a map: an order-independent sum over its entries, cached
+	// in the GCMap once the map is frozen, as with ListHash.
+	private static uint MapHash(Value v) {
+		int idx = v.ItemIndex();
+		uint h = GCManager.Maps.GetHashCache(idx);
+		if (h != 0) return h;
+		GCMap map = GCManager.Maps.Get(idx);
+		h = 0x4D415020u ^ (uint)map.Count();
+		unchecked {
+			for (int iter = map.NextEntry(-1); iter != -1; iter = map.NextEntry(iter)) {
+				uint kh = ShallowHash(map.KeyAt(iter)) * 0x9E3779B1u;
+				h += (kh ^ (kh >> 15)) ^ ShallowHash(map.ValueAt(iter));
+			}
+		}
+		if (h == 0) h = 1;
+		if (map.Frozen) GCManager.Maps.SetHashCache(idx, h);
+		return h;
+	}
+
+	// Content hash of a string, as GetHashCode computes it for a string Value.
+	// GCManager.InternString stores this with each interned string.
+	public static uint StringHash(string s) {
+		return (uint)s.GetHashCode(System.StringComparison.Ordinal);
+	}
 	
 	// And Hash, provided for compatibility with 1.0.
 	public int Hash() { return GetHashCode(); }
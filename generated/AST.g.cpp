@@ -85,6 +85,10 @@ String IdentifierNodeStorage::ToStr() {
 }
 ASTNode IdentifierNodeStorage::Simplify() {
 	IdentifierNode _this(std::static_pointer_cast<IdentifierNodeStorage>(shared_from_this()));
+	// The keywords true and false are just the numbers 1 and 0 (the code
+	// generator loads them that way), so folding can see through them.
+	if (Name == "true") return CopyLine( NumberNode::New(1));
+	if (Name == "false") return CopyLine( NumberNode::New(0));
 	return _this;
 }
 Boolean IdentifierNodeStorage::MayReadVar(String varName) {
@@ -159,10 +163,10 @@ ASTNode UnaryOpNodeStorage::Simplify() {
 	NumberNode num = As<NumberNode, NumberNodeStorage>(simplifiedOperand);
 	if (!IsNull(num)) {
 		if (Op == MiniScript::Op::MINUS) {
-			return  NumberNode::New(-num.Value());
+			return CopyLine( NumberNode::New(-num.Value()));
 		} else if (Op == MiniScript::Op::NOT) {
 			// Fuzzy logic NOT: 1 - AbsClamp01(value)
-			return  NumberNode::New(1.0 - Value::AbsClamp01(num.Value()));
+			return CopyLine( NumberNode::New(1.0 - Value::AbsClamp01(num.Value())));
 		}
 	}
 
@@ -263,6 +267,28 @@ ASTNode BinaryOpNodeStorage::Simplify() {
 		return  StringNode::New(result);
 	}
 
+	// String equality (ordering is left to the VM's string comparison)
+	if (!IsNull(leftStr) && !IsNull(rightStr) && Op == MiniScript::Op::EQUALS) {
+		return CopyLine( NumberNode::New(leftStr.Value() == rightStr.Value() ? 1 : 0));
+	}
+	if (!IsNull(leftStr) && !IsNull(rightStr) && Op == MiniScript::Op::NOT_EQUAL) {
+		return CopyLine( NumberNode::New(leftStr.Value() != rightStr.Value() ? 1 : 0));
+	}
+
+	// Algebraic identities: x + 0, x - 0, x * 1, x / 1, x ^ 1 and their
+	// mirror images are just x -- but only where x is known to be a number,
+	// since the same operators mean other things for strings and lists.
+	if (!IsNull(rightNum) && ASTSimplifier::IsKnownNumber(simplifiedLeft)) {
+		Double r = rightNum.Value();
+		if (r == 0 && (Op == MiniScript::Op::PLUS || Op == MiniScript::Op::MINUS)) return simplifiedLeft;
+		if (r == 1 && (Op == MiniScript::Op::TIMES || Op == MiniScript::Op::DIVIDE || Op == MiniScript::Op::POWER)) return simplifiedLeft;
+	}
+	if (!IsNull(leftNum) && ASTSimplifier::IsKnownNumber(simplifiedRight)) {
+		Double l = leftNum.Value();
+		if (l == 0 && Op == MiniScript::Op::PLUS) return simplifiedRight;
+		if (l == 1 && Op == MiniScript::Op::TIMES) return simplifiedRight;
+	}
+
 	// Otherwise return binary op with simplified operands
 	return CopyLine( BinaryOpNode::New(Op, simplifiedLeft, simplifiedRight));
 }
@@ -290,8 +316,31 @@ String ComparisonChainNodeStorage::ToStr() {
 }
 ASTNode ComparisonChainNodeStorage::Simplify() {
 	List<ASTNode> simplifiedOperands =  List<ASTNode>::New();
+	List<Double> numbers =  List<Double>::New();
 	for (Int32 i = 0; i < Operands.Count(); i++) {
-		simplifiedOperands.Add(Operands[i].Simplify());
+		ASTNode operand = Operands[i].Simplify();
+		NumberNode num = As<NumberNode, NumberNodeStorage>(operand);
+		if (!IsNull(num)) numbers.Add(num.Value());
+		simplifiedOperands.Add(operand);
+	}
+
+	// A chain of number literals folds to the product of its comparisons.
+	if (numbers.Count() == Operands.Count()) {
+		Double result = 1;
+		for (Int32 i = 0; i < Operators.Count(); i++) {
+			Double a = numbers[i];
+			Double b = numbers[i + 1];
+			String op = Operators[i];
+			Boolean holds = Boolean(false);
+			if (op == MiniScript::Op::EQUALS) holds = (a == b);
+			else if (op == MiniScript::Op::NOT_EQUAL) holds = (a != b);
+			else if (op == MiniScript::Op::LESS_THAN) holds = (a < b);
+			else if (op == MiniScript::Op::GREATER_THAN) holds = (a > b);
+			else if (op == MiniScript::Op::LESS_EQUAL) holds = (a <= b);
+			else if (op == MiniScript::Op::GREATER_EQUAL) holds = (a >= b);
+			if (!holds) result = 0;
+		}
+		return CopyLine( NumberNode::New(result));
 	}
 	return CopyLine( ComparisonChainNode::New(simplifiedOperands, Operators));
 }
@@ -652,6 +701,18 @@ ASTNode IfNodeStorage::Simplify() {
 	for (Int32 i = 0; i < ElseBody.Count(); i++) {
 		simplifiedElseBody.Add(ElseBody[i].Simplify());
 	}
+
+	// A constant condition settles which arm runs.  Drop the other one, and
+	// keep the survivor as the body of an `if 1` with no else, which the code
+	// generator compiles as a plain block (no test, no branch).  It stays an
+	// IfNode so that it is still a statement -- e.g. the REPL must not echo
+	// `if true then 42` as though it were the expression `42`.
+	Int32 truth = ASTSimplifier::ConstantTruth(simplifiedCondition);
+	if (truth == 1) {
+		return CopyLine( IfNode::New(CopyLine( NumberNode::New(1)), simplifiedThenBody,  List<ASTNode>::New()));
+	} else if (truth == 0) {
+		return CopyLine( IfNode::New(CopyLine( NumberNode::New(1)), simplifiedElseBody,  List<ASTNode>::New()));
+	}
 	return CopyLine( IfNode::New(simplifiedCondition, simplifiedThenBody, simplifiedElseBody));
 }
 Boolean IfNodeStorage::MayReadVar(String varName) {
@@ -882,4 +943,431 @@ Int32 ReturnNodeStorage::Accept(IASTVisitor& visitor) {
 	return visitor.Visit(_this);
 }
 
+Int32 ASTSimplifier::SimplifyAll(List<ASTNode> statements) {
+	NodeCounter counter =  NodeCounter::New();
+	Int32 before = 0;
+	Int32 after = 0;
+	for (Int32 i = 0; i < statements.Count(); i++) {
+		before += statements[i].Accept(counter);
+		statements[i] = statements[i].Simplify();
+		after += statements[i].Accept(counter);
+	}
+	return before - after;
+}
+Int32 ASTSimplifier::ConstantTruth(ASTNode node) {
+	NumberNode num = As<NumberNode, NumberNodeStorage>(node);
+	if (!IsNull(num)) return num.Value() != 0 ? 1 : 0;
+	StringNode str = As<StringNode, StringNodeStorage>(node);
+	if (!IsNull(str)) return str.Value() != "" ? 1 : 0;
+	IdentifierNode ident = As<IdentifierNode, IdentifierNodeStorage>(node);
+	if (!IsNull(ident) && ident.Name() == "null") return 0;
+	return -1;
+}
+Boolean ASTSimplifier::IsKnownNumber(ASTNode node) {
+	ComparisonChainNode chain = As<ComparisonChainNode, ComparisonChainNodeStorage>(node);
+	if (!IsNull(chain)) return Boolean(true);
+	UnaryOpNode unary = As<UnaryOpNode, UnaryOpNodeStorage>(node);
+	if (!IsNull(unary)) return unary.Op() == MiniScript::Op::NOT;
+	BinaryOpNode binary = As<BinaryOpNode, BinaryOpNodeStorage>(node);
+	if (IsNull(binary)) return Boolean(false);
+	String op = binary.Op();
+	return op == MiniScript::Op::EQUALS || op == MiniScript::Op::NOT_EQUAL
+		|| op == MiniScript::Op::LESS_THAN || op == MiniScript::Op::GREATER_THAN
+		|| op == MiniScript::Op::LESS_EQUAL || op == MiniScript::Op::GREATER_EQUAL
+		|| op == MiniScript::Op::AND || op == MiniScript::Op::OR || op == MiniScript::Op::ISA;
+}
+
+NodeCounterStorage::NodeCounterStorage() {
+}
+Int32 NodeCounterStorage::CountAll(List<ASTNode> nodes) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	Int32 count = 0;
+	for (Int32 i = 0; i < nodes.Count(); i++) {
+		ASTNode node = nodes[i];
+		if (!IsNull(node)) count += node.Accept(_this);
+	}
+	return count;
+}
+Int32 NodeCounterStorage::Visit(NumberNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(StringNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(IdentifierNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(AssignmentNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Value().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(UnaryOpNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Operand().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(BinaryOpNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Left().Accept(_this) + node.Right().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(CallNode node) {
+	return 1 + CountAll(node.Arguments());
+}
+Int32 NodeCounterStorage::Visit(GroupNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Expression().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(ListNode node) {
+	return 1 + CountAll(node.Elements());
+}
+Int32 NodeCounterStorage::Visit(MapNode node) {
+	return 1 + CountAll(node.Keys()) + CountAll(node.Values());
+}
+Int32 NodeCounterStorage::Visit(IndexNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Target().Accept(_this) + node.Index().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(SliceNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	Int32 count = 1 + node.Target().Accept(_this);
+	if (!IsNull(node.StartIndex())) count += node.StartIndex().Accept(_this);
+	if (!IsNull(node.EndIndex())) count += node.EndIndex().Accept(_this);
+	return count;
+}
+Int32 NodeCounterStorage::Visit(MemberNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Target().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(MethodCallNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Target().Accept(_this) + CountAll(node.Arguments());
+}
+Int32 NodeCounterStorage::Visit(ExprCallNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Function().Accept(_this) + CountAll(node.Arguments());
+}
+Int32 NodeCounterStorage::Visit(WhileNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Condition().Accept(_this) + CountAll(node.Body());
+}
+Int32 NodeCounterStorage::Visit(IfNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Condition().Accept(_this) + CountAll(node.ThenBody()) + CountAll(node.ElseBody());
+}
+Int32 NodeCounterStorage::Visit(ForNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Iterable().Accept(_this) + CountAll(node.Body());
+}
+Int32 NodeCounterStorage::Visit(BreakNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(ContinueNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(FunctionNode node) {
+	return 1 + CountAll(node.ParamDefaults()) + CountAll(node.Body());
+}
+Int32 NodeCounterStorage::Visit(ReturnNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return (!IsNull(node.Value())) ? 1 + node.Value().Accept(_this) : 1;
+}
+Int32 NodeCounterStorage::Visit(IndexedAssignmentNode node) {
+	NodeCounter _this(std::static_pointer_cast<NodeCounterStorage>(shared_from_this()));
+	return 1 + node.Target().Accept(_this) + node.Index().Accept(_this) + node.Value().Accept(_this);
+}
+Int32 NodeCounterStorage::Visit(SelfNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(SuperNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(ScopeNode node) {
+	return 1;
+}
+Int32 NodeCounterStorage::Visit(ComparisonChainNode node) {
+	return 1 + CountAll(node.Operands());
+}
+
+InlineCandidateStorage::InlineCandidateStorage(FuncDef func,Value funcTemplate,List<String> paramNames,ASTNode body,Int32 line) {
+	Func = func;
+	Template = funcTemplate;
+	ParamNames = paramNames;
+	Body = body;
+	Line = line;
+}
+
+InlineCheckerStorage::InlineCheckerStorage(List<String> paramNames) {
+	_paramNames = paramNames;
+}
+Int32 InlineCheckerStorage::CheckAll(List<ASTNode> nodes) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	for (Int32 i = 0; i < nodes.Count(); i++) {
+		ASTNode node = nodes[i];
+		if (!IsNull(node) && node.Accept(_this) == 0) return 0;
+	}
+	return 1;
+}
+Int32 InlineCheckerStorage::Visit(NumberNode node) {
+	return 1;
+}
+Int32 InlineCheckerStorage::Visit(StringNode node) {
+	return 1;
+}
+Int32 InlineCheckerStorage::Visit(IdentifierNode node) {
+	if (node.Name() == "null" || node.Name() == "true" || node.Name() == "false") return 1;
+	for (Int32 i = 0; i < _paramNames.Count(); i++) {
+		if (_paramNames[i] == node.Name()) return 1;
+	}
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(AssignmentNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(UnaryOpNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	return node.Operand().Accept(_this);
+}
+Int32 InlineCheckerStorage::Visit(BinaryOpNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	if (node.Left().Accept(_this) == 0) return 0;
+	return node.Right().Accept(_this);
+}
+Int32 InlineCheckerStorage::Visit(CallNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(GroupNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	return node.Expression().Accept(_this);
+}
+Int32 InlineCheckerStorage::Visit(ListNode node) {
+	return CheckAll(node.Elements());
+}
+Int32 InlineCheckerStorage::Visit(MapNode node) {
+	if (CheckAll(node.Keys()) == 0) return 0;
+	return CheckAll(node.Values());
+}
+Int32 InlineCheckerStorage::Visit(IndexNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	if (node.Target().Accept(_this) == 0) return 0;
+	return node.Index().Accept(_this);
+}
+Int32 InlineCheckerStorage::Visit(SliceNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	if (node.Target().Accept(_this) == 0) return 0;
+	if (!IsNull(node.StartIndex()) && node.StartIndex().Accept(_this) == 0) return 0;
+	if (!IsNull(node.EndIndex()) && node.EndIndex().Accept(_this) == 0) return 0;
+	return 1;
+}
+Int32 InlineCheckerStorage::Visit(MemberNode node) {
+	InlineChecker _this(std::static_pointer_cast<InlineCheckerStorage>(shared_from_this()));
+	return node.Target().Accept(_this);
+}
+Int32 InlineCheckerStorage::Visit(MethodCallNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ExprCallNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(WhileNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(IfNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ForNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(BreakNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ContinueNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(FunctionNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ReturnNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(IndexedAssignmentNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(SelfNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(SuperNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ScopeNode node) {
+	return 0;
+}
+Int32 InlineCheckerStorage::Visit(ComparisonChainNode node) {
+	return CheckAll(node.Operands());
+}
+
+LoopConstantCollectorStorage::LoopConstantCollectorStorage() {
+	Values =  List<Value>::New();
+}
+void LoopConstantCollectorStorage::CollectAll(List<ASTNode> nodes) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	for (Int32 i = 0; i < nodes.Count(); i++) {
+		ASTNode node = nodes[i];
+		if (!IsNull(node)) node.Accept(_this);
+	}
+}
+void LoopConstantCollectorStorage::NoteOperand(ASTNode node) {
+	NumberNode num = As<NumberNode, NumberNodeStorage>(node);
+	if (!IsNull(num)) {
+		if (std::isnan(num.Value())) return;
+		Note(Value(num.Value()));
+		return;
+	}
+	StringNode str = As<StringNode, StringNodeStorage>(node);
+	if (!IsNull(str)) Note(Value::make_interned_string(str.Value()));
+}
+void LoopConstantCollectorStorage::Note(Value value) {
+	for (Int32 i = 0; i < Values.Count(); i++) {
+		if (SameConstant(Values[i], value)) return;
+	}
+	Values.Add(value);
+}
+Boolean LoopConstantCollectorStorage::SameConstant(Value a,Value b) {
+	if (a.IsNumber() && b.IsNumber()) return a.Bits() == b.Bits();
+	return a.IsString() && b.IsString() && a == b;
+}
+Int32 LoopConstantCollectorStorage::Visit(NumberNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(StringNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(IdentifierNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(AssignmentNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Value().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(UnaryOpNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Operand().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(BinaryOpNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	// `and` and `or` compile their operands straight into the result.
+	if (node.Op() != MiniScript::Op::AND && node.Op() != MiniScript::Op::OR) {
+		NoteOperand(node.Left());
+		NoteOperand(node.Right());
+	}
+	node.Left().Accept(_this);
+	node.Right().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(CallNode node) {
+	CollectAll(node.Arguments());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(GroupNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Expression().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ListNode node) {
+	CollectAll(node.Elements());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(MapNode node) {
+	CollectAll(node.Keys());
+	CollectAll(node.Values());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(IndexNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	NoteOperand(node.Index());
+	node.Target().Accept(_this);
+	node.Index().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(SliceNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Target().Accept(_this);
+	if (!IsNull(node.StartIndex())) node.StartIndex().Accept(_this);
+	if (!IsNull(node.EndIndex())) node.EndIndex().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(MemberNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	Note(Value::make_interned_string(node.Member()));
+	node.Target().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(MethodCallNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	Note(Value::make_interned_string(node.Method()));
+	node.Target().Accept(_this);
+	CollectAll(node.Arguments());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ExprCallNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Function().Accept(_this);
+	CollectAll(node.Arguments());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(WhileNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Condition().Accept(_this);
+	CollectAll(node.Body());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(IfNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Condition().Accept(_this);
+	CollectAll(node.ThenBody());
+	CollectAll(node.ElseBody());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ForNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	node.Iterable().Accept(_this);
+	CollectAll(node.Body());
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(BreakNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ContinueNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(FunctionNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ReturnNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	if (!IsNull(node.Value())) node.Value().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(IndexedAssignmentNode node) {
+	LoopConstantCollector _this(std::static_pointer_cast<LoopConstantCollectorStorage>(shared_from_this()));
+	NoteOperand(node.Index());
+	node.Target().Accept(_this);
+	node.Index().Accept(_this);
+	node.Value().Accept(_this);
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(SelfNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(SuperNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ScopeNode node) {
+	return 0;
+}
+Int32 LoopConstantCollectorStorage::Visit(ComparisonChainNode node) {
+	CollectAll(node.Operands());
+	return 0;
+}
+
 } // end of namespace MiniScript
@@ -7,6 +7,8 @@
 // AST.cs - Abstract Syntax Tree nodes for MiniScript
 // These classes use the smart-pointer-wrapper pattern when transpiled to C++.
 
+#include "FuncDef.g.h"
+
 namespace MiniScript {
 
 // DECLARATIONS
@@ -73,6 +75,30 @@ enum class ScopeType : Int32 {
 	Globals
 }; // end of enum ScopeType
 
+// The AST optimization pass, run between parsing and code generation.  The
+// work itself is done by each node's Simplify method; this holds the entry
+// point and the judgments those methods share.
+class ASTSimplifier {
+	// Simplify every statement of a program (or REPL entry) in place, and return
+	// how many AST nodes that removed, as counted by NodeCounter.
+	public: static Int32 SimplifyAll(List<ASTNode> statements);
+
+	// What a simplified condition is known to be, judged by the rule the VM's
+	// branches apply (a nonzero number or nonempty string is true; null is
+	// false): 1 if always true, 0 if always false, -1 if it depends on run time.
+	// Only literals qualify; the keywords true and false have already become
+	// numbers by the time anything asks.
+	public: static Int32 ConstantTruth(ASTNode node);
+
+	// Is this (simplified) expression certain to yield a number that is not
+	// negative zero -- or else an error, which arithmetic passes through
+	// unchanged?  Comparisons and the fuzzy-logic operators always do; most
+	// other operators depend on their operand types (+ concatenates strings,
+	// - negates to -0, and so on), which we cannot know.  This is what makes
+	// identities like x + 0 safe to apply.
+	public: static Boolean IsKnownNumber(ASTNode node);
+}; // end of struct ASTSimplifier
+
 // Base class for all AST nodes.
 // When transpiled to C++, these become shared_ptr-wrapped classes.
 struct ASTNode {
@@ -646,6 +672,214 @@ class ReturnNodeStorage : public ASTNodeStorage {
 	public: Int32 Accept(IASTVisitor& visitor);
 }; // end of class ReturnNodeStorage
 
+class NodeCounterStorage : public std::enable_shared_from_this<NodeCounterStorage>, public IASTVisitor {
+	friend struct NodeCounter;
+	public: NodeCounterStorage();
+
+	private: Int32 CountAll(List<ASTNode> nodes);
+
+	public: Int32 Visit(NumberNode node);
+
+	public: Int32 Visit(StringNode node);
+
+	public: Int32 Visit(IdentifierNode node);
+
+	public: Int32 Visit(AssignmentNode node);
+
+	public: Int32 Visit(UnaryOpNode node);
+
+	public: Int32 Visit(BinaryOpNode node);
+
+	public: Int32 Visit(CallNode node);
+
+	public: Int32 Visit(GroupNode node);
+
+	public: Int32 Visit(ListNode node);
+
+	public: Int32 Visit(MapNode node);
+
+	public: Int32 Visit(IndexNode node);
+
+	public: Int32 Visit(SliceNode node);
+
+	public: Int32 Visit(MemberNode node);
+
+	public: Int32 Visit(MethodCallNode node);
+
+	public: Int32 Visit(ExprCallNode node);
+
+	public: Int32 Visit(WhileNode node);
+
+	public: Int32 Visit(IfNode node);
+
+	public: Int32 Visit(ForNode node);
+
+	public: Int32 Visit(BreakNode node);
+
+	public: Int32 Visit(ContinueNode node);
+
+	public: Int32 Visit(FunctionNode node);
+
+	public: Int32 Visit(ReturnNode node);
+
+	public: Int32 Visit(IndexedAssignmentNode node);
+
+	public: Int32 Visit(SelfNode node);
+
+	public: Int32 Visit(SuperNode node);
+
+	public: Int32 Visit(ScopeNode node);
+
+	public: Int32 Visit(ComparisonChainNode node);
+}; // end of class NodeCounterStorage
+
+class InlineCandidateStorage : public std::enable_shared_from_this<InlineCandidateStorage> {
+	friend struct InlineCandidate;
+	public: FuncDef Func; // the compiled function
+	public: Value Template; // its template funcref, for the IFFUNC guard
+	public: List<String> ParamNames;
+	public: ASTNode Body; // the expression it returns
+	public: Int32 Line; // source line of its return statement
+
+	public: InlineCandidateStorage(FuncDef func, Value funcTemplate, List<String> paramNames, ASTNode body, Int32 line);
+}; // end of class InlineCandidateStorage
+
+class InlineCheckerStorage : public std::enable_shared_from_this<InlineCheckerStorage>, public IASTVisitor {
+	friend struct InlineChecker;
+	private: List<String> _paramNames;
+
+	public: InlineCheckerStorage(List<String> paramNames);
+
+	private: Int32 CheckAll(List<ASTNode> nodes);
+
+	public: Int32 Visit(NumberNode node);
+
+	public: Int32 Visit(StringNode node);
+
+	public: Int32 Visit(IdentifierNode node);
+
+	public: Int32 Visit(AssignmentNode node);
+
+	public: Int32 Visit(UnaryOpNode node);
+
+	public: Int32 Visit(BinaryOpNode node);
+
+	public: Int32 Visit(CallNode node);
+
+	public: Int32 Visit(GroupNode node);
+
+	public: Int32 Visit(ListNode node);
+
+	public: Int32 Visit(MapNode node);
+
+	public: Int32 Visit(IndexNode node);
+
+	public: Int32 Visit(SliceNode node);
+
+	public: Int32 Visit(MemberNode node);
+
+	public: Int32 Visit(MethodCallNode node);
+
+	public: Int32 Visit(ExprCallNode node);
+
+	public: Int32 Visit(WhileNode node);
+
+	public: Int32 Visit(IfNode node);
+
+	public: Int32 Visit(ForNode node);
+
+	public: Int32 Visit(BreakNode node);
+
+	public: Int32 Visit(ContinueNode node);
+
+	public: Int32 Visit(FunctionNode node);
+
+	public: Int32 Visit(ReturnNode node);
+
+	public: Int32 Visit(IndexedAssignmentNode node);
+
+	public: Int32 Visit(SelfNode node);
+
+	public: Int32 Visit(SuperNode node);
+
+	public: Int32 Visit(ScopeNode node);
+
+	public: Int32 Visit(ComparisonChainNode node);
+}; // end of class InlineCheckerStorage
+
+class LoopConstantCollectorStorage : public std::enable_shared_from_this<LoopConstantCollectorStorage>, public IASTVisitor {
+	friend struct LoopConstantCollector;
+	public: List<Value> Values;
+
+	public: LoopConstantCollectorStorage();
+
+	public: void CollectAll(List<ASTNode> nodes);
+
+	// Record node if it is a literal number or string.  NaN is left alone: it
+	// equals nothing, itself included, so it could never be found again.
+	private: void NoteOperand(ASTNode node);
+
+	private: void Note(Value value);
+
+	// Whether two constants can share a register.  This is stricter than `==`,
+	// which counts -0 and 0 as equal: numbers must match bit for bit.
+	public: static Boolean SameConstant(Value a, Value b);
+
+	public: Int32 Visit(NumberNode node);
+
+	public: Int32 Visit(StringNode node);
+
+	public: Int32 Visit(IdentifierNode node);
+
+	public: Int32 Visit(AssignmentNode node);
+
+	public: Int32 Visit(UnaryOpNode node);
+
+	public: Int32 Visit(BinaryOpNode node);
+
+	public: Int32 Visit(CallNode node);
+
+	public: Int32 Visit(GroupNode node);
+
+	public: Int32 Visit(ListNode node);
+
+	public: Int32 Visit(MapNode node);
+
+	public: Int32 Visit(IndexNode node);
+
+	public: Int32 Visit(SliceNode node);
+
+	public: Int32 Visit(MemberNode node);
+
+	public: Int32 Visit(MethodCallNode node);
+
+	public: Int32 Visit(ExprCallNode node);
+
+	public: Int32 Visit(WhileNode node);
+
+	public: Int32 Visit(IfNode node);
+
+	public: Int32 Visit(ForNode node);
+
+	public: Int32 Visit(BreakNode node);
+
+	public: Int32 Visit(ContinueNode node);
+
+	public: Int32 Visit(FunctionNode node);
+
+	public: Int32 Visit(ReturnNode node);
+
+	public: Int32 Visit(IndexedAssignmentNode node);
+
+	public: Int32 Visit(SelfNode node);
+
+	public: Int32 Visit(SuperNode node);
+
+	public: Int32 Visit(ScopeNode node);
+
+	public: Int32 Visit(ComparisonChainNode node);
+}; // end of class LoopConstantCollectorStorage
+
 // Number literal node (e.g., 42, 3.14)
 struct NumberNode : public ASTNode {
 	friend class NumberNodeStorage;
@@ -1393,6 +1627,275 @@ struct ReturnNode : public ASTNode {
 	public: Int32 Accept(IASTVisitor& visitor) { return get()->Accept(visitor); }
 }; // end of struct ReturnNode
 
+// Counts the nodes in a tree: the node visited plus everything below it.
+// ASTSimplifier.SimplifyAll uses it to report how much simplification removed.
+struct NodeCounter : public IASTVisitor {
+	friend class NodeCounterStorage;
+	protected: std::shared_ptr<NodeCounterStorage> storage;
+  public:
+	NodeCounter(std::shared_ptr<NodeCounterStorage> stor) : storage(stor) {}
+	NodeCounter() : storage(nullptr) {}
+	NodeCounter(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const NodeCounter& inst) { return inst.storage == nullptr; }
+	private: NodeCounterStorage* get() const;
+
+	public: static NodeCounter New() {
+		return NodeCounter(std::make_shared<NodeCounterStorage>());
+	}
+
+	private: inline Int32 CountAll(List<ASTNode> nodes);
+
+	public: inline Int32 Visit(NumberNode node);
+
+	public: inline Int32 Visit(StringNode node);
+
+	public: inline Int32 Visit(IdentifierNode node);
+
+	public: inline Int32 Visit(AssignmentNode node);
+
+	public: inline Int32 Visit(UnaryOpNode node);
+
+	public: inline Int32 Visit(BinaryOpNode node);
+
+	public: inline Int32 Visit(CallNode node);
+
+	public: inline Int32 Visit(GroupNode node);
+
+	public: inline Int32 Visit(ListNode node);
+
+	public: inline Int32 Visit(MapNode node);
+
+	public: inline Int32 Visit(IndexNode node);
+
+	public: inline Int32 Visit(SliceNode node);
+
+	public: inline Int32 Visit(MemberNode node);
+
+	public: inline Int32 Visit(MethodCallNode node);
+
+	public: inline Int32 Visit(ExprCallNode node);
+
+	public: inline Int32 Visit(WhileNode node);
+
+	public: inline Int32 Visit(IfNode node);
+
+	public: inline Int32 Visit(ForNode node);
+
+	public: inline Int32 Visit(BreakNode node);
+
+	public: inline Int32 Visit(ContinueNode node);
+
+	public: inline Int32 Visit(FunctionNode node);
+
+	public: inline Int32 Visit(ReturnNode node);
+
+	public: inline Int32 Visit(IndexedAssignmentNode node);
+
+	public: inline Int32 Visit(SelfNode node);
+
+	public: inline Int32 Visit(SuperNode node);
+
+	public: inline Int32 Visit(ScopeNode node);
+
+	public: inline Int32 Visit(ComparisonChainNode node);
+}; // end of struct NodeCounter
+
+// A function whose calls may be compiled inline: one that just returns a small
+// expression of its parameters.  See CodeGenerator.MakeInlineCandidate.
+struct InlineCandidate {
+	friend class InlineCandidateStorage;
+	protected: std::shared_ptr<InlineCandidateStorage> storage;
+  public:
+	InlineCandidate(std::shared_ptr<InlineCandidateStorage> stor) : storage(stor) {}
+	InlineCandidate() : storage(nullptr) {}
+	InlineCandidate(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const InlineCandidate& inst) { return inst.storage == nullptr; }
+	private: InlineCandidateStorage* get() const;
+
+	public: FuncDef Func(); // the compiled function
+	public: void set_Func(FuncDef _v); // the compiled function
+	public: Value Template(); // its template funcref, for the IFFUNC guard
+	public: void set_Template(Value _v); // its template funcref, for the IFFUNC guard
+	public: List<String> ParamNames();
+	public: void set_ParamNames(List<String> _v);
+	public: ASTNode Body(); // the expression it returns
+	public: void set_Body(ASTNode _v); // the expression it returns
+	public: Int32 Line(); // source line of its return statement
+	public: void set_Line(Int32 _v); // source line of its return statement
+
+	public: static InlineCandidate New(FuncDef func, Value funcTemplate, List<String> paramNames, ASTNode body, Int32 line) {
+		return InlineCandidate(std::make_shared<InlineCandidateStorage>(func, funcTemplate, paramNames, body, line));
+	}
+}; // end of struct InlineCandidate
+
+// Decides whether an expression can be compiled inline, in place of a call to
+// the function whose body returns it (see CodeGenerator.EmitInlinedCall): that
+// is, whether it reads nothing but the function's parameters and constants,
+// and calls nothing.  Visit returns 1 if the node qualifies, 0 if not.
+struct InlineChecker : public IASTVisitor {
+	friend class InlineCheckerStorage;
+	protected: std::shared_ptr<InlineCheckerStorage> storage;
+  public:
+	InlineChecker(std::shared_ptr<InlineCheckerStorage> stor) : storage(stor) {}
+	InlineChecker() : storage(nullptr) {}
+	InlineChecker(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const InlineChecker& inst) { return inst.storage == nullptr; }
+	private: InlineCheckerStorage* get() const;
+
+	private: List<String> _paramNames();
+	private: void set__paramNames(List<String> _v);
+
+	public: static InlineChecker New(List<String> paramNames) {
+		return InlineChecker(std::make_shared<InlineCheckerStorage>(paramNames));
+	}
+
+	private: inline Int32 CheckAll(List<ASTNode> nodes);
+
+	public: inline Int32 Visit(NumberNode node);
+
+	public: inline Int32 Visit(StringNode node);
+
+	public: inline Int32 Visit(IdentifierNode node);
+
+	public: inline Int32 Visit(AssignmentNode node);
+
+	public: inline Int32 Visit(UnaryOpNode node);
+
+	public: inline Int32 Visit(BinaryOpNode node);
+
+	public: inline Int32 Visit(CallNode node);
+
+	public: inline Int32 Visit(GroupNode node);
+
+	public: inline Int32 Visit(ListNode node);
+
+	public: inline Int32 Visit(MapNode node);
+
+	public: inline Int32 Visit(IndexNode node);
+
+	public: inline Int32 Visit(SliceNode node);
+
+	public: inline Int32 Visit(MemberNode node);
+
+	public: inline Int32 Visit(MethodCallNode node);
+
+	public: inline Int32 Visit(ExprCallNode node);
+
+	public: inline Int32 Visit(WhileNode node);
+
+	public: inline Int32 Visit(IfNode node);
+
+	public: inline Int32 Visit(ForNode node);
+
+	public: inline Int32 Visit(BreakNode node);
+
+	public: inline Int32 Visit(ContinueNode node);
+
+	public: inline Int32 Visit(FunctionNode node);
+
+	public: inline Int32 Visit(ReturnNode node);
+
+	public: inline Int32 Visit(IndexedAssignmentNode node);
+
+	public: inline Int32 Visit(SelfNode node);
+
+	public: inline Int32 Visit(SuperNode node);
+
+	public: inline Int32 Visit(ScopeNode node);
+
+	public: inline Int32 Visit(ComparisonChainNode node);
+}; // end of struct InlineChecker
+
+// Gathers the constants a loop reads as operands -- either side of an
+// arithmetic or comparison operator, an index, a member name -- so that the
+// loop's preheader can load each into a register once (see
+// CodeGenerator.HoistLoopConstants).  Values holds them in order of first
+// appearance, without duplicates.  Nested function bodies are skipped: they
+// are compiled on their own, and run in their own frame.
+struct LoopConstantCollector : public IASTVisitor {
+	friend class LoopConstantCollectorStorage;
+	protected: std::shared_ptr<LoopConstantCollectorStorage> storage;
+  public:
+	LoopConstantCollector(std::shared_ptr<LoopConstantCollectorStorage> stor) : storage(stor) {}
+	LoopConstantCollector() : storage(nullptr) {}
+	LoopConstantCollector(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const LoopConstantCollector& inst) { return inst.storage == nullptr; }
+	private: LoopConstantCollectorStorage* get() const;
+
+	public: List<Value> Values();
+	public: void set_Values(List<Value> _v);
+
+	public: static LoopConstantCollector New() {
+		return LoopConstantCollector(std::make_shared<LoopConstantCollectorStorage>());
+	}
+
+	public: inline void CollectAll(List<ASTNode> nodes);
+
+	// Record node if it is a literal number or string.  NaN is left alone: it
+	// equals nothing, itself included, so it could never be found again.
+	private: inline void NoteOperand(ASTNode node);
+
+	private: inline void Note(Value value);
+
+	// Whether two constants can share a register.  This is stricter than `==`,
+	// which counts -0 and 0 as equal: numbers must match bit for bit.
+	public: static Boolean SameConstant(Value a, Value b) { return LoopConstantCollectorStorage::SameConstant(a, b); }
+
+	public: inline Int32 Visit(NumberNode node);
+
+	public: inline Int32 Visit(StringNode node);
+
+	public: inline Int32 Visit(IdentifierNode node);
+
+	public: inline Int32 Visit(AssignmentNode node);
+
+	public: inline Int32 Visit(UnaryOpNode node);
+
+	public: inline Int32 Visit(BinaryOpNode node);
+
+	public: inline Int32 Visit(CallNode node);
+
+	public: inline Int32 Visit(GroupNode node);
+
+	public: inline Int32 Visit(ListNode node);
+
+	public: inline Int32 Visit(MapNode node);
+
+	public: inline Int32 Visit(IndexNode node);
+
+	public: inline Int32 Visit(SliceNode node);
+
+	public: inline Int32 Visit(MemberNode node);
+
+	public: inline Int32 Visit(MethodCallNode node);
+
+	public: inline Int32 Visit(ExprCallNode node);
+
+	public: inline Int32 Visit(WhileNode node);
+
+	public: inline Int32 Visit(IfNode node);
+
+	public: inline Int32 Visit(ForNode node);
+
+	public: inline Int32 Visit(BreakNode node);
+
+	public: inline Int32 Visit(ContinueNode node);
+
+	public: inline Int32 Visit(FunctionNode node);
+
+	public: inline Int32 Visit(ReturnNode node);
+
+	public: inline Int32 Visit(IndexedAssignmentNode node);
+
+	public: inline Int32 Visit(SelfNode node);
+
+	public: inline Int32 Visit(SuperNode node);
+
+	public: inline Int32 Visit(ScopeNode node);
+
+	public: inline Int32 Visit(ComparisonChainNode node);
+}; // end of struct LoopConstantCollector
+
 // INLINE METHODS
 
 inline ASTNodeStorage* ASTNode::get() const { return static_cast<ASTNodeStorage*>(storage.get()); }
@@ -1580,4 +2083,112 @@ inline ReturnNodeStorage* ReturnNode::get() const { return static_cast<ReturnNod
 inline ASTNode ReturnNode::Value() { return get()->Value; } // expression to return (null for bare return)
 inline void ReturnNode::set_Value(ASTNode _v) { get()->Value = _v; } // expression to return (null for bare return)
 
+inline NodeCounterStorage* NodeCounter::get() const { return static_cast<NodeCounterStorage*>(storage.get()); }
+inline Int32 NodeCounter::CountAll(List<ASTNode> nodes) { return get()->CountAll(nodes); }
+inline Int32 NodeCounter::Visit(NumberNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(StringNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(IdentifierNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(AssignmentNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(UnaryOpNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(BinaryOpNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(CallNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(GroupNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ListNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(MapNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(IndexNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(SliceNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(MemberNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(MethodCallNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ExprCallNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(WhileNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(IfNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ForNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(BreakNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ContinueNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(FunctionNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ReturnNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(IndexedAssignmentNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(SelfNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(SuperNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ScopeNode node) { return get()->Visit(node); }
+inline Int32 NodeCounter::Visit(ComparisonChainNode node) { return get()->Visit(node); }
+
+inline InlineCandidateStorage* InlineCandidate::get() const { return static_cast<InlineCandidateStorage*>(storage.get()); }
+inline FuncDef InlineCandidate::Func() { return get()->Func; } // the compiled function
+inline void InlineCandidate::set_Func(FuncDef _v) { get()->Func = _v; } // the compiled function
+inline Value InlineCandidate::Template() { return get()->Template; } // its template funcref, for the IFFUNC guard
+inline void InlineCandidate::set_Template(Value _v) { get()->Template = _v; } // its template funcref, for the IFFUNC guard
+inline List<String> InlineCandidate::ParamNames() { return get()->ParamNames; }
+inline void InlineCandidate::set_ParamNames(List<String> _v) { get()->ParamNames = _v; }
+inline ASTNode InlineCandidate::Body() { return get()->Body; } // the expression it returns
+inline void InlineCandidate::set_Body(ASTNode _v) { get()->Body = _v; } // the expression it returns
+inline Int32 InlineCandidate::Line() { return get()->Line; } // source line of its return statement
+inline void InlineCandidate::set_Line(Int32 _v) { get()->Line = _v; } // source line of its return statement
+
+inline InlineCheckerStorage* InlineChecker::get() const { return static_cast<InlineCheckerStorage*>(storage.get()); }
+inline List<String> InlineChecker::_paramNames() { return get()->_paramNames; }
+inline void InlineChecker::set__paramNames(List<String> _v) { get()->_paramNames = _v; }
+inline Int32 InlineChecker::CheckAll(List<ASTNode> nodes) { return get()->CheckAll(nodes); }
+inline Int32 InlineChecker::Visit(NumberNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(StringNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(IdentifierNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(AssignmentNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(UnaryOpNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(BinaryOpNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(CallNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(GroupNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ListNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(MapNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(IndexNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(SliceNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(MemberNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(MethodCallNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ExprCallNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(WhileNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(IfNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ForNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(BreakNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ContinueNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(FunctionNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ReturnNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(IndexedAssignmentNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(SelfNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(SuperNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ScopeNode node) { return get()->Visit(node); }
+inline Int32 InlineChecker::Visit(ComparisonChainNode node) { return get()->Visit(node); }
+
+inline LoopConstantCollectorStorage* LoopConstantCollector::get() const { return static_cast<LoopConstantCollectorStorage*>(storage.get()); }
+inline List<Value> LoopConstantCollector::Values() { return get()->Values; }
+inline void LoopConstantCollector::set_Values(List<Value> _v) { get()->Values = _v; }
+inline void LoopConstantCollector::CollectAll(List<ASTNode> nodes) { return get()->CollectAll(nodes); }
+inline void LoopConstantCollector::NoteOperand(ASTNode node) { return get()->NoteOperand(node); }
+inline void LoopConstantCollector::Note(Value value) { return get()->Note(value); }
+inline Int32 LoopConstantCollector::Visit(NumberNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(StringNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(IdentifierNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(AssignmentNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(UnaryOpNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(BinaryOpNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(CallNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(GroupNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ListNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(MapNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(IndexNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(SliceNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(MemberNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(MethodCallNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ExprCallNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(WhileNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(IfNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ForNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(BreakNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ContinueNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(FunctionNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ReturnNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(IndexedAssignmentNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(SelfNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(SuperNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ScopeNode node) { return get()->Visit(node); }
+inline Int32 LoopConstantCollector::Visit(ComparisonChainNode node) { return get()->Visit(node); }
+
 } // end of namespace MiniScript
@@ -214,13 +214,10 @@ void App::MainProgram(List<String> args) {
 			if (lines.Count() == 0) {
 				IOHelper::Print("No lines read from file.");
 			} else {
-				String source = "";
-				for (Int32 i = 0; i < lines.Count(); i++) {
-					if (i > 0) source += "\n";
-					source += lines[i];
-				}
+				String source = String::Join("\n", lines);
 				if (debugMode) IOHelper::Print(StringUtils::Format("Parsing {0} lines...", lines.Count()));
 				interp.set_SourceFile(GetPathFilename(filePath));
+				ShellIntrinsics::PrefetchImports(source);   // parse its imports meanwhile
 				interp.Reset(source);
 				RunInterpreter(interp);
 				if (interp.ExitRequested()) DoExit(interp.ExitCode());
@@ -437,6 +434,11 @@ void App::RunInterpreter(Interpreter interp) {
 
 	// Debug: disassemble and print
 	if (debugMode) {
+		if (interp.SimplifiedNodeCount() < 0) {
+			IOHelper::Print("Loaded from the bytecode cache (not simplified this run).");
+		} else {
+			IOHelper::Print(StringUtils::Format("Simplification removed {0} AST nodes.", interp.SimplifiedNodeCount()));
+		}
 		List<FuncDef> functions = vm.GetFunctions();
 		IOHelper::Print("Disassembly:\n");
 		List<String> disassembly = Disassembler::Disassemble(functions, Boolean(true));
@@ -447,8 +449,9 @@ void App::RunInterpreter(Interpreter interp) {
 		IOHelper::Print(StringUtils::Format("Found {0} functions:", functions.Count()));
 		for (Int32 i = 0; i < functions.Count(); i++) {
 			FuncDef func = functions[i];
+			func.EnsureConstants();
 			IOHelper::Print(StringUtils::Format("  {0}: {1} instructions, {2} constants, MaxRegs={3}",
-				func.Name(), func.Code().Count(), func.Constants().Count(), func.MaxRegs()));
+				func.Name(), func.CodeCount(), func.Constants().Count(), func.MaxRegs()));
 		}
 
 		IOHelper::Print("");
@@ -154,7 +154,7 @@ UInt32 AssemblerStorage::AddLine(String line,Int32 lineNumber) {
 
 		// Add parameter to current function (store name as Value string)
 		// ToDo: make simple, consistent conversion functions between String and Value, and use everywhere.
-		Current.ParamNames().Add(Value::make_string(paramName));
+		Current.ParamNames().Add(Value::make_interned_string(paramName));
 		Current.ParamDefaults().Add(defaultValue);
 
 		return 0; // Directives don't produce instructions
@@ -232,16 +232,20 @@ UInt32 AssemblerStorage::AddLine(String line,Int32 lineNumber) {
 	} else if (mnemonic == "LOADC") {
 		// LOADC r1, r2, "varname"  -->  LOADC_rA_rB_kC
 		// LOADC r1, r2, r3         -->  LOADC_rA_rB_rC  (name comes from r3)
+		// LOADC r1, r2             -->  LOADC_rA_rB     (no name check)
 		// Load value from r2 into r1, but verify name matches varname and call if funcref
-		if (parts.Count() != 4) {
-			Error("Syntax error: LOADC requires exactly 3 operands");
+		if (parts.Count() != 3 && parts.Count() != 4) {
+			Error("Syntax error: LOADC requires 2 or 3 operands");
 			return 0;
 		}
 		Byte dest = ParseRegister(parts[1]);
 		Current.ReserveRegister(dest);
 		Byte src = ParseRegister(parts[2]);
 
-		if (parts[3][0] == 'r') {
+		if (parts.Count() == 3) {
+			if (HasError) return 0;
+			instruction = BytecodeUtil::INS_ABC(Opcode::LOADC_rA_rB, dest, src, 0);
+		} else if (parts[3][0] == 'r') {
 			// Register form: no constant-pool index, so no 255 limit.
 			Byte nameReg = ParseRegister(parts[3]);
 			if (HasError) return 0;
@@ -543,6 +547,23 @@ UInt32 AssemblerStorage::AddLine(String line,Int32 lineNumber) {
 			instruction = BytecodeUtil::INS_AB(opRI, reg1, immediate);
 		}
 
+	} else if (mnemonic == "IFFUNC") {
+		// IFFUNC r1, someFunc  -->  IFFUNC_rA_kBC
+		// Skip the next instruction unless r1 refers to someFunc.
+		if (parts.Count() != 3) { Error("Syntax error: IFFUNC requires exactly 2 operands"); return 0; }
+		Byte reg1 = ParseRegister(parts[1]);
+		FuncDef target = FindFunction(parts[2]);
+		if (IsNull(target)) {
+			Error(StringUtils::Format("Unknown function: '{0}'", parts[2]));
+			return 0;
+		}
+		Int32 funcConstIdx = AddConstant(Value::make_funcref(target, Value::Null));
+		if (funcConstIdx > Int16MaxValue) {
+			Error("Constant index out of range for IFFUNC");
+			return 0;
+		}
+		instruction = BytecodeUtil::INS_AB(Opcode::IFFUNC_rA_kBC, reg1, (Int16)funcConstIdx);
+
 	} else if (mnemonic == "NEXT") {
 		if (parts.Count() != 3) { Error("Syntax error: NEXT requires 2 register operands"); return 0; }
 		Byte reg1 = ParseRegister(parts[1]);
@@ -599,6 +620,19 @@ UInt32 AssemblerStorage::AddLine(String line,Int32 lineNumber) {
 		Byte funcRefReg = ParseRegister(parts[3]);
 		instruction = BytecodeUtil::INS_ABC(Opcode::CALL_rA_rB_rC, destReg, stackReg, funcRefReg);
 
+	} else if (mnemonic == "CALLINTRINSIC") {
+		// CALLINTRINSIC r1, r5, 12  -->  r1 = intrinsic 12, frame at r5 (after ARGBLK/ARGs)
+		if (parts.Count() != 4) { Error("Syntax error: CALLINTRINSIC requires exactly 3 operands"); return 0; }
+		Byte destReg = ParseRegister(parts[1]);
+		Current.ReserveRegister(destReg);
+		Byte stackReg = ParseRegister(parts[2]);
+		Int32 intrinsicIdx = ParseInt32(parts[3]);
+		if (intrinsicIdx < 0 || intrinsicIdx > 255) {
+			Error("CALLINTRINSIC intrinsic index out of range");
+			return 0;
+		}
+		instruction = BytecodeUtil::INS_ABC(Opcode::CALLINTRINSIC_rA_rB_iC, destReg, stackReg, (Byte)intrinsicIdx);
+
 	} else if (mnemonic == "RETURN") {
 		instruction = BytecodeUtil::INS(Opcode::RETURN);
 
@@ -649,6 +683,13 @@ UInt32 AssemblerStorage::AddLine(String line,Int32 lineNumber) {
 		Byte indexReg = ParseRegister(parts[3]);
 		instruction = BytecodeUtil::INS_ABC(Opcode::ITERGET_rA_rB_rC, dest, containerReg, indexReg);
 
+	} else if (mnemonic == "ITERNEXT") {
+		if (parts.Count() != 4) { Error("ITERNEXT requires 3 operands"); return 0; }
+		Byte dest = ParseRegister(parts[1]);
+		Byte containerReg = ParseRegister(parts[2]);
+		Byte indexReg = ParseRegister(parts[3]);
+		instruction = BytecodeUtil::INS_ABC(Opcode::ITERNEXT_rA_rB_rC, dest, containerReg, indexReg);
+
 	} else if (mnemonic == "ERRCHK") {
 		if (parts.Count() != 2) { Error("ERRCHK requires 1 operand"); return 0; }
 		Byte reg = ParseRegister(parts[1]);
@@ -864,7 +905,7 @@ Value AssemblerStorage::ParseAsConstant(String token) {
 	if (IsStringLiteral(token)) {
 		// Remove quotes and create string value
 		String content = token.Substring(1, token.Length() - 2);
-		return Value::make_string(content);
+		return Value::make_interned_string(content);
 	}
 	
 	// Check if it contains a decimal point (floating point number).
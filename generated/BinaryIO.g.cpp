@@ -0,0 +1,140 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: BinaryIO.cs
+
+#include "BinaryIO.g.h"
+#include <cstring>
+
+namespace MiniScript {
+
+ByteWriterStorage::ByteWriterStorage() {
+}
+void ByteWriterStorage::WriteU8(Byte b) {
+	Data.Add(b);
+}
+void ByteWriterStorage::WriteU16(UInt16 v) {
+	Data.Add((Byte)(v & 0xFF));
+	Data.Add((Byte)(v >> 8));
+}
+void ByteWriterStorage::WriteU32(UInt32 v) {
+	Data.Add((Byte)(v & 0xFF));
+	Data.Add((Byte)((v >> 8) & 0xFF));
+	Data.Add((Byte)((v >> 16) & 0xFF));
+	Data.Add((Byte)(v >> 24));
+}
+void ByteWriterStorage::WriteU64(UInt64 v) {
+	WriteU32((UInt32)(v & 0xFFFFFFFF));
+	WriteU32((UInt32)(v >> 32));
+}
+void ByteWriterStorage::WriteDouble(Double d) {
+	UInt64 bits; memcpy(&bits, &d, sizeof(bits));
+	WriteU64(bits);
+}
+void ByteWriterStorage::WriteString(String s) {
+	Int32 len = s.LengthB();
+	WriteU32((UInt32)len);
+	const char* p = s.c_str();
+	for (Int32 i = 0; i < len; i++) Data.Add((Byte)p[i]);
+}
+void ByteWriterStorage::PatchU32(Int32 pos,UInt32 v) {
+	Data[pos] = (Byte)(v & 0xFF);
+	Data[pos + 1] = (Byte)((v >> 8) & 0xFF);
+	Data[pos + 2] = (Byte)((v >> 16) & 0xFF);
+	Data[pos + 3] = (Byte)(v >> 24);
+}
+void ByteWriterStorage::Align(Int32 size) {
+	while (Data.Count() % size != 0) Data.Add(0);
+}
+
+ByteReaderStorage::ByteReaderStorage() {
+}
+ByteReader ByteReaderStorage::FromList(List<Byte> data) {
+	ByteReader r =  ByteReader::New();
+	r.set__list(data);
+	r.set_Count(data.Count());
+	r.get_storage()->_bytes = r.Count() > 0 ? &data[0] : nullptr;
+	return r;
+}
+ByteReader ByteReaderStorage::FromFile(String path) {
+	ByteReader r =  ByteReader::New();
+	std::shared_ptr<MappedFile> file = MappedFile::Open(path.c_str());
+	if (!file || file->Size() > 0x7FFFFFFF) return nullptr;
+	r.get_storage()->_file = file;
+	r.get_storage()->_bytes = file->Data();
+	r.set_Count((Int32)file->Size());
+	return r;
+}
+ByteReader ByteReaderStorage::Cursor(Int32 pos) {
+	ByteReader r =  ByteReader::New();
+	r.get_storage()->_bytes = _bytes; r.get_storage()->_file = _file;
+	r.set__list(_list);
+	r.set_Count(Count);
+	r.set_Pos(pos);
+	return r;
+}
+Boolean ByteReaderStorage::AtEnd() {
+	return Pos >= Count;
+}
+Boolean ByteReaderStorage::Need(Int32 byteCount) {
+	if (Failed || byteCount < 0 || byteCount > Count - Pos) {
+		Failed = Boolean(true);
+		return Boolean(false);
+	}
+	return Boolean(true);
+}
+Byte ByteReaderStorage::ReadU8() {
+	if (!Need(1)) return 0;
+	Byte b = _bytes[Pos];
+	Pos += 1;
+	return b;
+}
+UInt16 ByteReaderStorage::ReadU16() {
+	if (!Need(2)) return 0;
+	UInt16 v = (UInt16)(_bytes[Pos] | (_bytes[Pos + 1] << 8));
+	Pos += 2;
+	return v;
+}
+UInt32 ByteReaderStorage::ReadU32() {
+	if (!Need(4)) return 0;
+	UInt32 v = (UInt32)_bytes[Pos] | ((UInt32)_bytes[Pos + 1] << 8)
+		| ((UInt32)_bytes[Pos + 2] << 16) | ((UInt32)_bytes[Pos + 3] << 24);
+	Pos += 4;
+	return v;
+}
+UInt64 ByteReaderStorage::ReadU64() {
+	UInt64 lo = ReadU32();
+	UInt64 hi = ReadU32();
+	return lo | (hi << 32);
+}
+Double ByteReaderStorage::ReadDouble() {
+	UInt64 bits = ReadU64();
+	Double d; memcpy(&d, &bits, sizeof(d)); return d;
+}
+Int32 ByteReaderStorage::ReadCount() {
+	UInt32 n = ReadU32();
+	if (n > (UInt32)(Count - Pos)) {
+		Failed = Boolean(true);
+		return 0;
+	}
+	return (Int32)n;
+}
+String ByteReaderStorage::ReadString() {
+	Int32 len = ReadCount();
+	if (!Need(len)) return "";
+	String result((const char*)(_bytes + Pos), (size_t)len);
+	Pos += len;
+	return result;
+}
+void ByteReaderStorage::Skip(Int32 byteCount) {
+	if (Need(byteCount)) Pos += byteCount;
+}
+void ByteReaderStorage::Align(Int32 size) {
+	Int32 extra = Pos % size;
+	if (extra != 0) Skip(size - extra);
+}
+UInt64 ByteReaderStorage::Checksum(Int32 start) {
+	UInt64 h = 0xCBF29CE484222325UL;
+	for (Int32 i = start; i < Count; i++) h = (h ^ _bytes[i]) * 0x100000001B3UL;
+	return h;
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,241 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: BinaryIO.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// BinaryIO.cs
+// Little-endian binary reading and writing, as used by the bytecode cache
+// (BytecodeCache.cs).  A ByteReader can read either a byte list or a whole
+// file; in C++ the file is memory-mapped (see core/mapped_file.h) rather than
+// copied, so data in it can be used in place for as long as the reader lives.
+
+#include "mapped_file.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class ByteWriterStorage : public std::enable_shared_from_this<ByteWriterStorage> {
+	friend struct ByteWriter;
+	public: List<Byte> Data = List<Byte>::New();
+
+	public: ByteWriterStorage();
+
+	public: void WriteU8(Byte b);
+
+	public: void WriteU16(UInt16 v);
+
+	public: void WriteU32(UInt32 v);
+
+	public: void WriteU64(UInt64 v);
+
+	public: void WriteDouble(Double d);
+
+	// A string is its UTF-8 byte length followed by the bytes.
+	public: void WriteString(String s);
+
+	// Overwrite four bytes already written at pos (e.g. a length that was not
+	// known until what follows it had been written).
+	public: void PatchU32(Int32 pos, UInt32 v);
+
+	// Write zero bytes until the length is a multiple of the given size.
+	public: void Align(Int32 size);
+}; // end of class ByteWriterStorage
+
+class ByteReaderStorage : public std::enable_shared_from_this<ByteReaderStorage> {
+	friend struct ByteReader;
+	private: const Byte* _bytes = nullptr;
+	private: std::shared_ptr<MappedFile> _file;  // owns _bytes, when reading a file
+	private: List<Byte> _list = nullptr; // owns _bytes (in C++), when reading a list
+	public: Int32 Count = 0;
+	public: Int32 Pos = 0;
+	public: Boolean Failed = Boolean(false);
+	public: const Byte* BytesAt(Int32 pos) const { return _bytes + pos; }
+
+	public: ByteReaderStorage();
+
+	// Read from a byte list, which must not change while the reader is in use.
+	public: static ByteReader FromList(List<Byte> data);
+
+	// Read a whole file (mapped into memory, in C++), or return null if it
+	// cannot be read.
+	public: static ByteReader FromFile(String path);
+
+	// A second reader of the same data, starting at the given position.  It
+	// keeps the data alive for as long as it lives, just as this one does.
+	public: ByteReader Cursor(Int32 pos);
+
+	public: Boolean AtEnd();
+
+	private: Boolean Need(Int32 byteCount);
+
+	public: Byte ReadU8();
+
+	public: UInt16 ReadU16();
+
+	public: UInt32 ReadU32();
+
+	public: UInt64 ReadU64();
+
+	public: Double ReadDouble();
+
+	// Read a count (a U32 sizing what follows), failing if it is larger than
+	// the bytes remaining could possibly hold.
+	public: Int32 ReadCount();
+
+	public: String ReadString();
+
+	public: void Skip(Int32 byteCount);
+
+	// Skip to the next multiple of the given size (see ByteWriter.Align).
+	public: void Align(Int32 size);
+
+	// 64-bit FNV-1a over the bytes from start to the end of the data.
+	public: UInt64 Checksum(Int32 start);
+}; // end of class ByteReaderStorage
+
+// Appends little-endian binary data to a byte list.
+struct ByteWriter {
+	friend class ByteWriterStorage;
+	protected: std::shared_ptr<ByteWriterStorage> storage;
+  public:
+	ByteWriter(std::shared_ptr<ByteWriterStorage> stor) : storage(stor) {}
+	ByteWriter() : storage(nullptr) {}
+	ByteWriter(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const ByteWriter& inst) { return inst.storage == nullptr; }
+	private: ByteWriterStorage* get() const;
+
+	public: List<Byte> Data();
+	public: void set_Data(List<Byte> _v);
+
+	public: static ByteWriter New() {
+		return ByteWriter(std::make_shared<ByteWriterStorage>());
+	}
+
+	public: inline void WriteU8(Byte b);
+
+	public: inline void WriteU16(UInt16 v);
+
+	public: inline void WriteU32(UInt32 v);
+
+	public: inline void WriteU64(UInt64 v);
+
+	public: inline void WriteDouble(Double d);
+
+	// A string is its UTF-8 byte length followed by the bytes.
+	public: inline void WriteString(String s);
+
+	// Overwrite four bytes already written at pos (e.g. a length that was not
+	// known until what follows it had been written).
+	public: inline void PatchU32(Int32 pos, UInt32 v);
+
+	// Write zero bytes until the length is a multiple of the given size.
+	public: inline void Align(Int32 size);
+}; // end of struct ByteWriter
+
+// Reads little-endian binary data.  Reading past the end sets Failed (and
+// yields zeros) rather than throwing, so truncated or corrupt data can be
+// detected once, by checking Failed after a batch of reads.
+struct ByteReader {
+	friend class ByteReaderStorage;
+	protected: std::shared_ptr<ByteReaderStorage> storage;
+  public:
+	ByteReader(std::shared_ptr<ByteReaderStorage> stor) : storage(stor) {}
+	ByteReader() : storage(nullptr) {}
+	ByteReader(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const ByteReader& inst) { return inst.storage == nullptr; }
+	private: ByteReaderStorage* get() const;
+
+	private: List<Byte> _list(); // owns _bytes (in C++), when reading a list
+	private: void set__list(List<Byte> _v); // owns _bytes (in C++), when reading a list
+	public: Int32 Count();
+	public: void set_Count(Int32 _v);
+	public: Int32 Pos();
+	public: void set_Pos(Int32 _v);
+	public: Boolean Failed();
+	public: void set_Failed(Boolean _v);
+	public: ByteReaderStorage* get_storage() const { return storage.get(); }
+
+	public: static ByteReader New() {
+		return ByteReader(std::make_shared<ByteReaderStorage>());
+	}
+
+	// Read from a byte list, which must not change while the reader is in use.
+	public: static ByteReader FromList(List<Byte> data) { return ByteReaderStorage::FromList(data); }
+
+	// Read a whole file (mapped into memory, in C++), or return null if it
+	// cannot be read.
+	public: static ByteReader FromFile(String path) { return ByteReaderStorage::FromFile(path); }
+
+	// A second reader of the same data, starting at the given position.  It
+	// keeps the data alive for as long as it lives, just as this one does.
+	public: inline ByteReader Cursor(Int32 pos);
+
+	public: inline Boolean AtEnd();
+
+	private: inline Boolean Need(Int32 byteCount);
+
+	public: inline Byte ReadU8();
+
+	public: inline UInt16 ReadU16();
+
+	public: inline UInt32 ReadU32();
+
+	public: inline UInt64 ReadU64();
+
+	public: inline Double ReadDouble();
+
+	// Read a count (a U32 sizing what follows), failing if it is larger than
+	// the bytes remaining could possibly hold.
+	public: inline Int32 ReadCount();
+
+	public: inline String ReadString();
+
+	public: inline void Skip(Int32 byteCount);
+
+	// Skip to the next multiple of the given size (see ByteWriter.Align).
+	public: inline void Align(Int32 size);
+
+	// 64-bit FNV-1a over the bytes from start to the end of the data.
+	public: inline UInt64 Checksum(Int32 start);
+}; // end of struct ByteReader
+
+// INLINE METHODS
+
+inline ByteWriterStorage* ByteWriter::get() const { return static_cast<ByteWriterStorage*>(storage.get()); }
+inline List<Byte> ByteWriter::Data() { return get()->Data; }
+inline void ByteWriter::set_Data(List<Byte> _v) { get()->Data = _v; }
+inline void ByteWriter::WriteU8(Byte b) { return get()->WriteU8(b); }
+inline void ByteWriter::WriteU16(UInt16 v) { return get()->WriteU16(v); }
+inline void ByteWriter::WriteU32(UInt32 v) { return get()->WriteU32(v); }
+inline void ByteWriter::WriteU64(UInt64 v) { return get()->WriteU64(v); }
+inline void ByteWriter::WriteDouble(Double d) { return get()->WriteDouble(d); }
+inline void ByteWriter::WriteString(String s) { return get()->WriteString(s); }
+inline void ByteWriter::PatchU32(Int32 pos,UInt32 v) { return get()->PatchU32(pos, v); }
+inline void ByteWriter::Align(Int32 size) { return get()->Align(size); }
+
+inline ByteReaderStorage* ByteReader::get() const { return static_cast<ByteReaderStorage*>(storage.get()); }
+inline List<Byte> ByteReader::_list() { return get()->_list; } // owns _bytes (in C++), when reading a list
+inline void ByteReader::set__list(List<Byte> _v) { get()->_list = _v; } // owns _bytes (in C++), when reading a list
+inline Int32 ByteReader::Count() { return get()->Count; }
+inline void ByteReader::set_Count(Int32 _v) { get()->Count = _v; }
+inline Int32 ByteReader::Pos() { return get()->Pos; }
+inline void ByteReader::set_Pos(Int32 _v) { get()->Pos = _v; }
+inline Boolean ByteReader::Failed() { return get()->Failed; }
+inline void ByteReader::set_Failed(Boolean _v) { get()->Failed = _v; }
+inline ByteReader ByteReader::Cursor(Int32 pos) { return get()->Cursor(pos); }
+inline Boolean ByteReader::AtEnd() { return get()->AtEnd(); }
+inline Boolean ByteReader::Need(Int32 byteCount) { return get()->Need(byteCount); }
+inline Byte ByteReader::ReadU8() { return get()->ReadU8(); }
+inline UInt16 ByteReader::ReadU16() { return get()->ReadU16(); }
+inline UInt32 ByteReader::ReadU32() { return get()->ReadU32(); }
+inline UInt64 ByteReader::ReadU64() { return get()->ReadU64(); }
+inline Double ByteReader::ReadDouble() { return get()->ReadDouble(); }
+inline Int32 ByteReader::ReadCount() { return get()->ReadCount(); }
+inline String ByteReader::ReadString() { return get()->ReadString(); }
+inline void ByteReader::Skip(Int32 byteCount) { return get()->Skip(byteCount); }
+inline void ByteReader::Align(Int32 size) { return get()->Align(size); }
+inline UInt64 ByteReader::Checksum(Int32 start) { return get()->Checksum(start); }
+
+} // end of namespace MiniScript
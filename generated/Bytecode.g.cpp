@@ -46,10 +46,17 @@ EmitPattern BytecodeUtil::GetEmitPattern(Opcode opcode) {
 	// No suffix - opcode only (NOOP, RETURN, etc.)
 	return EmitPattern::None;
 }
+thread_local List<EmitPattern> BytecodeUtil::_emitPatterns;
 Boolean BytecodeUtil::CheckEmitPattern(Opcode opcode,EmitPattern expected) {
 	if (!ValidateOpcodes) return Boolean(true);
 
-	EmitPattern actual = GetEmitPattern(opcode);
+	if (IsNull(_emitPatterns)) {
+		_emitPatterns =  List<EmitPattern>::New();
+		for (Int32 i = 0; i < (Int32)Opcode::OP__COUNT; i++) {
+			_emitPatterns.Add(GetEmitPattern((Opcode)i));
+		}
+	}
+	EmitPattern actual = _emitPatterns[(Int32)opcode];
 	if (actual == expected) return Boolean(true);
 
 	// Mismatch - report error
@@ -84,6 +91,7 @@ String BytecodeUtil::ToMnemonic(Opcode opcode) {
 		case Opcode::LOADC_rA_rB_kC: return "LOADC_rA_rB_kC";
 		case Opcode::LOADV_rA_rB_rC: return "LOADV_rA_rB_rC";
 		case Opcode::LOADC_rA_rB_rC: return "LOADC_rA_rB_rC";
+		case Opcode::LOADC_rA_rB:    return "LOADC_rA_rB";
 		case Opcode::FUNCREF_iA_iBC: return "FUNCREF_iA_iBC";
 		case Opcode::ASSIGN_rA_rB_kC:return "ASSIGN_rA_rB_kC";
 		case Opcode::NAME_rA_kBC:    return "NAME_rA_kBC";
@@ -143,12 +151,14 @@ String BytecodeUtil::ToMnemonic(Opcode opcode) {
 		case Opcode::IFEQ_rA_iBC:    return "IFEQ_rA_iBC";
 		case Opcode::IFNE_rA_rB:     return "IFNE_rA_rB";
 		case Opcode::IFNE_rA_iBC:    return "IFNE_rA_iBC";
+		case Opcode::IFFUNC_rA_kBC:  return "IFFUNC_rA_kBC";
 		case Opcode::NEXT_rA_rB:     return "NEXT_rA_rB";
 		case Opcode::ARGBLK_iABC:  return "ARGBLK_iABC";
 		case Opcode::ARG_rA:         return "ARG_rA";
 		case Opcode::ARG_iABC:       return "ARG_iABC";
 		case Opcode::CALLF_iA_iBC:   return "CALLF_iA_iBC";
 		case Opcode::CALL_rA_rB_rC:  return "CALL_rA_rB_rC";
+		case Opcode::CALLINTRINSIC_rA_rB_iC: return "CALLINTRINSIC_rA_rB_iC";
 		case Opcode::RETURN:         return "RETURN";
 		case Opcode::NEW_rA_rB:      return "NEW_rA_rB";
 		case Opcode::ISA_rA_rB_rC:   return "ISA_rA_rB_rC";
@@ -157,6 +167,7 @@ String BytecodeUtil::ToMnemonic(Opcode opcode) {
 		case Opcode::SETSELF_rA:     return "SETSELF_rA";
 		case Opcode::CALLIFREF_rA:   return "CALLIFREF_rA";
 		case Opcode::ITERGET_rA_rB_rC: return "ITERGET_rA_rB_rC";
+		case Opcode::ITERNEXT_rA_rB_rC: return "ITERNEXT_rA_rB_rC";
 		case Opcode::ERRCHK_rA:      return "ERRCHK_rA";
 		default:
 			return "Unknown opcode";
@@ -172,6 +183,7 @@ Opcode BytecodeUtil::FromMnemonic(String s) {
 	if (s == "LOADC_rA_rB_kC")  return Opcode::LOADC_rA_rB_kC;
 	if (s == "LOADV_rA_rB_rC")  return Opcode::LOADV_rA_rB_rC;
 	if (s == "LOADC_rA_rB_rC")  return Opcode::LOADC_rA_rB_rC;
+	if (s == "LOADC_rA_rB")     return Opcode::LOADC_rA_rB;
 	if (s == "FUNCREF_iA_iBC")  return Opcode::FUNCREF_iA_iBC;
 	if (s == "ASSIGN_rA_rB_kC") return Opcode::ASSIGN_rA_rB_kC;
 	if (s == "NAME_rA_kBC")     return Opcode::NAME_rA_kBC;
@@ -231,12 +243,14 @@ Opcode BytecodeUtil::FromMnemonic(String s) {
 	if (s == "IFEQ_rA_iBC")     return Opcode::IFEQ_rA_iBC;
 	if (s == "IFNE_rA_rB")      return Opcode::IFNE_rA_rB;
 	if (s == "IFNE_rA_iBC")     return Opcode::IFNE_rA_iBC;
+	if (s == "IFFUNC_rA_kBC")   return Opcode::IFFUNC_rA_kBC;
 	if (s == "NEXT_rA_rB")      return Opcode::NEXT_rA_rB;
 	if (s == "ARGBLK_iABC")     return Opcode::ARGBLK_iABC;
 	if (s == "ARG_rA")          return Opcode::ARG_rA;
 	if (s == "ARG_iABC")        return Opcode::ARG_iABC;
 	if (s == "CALLF_iA_iBC")    return Opcode::CALLF_iA_iBC;
 	if (s == "CALL_rA_rB_rC")   return Opcode::CALL_rA_rB_rC;
+	if (s == "CALLINTRINSIC_rA_rB_iC") return Opcode::CALLINTRINSIC_rA_rB_iC;
 	if (s == "RETURN")          return Opcode::RETURN;
 	if (s == "NEW_rA_rB")       return Opcode::NEW_rA_rB;
 	if (s == "ISA_rA_rB_rC")    return Opcode::ISA_rA_rB_rC;
@@ -245,6 +259,7 @@ Opcode BytecodeUtil::FromMnemonic(String s) {
 	if (s == "SETSELF_rA")      return Opcode::SETSELF_rA;
 	if (s == "CALLIFREF_rA")    return Opcode::CALLIFREF_rA;
 	if (s == "ITERGET_rA_rB_rC") return Opcode::ITERGET_rA_rB_rC;
+	if (s == "ITERNEXT_rA_rB_rC") return Opcode::ITERNEXT_rA_rB_rC;
 	if (s == "ERRCHK_rA")       return Opcode::ERRCHK_rA;
 	return Opcode::NOOP;
 }
@@ -31,6 +31,7 @@ enum class Opcode : Byte {
 	LOADC_rA_rB_kC,
 	LOADV_rA_rB_rC,
 	LOADC_rA_rB_rC,
+	LOADC_rA_rB,
 	FUNCREF_iA_iBC,
 	ASSIGN_rA_rB_kC,
 	NAME_rA_kBC,
@@ -90,12 +91,14 @@ enum class Opcode : Byte {
 	IFEQ_rA_iBC,
 	IFNE_rA_rB,
 	IFNE_rA_iBC,
+	IFFUNC_rA_kBC,
 	NEXT_rA_rB,
 	ARGBLK_iABC,
 	ARG_rA,
 	ARG_iABC,
 	CALLF_iA_iBC,
 	CALL_rA_rB_rC,
+	CALLINTRINSIC_rA_rB_iC,
 	RETURN,
 	NEW_rA_rB,
 	ISA_rA_rB_rC,
@@ -104,6 +107,7 @@ enum class Opcode : Byte {
 	SETSELF_rA,
 	CALLIFREF_rA,
 	ITERGET_rA_rB_rC,
+	ITERNEXT_rA_rB_rC,
 	ERRCHK_rA,
 	OP__COUNT  // Not an opcode, but rather how many opcodes we have.
 }; // end of enum Opcode
@@ -114,6 +118,12 @@ class BytecodeUtil {
 
 	// Determine the expected emit pattern for an opcode based on its mnemonic
 	public: static EmitPattern GetEmitPattern(Opcode opcode);
+	private: thread_local static List<EmitPattern> _emitPatterns;
+
+	// GetEmitPattern for every opcode, indexed by opcode.  Working it out from
+	// the mnemonic takes a dozen substring searches, far too many to repeat on
+	// every instruction emitted, so CheckEmitPattern fills this on first use
+	// (on each thread, so that isolates compiling at once do not race on it).
 
 	// Validate that an opcode matches the expected emit pattern
 	// Returns true if valid, false if mismatch (and prints error)
@@ -0,0 +1,487 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: BytecodeCache.cs
+
+#include "BytecodeCache.g.h"
+#include "Bytecode.g.h"
+#include "CoreIntrinsics.g.h"
+#include "Intrinsic.g.h"
+#include "StringUtils.g.h"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+namespace MiniScript {
+
+const UInt32 BytecodeCache::kMagic = 0x4342534D;
+const UInt32 BytecodeCache::kFormatVersion = 4;
+const Int32 BytecodeCache::kHeaderSize = 24;
+const Byte BytecodeCache::kTagNull = 0;
+const Byte BytecodeCache::kTagNumber = 1;
+const Byte BytecodeCache::kTagString = 2;
+const Byte BytecodeCache::kTagFuncRef = 3;
+const Byte BytecodeCache::kTagList = 4;
+const Byte BytecodeCache::kTagMap = 5;
+String BytecodeCache::CacheDirectory = "";
+Boolean BytecodeCache::_directoryResolved = Boolean(false);
+String BytecodeCache::_compilerVersion = "";
+Int32 BytecodeCache::_tempFileCount = 0;
+static std::mutex _mutex;
+
+// Size and modification time of the running executable, which change
+// whenever it is relinked.  Where that cannot be found, the build time
+// of this file stands in for it.
+static String BinaryStamp() {
+	char buf[64];
+	struct stat st;
+	#if defined(__linux__)
+	if (stat("/proc/self/exe", &st) == 0) {
+		snprintf(buf, sizeof(buf), "%lld.%lld.%ld", (long long)st.st_size,
+			(long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec);
+		return String(buf);
+	}
+	#elif defined(__APPLE__)
+	char exePath[1024];
+	uint32_t exePathSize = sizeof(exePath);
+	if (_NSGetExecutablePath(exePath, &exePathSize) == 0 && stat(exePath, &st) == 0) {
+		snprintf(buf, sizeof(buf), "%lld.%lld.%ld", (long long)st.st_size,
+			(long long)st.st_mtimespec.tv_sec, (long)st.st_mtimespec.tv_nsec);
+		return String(buf);
+	}
+	#endif
+	(void)buf; (void)st;
+	return String("C++ " __DATE__ " " __TIME__);
+}
+String BytecodeCache::GetDirectory() {
+	Lock();
+	if (!_directoryResolved) {
+		_directoryResolved = Boolean(true);
+		if (CacheDirectory.Length() == 0) {
+			const char* env = getenv("MS_BYTECODE_CACHE");
+			if (env) CacheDirectory = String(env);
+		}
+	}
+	String dir = CacheDirectory;
+	Unlock();
+	return dir;
+}
+UInt64 BytecodeCache::HashString(UInt64 h,String s) {
+	const unsigned char* p = (const unsigned char*)s.c_str();
+	Int32 len = s.LengthB();
+	for (Int32 i = 0; i < len; i++) h = (h ^ p[i]) * 0x100000001B3ULL;
+	return (h ^ 0xFF) * 0x100000001B3UL;   // terminator, so "ab"+"c" != "a"+"bc"
+}
+String BytecodeCache::CompilerVersion() {
+	Lock();
+	String version = _compilerVersion;
+	Unlock();
+	if (version.Length() > 0) return version;
+
+	UInt64 h = 0xCBF29CE484222325UL;
+	for (Int32 i = 0; i < (Int32)Opcode::OP__COUNT; i++) {
+		h = HashString(h, BytecodeUtil::ToMnemonic((Opcode)i));
+	}
+	Int32 count = Intrinsic::Count();
+	for (Int32 i = 0; i < count; i++) {
+		Intrinsic intr = Intrinsic::GetByIndex(i);
+		if (intr.Core()) h = HashString(h, intr.Name());
+	}
+	String build = BinaryStamp();
+	version = StringUtils::Format("{0}/{1}/{2}/{3}/{4}", CoreIntrinsics::hostVersion,
+		kFormatVersion, StringUtils::ToHex((UInt32)(h >> 32)),
+		StringUtils::ToHex((UInt32)(h & 0xFFFFFFFF)), build);
+
+	Lock();
+	_compilerVersion = version;
+	Unlock();
+	return version;
+}
+UInt64 BytecodeCache::SourceKey(String source,String fileName,Boolean isImport) {
+	UInt64 h = 0xCBF29CE484222325UL;
+	h = HashString(h, CompilerVersion());
+	h = HashString(h, isImport ? "import" : "program");
+	h = HashString(h, fileName);
+	h = HashString(h, source);
+	return h;
+}
+String BytecodeCache::CachePath(String dir,UInt64 key) {
+	String sep = (dir.EndsWith("/") || dir.EndsWith("\\")) ? "" : "/";
+	return dir + sep + StringUtils::ToHex((UInt32)(key >> 32))
+		+ StringUtils::ToHex((UInt32)(key & 0xFFFFFFFF)) + ".msc";
+}
+List<FuncDef> BytecodeCache::Load(String source,String fileName,Boolean isImport) {
+	String dir = GetDirectory();
+	if (dir.Length() == 0) return nullptr;
+	UInt64 key = SourceKey(source, fileName, isImport);
+	ByteReader data = ByteReader::FromFile(CachePath(dir, key));
+	if (IsNull(data)) return nullptr;
+	return DeserializeFrom(data, key);
+}
+void BytecodeCache::Store(String source,String fileName,Boolean isImport,List<FuncDef> functions) {
+	String dir = GetDirectory();
+	if (dir.Length() == 0) return;
+	UInt64 key = SourceKey(source, fileName, isImport);
+	List<Byte> data = Serialize(functions, key);
+	if (IsNull(data)) return;
+	WriteFileBytes(dir, CachePath(dir, key), data);
+}
+List<Byte> BytecodeCache::Serialize(List<FuncDef> functions,UInt64 key) {
+	ByteWriter w =  ByteWriter::New();
+	w.WriteU32(kMagic);
+	w.WriteU32(kFormatVersion);
+	w.WriteU64(key);
+	w.WriteU64(0);		// checksum, patched below
+	w.WriteU32((UInt32)functions.Count());
+	List<Int32> childCounts =  List<Int32>::New();
+	for (Int32 i = 0; i < functions.Count(); i++) {
+		if (!WriteFunction(w, i, functions, childCounts)) return nullptr;
+	}
+	UInt64 checksum = ByteReader::FromList(w.Data()).Checksum(kHeaderSize);
+	w.PatchU32(kHeaderSize - 8, (UInt32)(checksum & 0xFFFFFFFF));
+	w.PatchU32(kHeaderSize - 4, (UInt32)(checksum >> 32));
+	return w.Data();
+}
+Boolean BytecodeCache::WriteFunction(ByteWriter w,Int32 index,List<FuncDef> functions,List<Int32> childCounts) {
+	FuncDef f = functions[index];
+	if (!IsNull(f.NativeCallback())) return Boolean(false);
+	f.EnsureConstants();
+	w.WriteString(f.Name());
+	w.WriteString(f.FileName());
+	w.WriteString(f.Note());
+	w.WriteString(f.SourceLoc());
+	w.WriteU16(f.MaxRegs());
+	w.WriteU16((UInt16)f.SelfReg());
+	w.WriteU16((UInt16)f.SuperReg());
+
+	Int32 runs = f.LineRunCount();
+	w.WriteU32((UInt32)runs);
+	for (Int32 i = 0; i < runs; i++) {
+		w.WriteU32((UInt32)f.LineRunPC(i));
+		w.WriteU32((UInt32)f.LineRunLine(i));
+	}
+
+	Int32 inlines = f.InlineRangeCount();
+	w.WriteU32((UInt32)inlines);
+	for (Int32 i = 0; i < inlines; i++) {
+		w.WriteU32((UInt32)f.InlineRangeStart(i));
+		w.WriteU32((UInt32)f.InlineRangeEnd(i));
+		w.WriteU32((UInt32)f.InlineRangeCallLine(i));
+	}
+
+	// The values go into blocks of their own first, because writing them
+	// is what discovers the children table that has to precede them.
+	List<Int32> children =  List<Int32>::New();
+	ByteWriter header =  ByteWriter::New();
+	if (!WriteValues(header, f.ParamNames(), functions, children)) return Boolean(false);
+	if (!WriteValues(header, f.ParamDefaults(), functions, children)) return Boolean(false);
+	if (!WriteValues(header, f.GlobalNames(), functions, children)) return Boolean(false);
+	ByteWriter constants =  ByteWriter::New();
+	if (!WriteValues(constants, f.Constants(), functions, children)) return Boolean(false);
+
+	// A function mostly refers to templates of the functions nested in it,
+	// which CodeGenerator places after it in the list.  The exception is the
+	// guard of an inlined call, which names a function compiled earlier; but
+	// only a function with no templates of its own can be inlined.  Insisting
+	// on one or the other keeps the loaded functions' LazyChildren links free
+	// of cycles.
+	w.WriteU32((UInt32)children.Count());
+	for (Int32 i = 0; i < children.Count(); i++) {
+		Int32 child = children[i];
+		if (child == index) return Boolean(false);
+		if (child < index && childCounts[child] != 0) return Boolean(false);
+		w.WriteU32((UInt32)child);
+	}
+	childCounts.Add(children.Count());
+	w.WriteU32((UInt32)header.Data().Count());
+	w.Data().AddRange(header.Data());
+	w.WriteU32((UInt32)constants.Data().Count());
+	w.Data().AddRange(constants.Data());
+
+	// Code is 4-byte aligned in the file, so that it can be used in place.
+	Int32 codeCount = f.CodeCount();
+	w.WriteU32((UInt32)codeCount);
+	w.Align(4);
+	for (Int32 i = 0; i < codeCount; i++) w.WriteU32(f.CodeAt(i));
+	return Boolean(true);
+}
+Boolean BytecodeCache::WriteValues(ByteWriter w,List<Value> values,List<FuncDef> functions,List<Int32> children) {
+	w.WriteU32((UInt32)values.Count());
+	for (Int32 i = 0; i < values.Count(); i++) {
+		if (!WriteValue(w, values[i], functions, children)) return Boolean(false);
+	}
+	return Boolean(true);
+}
+Boolean BytecodeCache::WriteValue(ByteWriter w,Value v,List<FuncDef> functions,List<Int32> children) {
+	if (v.IsNull()) {
+		w.WriteU8(kTagNull);
+	} else if (v.IsNumber()) {
+		w.WriteU8(kTagNumber);
+		w.WriteDouble(v.AsDouble());
+	} else if (v.IsString()) {
+		w.WriteU8(kTagString);
+		w.WriteString(v.AsCString());
+	} else if (v.IsFuncRef()) {
+		if (!v.OuterVars().IsNull()) return Boolean(false);
+		FuncDef target = v.FunctionDef();
+		Int32 index = -1;
+		for (Int32 i = 0; i < functions.Count(); i++) {
+			// (Compare storage, not FuncDefs: in C++ those convert to bool.)
+			if (functions[i].get_storage() == target.get_storage()) { index = i; break; }
+		}
+		if (index < 0) return Boolean(false);
+		Int32 child = children.IndexOf(index);
+		if (child < 0) {
+			child = children.Count();
+			children.Add(index);
+		}
+		w.WriteU8(kTagFuncRef);
+		w.WriteU32((UInt32)child);
+	} else if (v.IsList()) {
+		w.WriteU8(kTagList);
+		Int32 count = v.ListCount();
+		w.WriteU32((UInt32)count);
+		for (Int32 i = 0; i < count; i++) {
+			if (!WriteValue(w, v.ListGet(i), functions, children)) return Boolean(false);
+		}
+	} else if (v.IsMap()) {
+		w.WriteU8(kTagMap);
+		GCMap m = GCManager::Maps.Get(v.ItemIndex());
+		w.WriteU32((UInt32)m.Count());
+		for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+			if (!WriteValue(w, m.KeyAt(i), functions, children)) return Boolean(false);
+			if (!WriteValue(w, m.ValueAt(i), functions, children)) return Boolean(false);
+		}
+	} else {
+		return Boolean(false);
+	}
+	return Boolean(true);
+}
+List<FuncDef> BytecodeCache::Deserialize(List<Byte> data,UInt64 key) {
+	return DeserializeFrom(ByteReader::FromList(data), key);
+}
+List<FuncDef> BytecodeCache::DeserializeFrom(ByteReader r,UInt64 key) {
+	if (r.ReadU32() != kMagic) return nullptr;
+	if (r.ReadU32() != kFormatVersion) return nullptr;
+	if (r.ReadU64() != key) return nullptr;
+	UInt64 checksum = r.ReadU64();
+	if (r.Failed() || r.Checksum(kHeaderSize) != checksum) return nullptr;
+	Int32 count = r.ReadCount();
+	if (r.Failed() || count == 0) return nullptr;
+
+	// Create every FuncDef first, so function templates can refer forward.
+	List<FuncDef> functions =  List<FuncDef>::New();
+	for (Int32 i = 0; i < count; i++) functions.Add( FuncDef::New());
+	for (Int32 i = 0; i < count; i++) {
+		if (!ReadFunction(r, i, functions)) return nullptr;
+	}
+	if (r.Failed() || !r.AtEnd()) return nullptr;
+	return functions;
+}
+Boolean BytecodeCache::ReadFunction(ByteReader r,Int32 index,List<FuncDef> functions) {
+	FuncDef f = functions[index];
+	f.set_Name(r.ReadString());
+	f.set_FileName(r.ReadString());
+	f.set_Note(r.ReadString());
+	f.set_SourceLoc(r.ReadString());
+	f.set_MaxRegs(r.ReadU16());
+	f.set_SelfReg((Int16)r.ReadU16());
+	f.set_SuperReg((Int16)r.ReadU16());
+	if (f.SelfReg() < -1 || f.SelfReg() >= f.MaxRegs()) return Boolean(false);
+	if (f.SuperReg() < -1 || f.SuperReg() >= f.MaxRegs()) return Boolean(false);
+
+	Int32 runs = r.ReadCount();
+	for (Int32 i = 0; i < runs; i++) {
+		Int32 pc = (Int32)r.ReadU32();
+		f.AddLineRun(pc, (Int32)r.ReadU32());
+	}
+
+	Int32 inlines = r.ReadCount();
+	for (Int32 i = 0; i < inlines; i++) {
+		Int32 startPC = (Int32)r.ReadU32();
+		Int32 endPC = (Int32)r.ReadU32();
+		f.AddInlineRange(startPC, endPC, (Int32)r.ReadU32());
+	}
+
+	// Children are later functions, or earlier ones with no children (see
+	// WriteFunction).  Earlier functions have been read, so that can be
+	// checked here.
+	Int32 childCount = r.ReadCount();
+	List<FuncDef> children =  List<FuncDef>::New();
+	for (Int32 i = 0; i < childCount; i++) {
+		UInt32 child = r.ReadU32();
+		if (child == (UInt32)index || child >= (UInt32)functions.Count()) return Boolean(false);
+		FuncDef childFunc = functions[(Int32)child];
+		if (child < (UInt32)index && childFunc.LazyChildren().Count() != 0) return Boolean(false);
+		children.Add(childFunc);
+	}
+
+	// Parameters and global names are small, and wanted as soon as anything
+	// calls the function, so decode them now.
+	Int32 headerEnd = r.ReadCount();
+	headerEnd += r.Pos();
+	if (!ReadValues(r, f.ParamNames(), children)) return Boolean(false);
+	if (!ReadValues(r, f.ParamDefaults(), children)) return Boolean(false);
+	if (!ReadValues(r, f.GlobalNames(), children)) return Boolean(false);
+	if (r.Pos() != headerEnd || f.ParamDefaults().Count() != f.ParamNames().Count()) return Boolean(false);
+	for (Int32 i = 0; i < f.GlobalNames().Count(); i++) {
+		f.GlobalSlots().Add(-1);
+		f.GlobalIntrinsics().Add(Value::Null);
+	}
+
+	// The constant pool is only checked, and left for DecodeConstants.
+	Int32 constantsEnd = r.ReadCount();
+	constantsEnd += r.Pos();
+	Int32 constantsPos = r.Pos();
+	Int32 constantCount = r.ReadCount();
+	for (Int32 i = 0; i < constantCount && !r.Failed(); i++) SkipValue(r, childCount);
+	if (r.Failed() || r.Pos() != constantsEnd) return Boolean(false);
+	f.set_CacheSource(r);
+	f.set_LazyConstantsPos(constantsPos);
+	f.set_LazyChildren(children);
+
+	Int32 codeCount = r.ReadCount();
+	r.Align(4);
+	if (r.Failed() || codeCount > (r.Count() - r.Pos()) / 4) return Boolean(false);
+	for (Int32 i = 0; i < runs; i++) {
+		if ((UInt32)f.LineRunPC(i) > (UInt32)codeCount) return Boolean(false);
+	}
+	for (Int32 i = 0; i < inlines; i++) {
+		UInt32 startPC = (UInt32)f.InlineRangeStart(i);
+		if (startPC > (UInt32)f.InlineRangeEnd(i) || (UInt32)f.InlineRangeEnd(i) > (UInt32)codeCount) return Boolean(false);
+	}
+	#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	// The file's words are already in this host's order: run them in place.
+	f.get_storage()->BorrowedCode = (const UInt32*)r.get_storage()->BytesAt(r.Pos());
+	f.get_storage()->BorrowedCount = codeCount;
+	r.Skip(codeCount * 4);
+	#else
+	for (Int32 i = 0; i < codeCount; i++) f.Code().Add(r.ReadU32());
+	#endif
+	return !r.Failed();
+}
+void BytecodeCache::DecodeConstants(FuncDef f) {
+	ByteReader r = f.CacheSource().Cursor(f.LazyConstantsPos());
+	f.set_LazyConstantsPos(-1);
+	ReadValues(r, f.Constants(), f.LazyChildren());
+	f.set_LazyChildren(nullptr);
+	// Once its constants are in, a function needs the data only for code
+	// it runs in place, which C# never does.
+	if (!f.get_storage()->BorrowedCode) f.set_CacheSource(nullptr);
+}
+Boolean BytecodeCache::ReadValues(ByteReader r,List<Value> values,List<FuncDef> children) {
+	Int32 count = r.ReadCount();
+	for (Int32 i = 0; i < count && !r.Failed(); i++) values.Add(ReadValue(r, children));
+	return !r.Failed();
+}
+Value BytecodeCache::ReadValue(ByteReader r,List<FuncDef> children) {
+	Byte tag = r.ReadU8();
+	if (tag == kTagNull) return Value::Null;
+	if (tag == kTagNumber) return Value(r.ReadDouble());
+	if (tag == kTagString) return Value::make_interned_string(r.ReadString());
+	if (tag == kTagFuncRef) {
+		UInt32 index = r.ReadU32();
+		if (index >= (UInt32)children.Count()) {
+			r.set_Failed(Boolean(true));
+			return Value::Null;
+		}
+		return Value::make_funcref(children[(Int32)index], Value::Null);
+	}
+	if (tag == kTagList) {
+		Int32 count = r.ReadCount();
+		Value list = Value::make_list(count);
+		for (Int32 i = 0; i < count && !r.Failed(); i++) list.Push(ReadValue(r, children));
+		list.Freeze();
+		return list;
+	}
+	if (tag == kTagMap) {
+		Int32 count = r.ReadCount();
+		Value map = Value::make_map(count);
+		for (Int32 i = 0; i < count && !r.Failed(); i++) {
+			Value k = ReadValue(r, children);
+			map.MapSet(k, ReadValue(r, children));
+		}
+		map.Freeze();
+		return map;
+	}
+	r.set_Failed(Boolean(true));
+	return Value::Null;
+}
+void BytecodeCache::SkipValue(ByteReader r,Int32 childCount) {
+	Byte tag = r.ReadU8();
+	if (tag == kTagNull) return;
+	if (tag == kTagNumber) {
+		r.Skip(8);
+	} else if (tag == kTagString) {
+		r.Skip(r.ReadCount());
+	} else if (tag == kTagFuncRef) {
+		if (r.ReadU32() >= (UInt32)childCount) r.set_Failed(Boolean(true));
+	} else if (tag == kTagList) {
+		Int32 count = r.ReadCount();
+		for (Int32 i = 0; i < count && !r.Failed(); i++) SkipValue(r, childCount);
+	} else if (tag == kTagMap) {
+		Int32 count = r.ReadCount();
+		for (Int32 i = 0; i < count && !r.Failed(); i++) {
+			SkipValue(r, childCount);
+			SkipValue(r, childCount);
+		}
+	} else {
+		r.set_Failed(Boolean(true));
+	}
+}
+// Create dir and any missing parents, as Directory.CreateDirectory does.
+// Failures are left for the write that follows to find.
+static void MakeDirectories(const String& dir) {
+	std::string path(dir.c_str());
+	for (size_t i = 1; i <= path.size(); i++) {
+		if (i < path.size() && path[i] != '/' && path[i] != '\\') continue;
+		if (path[i - 1] == '/' || path[i - 1] == '\\' || path[i - 1] == ':') continue;
+		std::string prefix = path.substr(0, i);
+		#ifdef _WIN32
+		_mkdir(prefix.c_str());
+		#else
+		mkdir(prefix.c_str(), 0777);
+		#endif
+	}
+}
+void BytecodeCache::WriteFileBytes(String dir,String path,List<Byte> data) {
+	Lock();
+	_tempFileCount++;
+	Int32 tempNum = _tempFileCount;
+	Unlock();
+	MakeDirectories(dir);
+	#ifdef _WIN32
+	String tmp = path + ".tmp" + StringUtils::Format("{0}.{1}", (Int32)_getpid(), tempNum);
+	#else
+	String tmp = path + ".tmp" + StringUtils::Format("{0}.{1}", (Int32)getpid(), tempNum);
+	#endif
+	FILE* handle = fopen(tmp.c_str(), "wb");
+	if (!handle) return;
+	size_t n = (size_t)data.Count();
+	Boolean ok = (n == 0 || fwrite(&data[0], 1, n, handle) == n);
+	ok = (fclose(handle) == 0) && ok;
+	if (ok) {
+		#ifdef _WIN32
+		remove(path.c_str());
+		#endif
+		ok = (rename(tmp.c_str(), path.c_str()) == 0);
+	}
+	if (!ok) remove(tmp.c_str());
+}
+void BytecodeCache::Lock() {
+	_mutex.lock();
+}
+void BytecodeCache::Unlock() {
+	_mutex.unlock();
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,158 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: BytecodeCache.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// BytecodeCache.cs
+// A compact binary form of compiled code (the list of FuncDefs produced for a
+// program or an imported module), and an on-disk cache of it, so that a
+// script compiled once need not be lexed, parsed, and code-generated again on
+// the next run.  The text .msa format (Assembler/Disassembler) stays the
+// human-readable form; this one exists only for speed.
+// The cache is off unless a directory is given, either by the host (set
+// BytecodeCache.CacheDirectory) or by the MS_BYTECODE_CACHE environment variable.
+// Entries are keyed by a hash of the source, its file name, the compile mode,
+// and the compiler build, so a stale entry is simply never found.  Loading is
+// lazy: a function's constants are decoded only when it first runs, and (in
+// C++) its code is executed straight out of the memory-mapped file.  See
+// notes/BYTECODE_CACHE.md for the file format.
+
+#include "value.h"
+#include "FuncDef.g.h"
+#include "BinaryIO.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class BytecodeCache {
+	public: static const UInt32 kMagic;
+	public: static const UInt32 kFormatVersion;
+	private: static const Int32 kHeaderSize;
+	private: static const Byte kTagNull;
+	private: static const Byte kTagNumber;
+	private: static const Byte kTagString;
+	private: static const Byte kTagFuncRef;
+	private: static const Byte kTagList;
+	private: static const Byte kTagMap;
+	public: static String CacheDirectory;
+	private: static Boolean _directoryResolved;
+	private: static String _compilerVersion;
+	private: static Int32 _tempFileCount;
+	// "MSBC" in little-endian byte order, then the format version.  Bump the
+	// version whenever the layout below changes.
+
+	// Size of the file header: magic, version, key, and checksum.  A multiple
+	// of 4, so code aligned in the payload is aligned in the file.
+
+	// Tags for serialized constant values.
+
+	// Cache directory; empty means caching is off.  Hosts may set this
+	// directly; if they do not, it is read once from MS_BYTECODE_CACHE.
+
+	// CompilerVersion, once worked out.
+
+	// Count of temporary files this process has started to write; see
+	// WriteFileBytes.
+
+	// Guards _directoryResolved, _compilerVersion and _tempFileCount, which
+	// any thread that compiles may be the one to change.
+
+	public: static String GetDirectory();
+
+	// ── Keys ─────────────────────────────────────────────────────────────────
+
+	// 64-bit FNV-1a over the UTF-8 bytes of s, continuing from hash h.
+	private: static UInt64 HashString(UInt64 h, String s);
+
+	// Identifies the exact compiler build.  Bytecode is only valid for the
+	// build that produced it, so besides the version numbers this hashes the
+	// opcode table and the core intrinsics (a CALLINTRINSIC operand is an
+	// index among them), and names the binary itself, which changes whenever
+	// it is rebuilt: any change to the compiler may change what it generates.
+	public: static String CompilerVersion();
+
+	// Cache key for the given source, as compiled under the given file name
+	// either as a program (isImport false) or as an imported module.
+	public: static UInt64 SourceKey(String source, String fileName, Boolean isImport);
+
+	public: static String CachePath(String dir, UInt64 key);
+
+	// ── Cache lookup and storage ─────────────────────────────────────────────
+
+	// Return the cached functions for this source, or null if caching is off
+	// or there is no valid entry.  functions[0] is the @main.
+	public: static List<FuncDef> Load(String source, String fileName, Boolean isImport);
+
+	// Save freshly compiled functions for this source.  Quietly does nothing
+	// if caching is off, the functions cannot be serialized, or the write fails;
+	// a cache is never a reason for a program to fail.
+	public: static void Store(String source, String fileName, Boolean isImport, List<FuncDef> functions);
+
+	// ── Serialization ────────────────────────────────────────────────────────
+
+	// Serialize a function list (as produced by CodeGenerator) into the cache
+	// format.  Returns null if anything in it has no serialized form -- e.g. a
+	// constant that refers to a function outside the list.
+	public: static List<Byte> Serialize(List<FuncDef> functions, UInt64 key);
+
+	// childCounts holds the size of each earlier function's children table, and
+	// gets this function's added to it.
+	private: static Boolean WriteFunction(ByteWriter w, Int32 index, List<FuncDef> functions, List<Int32> childCounts);
+
+	private: static Boolean WriteValues(ByteWriter w, List<Value> values, List<FuncDef> functions, List<Int32> children);
+
+	// Constants are only ever null, numbers, strings, function templates, and
+	// the frozen lists/maps that constant folding builds; anything else fails.
+	// A template is written as an index into the function's children table
+	// (the list indexes of the functions it refers to), adding to it as needed.
+	private: static Boolean WriteValue(ByteWriter w, Value v, List<FuncDef> functions, List<Int32> children);
+
+	// ── Deserialization ──────────────────────────────────────────────────────
+
+	// Rebuild a function list from cache data.  Returns null if the data is not
+	// a complete, well-formed entry for the given key.  The data must not
+	// change while any of the returned functions is in use.
+	public: static List<FuncDef> Deserialize(List<Byte> data, UInt64 key);
+
+	// The payload must match the checksum in the header, so an entry that was
+	// damaged or edited after it was written is rejected before any of it is
+	// used.  Its structure is checked as well: every count and offset, the
+	// registers and code positions each function names, and the constants,
+	// decoded later by DecodeConstants, which are thus known to be well formed.
+	// The instruction words themselves are covered only by the checksum.  The
+	// functions keep r (and so the data it reads) alive until they no longer
+	// need it.
+	public: static List<FuncDef> DeserializeFrom(ByteReader r, UInt64 key);
+
+	private: static Boolean ReadFunction(ByteReader r, Int32 index, List<FuncDef> functions);
+
+	// Decode a cached function's constant pool (see FuncDef.EnsureConstants).
+	// DeserializeFrom has already checked it, so this cannot fail.
+	public: static void DecodeConstants(FuncDef f);
+
+	private: static Boolean ReadValues(ByteReader r, List<Value> values, List<FuncDef> children);
+
+	// Read one value; on bad data, sets r.Failed and returns null.
+	private: static Value ReadValue(ByteReader r, List<FuncDef> children);
+
+	// Step over one value without building it, checking it as ReadValue would.
+	private: static void SkipValue(ByteReader r, Int32 childCount);
+
+	// ── File access ──────────────────────────────────────────────────────────
+
+	// Write a file by way of a temporary name and a rename, so that another
+	// process reading the same cache never sees a half-written entry.  The
+	// temporary name holds the process id and a count, so no two writers --
+	// in other processes, or on other threads of this one -- share it.
+	private: static void WriteFileBytes(String dir, String path, List<Byte> data);
+
+	private: static void Lock();
+
+	private: static void Unlock();
+}; // end of struct BytecodeCache
+
+// INLINE METHODS
+
+} // end of namespace MiniScript
@@ -0,0 +1,214 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Channel.cs
+
+#include "Channel.g.h"
+#include "GCManager.g.h"
+#include "StringUtils.g.h"
+#include <mutex>
+
+namespace MiniScript {
+
+const Int32 ChannelMessageStorage::OpScalar = 0; // index in _scalars
+const Int32 ChannelMessageStorage::OpString = 1; // index in _strings
+const Int32 ChannelMessageStorage::OpList = 2; // count, frozen (0 or 1); then count items
+const Int32 ChannelMessageStorage::OpMap = 3; // count, frozen (0 or 1); then count keys and values
+const Int32 ChannelMessageStorage::OpRef = 4; // a list or map already in the copy, by number
+ChannelMessageStorage::ChannelMessageStorage() {
+}
+ChannelMessage ChannelMessageStorage::Pack(Value v) {
+	ChannelMessage msg =  ChannelMessage::New();
+	if (!v.IsGCObject() || v.IsShared()) {
+		msg.set__root(v);
+		return msg;
+	}
+	msg.set__ops( List<Int32>::New());
+	msg.set__scalars( List<Value>::New());
+	msg.set__strings( List<String>::New());
+	Dictionary<Int32, Int32> lists =  Dictionary<Int32, Int32>::New();
+	Dictionary<Int32, Int32> maps =  Dictionary<Int32, Int32>::New();
+	if (!msg.Add(v, lists, maps)) return nullptr;
+	return msg;
+}
+Boolean ChannelMessageStorage::Add(Value v,Dictionary<Int32, Int32> lists,Dictionary<Int32, Int32> maps) {
+	if (!v.IsGCObject() || v.IsShared()) {
+		_ops.Add(OpScalar);
+		_ops.Add(_scalars.Count());
+		_scalars.Add(v);
+		return Boolean(true);
+	}
+	if (v.IsString()) {
+		_ops.Add(OpString);
+		_ops.Add(_strings.Count());
+		_strings.Add(GCManager::GetString(v).Data);	// (a heap string: tiny ones are not GC objects)
+		return Boolean(true);
+	}
+	Int32 id;
+	if (v.IsList()) {
+		if (lists.TryGetValue(v.ItemIndex(), &id)) {
+			_ops.Add(OpRef);
+			_ops.Add(id);
+			return Boolean(true);
+		}
+		lists[v.ItemIndex()] = _containerCount++;
+		GCList src = GCManager::Lists.Get(v.ItemIndex());
+		Int32 count = src.Count();
+		_ops.Add(OpList);
+		_ops.Add(count);
+		_ops.Add(src.Frozen ? 1 : 0);
+		for (Int32 i = 0; i < count; i++) {
+			if (!Add(src.Get(i), lists, maps)) return Boolean(false);
+		}
+		return Boolean(true);
+	}
+	if (v.IsMap()) {
+		if (maps.TryGetValue(v.ItemIndex(), &id)) {
+			_ops.Add(OpRef);
+			_ops.Add(id);
+			return Boolean(true);
+		}
+		GCMap m = GCManager::Maps.Get(v.ItemIndex());
+		if (!IsNull(m._vmb) || !IsNull(m._gb)) return Boolean(false);
+		maps[v.ItemIndex()] = _containerCount++;
+		_ops.Add(OpMap);
+		_ops.Add(m.Count());
+		_ops.Add(m.Frozen ? 1 : 0);
+		for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+			if (!Add(m.KeyAt(i), lists, maps)) return Boolean(false);
+			if (!Add(m.ValueAt(i), lists, maps)) return Boolean(false);
+		}
+		return Boolean(true);
+	}
+	return Boolean(false);	// function, error or handle
+}
+Value ChannelMessageStorage::Unpack() {
+	if (IsNull(_ops)) return _root;
+	ChannelMessage reader =  ChannelMessage::New();
+	reader.set__ops(_ops);
+	reader.set__scalars(_scalars);
+	reader.set__strings(_strings);
+	reader.set__made( List<Value>::New());
+	return reader.Take();
+}
+Value ChannelMessageStorage::Take() {
+	Int32 op = _ops[_pos];
+	Int32 arg = _ops[_pos + 1];
+	if (op == OpScalar) {
+		_pos += 2;
+		return _scalars[arg];
+	}
+	if (op == OpString) {
+		_pos += 2;
+		return Value::make_string(_strings[arg]);
+	}
+	if (op == OpRef) {
+		_pos += 2;
+		return _made[arg];
+	}
+	Int32 count = arg;
+	Boolean frozen = _ops[_pos + 2] != 0;
+	_pos += 3;
+	Value result;
+	if (op == OpList) {
+		result = Value::make_list(count);
+		_made.Add(result);
+		for (Int32 i = 0; i < count; i++) result.Push(Take());
+		if (frozen) GCManager::Lists.SetFrozen(result.ItemIndex(), Boolean(true));
+	} else {
+		result = Value::make_map(count);
+		_made.Add(result);
+		for (Int32 i = 0; i < count; i++) {
+			Value key = Take();
+			result.MapSet(key, Take());
+		}
+		if (frozen) GCManager::Maps.SetFrozen(result.ItemIndex(), Boolean(true));
+	}
+	return result;
+}
+
+ChannelStorage::ChannelStorage(Int32 capacity) {
+	Int32 size = 1;
+	while (size < capacity) size <<= 1;
+	_mask = size - 1;
+	_slots.reset(new ChannelMessage[size]);
+	_seq.reset(new std::atomic<Int64>[size]);
+	for (Int32 i = 0; i < size; i++) _seq[i].store(i, std::memory_order_relaxed);
+}
+Int32 ChannelStorage::Capacity() {
+	return _mask + 1;
+}
+Boolean ChannelStorage::TrySend(ChannelMessage msg) {
+	Int64 pos = _tail.load(std::memory_order_relaxed);
+	Int32 idx;
+	while (Boolean(true)) {
+		idx = (Int32)(pos & _mask);
+		Int64 seq = _seq[idx].load(std::memory_order_acquire);
+		if (seq == pos) {
+			Int64 seen = pos; _tail.compare_exchange_strong(seen, pos + 1, std::memory_order_relaxed);
+			if (seen == pos) break;
+			pos = seen;
+		} else if (seq < pos) {
+			return Boolean(false);	// the slot still holds the message from a lap ago
+		} else {
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+	}
+	_slots[idx] = msg;
+	_seq[idx].store(pos + 1, std::memory_order_release);
+	return Boolean(true);
+}
+ChannelMessage ChannelStorage::TryReceive() {
+	Int64 pos = _head.load(std::memory_order_relaxed);
+	Int32 idx;
+	while (Boolean(true)) {
+		idx = (Int32)(pos & _mask);
+		Int64 seq = _seq[idx].load(std::memory_order_acquire);
+		if (seq == pos + 1) {
+			Int64 seen = pos; _head.compare_exchange_strong(seen, pos + 1, std::memory_order_relaxed);
+			if (seen == pos) break;
+			pos = seen;
+		} else if (seq < pos + 1) {
+			return nullptr;	// nothing sent to this position yet
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+	ChannelMessage msg = _slots[idx];
+	_slots[idx] = nullptr;
+	_seq[idx].store(pos + _mask + 1, std::memory_order_release);
+	return msg;
+}
+
+const Int32 Channels::DefaultCapacity = 64;
+const Int32 Channels::MaxCapacity = 1048576;
+Dictionary<String, Channel> Channels::_all =  Dictionary<String, Channel>::New(); // guarded by the lock
+Int32 Channels::_unnamedCount = 0; // guarded by the lock
+thread_local Dictionary<String, Channel> Channels::_known; // this thread's lookups
+static std::mutex _mutex;
+Channel Channels::Find(String name,Int32 capacity) {
+	if (IsNull(_known)) _known =  Dictionary<String, Channel>::New();
+	Channel ch;
+	if (_known.TryGetValue(name, &ch)) return ch;
+	Lock();
+	if (!_all.TryGetValue(name, &ch)) {
+		ch =  Channel::New(capacity);
+		_all[name] = ch;
+	}
+	Unlock();
+	_known[name] = ch;
+	return ch;
+}
+String Channels::NewName() {
+	Lock();
+	_unnamedCount++;
+	Int32 n = _unnamedCount;
+	Unlock();
+	return StringUtils::Format("channel#{0}", n);
+}
+void Channels::Lock() {
+	_mutex.lock();
+}
+void Channels::Unlock() {
+	_mutex.unlock();
+}
+
+} // end of namespace MiniScript
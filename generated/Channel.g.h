@@ -0,0 +1,241 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Channel.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// Channel.cs
+// Channels carry values between isolates: interpreters running at the same
+// time, each on its own thread with its own GC heap (see GCManager).  A
+// Channel is a bounded queue that any number of threads may send to and
+// receive from at once, without locks: a ring of slots, each with a sequence
+// number that says whose turn it is (Vyukov's bounded MPMC queue).  Send and
+// receive never wait; they report a full or empty channel, and the script
+// intrinsics built on them (send, receive) wait by yielding, so a script
+// waiting on a channel never blocks its thread.
+// A Value is an index into its own isolate's heap, so a value cannot simply
+// be put in a channel.  ChannelMessage.Pack records it in a form that
+// belongs to no heap, and Unpack rebuilds it on the receiver's.  Numbers,
+// null, tiny strings and values published to the SharedHeap are the same in
+// every isolate, so they travel as they are, with nothing copied; that is how
+// a frozen value moves without a copy (publish it first, with `share`).
+// Anything else is copied: strings by content, lists and maps structurally,
+// keeping shared structure and cycles, and a frozen list or map arrives
+// frozen.  Functions, errors, handles, and globals or locals maps cannot be
+// sent.
+// Channels are found by name (see Channels), since a name is a string and
+// so can be handed from one isolate to another like any other data.
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+#include "value.h"
+#include <atomic>
+#include <memory>
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+// The process's channels, by name.  A channel is made the first time its
+// name is used, and lives until the process exits.  Each thread remembers
+// the channels it has looked up, so only a thread's first use of a name
+// takes the lock.
+class Channels {
+	public: static const Int32 DefaultCapacity;
+	public: static const Int32 MaxCapacity;
+	private: static Dictionary<String, Channel> _all; // guarded by the lock
+	private: static Int32 _unnamedCount; // guarded by the lock
+	private: thread_local static Dictionary<String, Channel> _known; // this thread's lookups
+
+	// The channel with the given name, made with room for `capacity`
+	// messages if there is none yet.
+	public: static Channel Find(String name, Int32 capacity);
+
+	// A name that no channel has, for a new channel.
+	public: static String NewName();
+
+	private: static void Lock();
+
+	private: static void Unlock();
+}; // end of struct Channels
+
+class ChannelMessageStorage : public std::enable_shared_from_this<ChannelMessageStorage> {
+	friend struct ChannelMessage;
+	private: static const Int32 OpScalar; // index in _scalars
+	private: static const Int32 OpString; // index in _strings
+	private: static const Int32 OpList; // count, frozen (0 or 1); then count items
+	private: static const Int32 OpMap; // count, frozen (0 or 1); then count keys and values
+	private: static const Int32 OpRef; // a list or map already in the copy, by number
+	private: Value _root = Value::Null; // the whole value, when it needs no copy
+	private: List<Int32> _ops = nullptr; // otherwise, the copy
+	private: List<Value> _scalars = nullptr; // values the same in every isolate
+	private: List<String> _strings = nullptr; // string contents
+	private: Int32 _containerCount = 0; // lists and maps in the copy
+	private: Int32 _pos = 0;
+	private: List<Value> _made = nullptr;
+	// Ops in the copy, each followed by its operands.
+
+	// While unpacking (in a reader: see Unpack): the next op, and each list
+	// and map made so far.
+
+	public: ChannelMessageStorage();
+
+	// A message carrying v, a value on the calling thread's heap; or null if
+	// v is or holds something that cannot be sent.
+	public: static ChannelMessage Pack(Value v);
+
+	// Append the ops for v; lists and maps number those already in the copy.
+	private: Boolean Add(Value v, Dictionary<Int32, Int32> lists, Dictionary<Int32, Int32> maps);
+
+	// The value, made on the calling thread's heap.  The message itself is
+	// not changed, so it may be unpacked any number of times, by any number
+	// of threads at once: the position and the containers made so far are
+	// kept in a reader of its own.
+	public: Value Unpack();
+
+	// Make the value whose ops start at _pos, and move past them.
+	private: Value Take();
+}; // end of class ChannelMessageStorage
+
+class ChannelStorage : public std::enable_shared_from_this<ChannelStorage> {
+	friend struct Channel;
+	private: Int32 _mask; // ring size - 1 (the size is a power of 2)
+	private: std::unique_ptr<ChannelMessage[]> _slots;
+	private: std::unique_ptr<std::atomic<Int64>[]> _seq;
+	private: std::atomic<Int64> _tail{0};	// next position to send to
+	private: std::atomic<Int64> _head{0};	// next position to receive from
+
+	// A channel with room for at least `capacity` messages (1 or more).
+	public: ChannelStorage(Int32 capacity);
+
+	public: Int32 Capacity();
+
+	// Add msg to the channel.  Returns false, adding nothing, if it is full.
+	public: Boolean TrySend(ChannelMessage msg);
+
+	// Take the oldest message from the channel; or null if it is empty.
+	public: ChannelMessage TryReceive();
+}; // end of class ChannelStorage
+
+// A value in transit: a structural copy that belongs to no isolate.
+struct ChannelMessage {
+	friend class ChannelMessageStorage;
+	protected: std::shared_ptr<ChannelMessageStorage> storage;
+  public:
+	ChannelMessage(std::shared_ptr<ChannelMessageStorage> stor) : storage(stor) {}
+	ChannelMessage() : storage(nullptr) {}
+	ChannelMessage(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const ChannelMessage& inst) { return inst.storage == nullptr; }
+	private: ChannelMessageStorage* get() const;
+
+	private: Int32 OpScalar(); // index in _scalars
+	private: Int32 OpString(); // index in _strings
+	private: Int32 OpList(); // count, frozen (0 or 1); then count items
+	private: Int32 OpMap(); // count, frozen (0 or 1); then count keys and values
+	private: Int32 OpRef(); // a list or map already in the copy, by number
+	private: Value _root(); // the whole value, when it needs no copy
+	private: void set__root(Value _v); // the whole value, when it needs no copy
+	private: List<Int32> _ops(); // otherwise, the copy
+	private: void set__ops(List<Int32> _v); // otherwise, the copy
+	private: List<Value> _scalars(); // values the same in every isolate
+	private: void set__scalars(List<Value> _v); // values the same in every isolate
+	private: List<String> _strings(); // string contents
+	private: void set__strings(List<String> _v); // string contents
+	private: Int32 _containerCount(); // lists and maps in the copy
+	private: void set__containerCount(Int32 _v); // lists and maps in the copy
+	private: Int32 _pos();
+	private: void set__pos(Int32 _v);
+	private: List<Value> _made();
+	private: void set__made(List<Value> _v);
+	// Ops in the copy, each followed by its operands.
+
+	// While unpacking (in a reader: see Unpack): the next op, and each list
+	// and map made so far.
+
+	public: static ChannelMessage New() {
+		return ChannelMessage(std::make_shared<ChannelMessageStorage>());
+	}
+
+	// A message carrying v, a value on the calling thread's heap; or null if
+	// v is or holds something that cannot be sent.
+	public: static ChannelMessage Pack(Value v) { return ChannelMessageStorage::Pack(v); }
+
+	// Append the ops for v; lists and maps number those already in the copy.
+	private: inline Boolean Add(Value v, Dictionary<Int32, Int32> lists, Dictionary<Int32, Int32> maps);
+
+	// The value, made on the calling thread's heap.  The message itself is
+	// not changed, so it may be unpacked any number of times, by any number
+	// of threads at once: the position and the containers made so far are
+	// kept in a reader of its own.
+	public: inline Value Unpack();
+
+	// Make the value whose ops start at _pos, and move past them.
+	private: inline Value Take();
+}; // end of struct ChannelMessage
+
+// A bounded multi-producer, multi-consumer queue of messages, safe to use
+// from any number of threads at once.  Slot i of the ring holds position p
+// (p & mask == i) when its sequence number says so: p when it is free for
+// the sender of p, p+1 once that message is in it.  A sender or receiver
+// claims a position by advancing _tail or _head with a compare-and-swap, and
+// hands the slot on by storing the next sequence number.
+struct Channel {
+	friend class ChannelStorage;
+	protected: std::shared_ptr<ChannelStorage> storage;
+  public:
+	Channel(std::shared_ptr<ChannelStorage> stor) : storage(stor) {}
+	Channel() : storage(nullptr) {}
+	Channel(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const Channel& inst) { return inst.storage == nullptr; }
+	private: ChannelStorage* get() const;
+
+	private: Int32 _mask(); // ring size - 1 (the size is a power of 2)
+	private: void set__mask(Int32 _v); // ring size - 1 (the size is a power of 2)
+
+	// A channel with room for at least `capacity` messages (1 or more).
+	public: static Channel New(Int32 capacity) {
+		return Channel(std::make_shared<ChannelStorage>(capacity));
+	}
+
+	public: inline Int32 Capacity();
+
+	// Add msg to the channel.  Returns false, adding nothing, if it is full.
+	public: inline Boolean TrySend(ChannelMessage msg);
+
+	// Take the oldest message from the channel; or null if it is empty.
+	public: inline ChannelMessage TryReceive();
+}; // end of struct Channel
+
+// INLINE METHODS
+
+inline ChannelMessageStorage* ChannelMessage::get() const { return static_cast<ChannelMessageStorage*>(storage.get()); }
+inline Int32 ChannelMessage::OpScalar() { return get()->OpScalar; } // index in _scalars
+inline Int32 ChannelMessage::OpString() { return get()->OpString; } // index in _strings
+inline Int32 ChannelMessage::OpList() { return get()->OpList; } // count, frozen (0 or 1); then count items
+inline Int32 ChannelMessage::OpMap() { return get()->OpMap; } // count, frozen (0 or 1); then count keys and values
+inline Int32 ChannelMessage::OpRef() { return get()->OpRef; } // a list or map already in the copy, by number
+inline Value ChannelMessage::_root() { return get()->_root; } // the whole value, when it needs no copy
+inline void ChannelMessage::set__root(Value _v) { get()->_root = _v; } // the whole value, when it needs no copy
+inline List<Int32> ChannelMessage::_ops() { return get()->_ops; } // otherwise, the copy
+inline void ChannelMessage::set__ops(List<Int32> _v) { get()->_ops = _v; } // otherwise, the copy
+inline List<Value> ChannelMessage::_scalars() { return get()->_scalars; } // values the same in every isolate
+inline void ChannelMessage::set__scalars(List<Value> _v) { get()->_scalars = _v; } // values the same in every isolate
+inline List<String> ChannelMessage::_strings() { return get()->_strings; } // string contents
+inline void ChannelMessage::set__strings(List<String> _v) { get()->_strings = _v; } // string contents
+inline Int32 ChannelMessage::_containerCount() { return get()->_containerCount; } // lists and maps in the copy
+inline void ChannelMessage::set__containerCount(Int32 _v) { get()->_containerCount = _v; } // lists and maps in the copy
+inline Int32 ChannelMessage::_pos() { return get()->_pos; }
+inline void ChannelMessage::set__pos(Int32 _v) { get()->_pos = _v; }
+inline List<Value> ChannelMessage::_made() { return get()->_made; }
+inline void ChannelMessage::set__made(List<Value> _v) { get()->_made = _v; }
+inline Boolean ChannelMessage::Add(Value v,Dictionary<Int32, Int32> lists,Dictionary<Int32, Int32> maps) { return get()->Add(v, lists, maps); }
+inline Value ChannelMessage::Unpack() { return get()->Unpack(); }
+inline Value ChannelMessage::Take() { return get()->Take(); }
+
+inline ChannelStorage* Channel::get() const { return static_cast<ChannelStorage*>(storage.get()); }
+inline Int32 Channel::_mask() { return get()->_mask; } // ring size - 1 (the size is a power of 2)
+inline void Channel::set__mask(Int32 _v) { get()->_mask = _v; } // ring size - 1 (the size is a power of 2)
+inline Int32 Channel::Capacity() { return get()->Capacity(); }
+inline Boolean Channel::TrySend(ChannelMessage msg) { return get()->TrySend(msg); }
+inline ChannelMessage Channel::TryReceive() { return get()->TryReceive(); }
+
+} // end of namespace MiniScript
@@ -4,6 +4,7 @@
 #include "CodeGenerator.g.h"
 #include "StringUtils.g.h"
 #include "CS_Math.h"
+#include "Intrinsic.g.h"
 
 namespace MiniScript {
 
@@ -24,10 +25,16 @@ CodeGeneratorStorage::CodeGeneratorStorage(CodeEmitterBase emitter) {
 	_loopNameMarks =  List<Int32>::New();
 	_loopReserved =  List<String>::New();
 	_loopReservedStarts =  List<Int32>::New();
+	_loopConstValues =  List<Value>::New();
+	_loopConstRegs =  List<Int32>::New();
+	_loopConstStarts =  List<Int32>::New();
 	_targetReg = -1;
 	_loopExitLabels =  List<Int32>::New();
 	_loopContinueLabels =  List<Int32>::New();
 	_functions =  List<FuncDef>::New();
+	_inlineCandidates =  Dictionary<String, InlineCandidate>::New();
+	_lastFunctionInline = nullptr;
+	_inlineParams =  Dictionary<String, Int32>::New();
 	_globalScope = Boolean(false);
 	Error = Value::Null;
 }
@@ -58,6 +65,10 @@ Int32 CodeGeneratorStorage::AllocReg() {
 	_emitter.ReserveRegister(reg);
 	return reg;
 }
+void CodeGeneratorStorage::ClaimReg(Int32 reg) {
+	_regInUse[reg] = Boolean(true);
+	if (reg > _maxRegUsed) _maxRegUsed = reg;
+}
 void CodeGeneratorStorage::FreeReg(Int32 reg) {
 	if (reg < 0 || reg >= _regInUse.Count()) return;
 
@@ -118,6 +129,13 @@ Boolean CodeGeneratorStorage::IsLiveVariableReg(Int32 reg) {
 	}
 	return Boolean(false);
 }
+Boolean CodeGeneratorStorage::AllConstant(List<ASTNode> nodes) {
+	Value unused;
+	for (Int32 i = 0; i < nodes.Count(); i++) {
+		if (!TryEvaluateConstant(nodes[i], &unused)) return Boolean(false);
+	}
+	return Boolean(true);
+}
 Int32 CodeGeneratorStorage::CompileInto(ASTNode node,Int32 targetReg) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
 	_targetReg = targetReg;
@@ -131,6 +149,15 @@ Int32 CodeGeneratorStorage::GetTargetOrAlloc() {
 	if (target >= 0) return target;
 	return AllocReg();
 }
+Int32 CodeGeneratorStorage::TakeTarget() {
+	Int32 target = _targetReg;
+	_targetReg = -1;
+	return target;
+}
+Int32 CodeGeneratorStorage::ResultReg(Int32 target) {
+	if (target >= 0) return target;
+	return AllocReg();
+}
 Int32 CodeGeneratorStorage::Compile(ASTNode ast) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
 	return ast.Accept(_this);
@@ -139,12 +166,16 @@ void CodeGeneratorStorage::ResetTempRegisters() {
 	_regInUse.Clear();
 	_regInUse.Add(Boolean(true));  // r0
 	_firstAvailable = 1;
+	_maxRegUsed = 0;
 	for (Int32 reg : _variableRegs.GetValues()) {
 		while (_regInUse.Count() <= reg) {
 			_regInUse.Add(Boolean(false));
 		}
 		_regInUse[reg] = Boolean(true);
-		if (reg >= _firstAvailable) _firstAvailable = reg + 1;
+		if (reg > _maxRegUsed) _maxRegUsed = reg;
+	}
+	while (_firstAvailable < _regInUse.Count() && _regInUse[_firstAvailable]) {
+		_firstAvailable = _firstAvailable + 1;
 	}
 }
 void CodeGeneratorStorage::CompileBody(List<ASTNode> body) {
@@ -350,13 +381,96 @@ Int32 CodeGeneratorStorage::EmitHoistedNames(List<String> names) {
 	for (Int32 i = 0; i < names.Count(); i++) {
 		Int32 reg;
 		if (!_variableRegs.TryGetValue(PendingVarRegKey(names[i]), &reg)) continue;
-		Int32 nameIdx = _emitter.AddConstant(Value::make_string(names[i]));
+		Int32 nameIdx = _emitter.AddConstant(Value::make_interned_string(names[i]));
 		_emitter.EmitAB(Opcode::NAME_rA_kBC, reg, nameIdx,
 			Interp("use r{} for {} (hoisted)", reg, names[i]));
 		PushName(names[i], Boolean(true));
 	}
 	return mark;
 }
+const Int32 CodeGeneratorStorage::kMaxLoopConstants = 8;
+String CodeGeneratorStorage::LoopConstRegKey(Int32 index) {
+	return StringUtils::Format("@const {0}", index);
+}
+void CodeGeneratorStorage::HoistLoopConstants(ASTNode condition,List<ASTNode> body) {
+	_loopConstStarts.Add(_loopConstValues.Count());
+
+	LoopConstantCollector collector =  LoopConstantCollector::New();
+	if (!IsNull(condition)) condition.Accept(collector);
+	collector.CollectAll(body);
+
+	Int32 hoisted = 0;
+	for (Int32 i = 0; i < collector.Values().Count() && hoisted < kMaxLoopConstants; i++) {
+		Value value = collector.Values()[i];
+		if (FindLoopConst(value) >= 0) continue;
+		Int32 reg = AllocReg();
+		_variableRegs[LoopConstRegKey(_loopConstValues.Count())] = reg;
+		_loopConstValues.Add(value);
+		_loopConstRegs.Add(reg);
+		EmitLoadConstant(reg, value, "(loop constant)");
+		hoisted++;
+	}
+}
+void CodeGeneratorStorage::ReleaseLoopConstants() {
+	Int32 start = _loopConstStarts[_loopConstStarts.Count() - 1];
+	_loopConstStarts.RemoveAt(_loopConstStarts.Count() - 1);
+	while (_loopConstValues.Count() > start) {
+		Int32 last = _loopConstValues.Count() - 1;
+		_variableRegs.Remove(LoopConstRegKey(last));
+		FreeReg(_loopConstRegs[last]);
+		_loopConstValues.RemoveAt(last);
+		_loopConstRegs.RemoveAt(last);
+	}
+}
+Int32 CodeGeneratorStorage::FindLoopConst(Value value) {
+	for (Int32 i = 0; i < _loopConstValues.Count(); i++) {
+		if (LoopConstantCollector::SameConstant(_loopConstValues[i], value)) return _loopConstRegs[i];
+	}
+	return -1;
+}
+Boolean CodeGeneratorStorage::IsLoopConstReg(Int32 reg) {
+	for (Int32 i = 0; i < _loopConstRegs.Count(); i++) {
+		if (_loopConstRegs[i] == reg) return Boolean(true);
+	}
+	return Boolean(false);
+}
+Int32 CodeGeneratorStorage::CompileOperand(ASTNode node) {
+	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
+	if (_loopConstRegs.Count() > 0) {
+		Int32 reg = -1;
+		NumberNode num = As<NumberNode, NumberNodeStorage>(node);
+		StringNode str = As<StringNode, StringNodeStorage>(node);
+		if (!IsNull(num)) reg = FindLoopConst(Value(num.Value()));
+		else if (!IsNull(str)) reg = FindLoopConst(Value::make_interned_string(str.Value()));
+		if (reg >= 0) return reg;
+	}
+	return node.Accept(_this);
+}
+void CodeGeneratorStorage::FreeOperand(Int32 reg) {
+	if (IsLoopConstReg(reg)) return;
+	FreeReg(reg);
+}
+Int32 CodeGeneratorStorage::CompileKeyOperand(String key) {
+	Value keyVal = Value::make_interned_string(key);
+	Int32 reg = FindLoopConst(keyVal);
+	if (reg >= 0) return reg;
+	reg = AllocReg();
+	Int32 constIdx = _emitter.AddConstant(keyVal);
+	_emitter.EmitAB(Opcode::LOAD_rA_kBC, reg, constIdx, Interp("r{} = \"{}\"", reg, key));
+	return reg;
+}
+void CodeGeneratorStorage::EmitLoadConstant(Int32 reg,Value value,String note) {
+	if (value.IsNumber()) {
+		Double d = value.AsDouble();
+		if (d == Math::Floor(d) && d >= -32768 && d <= 32767) {
+			_emitter.EmitAB(Opcode::LOAD_rA_iBC, reg, (Int32)d, Interp("r{} = {} {}", reg, d, note));
+			return;
+		}
+	}
+	Int32 constIdx = _emitter.AddConstant(value);
+	String text = value.Repr(nullptr).AsCString();
+	_emitter.EmitAB(Opcode::LOAD_rA_kBC, reg, constIdx, Interp("r{} = {} {}", reg, text, note));
+}
 void CodeGeneratorStorage::PushName(String varName,Boolean isReg) {
 	_namedStack.Add(varName);
 	_namedIsReg.Add(isReg);
@@ -381,7 +495,7 @@ Boolean CodeGeneratorStorage::IsDefinitelyAssigned(String varName) {
 }
 void CodeGeneratorStorage::EnsureNamed(String varName,Int32 varReg) {
 	if (IsRegisterNamed(varName)) return;
-	Int32 nameIdx = _emitter.AddConstant(Value::make_string(varName));
+	Int32 nameIdx = _emitter.AddConstant(Value::make_interned_string(varName));
 	_emitter.EmitAB(Opcode::NAME_rA_kBC, varReg, nameIdx, Interp("use r{} for {}", varReg, varName));
 	PushName(varName, Boolean(true));
 }
@@ -474,7 +588,7 @@ String CodeGeneratorStorage::LoopVarRegKey(String varName) {
 	return "@loopvar " + varName;
 }
 Int32 CodeGeneratorStorage::AddGlobalRef(String varName) {
-	Int32 refIdx = _emitter.AddGlobalRef(Value::make_string(varName));
+	Int32 refIdx = _emitter.AddGlobalRef(Value::make_interned_string(varName));
 	if (refIdx > 65535 && Error.IsNull()) {
 		Error = ErrorTypes::CompilerError("too many distinct global variables in one function", FileName, _emitter.CurrentLine());
 	}
@@ -526,6 +640,7 @@ List<FuncDef> CodeGeneratorStorage::CompileImport(List<ASTNode> statements,Strin
 
 	_functions.Clear();
 	_functions.Add(nullptr);
+	_inlineCandidates.Clear();
 
 	for (Int32 i = 0; i < statements.Count(); i++) {
 		ResetTempRegisters();
@@ -554,6 +669,7 @@ FuncDef CodeGeneratorStorage::CompileProgram(List<ASTNode> statements,String fun
 	// Reserve index 0 for @main
 	_functions.Clear();
 	_functions.Add(nullptr);
+	_inlineCandidates.Clear();
 
 	BeginGlobalScope();
 
@@ -588,7 +704,7 @@ Int32 CodeGeneratorStorage::Visit(NumberNode node) {
 }
 Int32 CodeGeneratorStorage::Visit(StringNode node) {
 	Int32 reg = GetTargetOrAlloc();
-	Int32 constIdx = _emitter.AddConstant(Value::make_string(node.Value()));
+	Int32 constIdx = _emitter.AddConstant(Value::make_interned_string(node.Value()));
 	_emitter.EmitAB(Opcode::LOAD_rA_kBC, reg, constIdx, Interp("r{} = \"{}\"", reg, node.Value()));
 	return reg;
 }
@@ -609,6 +725,19 @@ Int32 CodeGeneratorStorage::VisitIdentifier(IdentifierNode node,bool addressOf)
 		return resultReg;
 	}
 
+	// A parameter of a function being compiled inline: it is the register its
+	// argument was evaluated into.  That is a temp, with no name to check, so
+	// this is the plain LOAD/LOADC rather than the name-checked forms.
+	Int32 paramReg;
+	if (_inlineParams.TryGetValue(node.Name(), &paramReg)) {
+		if (addressOf) {
+			_emitter.EmitABC(Opcode::LOAD_rA_rB, resultReg, paramReg, 0, Interp("r{} = @{} (inlined param)", resultReg, node.Name()));
+		} else {
+			_emitter.EmitABC(Opcode::LOADC_rA_rB, resultReg, paramReg, 0, Interp("r{} = {} (inlined param)", resultReg, node.Name()));
+		}
+		return resultReg;
+	}
+
 	// Reading the variable that the assignment we are inside is creating.  The
 	// local does not exist yet, so this can only mean the enclosing scope's
 	// variable of the same name -- and on the next time through a loop it would
@@ -632,7 +761,7 @@ Int32 CodeGeneratorStorage::VisitIdentifier(IdentifierNode node,bool addressOf)
 		}
 		Int32 checkReg;
 		if (_variableRegs.TryGetValue(node.Name(), &checkReg)) {
-			Int32 checkIdx = _emitter.AddConstant(Value::make_string(node.Name()));
+			Int32 checkIdx = _emitter.AddConstant(Value::make_interned_string(node.Name()));
 			_emitter.EmitAB(Opcode::CHKNAME_rA_kBC, checkReg, checkIdx,
 				Interp("require r{} to be holding {}", checkReg, node.Name()));
 		}
@@ -642,7 +771,7 @@ Int32 CodeGeneratorStorage::VisitIdentifier(IdentifierNode node,bool addressOf)
 	String at = addressOf ? "@" : "";
 	if (_variableRegs.TryGetValue(node.Name(), &varReg)) {
 		// Variable found - emit LOADC (load-and-call for implicit function invocation)
-		EmitNamedLoad(addressOf, resultReg, varReg, Value::make_string(node.Name()),
+		EmitNamedLoad(addressOf, resultReg, varReg, Value::make_interned_string(node.Name()),
 			Interp("r{} = {}{}", resultReg, at, node.Name()));
 	} else if (_variableRegs.TryGetValue(PendingVarRegKey(node.Name()), &varReg)) {
 		// The local does not exist yet, but an enclosing loop has reserved the
@@ -653,7 +782,7 @@ Int32 CodeGeneratorStorage::VisitIdentifier(IdentifierNode node,bool addressOf)
 		// makes the guard match, so until the assignment has run once this falls
 		// back to the run-time search and finds the enclosing scope, and from then
 		// on it finds the local that now shadows it.
-		EmitNamedLoad(addressOf, resultReg, varReg, Value::make_string(node.Name()),
+		EmitNamedLoad(addressOf, resultReg, varReg, Value::make_interned_string(node.Name()),
 			Interp("r{} = {}{} (outer until assigned)", resultReg, at, node.Name()));
 	} else {
 		// Variable has no register here: at global scope it is a slot, and
@@ -790,6 +919,7 @@ Int32 CodeGeneratorStorage::Visit(AssignmentNode node) {
 	if (!IsNull(rhsFunc) && funcIndexBeforeRHS < _functions.Count()) {
 		FuncDef rhsFuncDef = _functions[funcIndexBeforeRHS];
 		if (!IsNull(rhsFuncDef)) rhsFuncDef.set_Name(node.Variable());
+		NoteFunctionAssignment(node.Variable());
 	}
 
 	// Note that we don't FreeReg(varReg) here, as we need this register to
@@ -814,6 +944,7 @@ Int32 CodeGeneratorStorage::VisitGlobalAssignment(AssignmentNode node) {
 	if (!IsNull(rhsFunc) && funcIndexBeforeRHS < _functions.Count()) {
 		FuncDef rhsFuncDef = _functions[funcIndexBeforeRHS];
 		if (!IsNull(rhsFuncDef)) rhsFuncDef.set_Name(node.Variable());
+		NoteFunctionAssignment(node.Variable());
 	}
 
 	EmitGlobalStore(node.Variable(), valueReg);
@@ -822,7 +953,7 @@ Int32 CodeGeneratorStorage::VisitGlobalAssignment(AssignmentNode node) {
 Int32 CodeGeneratorStorage::Visit(IndexedAssignmentNode node) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
 	Int32 containerReg = node.Target().Accept(_this);
-	Int32 indexReg = node.Index().Accept(_this);
+	Int32 indexReg = CompileOperand(node.Index());
 
 	// If the RHS is a function expression, note the current function count so we
 	// can assign a name to the resulting FuncDef afterward.
@@ -857,7 +988,7 @@ Int32 CodeGeneratorStorage::Visit(IndexedAssignmentNode node) {
 	}
 
 	FreeReg(valueReg);
-	FreeReg(indexReg);
+	FreeOperand(indexReg);
 	return containerReg;
 }
 Int32 CodeGeneratorStorage::Visit(UnaryOpNode node) {
@@ -874,7 +1005,8 @@ Int32 CodeGeneratorStorage::Visit(UnaryOpNode node) {
 		return node.Operand().Accept(_this);
 	}
 		
-	Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
+	Int32 target = TakeTarget();  // Capture target before any recursive calls
+	Int32 resultReg;
 
 	Int32 operandReg = node.Operand().Accept(_this);
 
@@ -882,23 +1014,27 @@ Int32 CodeGeneratorStorage::Visit(UnaryOpNode node) {
 		// Negate: result = 0 - operand
 		Int32 zeroReg = AllocReg();
 		_emitter.EmitAB(Opcode::LOAD_rA_iBC, zeroReg, 0, "r{zeroReg} = 0 (for negation)");
-		_emitter.EmitABC(Opcode::SUB_rA_rB_rC, resultReg, zeroReg, operandReg, Interp("r{} = -{}", resultReg, node.Operand().ToStr()));
 		FreeReg(zeroReg);
 		FreeReg(operandReg);
+		resultReg = ResultReg(target);
+		_emitter.EmitABC(Opcode::SUB_rA_rB_rC, resultReg, zeroReg, operandReg, Interp("r{} = -{}", resultReg, node.Operand().ToStr()));
 		return resultReg;
 	} else if (node.Op() == Op::NOT) {
 		// Fuzzy logic NOT: 1 - AbsClamp01(operand)
-		_emitter.EmitABC(Opcode::NOT_rA_rB, resultReg, operandReg, 0, Interp("not {}", node.Operand().ToStr()));
 		FreeReg(operandReg);
+		resultReg = ResultReg(target);
+		_emitter.EmitABC(Opcode::NOT_rA_rB, resultReg, operandReg, 0, Interp("not {}", node.Operand().ToStr()));
 		return resultReg;
 	} else if (node.Op() == Op::NEW) {
 		// new: create a map with __isa set to the operand
-		_emitter.EmitABC(Opcode::NEW_rA_rB, resultReg, operandReg, 0, Interp("new {}", node.Operand().ToStr()));
 		FreeReg(operandReg);
+		resultReg = ResultReg(target);
+		_emitter.EmitABC(Opcode::NEW_rA_rB, resultReg, operandReg, 0, Interp("new {}", node.Operand().ToStr()));
 		return resultReg;
 	}
 
 	// Unknown unary operator - move operand to result if needed
+	resultReg = ResultReg(target);
 	if (Error.IsNull()) Error = ErrorTypes::CompilerError("unknown unary operator", FileName, _emitter.CurrentLine());
 	if (operandReg != resultReg) {
 		_emitter.EmitABC(Opcode::LOAD_rA_rB, resultReg, operandReg, 0, "move to target");
@@ -907,16 +1043,18 @@ Int32 CodeGeneratorStorage::Visit(UnaryOpNode node) {
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::Visit(BinaryOpNode node) {
-	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
 	// 'and'/'or' use short-circuit evaluation: the right operand is not
 	// evaluated if the left operand alone determines the result.
 	if (node.Op() == Op::AND || node.Op() == Op::OR) {
 		return CompileShortCircuit(node);
 	}
 
-	Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
-	Int32 leftReg = node.Left().Accept(_this);
-	Int32 rightReg = node.Right().Accept(_this);
+	Int32 target = TakeTarget();  // Capture target before any recursive calls
+	Int32 leftReg = CompileOperand(node.Left());
+	Int32 rightReg = CompileOperand(node.Right());
+	FreeOperand(rightReg);
+	FreeOperand(leftReg);
+	Int32 resultReg = ResultReg(target);
 
 	Opcode op = Opcode::NOOP;
 	String opSymbol = "?";
@@ -977,8 +1115,6 @@ Int32 CodeGeneratorStorage::Visit(BinaryOpNode node) {
 			Interp("r{} = {} {} {}", resultReg, node.Left().ToStr(), opSymbol, node.Right().ToStr()));
 	}
 
-	FreeReg(rightReg);
-	FreeReg(leftReg);
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::CompileShortCircuit(BinaryOpNode node) {
@@ -987,9 +1123,30 @@ Int32 CodeGeneratorStorage::CompileShortCircuit(BinaryOpNode node) {
 	Int32 resultReg = GetTargetOrAlloc();
 	Int32 doneLabel = _emitter.CreateLabel();
 
-	Int32 leftReg = node.Left().Accept(_this);
+	// Evaluate the left operand straight into the result register when nothing
+	// can tell the difference: every path either keeps the left value as the
+	// result or overwrites it, and only a variable's register (which the right
+	// operand might read) has to stay untouched until the end.  That saves a
+	// register, and for 'and' the copy on the error path.
+	Int32 leftReg;
+	if (IsLiveVariableReg(resultReg)) leftReg = node.Left().Accept(_this);
+	else leftReg = CompileInto(node.Left(), resultReg);
+
+	if (isAnd && leftReg == resultReg) {
+		// As below, but an error left is already the result.
+		Int32 zeroLabel = _emitter.CreateLabel();
+		_emitter.EmitBranch(Opcode::BRERR_rA_iBC, leftReg, doneLabel, "short-circuit 'and': left is error");
+		_emitter.EmitBranch(Opcode::BRFALSE_rA_iBC, leftReg, zeroLabel, "short-circuit 'and': left is false");
+
+		Int32 rightReg = node.Right().Accept(_this);
+		_emitter.EmitABC(Opcode::AND_rA_rB_rC, resultReg, leftReg, rightReg,
+			Interp("r{} = {} and {}", resultReg, node.Left().ToStr(), node.Right().ToStr()));
+		FreeReg(rightReg);
+		_emitter.EmitJump(Opcode::JUMP_iABC, doneLabel, "skip short-circuit value");
 
-	if (isAnd) {
+		_emitter.PlaceLabel(zeroLabel);
+		_emitter.EmitAB(Opcode::LOAD_rA_iBC, resultReg, 0, Interp("r{} = 0 (short-circuit)", resultReg));
+	} else if (isAnd) {
 		// 'and': error left -> result is the error; false left -> result 0;
 		// true left -> evaluate right and combine with the fuzzy AND op.
 		Int32 errLabel = _emitter.CreateLabel();
@@ -1037,19 +1194,22 @@ Int32 CodeGeneratorStorage::CompileShortCircuit(BinaryOpNode node) {
 		_emitter.EmitAB(Opcode::LOAD_rA_iBC, resultReg, 1, Interp("r{} = 1 (short-circuit)", resultReg));
 	}
 
-	FreeReg(leftReg);
+	if (leftReg != resultReg) FreeReg(leftReg);
 	_emitter.PlaceLabel(doneLabel);
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::Visit(ComparisonChainNode node) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
-	Int32 resultReg = GetTargetOrAlloc();
+	Int32 target = TakeTarget();
 
-	// Evaluate ALL operands first (each exactly once)
+	// Evaluate ALL operands first (each exactly once).  The first is read only
+	// by the first comparison, so the result may share its register.
 	List<Int32> valueRegs =  List<Int32>::New();
 	for (Int32 i = 0; i < node.Operands().Count(); i++) {
 		valueRegs.Add(node.Operands()[i].Accept(_this));
 	}
+	FreeReg(valueRegs[0]);
+	Int32 resultReg = ResultReg(target);
 
 	// First comparison → resultReg
 	EmitComparison(node.Operators()[0], resultReg, valueRegs[0], valueRegs[1]);
@@ -1063,7 +1223,7 @@ Int32 CodeGeneratorStorage::Visit(ComparisonChainNode node) {
 	}
 
 	// Free operand registers
-	for (Int32 i = 0; i < valueRegs.Count(); i++) {
+	for (Int32 i = 1; i < valueRegs.Count(); i++) {
 		FreeReg(valueRegs[i]);
 	}
 
@@ -1096,6 +1256,16 @@ Int32 CodeGeneratorStorage::Visit(CallNode node) {
 		return CompileUserCall(node, funcVarReg, explicitTarget);
 	}
 
+	// A built-in intrinsic (that is not about to be inlined in its place):
+	// call it by number, without fetching the funcref by name.
+	Int32 intrinsicIdx = Intrinsic::DirectCallIndex(node.Function());
+	InlineCandidate inlined = FindInlineCandidate(node);
+	if (intrinsicIdx >= 0 && intrinsicIdx <= 255 && IsNull(inlined)) {
+		List<Int32> argRegs = CompileArguments(node.Arguments());
+		return EmitArgsAndCall(Opcode::CALLINTRINSIC_rA_rB_iC, intrinsicIdx, argRegs, explicitTarget,
+			Interp("call intrinsic {}", node.Function()));
+	}
+
 	// Not a known local — fetch the funcref by name, without auto-invoking it
 	// (so, the LOADV/GLOADV side of the pair rather than LOADC/GLOADC).
 	Int32 funcReg = AllocReg();
@@ -1108,8 +1278,89 @@ Int32 CodeGeneratorStorage::Visit(CallNode node) {
 }
 Int32 CodeGeneratorStorage::CompileUserCall(CallNode node,Int32 funcVarReg,Int32 explicitTarget) {
 	List<Int32> argRegs = CompileArguments(node.Arguments());
+	InlineCandidate candidate = FindInlineCandidate(node);
+	if (!IsNull(candidate)) return EmitInlinedCall(node, candidate, funcVarReg, argRegs, explicitTarget);
 	return EmitCallSequence(funcVarReg, argRegs, explicitTarget, Interp("call {}", node.Function()));
 }
+const Int32 CodeGeneratorStorage::kMaxInlineNodes = 16;
+InlineCandidate CodeGeneratorStorage::MakeInlineCandidate(FunctionNode node,FuncDef funcDef,Value funcTemplate) {
+	if (node.Body().Count() != 1) return nullptr;
+	ReturnNode ret = As<ReturnNode, ReturnNodeStorage>(node.Body()[0]);
+	if (IsNull(ret) || IsNull(ret.Value())) return nullptr;
+	if (node.ParamNames().Contains("self")) return nullptr;
+	NodeCounter counter =  NodeCounter::New();
+	if (ret.Value().Accept(counter) > kMaxInlineNodes) return nullptr;
+	InlineChecker checker =  InlineChecker::New(node.ParamNames());
+	if (ret.Value().Accept(checker) == 0) return nullptr;
+	return  InlineCandidate::New(funcDef, funcTemplate, node.ParamNames(), ret.Value(), ret.Line());
+}
+void CodeGeneratorStorage::NoteFunctionAssignment(String name) {
+	if (!IsNull(_lastFunctionInline)) {
+		_inlineCandidates[name] = _lastFunctionInline;
+	} else {
+		_inlineCandidates.Remove(name);
+	}
+}
+InlineCandidate CodeGeneratorStorage::FindInlineCandidate(CallNode node) {
+	if (!_inlineCandidates.ContainsKey(node.Function())) return nullptr;
+	InlineCandidate candidate = _inlineCandidates[node.Function()];
+	// Too many arguments is an error, which the real call reports.
+	if (node.Arguments().Count() > candidate.ParamNames().Count()) return nullptr;
+	return candidate;
+}
+Int32 CodeGeneratorStorage::EmitInlinedCall(CallNode node,InlineCandidate candidate,Int32 funcReg,List<Int32> argRegs,Int32 explicitTarget) {
+	// Choose the result register while the arguments are live: the body may
+	// write it (e.g. LIST) before it has read them all.
+	Int32 resultReg = ResultReg(explicitTarget);
+	Int32 guardIdx = _emitter.AddConstant(candidate.Template());
+	Int32 inlineLabel = _emitter.CreateLabel();
+	Int32 doneLabel = _emitter.CreateLabel();
+
+	_emitter.EmitAB(Opcode::IFFUNC_rA_kBC, funcReg, guardIdx, Interp("is {} still {}?", node.Function(), candidate.Func().Name()));
+	_emitter.EmitJump(Opcode::JUMP_iABC, inlineLabel, "yes: inline it");
+	EmitCallSequence(funcReg, argRegs, resultReg, Interp("call {}", node.Function()));
+	_emitter.EmitJump(Opcode::JUMP_iABC, doneLabel, nullptr);
+
+	// EmitCallSequence freed the arguments, and nothing has been allocated
+	// since; the inlined body reads them, so take them back.
+	_emitter.PlaceLabel(inlineLabel);
+	for (Int32 i = 0; i < argRegs.Count(); i++) ClaimReg(argRegs[i]);
+	List<Int32> paramRegs =  List<Int32>::New();
+	for (Int32 i = 0; i < candidate.ParamNames().Count(); i++) {
+		Int32 reg;
+		if (i < argRegs.Count()) {
+			reg = argRegs[i];
+		} else {
+			// Omitted argument: its default, which is always a constant.
+			reg = AllocReg();
+			Value defaultVal = candidate.Func().ParamDefaults()[i];
+			if (defaultVal.IsNull()) {
+				_emitter.EmitA(Opcode::LOADNULL_rA, reg, Interp("r{} = null (default)", reg));
+			} else {
+				Int32 constIdx = _emitter.AddConstant(defaultVal);
+				_emitter.EmitAB(Opcode::LOAD_rA_kBC, reg, constIdx, Interp("r{} = default for {}", reg, candidate.ParamNames()[i]));
+			}
+		}
+		paramRegs.Add(reg);
+		String paramName = candidate.ParamNames()[i];
+		_inlineParams[paramName] = reg;
+	}
+
+	Int32 callLine = _emitter.CurrentLine();
+	Int32 startPC = _emitter.PendingFunc().Code().Count();
+	if (candidate.Line() != 0) _emitter.set_CurrentLine(candidate.Line());
+	Int32 bodyReg = CompileInto(candidate.Body(), resultReg);
+	if (bodyReg != resultReg) {
+		_emitter.EmitABC(Opcode::LOAD_rA_rB, resultReg, bodyReg, 0, Interp("r{} = r{}", resultReg, bodyReg));
+	}
+	_emitter.set_CurrentLine(callLine);
+	_emitter.PendingFunc().AddInlineRange(startPC, _emitter.PendingFunc().Code().Count(), callLine);
+	_inlineParams.Clear();
+	for (Int32 i = 0; i < paramRegs.Count(); i++) FreeReg(paramRegs[i]);
+
+	_emitter.PlaceLabel(doneLabel);
+	return resultReg;
+}
 List<Int32> CodeGeneratorStorage::CompileArguments(List<ASTNode> arguments) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
 	List<Int32> argRegs =  List<Int32>::New();
@@ -1119,6 +1370,9 @@ List<Int32> CodeGeneratorStorage::CompileArguments(List<ASTNode> arguments) {
 	return argRegs;
 }
 Int32 CodeGeneratorStorage::EmitCallSequence(Int32 funcReg,List<Int32> argRegs,Int32 explicitTarget,String comment) {
+	return EmitArgsAndCall(Opcode::CALL_rA_rB_rC, funcReg, argRegs, explicitTarget, comment);
+}
+Int32 CodeGeneratorStorage::EmitArgsAndCall(Opcode callOp,Int32 operandC,List<Int32> argRegs,Int32 explicitTarget,String comment) {
 	Int32 argCount = argRegs.Count();
 
 	// Emit ARGBLK + ARG instructions
@@ -1131,17 +1385,18 @@ Int32 CodeGeneratorStorage::EmitCallSequence(Int32 funcReg,List<Int32> argRegs,I
 	Int32 calleeBase = _maxRegUsed + 1;
 	_emitter.ReserveRegister(calleeBase);
 
-	// Determine result register
-	Int32 resultReg = (explicitTarget >= 0) ? explicitTarget : AllocReg();
-
-	// Emit CALL: result in rA, callee frame at rB, funcref in rC
-	_emitter.EmitABC(Opcode::CALL_rA_rB_rC, resultReg, calleeBase, funcReg,
-		Interp("{}, result to r{}", comment, resultReg));
-
-	// Free argument registers
+	// The arguments are dead once ARG has copied them into the callee frame, so
+	// the result may take one of their registers (the CALL writes it only when
+	// the callee returns).  The frame base above was chosen while they were
+	// still live, which keeps it clear of them.
 	for (Int32 i = 0; i < argCount; i++) {
 		FreeReg(argRegs[i]);
 	}
+	Int32 resultReg = ResultReg(explicitTarget);
+
+	// Emit CALL: result in rA, callee frame at rB, funcref (or intrinsic) in C
+	_emitter.EmitABC(callOp, resultReg, calleeBase, operandC,
+		Interp("{}, result to r{}", comment, resultReg));
 
 	return resultReg;
 }
@@ -1157,9 +1412,11 @@ Int32 CodeGeneratorStorage::Visit(ListNode node) {
 	// LIST writes its destination before the elements are evaluated, so if the
 	// destination holds a live variable, an element that reads that variable would
 	// see the new (empty) list instead -- e.g. "x = [x]" would build a list
-	// containing itself.  Build in a temp and copy at the end.
+	// containing itself.  Build in a temp and copy at the end -- unless every
+	// element is a constant, so that nothing can read the variable (`x = []`,
+	// the common case, needs no copy).
 	Int32 buildReg = listReg;
-	if (IsLiveVariableReg(listReg)) buildReg = AllocReg();
+	if (IsLiveVariableReg(listReg) && !AllConstant(node.Elements())) buildReg = AllocReg();
 
 	// Create a list with the given number of elements
 	Int32 count = node.Elements().Count();
@@ -1184,9 +1441,12 @@ Int32 CodeGeneratorStorage::Visit(MapNode node) {
 	Int32 mapReg = GetTargetOrAlloc();
 
 	// As in Visit(ListNode): MAP writes its destination before the keys and values
-	// are evaluated, so build in a temp when the destination is live.
+	// are evaluated, so build in a temp when the destination is live and some key
+	// or value could read it.
 	Int32 buildReg = mapReg;
-	if (IsLiveVariableReg(mapReg)) buildReg = AllocReg();
+	if (IsLiveVariableReg(mapReg) && !(AllConstant(node.Keys()) && AllConstant(node.Values()))) {
+		buildReg = AllocReg();
+	}
 
 	// Create a map
 	Int32 count = node.Keys().Count();
@@ -1213,20 +1473,20 @@ Int32 CodeGeneratorStorage::Visit(IndexNode node) {
 }
 Int32 CodeGeneratorStorage::VisitIndex(IndexNode node,bool addressOf) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
-	Int32 resultReg = GetTargetOrAlloc();  // Capture target before any recursive calls
+	Int32 target = TakeTarget();  // Capture target before any recursive calls
 	Int32 targetReg = node.Target().Accept(_this);
-	Int32 indexReg = node.Index().Accept(_this);
+	Int32 indexReg = CompileOperand(node.Index());
 	String comment = Interp("{}[{}]", node.Target().ToStr(), node.Index().ToStr());
 
-	EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, Boolean(false), node.Target(), comment);
-
-	FreeReg(indexReg);
+	FreeOperand(indexReg);
 	FreeReg(targetReg);
+	Int32 resultReg = ResultReg(target);
+	EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, Boolean(false), node.Target(), comment);
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::Visit(SliceNode node) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
-	Int32 resultReg = GetTargetOrAlloc();
+	Int32 target = TakeTarget();
 	Int32 containerReg = node.Target().Accept(_this);
 
 	// Allocate two consecutive registers for start and end indices
@@ -1245,12 +1505,12 @@ Int32 CodeGeneratorStorage::Visit(SliceNode node) {
 		_emitter.EmitA(Opcode::LOADNULL_rA, endReg, Interp("r{} = null (slice end)", endReg));
 	}
 
-	_emitter.EmitABC(Opcode::SLICE_rA_rB_rC, resultReg, containerReg, startReg,
-		Interp("r{} = {}[{}]", resultReg, node.Target().ToStr(), node.ToStr()));
-
 	FreeReg(endReg);
 	FreeReg(startReg);
 	FreeReg(containerReg);
+	Int32 resultReg = ResultReg(target);
+	_emitter.EmitABC(Opcode::SLICE_rA_rB_rC, resultReg, containerReg, startReg,
+		Interp("r{} = {}[{}]", resultReg, node.Target().ToStr(), node.ToStr()));
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::Visit(MemberNode node) {
@@ -1258,17 +1518,15 @@ Int32 CodeGeneratorStorage::Visit(MemberNode node) {
 }
 Int32 CodeGeneratorStorage::VisitMember(MemberNode node,bool addressOf) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
-	Int32 resultReg = GetTargetOrAlloc();
+	Int32 target = TakeTarget();
 	Int32 targetReg = node.Target().Accept(_this);
-	Int32 indexReg = AllocReg();
-	Int32 constIdx = _emitter.AddConstant(Value::make_string(node.Member()));
-	_emitter.EmitAB(Opcode::LOAD_rA_kBC, indexReg, constIdx, Interp("r{} = \"{}\"", indexReg, node.Member()));
+	Int32 indexReg = CompileKeyOperand(node.Member());
 	String comment = Interp("{}.{}", node.Target().ToStr(), node.Member());
 
-	EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, Boolean(true), node.Target(), comment);
-
-	FreeReg(indexReg);
+	FreeOperand(indexReg);
 	FreeReg(targetReg);
+	Int32 resultReg = ResultReg(target);
+	EmitAccessOrInvoke(resultReg, targetReg, indexReg, addressOf, Boolean(true), node.Target(), comment);
 	return resultReg;
 }
 void CodeGeneratorStorage::EmitAccessOrInvoke(Int32 resultReg,Int32 targetReg,Int32 indexReg,bool addressOf,bool isDotAccess,ASTNode targetNode,String comment) {
@@ -1381,6 +1639,7 @@ Int32 CodeGeneratorStorage::Visit(WhileNode node) {
 	// at the bottom of the body, so the steady state costs one branch per
 	// iteration instead of a branch plus an unconditional jump.
 	//
+	//       [loop constants]
 	//       [evaluate condition]     <-- preheader copy
 	//       BRFALSE condReg, afterLoop
 	//       [hoisted NAME ops]
@@ -1419,8 +1678,10 @@ Int32 CodeGeneratorStorage::Visit(WhileNode node) {
 	// ReserveBodyVarRegs.
 	List<String> reserved = ReserveBodyVarRegs(node.Body());
 
-	// Preheader: the entry test.  A constant-true condition needs none -- the
+	// Preheader: the constants the loop reads (see HoistLoopConstants), then
+	// the entry test.  A constant-true condition needs no test -- the
 	// body always runs -- and emitting one would only add dead code.
+	HoistLoopConstants(node.Condition(), node.Body());
 	if (!alwaysRuns) {
 		Int32 condReg = node.Condition().Accept(_this);
 		_emitter.EmitBranch(Opcode::BRFALSE_rA_iBC, condReg, afterLoop, "skip loop if false");
@@ -1446,6 +1707,7 @@ Int32 CodeGeneratorStorage::Visit(WhileNode node) {
 		FreeReg(backReg);
 	}
 
+	ReleaseLoopConstants();
 	ReleaseBodyVarRegs(reserved);
 	_emitter.PlaceLabel(afterLoop);
 
@@ -1473,6 +1735,16 @@ Int32 CodeGeneratorStorage::Visit(IfNode node) {
 	//       [else body]
 	//   afterIf:
 
+	// A condition that always holds needs no test, and then the body is not
+	// conditional at all: its assignments stand afterward, as if it had been
+	// written inline.  IfNode.Simplify leaves a constant-condition if in
+	// this form (having dropped whichever arm cannot run).
+	NumberNode literal = As<NumberNode, NumberNodeStorage>(node.Condition());
+	if (!IsNull(literal) && literal.Value() != 0 && node.ElseBody().Count() == 0) {
+		CompileBody(node.ThenBody());
+		return -1;
+	}
+
 	Int32 afterIf = _emitter.CreateLabel();
 	Int32 elseLabel = (node.ElseBody().Count() > 0) ? _emitter.CreateLabel() : afterIf;
 
@@ -1522,24 +1794,27 @@ Int32 CodeGeneratorStorage::Visit(IfNode node) {
 }
 Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	CodeGenerator _this(std::static_pointer_cast<CodeGeneratorStorage>(shared_from_this()));
-	// For loop generates (using NEXT opcode for performance):
+	// For loop generates (using the fused ITERNEXT opcode for performance):
 	//   [evaluate iterable into listReg]
-	//   indexReg = -1  (NEXT increments before checking)
+	//   indexReg = -1  (ITERNEXT increments before checking)
 	// loopStart:
-	//   NEXT indexReg, listReg  (indexReg++; if indexReg >= len(listReg) skip next)
+	//   ITERNEXT varReg, listReg, indexReg  (indexReg++; if there is an
+	//                           element there, varReg = it and skip next)
 	//   JUMP afterLoop          (skipped unless we've reached the end)
-	//   varReg = listReg[indexReg]
 	//   [body statements]
 	//   JUMP loopStart
 	// afterLoop:
 	//
-	// At function scope the first NEXT/ITERGET is peeled off into a preheader, so
+	// ITERNEXT steps a computed `range` list with plain arithmetic, so a `for`
+	// over `range(n)` costs about what a `while` loop on a counter does: one
+	// ITERNEXT and one JUMP per iteration, with nothing materialized.
+	//
+	// At function scope the first ITERNEXT is peeled off into a preheader, so
 	// that the loop variable's NAME has somewhere to sit that runs once and only
 	// when there is a first element:
 	//
-	//   NEXT indexReg, listReg
+	//   ITERNEXT varReg, listReg, indexReg
 	//   JUMP afterLoop          (zero iterations: the variable never comes to be)
-	//   varReg = listReg[indexReg]
 	//   NAME varReg, "v"
 	//   JUMP bodyStart
 	// loopStart:
@@ -1552,7 +1827,7 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	// times, because NAME is what makes a variable exist -- emitting it ahead of
 	// the loop outright left `for j in []` with a defined `j` where MiniScript 1
 	// raises Undefined Identifier (bugs.md entry 6).  Peeling satisfies both, at
-	// four instructions of code size and nothing per iteration.
+	// three instructions of code size and nothing per iteration.
 	//
 	// Global scope keeps the plain layout: top-level names are slots in the
 	// Globals table, no NAME is emitted for them, and the zero-iteration case is
@@ -1570,7 +1845,7 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	// Evaluate iterable expression
 	Int32 listReg = node.Iterable().Accept(_this);
 
-	// Allocate hidden index register (starts at -1; NEXT will increment to 0)
+	// Allocate hidden index register (starts at -1; ITERNEXT will increment to 0)
 	Int32 indexReg = AllocReg();
 	_emitter.EmitAB(Opcode::LOAD_rA_iBC, indexReg, -1, "for loop index = -1");
 
@@ -1583,7 +1858,7 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 
 	// Get or create register for loop variable.  At global scope the loop
 	// variable is a global like any other top-level name, so the register is
-	// only where ITERGET drops each element on its way to the slot; it is
+	// only where ITERNEXT drops each element on its way to the slot; it is
 	// parked under an internal key so the body's ResetTempRegisters leaves it
 	// alone, and it is never findable by the user's name.
 	Int32 varReg;
@@ -1606,17 +1881,19 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	// value the previous iteration stored.  See ReserveBodyVarRegs.
 	List<String> reserved = ReserveBodyVarRegs(node.Body());
 
-	// Peel the first iteration's NEXT/ITERGET when the loop variable still needs
-	// a NAME, so the NAME lands on a path taken only when the body will run.  If
+	// Load the constants the body reads; see HoistLoopConstants.
+	HoistLoopConstants(nullptr, node.Body());
+
+	// Peel the first iteration's ITERNEXT when the loop variable still needs a
+	// NAME, so the NAME lands on a path taken only when the body will run.  If
 	// a NAME already dominates -- the variable existed before the loop -- there
 	// is nothing to place and the plain layout is smaller.
 	Int32 nameMark = _namedStack.Count();
 	Boolean peelFirst = !_globalScope && !IsRegisterNamed(node.Variable());
 	if (peelFirst) {
-		_emitter.EmitABC(Opcode::NEXT_rA_rB, indexReg, listReg, 0, "index++; skip next if done");
+		_emitter.EmitABC(Opcode::ITERNEXT_rA_rB_rC, varReg, listReg, indexReg,
+			Interp("index++; {} = next element, or skip next if done", node.Variable()));
 		_emitter.EmitJump(Opcode::JUMP_iABC, afterLoop, "no iterations: leave the loop variable undefined");
-		_emitter.EmitABC(Opcode::ITERGET_rA_rB_rC, varReg, listReg, indexReg,
-			Interp("{} = iterget(container, index)", node.Variable()));
 		EnsureNamed(node.Variable(), varReg);
 		_emitter.EmitJump(Opcode::JUMP_iABC, bodyStart, "enter the body");
 	}
@@ -1624,14 +1901,13 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	// Place loopStart label
 	_emitter.PlaceLabel(loopStart);
 
-	// NEXT: increment index, skip next if done
-	_emitter.EmitABC(Opcode::NEXT_rA_rB, indexReg, listReg, 0, "index++; skip next if done");
+	// ITERNEXT: increment index and fetch the element at it into varReg (for
+	// lists/strings the same as INDEX; for maps a {"key":k, "value":v} map),
+	// or skip the next instruction if there is none
+	_emitter.EmitABC(Opcode::ITERNEXT_rA_rB_rC, varReg, listReg, indexReg,
+		Interp("index++; {} = next element, or skip next if done", node.Variable()));
 	_emitter.EmitJump(Opcode::JUMP_iABC, afterLoop, "exit loop");
 
-	// Get current element by position: varReg = iterget(listReg, indexReg)
-	// For lists/strings this is the same as INDEX; for maps it returns {"key":k, "value":v}
-	_emitter.EmitABC(Opcode::ITERGET_rA_rB_rC, varReg, listReg, indexReg, Interp("{} = iterget(container, index)", node.Variable()));
-
 	// At global scope, publish the element as a global before running the body.
 	if (_globalScope) EmitGlobalStore(node.Variable(), varReg);
 
@@ -1642,6 +1918,7 @@ Int32 CodeGeneratorStorage::Visit(ForNode node) {
 	// Jump back to loopStart
 	_emitter.EmitJump(Opcode::JUMP_iABC, loopStart, "loop back");
 
+	ReleaseLoopConstants();
 	ReleaseBodyVarRegs(reserved);
 
 	// Place afterLoop label
@@ -1706,7 +1983,7 @@ Boolean CodeGeneratorStorage::TryEvaluateConstant(ASTNode node,Value* result) {
 	}
 	StringNode strNode = As<StringNode, StringNodeStorage>(node);
 	if (!IsNull(strNode)) {
-		*result = Value::make_string(strNode.Value());
+		*result = Value::make_interned_string(strNode.Value());
 		return Boolean(true);
 	}
 	IdentifierNode idNode = As<IdentifierNode, IdentifierNodeStorage>(node);
@@ -1766,6 +2043,7 @@ Int32 CodeGeneratorStorage::Visit(FunctionNode node) {
 	BytecodeEmitter innerEmitter =  BytecodeEmitter::New();
 	CodeGenerator innerGen =  CodeGenerator::New(innerEmitter);
 	innerGen.set__functions(_functions);  // share the function registry
+	innerGen.set__inlineCandidates(_inlineCandidates);
 	innerGen.set_FileName(FileName);      // share the source file name
 
 	// Reserve r0 for return value, then set up param registers (r1, r2, ...)
@@ -1774,7 +2052,7 @@ Int32 CodeGeneratorStorage::Visit(FunctionNode node) {
 		Int32 paramReg = innerGen.AllocReg();  // r1, r2, ...
 		String name = node.ParamNames()[i];
 		innerGen._variableRegs()[name] = paramReg;
-		Int32 nameIdx = innerEmitter.AddConstant(Value::make_string(name));
+		Int32 nameIdx = innerEmitter.AddConstant(Value::make_interned_string(name));
 		innerEmitter.EmitAB(Opcode::NAME_rA_kBC, paramReg, nameIdx, Interp("param {}", name));
 		// Params are named unconditionally at function entry, so reassigning
 		// one in the body needn't re-emit NAME.
@@ -1815,7 +2093,7 @@ Int32 CodeGeneratorStorage::Visit(FunctionNode node) {
 	// Set parameter info on the FuncDef
 	Value defaultVal;
 	for (Int32 i = 0; i < node.ParamNames().Count(); i++) {
-		funcDef.ParamNames().Add(Value::make_string(node.ParamNames()[i]));
+		funcDef.ParamNames().Add(Value::make_interned_string(node.ParamNames()[i]));
 		ASTNode defaultNode = node.ParamDefaults()[i];
 		if (!IsNull(defaultNode)) {
 			if (TryEvaluateConstant(defaultNode, &defaultVal)) {
@@ -1845,6 +2123,7 @@ Int32 CodeGeneratorStorage::Visit(FunctionNode node) {
 	_emitter.EmitAB(Opcode::FUNCREF_iA_iBC, resultReg, templateConst,
 		Interp("r{} = funcref {}", resultReg, funcName));
 
+	_lastFunctionInline = MakeInlineCandidate(node, funcDef, funcTemplate);
 	return resultReg;
 }
 Int32 CodeGeneratorStorage::GetSelfReg() {
@@ -2003,13 +2282,11 @@ Int32 CodeGeneratorStorage::EmitMethodCall(Int32 receiverReg,String methodKey,Li
 	List<Int32> argRegs = CompileArguments(arguments);
 
 	// Look up the method using METHFIND (walks __isa chain, sets pending self/super)
-	Int32 keyReg = AllocReg();
-	Int32 constIdx = _emitter.AddConstant(Value::make_string(methodKey));
-	_emitter.EmitAB(Opcode::LOAD_rA_kBC, keyReg, constIdx, Interp("r{} = \"{}\"", keyReg, methodKey));
+	Int32 keyReg = CompileKeyOperand(methodKey);
 	Int32 funcReg = AllocReg();
 	_emitter.EmitABC(Opcode::METHFIND_rA_rB_rC, funcReg, receiverReg, keyReg,
 		Interp("r{} = {} (method lookup)", funcReg, methodKey));
-	FreeReg(keyReg);
+	FreeOperand(keyReg);
 
 	// For super.method() calls, override pendingSelf with the current self
 	if (preserveSelf) {
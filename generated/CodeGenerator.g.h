@@ -33,10 +33,16 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	private: List<Int32> _loopNameMarks; // per open loop: _namedStack depth on entry
 	private: List<String> _loopReserved;
 	private: List<Int32> _loopReservedStarts;
+	private: List<Value> _loopConstValues;
+	private: List<Int32> _loopConstRegs;
+	private: List<Int32> _loopConstStarts;
 	private: Int32 _targetReg; // Target register for next expression (-1 = allocate)
 	private: List<Int32> _loopExitLabels; // Stack of loop exit labels for break
 	private: List<Int32> _loopContinueLabels; // Stack of loop continue labels for continue
 	private: List<FuncDef> _functions; // Compile-time registry of all functions (for naming + disassembly)
+	private: Dictionary<String, InlineCandidate> _inlineCandidates;
+	private: InlineCandidate _lastFunctionInline; // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+	private: Dictionary<String, Int32> _inlineParams; // while compiling an inlined body: parameter name -> register of its argument
 	private: Boolean _globalScope;
 	public: String FileName = ""; // Source file name, copied to each compiled FuncDef
 	public: Value Error;
@@ -48,6 +54,11 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// Names an open loop's body creates -- what ReserveBodyVarRegs parked a register
 	// for.  Stacked end to end, innermost last, with _loopReservedStarts giving each
 	// reservation's first index.  See MayBeAssignedByEarlierIteration.
+	// Constants the open loops' preheaders loaded into registers, and those
+	// registers: stacked end to end, innermost last, with _loopConstStarts giving
+	// each loop's first index.  See HoistLoopConstants.
+	// Functions whose calls may be compiled inline, by the name each was last
+	// assigned to.  Shared with nested generators, like _functions.
 
 	// True while compiling code whose named variables are GLOBALS rather than
 	// registers -- that is, @main and only @main.  A module compiled for `import`
@@ -66,6 +77,10 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// Allocate a register
 	private: Int32 AllocReg();
 
+	// Mark a register in use again after FreeReg, when the caller knows nothing
+	// has been allocated since (see EmitInlinedCall).
+	private: void ClaimReg(Int32 reg);
+
 	// Free a register so it can be reused
 	private: void FreeReg(Int32 reg);
 
@@ -88,6 +103,11 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// assignment -- and neither subsumes the other.
 	private: Boolean IsLiveVariableReg(Int32 reg);
 
+	// Are all of these expressions constants (see TryEvaluateConstant)?  Such an
+	// expression reads no register, so nothing it does can see a destination
+	// that was written early.
+	private: static Boolean AllConstant(List<ASTNode> nodes);
+
 	// Compile an expression into a specific target register
 	// The target register should already be allocated by the caller
 	private: Int32 CompileInto(ASTNode node, Int32 targetReg);
@@ -96,12 +116,29 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// IMPORTANT: Call this at the START of each Visit method, before any recursive calls
 	private: Int32 GetTargetOrAlloc();
 
+	// Take the target register, if one was set, WITHOUT allocating one.  This is
+	// the other half of live-range reuse: a Visit method whose instruction reads
+	// all its operands before writing its result calls this at the start (for the
+	// same reason as GetTargetOrAlloc), evaluates and frees its operands, and only
+	// then calls ResultReg.  An operand's live range ends at the instruction that
+	// consumes it, so the result can take its register -- `a[i-1] + b` then needs
+	// three temps rather than five, and MaxRegs shrinks with the nesting depth.
+	private: Int32 TakeTarget();
+
+	// The result register for a target taken by TakeTarget: the target itself, or
+	// the lowest free register.  Call after freeing the operands.
+	private: Int32 ResultReg(Int32 target);
+
 	// Compile an expression, placing result in a newly allocated register
 	// Returns the register number holding the result
 	public: Int32 Compile(ASTNode ast);
 
 	// Reset temporary registers before compiling a new statement.
-	// Keeps r0 and all variable registers; frees everything else.
+	// Keeps r0 and all variable registers; frees everything else.  Temps are
+	// allocated lowest-first, so they fill any gaps between variable registers
+	// before going above them.  _maxRegUsed drops back to the highest variable
+	// register too; left at the previous statement's high water mark, it would
+	// put every later call's frame (see EmitCallSequence) needlessly high.
 	private: void ResetTempRegisters();
 
 	// Compile a list of statements (a block body).
@@ -243,6 +280,57 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// runs only when the body does, so a zero-iteration loop leaves these names
 	// undefined for the code that follows.
 	private: Int32 EmitHoistedNames(List<String> names);
+	private: static const Int32 kMaxLoopConstants;
+
+	// ── Loop-invariant constants ─────────────────────────────────────────────
+	// An operand that is a literal -- the 1 in `j = j + 1`, the "k" in `m.k` --
+	// compiles to a LOAD into a temp right before the instruction that reads it,
+	// so in a loop it is reloaded on every iteration.  A constant is the one kind
+	// of operand that is invariant by construction, so the loop's preheader can
+	// load it into a register once and the body can read that register instead,
+	// saving a dispatch per use per iteration.
+	// Nothing else a loop reads can be hoisted this way without a guard.  Reading
+	// any variable may call a function (a funcref is invoked when read), and that
+	// function may rebind a global or change a list or map, so neither a global's
+	// value nor `len` of a list nor `m["k"]` is provably the same on the next
+	// iteration.  Global loads are made cheap where they are instead: see
+	// FuncDef.GlobalIntrinsics.
+	// The registers are parked in _variableRegs under internal keys, as the `for`
+	// loop's hidden registers are, so ResetTempRegisters keeps them live through
+	// the body, and IsLiveVariableReg counts them.  Only CompileOperand hands one
+	// out, and only to an instruction that reads it; such callers release it with
+	// FreeOperand, which leaves it alone.
+
+	private: static String LoopConstRegKey(Int32 index);
+
+	// Load the constants these loop nodes read as operands into registers, ahead
+	// of the loop, and open this loop's span of the table.  Constants an enclosing
+	// loop already holds are not loaded again.  Must be paired with
+	// ReleaseLoopConstants once the loop is closed.
+	private: void HoistLoopConstants(ASTNode condition, List<ASTNode> body);
+
+	// Close the innermost loop's span of the table and free its registers.
+	private: void ReleaseLoopConstants();
+
+	// The register an open loop holds this constant in, or -1.
+	private: Int32 FindLoopConst(Value value);
+
+	private: Boolean IsLoopConstReg(Int32 reg);
+
+	// Compile an operand that the consuming instruction only reads.  A literal an
+	// open loop has hoisted comes back as the register holding it; anything else
+	// is compiled as usual.  Release the result with FreeOperand.
+	private: Int32 CompileOperand(ASTNode node);
+
+	private: void FreeOperand(Int32 reg);
+
+	// A register holding a member or method name, for METHFIND: an open loop's
+	// hoisted copy, or a temp loaded here.  Release it with FreeOperand.
+	private: Int32 CompileKeyOperand(String key);
+
+	// Load a number or string constant into reg, as Visit(NumberNode) and
+	// Visit(StringNode) would.
+	private: void EmitLoadConstant(Int32 reg, Value value, String note);
 
 	// ── Definite assignment ──────────────────────────────────────────────────
 	// _namedStack holds the variables that are definitely assigned at the current
@@ -421,6 +509,45 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 
 	// Compile a call to a user-defined function (funcref in a register)
 	private: Int32 CompileUserCall(CallNode node, Int32 funcVarReg, Int32 explicitTarget);
+	private: static const Int32 kMaxInlineNodes;
+
+	// ── Inlining ─────────────────────────────────────────────────────────────
+
+	// Largest returned expression (in AST nodes, as NodeCounter counts them)
+	// that a call may be replaced with.
+
+	// If calls to the function compiled from this node may be compiled inline,
+	// return what that takes; otherwise null.  The body must be a single
+	// `return` of a small expression that reads nothing but the parameters
+	// (InlineChecker).  So it makes no calls -- it is not recursive, and has no
+	// frame of its own to be missed -- and it needs nothing from the callee's
+	// scope, so it means the same in the caller's.
+	private: static InlineCandidate MakeInlineCandidate(FunctionNode node, FuncDef funcDef, Value funcTemplate);
+
+	// After compiling `name = function ...`, note whether that function can be
+	// inlined where name is called.  The binding is only a guess (name may be
+	// reassigned, or mean a different variable where it is called), which is
+	// fine: the inlined code checks it (see EmitInlinedCall).
+	private: void NoteFunctionAssignment(String name);
+
+	// The function this call may be inlined from, or null.
+	private: InlineCandidate FindInlineCandidate(CallNode node);
+
+	// Compile a call to a function that may be inlined.  What the name refers to
+	// is only known at run time, so the inlined body is guarded: it runs when
+	// IFFUNC finds the funcref being called is (a closure of) the function we
+	// inlined, and otherwise the call is made as usual:
+	//     IFFUNC rF, k          ; rF still the function in k?
+	//     JUMP   inline
+	//     ARGBLK/ARG/CALL       ; no: call whatever it is now
+	//     JUMP   done
+	//   inline:
+	//     (the body, reading the argument registers as its parameters)
+	//   done:
+	// The body's code carries the callee's line numbers, and its PC range is
+	// recorded in the caller (FuncDef.AddInlineRange), so a stack trace taken
+	// inside it still shows both the function and the call.
+	private: Int32 EmitInlinedCall(CallNode node, InlineCandidate candidate, Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget);
 
 	// Compile argument expressions into temporary registers.
 	private: List<Int32> CompileArguments(List<ASTNode> arguments);
@@ -429,6 +556,13 @@ class CodeGeneratorStorage : public std::enable_shared_from_this<CodeGeneratorSt
 	// the argument registers.  Returns the result register.
 	private: Int32 EmitCallSequence(Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget, String comment);
 
+	// The same, ending in the given call opcode: CALL, with the funcref
+	// register as its C operand, or CALLINTRINSIC, with the intrinsic's index.
+	// A name bound to an intrinsic at compile time can still be shadowed by
+	// the time the call runs, so CALLINTRINSIC checks that it is not, and if
+	// it is, calls what the name means then, with these same arguments.
+	private: Int32 EmitArgsAndCall(Opcode callOp, Int32 operandC, List<Int32> argRegs, Int32 explicitTarget, String comment);
+
 	public: Int32 Visit(GroupNode node);
 
 	public: Int32 Visit(ListNode node);
@@ -555,6 +689,12 @@ struct CodeGenerator : public IASTVisitor {
 	private: void set__loopReserved(List<String> _v);
 	private: List<Int32> _loopReservedStarts();
 	private: void set__loopReservedStarts(List<Int32> _v);
+	private: List<Value> _loopConstValues();
+	private: void set__loopConstValues(List<Value> _v);
+	private: List<Int32> _loopConstRegs();
+	private: void set__loopConstRegs(List<Int32> _v);
+	private: List<Int32> _loopConstStarts();
+	private: void set__loopConstStarts(List<Int32> _v);
 	private: Int32 _targetReg(); // Target register for next expression (-1 = allocate)
 	private: void set__targetReg(Int32 _v); // Target register for next expression (-1 = allocate)
 	private: List<Int32> _loopExitLabels(); // Stack of loop exit labels for break
@@ -563,6 +703,12 @@ struct CodeGenerator : public IASTVisitor {
 	private: void set__loopContinueLabels(List<Int32> _v); // Stack of loop continue labels for continue
 	private: List<FuncDef> _functions(); // Compile-time registry of all functions (for naming + disassembly)
 	private: void set__functions(List<FuncDef> _v); // Compile-time registry of all functions (for naming + disassembly)
+	private: Dictionary<String, InlineCandidate> _inlineCandidates();
+	private: void set__inlineCandidates(Dictionary<String, InlineCandidate> _v);
+	private: InlineCandidate _lastFunctionInline(); // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+	private: void set__lastFunctionInline(InlineCandidate _v); // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+	private: Dictionary<String, Int32> _inlineParams(); // while compiling an inlined body: parameter name -> register of its argument
+	private: void set__inlineParams(Dictionary<String, Int32> _v); // while compiling an inlined body: parameter name -> register of its argument
 	private: Boolean _globalScope();
 	private: void set__globalScope(Boolean _v);
 	public: String FileName(); // Source file name, copied to each compiled FuncDef
@@ -577,6 +723,11 @@ struct CodeGenerator : public IASTVisitor {
 	// Names an open loop's body creates -- what ReserveBodyVarRegs parked a register
 	// for.  Stacked end to end, innermost last, with _loopReservedStarts giving each
 	// reservation's first index.  See MayBeAssignedByEarlierIteration.
+	// Constants the open loops' preheaders loaded into registers, and those
+	// registers: stacked end to end, innermost last, with _loopConstStarts giving
+	// each loop's first index.  See HoistLoopConstants.
+	// Functions whose calls may be compiled inline, by the name each was last
+	// assigned to.  Shared with nested generators, like _functions.
 
 	// True while compiling code whose named variables are GLOBALS rather than
 	// registers -- that is, @main and only @main.  A module compiled for `import`
@@ -597,6 +748,10 @@ struct CodeGenerator : public IASTVisitor {
 	// Allocate a register
 	private: inline Int32 AllocReg();
 
+	// Mark a register in use again after FreeReg, when the caller knows nothing
+	// has been allocated since (see EmitInlinedCall).
+	private: inline void ClaimReg(Int32 reg);
+
 	// Free a register so it can be reused
 	private: inline void FreeReg(Int32 reg);
 
@@ -619,6 +774,11 @@ struct CodeGenerator : public IASTVisitor {
 	// assignment -- and neither subsumes the other.
 	private: inline Boolean IsLiveVariableReg(Int32 reg);
 
+	// Are all of these expressions constants (see TryEvaluateConstant)?  Such an
+	// expression reads no register, so nothing it does can see a destination
+	// that was written early.
+	private: static Boolean AllConstant(List<ASTNode> nodes) { return CodeGeneratorStorage::AllConstant(nodes); }
+
 	// Compile an expression into a specific target register
 	// The target register should already be allocated by the caller
 	private: inline Int32 CompileInto(ASTNode node, Int32 targetReg);
@@ -627,12 +787,29 @@ struct CodeGenerator : public IASTVisitor {
 	// IMPORTANT: Call this at the START of each Visit method, before any recursive calls
 	private: inline Int32 GetTargetOrAlloc();
 
+	// Take the target register, if one was set, WITHOUT allocating one.  This is
+	// the other half of live-range reuse: a Visit method whose instruction reads
+	// all its operands before writing its result calls this at the start (for the
+	// same reason as GetTargetOrAlloc), evaluates and frees its operands, and only
+	// then calls ResultReg.  An operand's live range ends at the instruction that
+	// consumes it, so the result can take its register -- `a[i-1] + b` then needs
+	// three temps rather than five, and MaxRegs shrinks with the nesting depth.
+	private: inline Int32 TakeTarget();
+
+	// The result register for a target taken by TakeTarget: the target itself, or
+	// the lowest free register.  Call after freeing the operands.
+	private: inline Int32 ResultReg(Int32 target);
+
 	// Compile an expression, placing result in a newly allocated register
 	// Returns the register number holding the result
 	public: inline Int32 Compile(ASTNode ast);
 
 	// Reset temporary registers before compiling a new statement.
-	// Keeps r0 and all variable registers; frees everything else.
+	// Keeps r0 and all variable registers; frees everything else.  Temps are
+	// allocated lowest-first, so they fill any gaps between variable registers
+	// before going above them.  _maxRegUsed drops back to the highest variable
+	// register too; left at the previous statement's high water mark, it would
+	// put every later call's frame (see EmitCallSequence) needlessly high.
 	private: inline void ResetTempRegisters();
 
 	// Compile a list of statements (a block body).
@@ -774,6 +951,57 @@ struct CodeGenerator : public IASTVisitor {
 	// runs only when the body does, so a zero-iteration loop leaves these names
 	// undefined for the code that follows.
 	private: inline Int32 EmitHoistedNames(List<String> names);
+	private: Int32 kMaxLoopConstants();
+
+	// ── Loop-invariant constants ─────────────────────────────────────────────
+	// An operand that is a literal -- the 1 in `j = j + 1`, the "k" in `m.k` --
+	// compiles to a LOAD into a temp right before the instruction that reads it,
+	// so in a loop it is reloaded on every iteration.  A constant is the one kind
+	// of operand that is invariant by construction, so the loop's preheader can
+	// load it into a register once and the body can read that register instead,
+	// saving a dispatch per use per iteration.
+	// Nothing else a loop reads can be hoisted this way without a guard.  Reading
+	// any variable may call a function (a funcref is invoked when read), and that
+	// function may rebind a global or change a list or map, so neither a global's
+	// value nor `len` of a list nor `m["k"]` is provably the same on the next
+	// iteration.  Global loads are made cheap where they are instead: see
+	// FuncDef.GlobalIntrinsics.
+	// The registers are parked in _variableRegs under internal keys, as the `for`
+	// loop's hidden registers are, so ResetTempRegisters keeps them live through
+	// the body, and IsLiveVariableReg counts them.  Only CompileOperand hands one
+	// out, and only to an instruction that reads it; such callers release it with
+	// FreeOperand, which leaves it alone.
+
+	private: static String LoopConstRegKey(Int32 index) { return CodeGeneratorStorage::LoopConstRegKey(index); }
+
+	// Load the constants these loop nodes read as operands into registers, ahead
+	// of the loop, and open this loop's span of the table.  Constants an enclosing
+	// loop already holds are not loaded again.  Must be paired with
+	// ReleaseLoopConstants once the loop is closed.
+	private: inline void HoistLoopConstants(ASTNode condition, List<ASTNode> body);
+
+	// Close the innermost loop's span of the table and free its registers.
+	private: inline void ReleaseLoopConstants();
+
+	// The register an open loop holds this constant in, or -1.
+	private: inline Int32 FindLoopConst(Value value);
+
+	private: inline Boolean IsLoopConstReg(Int32 reg);
+
+	// Compile an operand that the consuming instruction only reads.  A literal an
+	// open loop has hoisted comes back as the register holding it; anything else
+	// is compiled as usual.  Release the result with FreeOperand.
+	private: inline Int32 CompileOperand(ASTNode node);
+
+	private: inline void FreeOperand(Int32 reg);
+
+	// A register holding a member or method name, for METHFIND: an open loop's
+	// hoisted copy, or a temp loaded here.  Release it with FreeOperand.
+	private: inline Int32 CompileKeyOperand(String key);
+
+	// Load a number or string constant into reg, as Visit(NumberNode) and
+	// Visit(StringNode) would.
+	private: inline void EmitLoadConstant(Int32 reg, Value value, String note);
 
 	// ── Definite assignment ──────────────────────────────────────────────────
 	// _namedStack holds the variables that are definitely assigned at the current
@@ -952,6 +1180,45 @@ struct CodeGenerator : public IASTVisitor {
 
 	// Compile a call to a user-defined function (funcref in a register)
 	private: inline Int32 CompileUserCall(CallNode node, Int32 funcVarReg, Int32 explicitTarget);
+	private: Int32 kMaxInlineNodes();
+
+	// ── Inlining ─────────────────────────────────────────────────────────────
+
+	// Largest returned expression (in AST nodes, as NodeCounter counts them)
+	// that a call may be replaced with.
+
+	// If calls to the function compiled from this node may be compiled inline,
+	// return what that takes; otherwise null.  The body must be a single
+	// `return` of a small expression that reads nothing but the parameters
+	// (InlineChecker).  So it makes no calls -- it is not recursive, and has no
+	// frame of its own to be missed -- and it needs nothing from the callee's
+	// scope, so it means the same in the caller's.
+	private: static InlineCandidate MakeInlineCandidate(FunctionNode node, FuncDef funcDef, Value funcTemplate) { return CodeGeneratorStorage::MakeInlineCandidate(node, funcDef, funcTemplate); }
+
+	// After compiling `name = function ...`, note whether that function can be
+	// inlined where name is called.  The binding is only a guess (name may be
+	// reassigned, or mean a different variable where it is called), which is
+	// fine: the inlined code checks it (see EmitInlinedCall).
+	private: inline void NoteFunctionAssignment(String name);
+
+	// The function this call may be inlined from, or null.
+	private: inline InlineCandidate FindInlineCandidate(CallNode node);
+
+	// Compile a call to a function that may be inlined.  What the name refers to
+	// is only known at run time, so the inlined body is guarded: it runs when
+	// IFFUNC finds the funcref being called is (a closure of) the function we
+	// inlined, and otherwise the call is made as usual:
+	//     IFFUNC rF, k          ; rF still the function in k?
+	//     JUMP   inline
+	//     ARGBLK/ARG/CALL       ; no: call whatever it is now
+	//     JUMP   done
+	//   inline:
+	//     (the body, reading the argument registers as its parameters)
+	//   done:
+	// The body's code carries the callee's line numbers, and its PC range is
+	// recorded in the caller (FuncDef.AddInlineRange), so a stack trace taken
+	// inside it still shows both the function and the call.
+	private: inline Int32 EmitInlinedCall(CallNode node, InlineCandidate candidate, Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget);
 
 	// Compile argument expressions into temporary registers.
 	private: inline List<Int32> CompileArguments(List<ASTNode> arguments);
@@ -960,6 +1227,13 @@ struct CodeGenerator : public IASTVisitor {
 	// the argument registers.  Returns the result register.
 	private: inline Int32 EmitCallSequence(Int32 funcReg, List<Int32> argRegs, Int32 explicitTarget, String comment);
 
+	// The same, ending in the given call opcode: CALL, with the funcref
+	// register as its C operand, or CALLINTRINSIC, with the intrinsic's index.
+	// A name bound to an intrinsic at compile time can still be shadowed by
+	// the time the call runs, so CALLINTRINSIC checks that it is not, and if
+	// it is, calls what the name means then, with these same arguments.
+	private: inline Int32 EmitArgsAndCall(Opcode callOp, Int32 operandC, List<Int32> argRegs, Int32 explicitTarget, String comment);
+
 	public: inline Int32 Visit(GroupNode node);
 
 	public: inline Int32 Visit(ListNode node);
@@ -1080,6 +1354,12 @@ inline List<String> CodeGenerator::_loopReserved() { return get()->_loopReserved
 inline void CodeGenerator::set__loopReserved(List<String> _v) { get()->_loopReserved = _v; }
 inline List<Int32> CodeGenerator::_loopReservedStarts() { return get()->_loopReservedStarts; }
 inline void CodeGenerator::set__loopReservedStarts(List<Int32> _v) { get()->_loopReservedStarts = _v; }
+inline List<Value> CodeGenerator::_loopConstValues() { return get()->_loopConstValues; }
+inline void CodeGenerator::set__loopConstValues(List<Value> _v) { get()->_loopConstValues = _v; }
+inline List<Int32> CodeGenerator::_loopConstRegs() { return get()->_loopConstRegs; }
+inline void CodeGenerator::set__loopConstRegs(List<Int32> _v) { get()->_loopConstRegs = _v; }
+inline List<Int32> CodeGenerator::_loopConstStarts() { return get()->_loopConstStarts; }
+inline void CodeGenerator::set__loopConstStarts(List<Int32> _v) { get()->_loopConstStarts = _v; }
 inline Int32 CodeGenerator::_targetReg() { return get()->_targetReg; } // Target register for next expression (-1 = allocate)
 inline void CodeGenerator::set__targetReg(Int32 _v) { get()->_targetReg = _v; } // Target register for next expression (-1 = allocate)
 inline List<Int32> CodeGenerator::_loopExitLabels() { return get()->_loopExitLabels; } // Stack of loop exit labels for break
@@ -1088,6 +1368,12 @@ inline List<Int32> CodeGenerator::_loopContinueLabels() { return get()->_loopCon
 inline void CodeGenerator::set__loopContinueLabels(List<Int32> _v) { get()->_loopContinueLabels = _v; } // Stack of loop continue labels for continue
 inline List<FuncDef> CodeGenerator::_functions() { return get()->_functions; } // Compile-time registry of all functions (for naming + disassembly)
 inline void CodeGenerator::set__functions(List<FuncDef> _v) { get()->_functions = _v; } // Compile-time registry of all functions (for naming + disassembly)
+inline Dictionary<String, InlineCandidate> CodeGenerator::_inlineCandidates() { return get()->_inlineCandidates; }
+inline void CodeGenerator::set__inlineCandidates(Dictionary<String, InlineCandidate> _v) { get()->_inlineCandidates = _v; }
+inline InlineCandidate CodeGenerator::_lastFunctionInline() { return get()->_lastFunctionInline; } // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+inline void CodeGenerator::set__lastFunctionInline(InlineCandidate _v) { get()->_lastFunctionInline = _v; } // what Visit(FunctionNode) found for the function it just compiled (null if not inlinable)
+inline Dictionary<String, Int32> CodeGenerator::_inlineParams() { return get()->_inlineParams; } // while compiling an inlined body: parameter name -> register of its argument
+inline void CodeGenerator::set__inlineParams(Dictionary<String, Int32> _v) { get()->_inlineParams = _v; } // while compiling an inlined body: parameter name -> register of its argument
 inline Boolean CodeGenerator::_globalScope() { return get()->_globalScope; }
 inline void CodeGenerator::set__globalScope(Boolean _v) { get()->_globalScope = _v; }
 inline String CodeGenerator::FileName() { return get()->FileName; } // Source file name, copied to each compiled FuncDef
@@ -1096,11 +1382,14 @@ inline Value CodeGenerator::Error() { return get()->Error; }
 inline void CodeGenerator::set_Error(Value _v) { get()->Error = _v; }
 inline List<FuncDef> CodeGenerator::GetFunctions() { return get()->GetFunctions(); }
 inline Int32 CodeGenerator::AllocReg() { return get()->AllocReg(); }
+inline void CodeGenerator::ClaimReg(Int32 reg) { return get()->ClaimReg(reg); }
 inline void CodeGenerator::FreeReg(Int32 reg) { return get()->FreeReg(reg); }
 inline Int32 CodeGenerator::AllocConsecutiveRegs(Int32 count) { return get()->AllocConsecutiveRegs(count); }
 inline Boolean CodeGenerator::IsLiveVariableReg(Int32 reg) { return get()->IsLiveVariableReg(reg); }
 inline Int32 CodeGenerator::CompileInto(ASTNode node,Int32 targetReg) { return get()->CompileInto(node, targetReg); }
 inline Int32 CodeGenerator::GetTargetOrAlloc() { return get()->GetTargetOrAlloc(); }
+inline Int32 CodeGenerator::TakeTarget() { return get()->TakeTarget(); }
+inline Int32 CodeGenerator::ResultReg(Int32 target) { return get()->ResultReg(target); }
 inline Int32 CodeGenerator::Compile(ASTNode ast) { return get()->Compile(ast); }
 inline void CodeGenerator::ResetTempRegisters() { return get()->ResetTempRegisters(); }
 inline void CodeGenerator::CompileBody(List<ASTNode> body) { return get()->CompileBody(body); }
@@ -1117,6 +1406,15 @@ inline List<String> CodeGenerator::HoistableBodyNames(List<ASTNode> body) { retu
 inline Boolean CodeGenerator::MayLeaveLoop(ASTNode node) { return get()->MayLeaveLoop(node); }
 inline Boolean CodeGenerator::AnyLeavesLoop(List<ASTNode> nodes) { return get()->AnyLeavesLoop(nodes); }
 inline Int32 CodeGenerator::EmitHoistedNames(List<String> names) { return get()->EmitHoistedNames(names); }
+inline Int32 CodeGenerator::kMaxLoopConstants() { return get()->kMaxLoopConstants; }
+inline void CodeGenerator::HoistLoopConstants(ASTNode condition,List<ASTNode> body) { return get()->HoistLoopConstants(condition, body); }
+inline void CodeGenerator::ReleaseLoopConstants() { return get()->ReleaseLoopConstants(); }
+inline Int32 CodeGenerator::FindLoopConst(Value value) { return get()->FindLoopConst(value); }
+inline Boolean CodeGenerator::IsLoopConstReg(Int32 reg) { return get()->IsLoopConstReg(reg); }
+inline Int32 CodeGenerator::CompileOperand(ASTNode node) { return get()->CompileOperand(node); }
+inline void CodeGenerator::FreeOperand(Int32 reg) { return get()->FreeOperand(reg); }
+inline Int32 CodeGenerator::CompileKeyOperand(String key) { return get()->CompileKeyOperand(key); }
+inline void CodeGenerator::EmitLoadConstant(Int32 reg,Value value,String note) { return get()->EmitLoadConstant(reg, value, note); }
 inline void CodeGenerator::PushName(String varName,Boolean isReg) { return get()->PushName(varName, isReg); }
 inline void CodeGenerator::PopNamesTo(Int32 mark) { return get()->PopNamesTo(mark); }
 inline Boolean CodeGenerator::IsRegisterNamed(String varName) { return get()->IsRegisterNamed(varName); }
@@ -1150,8 +1448,13 @@ inline Int32 CodeGenerator::Visit(ComparisonChainNode node) { return get()->Visi
 inline void CodeGenerator::EmitComparison(String op,Int32 destReg,Int32 leftReg,Int32 rightReg) { return get()->EmitComparison(op, destReg, leftReg, rightReg); }
 inline Int32 CodeGenerator::Visit(CallNode node) { return get()->Visit(node); }
 inline Int32 CodeGenerator::CompileUserCall(CallNode node,Int32 funcVarReg,Int32 explicitTarget) { return get()->CompileUserCall(node, funcVarReg, explicitTarget); }
+inline Int32 CodeGenerator::kMaxInlineNodes() { return get()->kMaxInlineNodes; }
+inline void CodeGenerator::NoteFunctionAssignment(String name) { return get()->NoteFunctionAssignment(name); }
+inline InlineCandidate CodeGenerator::FindInlineCandidate(CallNode node) { return get()->FindInlineCandidate(node); }
+inline Int32 CodeGenerator::EmitInlinedCall(CallNode node,InlineCandidate candidate,Int32 funcReg,List<Int32> argRegs,Int32 explicitTarget) { return get()->EmitInlinedCall(node, candidate, funcReg, argRegs, explicitTarget); }
 inline List<Int32> CodeGenerator::CompileArguments(List<ASTNode> arguments) { return get()->CompileArguments(arguments); }
 inline Int32 CodeGenerator::EmitCallSequence(Int32 funcReg,List<Int32> argRegs,Int32 explicitTarget,String comment) { return get()->EmitCallSequence(funcReg, argRegs, explicitTarget, comment); }
+inline Int32 CodeGenerator::EmitArgsAndCall(Opcode callOp,Int32 operandC,List<Int32> argRegs,Int32 explicitTarget,String comment) { return get()->EmitArgsAndCall(callOp, operandC, argRegs, explicitTarget, comment); }
 inline Int32 CodeGenerator::Visit(GroupNode node) { return get()->Visit(node); }
 inline Int32 CodeGenerator::Visit(ListNode node) { return get()->Visit(node); }
 inline Int32 CodeGenerator::Visit(MapNode node) { return get()->Visit(node); }
@@ -14,6 +14,10 @@
 #include "CS_value_util.h"
 #include "Interpreter.g.h"
 #include "PRNG.g.h"
+#include "Channel.g.h"
+#include "Coroutine.g.h"
+#include "SharedHeap.g.h"
+#include "ParallelMap.g.h"
 #if defined(__APPLE__)
 #include <sys/sysctl.h>
 #elif defined(_WIN32)
@@ -94,6 +98,38 @@ String CoreIntrinsics::PlatformName() {
 String CoreIntrinsics::hostName = "";
 String CoreIntrinsics::hostInfo = "";
 String CoreIntrinsics::hostVersion = "";
+IntrinsicResult CoreIntrinsics::StartParallel(Context ctx,Boolean filter) {
+	String name = filter ? "parallelFilter" : "parallelMap";
+	Value list = ctx.GetArg(0);
+	if (list.IsError()) return ctx.vm.RaiseUncaughtError(list);
+	if (!list.IsList()) return IntrinsicResult(ErrorTypes::TypeError("list", list));
+	Value func = ctx.GetArg(1);
+	if (func.IsError()) return ctx.vm.RaiseUncaughtError(func);
+	if (!func.IsFuncRef()) return IntrinsicResult(ErrorTypes::TypeError("function", func));
+	FuncDef def = func.FunctionDef();
+	if (!IsNull(def.NativeCallback())) {
+		return IntrinsicResult(ErrorTypes::RuntimeError(
+			StringUtils::Format("{0}: func must be a script function, not an intrinsic (wrap it in one)", name)));
+	}
+	String outside = ParallelMap::OutsideName(func, ctx.vm.GetGlobals());
+	if (!IsNull(outside)) {
+		return IntrinsicResult(ErrorTypes::RuntimeError(
+			StringUtils::Format("{0}: func uses '{1}', which a worker thread cannot see; it may use only its argument, its own variables, and intrinsics", name, outside)));
+	}
+	Value vChunkSize = ctx.GetArg(2);
+	Int32 chunkSize = 0;
+	if (!vChunkSize.IsNull()) {
+		double d;
+		Value e = RequireNumber(vChunkSize, &d);
+		if (!e.IsNull()) return IntrinsicResult(e);
+		if (d < 1) {
+			return IntrinsicResult(ErrorTypes::RuntimeError(
+				StringUtils::Format("{0}: chunkSize must be at least 1", name)));
+		}
+		chunkSize = (Int32)d;
+	}
+	return ParallelMap::Start(ctx, list, func, chunkSize, filter);
+}
 Value CoreIntrinsics::RequireNumber(Value v,double* result) {
 	if (v.IsNumber()) { *result = v.NumericVal(); return Value::Null; }
 	if (v.IsString()) {
@@ -134,7 +170,7 @@ Value CoreIntrinsics::ListType() {
 	}
 	return _listType;
 }
-Value CoreIntrinsics::_listType = Value::Null;
+thread_local Value CoreIntrinsics::_listType;
 Value CoreIntrinsics::StringType() {
 	if (_stringType.IsNull()) {
 		_stringType = Value::make_map(16);
@@ -155,7 +191,7 @@ Value CoreIntrinsics::StringType() {
 	}
 	return _stringType;
 }
-Value CoreIntrinsics::_stringType = Value::Null;
+thread_local Value CoreIntrinsics::_stringType;
 Value CoreIntrinsics::MapType() {
 	if (_mapType.IsNull()) {
 		_mapType = Value::make_map(16);
@@ -175,7 +211,7 @@ Value CoreIntrinsics::MapType() {
 	}
 	return _mapType;
 }
-Value CoreIntrinsics::_mapType = Value::Null;
+thread_local Value CoreIntrinsics::_mapType;
 Value CoreIntrinsics::NumberType() {
 	if (_numberType.IsNull()) {
 		_numberType = Value::make_map(4);
@@ -183,7 +219,7 @@ Value CoreIntrinsics::NumberType() {
 	}
 	return _numberType;
 }
-Value CoreIntrinsics::_numberType = Value::Null;
+thread_local Value CoreIntrinsics::_numberType;
 Value CoreIntrinsics::FunctionType() {
 	if (_functionType.IsNull()) {
 		_functionType = Value::make_map(4);
@@ -191,7 +227,7 @@ Value CoreIntrinsics::FunctionType() {
 	}
 	return _functionType;
 }
-Value CoreIntrinsics::_functionType = Value::Null;
+thread_local Value CoreIntrinsics::_functionType;
 Value CoreIntrinsics::ErrorType() {
 	if (_errorType.IsNull()) {
 		_errorType = Value::make_map(4);
@@ -202,11 +238,11 @@ Value CoreIntrinsics::ErrorType() {
 	}
 	return _errorType;
 }
-Value CoreIntrinsics::_errorType = Value::Null;
-Intrinsic CoreIntrinsics::_errorErrIntr = nullptr;
+thread_local Value CoreIntrinsics::_errorType;
+thread_local Intrinsic CoreIntrinsics::_errorErrIntr;
 Value CoreIntrinsics::_EOL = Value::make_string("\n");
-Value CoreIntrinsics::replInList = Value::Null;
-Value CoreIntrinsics::replOutList = Value::Null;
+thread_local Value CoreIntrinsics::replInList;
+thread_local Value CoreIntrinsics::replOutList;
 void CoreIntrinsics::MarkRoots(object user_data) {
 	GCManager::Mark(_listType);
 	GCManager::Mark(_stringType);
@@ -221,6 +257,10 @@ void CoreIntrinsics::MarkRoots(object user_data) {
 }
 void CoreIntrinsics::Init() {
 	GCManager::RegisterMarkCallback(CoreIntrinsics::MarkRoots, nullptr);
+	// A thread-static Value starts out as 0 in C#, not null; start clean.
+	replInList = Value::Null;
+	replOutList = Value::Null;
+	InvalidateTypeMaps();
 
 	Intrinsic f;
 
@@ -414,9 +454,9 @@ void CoreIntrinsics::Init() {
 	// len(x)
 	f = Intrinsic::Create("len");
 	f.AddParam("self");
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value container = ctx.GetArg(0);
-		if (container.IsError()) return IntrinsicResult(container);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value container = args[0];
+		if (container.IsError()) return container;
 		Value result = Value::Null;
 		if (container.IsList()) {
 			result = Value(container.ListCount());
@@ -425,7 +465,7 @@ void CoreIntrinsics::Init() {
 		} else if (container.IsMap()) {
 			result = Value(container.MapCount());
 		}
-		return IntrinsicResult(result);
+		return result;
 	});
 
 	// remove(self, index)
@@ -477,13 +517,13 @@ void CoreIntrinsics::Init() {
 	// abs(x=0)
 	f = Intrinsic::Create("abs");
 	f.AddParam("x", Value::zero);
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value v = ctx.GetArg(0);
-		if (v.IsError()) return IntrinsicResult(v);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value v = args[0];
+		if (v.IsError()) return v;
 		double x;
 		Value e = RequireNumber(v, &x);
-		if (!e.IsNull()) return IntrinsicResult(e);
-		return IntrinsicResult(Value(Math::Abs(x)));
+		if (!e.IsNull()) return e;
+		return Value(Math::Abs(x));
 	});
 
 	// acos(x=0)
@@ -555,13 +595,13 @@ void CoreIntrinsics::Init() {
 	// floor(x=0)
 	f = Intrinsic::Create("floor");
 	f.AddParam("x", Value::zero);
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value v = ctx.GetArg(0);
-		if (v.IsError()) return IntrinsicResult(v);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value v = args[0];
+		if (v.IsError()) return v;
 		double x;
 		Value e = RequireNumber(v, &x);
-		if (!e.IsNull()) return IntrinsicResult(e);
-		return IntrinsicResult(Value(Math::Floor(x)));
+		if (!e.IsNull()) return e;
+		return Value(Math::Floor(x));
 	});
 
 	// log(x=0, base=10)
@@ -662,13 +702,13 @@ void CoreIntrinsics::Init() {
 	// sqrt(x=0)
 	f = Intrinsic::Create("sqrt");
 	f.AddParam("x", Value::zero);
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value v = ctx.GetArg(0);
-		if (v.IsError()) return IntrinsicResult(v);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value v = args[0];
+		if (v.IsError()) return v;
 		double x;
 		Value e = RequireNumber(v, &x);
-		if (!e.IsNull()) return IntrinsicResult(e);
-		return IntrinsicResult(Value(Math::Sqrt(x)));
+		if (!e.IsNull()) return e;
+		return Value(Math::Sqrt(x));
 	});
 
 	// tan(radians=0)
@@ -686,18 +726,21 @@ void CoreIntrinsics::Init() {
 	f = Intrinsic::Create("push");
 	f.AddParam("self");
 	f.AddParam("value");
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value self = ctx.GetArg(0);
-		if (self.IsError()) return ctx.vm.RaiseUncaughtError(self);
-		Value value = ctx.GetArg(1);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value self = args[0];
+		if (self.IsError()) {
+			VMStorage::ActiveVM().RaiseUncaughtError(self);
+			return Value::Null;
+		}
+		Value value = args[1];
 		if (self.IsList()) {
 			self.Push(value);
-			return IntrinsicResult(self);
+			return self;
 		} else if (self.IsMap()) {
 			self.MapSet(value, Value::one);
-			return IntrinsicResult(self);
+			return self;
 		}
-		return IntrinsicResult(ErrorTypes::TypeError("list or map", self));
+		return ErrorTypes::TypeError("list or map", self);
 	});
 
 	// pop(self)
@@ -768,11 +811,11 @@ void CoreIntrinsics::Init() {
 	f.AddParam("self");
 	f.AddParam("value");
 	f.AddParam("after");
-	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
-		Value self = ctx.GetArg(0);
-		if (self.IsError()) return IntrinsicResult(self);
-		Value value = ctx.GetArg(1);
-		Value after = ctx.GetArg(2);
+	f.set_SimpleCode([](Value* args, Int32 argCount) -> Value {
+		Value self = args[0];
+		if (self.IsError()) return self;
+		Value value = args[1];
+		Value after = args[2];
 		Value result = Value::Null;
 		Value iterKey, iterVal;
 		if (self.IsList()) {
@@ -784,7 +827,7 @@ void CoreIntrinsics::Init() {
 			int idx = self.ListIndexOf(value, afterIdx);
 			if (idx >= 0) result = Value(idx);
 		} else if (self.IsString()) {
-			if (!value.IsString()) return IntrinsicResult(Value::Null);
+			if (!value.IsString()) return Value::Null;
 			int afterIdx = -1;
 			if (!after.IsNull()) {
 				afterIdx = (int)after.NumericVal();
@@ -809,9 +852,9 @@ void CoreIntrinsics::Init() {
 				}
 			}
 		} else {
-			return IntrinsicResult(ErrorTypes::TypeError("list, string, or map", self));
+			return ErrorTypes::TypeError("list, string, or map", self);
 		}
-		return IntrinsicResult(result);
+		return result;
 	});
 
 	// sort(self, byKey=null, ascending=1)
@@ -1010,7 +1053,6 @@ void CoreIntrinsics::Init() {
 		Value self = ctx.GetArg(0);
 		if (self.IsError()) return IntrinsicResult(self);
 		Value result = Value::Null;
-		Value iterKey;
 		if (self.IsList()) {
 			int count = self.ListCount();
 			result = Value::make_list(count);
@@ -1027,10 +1069,8 @@ void CoreIntrinsics::Init() {
 			return IntrinsicResult(result);
 		} else if (self.IsMap()) {
 			result = Value::make_list(self.MapCount());
-			MapIterator iter = self.Iterator();
-			while (map_iterator_next(&iter, &iterKey, nullptr)) {
-				result.Push(iterKey);
-			}
+			GCManager::Maps.Get(self.ItemIndex()).CopyKeysTo(
+				GCManager::Lists.Get(result.ItemIndex()).Items);
 		} else {
 			return IntrinsicResult(ErrorTypes::TypeError("list, string, or map", self));
 		}
@@ -1068,13 +1108,10 @@ void CoreIntrinsics::Init() {
 		Value self = ctx.GetArg(0);
 		if (self.IsError()) return IntrinsicResult(self);
 		Value result = self;
-		Value iterVal;
 		if (self.IsMap()) {
 			result = Value::make_list(self.MapCount());
-			MapIterator iter = self.Iterator();
-			while (map_iterator_next(&iter, nullptr, &iterVal)) {
-				result.Push(iterVal);
-			}
+			GCManager::Maps.Get(self.ItemIndex()).CopyValuesTo(
+				GCManager::Lists.Get(result.ItemIndex()).Items);
 		} else if (self.IsString()) {
 			int slen = self.Length();
 			result = Value::make_list(slen);
@@ -1209,25 +1246,252 @@ void CoreIntrinsics::Init() {
 			vSeconds = ctx.GetArg(0);
 			if (vSeconds.IsError()) return ctx.vm.RaiseUncaughtError(vSeconds);
 			double interval = vSeconds.NumericVal();
+			ctx.vm.wakeTime = now + interval;	// (so the host can sleep till then)
 			return IntrinsicResult(Value(now + interval), Boolean(false));
 		} else {
 			// Continuation: check if we've waited long enough
 			if (now > partialResult.result.NumericVal()) return IntrinsicResult::Null;
+			ctx.vm.wakeTime = partialResult.result.NumericVal();
 			return partialResult;
 		}
 	});
 
-	// yield
+	// yield(value=null)
 	//    Pause execution of the script until the next "tick" of the
 	//    host app.  In Mini Micro, for example, this waits until the
 	//    next 60Hz frame.  If you're doing something in a tight loop,
 	//    calling yield is polite to the host app or other scripts.
+	//    In a coroutine, yield instead stops the coroutine, and the
+	//    resume that ran it returns value; yield then returns the
+	//    value passed to the next resume.
+	// value (default null): what resume returns, in a coroutine
+	// See also: wait, coroutine, resume
 	f = Intrinsic::Create("yield");
+	f.AddParam("value");
 	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		if (ctx.vm.InCoroutine()) return ctx.vm.YieldCoroutine(ctx.GetArg(0));
 		ctx.vm.yielding = Boolean(true);
 		return IntrinsicResult::Null;
 	});
 
+	// coroutine(func)
+	//    Return a new coroutine: a task that runs func in turns with the
+	//    rest of the program.  Nothing runs until it is resumed; then
+	//    func runs until it yields or returns, and resume returns the
+	//    value it yielded or returned.  The next resume carries on from
+	//    where it stopped.  A coroutine costs about as much to make as a
+	//    function call, so a script can keep thousands of them.
+	// func: a function of at most one argument (the first value resumed with)
+	// See also: resume, yield, coroutineStatus
+	f = Intrinsic::Create("coroutine");
+	f.AddParam("func");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value func = ctx.GetArg(0);
+		if (func.IsError()) return ctx.vm.RaiseUncaughtError(func);
+		if (!func.IsFuncRef()) return IntrinsicResult(ErrorTypes::TypeError("function", func));
+		FuncDef def = func.FunctionDef();
+		if (!IsNull(def.NativeCallback())) {
+			return IntrinsicResult(ErrorTypes::RuntimeError(
+				"coroutine: func must be a script function, not an intrinsic (wrap it in one)"));
+		}
+		return IntrinsicResult(VM::MakeCoroutine(func));
+	});
+
+	// resume(co, value=null)
+	//    Run a coroutine until it yields or finishes.  Returns the value
+	//    it yielded, or, when it finishes, its function's result.  value
+	//    becomes the result of the yield it stopped at -- or, the first
+	//    time, the function's first argument.
+	// co: a coroutine, made by `coroutine`
+	// value (default null): the value to hand to the coroutine
+	// See also: coroutine, yield, coroutineStatus
+	f = Intrinsic::Create("resume");
+	f.AddParam("co");
+	f.AddParam("value");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vCo = ctx.GetArg(0);
+		if (vCo.IsError()) return ctx.vm.RaiseUncaughtError(vCo);
+		Coroutine co = VM::GetCoroutine(vCo);
+		if (IsNull(co)) return IntrinsicResult(ErrorTypes::TypeError("coroutine", vCo));
+		return ctx.vm.ResumeCoroutine(co, ctx.GetArg(1), !partialResult.done);
+	});
+
+	// coroutineStatus(co)
+	//    Return the status of a coroutine: "suspended" (not yet started,
+	//    or stopped at a yield), "running" (the one running now),
+	//    "normal" (waiting for a coroutine it resumed), or "dead"
+	//    (finished, or stopped by an error).
+	// co: a coroutine, made by `coroutine`
+	// See also: coroutine, resume
+	f = Intrinsic::Create("coroutineStatus");
+	f.AddParam("co");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vCo = ctx.GetArg(0);
+		Coroutine co = VM::GetCoroutine(vCo);
+		if (IsNull(co)) return IntrinsicResult(ErrorTypes::TypeError("coroutine", vCo));
+		return IntrinsicResult(Value::make_string(co.StatusName()));
+	});
+
+	// channel(name="", capacity=64)
+	//    Return the name of a channel: a queue of values that scripts
+	//    running at the same time, on different threads, can send to
+	//    and receive from.  A channel is known by its name everywhere in
+	//    the process, and is made, with room for `capacity` values, the
+	//    first time its name is used (by this or by send, receive or
+	//    tryReceive).  With no name, makes a new channel.
+	// name (default ""): the channel's name
+	// capacity (default 64): how many values it holds before send waits
+	// See also: send, receive, tryReceive, share
+	f = Intrinsic::Create("channel");
+	f.AddParam("name", Value::make_string(""));
+	f.AddParam("capacity", Value(Channels::DefaultCapacity));
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vName = ctx.GetArg(0);
+		if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+		if (!vName.IsString()) return IntrinsicResult(ErrorTypes::TypeError("string", vName));
+		Value vCapacity = ctx.GetArg(1);
+		if (vCapacity.IsError()) return ctx.vm.RaiseUncaughtError(vCapacity);
+		double capacity;
+		Value e = RequireNumber(vCapacity, &capacity);
+		if (!e.IsNull()) return IntrinsicResult(e);
+		if (capacity < 1 || capacity > Channels::MaxCapacity) {
+			return IntrinsicResult(ErrorTypes::RuntimeError(
+				StringUtils::Format("channel capacity must be from 1 to {0}", Channels::MaxCapacity)));
+		}
+		String name = vName.ToString(nullptr);
+		if (name == "") name = Channels::NewName();
+		Channels::Find(name, (Int32)capacity);
+		return IntrinsicResult(Value::make_string(name));
+	});
+
+	// send(channel, value)
+	//    Put a value on a channel, waiting (without blocking other
+	//    scripts or the host) while the channel is full.  Numbers,
+	//    strings, null and shared values go as they are; a list or map
+	//    is copied, and its copy is frozen if it is.  Functions, errors
+	//    and handles cannot be sent.
+	// channel: name of the channel (see channel)
+	// value: the value to send
+	// See also: receive, share
+	f = Intrinsic::Create("send");
+	f.AddParam("channel");
+	f.AddParam("value");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vName = ctx.GetArg(0);
+		if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+		if (!vName.IsString()) return IntrinsicResult(ErrorTypes::TypeError("string", vName));
+		Value v = ctx.GetArg(1);
+		if (v.IsError()) return ctx.vm.RaiseUncaughtError(v);
+		// (Packed again on each try: the value may have changed meanwhile,
+		// and a message cannot be kept in the partial result.)
+		ChannelMessage msg = ChannelMessage::Pack(v);
+		if (IsNull(msg)) {
+			return IntrinsicResult(ErrorTypes::RuntimeError(
+				"send: value cannot be sent (it is or holds a function, error, handle, or variable map)"));
+		}
+		Channel ch = Channels::Find(vName.ToString(nullptr), Channels::DefaultCapacity);
+		if (ch.TrySend(msg)) return IntrinsicResult::Null;
+		ctx.vm.yielding = Boolean(true);		// full: let the host run something else
+		return IntrinsicResult(Value::Null, Boolean(false));
+	});
+
+	// receive(channel)
+	//    Take the oldest value from a channel, waiting (without blocking
+	//    other scripts or the host) until there is one.
+	// channel: name of the channel (see channel)
+	// See also: send, tryReceive
+	f = Intrinsic::Create("receive");
+	f.AddParam("channel");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vName = ctx.GetArg(0);
+		if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+		if (!vName.IsString()) return IntrinsicResult(ErrorTypes::TypeError("string", vName));
+		Channel ch = Channels::Find(vName.ToString(nullptr), Channels::DefaultCapacity);
+		ChannelMessage msg = ch.TryReceive();
+		if (!IsNull(msg)) return IntrinsicResult(msg.Unpack());
+		ctx.vm.yielding = Boolean(true);		// empty: let the host run something else
+		return IntrinsicResult(Value::Null, Boolean(false));
+	});
+
+	// tryReceive(channel, default=null)
+	//    Take the oldest value from a channel if it has one; otherwise
+	//    return `default` at once.
+	// channel: name of the channel (see channel)
+	// default (default null): what to return if the channel is empty
+	// See also: receive
+	f = Intrinsic::Create("tryReceive");
+	f.AddParam("channel");
+	f.AddParam("default", Value::Null);
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value vName = ctx.GetArg(0);
+		if (vName.IsError()) return ctx.vm.RaiseUncaughtError(vName);
+		if (!vName.IsString()) return IntrinsicResult(ErrorTypes::TypeError("string", vName));
+		Channel ch = Channels::Find(vName.ToString(nullptr), Channels::DefaultCapacity);
+		ChannelMessage msg = ch.TryReceive();
+		if (IsNull(msg)) return IntrinsicResult(ctx.GetArg(1));
+		return IntrinsicResult(msg.Unpack());
+	});
+
+	// share(x)
+	//    Publish a frozen value to the shared heap, and return its
+	//    published form, which every thread can read in place: sending
+	//    it on a channel copies nothing.  Published values are never
+	//    freed, so share data that lasts, not a value per message.
+	// x: the value to publish; a list or map must be frozen
+	// See also: freeze, send
+	f = Intrinsic::Create("share");
+	f.AddParam("x");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		Value v = ctx.GetArg(0);
+		if (v.IsError()) return IntrinsicResult(v);
+		Value shared;
+		if (!SharedHeap::TryPublish(v, &shared)) {
+			if (SharedHeap::Shareable(v)) {
+				return IntrinsicResult(ErrorTypes::RuntimeError("share: the shared heap is full"));
+			}
+			return IntrinsicResult(ErrorTypes::RuntimeError(
+				"share: value must be frozen, and cannot hold a function, error, handle, or variable map"));
+		}
+		return IntrinsicResult(shared);
+	});
+
+	// parallelMap(list, func, chunkSize=null)
+	//    Call func on each item of a list, spreading the calls over
+	//    worker threads, and return a list of the results, in order.
+	//    On a worker, func runs with only its argument: it cannot see
+	//    the caller's globals or local variables, so it must compute
+	//    its result from the item alone.  A func that uses any name
+	//    other than its own variables and intrinsics is an error.
+	// list: the items to call func on
+	// func: a function of one argument
+	// chunkSize (default null): how many items a thread takes at a
+	//    time; null picks a size to suit the number of threads
+	// See also: parallelFilter
+	f = Intrinsic::Create("parallelMap");
+	f.AddParam("list");
+	f.AddParam("func");
+	f.AddParam("chunkSize");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		if (!partialResult.done) return ParallelMap::Continue(ctx, partialResult.result, Boolean(false));
+		return StartParallel(ctx, Boolean(false));
+	});
+
+	// parallelFilter(list, func, chunkSize=null)
+	//    Like parallelMap, but return the items of the list for which
+	//    func returned a true value, in order.
+	// list: the items to test
+	// func: a function of one argument
+	// chunkSize (default null): how many items a thread takes at a time
+	// See also: parallelMap
+	f = Intrinsic::Create("parallelFilter");
+	f.AddParam("list");
+	f.AddParam("func");
+	f.AddParam("chunkSize");
+	f.set_Code([](Context ctx, IntrinsicResult partialResult) -> IntrinsicResult {
+		if (!partialResult.done) return ParallelMap::Continue(ctx, partialResult.result, Boolean(true));
+		return StartParallel(ctx, Boolean(true));
+	});
+
 	// stackTrace
 	//    Return the current call stack as a list of strings, innermost
 	//    (most recent) call first.  Each string has the form
@@ -1443,7 +1707,7 @@ Value CoreIntrinsics::IntrinsicsMap() {
 	}
 	return _intrinsicsMap;
 }
-Value CoreIntrinsics::_intrinsicsMap = Value::Null;
+thread_local Value CoreIntrinsics::_intrinsicsMap;
 Value CoreIntrinsics::GCMap() {
 	if (_gcMap.IsNull()) {
 		_gcMap = Value::make_map(2);
@@ -1453,11 +1717,11 @@ Value CoreIntrinsics::GCMap() {
 	}
 	return _gcMap;
 }
-Value CoreIntrinsics::_gcMap = Value::Null;
-Intrinsic CoreIntrinsics::_gcCollectIntr = nullptr;
-Intrinsic CoreIntrinsics::_gcStatsIntr = nullptr;
-Value CoreIntrinsics::_versionMap = Value::Null;
-List<VoidCallback> CoreIntrinsics::_invalidateCallbacks = nullptr;
+thread_local Value CoreIntrinsics::_gcMap;
+thread_local Intrinsic CoreIntrinsics::_gcCollectIntr;
+thread_local Intrinsic CoreIntrinsics::_gcStatsIntr;
+thread_local Value CoreIntrinsics::_versionMap;
+thread_local List<VoidCallback> CoreIntrinsics::_invalidateCallbacks;
 void CoreIntrinsics::RegisterInvalidateCallback(VoidCallback callback) {
 	if (IsNull(_invalidateCallbacks)) _invalidateCallbacks =  List<VoidCallback>::New();
 	_invalidateCallbacks.Add(callback);
@@ -32,6 +32,9 @@ class CoreIntrinsics {
 	// is the wrong type (not a number or string), or a FormatError when it is a
 	// string that does not parse as a number.  Callers should check/propagate
 	// v.IsError() before calling this.
+	// Check the arguments of parallelMap or parallelFilter, and start it.
+	private: static IntrinsicResult StartParallel(Context ctx, Boolean filter);
+
 	private: static Value RequireNumber(Value v, double* result);
 
 	private: static void AddIntrinsicToMap(Value map, String methodName);
@@ -41,60 +44,63 @@ class CoreIntrinsics {
 	// intrinsic methods that can be invoked on it via dot syntax.
 	// 
 	public: static Value ListType();
-	private: static Value _listType;
+	private: thread_local static Value _listType;
 
 	// 
 	// StringType: a static map that represents the `string` type, and provides
 	// intrinsic methods that can be invoked on it via dot syntax.
 	// 
 	public: static Value StringType();
-	private: static Value _stringType;
+	private: thread_local static Value _stringType;
 
 	// 
 	// MapType: a static map that represents the `map` type, and provides
 	// intrinsic methods that can be invoked on it via dot syntax.
 	// 
 	public: static Value MapType();
-	private: static Value _mapType;
+	private: thread_local static Value _mapType;
 	
 	// 
 	// NumberType: a static map that represents the `number` type.
 	// 
 	public: static Value NumberType();
-	private: static Value _numberType;
+	private: thread_local static Value _numberType;
 
 	// 
 	// FunctionType: a static map that represents the `funcRef` type.
 	// 
 	public: static Value FunctionType();
-	private: static Value _functionType;
+	private: thread_local static Value _functionType;
 
 	// ErrorType: a static map that represents the `error` type, and provides
 	// intrinsic methods that can be invoked on an error via dot syntax
 	// (notably `err` for creating a specialization).
 	public: static Value ErrorType();
-	private: static Value _errorType;
-	private: static Intrinsic _errorErrIntr;
+	private: thread_local static Value _errorType;
+	private: thread_local static Intrinsic _errorErrIntr;
 	private: static Value _EOL;
-	public: static Value replInList;
-	public: static Value replOutList;
+	public: thread_local static Value replInList;
+	public: thread_local static Value replOutList;
 
 	// REPL history lists, set by App.RunREPL at startup and by the reset intrinsic.
 
 	public: static void MarkRoots(object user_data);
 
+	// Define the core intrinsics.  Called once per thread, by Intrinsic.Count
+	// or Intrinsic.RegisterAll: like the GC heap, the intrinsics and every
+	// cached map here are per isolate (see GCManager).
 	public: static void Init();
 
 	public: static Value IntrinsicsMap();
-	private: static Value _intrinsicsMap;
+	private: thread_local static Value _intrinsicsMap;
 
 	public: static Value GCMap();
-	private: static Value _gcMap;
-	private: static Intrinsic _gcCollectIntr;
-	private: static Intrinsic _gcStatsIntr;
-	private: static Value _versionMap;
+	private: thread_local static Value _gcMap;
+	private: thread_local static Intrinsic _gcCollectIntr;
+	private: thread_local static Intrinsic _gcStatsIntr;
+	private: thread_local static Value _versionMap;
 	
-	private: static List<VoidCallback> _invalidateCallbacks;
+	private: thread_local static List<VoidCallback> _invalidateCallbacks;
 
 	public: static void RegisterInvalidateCallback(VoidCallback callback);
 
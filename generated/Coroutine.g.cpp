@@ -0,0 +1,18 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Coroutine.cs
+
+#include "Coroutine.g.h"
+#include "VM.g.h"
+
+namespace MiniScript {
+
+CoroutineStorage::CoroutineStorage() {
+}
+String CoroutineStorage::StatusName() {
+	if (Status == CoroutineStatus::Running) return "running";
+	if (Status == CoroutineStatus::Normal) return "normal";
+	if (Status == CoroutineStatus::Dead) return "dead";
+	return "suspended";
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,211 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Coroutine.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// Coroutine.cs
+// A coroutine: a script function that runs in turns inside one VM.  It can
+// stop partway (yield), handing a value back to whoever resumed it, and
+// later carry on from where it stopped (resume).  Each has registers and a
+// call stack of its own, so switching to it is just swapping those, and the
+// frame state that goes with them, into the VM; the switching itself is
+// done by VM.ResumeCoroutine.
+// The fields hold whichever execution state the VM is not using.  While the
+// coroutine is suspended, that is its own; while it runs, the VM has its
+// state, and these hold the state of whoever resumed it, which goes back
+// into the VM when the coroutine yields or finishes.
+// Scripts see a coroutine as a handle (see VM.MakeCoroutine), whose Marker
+// keeps the Values in a suspended coroutine's registers alive.
+
+#include "FuncDef.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+// How far a coroutine has got.
+enum class CoroutineStatus : Int32 {
+	NotStarted,	// made, but never resumed
+	Suspended,	// stopped at a yield
+	Running,	// the one the VM is running
+	Normal,	// resumed another, and waiting for it
+	Dead	// finished, or stopped by an error
+}; // end of enum CoroutineStatus
+
+class CoroutineStorage : public std::enable_shared_from_this<CoroutineStorage> {
+	friend struct Coroutine;
+	public: CoroutineStatus Status = CoroutineStatus::NotStarted;
+	public: Value Function = Value::Null; // the function it runs
+	public: List<Value> Stack = nullptr;
+	public: List<Value> Names = nullptr;
+	public: List<CallInfo> CallStack = nullptr;
+	public: Int32 CallStackTop = 0;
+	public: Int32 PC = 0;
+	public: Int32 BaseIndex = 0;
+	public: FuncDef CurrentFunction = nullptr;
+	public: Int32 NativeFrameTop = 0;
+	public: Value PendingSelf = Value::Null;
+	public: Value PendingSuper = Value::Null;
+	public: Boolean HasPendingContext = Boolean(false);
+	public: NativeCallbackDelegate PendingCallback = nullptr;
+	public: FuncDef PendingCallee = nullptr;
+	public: Int32 PendingCalleeBase = 0;
+	public: Int32 PendingArgCount = 0;
+	public: Int32 PendingResultIndex = 0;
+	public: Boolean PendingIsManual = Boolean(false);
+	public: Boolean HasPendingManualCall = Boolean(false);
+	public: Int32 PendingManualCallDepth = 0;
+	public: Value ManualCallResult = Value::Null;
+	public: List<PendingCallState> PendingCallStack = nullptr;
+	public: Int32 YieldResultIndex = -1;
+
+	// Registers and call stack: the coroutine's own while it is suspended,
+	// its resumer's while it runs.  Null until first resumed.
+
+	// Frame state that goes with them.
+
+	// Pending intrinsic continuation (see VM._pendingCallback); a coroutine
+	// suspended in a `wait` has one.
+
+	// Where, in Stack, the value passed to the next resume goes: the result
+	// register of the yield it is suspended in.
+
+	public: CoroutineStorage();
+
+	// Status as a script sees it (see the coroutineStatus intrinsic).
+	public: String StatusName();
+}; // end of class CoroutineStorage
+
+struct Coroutine {
+	friend class CoroutineStorage;
+	protected: std::shared_ptr<CoroutineStorage> storage;
+  public:
+	Coroutine(std::shared_ptr<CoroutineStorage> stor) : storage(stor) {}
+	Coroutine() : storage(nullptr) {}
+	Coroutine(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const Coroutine& inst) { return inst.storage == nullptr; }
+	private: CoroutineStorage* get() const;
+
+	public: CoroutineStatus Status();
+	public: void set_Status(CoroutineStatus _v);
+	public: Value Function(); // the function it runs
+	public: void set_Function(Value _v); // the function it runs
+	public: List<Value> Stack();
+	public: void set_Stack(List<Value> _v);
+	public: List<Value> Names();
+	public: void set_Names(List<Value> _v);
+	public: List<CallInfo> CallStack();
+	public: void set_CallStack(List<CallInfo> _v);
+	public: Int32 CallStackTop();
+	public: void set_CallStackTop(Int32 _v);
+	public: Int32 PC();
+	public: void set_PC(Int32 _v);
+	public: Int32 BaseIndex();
+	public: void set_BaseIndex(Int32 _v);
+	public: FuncDef CurrentFunction();
+	public: void set_CurrentFunction(FuncDef _v);
+	public: Int32 NativeFrameTop();
+	public: void set_NativeFrameTop(Int32 _v);
+	public: Value PendingSelf();
+	public: void set_PendingSelf(Value _v);
+	public: Value PendingSuper();
+	public: void set_PendingSuper(Value _v);
+	public: Boolean HasPendingContext();
+	public: void set_HasPendingContext(Boolean _v);
+	public: NativeCallbackDelegate PendingCallback();
+	public: void set_PendingCallback(NativeCallbackDelegate _v);
+	public: FuncDef PendingCallee();
+	public: void set_PendingCallee(FuncDef _v);
+	public: Int32 PendingCalleeBase();
+	public: void set_PendingCalleeBase(Int32 _v);
+	public: Int32 PendingArgCount();
+	public: void set_PendingArgCount(Int32 _v);
+	public: Int32 PendingResultIndex();
+	public: void set_PendingResultIndex(Int32 _v);
+	public: Boolean PendingIsManual();
+	public: void set_PendingIsManual(Boolean _v);
+	public: Boolean HasPendingManualCall();
+	public: void set_HasPendingManualCall(Boolean _v);
+	public: Int32 PendingManualCallDepth();
+	public: void set_PendingManualCallDepth(Int32 _v);
+	public: Value ManualCallResult();
+	public: void set_ManualCallResult(Value _v);
+	public: List<PendingCallState> PendingCallStack();
+	public: void set_PendingCallStack(List<PendingCallState> _v);
+	public: Int32 YieldResultIndex();
+	public: void set_YieldResultIndex(Int32 _v);
+
+	// Registers and call stack: the coroutine's own while it is suspended,
+	// its resumer's while it runs.  Null until first resumed.
+
+	// Frame state that goes with them.
+
+	// Pending intrinsic continuation (see VM._pendingCallback); a coroutine
+	// suspended in a `wait` has one.
+
+	// Where, in Stack, the value passed to the next resume goes: the result
+	// register of the yield it is suspended in.
+
+	public: static Coroutine New() {
+		return Coroutine(std::make_shared<CoroutineStorage>());
+	}
+
+	// Status as a script sees it (see the coroutineStatus intrinsic).
+	public: inline String StatusName();
+}; // end of struct Coroutine
+
+// INLINE METHODS
+
+inline CoroutineStorage* Coroutine::get() const { return static_cast<CoroutineStorage*>(storage.get()); }
+inline CoroutineStatus Coroutine::Status() { return get()->Status; }
+inline void Coroutine::set_Status(CoroutineStatus _v) { get()->Status = _v; }
+inline Value Coroutine::Function() { return get()->Function; } // the function it runs
+inline void Coroutine::set_Function(Value _v) { get()->Function = _v; } // the function it runs
+inline List<Value> Coroutine::Stack() { return get()->Stack; }
+inline void Coroutine::set_Stack(List<Value> _v) { get()->Stack = _v; }
+inline List<Value> Coroutine::Names() { return get()->Names; }
+inline void Coroutine::set_Names(List<Value> _v) { get()->Names = _v; }
+inline List<CallInfo> Coroutine::CallStack() { return get()->CallStack; }
+inline void Coroutine::set_CallStack(List<CallInfo> _v) { get()->CallStack = _v; }
+inline Int32 Coroutine::CallStackTop() { return get()->CallStackTop; }
+inline void Coroutine::set_CallStackTop(Int32 _v) { get()->CallStackTop = _v; }
+inline Int32 Coroutine::PC() { return get()->PC; }
+inline void Coroutine::set_PC(Int32 _v) { get()->PC = _v; }
+inline Int32 Coroutine::BaseIndex() { return get()->BaseIndex; }
+inline void Coroutine::set_BaseIndex(Int32 _v) { get()->BaseIndex = _v; }
+inline FuncDef Coroutine::CurrentFunction() { return get()->CurrentFunction; }
+inline void Coroutine::set_CurrentFunction(FuncDef _v) { get()->CurrentFunction = _v; }
+inline Int32 Coroutine::NativeFrameTop() { return get()->NativeFrameTop; }
+inline void Coroutine::set_NativeFrameTop(Int32 _v) { get()->NativeFrameTop = _v; }
+inline Value Coroutine::PendingSelf() { return get()->PendingSelf; }
+inline void Coroutine::set_PendingSelf(Value _v) { get()->PendingSelf = _v; }
+inline Value Coroutine::PendingSuper() { return get()->PendingSuper; }
+inline void Coroutine::set_PendingSuper(Value _v) { get()->PendingSuper = _v; }
+inline Boolean Coroutine::HasPendingContext() { return get()->HasPendingContext; }
+inline void Coroutine::set_HasPendingContext(Boolean _v) { get()->HasPendingContext = _v; }
+inline NativeCallbackDelegate Coroutine::PendingCallback() { return get()->PendingCallback; }
+inline void Coroutine::set_PendingCallback(NativeCallbackDelegate _v) { get()->PendingCallback = _v; }
+inline FuncDef Coroutine::PendingCallee() { return get()->PendingCallee; }
+inline void Coroutine::set_PendingCallee(FuncDef _v) { get()->PendingCallee = _v; }
+inline Int32 Coroutine::PendingCalleeBase() { return get()->PendingCalleeBase; }
+inline void Coroutine::set_PendingCalleeBase(Int32 _v) { get()->PendingCalleeBase = _v; }
+inline Int32 Coroutine::PendingArgCount() { return get()->PendingArgCount; }
+inline void Coroutine::set_PendingArgCount(Int32 _v) { get()->PendingArgCount = _v; }
+inline Int32 Coroutine::PendingResultIndex() { return get()->PendingResultIndex; }
+inline void Coroutine::set_PendingResultIndex(Int32 _v) { get()->PendingResultIndex = _v; }
+inline Boolean Coroutine::PendingIsManual() { return get()->PendingIsManual; }
+inline void Coroutine::set_PendingIsManual(Boolean _v) { get()->PendingIsManual = _v; }
+inline Boolean Coroutine::HasPendingManualCall() { return get()->HasPendingManualCall; }
+inline void Coroutine::set_HasPendingManualCall(Boolean _v) { get()->HasPendingManualCall = _v; }
+inline Int32 Coroutine::PendingManualCallDepth() { return get()->PendingManualCallDepth; }
+inline void Coroutine::set_PendingManualCallDepth(Int32 _v) { get()->PendingManualCallDepth = _v; }
+inline Value Coroutine::ManualCallResult() { return get()->ManualCallResult; }
+inline void Coroutine::set_ManualCallResult(Value _v) { get()->ManualCallResult = _v; }
+inline List<PendingCallState> Coroutine::PendingCallStack() { return get()->PendingCallStack; }
+inline void Coroutine::set_PendingCallStack(List<PendingCallState> _v) { get()->PendingCallStack = _v; }
+inline Int32 Coroutine::YieldResultIndex() { return get()->YieldResultIndex; }
+inline void Coroutine::set_YieldResultIndex(Int32 _v) { get()->YieldResultIndex = _v; }
+inline String Coroutine::StatusName() { return get()->StatusName(); }
+
+} // end of namespace MiniScript
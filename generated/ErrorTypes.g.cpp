@@ -7,29 +7,24 @@
 
 namespace MiniScript {
 
-Value ErrorTypes::compiler = Value::Null;
-Value ErrorTypes::runtime = Value::Null;
-bool ErrorTypes::_markRootsRegistered = Boolean(false);
+thread_local Value ErrorTypes::compiler;
+thread_local Value ErrorTypes::runtime;
+thread_local bool ErrorTypes::_initialized;
 void ErrorTypes::Init() {
-	if (!_markRootsRegistered) {
-		GCManager::RegisterMarkCallback(ErrorTypes::MarkRoots, nullptr);
-		_markRootsRegistered = Boolean(true);
-	}
-	if (compiler.IsNull()) {
-		compiler = Value::make_error(Value::make_string("Compiler Error"), Value::Null, Value::Null, Value::Null);
-		compiler.Freeze();
-	}
-	if (runtime.IsNull()) {
-		runtime = Value::make_error(Value::make_string("Runtime Error"), Value::Null, Value::Null, Value::Null);
-		runtime.Freeze();
-	}
+	if (_initialized) return;
+	_initialized = Boolean(true);
+	GCManager::RegisterMarkCallback(ErrorTypes::MarkRoots, nullptr);
+	compiler = Value::make_error(Value::make_string("Compiler Error"), Value::Null, Value::Null, Value::Null);
+	compiler.Freeze();
+	runtime = Value::make_error(Value::make_string("Runtime Error"), Value::Null, Value::Null, Value::Null);
+	runtime.Freeze();
 }
 Value ErrorTypes::CompilerError(String msg) {
-	if (compiler.IsNull()) Init();
+	if (!_initialized) Init();
 	return Value::make_error(Value::make_string(msg), Value::Null, Value::Null, compiler);
 }
 Value ErrorTypes::CompilerError(String msg,String fileName,Int32 lineNum) {
-	if (compiler.IsNull()) Init();
+	if (!_initialized) Init();
 	String file = fileName;
 	if (file == "") file = "(current program)";
 	Value stack = Value::make_list(1);
@@ -38,15 +33,15 @@ Value ErrorTypes::CompilerError(String msg,String fileName,Int32 lineNum) {
 	return Value::make_error(Value::make_string(msg), Value::Null, stack, compiler);
 }
 Value ErrorTypes::CompilerError(String msg,Value inner) {
-	if (compiler.IsNull()) Init();
+	if (!_initialized) Init();
 	return Value::make_error(Value::make_string(msg), inner, Value::value_current_stack_trace(), compiler);
 }
 Value ErrorTypes::RuntimeError(String msg,Value stack) {
-	if (runtime.IsNull()) Init();
+	if (!_initialized) Init();
 	return Value::make_error(Value::make_string(msg), Value::Null, stack, runtime);
 }
 Value ErrorTypes::RuntimeError(String msg) {
-	if (runtime.IsNull()) Init();
+	if (!_initialized) Init();
 	return Value::make_error(Value::make_string(msg), Value::Null, Value::value_current_stack_trace(), runtime);
 }
 Value ErrorTypes::FileError(String msg) {
@@ -17,13 +17,18 @@ namespace MiniScript {
 // DECLARATIONS
 
 class ErrorTypes {
-	public: static Value compiler;
-	public: static Value runtime;
-	private: static bool _markRootsRegistered;
+	public: thread_local static Value compiler;
+	public: thread_local static Value runtime;
+	private: thread_local static bool _initialized;
+
+	// Whether compiler and runtime are set up on this thread.  (A flag rather
+	// than a null check: a thread-static Value starts out as 0, not null, in C#.)
 
 	// Initialize the compiler and runtime prototype error values.
 	// Safe to call multiple times (no-op if already initialized).
 	// Must be called after gc_init() in C++; in C# this is called lazily.
+	// Like the GC heap they live in, these are per thread (see GCManager):
+	// each isolate makes its own.
 	public: static void Init();
 
 	// Create a compiler error value with the given message.  Carries no stack
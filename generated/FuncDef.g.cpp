@@ -4,6 +4,7 @@
 #include "FuncDef.g.h"
 #include "StringUtils.g.h"
 #include "IntrinsicAPI.g.h"
+#include "BytecodeCache.g.h"
 
 namespace MiniScript {
 
@@ -13,6 +14,7 @@ Int32 FuncDefStorage::AddGlobalRef(Value name) {
 	}
 	GlobalNames.Add(name);
 	GlobalSlots.Add(-1);
+	GlobalIntrinsics.Add(Value::Null);
 	return GlobalNames.Count() - 1;
 }
 void FuncDefStorage::AddInstruction(UInt32 instruction,Int32 lineNumber) {
@@ -31,12 +33,71 @@ Int32 FuncDefStorage::GetLineNumber(Int32 pc) {
 	}
 	return result;
 }
+Int32 FuncDefStorage::LineRunCount() {
+	return _lineRLEPC.Count();
+}
+Int32 FuncDefStorage::LineRunPC(Int32 i) {
+	return _lineRLEPC[i];
+}
+Int32 FuncDefStorage::LineRunLine(Int32 i) {
+	return _lineRLELine[i];
+}
+void FuncDefStorage::AddLineRun(Int32 pc,Int32 lineNumber) {
+	_lineRLEPC.Add(pc);
+	_lineRLELine.Add(lineNumber);
+}
+void FuncDefStorage::AddInlineRange(Int32 startPC,Int32 endPC,Int32 callLine) {
+	_inlineStartPC.Add(startPC);
+	_inlineEndPC.Add(endPC);
+	_inlineCallLine.Add(callLine);
+}
+Int32 FuncDefStorage::InlineRangeCount() {
+	return _inlineStartPC.Count();
+}
+Int32 FuncDefStorage::InlineRangeStart(Int32 i) {
+	return _inlineStartPC[i];
+}
+Int32 FuncDefStorage::InlineRangeEnd(Int32 i) {
+	return _inlineEndPC[i];
+}
+Int32 FuncDefStorage::InlineRangeCallLine(Int32 i) {
+	return _inlineCallLine[i];
+}
+Int32 FuncDefStorage::GetInlineCallLine(Int32 pc) {
+	for (Int32 i = 0; i < _inlineStartPC.Count(); i++) {
+		if (pc >= _inlineStartPC[i] && pc < _inlineEndPC[i]) return _inlineCallLine[i];
+	}
+	return 0;
+}
+void FuncDefStorage::EnsureConstants() {
+	FuncDef _this(std::static_pointer_cast<FuncDefStorage>(shared_from_this()));
+	if (LazyConstantsPos >= 0) BytecodeCache::DecodeConstants(_this);
+}
 FuncDefStorage::FuncDefStorage() {
 }
 void FuncDefStorage::ReserveRegister(Int32 registerNumber) {
 	UInt16 impliedCount = (UInt16)(registerNumber + 1);
 	if (MaxRegs < impliedCount) MaxRegs = impliedCount;
 }
+FuncDef FuncDefStorage::CopyForIsolate() {
+	FuncDef copy =  FuncDef::New();
+	copy.set_Name(Name);
+	copy.set_Code(Code);
+	copy.get_storage()->BorrowedCode = BorrowedCode;
+	copy.get_storage()->BorrowedCount = BorrowedCount;
+	copy.set_MaxRegs(MaxRegs);
+	copy.set_SelfReg(SelfReg);
+	copy.set_SuperReg(SuperReg);
+	copy.set_Note(Note);
+	copy.set_SourceLoc(SourceLoc);
+	copy.set_FileName(FileName);
+	copy.set__lineRLEPC(_lineRLEPC);
+	copy.set__lineRLELine(_lineRLELine);
+	copy.set__inlineStartPC(_inlineStartPC);
+	copy.set__inlineEndPC(_inlineEndPC);
+	copy.set__inlineCallLine(_inlineCallLine);
+	return copy;
+}
 String FuncDefStorage::ToString() {
 	String result = Name + "(";
 	Value defaultVal;
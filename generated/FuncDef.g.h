@@ -5,12 +5,15 @@
 #include "core_includes.h"
 #include "forward_decs.g.h"
 #include "value.h"
+#include "BinaryIO.g.h"
 
 namespace MiniScript {
 struct Context;  // forward declaration; defined in VM.g.h
 struct IntrinsicResult;  // forward declaration
 typedef IntrinsicResult (*NativeCallbackDelegate)(Context, IntrinsicResult);
 inline bool IsNull(NativeCallbackDelegate f) { return f == nullptr; }
+typedef Value (*SimpleCallbackDelegate)(Value* args, Int32 argCount);
+inline bool IsNull(SimpleCallbackDelegate f) { return f == nullptr; }
 
 // DECLARATIONS
 
@@ -29,6 +32,7 @@ class FuncDefStorage : public std::enable_shared_from_this<FuncDefStorage> {
 	public: String FileName = "";
 	public: List<Value> GlobalNames = List<Value>::New();
 	public: List<Int32> GlobalSlots = List<Int32>::New();
+	public: List<Value> GlobalIntrinsics = List<Value>::New();
 	public: Int32 GlobalCacheId = 0;
 
 	// ── Global-reference table ────────────────────────────────────────────────
@@ -41,6 +45,14 @@ class FuncDefStorage : public std::enable_shared_from_this<FuncDefStorage> {
 	// namespace than the one it was compiled alongside, which is what makes
 	// cross-interpreter seeding work.
 	// Id 0 is never issued (Globals pre-increments), so 0 means "never resolved".
+	// GlobalIntrinsics remembers, per reference, the intrinsic a name resolved to
+	// when its slot turned out to be unassigned (see VM.GlobalMiss), so a loop
+	// calling `len` or `sqrt` looks the name up once rather than on every
+	// iteration.  The intrinsic table is per thread, so what is cached is this
+	// thread's funcref (a permanent GC root of its heap); that holds because a
+	// FuncDef never crosses isolates -- IsolateFunction sends a copy, whose
+	// cache starts empty.  The slot is still checked first on every access,
+	// so a global that shadows the intrinsic later is seen at once.
 
 	// Intern a name into the global-reference table, returning its index.  Used
 	// by the code generator and the assembler while building this function.
@@ -60,16 +72,77 @@ class FuncDefStorage : public std::enable_shared_from_this<FuncDefStorage> {
 	// Return the source line number for the instruction at the given PC index.
 	// Returns 0 if no line information is available.
 	public: Int32 GetLineNumber(Int32 pc);
+
+	// Raw access to the line table, for BytecodeCache to save and restore it:
+	// the number of runs, each run's first PC and line, and appending a run.
+	public: Int32 LineRunCount();
+	public: Int32 LineRunPC(Int32 i);
+	public: Int32 LineRunLine(Int32 i);
+	public: void AddLineRun(Int32 pc, Int32 lineNumber);
+	private: List<Int32> _inlineStartPC = List<Int32>::New();
+	private: List<Int32> _inlineEndPC = List<Int32>::New();
+	private: List<Int32> _inlineCallLine = List<Int32>::New();
+
+	// Inlined calls: the code generator may compile a small function's body
+	// straight into its caller (see CodeGenerator.EmitInlinedCall).  Each entry
+	// records the PC range [start, end) of one inlined body and the line of the
+	// call it replaced, so a stack trace can still show the call.  The lines
+	// within the range are the callee's own, from the line table as usual.
+
+	public: void AddInlineRange(Int32 startPC, Int32 endPC, Int32 callLine);
+	public: Int32 InlineRangeCount();
+	public: Int32 InlineRangeStart(Int32 i);
+	public: Int32 InlineRangeEnd(Int32 i);
+	public: Int32 InlineRangeCallLine(Int32 i);
+
+	// Return the line of the inlined call whose body contains the given PC, or
+	// 0 if the PC is not in an inlined body.  Inlined bodies contain no calls,
+	// so they never nest.
+	public: Int32 GetInlineCallLine(Int32 pc);
+	public: ByteReader CacheSource = nullptr;
+	public: Int32 LazyConstantsPos = -1;
+	public: List<FuncDef> LazyChildren = nullptr;
+	public: const UInt32* BorrowedCode = nullptr;
+	public: Int32 BorrowedCount = 0;
+
+	// ── Loading from the bytecode cache ──────────────────────────────────────
+	// A FuncDef loaded by BytecodeCache does not decode its constant pool until
+	// it is first needed: until then LazyConstantsPos is the position of the
+	// encoded pool in CacheSource, and LazyChildren holds the functions that
+	// the pool's templates refer to.  Call EnsureConstants before reading
+	// Constants of a function that may have come from the cache (the VM does so
+	// on entering a function).  In C++, the code itself may be left in place in
+	// the mapped cache file (BorrowedCode), so read it through CodeCount and
+	// CodeAt rather than Code.
+
+	public: Int32 CodeCount();
+
+	public: UInt32 CodeAt(Int32 pc);
+
+	public: void EnsureConstants();
 	public: NativeCallbackDelegate NativeCallback = nullptr;
+	public: SimpleCallbackDelegate SimpleCallback = nullptr;
 
 	// Native callback for intrinsic functions. When non-null, this FuncDef
 	// represents a built-in function: CALL invokes the callback directly
 	// instead of executing bytecode.  Parameters are in stack[baseIndex+1..].
 
+	// Set, as well as NativeCallback, for a simple intrinsic: the VM calls
+	// this instead, without making a Context or IntrinsicResult.
+
 	public: FuncDefStorage();
 
 	public: void ReserveRegister(Int32 registerNumber);
 
+	// A copy of this function for another isolate to run (see ParallelMap).
+	// The code and the line and inline tables are shared, since nothing
+	// changes them once the function is built.  Everything made of Values --
+	// constants, parameters, global names -- belongs to this isolate's heap,
+	// so the copy starts with those empty, for the caller to fill from the
+	// other one's; and it gets a global-reference cache of its own.  Call
+	// EnsureConstants first if the function may have come from the cache.
+	public: FuncDef CopyForIsolate();
+
 	// Returns a string like "functionName(a, b=1, c=0)"
 	public: String ToString();
 
@@ -80,6 +153,10 @@ class FuncDefStorage : public std::enable_shared_from_this<FuncDefStorage> {
 
 // Native callback for intrinsic functions.
 
+// Simple native callback: a lighter kind of intrinsic, for one that always
+// finishes at once.  It gets its argument registers in place (one per
+// declared parameter, defaults filled in) and returns its result directly.
+
 // Function definition: code, constants, and how many registers it needs
 struct FuncDef {
 	friend class FuncDefStorage;
@@ -117,6 +194,8 @@ struct FuncDef {
 	public: void set_GlobalNames(List<Value> _v);
 	public: List<Int32> GlobalSlots();
 	public: void set_GlobalSlots(List<Int32> _v);
+	public: List<Value> GlobalIntrinsics();
+	public: void set_GlobalIntrinsics(List<Value> _v);
 	public: Int32 GlobalCacheId();
 	public: void set_GlobalCacheId(Int32 _v);
 
@@ -130,6 +209,14 @@ struct FuncDef {
 	// namespace than the one it was compiled alongside, which is what makes
 	// cross-interpreter seeding work.
 	// Id 0 is never issued (Globals pre-increments), so 0 means "never resolved".
+	// GlobalIntrinsics remembers, per reference, the intrinsic a name resolved to
+	// when its slot turned out to be unassigned (see VM.GlobalMiss), so a loop
+	// calling `len` or `sqrt` looks the name up once rather than on every
+	// iteration.  The intrinsic table is per thread, so what is cached is this
+	// thread's funcref (a permanent GC root of its heap); that holds because a
+	// FuncDef never crosses isolates -- IsolateFunction sends a copy, whose
+	// cache starts empty.  The slot is still checked first on every access,
+	// so a global that shadows the intrinsic later is seen at once.
 
 	// Intern a name into the global-reference table, returning its index.  Used
 	// by the code generator and the assembler while building this function.
@@ -151,19 +238,85 @@ struct FuncDef {
 	// Return the source line number for the instruction at the given PC index.
 	// Returns 0 if no line information is available.
 	public: inline Int32 GetLineNumber(Int32 pc);
+
+	// Raw access to the line table, for BytecodeCache to save and restore it:
+	// the number of runs, each run's first PC and line, and appending a run.
+	public: inline Int32 LineRunCount();
+	public: inline Int32 LineRunPC(Int32 i);
+	public: inline Int32 LineRunLine(Int32 i);
+	public: inline void AddLineRun(Int32 pc, Int32 lineNumber);
+	private: List<Int32> _inlineStartPC();
+	private: void set__inlineStartPC(List<Int32> _v);
+	private: List<Int32> _inlineEndPC();
+	private: void set__inlineEndPC(List<Int32> _v);
+	private: List<Int32> _inlineCallLine();
+	private: void set__inlineCallLine(List<Int32> _v);
+
+	// Inlined calls: the code generator may compile a small function's body
+	// straight into its caller (see CodeGenerator.EmitInlinedCall).  Each entry
+	// records the PC range [start, end) of one inlined body and the line of the
+	// call it replaced, so a stack trace can still show the call.  The lines
+	// within the range are the callee's own, from the line table as usual.
+
+	public: inline void AddInlineRange(Int32 startPC, Int32 endPC, Int32 callLine);
+	public: inline Int32 InlineRangeCount();
+	public: inline Int32 InlineRangeStart(Int32 i);
+	public: inline Int32 InlineRangeEnd(Int32 i);
+	public: inline Int32 InlineRangeCallLine(Int32 i);
+
+	// Return the line of the inlined call whose body contains the given PC, or
+	// 0 if the PC is not in an inlined body.  Inlined bodies contain no calls,
+	// so they never nest.
+	public: inline Int32 GetInlineCallLine(Int32 pc);
+	public: ByteReader CacheSource();
+	public: void set_CacheSource(ByteReader _v);
+	public: Int32 LazyConstantsPos();
+	public: void set_LazyConstantsPos(Int32 _v);
+	public: List<FuncDef> LazyChildren();
+	public: void set_LazyChildren(List<FuncDef> _v);
+
+	// ── Loading from the bytecode cache ──────────────────────────────────────
+	// A FuncDef loaded by BytecodeCache does not decode its constant pool until
+	// it is first needed: until then LazyConstantsPos is the position of the
+	// encoded pool in CacheSource, and LazyChildren holds the functions that
+	// the pool's templates refer to.  Call EnsureConstants before reading
+	// Constants of a function that may have come from the cache (the VM does so
+	// on entering a function).  In C++, the code itself may be left in place in
+	// the mapped cache file (BorrowedCode), so read it through CodeCount and
+	// CodeAt rather than Code.
+
+	public: inline Int32 CodeCount();
+
+	public: inline UInt32 CodeAt(Int32 pc);
+
+	public: inline void EnsureConstants();
 	public: NativeCallbackDelegate NativeCallback();
 	public: void set_NativeCallback(NativeCallbackDelegate _v);
+	public: SimpleCallbackDelegate SimpleCallback();
+	public: void set_SimpleCallback(SimpleCallbackDelegate _v);
 
 	// Native callback for intrinsic functions. When non-null, this FuncDef
 	// represents a built-in function: CALL invokes the callback directly
 	// instead of executing bytecode.  Parameters are in stack[baseIndex+1..].
 
+	// Set, as well as NativeCallback, for a simple intrinsic: the VM calls
+	// this instead, without making a Context or IntrinsicResult.
+
 	public: static FuncDef New() {
 		return FuncDef(std::make_shared<FuncDefStorage>());
 	}
 
 	public: inline void ReserveRegister(Int32 registerNumber);
 
+	// A copy of this function for another isolate to run (see ParallelMap).
+	// The code and the line and inline tables are shared, since nothing
+	// changes them once the function is built.  Everything made of Values --
+	// constants, parameters, global names -- belongs to this isolate's heap,
+	// so the copy starts with those empty, for the caller to fill from the
+	// other one's; and it gets a global-reference cache of its own.  Call
+	// EnsureConstants first if the function may have come from the cache.
+	public: inline FuncDef CopyForIsolate();
+
 	// Returns a string like "functionName(a, b=1, c=0)"
 	public: String ToString() { return get()->ToString(); }
 
@@ -201,6 +354,8 @@ inline List<Value> FuncDef::GlobalNames() { return get()->GlobalNames; }
 inline void FuncDef::set_GlobalNames(List<Value> _v) { get()->GlobalNames = _v; }
 inline List<Int32> FuncDef::GlobalSlots() { return get()->GlobalSlots; }
 inline void FuncDef::set_GlobalSlots(List<Int32> _v) { get()->GlobalSlots = _v; }
+inline List<Value> FuncDef::GlobalIntrinsics() { return get()->GlobalIntrinsics; }
+inline void FuncDef::set_GlobalIntrinsics(List<Value> _v) { get()->GlobalIntrinsics = _v; }
 inline Int32 FuncDef::GlobalCacheId() { return get()->GlobalCacheId; }
 inline void FuncDef::set_GlobalCacheId(Int32 _v) { get()->GlobalCacheId = _v; }
 inline Int32 FuncDef::AddGlobalRef(Value name) { return get()->AddGlobalRef(name); }
@@ -210,9 +365,43 @@ inline List<Int32> FuncDef::_lineRLELine() { return get()->_lineRLELine; }
 inline void FuncDef::set__lineRLELine(List<Int32> _v) { get()->_lineRLELine = _v; }
 inline void FuncDef::AddInstruction(UInt32 instruction,Int32 lineNumber) { return get()->AddInstruction(instruction, lineNumber); }
 inline Int32 FuncDef::GetLineNumber(Int32 pc) { return get()->GetLineNumber(pc); }
+inline Int32 FuncDef::LineRunCount() { return get()->LineRunCount(); }
+inline Int32 FuncDef::LineRunPC(Int32 i) { return get()->LineRunPC(i); }
+inline Int32 FuncDef::LineRunLine(Int32 i) { return get()->LineRunLine(i); }
+inline void FuncDef::AddLineRun(Int32 pc,Int32 lineNumber) { return get()->AddLineRun(pc, lineNumber); }
+inline List<Int32> FuncDef::_inlineStartPC() { return get()->_inlineStartPC; }
+inline void FuncDef::set__inlineStartPC(List<Int32> _v) { get()->_inlineStartPC = _v; }
+inline List<Int32> FuncDef::_inlineEndPC() { return get()->_inlineEndPC; }
+inline void FuncDef::set__inlineEndPC(List<Int32> _v) { get()->_inlineEndPC = _v; }
+inline List<Int32> FuncDef::_inlineCallLine() { return get()->_inlineCallLine; }
+inline void FuncDef::set__inlineCallLine(List<Int32> _v) { get()->_inlineCallLine = _v; }
+inline void FuncDef::AddInlineRange(Int32 startPC,Int32 endPC,Int32 callLine) { return get()->AddInlineRange(startPC, endPC, callLine); }
+inline Int32 FuncDef::InlineRangeCount() { return get()->InlineRangeCount(); }
+inline Int32 FuncDef::InlineRangeStart(Int32 i) { return get()->InlineRangeStart(i); }
+inline Int32 FuncDef::InlineRangeEnd(Int32 i) { return get()->InlineRangeEnd(i); }
+inline Int32 FuncDef::InlineRangeCallLine(Int32 i) { return get()->InlineRangeCallLine(i); }
+inline Int32 FuncDef::GetInlineCallLine(Int32 pc) { return get()->GetInlineCallLine(pc); }
+inline ByteReader FuncDef::CacheSource() { return get()->CacheSource; }
+inline void FuncDef::set_CacheSource(ByteReader _v) { get()->CacheSource = _v; }
+inline Int32 FuncDef::LazyConstantsPos() { return get()->LazyConstantsPos; }
+inline void FuncDef::set_LazyConstantsPos(Int32 _v) { get()->LazyConstantsPos = _v; }
+inline List<FuncDef> FuncDef::LazyChildren() { return get()->LazyChildren; }
+inline void FuncDef::set_LazyChildren(List<FuncDef> _v) { get()->LazyChildren = _v; }
+inline Int32 FuncDef::CodeCount() { return get()->CodeCount(); }
+inline Int32 FuncDefStorage::CodeCount() {
+	return BorrowedCode ? BorrowedCount : Code.Count();
+}
+inline UInt32 FuncDef::CodeAt(Int32 pc) { return get()->CodeAt(pc); }
+inline UInt32 FuncDefStorage::CodeAt(Int32 pc) {
+	return BorrowedCode ? BorrowedCode[pc] : Code[pc];
+}
+inline void FuncDef::EnsureConstants() { return get()->EnsureConstants(); }
 inline NativeCallbackDelegate FuncDef::NativeCallback() { return get()->NativeCallback; }
 inline void FuncDef::set_NativeCallback(NativeCallbackDelegate _v) { get()->NativeCallback = _v; }
+inline SimpleCallbackDelegate FuncDef::SimpleCallback() { return get()->SimpleCallback; }
+inline void FuncDef::set_SimpleCallback(SimpleCallbackDelegate _v) { get()->SimpleCallback = _v; }
 inline void FuncDef::ReserveRegister(Int32 registerNumber) { return get()->ReserveRegister(registerNumber); }
+inline FuncDef FuncDef::CopyForIsolate() { return get()->CopyForIsolate(); }
 inline FuncDefStorage::operator bool() const {
 	return Name != "";
 }
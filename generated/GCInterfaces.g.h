@@ -8,11 +8,15 @@
 namespace MiniScript {
 typedef void (*HandleFinalizer)(void* userData);
 inline bool IsNull(HandleFinalizer f) { return f == nullptr; }
+typedef void (*HandleMarker)(void* userData);
 
 // DECLARATIONS
 
 // Callback invoked when a GCHandle is swept (its referent has no more live references).
 
+// Callback invoked during the Mark phase for a GCHandle whose native object
+// holds Values of its own; it must GCManager.Mark each of them.
+
 // Interface for items managed by a GCSet.
 // Must be implemented by every GC-managed struct type.
 class IGCItem {
@@ -20,6 +20,7 @@ void GCList::InitComputed(Value baseVal,Value increment,Int32 length) {
 	Items.Add(Value(length));
 	Frozen   = Boolean(false);
 	Computed = Boolean(true);
+	HashCache = 0;
 }
 void GCList::Materialize() {
 	if (!Computed) return;
@@ -83,12 +84,14 @@ void GCMap::Init(Int32 capacity ) {
 	Frozen = Boolean(false);
 	_vmb   = nullptr;
 	_gb    = nullptr;
+	HashCache = 0;
 }
 void GCMap::InitAsGlobals(Globals g) {
 	Items  = nullptr;
 	Frozen = Boolean(false);
 	_vmb   = nullptr;
 	_gb    = g;
+	HashCache = 0;
 }
 Boolean GCMap::TryGet(Value key,Value* value) {
 	if (!IsNull(_gb)) return _gb.TryGet(key, &*value);
@@ -102,11 +105,18 @@ Boolean GCMap::TryGet(Value key,Value* value) {
 	return Boolean(false);
 }
 void GCMap::Set(Value key,Value value) {
+	// A short string key is interned (GCManager.Intern), so that looking it
+	// up with a literal or identifier matches by bits alone.
+	key = GCManager::Intern(key);
 	if (!IsNull(_gb)) { _gb.Set(key, value); return; }
 
 	// Store in register if VarMap-backed and key is register-mapped.
 	if (!IsNull(_vmb) && _vmb.TrySet(key, value)) return;
 
+	// A list or map key is stored as a frozen copy (notes/FROZEN_VALUES.md),
+	// so later changes to the caller's container cannot invalidate its hash.
+	if (key.IsList() || key.IsMap()) key = key.FrozenCopy();
+
 	if (IsNull(Items)) Init();
 	Items[key] = value;
 }
@@ -146,12 +156,7 @@ Value GCMap::KeyAt(Int32 i) {
 		return _vmb.GetRegEntryKey(regIdx);
 	}
 	if (IsNull(Items)) return Value::Null;
-	Int32 j = 0;
-	for (Value k : Items.Keys()) {
-		if (j == i) return k;
-		j++;
-	}
-	return Value::Null;
+	return Items.KeyAtPosition(i);
 }
 Value GCMap::ValueAt(Int32 i) {
 	if (!IsNull(_gb)) return _gb.ValueAtSlot(i);
@@ -160,12 +165,46 @@ Value GCMap::ValueAt(Int32 i) {
 		return _vmb.GetRegEntryValue(regIdx);
 	}
 	if (IsNull(Items)) return Value::Null;
-	Int32 j = 0;
+	return Items.ValueAtPosition(i);
+}
+void GCMap::CopyKeysTo(List<Value> dst) {
+	if (!IsNull(_gb) || !IsNull(_vmb)) {
+		for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) dst.Add(KeyAt(i));
+		return;
+	}
+	if (IsNull(Items)) return;
+	for (Value k : Items.Keys()) {
+		dst.Add(k);
+	}
+}
+void GCMap::CopyValuesTo(List<Value> dst) {
+	if (!IsNull(_gb) || !IsNull(_vmb)) {
+		for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) dst.Add(ValueAt(i));
+		return;
+	}
+	if (IsNull(Items)) return;
 	for (Value v : Items.Values()) {
-		if (j == i) return v;
-		j++;
+		dst.Add(v);
+	}
+}
+Dictionary<Value, Value> GCMap::CopyItems() {
+	if (IsNull(_gb) && IsNull(_vmb) && !IsNull(Items)) {
+		return  Dictionary<Value, Value>::New(Items);
+	}
+	Dictionary<Value, Value> result =  Dictionary<Value, Value>::New(Math::Max(Count(), 4));
+	for (Int32 i = NextEntry(-1); i != -1; i = NextEntry(i)) result[KeyAt(i)] = ValueAt(i);
+	return result;
+}
+void GCMap::SetAll(GCMap src) {
+	if (!IsNull(_gb) || !IsNull(_vmb) || !IsNull(src._gb) || !IsNull(src._vmb)) {
+		for (Int32 i = src.NextEntry(-1); i != -1; i = src.NextEntry(i)) {
+			Set(src.KeyAt(i), src.ValueAt(i));
+		}
+		return;
 	}
-	return Value::Null;
+	if (IsNull(src.Items)) return;
+	if (IsNull(Items)) Init(src.Items.Count());
+	Items.SetAll(src.Items);
 }
 void GCMap::MarkChildren() {
 	if (!IsNull(_gb)) { _gb.MarkChildren(); return; }
@@ -184,6 +223,7 @@ void GCMap::OnSweep() {
 	Frozen = Boolean(false);
 	_vmb   = nullptr;
 	_gb    = nullptr;
+	HashCache = 0;
 }
 
 void GCError::MarkChildren() {
@@ -213,7 +253,7 @@ void GCFunction::MarkChildren() {
 }
 
 void GCHandle::MarkChildren() {
-	// handles have no child Values
+	if (!IsNull(Marker)) Marker(UserData);
 }
 
 } // end of namespace MiniScript
@@ -31,6 +31,7 @@ struct GCList {
 	public: List<Value> Items;
 	public: Boolean Frozen;
 	public: Boolean Computed;
+	public: UInt32 HashCache;
 	// Items is public (paralleling GCMap.Items) so host bridges such as
 	// Value::GetList() can reach the backing list, but treat it with care: a list
 	// may be either "materialized" (Computed == false, Items holds the actual
@@ -45,6 +46,9 @@ struct GCList {
 	// callers MUST write the value back (GCManager.Lists.Set / SetFrozen style)
 	// after any operation that can mutate, or the change is lost.
 
+	// Content hash, cached on first use once the list is frozen (see
+	// Value.ListHash); 0 = not cached.  Cleared whenever Frozen changes.
+
 	public: void Init(Int32 capacity = 8);
 
 	// Construct a computed list.  increment may be Value.Null to repeat baseVal.
@@ -70,6 +74,12 @@ struct GCList {
 
 	public: Value Pull();
 
+	// Report the parameters of a computed list with a numeric increment (what
+	// `range` builds), so a caller can step through its elements with plain
+	// Double arithmetic instead of a Get per element.  Returns false for a
+	// materialized list, and for a repeating `[x] * n` list (null increment).
+	public: Boolean GetRange(Double* baseVal, Double* increment, Int32* length);
+
 	public: Int32 IndexOf(Value item, Int32 afterIdx);
 
 	public: void MarkChildren();
@@ -96,9 +106,13 @@ struct GCList {
 struct GCMap {
 	public: Dictionary<Value, Value> Items;
 	public: Boolean Frozen;
+	public: UInt32 HashCache;
 	public: VarMapBacking _vmb;
 	public: Globals _gb;
 
+	// Content hash, cached on first use once the map is frozen (see
+	// Value.MapHash); 0 = not cached.  Cleared whenever Frozen changes.
+
 	// Non-null for VarMap-backed maps (call-frame locals, closure contexts).
 
 	// Non-null for the `globals` map; then Items is null and _vmb is null.
@@ -125,8 +139,11 @@ struct GCMap {
 	// ── Iteration ─────────────────────────────────────────────────────────────
 	// iter = -1: start
 	// iter < -1: VarMap register entry -(i+2) where i is the reg-entry index
-	// iter >= 0: index into Items (in enumeration order), or -- for a globals
+	// iter >= 0: position in Items (in enumeration order), or -- for a globals
 	//            map, where Items is null -- a slot index in the global table
+	// In C++, the Dictionary finds a position in O(1) when it is stepped
+	// through in order (see KeyAtPosition in CS_Dictionary.h); in C# it is
+	// found by counting through the keys or values.
 
 	public: Int32 NextEntry(Int32 after);
 
@@ -134,6 +151,24 @@ struct GCMap {
 
 	public: Value ValueAt(Int32 i);
 
+	// ── Bulk operations ───────────────────────────────────────────────────────
+	// These work on the Dictionary as a whole when all entries live in Items
+	// (no VarMap or globals backing), instead of one NextEntry/KeyAt/Set round
+	// trip per entry.  A backed map falls back to that entry-at-a-time walk.
+
+	// Append every key to dst, in iteration order.
+	public: void CopyKeysTo(List<Value> dst);
+
+	// Append every value to dst, in iteration order.
+	public: void CopyValuesTo(List<Value> dst);
+
+	// A new, unshared dictionary holding this map's entries in order.  For an
+	// unbacked map this copies the table wholesale.
+	public: Dictionary<Value, Value> CopyItems();
+
+	// Store every entry of src in this map, as by Set, in src's order.
+	public: void SetAll(GCMap src);
+
 	// ── GC ────────────────────────────────────────────────────────────────────
 
 	public: void MarkChildren();
@@ -166,12 +201,15 @@ struct GCFunction {
 }; // end of struct GCFunction
 
 // ── GCHandle ──────────────────────────────────────────────────────────────────
-// A leaf GC type wrapping an arbitrary native object (void* in C++, object in C#).
+// A GC type wrapping an arbitrary native object (void* in C++, object in C#).
 // When swept, invokes Callback(UserData) so the host can free native resources.
+// Usually a leaf; but a native object that holds Values (a coroutine's
+// registers, say) gives a Marker, which marks them whenever the handle is.
 
 struct GCHandle {
 	public: object UserData;
 	public: HandleFinalizer Callback;
+	public: HandleMarker Marker;
 
 	public: void MarkChildren();
 
@@ -184,6 +222,7 @@ inline void GCList::Init(Int32 capacity ) {
 	Items    =  List<Value>::New(Math::Max(capacity, 4));
 	Frozen   = Boolean(false);
 	Computed = Boolean(false);
+	HashCache = 0;
 }
 inline Int32 GCList::Count() {
 	if (Computed) return (Int32)Items[2].NumericVal();
@@ -220,10 +259,23 @@ inline Boolean GCList::Remove(Int32 index) {
 	Items.RemoveAt(index);
 	return Boolean(true);
 }
+inline Boolean GCList::GetRange(Double* baseVal,Double* increment,Int32* length) {
+	if (!Computed || Items[1].IsNull()) {
+		*baseVal = 0;
+		*increment = 0;
+		*length = 0;
+		return Boolean(false);
+	}
+	*baseVal = Items[0].NumericVal();
+	*increment = Items[1].NumericVal();
+	*length = (Int32)Items[2].NumericVal();
+	return Boolean(true);
+}
 inline void GCList::OnSweep() {
 	Items    = nullptr;
 	Frozen   = Boolean(false);
 	Computed = Boolean(false);
+	HashCache = 0;
 }
 
 inline Boolean GCMap::HasKey(Value key) {
@@ -247,6 +299,7 @@ inline void GCHandle::OnSweep() {
 	if (!IsNull(Callback)) Callback(UserData);
 	UserData = nullptr;
 	Callback = nullptr;
+	Marker = nullptr;
 }
 
 } // end of namespace MiniScript
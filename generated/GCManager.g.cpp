@@ -14,20 +14,20 @@ const Int32 GCManager::FunctionSet = 4;
 const Int32 GCManager::InternedStringSet = 5;
 const Int32 GCManager::HandleSet = 6;
 const Int32 GCManager::InternThreshold = 128;
-GCStringSet GCManager::BigStrings = nullptr;
-GCStringSet GCManager::InternedStrings = nullptr;
-GCListSet GCManager::Lists = nullptr;
-GCMapSet GCManager::Maps = nullptr;
-GCErrorSet GCManager::Errors = nullptr;
-GCFuncRefSet GCManager::Functions = nullptr;
-GCHandleSet GCManager::Handles = nullptr;
-Dictionary<String, Int32> GCManager::_internTable = nullptr;
-Boolean GCManager::_fullCollection = Boolean(false);
-List<Value> GCManager::_roots = nullptr;
-List<MarkCallback> GCManager::_markCallbackFns = nullptr;
-List<object> GCManager::_markCallbackData = nullptr;
+thread_local GCStringSet GCManager::BigStrings;
+thread_local GCStringSet GCManager::InternedStrings;
+thread_local GCListSet GCManager::Lists;
+thread_local GCMapSet GCManager::Maps;
+thread_local GCErrorSet GCManager::Errors;
+thread_local GCFuncRefSet GCManager::Functions;
+thread_local GCHandleSet GCManager::Handles;
+thread_local Dictionary<String, Int32> GCManager::_internTable;
+thread_local Boolean GCManager::_fullCollection;
+thread_local List<Value> GCManager::_roots;
+thread_local List<MarkCallback> GCManager::_markCallbackFns;
+thread_local List<object> GCManager::_markCallbackData;
 void GCManager::Init() {
-	if (!IsNull(_roots)) return;	// already initialized
+	if (!IsNull(_roots)) return;	// already initialized on this thread
 	BigStrings      =  GCStringSet::New();
 	InternedStrings =  GCStringSet::New();
 	Lists           =  GCListSet::New();
@@ -46,10 +46,17 @@ void GCManager::Init() {
 	// who can allocate a funcref and root it.  A bare FuncDef is all we can
 	// build without reaching into the VM layer -- Globals installs the
 	// reporting callback on it.
+	//
+	// Each heap gets its own sentinel, but as the first funcref made in a
+	// fresh heap it has the same bits in all of them, so the one shared
+	// Value.Unassigned is right everywhere.  It is written only by the
+	// first Init in the process, which must finish before any other thread
+	// starts its own.
 	FuncDef unassignedFunc =  FuncDef::New();
 	unassignedFunc.set_Name("<unassigned>");
-	Value::Unassigned = NewFuncRef(unassignedFunc, Value::Null);
-	AddRoot(Value::Unassigned);
+	Value sentinel = NewFuncRef(unassignedFunc, Value::Null);
+	if (Value::Unassigned.Bits() != sentinel.Bits()) Value::Unassigned = sentinel;
+	AddRoot(sentinel);
 }
 Value GCManager::NewString(String s) {
 	Int32 idx = BigStrings.AllocItem();
@@ -62,10 +69,16 @@ Value GCManager::InternString(String s) {
 		return Value::make_gc(InternedStringSet, idx);
 	}
 	idx = InternedStrings.AllocItem();
-	InternedStrings.SetData(idx, s);
+	InternedStrings.SetInterned(idx, s, Value::StringHash(s));
 	_internTable[s] = idx;
 	return Value::make_gc(InternedStringSet, idx);
 }
+Value GCManager::Intern(Value v) {
+	if (!v.IsHeapString() || v.IsInternedString() || v.IsShared()) return v;
+	String s = GetString(v).Data;
+	if (IsNull(s) || s.Length() >= InternThreshold) return v;
+	return InternString(s);
+}
 Value GCManager::NewList(Int32 capacity ) {
 	Int32 idx = Lists.AllocItem();
 	Lists.Init(idx, capacity);
@@ -108,6 +121,12 @@ Value GCManager::NewHandle(object userData,HandleFinalizer callback) {
 	Handles.SetFields(idx, userData, callback);
 	return Value::make_gc(HandleSet, idx);
 }
+Value GCManager::NewHandle(object userData,HandleFinalizer callback,HandleMarker marker) {
+	Int32 idx = Handles.AllocItem();
+	Handles.SetFields(idx, userData, callback);
+	Handles.SetMarker(idx, marker);
+	return Value::make_gc(HandleSet, idx);
+}
 void GCManager::Retain(Value v) {
 	if (!v.IsGCObject()) return;
 	DispatchMark(v.GCSetIndex(), v.ItemIndex());
@@ -139,6 +158,7 @@ void GCManager::UnregisterMarkCallback(MarkCallback fn,object userData) {
 	}
 }
 void GCManager::DispatchMark(Int32 setIdx,Int32 itemIdx) {
+	if (itemIdx >= SharedHeap::FirstIndex) return;	// immortal; see SharedHeap
 	switch (setIdx) {
 		case BigStringSet:  BigStrings.Mark(itemIdx);  break;
 		case ListSet:    Lists.Mark(itemIdx);    break;
@@ -15,6 +15,15 @@ typedef void (*MarkCallback)(void* userData);
 // Central GC coordinator.  Owns the five typed GCSets and an explicit root list.
 // Mark(Value) dispatches to the right GCSet using the GCSet index baked into
 // the Value bits — no switch statement, just array indexing.
+// The heap is per thread: every field below is thread-static, and Init makes
+// the calling thread's own sets, roots and intern table.  A thread with its
+// own heap is an isolate -- it can run interpreters in parallel with other
+// isolates, with no locking, because no GC state is shared.  (C++ keeps its
+// C-string arena per thread too; see cstr_arena.h.)  The catch is that a
+// Value is only an index into its own thread's sets: a Value, or anything
+// holding one, must not be handed to another isolate -- unless it has been
+// published to the SharedHeap, which every isolate can read.  See
+// notes/MEMORY_SYSTEMS.md, "Isolates".
 class GCManager {
 	public: static const Int32 BigStringSet;
 	public: static const Int32 ListSet;
@@ -24,18 +33,18 @@ class GCManager {
 	public: static const Int32 InternedStringSet;
 	public: static const Int32 HandleSet;
 	public: static const Int32 InternThreshold;
-	public: static GCStringSet BigStrings;
-	public: static GCStringSet InternedStrings;
-	public: static GCListSet Lists;
-	public: static GCMapSet Maps;
-	public: static GCErrorSet Errors;
-	public: static GCFuncRefSet Functions;
-	public: static GCHandleSet Handles;
-	private: static Dictionary<String, Int32> _internTable;
-	private: static Boolean _fullCollection;
-	private: static List<Value> _roots;
-	private: static List<MarkCallback> _markCallbackFns;
-	private: static List<object> _markCallbackData;
+	public: thread_local static GCStringSet BigStrings;
+	public: thread_local static GCStringSet InternedStrings;
+	public: thread_local static GCListSet Lists;
+	public: thread_local static GCMapSet Maps;
+	public: thread_local static GCErrorSet Errors;
+	public: thread_local static GCFuncRefSet Functions;
+	public: thread_local static GCHandleSet Handles;
+	private: thread_local static Dictionary<String, Int32> _internTable;
+	private: thread_local static Boolean _fullCollection;
+	private: thread_local static List<Value> _roots;
+	private: thread_local static List<MarkCallback> _markCallbackFns;
+	private: thread_local static List<object> _markCallbackData;
 
 	// GCSet indices — these constants define the encoding baked into every GC Value.
 
@@ -43,7 +52,8 @@ class GCManager {
 	// are placed in the InternedStrings set and deduplicated via _internTable.
 	// Strings of Length >= InternThreshold go into the ordinary BigStrings set.
 
-	// Typed accessors; use these to allocate new objects.
+	// Typed accessors; use these to allocate new objects.  (These, and the
+	// rest of the state, are this thread's; see above.)
 
 	// Content-addressed intern table for short heap strings.
 	// Maps string content → InternedStrings slot index.
@@ -56,6 +66,9 @@ class GCManager {
 	// per CollectGarbage cycle.  The callback must call GCManager.Mark(v) on
 	// every root Value it owns.
 
+	// Make the calling thread's heap, if it has none yet.  Call this first on
+	// every thread that will run MiniScript code (then ErrorTypes.Init, and
+	// the host's own intrinsics, as on the main thread).
 	public: static void Init();
 
 	// ── Value factories ──────────────────────────────────────────────────────
@@ -66,6 +79,14 @@ class GCManager {
 	// semi-immortal InternedStrings set and record the mapping.
 	public: static Value InternString(String s);
 
+	// Return the interned equivalent of v if it is a heap string under
+	// InternThreshold that is not interned yet; otherwise v itself.  Strings
+	// built at run time are not interned when made, only when they become a
+	// map key (GCMap.Set), so most of them never touch the intern table.
+	// A shared string is left as it is: it may be a key of a shared map,
+	// which every isolate reads, and interned slots belong to this thread.
+	public: static Value Intern(Value v);
+
 	public: static Value NewList(Int32 capacity = 8);
 
 	// Create a computed list: element i is baseVal + increment * i, for `length`
@@ -92,6 +113,9 @@ class GCManager {
 
 	public: static Value NewHandle(object userData, HandleFinalizer callback);
 
+	// A handle whose native object holds Values: marker marks them (see GCHandle).
+	public: static Value NewHandle(object userData, HandleFinalizer callback, HandleMarker marker);
+
 	// ── Retain / Release ─────────────────────────────────────────────────────
 
 	public: static void Retain(Value v);
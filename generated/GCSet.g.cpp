@@ -23,9 +23,11 @@ Int32 GCSetBaseStorage::AllocItem() {
 	return idx;
 }
 void GCSetBaseStorage::Retain(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return;
 	_retainCounts[idx]++;
 }
 void GCSetBaseStorage::Release(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return;
 	_retainCounts[idx]--;
 }
 void GCSetBaseStorage::PrepareForGC() {
@@ -52,6 +54,7 @@ void GCSetBaseStorage::Sweep() {
 	}
 }
 Boolean GCSetBaseStorage::IsLiveSlot(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return Boolean(true);
 	return _inUse[idx] && (_marked[idx] || _retainCounts[idx] > 0);
 }
 Int32 GCSetBaseStorage::LiveCount() {
@@ -64,6 +67,7 @@ Int32 GCSetBaseStorage::LiveCount() {
 
 GCStringSetStorage::GCStringSetStorage(Int32 initialCapacity ) {
 	_items =  List<GCString>::New(initialCapacity);
+	_hashes =  List<UInt32>::New();
 }
 void GCStringSetStorage::CallMarkChildren(Int32 idx) {
 	_items[idx].MarkChildren();
@@ -76,6 +80,11 @@ void GCStringSetStorage::CallOnSweep(Int32 idx) {
 void GCStringSetStorage::AppendItem() {
 	_items.Add(GCString());
 }
+void GCStringSetStorage::SetInterned(Int32 idx,String s,UInt32 hash) {
+	SetData(idx, s);
+	while (_hashes.Count() <= idx) _hashes.Add(0);
+	_hashes[idx] = hash;
+}
 
 GCListSetStorage::GCListSetStorage(Int32 initialCapacity ) {
 	_items =  List<GCList>::New(initialCapacity);
@@ -6,6 +6,7 @@
 #include "forward_decs.g.h"
 #include "GCInterfaces.g.h"
 #include "GCItems.g.h"
+#include "SharedHeap.g.h"
 
 namespace MiniScript {
 
@@ -15,6 +16,10 @@ namespace MiniScript {
 // Manages bookkeeping metadata (InUse, Marked, RetainCount, free-list).
 // Subclasses supply the typed item list and the three abstract item operations.
 // Satisfies the IGCSet conceptual interface (see GCInterfaces.cs).
+// Indices from SharedHeap.FirstIndex up are not this set's items but shared,
+// immortal ones (see SharedHeap.cs).  The string, list and map sets read
+// those from the SharedHeap; they are never retained, marked or swept, and
+// the calls that would change one do nothing.
 struct GCSetBase {
 	friend class GCSetBaseStorage;
 	protected: std::shared_ptr<GCSetBaseStorage> storage;
@@ -125,6 +130,11 @@ class GCSetBaseStorage : public std::enable_shared_from_this<GCSetBaseStorage> {
 class GCStringSetStorage : public GCSetBaseStorage {
 	friend struct GCStringSet;
 	private: List<GCString> _items;
+	private: List<UInt32> _hashes;
+
+	// Content hash of each interned item (see SetInterned), so that hashing an
+	// interned Value (e.g. as a map key) is a read.  Kept apart from _items so
+	// that the BigStrings set, which never fills it in, pays nothing for it.
 
 	public: GCStringSetStorage(Int32 initialCapacity = 64);
 
@@ -135,6 +145,12 @@ class GCStringSetStorage : public GCSetBaseStorage {
 	public: GCString Get(Int32 idx);
 
 	public: void SetData(Int32 idx, String s);
+
+	// Store an interned string together with its content hash.
+	public: void SetInterned(Int32 idx, String s, UInt32 hash);
+
+	// Stored content hash of interned item idx (see SetInterned).
+	public: UInt32 GetHash(Int32 idx);
 }; // end of class GCStringSetStorage
 
 class GCListSetStorage : public GCSetBaseStorage {
@@ -149,10 +165,23 @@ class GCListSetStorage : public GCSetBaseStorage {
 
 	public: GCList Get(Int32 idx);
 
+	// Range parameters of list idx, read in place (see GCList.GetRange).  Used
+	// by the VM's `for` loop, which must not copy the GCList each iteration.
+	public: Boolean GetRange(Int32 idx, Double* baseVal, Double* increment, Int32* length);
+
 	public: void Init(Int32 idx, Int32 capacity);
 
 	public: void SetFrozen(Int32 idx, Boolean frozen);
 
+	// Frozen flag and cached content hash of item idx, read in place.
+	public: Boolean IsFrozen(Int32 idx);
+
+	public: UInt32 GetHashCache(Int32 idx);
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	public: void SetHashCache(Int32 idx, UInt32 hash);
+
 	// Write back a (possibly mutated/materialized) GCList value.  Mutating
 	// operations must call this so a materialized list's new Items reference and
 	// cleared Computed flag are not lost to struct-copy semantics.
@@ -178,8 +207,26 @@ class GCMapSetStorage : public GCSetBaseStorage {
 
 	public: void SetFrozen(Int32 idx, Boolean frozen);
 
+	// Frozen flag and cached content hash of item idx, read in place.
+	public: Boolean IsFrozen(Int32 idx);
+
+	public: UInt32 GetHashCache(Int32 idx);
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	public: void SetHashCache(Int32 idx, UInt32 hash);
+
 	public: void SetVmb(Int32 idx, VarMapBacking vmb);
 
+	// Iteration over map idx, read in place (see GCMap.NextEntry).  Used by
+	// the VM's `for` loop and map iterators, which must not copy the GCMap on
+	// every step.
+	public: Int32 NextEntry(Int32 idx, Int32 after);
+
+	public: Value KeyAt(Int32 idx, Int32 i);
+
+	public: Value ValueAt(Int32 idx, Int32 i);
+
 	// Attach an existing dictionary as this slot's contents, sharing its
 	// storage rather than copying entries (Dictionary assignment shares the
 	// underlying table).  Leaves Frozen and _vmb untouched, so this is meant
@@ -215,6 +262,8 @@ class GCHandleSetStorage : public GCSetBaseStorage {
 	public: GCHandle Get(Int32 idx);
 
 	public: void SetFields(Int32 idx, object userData, HandleFinalizer callback);
+
+	public: void SetMarker(Int32 idx, HandleMarker marker);
 }; // end of class GCHandleSetStorage
 
 class GCFuncRefSetStorage : public GCSetBaseStorage {
@@ -243,6 +292,12 @@ struct GCStringSet : public GCSetBase {
 
 	private: List<GCString> _items();
 	private: void set__items(List<GCString> _v);
+	private: List<UInt32> _hashes();
+	private: void set__hashes(List<UInt32> _v);
+
+	// Content hash of each interned item (see SetInterned), so that hashing an
+	// interned Value (e.g. as a map key) is a read.  Kept apart from _items so
+	// that the BigStrings set, which never fills it in, pays nothing for it.
 
 	public: static GCStringSet New(Int32 initialCapacity = 64) {
 		return GCStringSet(std::make_shared<GCStringSetStorage>());
@@ -255,6 +310,12 @@ struct GCStringSet : public GCSetBase {
 	public: inline GCString Get(Int32 idx);
 
 	public: inline void SetData(Int32 idx, String s);
+
+	// Store an interned string together with its content hash.
+	public: inline void SetInterned(Int32 idx, String s, UInt32 hash);
+
+	// Stored content hash of interned item idx (see SetInterned).
+	public: inline UInt32 GetHash(Int32 idx);
 }; // end of struct GCStringSet
 
 // ── GCListSet ─────────────────────────────────────────────────────────────────
@@ -279,10 +340,23 @@ struct GCListSet : public GCSetBase {
 
 	public: inline GCList Get(Int32 idx);
 
+	// Range parameters of list idx, read in place (see GCList.GetRange).  Used
+	// by the VM's `for` loop, which must not copy the GCList each iteration.
+	public: inline Boolean GetRange(Int32 idx, Double* baseVal, Double* increment, Int32* length);
+
 	public: inline void Init(Int32 idx, Int32 capacity);
 
 	public: inline void SetFrozen(Int32 idx, Boolean frozen);
 
+	// Frozen flag and cached content hash of item idx, read in place.
+	public: inline Boolean IsFrozen(Int32 idx);
+
+	public: inline UInt32 GetHashCache(Int32 idx);
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	public: inline void SetHashCache(Int32 idx, UInt32 hash);
+
 	// Write back a (possibly mutated/materialized) GCList value.  Mutating
 	// operations must call this so a materialized list's new Items reference and
 	// cleared Computed flag are not lost to struct-copy semantics.
@@ -318,8 +392,26 @@ struct GCMapSet : public GCSetBase {
 
 	public: inline void SetFrozen(Int32 idx, Boolean frozen);
 
+	// Frozen flag and cached content hash of item idx, read in place.
+	public: inline Boolean IsFrozen(Int32 idx);
+
+	public: inline UInt32 GetHashCache(Int32 idx);
+
+	// Cache the content hash of item idx; only meaningful while it is frozen.
+	// (A shared item's hash was cached when it was published.)
+	public: inline void SetHashCache(Int32 idx, UInt32 hash);
+
 	public: inline void SetVmb(Int32 idx, VarMapBacking vmb);
 
+	// Iteration over map idx, read in place (see GCMap.NextEntry).  Used by
+	// the VM's `for` loop and map iterators, which must not copy the GCMap on
+	// every step.
+	public: inline Int32 NextEntry(Int32 idx, Int32 after);
+
+	public: inline Value KeyAt(Int32 idx, Int32 i);
+
+	public: inline Value ValueAt(Int32 idx, Int32 i);
+
 	// Attach an existing dictionary as this slot's contents, sharing its
 	// storage rather than copying entries (Dictionary assignment shares the
 	// underlying table).  Leaves Frozen and _vmb untouched, so this is meant
@@ -375,6 +467,8 @@ struct GCHandleSet : public GCSetBase {
 	public: inline GCHandle Get(Int32 idx);
 
 	public: inline void SetFields(Int32 idx, object userData, HandleFinalizer callback);
+
+	public: inline void SetMarker(Int32 idx, HandleMarker marker);
 }; // end of struct GCHandleSet
 
 // ── GCFuncRefSet ──────────────────────────────────────────────────────────────
@@ -430,8 +524,11 @@ inline GCStringSet::GCStringSet(std::shared_ptr<GCStringSetStorage> stor) : GCSe
 inline GCStringSetStorage* GCStringSet::get() const { return static_cast<GCStringSetStorage*>(storage.get()); }
 inline List<GCString> GCStringSet::_items() { return get()->_items; }
 inline void GCStringSet::set__items(List<GCString> _v) { get()->_items = _v; }
+inline List<UInt32> GCStringSet::_hashes() { return get()->_hashes; }
+inline void GCStringSet::set__hashes(List<UInt32> _v) { get()->_hashes = _v; }
 inline GCString GCStringSet::Get(Int32 idx) { return get()->Get(idx); }
 inline GCString GCStringSetStorage::Get(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetString(idx);
 	return _items[idx];
 }
 inline void GCStringSet::SetData(Int32 idx,String s) { return get()->SetData(idx, s); }
@@ -440,6 +537,11 @@ inline void GCStringSetStorage::SetData(Int32 idx,String s) {
 	item.Data = s;
 	_items[idx] = item;
 }
+inline void GCStringSet::SetInterned(Int32 idx,String s,UInt32 hash) { return get()->SetInterned(idx, s, hash); }
+inline UInt32 GCStringSet::GetHash(Int32 idx) { return get()->GetHash(idx); }
+inline UInt32 GCStringSetStorage::GetHash(Int32 idx) {
+	return _hashes[idx];
+}
 
 inline GCListSet::GCListSet(std::shared_ptr<GCListSetStorage> stor) : GCSetBase(stor) {}
 inline GCListSetStorage* GCListSet::get() const { return static_cast<GCListSetStorage*>(storage.get()); }
@@ -447,17 +549,43 @@ inline List<GCList> GCListSet::_items() { return get()->_items; }
 inline void GCListSet::set__items(List<GCList> _v) { get()->_items = _v; }
 inline GCList GCListSet::Get(Int32 idx) { return get()->Get(idx); }
 inline GCList GCListSetStorage::Get(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetList(idx);
 	return _items[idx];
 }
+inline Boolean GCListSet::GetRange(Int32 idx,Double* baseVal,Double* increment,Int32* length) { return get()->GetRange(idx, baseVal, increment, length); }
+inline Boolean GCListSetStorage::GetRange(Int32 idx,Double* baseVal,Double* increment,Int32* length) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetList(idx).GetRange(&*baseVal, &*increment, &*length);
+	return _items[idx].GetRange(&*baseVal, &*increment, &*length);
+}
 inline void GCListSet::Init(Int32 idx,Int32 capacity) { return get()->Init(idx, capacity); }
 inline void GCListSet::SetFrozen(Int32 idx,Boolean frozen) { return get()->SetFrozen(idx, frozen); }
 inline void GCListSetStorage::SetFrozen(Int32 idx,Boolean frozen) {
+	if (idx >= SharedHeap::FirstIndex) return;
 	GCList item = _items[idx];
 	item.Frozen = frozen;
+	item.HashCache = 0;
+	_items[idx] = item;
+}
+inline Boolean GCListSet::IsFrozen(Int32 idx) { return get()->IsFrozen(idx); }
+inline Boolean GCListSetStorage::IsFrozen(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return Boolean(true);
+	return _items[idx].Frozen;
+}
+inline UInt32 GCListSet::GetHashCache(Int32 idx) { return get()->GetHashCache(idx); }
+inline UInt32 GCListSetStorage::GetHashCache(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetList(idx).HashCache;
+	return _items[idx].HashCache;
+}
+inline void GCListSet::SetHashCache(Int32 idx,UInt32 hash) { return get()->SetHashCache(idx, hash); }
+inline void GCListSetStorage::SetHashCache(Int32 idx,UInt32 hash) {
+	if (idx >= SharedHeap::FirstIndex) return;
+	GCList item = _items[idx];
+	item.HashCache = hash;
 	_items[idx] = item;
 }
 inline void GCListSet::Set(Int32 idx,GCList item) { return get()->Set(idx, item); }
 inline void GCListSetStorage::Set(Int32 idx,GCList item) {
+	if (idx >= SharedHeap::FirstIndex) return;
 	_items[idx] = item;
 }
 
@@ -467,14 +595,34 @@ inline List<GCMap> GCMapSet::_items() { return get()->_items; }
 inline void GCMapSet::set__items(List<GCMap> _v) { get()->_items = _v; }
 inline GCMap GCMapSet::Get(Int32 idx) { return get()->Get(idx); }
 inline GCMap GCMapSetStorage::Get(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetMap(idx);
 	return _items[idx];
 }
 inline void GCMapSet::Init(Int32 idx,Int32 capacity) { return get()->Init(idx, capacity); }
 inline void GCMapSet::InitAsGlobals(Int32 idx,Globals g) { return get()->InitAsGlobals(idx, g); }
 inline void GCMapSet::SetFrozen(Int32 idx,Boolean frozen) { return get()->SetFrozen(idx, frozen); }
 inline void GCMapSetStorage::SetFrozen(Int32 idx,Boolean frozen) {
+	if (idx >= SharedHeap::FirstIndex) return;
 	GCMap item = _items[idx];
 	item.Frozen = frozen;
+	item.HashCache = 0;
+	_items[idx] = item;
+}
+inline Boolean GCMapSet::IsFrozen(Int32 idx) { return get()->IsFrozen(idx); }
+inline Boolean GCMapSetStorage::IsFrozen(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return Boolean(true);
+	return _items[idx].Frozen;
+}
+inline UInt32 GCMapSet::GetHashCache(Int32 idx) { return get()->GetHashCache(idx); }
+inline UInt32 GCMapSetStorage::GetHashCache(Int32 idx) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetMap(idx).HashCache;
+	return _items[idx].HashCache;
+}
+inline void GCMapSet::SetHashCache(Int32 idx,UInt32 hash) { return get()->SetHashCache(idx, hash); }
+inline void GCMapSetStorage::SetHashCache(Int32 idx,UInt32 hash) {
+	if (idx >= SharedHeap::FirstIndex) return;
+	GCMap item = _items[idx];
+	item.HashCache = hash;
 	_items[idx] = item;
 }
 inline void GCMapSet::SetVmb(Int32 idx,VarMapBacking vmb) { return get()->SetVmb(idx, vmb); }
@@ -483,6 +631,21 @@ inline void GCMapSetStorage::SetVmb(Int32 idx,VarMapBacking vmb) {
 	item._vmb = vmb;
 	_items[idx] = item;
 }
+inline Int32 GCMapSet::NextEntry(Int32 idx,Int32 after) { return get()->NextEntry(idx, after); }
+inline Int32 GCMapSetStorage::NextEntry(Int32 idx,Int32 after) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetMap(idx).NextEntry(after);
+	return _items[idx].NextEntry(after);
+}
+inline Value GCMapSet::KeyAt(Int32 idx,Int32 i) { return get()->KeyAt(idx, i); }
+inline Value GCMapSetStorage::KeyAt(Int32 idx,Int32 i) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetMap(idx).KeyAt(i);
+	return _items[idx].KeyAt(i);
+}
+inline Value GCMapSet::ValueAt(Int32 idx,Int32 i) { return get()->ValueAt(idx, i); }
+inline Value GCMapSetStorage::ValueAt(Int32 idx,Int32 i) {
+	if (idx >= SharedHeap::FirstIndex) return SharedHeap::GetMap(idx).ValueAt(i);
+	return _items[idx].ValueAt(i);
+}
 inline void GCMapSet::SetItems(Int32 idx,Dictionary<Value, Value> items) { return get()->SetItems(idx, items); }
 inline void GCMapSetStorage::SetItems(Int32 idx,Dictionary<Value, Value> items) {
 	GCMap item = _items[idx];
@@ -521,6 +684,13 @@ inline void GCHandleSetStorage::SetFields(Int32 idx,object userData,HandleFinali
 	GCHandle item = _items[idx];
 	item.UserData = userData;
 	item.Callback = callback;
+	item.Marker = nullptr;
+	_items[idx] = item;
+}
+inline void GCHandleSet::SetMarker(Int32 idx,HandleMarker marker) { return get()->SetMarker(idx, marker); }
+inline void GCHandleSetStorage::SetMarker(Int32 idx,HandleMarker marker) {
+	GCHandle item = _items[idx];
+	item.Marker = marker;
 	_items[idx] = item;
 }
 
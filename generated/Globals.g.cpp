@@ -8,7 +8,7 @@
 
 namespace MiniScript {
 
-Int32 GlobalsStorage::_lastId = 0;
+	thread_local Int32 GlobalsStorage::_lastId;
 Globals GlobalsStorage::Create() {
 	Globals g =  Globals::New();
 	g.AttachMap(GCManager::NewGlobalsMap(g));
@@ -87,6 +87,56 @@ Int32 GlobalsStorage::NextAssignedSlot(Int32 startSlot) {
 	}
 	return -1;
 }
+Globals GlobalsStorage::Clone() {
+	Globals _this(std::static_pointer_cast<GlobalsStorage>(shared_from_this()));
+	Globals g = Create();
+	g.CopyFrom(_this);
+	return g;
+}
+void GlobalsStorage::CopyFrom(Globals src) {
+	Clear();
+	Dictionary<Int32, Value> lists =  Dictionary<Int32, Value>::New();  // list index -> its copy
+	Dictionary<Int32, Value> maps =  Dictionary<Int32, Value>::New();   // map index -> its copy
+	maps[src.AsMap().ItemIndex()] = _mapValue;
+	Int32 count = src.SlotCount();
+	for (Int32 i = 0; i < count; i++) {
+		Int32 slot = Resolve(src.NameAtSlot(i));	// (unassigned ones too, to keep the numbering)
+		Value v = src.ValueAtSlot(i);
+		if (!v.IsUnassigned()) SetSlot(slot, CloneValue(v, lists, maps));
+	}
+}
+Value GlobalsStorage::CloneValue(Value v,Dictionary<Int32, Value> lists,Dictionary<Int32, Value> maps) {
+	Value copy;
+	if (v.IsList()) {
+		if (v.IsFrozen()) return v;
+		if (lists.TryGetValue(v.ItemIndex(), &copy)) return copy;
+		Int32 count = v.ListCount();
+		copy = Value::make_list(count);
+		lists[v.ItemIndex()] = copy;	// (before the items, which may lead back here)
+		for (Int32 i = 0; i < count; i++) copy.Push(CloneValue(v.ListGet(i), lists, maps));
+		return copy;
+	}
+	if (v.IsMap()) {
+		if (v.IsFrozen()) return v;
+		if (maps.TryGetValue(v.ItemIndex(), &copy)) return copy;
+		GCMap m = GCManager::Maps.Get(v.ItemIndex());
+		if (!IsNull(m._gb)) return v;	// some other interpreter's globals
+		copy = Value::make_map(m.Count());
+		maps[v.ItemIndex()] = copy;
+		for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+			copy.MapSet(m.KeyAt(i), CloneValue(m.ValueAt(i), lists, maps));
+		}
+		return copy;
+	}
+	if (v.IsFuncRef() && !v.IsUnassigned()) {
+		Value outer = v.OuterVars();
+		if (outer.IsNull()) return v;
+		Value outerCopy = CloneValue(outer, lists, maps);
+		if (outerCopy.RefEquals(outer)) return v;
+		return Value::make_funcref(v.FunctionDef(), outerCopy);
+	}
+	return v;
+}
 void GlobalsStorage::MarkChildren() {
 	for (Int32 i = 0; i < _names.Count(); i++) {
 		GCManager::Mark(_names[i]);
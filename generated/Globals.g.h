@@ -57,7 +57,7 @@ class GlobalsStorage : public std::enable_shared_from_this<GlobalsStorage> {
 	private: Int32 _id; // generation; see Id()
 	private: Int32 _assignedCount; // slots currently holding a value
 	private: Value _mapValue; // the `globals` map viewing this table
-	private: static Int32 _lastId;
+	private: thread_local static Int32 _lastId;
 
 	// Generation counter.  Every Globals gets a distinct Id, and an Id is never
 	// reused.  Compiled code caches (name -> slot) resolutions and validates
@@ -67,6 +67,8 @@ class GlobalsStorage : public std::enable_shared_from_this<GlobalsStorage> {
 	// Pre-incremented, so the first Globals gets Id 1 and 0 is never a valid Id
 	// -- which lets a not-yet-resolved slot cache use 0 as its "never resolved"
 	// marker.
+	// Per thread: an Id need only be unique among the namespaces of one
+	// isolate (see GCManager), and the isolates must not race on it.
 
 	// Make a new, empty global namespace.  Use this rather than `new Globals()`
 	// directly: a Globals is paired 1:1 with the map that views it, and only a
@@ -171,6 +173,31 @@ class GlobalsStorage : public std::enable_shared_from_this<GlobalsStorage> {
 	// the Dictionary walk it replaces, it is O(1) per step.
 	public: Int32 NextAssignedSlot(Int32 startSlot);
 
+	// ── Cloning ───────────────────────────────────────────────────────────────
+
+	// A new namespace holding a copy of every global here, for another
+	// interpreter to start from (see Interpreter.Clone).  The copy must be one
+	// the clone can change freely without the change showing up here, so
+	// mutable lists and maps are copied, however deeply nested, and a structure
+	// shared or cyclic here is shared or cyclic in the copy.  Everything
+	// immutable -- numbers, strings, frozen lists and maps, FuncDefs -- is
+	// shared, so a prelude that freezes its tables costs next to nothing to
+	// clone.  A function whose closure is this namespace gets the copy instead,
+	// so a top-level function defined here sees the clone's globals.
+	// Slots are made in the same order, so the copy numbers its names exactly
+	// as this one does; it still gets its own Id, since the two grow apart.
+	public: Globals Clone();
+
+	// Make this namespace a copy of src, as Clone does, but in place: every
+	// global not in src is unbound, and this object keeps its Id and its slots.
+	// Reusing a namespace this way (see Interpreter.Recycle) costs no more
+	// than copying src's mutable data, and keeps valid every slot resolution
+	// compiled code has already made against it.
+	public: void CopyFrom(Globals src);
+
+	// A copy of v for CopyFrom, made at most once per list or map.
+	private: static Value CloneValue(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps);
+
 	// ── GC ────────────────────────────────────────────────────────────────────
 
 	// Mark every name and value held here.  Reached from GCMap.MarkChildren on
@@ -223,6 +250,8 @@ struct Globals {
 	// Pre-incremented, so the first Globals gets Id 1 and 0 is never a valid Id
 	// -- which lets a not-yet-resolved slot cache use 0 as its "never resolved"
 	// marker.
+	// Per thread: an Id need only be unique among the namespaces of one
+	// isolate (see GCManager), and the isolates must not race on it.
 
 	// Make a new, empty global namespace.  Use this rather than `new Globals()`
 	// directly: a Globals is paired 1:1 with the map that views it, and only a
@@ -329,6 +358,31 @@ struct Globals {
 	// the Dictionary walk it replaces, it is O(1) per step.
 	public: inline Int32 NextAssignedSlot(Int32 startSlot);
 
+	// ── Cloning ───────────────────────────────────────────────────────────────
+
+	// A new namespace holding a copy of every global here, for another
+	// interpreter to start from (see Interpreter.Clone).  The copy must be one
+	// the clone can change freely without the change showing up here, so
+	// mutable lists and maps are copied, however deeply nested, and a structure
+	// shared or cyclic here is shared or cyclic in the copy.  Everything
+	// immutable -- numbers, strings, frozen lists and maps, FuncDefs -- is
+	// shared, so a prelude that freezes its tables costs next to nothing to
+	// clone.  A function whose closure is this namespace gets the copy instead,
+	// so a top-level function defined here sees the clone's globals.
+	// Slots are made in the same order, so the copy numbers its names exactly
+	// as this one does; it still gets its own Id, since the two grow apart.
+	public: inline Globals Clone();
+
+	// Make this namespace a copy of src, as Clone does, but in place: every
+	// global not in src is unbound, and this object keeps its Id and its slots.
+	// Reusing a namespace this way (see Interpreter.Recycle) costs no more
+	// than copying src's mutable data, and keeps valid every slot resolution
+	// compiled code has already made against it.
+	public: inline void CopyFrom(Globals src);
+
+	// A copy of v for CopyFrom, made at most once per list or map.
+	private: static Value CloneValue(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps) { return GlobalsStorage::CloneValue(v, lists, maps); }
+
 	// ── GC ────────────────────────────────────────────────────────────────────
 
 	// Mark every name and value held here.  Reached from GCMap.MarkChildren on
@@ -421,6 +475,8 @@ inline Boolean Globals::Remove(Value key) { return get()->Remove(key); }
 inline Boolean Globals::HasKey(Value key) { return get()->HasKey(key); }
 inline void Globals::Clear() { return get()->Clear(); }
 inline Int32 Globals::NextAssignedSlot(Int32 startSlot) { return get()->NextAssignedSlot(startSlot); }
+inline Globals Globals::Clone() { return get()->Clone(); }
+inline void Globals::CopyFrom(Globals src) { return get()->CopyFrom(src); }
 inline void Globals::MarkChildren() { return get()->MarkChildren(); }
 
 } // end of namespace MiniScript
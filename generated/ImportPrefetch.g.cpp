@@ -0,0 +1,205 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: ImportPrefetch.cs
+
+#include "ImportPrefetch.g.h"
+#include "Parser.g.h"
+#include "Lexer.g.h"
+#include "ShellIntrinsics.g.h"
+#include <cstdlib>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MiniScript {
+
+Int32 ImportPrefetch::ThreadCount = -1;
+List<String> ImportPrefetch::_names =  List<String>::New(); // library name
+List<String> ImportPrefetch::_sources =  List<String>::New(); // its source, once read ("" if not found)
+List<Int32> ImportPrefetch::_firstStatement =  List<Int32>::New(); // its statements in _statements, or -1
+List<Int32> ImportPrefetch::_statementCount =  List<Int32>::New();
+List<ASTNode> ImportPrefetch::_statements =  List<ASTNode>::New();
+List<Boolean> ImportPrefetch::_claimed =  List<Boolean>::New(); // a worker (or Take) has it
+List<Boolean> ImportPrefetch::_done =  List<Boolean>::New(); // its source and statements are final
+Int32 ImportPrefetch::_nextJob = 0; // no job before this one is unclaimed
+List<String> ImportPrefetch::_dirs =  List<String>::New(); // where to look, in search order
+Boolean ImportPrefetch::_stopping = Boolean(false);
+Boolean ImportPrefetch::_started = Boolean(false); // (VM thread only) Start has been called
+Int32 ImportPrefetch::_threadsRunning = 0;
+static std::mutex _mutex;
+static std::condition_variable_any _changed;
+// Made on first use, so that it is destroyed (joining the workers) before
+// the job lists above, which the workers may still be using.
+struct PrefetchThreads {
+	std::vector<std::thread> threads;
+	~PrefetchThreads() { ImportPrefetch::Stop(); }
+};
+static PrefetchThreads& Threads() {
+	static PrefetchThreads threads;
+	return threads;
+}
+Int32 ImportPrefetch::GetThreadCount() {
+	if (ThreadCount < 0) {
+		ThreadCount = 0;
+		const char* env = getenv("MS_IMPORT_PREFETCH");
+		if (env) ThreadCount = atoi(env);
+		if (ThreadCount < 0) ThreadCount = 0;
+	}
+	return ThreadCount;
+}
+void ImportPrefetch::Start(String source,List<String> dirs) {
+	if (GetThreadCount() <= 0) return;
+	_started = Boolean(true);
+	Lock();
+	_dirs = dirs;
+	AddJob("", source);
+	Notify();
+	Unlock();
+	StartThreads();
+}
+List<ASTNode> ImportPrefetch::Take(String name,String source) {
+	if (!_started) return nullptr;
+	List<ASTNode> result = nullptr;
+	Lock();
+	Int32 job = _names.IndexOf(name);
+	if (job >= 0 && !_claimed[job]) {
+		// Not begun yet: quicker to parse it on the spot than to wait.
+		_claimed[job] = Boolean(true);
+		_done[job] = Boolean(true);
+	}
+	if (job >= 0) {
+		while (!_done[job] && !_stopping) Wait();
+		Int32 first = _firstStatement[job];
+		if (_done[job] && first >= 0) {
+			if (_sources[job] == source) result =  List<ASTNode>::New();
+			for (Int32 i = first; i < first + _statementCount[job]; i++) {
+				if (!IsNull(result)) result.Add(_statements[i]);
+				_statements[i] = nullptr;
+			}
+		}
+		_firstStatement[job] = -1;
+		_sources[job] = "";
+	}
+	Unlock();
+	return result;
+}
+void ImportPrefetch::Stop() {
+	Lock();
+	_stopping = Boolean(true);
+	Notify();
+	Unlock();
+	std::vector<std::thread>& threads = Threads().threads;
+	for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+	threads.clear();
+	Lock();
+	_names.Clear();
+	_sources.Clear();
+	_firstStatement.Clear();
+	_statementCount.Clear();
+	_statements.Clear();
+	_claimed.Clear();
+	_done.Clear();
+	_nextJob = 0;
+	_threadsRunning = 0;
+	_stopping = Boolean(false);
+	Unlock();
+	_started = Boolean(false);
+}
+void ImportPrefetch::StartThreads() {
+	while (_threadsRunning < ThreadCount) {
+		_threadsRunning++;
+		Threads().threads.push_back(std::thread(&ImportPrefetch::WorkerLoop));
+	}
+}
+void ImportPrefetch::AddJob(String name,String source) {
+	if (name.Length() > 0 && _names.IndexOf(name) >= 0) return;
+	_names.Add(name);
+	_sources.Add(source);
+	_firstStatement.Add(-1);
+	_statementCount.Add(0);
+	_claimed.Add(Boolean(false));
+	_done.Add(Boolean(false));
+}
+void ImportPrefetch::WorkerLoop() {
+	Lock();
+	while (Boolean(true)) {
+		while (_nextJob < _names.Count() && _claimed[_nextJob]) _nextJob++;
+		if (_stopping) break;
+		if (_nextJob >= _names.Count()) {
+			Wait();
+			continue;
+		}
+		Int32 job = _nextJob;
+		_claimed[job] = Boolean(true);
+		String name = _names[job];
+		String source = _sources[job];
+		List<String> dirs = _dirs;
+		Unlock();
+
+		List<ASTNode> statements = nullptr;
+		if (name.Length() > 0) {
+			source = ReadModule(name, dirs);
+			if (source.Length() > 0) statements = Parse(source, name + ".ms");
+		}
+		List<String> imports = FindImports(source);
+
+		Lock();
+		_sources[job] = name.Length() > 0 ? source : "";
+		if (!IsNull(statements)) {
+			_firstStatement[job] = _statements.Count();
+			_statementCount[job] = statements.Count();
+			for (Int32 i = 0; i < statements.Count(); i++) _statements.Add(statements[i]);
+		}
+		_done[job] = Boolean(true);
+		for (Int32 i = 0; i < imports.Count(); i++) AddJob(imports[i], "");
+		Notify();
+	}
+	Unlock();
+}
+String ImportPrefetch::ReadModule(String name,List<String> dirs) {
+	for (Int32 i = 0; i < dirs.Count(); i++) {
+		String src = ShellIntrinsics::TryReadSource(dirs[i] + name + ".ms");
+		if (src.LengthB() == 0) continue;
+		return src;
+	}
+	return "";
+}
+List<ASTNode> ImportPrefetch::Parse(String source,String fileName) {
+	Parser parser =  Parser::New();
+	parser.set_Detached(Boolean(true));
+	parser.Init(source, fileName);
+	List<ASTNode> statements = parser.ParseProgram();
+	parser.RequireComplete();
+	if (parser.HadError()) return nullptr;
+	ASTSimplifier::SimplifyAll(statements);
+	return statements;
+}
+List<String> ImportPrefetch::FindImports(String source) {
+	List<String> result =  List<String>::New();
+	Lexer lexer = Lexer(source);
+	lexer.Detached = Boolean(true);
+	Int32 state = 0;   // 1: just after `import`; 2: after `import(`
+	while (Boolean(true)) {
+		Token tok = lexer.NextToken();
+		if (tok.Type == TokenType::END_OF_INPUT || lexer.HadError()) break;
+		if (tok.Type == TokenType::STRING && state > 0) result.Add(tok.Text);
+		if (tok.Type == TokenType::IDENTIFIER && tok.Text == "import") state = 1;
+		else if (tok.Type == TokenType::LPAREN && state == 1) state = 2;
+		else state = 0;
+	}
+	return result;
+}
+void ImportPrefetch::Lock() {
+	_mutex.lock();
+}
+void ImportPrefetch::Unlock() {
+	_mutex.unlock();
+}
+void ImportPrefetch::Wait() {
+	_changed.wait(_mutex);
+}
+void ImportPrefetch::Notify() {
+	_changed.notify_all();
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,112 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: ImportPrefetch.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// ImportPrefetch.cs
+// Background parsing of the modules a script imports.  `import` compiles a
+// module only when the import runs, so a script that imports dozens of
+// modules parses them one after another on the VM thread.  When the shell
+// loads a script it hands the source to ImportPrefetch.Start, which sets
+// worker threads to finding each `import "name"` with a literal name, and to
+// reading and parsing those modules (and, in turn, the modules they import).
+// When the import itself runs, the import intrinsic finds and reads the
+// module just as before, and takes the prefetched statements only if they
+// were parsed from exactly that source.  Code generation, and running the
+// module, stay on the VM thread.  So the order and effect of imports do not
+// change: a prefetch that guessed wrong (MS_IMPORT_PATH changed by then, the
+// file changed, the import never reached) simply goes unused.
+// Only the front end runs on the workers.  Code generation makes Values --
+// constants, function templates -- and the GC heap belongs to the VM thread.
+// For the same reason a worker's parser runs Detached: a parse error is only
+// noted, and the import parses the module again itself to report it.
+// The number of workers is ThreadCount.  Hosts may set it; if they do not, it
+// is read once from the MS_IMPORT_PREFETCH environment variable.  It is 0
+// (prefetching off) unless set, because in C++ a second thread is not free:
+// once a process has started one, libstdc++ makes every shared_ptr copy an
+// atomic operation for the rest of the run, which costs the VM far more than
+// it saves a script that mostly computes (see notes/POTENTIAL_ISSUES.md).
+
+#include "AST.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class ImportPrefetch {
+	public: static Int32 ThreadCount;
+	private: static List<String> _names; // library name
+	private: static List<String> _sources; // its source, once read ("" if not found)
+	private: static List<Int32> _firstStatement; // its statements in _statements, or -1
+	private: static List<Int32> _statementCount;
+	private: static List<ASTNode> _statements;
+	private: static List<Boolean> _claimed; // a worker (or Take) has it
+	private: static List<Boolean> _done; // its source and statements are final
+	private: static Int32 _nextJob; // no job before this one is unclaimed
+	private: static List<String> _dirs; // where to look, in search order
+	private: static Boolean _stopping;
+	private: static Boolean _started; // (VM thread only) Start has been called
+	private: static Int32 _threadsRunning;
+	// Worker threads to use; -1 until resolved (see GetThreadCount).
+
+	// The jobs, one per module name, in the order they were found.  A job with
+	// an empty name is a script handed to Start: it is only scanned for
+	// imports.  Everything here is shared with the workers, and guarded by the
+	// lock (see Lock and Unlock).  A job's statements are a run of _statements,
+	// since a list of lists is more than the transpiler can take.
+
+	public: static Int32 GetThreadCount();
+
+	// Start prefetching the modules that `source` imports, looking for them in
+	// `dirs`: directory prefixes, already expanded, each ending in a separator
+	// (or empty, for the current directory).  Returns at once.
+	public: static void Start(String source, List<String> dirs);
+
+	// The statements of module `name`, if they were prefetched from exactly
+	// `source`; otherwise null, and the caller should parse it as usual.  Waits
+	// if a worker is still on it.  A module is handed out only once, so a
+	// second import of it parses afresh.
+	public: static List<ASTNode> Take(String name, String source);
+
+	// Stop the workers and wait for them to finish, dropping any prefetched
+	// modules not yet taken.  Happens by itself at exit.
+	public: static void Stop();
+
+	// ── Workers ──────────────────────────────────────────────────────────────
+
+	private: static void StartThreads();
+
+	// Add a job (under the lock).  A module already known is not added again.
+	private: static void AddJob(String name, String source);
+
+	// Body of each worker: claim jobs in order until told to stop.
+	private: static void WorkerLoop();
+
+	// Find and read module `name`, as the import intrinsic would; "" if not found.
+	private: static String ReadModule(String name, List<String> dirs);
+
+	// Parse and simplify a module, as Interpreter.CompileToFunc would; null on
+	// any error.
+	private: static List<ASTNode> Parse(String source, String fileName);
+
+	// The literal names imported by `import "name"` or `import("name")` in
+	// source.  Found from the tokens alone, so an occasional false hit is
+	// possible; it only costs an unused prefetch.
+	private: static List<String> FindImports(String source);
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private: static void Lock();
+
+	private: static void Unlock();
+
+	// Wait (holding the lock) until some other thread calls Notify.
+	private: static void Wait();
+
+	private: static void Notify();
+}; // end of struct ImportPrefetch
+
+// INLINE METHODS
+
+} // end of namespace MiniScript
@@ -5,6 +5,7 @@
 #include "StringUtils.g.h"
 #include "CS_value_util.h"
 #include "CoreIntrinsics.g.h"
+#include <thread>
 
 namespace MiniScript {
 
@@ -29,6 +30,14 @@ Globals InterpreterStorage::GetGlobals() {
 void InterpreterStorage::ClearGlobals() {
 	if (!IsNull(_globals)) _globals.Clear();
 }
+Interpreter InterpreterStorage::Clone(String source,TextOutputMethod standardOutput,TextOutputMethod errorOutput) {
+	Interpreter result =  Interpreter::New(source, standardOutput, errorOutput);
+	result.set_implicitOutput(implicitOutput);
+	result.set_hostData(hostData);
+	result.set_SourceFile(SourceFile);
+	result.set__globals(GetGlobals().Clone());
+	return result;
+}
 InterpreterStorage::InterpreterStorage(List<String> sourceList,TextOutputMethod standardOutput,TextOutputMethod errorOutput) {
 	String source = String::Join("\n", sourceList);
 	Init(source, standardOutput, errorOutput);
@@ -59,6 +68,33 @@ void InterpreterStorage::ResetPreservingGlobals(String _source) {
 	_globals = keptGlobals;  // still rooted, since Reset never saw it
 	Compile();
 }
+void InterpreterStorage::Recycle(String _source,Globals startFrom) {
+	if (!IsNull(vm) && (_source != source || IsNull(compiledFunctions))) {
+		_spareVM = vm;	// the next Compile runs on it
+		vm = nullptr;
+	}
+	if (IsNull(vm)) compiledFunctions = nullptr;
+	source = _source;
+	Error = Value::Null;
+	lastImplicitResult = Value::Null;
+	_pendingSource = nullptr;
+	Globals g = GetGlobals();
+	if (!IsNull(startFrom)) g.CopyFrom(startFrom);
+	else g.Clear();
+	if (!IsNull(vm)) vm.Reset(compiledFunctions, g);
+}
+void InterpreterStorage::Retire() {
+	if (!IsNull(vm)) vm.Idle();
+	ClearGlobals();
+	lastImplicitResult = Value::Null;
+	Error = Value::Null;
+}
+VM InterpreterStorage::TakeVM() {
+	VM result = _spareVM;
+	_spareVM = nullptr;
+	if (IsNull(result)) result =  VM::New();
+	return result;
+}
 void InterpreterStorage::Reset(List<FuncDef> functions) {
 	Interpreter _this(std::static_pointer_cast<InterpreterStorage>(shared_from_this()));
 	source = nullptr;
@@ -73,7 +109,7 @@ void InterpreterStorage::Reset(List<FuncDef> functions) {
 	}
 
 	// Create and configure VM
-	vm =  VM::New();
+	vm = TakeVM();
 	vm.SetInterpreter(_this);
 	vm.Reset(functions, GetGlobals());
 }
@@ -83,6 +119,17 @@ void InterpreterStorage::Compile() {
 
 	Error = Value::Null;
 
+	// A cached compile of this exact source skips parsing and code generation.
+	List<FuncDef> cached = BytecodeCache::Load(source, SourceFile, Boolean(false));
+	if (!IsNull(cached)) {
+		SimplifiedNodeCount = -1;
+		compiledFunctions = cached;
+		vm = TakeVM();
+		vm.SetInterpreter(_this);
+		vm.Reset(compiledFunctions, GetGlobals());
+		return;
+	}
+
 	if (IsNull(parser)) parser =  Parser::New();
 	parser.Init(source, SourceFile);
 	List<ASTNode> statements = parser.ParseProgram();
@@ -97,9 +144,7 @@ void InterpreterStorage::Compile() {
 	if (statements.Count() == 0) return;
 
 	// Simplify AST (constant folding, etc.)
-	for (Int32 i = 0; i < statements.Count(); i++) {
-		statements[i] = statements[i].Simplify();
-	}
+	SimplifiedNodeCount = ASTSimplifier::SimplifyAll(statements);
 
 	// Compile to bytecode (offset past intrinsics so indices don't collide)
 	BytecodeEmitter emitter =  BytecodeEmitter::New();
@@ -114,27 +159,34 @@ void InterpreterStorage::Compile() {
 	}
 
 	compiledFunctions = generator.GetFunctions();
+	BytecodeCache::Store(source, SourceFile, Boolean(false), compiledFunctions);
 
 	// Create and configure VM, running in this interpreter's namespace --
 	// which already holds anything a host seeded, or (via
 	// ResetPreservingGlobals) the outgoing program's globals.
-	vm =  VM::New();
+	vm = TakeVM();
 	vm.SetInterpreter(_this);
 	vm.Reset(compiledFunctions, GetGlobals());
 }
 FuncDef InterpreterStorage::CompileToFunc(String source,String fileName,Value* error) {
+	return CompileToFunc(source, fileName, nullptr, &*error);
+}
+FuncDef InterpreterStorage::CompileToFunc(String source,String fileName,List<ASTNode> parsed,Value* error) {
 	*error = Value::Null;
-	Parser parser =  Parser::New();
-	parser.Init(source, fileName);
-	List<ASTNode> statements = parser.ParseProgram();
-	parser.RequireComplete();   // a module file ends where it ends
-	if (parser.HadError()) {
-		*error = parser.Error();
-		return nullptr;
-	}
-	// Simplify AST (constant folding, etc.)
-	for (Int32 i = 0; i < statements.Count(); i++) {
-		statements[i] = statements[i].Simplify();
+	List<FuncDef> cached = BytecodeCache::Load(source, fileName, Boolean(true));
+	if (!IsNull(cached)) return cached[0];
+	List<ASTNode> statements = parsed;
+	if (IsNull(statements)) {
+		Parser parser =  Parser::New();
+		parser.Init(source, fileName);
+		statements = parser.ParseProgram();
+		parser.RequireComplete();   // a module file ends where it ends
+		if (parser.HadError()) {
+			*error = parser.Error();
+			return nullptr;
+		}
+		// Simplify AST (constant folding, etc.)
+		ASTSimplifier::SimplifyAll(statements);
 	}
 	BytecodeEmitter emitter =  BytecodeEmitter::New();
 	CodeGenerator generator =  CodeGenerator::New(emitter);
@@ -145,6 +197,7 @@ FuncDef InterpreterStorage::CompileToFunc(String source,String fileName,Value* e
 		return nullptr;
 	}
 	if (functions.Count() == 0) return nullptr;
+	BytecodeCache::Store(source, fileName, Boolean(true), functions);
 	return functions[0];   // the module's @main
 }
 Value InterpreterStorage::RunFunction(Value funcRef,List<Value> args) {
@@ -158,6 +211,12 @@ void InterpreterStorage::Restart() {
 	}
 }
 void InterpreterStorage::RunUntilDone(double timeLimit,bool returnEarly) {
+	RunFor(timeLimit, returnEarly, Boolean(false));
+}
+void InterpreterStorage::RunSlice(double timeLimit) {
+	RunFor(timeLimit, Boolean(true), Boolean(true));
+}
+void InterpreterStorage::RunFor(double timeLimit,bool returnEarly,bool returnOnWait) {
 	if (IsNull(vm)) {
 		Compile();
 		if (IsNull(vm)) return;		// (must have been some error)
@@ -174,6 +233,15 @@ void InterpreterStorage::RunUntilDone(double timeLimit,bool returnEarly) {
 			return;
 		}
 		if (returnEarly && vm.yielding()) return;		// waiting for something
+		// In a wait, sleep until it is due (or our time is up) rather than
+		// spinning on the VM.
+		double wake = vm.SecondsToWake();
+		if (returnOnWait && (wake > 0 || vm.IsBlocked())) return;
+		if (wake > 0) {
+			double left = timeLimit - (vm.ElapsedTime() - startTime);
+			if (wake > left) wake = left;
+			if (wake > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wake));
+		}
 	}
 }
 void InterpreterStorage::Step() {
@@ -231,9 +299,7 @@ void InterpreterStorage::REPL(String sourceLine,double timeLimit) {
 	}
 
 	// Simplify AST
-	for (Int32 i = 0; i < statements.Count(); i++) {
-		statements[i] = statements[i].Simplify();
-	}
+	SimplifiedNodeCount = ASTSimplifier::SimplifyAll(statements);
 
 	// Detect implicit output: last statement is a bare expression
 	// (not an assignment, block statement, break, continue, or return)
@@ -266,7 +332,7 @@ void InterpreterStorage::REPL(String sourceLine,double timeLimit) {
 	// Create/reset VM.  The namespace is the interpreter's, so it is the same
 	// one every line -- there is no first-line special case, and nothing is
 	// rebound onto the new @main's registers.
-	if (IsNull(vm)) vm =  VM::New();
+	if (IsNull(vm)) vm = TakeVM();
 	vm.SetInterpreter(_this);
 	vm.Reset(functions, GetGlobals());
 
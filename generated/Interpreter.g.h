@@ -18,6 +18,7 @@
 #include "IOHelper.g.h"
 #include "Bytecode.g.h"
 #include "CodeGenerator.g.h"
+#include "BytecodeCache.g.h"
 
 namespace MiniScript {
 typedef void* object;
@@ -36,9 +37,11 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	protected: Parser parser;
 	protected: List<FuncDef> compiledFunctions;
 	public: Value Error;
+	public: Int32 SimplifiedNodeCount = 0;
 	public: Value lastImplicitResult = Value::Null;
 	private: String _pendingSource; // accumulated REPL lines so far
 	private: Globals _globals;
+	private: VM _spareVM;
 
 	// 
 	// standardOutput: receives the output of the "print" intrinsic.
@@ -86,6 +89,13 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// to distinguish error types.
 	// 
 
+	// 
+	// How many AST nodes simplification (constant folding, dead-branch removal,
+	// and so on) removed from the most recently compiled source, or -1 if that
+	// source was loaded from the bytecode cache, so was not simplified here.
+	// Reported by the app under --debug.
+	// 
+
 	// 
 	// The Value produced by the last complete REPL interaction that had implicit
 	// output (a bare expression as the last statement), or Value.Null otherwise.
@@ -100,6 +110,9 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// REPL lines, across a program ending, and across chaining to a new program.
 	// Handed to each VM at Reset.  See notes/GLOBALS.md.
 
+	// A VM kept by Recycle for the next compile to run on, so that a new job
+	// does not have to allocate fresh register and call stacks; null if none.
+
   
 	// 
 	// Constructor taking some MiniScript source code, and the output delegates.
@@ -120,7 +133,21 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// `reset` intrinsic needs.
 	public: void ClearGlobals();
 
-	// 
+	// Make a new interpreter for the given source that starts where this one
+	// stands: its globals are a copy of ours (see Globals.Clone).  This is for
+	// hosts that run many short scripts against the same prelude -- run the
+	// prelude (imports, helper functions, classes) once in a template
+	// interpreter, then clone the template for each job, rather than compiling
+	// and running the prelude again every time.  Nothing the job does reaches
+	// the template, so it can be cloned again and again.
+	// Cloning is cheap in proportion to the prelude's mutable data; functions,
+	// strings and frozen lists and maps are shared, not copied.  The template
+	// should be idle (not partway through running) when cloned, and the clone
+	// belongs to the same thread, since it shares the template's heap.  The
+	// output delegates are the ones given here, as with the constructor;
+	// implicitOutput, hostData and SourceFile are carried over.
+	public: Interpreter Clone(String source, TextOutputMethod standardOutput=nullptr, TextOutputMethod errorOutput=nullptr);
+
 	// Constructor taking source code in the form of a list of strings.
 	// 
 	public: InterpreterStorage(List<String> sourceList, TextOutputMethod standardOutput=nullptr, TextOutputMethod errorOutput=nullptr);
@@ -155,6 +182,30 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// executing the rest of the abandoned program after the intrinsic returns.
 	public: void ResetPreservingGlobals(String _source="");
 
+	// Get ready to run the given source as a new job, unrelated to the last
+	// one, keeping whatever the last one built that a new job can use: the
+	// VM, with its register and call stacks; the parser; the global namespace
+	// object (emptied); and, when the source is the same as last time, the
+	// compiled code, so that no compile is needed at all.  If startFrom is
+	// given, the globals start as a copy of it (see Globals.CopyFrom) -- a
+	// prelude's, say -- and otherwise empty.  This is Reset for hosts that run
+	// job after job, usually through an InterpreterPool; in the steady state,
+	// with a source already seen and no prelude data to copy, it allocates
+	// nothing.
+	// Not for use while this interpreter is running (from an intrinsic, say):
+	// the VM it keeps may be the one running.  ResetPreservingGlobals is the
+	// way to chain from inside a program.
+	public: void Recycle(String _source, Globals startFrom=nullptr);
+
+	// Stop, and let go of everything the current job holds -- its globals'
+	// values, and whatever its VM's registers and frames still refer to -- so
+	// that an interpreter kept idle for Recycle does not keep that job's data
+	// from being collected.
+	public: void Retire();
+
+	// The VM for a new program: the one Recycle kept, if any, else a new one.
+	private: VM TakeVM();
+
 	// 
 	// Reset the interpreter with pre-compiled functions (e.g. from an assembler).
 	// The list must contain a FuncDef named "@main".
@@ -177,6 +228,11 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// and sets `error` to the error Value (Value.Null on success).
 	public: static FuncDef CompileToFunc(String source, String fileName, Value* error);
 
+	// As above, but `parsed` may give the source's statements already parsed
+	// and simplified (as by ImportPrefetch), so that only code generation is
+	// left to do here.  Pass null to parse the source as usual.
+	public: static FuncDef CompileToFunc(String source, String fileName, List<ASTNode> parsed, Value* error);
+
 	// Synchronously call a MiniScript function value with the given arguments,
 	// running the VM re-entrantly to completion, and return its result.  This is
 	// the host-facing entry point for calling back into MiniScript from native
@@ -210,6 +266,16 @@ class InterpreterStorage : public std::enable_shared_from_this<InterpreterStorag
 	// <param name="returnEarly">if true, return as soon as the VM yields</param>
 	public: void RunUntilDone(double timeLimit=60, bool returnEarly=Boolean(true));
 
+	// Run for at most timeLimit seconds, returning as soon as the script
+	// yields, starts a wait, or is left blocked in an intrinsic such as
+	// receive (or ends).  This is for a host that takes turns among many
+	// interpreters on one thread -- see Scheduler -- and so wants control
+	// back, rather than sleeping or spinning, when this one has nothing to
+	// do; vm.SecondsToWake then says when it next will.
+	public: void RunSlice(double timeLimit);
+
+	private: void RunFor(double timeLimit, bool returnEarly, bool returnOnWait);
+
 	// 
 	// Run one step (small batch) of the virtual machine.  This method is not
 	// very useful except in special cases; usually you will use RunUntilDone instead.
@@ -321,12 +387,16 @@ struct Interpreter {
 	protected: void set_compiledFunctions(List<FuncDef> _v);
 	public: Value Error();
 	public: void set_Error(Value _v);
+	public: Int32 SimplifiedNodeCount();
+	public: void set_SimplifiedNodeCount(Int32 _v);
 	public: Value lastImplicitResult();
 	public: void set_lastImplicitResult(Value _v);
 	private: String _pendingSource(); // accumulated REPL lines so far
 	private: void set__pendingSource(String _v); // accumulated REPL lines so far
 	private: Globals _globals();
 	private: void set__globals(Globals _v);
+	private: VM _spareVM();
+	private: void set__spareVM(VM _v);
 	public: Interpreter(InterpreterStorage* p) : storage(p ? p->shared_from_this() : nullptr) {}  
 
 	// 
@@ -375,6 +445,13 @@ struct Interpreter {
 	// to distinguish error types.
 	// 
 
+	// 
+	// How many AST nodes simplification (constant folding, dead-branch removal,
+	// and so on) removed from the most recently compiled source, or -1 if that
+	// source was loaded from the bytecode cache, so was not simplified here.
+	// Reported by the app under --debug.
+	// 
+
 	// 
 	// The Value produced by the last complete REPL interaction that had implicit
 	// output (a bare expression as the last statement), or Value.Null otherwise.
@@ -389,6 +466,9 @@ struct Interpreter {
 	// REPL lines, across a program ending, and across chaining to a new program.
 	// Handed to each VM at Reset.  See notes/GLOBALS.md.
 
+	// A VM kept by Recycle for the next compile to run on, so that a new job
+	// does not have to allocate fresh register and call stacks; null if none.
+
   
 	// 
 	// Constructor taking some MiniScript source code, and the output delegates.
@@ -411,7 +491,21 @@ struct Interpreter {
 	// `reset` intrinsic needs.
 	public: inline void ClearGlobals();
 
-	// 
+	// Make a new interpreter for the given source that starts where this one
+	// stands: its globals are a copy of ours (see Globals.Clone).  This is for
+	// hosts that run many short scripts against the same prelude -- run the
+	// prelude (imports, helper functions, classes) once in a template
+	// interpreter, then clone the template for each job, rather than compiling
+	// and running the prelude again every time.  Nothing the job does reaches
+	// the template, so it can be cloned again and again.
+	// Cloning is cheap in proportion to the prelude's mutable data; functions,
+	// strings and frozen lists and maps are shared, not copied.  The template
+	// should be idle (not partway through running) when cloned, and the clone
+	// belongs to the same thread, since it shares the template's heap.  The
+	// output delegates are the ones given here, as with the constructor;
+	// implicitOutput, hostData and SourceFile are carried over.
+	public: inline Interpreter Clone(String source, TextOutputMethod standardOutput=nullptr, TextOutputMethod errorOutput=nullptr);
+
 	// Constructor taking source code in the form of a list of strings.
 	// 
 	public: static Interpreter New(List<String> sourceList, TextOutputMethod standardOutput=nullptr, TextOutputMethod errorOutput=nullptr) {
@@ -448,6 +542,30 @@ struct Interpreter {
 	// executing the rest of the abandoned program after the intrinsic returns.
 	public: inline void ResetPreservingGlobals(String _source="");
 
+	// Get ready to run the given source as a new job, unrelated to the last
+	// one, keeping whatever the last one built that a new job can use: the
+	// VM, with its register and call stacks; the parser; the global namespace
+	// object (emptied); and, when the source is the same as last time, the
+	// compiled code, so that no compile is needed at all.  If startFrom is
+	// given, the globals start as a copy of it (see Globals.CopyFrom) -- a
+	// prelude's, say -- and otherwise empty.  This is Reset for hosts that run
+	// job after job, usually through an InterpreterPool; in the steady state,
+	// with a source already seen and no prelude data to copy, it allocates
+	// nothing.
+	// Not for use while this interpreter is running (from an intrinsic, say):
+	// the VM it keeps may be the one running.  ResetPreservingGlobals is the
+	// way to chain from inside a program.
+	public: inline void Recycle(String _source, Globals startFrom=nullptr);
+
+	// Stop, and let go of everything the current job holds -- its globals'
+	// values, and whatever its VM's registers and frames still refer to -- so
+	// that an interpreter kept idle for Recycle does not keep that job's data
+	// from being collected.
+	public: inline void Retire();
+
+	// The VM for a new program: the one Recycle kept, if any, else a new one.
+	private: inline VM TakeVM();
+
 	// 
 	// Reset the interpreter with pre-compiled functions (e.g. from an assembler).
 	// The list must contain a FuncDef named "@main".
@@ -470,6 +588,11 @@ struct Interpreter {
 	// and sets `error` to the error Value (Value.Null on success).
 	public: static FuncDef CompileToFunc(String source, String fileName, Value* error) { return InterpreterStorage::CompileToFunc(source, fileName, error); }
 
+	// As above, but `parsed` may give the source's statements already parsed
+	// and simplified (as by ImportPrefetch), so that only code generation is
+	// left to do here.  Pass null to parse the source as usual.
+	public: static FuncDef CompileToFunc(String source, String fileName, List<ASTNode> parsed, Value* error) { return InterpreterStorage::CompileToFunc(source, fileName, parsed, error); }
+
 	// Synchronously call a MiniScript function value with the given arguments,
 	// running the VM re-entrantly to completion, and return its result.  This is
 	// the host-facing entry point for calling back into MiniScript from native
@@ -503,6 +626,16 @@ struct Interpreter {
 	// <param name="returnEarly">if true, return as soon as the VM yields</param>
 	public: inline void RunUntilDone(double timeLimit=60, bool returnEarly=Boolean(true));
 
+	// Run for at most timeLimit seconds, returning as soon as the script
+	// yields, starts a wait, or is left blocked in an intrinsic such as
+	// receive (or ends).  This is for a host that takes turns among many
+	// interpreters on one thread -- see Scheduler -- and so wants control
+	// back, rather than sleeping or spinning, when this one has nothing to
+	// do; vm.SecondsToWake then says when it next will.
+	public: inline void RunSlice(double timeLimit);
+
+	private: inline void RunFor(double timeLimit, bool returnEarly, bool returnOnWait);
+
 	// 
 	// Run one step (small batch) of the virtual machine.  This method is not
 	// very useful except in special cases; usually you will use RunUntilDone instead.
@@ -604,23 +737,33 @@ inline List<FuncDef> Interpreter::compiledFunctions() { return get()->compiledFu
 inline void Interpreter::set_compiledFunctions(List<FuncDef> _v) { get()->compiledFunctions = _v; }
 inline Value Interpreter::Error() { return get()->Error; }
 inline void Interpreter::set_Error(Value _v) { get()->Error = _v; }
+inline Int32 Interpreter::SimplifiedNodeCount() { return get()->SimplifiedNodeCount; }
+inline void Interpreter::set_SimplifiedNodeCount(Int32 _v) { get()->SimplifiedNodeCount = _v; }
 inline Value Interpreter::lastImplicitResult() { return get()->lastImplicitResult; }
 inline void Interpreter::set_lastImplicitResult(Value _v) { get()->lastImplicitResult = _v; }
 inline String Interpreter::_pendingSource() { return get()->_pendingSource; } // accumulated REPL lines so far
 inline void Interpreter::set__pendingSource(String _v) { get()->_pendingSource = _v; } // accumulated REPL lines so far
 inline Globals Interpreter::_globals() { return get()->_globals; }
 inline void Interpreter::set__globals(Globals _v) { get()->_globals = _v; }
+inline VM Interpreter::_spareVM() { return get()->_spareVM; }
+inline void Interpreter::set__spareVM(VM _v) { get()->_spareVM = _v; }
 inline void Interpreter::Init(String _source,TextOutputMethod _standardOutput,TextOutputMethod _errorOutput) { return get()->Init(_source, _standardOutput, _errorOutput); }
 inline Globals Interpreter::GetGlobals() { return get()->GetGlobals(); }
 inline void Interpreter::ClearGlobals() { return get()->ClearGlobals(); }
+inline Interpreter Interpreter::Clone(String source,TextOutputMethod standardOutput,TextOutputMethod errorOutput) { return get()->Clone(source, standardOutput, errorOutput); }
 inline void Interpreter::Stop() { return get()->Stop(); }
 inline void Interpreter::Reset(String _source) { return get()->Reset(_source); }
 inline void Interpreter::ResetPreservingGlobals(String _source) { return get()->ResetPreservingGlobals(_source); }
+inline void Interpreter::Recycle(String _source,Globals startFrom) { return get()->Recycle(_source, startFrom); }
+inline void Interpreter::Retire() { return get()->Retire(); }
+inline VM Interpreter::TakeVM() { return get()->TakeVM(); }
 inline void Interpreter::Reset(List<FuncDef> functions) { return get()->Reset(functions); }
 inline void Interpreter::Compile() { return get()->Compile(); }
 inline Value Interpreter::RunFunction(Value funcRef,List<Value> args) { return get()->RunFunction(funcRef, args); }
 inline void Interpreter::Restart() { return get()->Restart(); }
 inline void Interpreter::RunUntilDone(double timeLimit,bool returnEarly) { return get()->RunUntilDone(timeLimit, returnEarly); }
+inline void Interpreter::RunSlice(double timeLimit) { return get()->RunSlice(timeLimit); }
+inline void Interpreter::RunFor(double timeLimit,bool returnEarly,bool returnOnWait) { return get()->RunFor(timeLimit, returnEarly, returnOnWait); }
 inline void Interpreter::Step() { return get()->Step(); }
 inline void Interpreter::REPL(String sourceLine,double timeLimit) { return get()->REPL(sourceLine, timeLimit); }
 inline bool Interpreter::Running() { return get()->Running(); }
@@ -0,0 +1,43 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: InterpreterPool.cs
+
+#include "InterpreterPool.g.h"
+
+namespace MiniScript {
+
+InterpreterPoolStorage::InterpreterPoolStorage(Interpreter prelude) {
+	_idle =  List<Interpreter>::New();
+	_prelude = prelude;
+	standardOutput = nullptr;
+	errorOutput = nullptr;
+}
+Interpreter InterpreterPoolStorage::Lease(String source) {
+	Interpreter interp;
+	if (_idle.Count() > 0) {
+		interp = _idle[_idle.Count() - 1];
+		_idle.RemoveAt(_idle.Count() - 1);
+	} else {
+		interp =  Interpreter::New("", standardOutput, errorOutput);
+		if (!IsNull(_prelude)) {
+			interp.set_SourceFile(_prelude.SourceFile());
+			interp.set_hostData(_prelude.hostData());
+		}
+	}
+	Globals startFrom = nullptr;
+	if (!IsNull(_prelude)) startFrom = _prelude.GetGlobals();
+	interp.Recycle(source, startFrom);
+	return interp;
+}
+void InterpreterPoolStorage::Return(Interpreter interp) {
+	interp.Retire();
+	_idle.Add(interp);
+}
+Int32 InterpreterPoolStorage::IdleCount() {
+	return _idle.Count();
+}
+void InterpreterPoolStorage::Clear() {
+	for (Int32 i = 0; i < _idle.Count(); i++) _idle[i].Reset("");	// (releases its globals)
+	_idle.Clear();
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,119 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: InterpreterPool.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// InterpreterPool.cs
+// A pool of interpreters for hosts that run one short script after another
+// (a job per request, say).  Making an Interpreter for each job costs a VM --
+// a 10240-slot register stack and a 256-slot call stack -- plus a parser, a
+// global namespace and a compile.  Lease hands out an interpreter that an
+// earlier job has Returned, Recycled for the new source, so all of that is
+// reused: in the steady state, running a job whose source the interpreter
+// has run before needs no compile and no allocation beyond what the script
+// itself does.
+// A pool may be given a prelude: an interpreter that has already run the
+// code every job needs (imports, helper functions, classes).  Each leased
+// interpreter then starts with a copy of the prelude's globals, as with
+// Interpreter.Clone, and the prelude itself is never changed by a job.
+// Everything here belongs to one thread, like the heap it works on (see
+// GCManager).  A host with several threads keeps a pool on each.
+
+#include "Interpreter.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class InterpreterPoolStorage : public std::enable_shared_from_this<InterpreterPoolStorage> {
+	friend struct InterpreterPool;
+	private: List<Interpreter> _idle; // Returned, and ready to Lease again
+	private: Interpreter _prelude; // whose globals each job starts from, or null
+	public: TextOutputMethod standardOutput = nullptr;
+	public: TextOutputMethod errorOutput = nullptr;
+
+	// Output delegates given to every interpreter the pool makes.  A host
+	// that wants a job's output kept apart may set them on the leased
+	// interpreter instead; they are left as they are on Return.
+
+	public: InterpreterPoolStorage(Interpreter prelude=nullptr);
+
+	// An interpreter ready to run the given source (call RunUntilDone), with
+	// fresh globals -- or a fresh copy of the prelude's.  Hand it back with
+	// Return when the job is over.
+	public: Interpreter Lease(String source);
+
+	// Take back an interpreter from Lease.  Its job is stopped if it is still
+	// running, and what the job held is let go (see Interpreter.Retire); the
+	// interpreter must not be used again until it is leased again.
+	public: void Return(Interpreter interp);
+
+	// How many interpreters are waiting to be leased.
+	public: Int32 IdleCount();
+
+	// Drop every idle interpreter (and the memory its VM holds).
+	public: void Clear();
+}; // end of class InterpreterPoolStorage
+
+struct InterpreterPool {
+	friend class InterpreterPoolStorage;
+	protected: std::shared_ptr<InterpreterPoolStorage> storage;
+  public:
+	InterpreterPool(std::shared_ptr<InterpreterPoolStorage> stor) : storage(stor) {}
+	InterpreterPool() : storage(nullptr) {}
+	InterpreterPool(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const InterpreterPool& inst) { return inst.storage == nullptr; }
+	private: InterpreterPoolStorage* get() const;
+
+	private: List<Interpreter> _idle(); // Returned, and ready to Lease again
+	private: void set__idle(List<Interpreter> _v); // Returned, and ready to Lease again
+	private: Interpreter _prelude(); // whose globals each job starts from, or null
+	private: void set__prelude(Interpreter _v); // whose globals each job starts from, or null
+	public: TextOutputMethod standardOutput();
+	public: void set_standardOutput(TextOutputMethod _v);
+	public: TextOutputMethod errorOutput();
+	public: void set_errorOutput(TextOutputMethod _v);
+
+	// Output delegates given to every interpreter the pool makes.  A host
+	// that wants a job's output kept apart may set them on the leased
+	// interpreter instead; they are left as they are on Return.
+
+	public: static InterpreterPool New(Interpreter prelude=nullptr) {
+		return InterpreterPool(std::make_shared<InterpreterPoolStorage>(prelude));
+	}
+
+	// An interpreter ready to run the given source (call RunUntilDone), with
+	// fresh globals -- or a fresh copy of the prelude's.  Hand it back with
+	// Return when the job is over.
+	public: inline Interpreter Lease(String source);
+
+	// Take back an interpreter from Lease.  Its job is stopped if it is still
+	// running, and what the job held is let go (see Interpreter.Retire); the
+	// interpreter must not be used again until it is leased again.
+	public: inline void Return(Interpreter interp);
+
+	// How many interpreters are waiting to be leased.
+	public: inline Int32 IdleCount();
+
+	// Drop every idle interpreter (and the memory its VM holds).
+	public: inline void Clear();
+}; // end of struct InterpreterPool
+
+// INLINE METHODS
+
+inline InterpreterPoolStorage* InterpreterPool::get() const { return static_cast<InterpreterPoolStorage*>(storage.get()); }
+inline List<Interpreter> InterpreterPool::_idle() { return get()->_idle; } // Returned, and ready to Lease again
+inline void InterpreterPool::set__idle(List<Interpreter> _v) { get()->_idle = _v; } // Returned, and ready to Lease again
+inline Interpreter InterpreterPool::_prelude() { return get()->_prelude; } // whose globals each job starts from, or null
+inline void InterpreterPool::set__prelude(Interpreter _v) { get()->_prelude = _v; } // whose globals each job starts from, or null
+inline TextOutputMethod InterpreterPool::standardOutput() { return get()->standardOutput; }
+inline void InterpreterPool::set_standardOutput(TextOutputMethod _v) { get()->standardOutput = _v; }
+inline TextOutputMethod InterpreterPool::errorOutput() { return get()->errorOutput; }
+inline void InterpreterPool::set_errorOutput(TextOutputMethod _v) { get()->errorOutput = _v; }
+inline Interpreter InterpreterPool::Lease(String source) { return get()->Lease(source); }
+inline void InterpreterPool::Return(Interpreter interp) { return get()->Return(interp); }
+inline Int32 InterpreterPool::IdleCount() { return get()->IdleCount(); }
+inline void InterpreterPool::Clear() { return get()->Clear(); }
+
+} // end of namespace MiniScript
@@ -6,12 +6,12 @@
 
 namespace MiniScript {
 
-List<Intrinsic> IntrinsicStorage::_all =  List<Intrinsic>::New();
-Dictionary<String, Intrinsic> IntrinsicStorage::_byName =  Dictionary<String, Intrinsic>::New();
-Boolean IntrinsicStorage::_initialized = Boolean(false);
-Boolean IntrinsicStorage::_markCallbackRegistered = Boolean(false);
-List<Value> IntrinsicStorage::_shortNameKeys =  List<Value>::New();
-List<String> IntrinsicStorage::_shortNameVals =  List<String>::New();
+	thread_local List<Intrinsic> IntrinsicStorage::_all;
+	thread_local Dictionary<String, Intrinsic> IntrinsicStorage::_byName;
+	thread_local Boolean IntrinsicStorage::_initialized;
+	thread_local Boolean IntrinsicStorage::_definingCore;
+	thread_local List<Value> IntrinsicStorage::_shortNameKeys;
+	thread_local List<String> IntrinsicStorage::_shortNameVals;
 void IntrinsicStorage::MarkRoots(object user_data) {
 	for (Int32 i = 0; i < _all.Count(); i++) {
 		List<Value> defaults = _all[i]._paramDefaults();
@@ -19,37 +19,48 @@ void IntrinsicStorage::MarkRoots(object user_data) {
 	}
 	for (Int32 i = 0; i < _shortNameKeys.Count(); i++) GCManager::Mark(_shortNameKeys[i]);
 }
-void IntrinsicStorage::EnsureMarkCallback() {
-	if (_markCallbackRegistered) return;
-	_markCallbackRegistered = Boolean(true);
+void IntrinsicStorage::EnsureRegistry() {
+	if (!IsNull(_all)) return;
+	_all =  List<Intrinsic>::New();
+	_byName =  Dictionary<String, Intrinsic>::New();
+	_shortNameKeys =  List<Value>::New();
+	_shortNameVals =  List<String>::New();
 	GCManager::RegisterMarkCallback(Intrinsic::MarkRoots, nullptr);
 }
 void IntrinsicStorage::AddShortName(Value v,String name) {
-	EnsureMarkCallback();
+	EnsureRegistry();
 	_shortNameKeys.Add(v);
 	_shortNameVals.Add(name);
 }
 void IntrinsicStorage::ClearShortNames() {
+	if (IsNull(_shortNameKeys)) return;
 	_shortNameKeys.Clear();
 	_shortNameVals.Clear();
 }
 String IntrinsicStorage::GetShortName(Value v) {
+	if (IsNull(_shortNameKeys)) return nullptr;
 	for (Int32 i = 0; i < _shortNameKeys.Count(); i++) {
 		if (_shortNameKeys[i].RefEquals(v)) return _shortNameVals[i];
 	}
 	return nullptr;
 }
+void IntrinsicStorage::EnsureInitialized() {
+	if (_initialized) return;
+	_definingCore = Boolean(true);
+	CoreIntrinsics::Init();
+	_definingCore = Boolean(false);
+	_initialized = Boolean(true);
+}
 Int32 IntrinsicStorage::Count() {
-	if (!_initialized) {
-		CoreIntrinsics::Init();
-		_initialized = Boolean(true);
-	}
+	EnsureInitialized();
 	return _all.Count();
 }
 Intrinsic IntrinsicStorage::Create(String name) {
-	EnsureMarkCallback();
+	EnsureRegistry();
 	Intrinsic result =  Intrinsic::New();
 	result.set_Name(name);
+	result.set_Index(_all.Count());
+	result.set_Core(_definingCore);
 	result.set__paramNames( List<String>::New());
 	result.set__paramDefaults( List<Value>::New());
 	_all.Add(result);
@@ -65,6 +76,7 @@ void IntrinsicStorage::AddParam(String name,Value defaultValue) {
 	_paramDefaults.Add(defaultValue);
 }
 Intrinsic IntrinsicStorage::GetByName(String name) {
+	if (IsNull(_byName)) return nullptr;
 	Intrinsic result;
 	if (_byName.TryGetValue(name, &result)) return result;
 	return nullptr;
@@ -72,6 +84,12 @@ Intrinsic IntrinsicStorage::GetByName(String name) {
 Intrinsic IntrinsicStorage::GetByIndex(Int32 i) {
 	return _all[i];
 }
+Int32 IntrinsicStorage::DirectCallIndex(String name) {
+	EnsureInitialized();
+	Intrinsic intr = GetByName(name);
+	if (IsNull(intr) || !intr.Core() || IsNull(intr.SimpleCode())) return -1;
+	return intr.Index();
+}
 void IntrinsicStorage::EnsureBuilt() {
 	if (IsNull(_funcDef)) {
 		_funcDef = BuildFuncDef();
@@ -87,18 +105,22 @@ FuncDef IntrinsicStorage::BuildFuncDef() {
 	FuncDef def =  FuncDef::New();
 	def.set_Name(Name);
 	for (Int32 i = 0; i < _paramNames.Count(); i++) {
-		def.ParamNames().Add(Value::make_string(_paramNames[i]));
+		def.ParamNames().Add(Value::make_interned_string(_paramNames[i]));
 		def.ParamDefaults().Add(_paramDefaults[i]);
 	}
 	def.set_MaxRegs((UInt16)(_paramNames.Count() + 1)); // r0 + params
 	def.set_NativeCallback(Code);
+	if (!IsNull(SimpleCode)) {
+		def.set_SimpleCallback(SimpleCode);
+		def.set_NativeCallback(SimpleMarker);
+	}
 	return def;
 }
+IntrinsicResult IntrinsicStorage::SimpleMarker(Context context,IntrinsicResult partialResult) {
+	return IntrinsicResult::Null;
+}
 void IntrinsicStorage::RegisterAll(Dictionary<String, Value> intrinsics) {
-	if (!_initialized) {
-		CoreIntrinsics::Init();
-		_initialized = Boolean(true);
-	}
+	EnsureInitialized();
 	intrinsics.Clear();
 	for (Int32 i = 0; i < _all.Count(); i++) {
 		Intrinsic intr = _all[i];
@@ -9,9 +9,18 @@
 //   f = Intrinsic.Create("name");
 //   f.AddParam("paramName", defaultValue);
 //   f.Code = (stk, bi, ac) => { ... };
+// An intrinsic that always finishes at once, and needs nothing from the VM
+// but its arguments, can instead be defined as a simple intrinsic:
+//   f.SimpleCode = (Span<Value> args, Int32 argCount) => { ... };
+// which gets its arguments in place (a raw Value* in C++) and returns its
+// result directly.  The VM calls it without making a Context or an
+// IntrinsicResult for each call, which is worth it for the hottest ones.
+// A simple intrinsic reports an error through VM.ActiveVM(), and must not
+// use Value.c_str (its call is not bracketed by a CStrArena mark).
 
 #include "value.h"
 #include "FuncDef.g.h"
+#include "IntrinsicAPI.g.h"
 
 namespace MiniScript {
 
@@ -21,16 +30,27 @@ class IntrinsicStorage : public std::enable_shared_from_this<IntrinsicStorage> {
 	friend struct Intrinsic;
 	public: String Name;
 	public: NativeCallbackDelegate Code;
+	public: SimpleCallbackDelegate SimpleCode = nullptr;
+	public: Int32 Index = -1;
+	public: Boolean Core = Boolean(false);
 	private: List<String> _paramNames;
 	private: List<Value> _paramDefaults;
 	private: FuncDef _funcDef = nullptr;
 	private: Value _funcRef = Value::Null;
-	private: static List<Intrinsic> _all;
-	private: static Dictionary<String, Intrinsic> _byName;
-	private: static Boolean _initialized;
-	private: static Boolean _markCallbackRegistered;
-	private: static List<Value> _shortNameKeys;
-	private: static List<String> _shortNameVals;
+	private: thread_local static List<Intrinsic> _all;
+	private: thread_local static Dictionary<String, Intrinsic> _byName;
+	private: thread_local static Boolean _initialized;
+	private: thread_local static Boolean _definingCore;
+	private: thread_local static List<Value> _shortNameKeys;
+	private: thread_local static List<String> _shortNameVals;
+
+	// Position in the registry (see GetByIndex), and whether this is one of
+	// the built-ins defined by CoreIntrinsics.Init, which every thread defines
+	// in the same order.
+
+	// The registry is per thread, like the GC heap its funcrefs live in (see
+	// GCManager): each isolate defines and builds its own set of intrinsics.
+	// Made on first use on each thread (see EnsureRegistry).
 
 	// Short-name registry: maps known Values (e.g. type maps) to display names.
 
@@ -38,10 +58,10 @@ class IntrinsicStorage : public std::enable_shared_from_this<IntrinsicStorage> {
 	// intrinsic is *defined*, which is long before the first VM exists; without
 	// this they are unreachable until EnsureBuilt copies them into a FuncDef and
 	// roots the funcref, and any collection in that window frees them out from
-	// under us.  Registered on first use (see EnsureMarkCallback).
+	// under us.  Registered on first use (see EnsureRegistry).
 	public: static void MarkRoots(object user_data);
 
-	private: static void EnsureMarkCallback();
+	private: static void EnsureRegistry();
 
 	public: static void AddShortName(Value v, String name);
 
@@ -50,6 +70,8 @@ class IntrinsicStorage : public std::enable_shared_from_this<IntrinsicStorage> {
 	public: static String GetShortName(Value v);
 	public: IntrinsicStorage() {}
 
+	private: static void EnsureInitialized();
+
 	// Return the number of intrinsics (initializing them if needed).
 	public: static Int32 Count();
 
@@ -63,9 +85,15 @@ class IntrinsicStorage : public std::enable_shared_from_this<IntrinsicStorage> {
 
 	public: static Intrinsic GetByIndex(Int32 i);
 
+	// The index of the intrinsic with the given name, if a call to it may be
+	// compiled to CALLINTRINSIC, or else -1.  That takes a simple, built-in
+	// intrinsic: the VM calls it straight from its registry index, so the
+	// index must mean the same thing on every thread the code may run on.
+	public: static Int32 DirectCallIndex(String name);
+
 	// Build (once) this intrinsic's FuncDef and a stable funcref Value.
 	// The funcref is added as a permanent GC root: intrinsics live for the
-	// lifetime of the process and are shared across VMs and resets.
+	// lifetime of the thread and are shared across its VMs and resets.
 	private: void EnsureBuilt();
 
 	public: Value GetFunc();
@@ -73,8 +101,14 @@ class IntrinsicStorage : public std::enable_shared_from_this<IntrinsicStorage> {
 	// Build a FuncDef from this intrinsic's definition.
 	public: FuncDef BuildFuncDef();
 
+	// The NativeCallback of a simple intrinsic's FuncDef.  It is never called
+	// (the VM calls the SimpleCallback instead), but a FuncDef with a
+	// NativeCallback is how the rest of the code knows a native function.
+	private: static IntrinsicResult SimpleMarker(Context context, IntrinsicResult partialResult);
+
 	// Populate the VM's intrinsics name->funcref table.  Intrinsic FuncDefs and
-	// their funcref Values are built once (lazily) and shared across all VMs.
+	// their funcref Values are built once (lazily) and shared across all VMs
+	// on this thread.
 	public: static void RegisterAll(Dictionary<String, Value> intrinsics);
 }; // end of class IntrinsicStorage
 
@@ -92,6 +126,12 @@ struct Intrinsic {
 	public: void set_Name(String _v);
 	public: NativeCallbackDelegate Code();
 	public: void set_Code(NativeCallbackDelegate _v);
+	public: SimpleCallbackDelegate SimpleCode();
+	public: void set_SimpleCode(SimpleCallbackDelegate _v);
+	public: Int32 Index();
+	public: void set_Index(Int32 _v);
+	public: Boolean Core();
+	public: void set_Core(Boolean _v);
 	private: List<String> _paramNames();
 	private: void set__paramNames(List<String> _v);
 	private: List<Value> _paramDefaults();
@@ -106,23 +146,31 @@ struct Intrinsic {
 	private: void set__byName(Dictionary<String, Intrinsic> _v);
 	private: Boolean _initialized();
 	private: void set__initialized(Boolean _v);
-	private: Boolean _markCallbackRegistered();
-	private: void set__markCallbackRegistered(Boolean _v);
+	private: Boolean _definingCore();
+	private: void set__definingCore(Boolean _v);
 	private: List<Value> _shortNameKeys();
 	private: void set__shortNameKeys(List<Value> _v);
 	private: List<String> _shortNameVals();
 	private: void set__shortNameVals(List<String> _v);
 
+	// Position in the registry (see GetByIndex), and whether this is one of
+	// the built-ins defined by CoreIntrinsics.Init, which every thread defines
+	// in the same order.
+
+	// The registry is per thread, like the GC heap its funcrefs live in (see
+	// GCManager): each isolate defines and builds its own set of intrinsics.
+	// Made on first use on each thread (see EnsureRegistry).
+
 	// Short-name registry: maps known Values (e.g. type maps) to display names.
 
 	// Mark the Values this class owns.  Parameter defaults are created when an
 	// intrinsic is *defined*, which is long before the first VM exists; without
 	// this they are unreachable until EnsureBuilt copies them into a FuncDef and
 	// roots the funcref, and any collection in that window frees them out from
-	// under us.  Registered on first use (see EnsureMarkCallback).
+	// under us.  Registered on first use (see EnsureRegistry).
 	public: static void MarkRoots(object user_data) { return IntrinsicStorage::MarkRoots(user_data); }
 
-	private: static void EnsureMarkCallback() { return IntrinsicStorage::EnsureMarkCallback(); }
+	private: static void EnsureRegistry() { return IntrinsicStorage::EnsureRegistry(); }
 
 	public: static void AddShortName(Value v, String name) { return IntrinsicStorage::AddShortName(v, name); }
 
@@ -133,6 +181,8 @@ struct Intrinsic {
 		return Intrinsic(std::make_shared<IntrinsicStorage>());
 	}
 
+	private: static void EnsureInitialized() { return IntrinsicStorage::EnsureInitialized(); }
+
 	// Return the number of intrinsics (initializing them if needed).
 	public: static Int32 Count() { return IntrinsicStorage::Count(); }
 
@@ -146,9 +196,15 @@ struct Intrinsic {
 
 	public: static Intrinsic GetByIndex(Int32 i) { return IntrinsicStorage::GetByIndex(i); }
 
+	// The index of the intrinsic with the given name, if a call to it may be
+	// compiled to CALLINTRINSIC, or else -1.  That takes a simple, built-in
+	// intrinsic: the VM calls it straight from its registry index, so the
+	// index must mean the same thing on every thread the code may run on.
+	public: static Int32 DirectCallIndex(String name) { return IntrinsicStorage::DirectCallIndex(name); }
+
 	// Build (once) this intrinsic's FuncDef and a stable funcref Value.
 	// The funcref is added as a permanent GC root: intrinsics live for the
-	// lifetime of the process and are shared across VMs and resets.
+	// lifetime of the thread and are shared across its VMs and resets.
 	private: inline void EnsureBuilt();
 
 	public: inline Value GetFunc();
@@ -156,8 +212,14 @@ struct Intrinsic {
 	// Build a FuncDef from this intrinsic's definition.
 	public: inline FuncDef BuildFuncDef();
 
+	// The NativeCallback of a simple intrinsic's FuncDef.  It is never called
+	// (the VM calls the SimpleCallback instead), but a FuncDef with a
+	// NativeCallback is how the rest of the code knows a native function.
+	private: static IntrinsicResult SimpleMarker(Context context, IntrinsicResult partialResult) { return IntrinsicStorage::SimpleMarker(context, partialResult); }
+
 	// Populate the VM's intrinsics name->funcref table.  Intrinsic FuncDefs and
-	// their funcref Values are built once (lazily) and shared across all VMs.
+	// their funcref Values are built once (lazily) and shared across all VMs
+	// on this thread.
 	public: static void RegisterAll(Dictionary<String, Value> intrinsics) { return IntrinsicStorage::RegisterAll(intrinsics); }
 }; // end of struct Intrinsic
 
@@ -168,6 +230,12 @@ inline String Intrinsic::Name() { return get()->Name; }
 inline void Intrinsic::set_Name(String _v) { get()->Name = _v; }
 inline NativeCallbackDelegate Intrinsic::Code() { return get()->Code; }
 inline void Intrinsic::set_Code(NativeCallbackDelegate _v) { get()->Code = _v; }
+inline SimpleCallbackDelegate Intrinsic::SimpleCode() { return get()->SimpleCode; }
+inline void Intrinsic::set_SimpleCode(SimpleCallbackDelegate _v) { get()->SimpleCode = _v; }
+inline Int32 Intrinsic::Index() { return get()->Index; }
+inline void Intrinsic::set_Index(Int32 _v) { get()->Index = _v; }
+inline Boolean Intrinsic::Core() { return get()->Core; }
+inline void Intrinsic::set_Core(Boolean _v) { get()->Core = _v; }
 inline List<String> Intrinsic::_paramNames() { return get()->_paramNames; }
 inline void Intrinsic::set__paramNames(List<String> _v) { get()->_paramNames = _v; }
 inline List<Value> Intrinsic::_paramDefaults() { return get()->_paramDefaults; }
@@ -182,8 +250,8 @@ inline Dictionary<String, Intrinsic> Intrinsic::_byName() { return get()->_byNam
 inline void Intrinsic::set__byName(Dictionary<String, Intrinsic> _v) { get()->_byName = _v; }
 inline Boolean Intrinsic::_initialized() { return get()->_initialized; }
 inline void Intrinsic::set__initialized(Boolean _v) { get()->_initialized = _v; }
-inline Boolean Intrinsic::_markCallbackRegistered() { return get()->_markCallbackRegistered; }
-inline void Intrinsic::set__markCallbackRegistered(Boolean _v) { get()->_markCallbackRegistered = _v; }
+inline Boolean Intrinsic::_definingCore() { return get()->_definingCore; }
+inline void Intrinsic::set__definingCore(Boolean _v) { get()->_definingCore = _v; }
 inline List<Value> Intrinsic::_shortNameKeys() { return get()->_shortNameKeys; }
 inline void Intrinsic::set__shortNameKeys(List<Value> _v) { get()->_shortNameKeys = _v; }
 inline List<String> Intrinsic::_shortNameVals() { return get()->_shortNameVals; }
@@ -0,0 +1,69 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: IsolateFunction.cs
+
+#include "IsolateFunction.g.h"
+#include "GCManager.g.h"
+
+namespace MiniScript {
+
+IsolateFunctionStorage::IsolateFunctionStorage() {
+}
+IsolateFunction IsolateFunctionStorage::Pack(Value func) {
+	IsolateFunction result =  IsolateFunction::New();
+	result._defs().Add(func.FunctionDef());
+	for (Int32 d = 0; d < result._defs().Count(); d++) {	// (_defs grows as nested functions turn up)
+		FuncDef def = result._defs()[d];
+		if (!IsNull(def.NativeCallback())) return nullptr;
+		def.EnsureConstants();
+		Value constants = Value::make_list(def.Constants().Count());
+		for (Int32 i = 0; i < def.Constants().Count(); i++) {
+			Value c = def.Constants()[i];
+			if (c.IsFuncRef()) {
+				result._templateOwner().Add(d);
+				result._templateIndex().Add(i);
+				result._templateDef().Add(result._defs().Count());
+				result._defs().Add(c.FunctionDef());
+				c = Value::Null;
+			}
+			constants.Push(c);
+		}
+		Value values = Value::make_list(4);
+		values.Push(constants);
+		values.Push(ListOf(def.ParamNames()));
+		values.Push(ListOf(def.ParamDefaults()));
+		values.Push(ListOf(def.GlobalNames()));
+		ChannelMessage msg = ChannelMessage::Pack(values);
+		if (IsNull(msg)) return nullptr;
+		result._values().Add(msg);
+	}
+	return result;
+}
+Value IsolateFunctionStorage::Unpack() {
+	List<FuncDef> copies =  List<FuncDef>::New();
+	for (Int32 d = 0; d < _defs.Count(); d++) {
+		FuncDef copy = _defs[d].CopyForIsolate();
+		Value values = _values[d].Unpack();
+		Value list = values.ListGet(0);
+		for (Int32 i = 0; i < list.ListCount(); i++) copy.Constants().Add(list.ListGet(i));
+		list = values.ListGet(1);
+		for (Int32 i = 0; i < list.ListCount(); i++) copy.ParamNames().Add(list.ListGet(i));
+		list = values.ListGet(2);
+		for (Int32 i = 0; i < list.ListCount(); i++) copy.ParamDefaults().Add(list.ListGet(i));
+		list = values.ListGet(3);
+		for (Int32 i = 0; i < list.ListCount(); i++) copy.AddGlobalRef(list.ListGet(i));
+		copies.Add(copy);
+	}
+	for (Int32 t = 0; t < _templateOwner.Count(); t++) {
+		Int32 owner = _templateOwner[t];
+		Int32 child = _templateDef[t];
+		copies[owner].Constants()[_templateIndex[t]] = Value::make_funcref(copies[child], Value::Null);
+	}
+	return Value::make_funcref(copies[0], Value::Null);
+}
+Value IsolateFunctionStorage::ListOf(List<Value> items) {
+	Value result = Value::make_list(items.Count());
+	for (Int32 i = 0; i < items.Count(); i++) result.Push(items[i]);
+	return result;
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,105 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: IsolateFunction.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// IsolateFunction.cs
+// A script function packed to run in another isolate (see ParallelMap).
+// Code is never changed once built, so the copy shares it; the Values a
+// function holds -- constants, parameter names and defaults, global names
+// -- are on its own isolate's heap, so they travel as a ChannelMessage and
+// are made again on the other side.  Nested functions (the templates among
+// the constants) go along, the same way.  The function's outer variables
+// do not: the rebuilt function has none.
+
+#include "Channel.g.h"
+#include "FuncDef.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class IsolateFunctionStorage : public std::enable_shared_from_this<IsolateFunctionStorage> {
+	friend struct IsolateFunction;
+	private: List<FuncDef> _defs = List<FuncDef>::New(); // the function, then those nested in it
+	private: List<ChannelMessage> _values = List<ChannelMessage>::New(); // per def: [constants, param names, param defaults, global names]
+	private: List<Int32> _templateOwner = List<Int32>::New();
+	private: List<Int32> _templateIndex = List<Int32>::New();
+	private: List<Int32> _templateDef = List<Int32>::New();
+
+	// Nested-function templates among the constants (sent as null): for
+	// each, the def whose constant it is, the constant's index, and the def
+	// it refers to.
+
+	public: IsolateFunctionStorage();
+
+	// The function `func` refers to, ready to send; or null if it is an
+	// intrinsic, or holds a constant that cannot be sent.
+	public: static IsolateFunction Pack(Value func);
+
+	// The function, made on the calling thread's heap, as a funcref with no
+	// outer variables.  Safe to call from any number of threads at once.
+	public: Value Unpack();
+
+	private: static Value ListOf(List<Value> items);
+}; // end of class IsolateFunctionStorage
+
+// The FuncDef of a function and of each function nested in it, with the
+// Values each one holds packed in a message.
+struct IsolateFunction {
+	friend class IsolateFunctionStorage;
+	protected: std::shared_ptr<IsolateFunctionStorage> storage;
+  public:
+	IsolateFunction(std::shared_ptr<IsolateFunctionStorage> stor) : storage(stor) {}
+	IsolateFunction() : storage(nullptr) {}
+	IsolateFunction(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const IsolateFunction& inst) { return inst.storage == nullptr; }
+	private: IsolateFunctionStorage* get() const;
+
+	private: List<FuncDef> _defs(); // the function, then those nested in it
+	private: void set__defs(List<FuncDef> _v); // the function, then those nested in it
+	private: List<ChannelMessage> _values(); // per def: [constants, param names, param defaults, global names]
+	private: void set__values(List<ChannelMessage> _v); // per def: [constants, param names, param defaults, global names]
+	private: List<Int32> _templateOwner();
+	private: void set__templateOwner(List<Int32> _v);
+	private: List<Int32> _templateIndex();
+	private: void set__templateIndex(List<Int32> _v);
+	private: List<Int32> _templateDef();
+	private: void set__templateDef(List<Int32> _v);
+
+	// Nested-function templates among the constants (sent as null): for
+	// each, the def whose constant it is, the constant's index, and the def
+	// it refers to.
+
+	public: static IsolateFunction New() {
+		return IsolateFunction(std::make_shared<IsolateFunctionStorage>());
+	}
+
+	// The function `func` refers to, ready to send; or null if it is an
+	// intrinsic, or holds a constant that cannot be sent.
+	public: static IsolateFunction Pack(Value func) { return IsolateFunctionStorage::Pack(func); }
+
+	// The function, made on the calling thread's heap, as a funcref with no
+	// outer variables.  Safe to call from any number of threads at once.
+	public: inline Value Unpack();
+
+	private: static Value ListOf(List<Value> items) { return IsolateFunctionStorage::ListOf(items); }
+}; // end of struct IsolateFunction
+
+// INLINE METHODS
+
+inline IsolateFunctionStorage* IsolateFunction::get() const { return static_cast<IsolateFunctionStorage*>(storage.get()); }
+inline List<FuncDef> IsolateFunction::_defs() { return get()->_defs; } // the function, then those nested in it
+inline void IsolateFunction::set__defs(List<FuncDef> _v) { get()->_defs = _v; } // the function, then those nested in it
+inline List<ChannelMessage> IsolateFunction::_values() { return get()->_values; } // per def: [constants, param names, param defaults, global names]
+inline void IsolateFunction::set__values(List<ChannelMessage> _v) { get()->_values = _v; } // per def: [constants, param names, param defaults, global names]
+inline List<Int32> IsolateFunction::_templateOwner() { return get()->_templateOwner; }
+inline void IsolateFunction::set__templateOwner(List<Int32> _v) { get()->_templateOwner = _v; }
+inline List<Int32> IsolateFunction::_templateIndex() { return get()->_templateIndex; }
+inline void IsolateFunction::set__templateIndex(List<Int32> _v) { get()->_templateIndex = _v; }
+inline List<Int32> IsolateFunction::_templateDef() { return get()->_templateDef; }
+inline void IsolateFunction::set__templateDef(List<Int32> _v) { get()->_templateDef = _v; }
+inline Value IsolateFunction::Unpack() { return get()->Unpack(); }
+
+} // end of namespace MiniScript
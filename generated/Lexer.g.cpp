@@ -7,30 +7,74 @@
 
 namespace MiniScript {
 
-Token::Token(TokenType type,String text,Int32 line,Int32 column) {
+Token::Token(TokenType type,Int32 start,Int32 length,Int32 line,Int32 column) {
 	Type = type;
-	Text = text;
+	Text = nullptr;
 	DoubleValue = 0;
+	Start = start;
+	Length = length;
 	Line = line;
 	Column = column;
 	AfterSpace = Boolean(false);
 }
 
 Lexer::Lexer(String source) {
+	// (C# wants every field set before a method may be called.)
+	_input = nullptr;
+	_length = 0;
+	_position = 0;
+	_line = 0;
+	_column = 0;
+	Error = Value::Null;
+	FileName = "";
+	Detached = Boolean(false);
+	_detachedError = Boolean(false);
+	_nameSlots = nullptr;
+	_names = nullptr;
+	_nameHashes = nullptr;
+	_nameTypes = nullptr;
+	Reset(source);
+}
+void Lexer::Reset(String source) {
 	_input = source.Replace("\r\n", "\n").Replace("\r", "\n");
+	_length = _input.LengthB(); _src = _input.c_str();
 	_position = 0;
 	_line = 1;
 	_column = 1;
 	Error = Value::Null;
 	FileName = "";
-}
-Char Lexer::Peek() {
-	if (_position >= _input.Length()) return '\0';
-	return _input[_position];
+	_detachedError = Boolean(false);
+	if (!IsNull(_nameSlots)) return;
+	_nameSlots =  List<Int32>::New();
+	_names =  List<String>::New();
+	_nameHashes =  List<UInt32>::New();
+	_nameTypes =  List<TokenType>::New();
+	for (Int32 i = 0; i < 64; i++) _nameSlots.Add(-1);
+	AddKeyword("and", TokenType::AND);
+	AddKeyword("or", TokenType::OR);
+	AddKeyword("not", TokenType::NOT);
+	AddKeyword("while", TokenType::WHILE);
+	AddKeyword("for", TokenType::FOR);
+	AddKeyword("in", TokenType::IN);
+	AddKeyword("if", TokenType::IF);
+	AddKeyword("then", TokenType::THEN);
+	AddKeyword("else", TokenType::ELSE);
+	AddKeyword("break", TokenType::BREAK);
+	AddKeyword("continue", TokenType::CONTINUE);
+	AddKeyword("function", TokenType::FUNCTION);
+	AddKeyword("return", TokenType::RETURN);
+	AddKeyword("new", TokenType::NEW);
+	AddKeyword("isa", TokenType::ISA);
+	AddKeyword("self", TokenType::SELF);
+	AddKeyword("super", TokenType::SUPER);
+	AddKeyword("locals", TokenType::LOCALS);
+	AddKeyword("outer", TokenType::OUTER);
+	AddKeyword("globals", TokenType::GLOBALS);
+	AddKeyword("end", TokenType::END);
 }
 Char Lexer::Advance() {
 	Char c = Peek();
-	_position++;
+	_position += (_position < _length ? LexCharSize(_src, _position, _length) : 1);
 	if (c == '\n') {
 		_line++;
 		_column = 1;
@@ -39,113 +83,153 @@ Char Lexer::Advance() {
 	}
 	return c;
 }
+String Lexer::Slice(Int32 start,Int32 end) {
+	if (end <= start) return "";
+	return String(_src + start, (size_t)(end - start));
+}
+String Lexer::TextOf(Token tok) {
+	return Slice(tok.Start, tok.Start + tok.Length);
+}
+Int32 Lexer::ScanIdentifierRun(Int32 pos) {
+	return LexScanIdentifier(_src, pos, _length);
+}
+Int32 Lexer::ScanDigitRun(Int32 pos) {
+	return LexScanDigits(_src, pos, _length);
+}
+Int32 Lexer::ScanBlankRun(Int32 pos) {
+	return LexScanBlanks(_src, pos, _length);
+}
+Int32 Lexer::FindLineEnd(Int32 pos) {
+	Int32 found = LexFindByte(_src, pos, _length, '\n');
+	if (found < 0) return _length;
+	return found;
+}
+UInt32 Lexer::HashRange(Int32 start,Int32 end) {
+	UInt32 h = 2166136261u;
+	for (Int32 i = start; i < end; i++) {
+		h = (h ^ (UInt32)(unsigned char)_src[i]) * 16777619u;
+	}
+	return h;
+}
+UInt32 Lexer::HashText(String s) {
+	UInt32 h = 2166136261u;
+	const char* p = s.c_str();
+	Int32 len = s.LengthB();
+	for (Int32 i = 0; i < len; i++) h = (h ^ (UInt32)(unsigned char)p[i]) * 16777619u;
+	return h;
+}
+Boolean Lexer::NameMatches(Int32 idx,Int32 start,Int32 end) {
+	const String& name = _names[idx];
+	return name.LengthB() == end - start && memcmp(name.c_str(), _src + start, end - start) == 0;
+}
+Int32 Lexer::FindNameSlot(UInt32 hash,Int32 start,Int32 end) {
+	Int32 mask = _nameSlots.Count() - 1;
+	Int32 slot = (Int32)(hash & (UInt32)mask);
+	while (_nameSlots[slot] >= 0) {
+		Int32 idx = _nameSlots[slot];
+		if (_nameHashes[idx] == hash && NameMatches(idx, start, end)) break;
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+void Lexer::AddName(Int32 slot,String name,UInt32 hash,TokenType type) {
+	_nameSlots[slot] = _names.Count();
+	_names.Add(name);
+	_nameHashes.Add(hash);
+	_nameTypes.Add(type);
+	if (_names.Count() * 2 <= _nameSlots.Count()) return;
+	Int32 size = _nameSlots.Count() * 2;
+	_nameSlots.Clear();
+	for (Int32 i = 0; i < size; i++) _nameSlots.Add(-1);
+	for (Int32 i = 0; i < _names.Count(); i++) {
+		Int32 s = (Int32)(_nameHashes[i] & (UInt32)(size - 1));
+		while (_nameSlots[s] >= 0) s = (s + 1) & (size - 1);
+		_nameSlots[s] = i;
+	}
+}
+void Lexer::AddKeyword(String word,TokenType type) {
+	UInt32 hash = HashText(word);
+	Int32 mask = _nameSlots.Count() - 1;
+	Int32 slot = (Int32)(hash & (UInt32)mask);
+	while (_nameSlots[slot] >= 0) slot = (slot + 1) & mask;
+	AddName(slot, word, hash, type);
+}
 Token Lexer::NextToken() {
 	Boolean hadWhitespace = SkipWhitespace();
 
+	Int32 startPos = _position;
 	Int32 startLine = _line;
 	Int32 startColumn = _column;
+	Token tok;
 
 	// End of _input
-	if (_position >= _input.Length()) {
-		Token eofTok = Token(TokenType::END_OF_INPUT, "", startLine, startColumn);
-		eofTok.AfterSpace = hadWhitespace;
-		return eofTok;
+	if (_position >= _length) {
+		tok = Token(TokenType::END_OF_INPUT, startPos, 0, startLine, startColumn);
+		tok.AfterSpace = hadWhitespace;
+		return tok;
 	}
 
 	Char c = Peek();
 
 	// Numbers
 	if (IsDigit(c)) {
-		Int32 start = _position;
-		while (_position < _input.Length() && IsDigit(_input[_position])) {
-			Advance();
-		}
+		SkipTo(ScanDigitRun(_position));
+		Boolean isInteger = Boolean(true);
 		// Check for decimal point
-		if (Peek() == '.' && _position + 1 < _input.Length() && IsDigit(_input[_position + 1])) {
+		if (Peek() == '.' && IsDigit(CharAt(_position + 1))) {
+			isInteger = Boolean(false);
 			Advance(); // consume '.'
-			while (_position < _input.Length() && IsDigit(_input[_position])) {
-				Advance();
-			}
+			SkipTo(ScanDigitRun(_position));
 		}
 		// Check for exponent (e.g. 1E-12, 2.5e6)
-		if (_position < _input.Length() && (_input[_position] == 'E' || _input[_position] == 'e')) {
+		if (Peek() == 'E' || Peek() == 'e') {
 			Int32 savedPos = _position;
+			Int32 savedColumn = _column;
 			Advance(); // consume 'E'/'e'
-			if (_position < _input.Length() && (_input[_position] == '+' || _input[_position] == '-')) {
+			if (Peek() == '+' || Peek() == '-') {
 				Advance(); // consume sign
 			}
-			if (_position < _input.Length() && IsDigit(_input[_position])) {
-				while (_position < _input.Length() && IsDigit(_input[_position])) {
-					Advance();
-				}
+			if (IsDigit(Peek())) {
+				isInteger = Boolean(false);
+				SkipTo(ScanDigitRun(_position));
 			} else {
 				_position = savedPos; // not a valid exponent; backtrack
+				_column = savedColumn;
 			}
 		}
-		String numStr = _input.Substring(start, _position - start);
-		Token tok = Token(TokenType::NUMBER, numStr, startLine, startColumn);
+		tok = Token(TokenType::NUMBER, startPos, _position - startPos, startLine, startColumn);
 		tok.AfterSpace = hadWhitespace;
-		// Always derive the value as a double; this stores our best
-		// approximation for magnitudes too large to represent exactly,
-		// just as we do for fractional literals like 2.5.
-		tok.DoubleValue = StringUtils::ParseDouble(numStr);
+		if (isInteger && _position - startPos <= 15) {
+			// Up to 15 digits is exact in a double, so add it up directly.
+			Double value = 0;
+			for (Int32 i = startPos; i < _position; i++) value = value * 10 + (CharAt(i) - '0');
+			tok.DoubleValue = value;
+		} else {
+			// Always derive the value as a double; this stores our best
+			// approximation for magnitudes too large to represent exactly,
+			// just as we do for fractional literals like 2.5.
+			tok.DoubleValue = StringUtils::ParseDouble(Slice(startPos, _position));
+		}
 		return tok;
 	}
 
 	// Identifiers and keywords
 	if (IsIdentifierStartChar(c)) {
-		Int32 start = _position;
-		while (_position < _input.Length() && IsIdentifierChar(_input[_position])) {
+		while (Boolean(true)) {
+			SkipTo(ScanIdentifierRun(_position));
+			Char ch = Peek();
+			if ((int)ch < 128 || !IsIdentifierChar(ch)) break;
 			Advance();
 		}
-		String text = _input.Substring(start, _position - start);
-		Token tok;
-		// Check for keywords
-		if (text == "and") {
-			tok = Token(TokenType::AND, text, startLine, startColumn);
-		} else if (text == "or") {
-			tok = Token(TokenType::OR, text, startLine, startColumn);
-		} else if (text == "not") {
-			tok = Token(TokenType::NOT, text, startLine, startColumn);
-		} else if (text == "while") {
-			tok = Token(TokenType::WHILE, text, startLine, startColumn);
-		} else if (text == "for") {
-			tok = Token(TokenType::FOR, text, startLine, startColumn);
-		} else if (text == "in") {
-			tok = Token(TokenType::IN, text, startLine, startColumn);
-		} else if (text == "if") {
-			tok = Token(TokenType::IF, text, startLine, startColumn);
-		} else if (text == "then") {
-			tok = Token(TokenType::THEN, text, startLine, startColumn);
-		} else if (text == "else") {
-			tok = Token(TokenType::ELSE, text, startLine, startColumn);
-		} else if (text == "break") {
-			tok = Token(TokenType::BREAK, text, startLine, startColumn);
-		} else if (text == "continue") {
-			tok = Token(TokenType::CONTINUE, text, startLine, startColumn);
-		} else if (text == "function") {
-			tok = Token(TokenType::FUNCTION, text, startLine, startColumn);
-		} else if (text == "return") {
-			tok = Token(TokenType::RETURN, text, startLine, startColumn);
-		} else if (text == "new") {
-			tok = Token(TokenType::NEW, text, startLine, startColumn);
-		} else if (text == "isa") {
-			tok = Token(TokenType::ISA, text, startLine, startColumn);
-		} else if (text == "self") {
-			tok = Token(TokenType::SELF, text, startLine, startColumn);
-		} else if (text == "super") {
-			tok = Token(TokenType::SUPER, text, startLine, startColumn);
-		} else if (text == "locals") {
-			tok = Token(TokenType::LOCALS, text, startLine, startColumn);
-		} else if (text == "outer") {
-			tok = Token(TokenType::OUTER, text, startLine, startColumn);
-		} else if (text == "globals") {
-			tok = Token(TokenType::GLOBALS, text, startLine, startColumn);
-		} else if (text == "end") {
-			tok = Token(TokenType::END, text, startLine, startColumn);
-		} else {
-			tok = Token(TokenType::IDENTIFIER, text, startLine, startColumn);
+		UInt32 hash = HashRange(startPos, _position);
+		Int32 slot = FindNameSlot(hash, startPos, _position);
+		Int32 idx = _nameSlots[slot];
+		if (idx < 0) {
+			AddName(slot, Slice(startPos, _position), hash, TokenType::IDENTIFIER);
+			idx = _names.Count() - 1;
 		}
+		tok = Token(_nameTypes[idx], startPos, _position - startPos, startLine, startColumn);
+		if (tok.Type == TokenType::IDENTIFIER) tok.Text = _names[idx];
 		tok.AfterSpace = hadWhitespace;
 		return tok;
 	}
@@ -155,12 +239,13 @@ Token Lexer::NextToken() {
 		Advance(); // consume opening quote
 		Int32 start = _position;
 		List<String> parts = nullptr;
-		while (_position < _input.Length()) {
-			if (_input[_position] == '"') {
+		while (_position < _length) {
+			Char ch = Peek();
+			if (ch == '"') {
 				// Check for doubled quote (escaped literal quote)
-				if (_position + 1 < _input.Length() && _input[_position + 1] == '"') {
+				if (CharAt(_position + 1) == '"') {
 					if (IsNull(parts)) parts =  List<String>::New();
-					parts.Add(_input.Substring(start, _position - start));
+					parts.Add(Slice(start, _position));
 					parts.Add("\"");
 					Advance(); Advance(); // skip both quotes
 					start = _position;
@@ -172,126 +257,103 @@ Token Lexer::NextToken() {
 		}
 		String text;
 		if (IsNull(parts)) {
-			text = _input.Substring(start, _position - start);
+			text = Slice(start, _position);
 		} else {
-			parts.Add(_input.Substring(start, _position - start));
+			parts.Add(Slice(start, _position));
 			text = String::Join("", parts);
 		}
 		if (Peek() == '"') Advance(); // consume closing quote
-		Token tok = Token(TokenType::STRING, text, startLine, startColumn);
+		tok = Token(TokenType::STRING, startPos, _position - startPos, startLine, startColumn);
+		tok.Text = text;
 		tok.AfterSpace = hadWhitespace;
 		return tok;
 	}
 
-	// Multi-character operators (check before consuming)
-	Token multiTok;
-	if (c == '=' && _position + 1 < _input.Length() && _input[_position + 1] == '=') {
-		Advance(); Advance();
-		multiTok = Token(TokenType::EQUALS, "==", startLine, startColumn);
-		multiTok.AfterSpace = hadWhitespace;
-		return multiTok;
-	}
-	if (c == '!' && _position + 1 < _input.Length() && _input[_position + 1] == '=') {
-		Advance(); Advance();
-		multiTok = Token(TokenType::NOT_EQUAL, "!=", startLine, startColumn);
-		multiTok.AfterSpace = hadWhitespace;
-		return multiTok;
-	}
-	if (c == '<' && _position + 1 < _input.Length() && _input[_position + 1] == '=') {
-		Advance(); Advance();
-		multiTok = Token(TokenType::LESS_EQUAL, "<=", startLine, startColumn);
-		multiTok.AfterSpace = hadWhitespace;
-		return multiTok;
-	}
-	if (c == '>' && _position + 1 < _input.Length() && _input[_position + 1] == '=') {
-		Advance(); Advance();
-		multiTok = Token(TokenType::GREATER_EQUAL, ">=", startLine, startColumn);
-		multiTok.AfterSpace = hadWhitespace;
-		return multiTok;
+	// Comments: // to end of line (must check before /= which is handled below).
+	// The newline itself is not part of the comment.
+	Char next = CharAt(_position + 1);
+	if (c == '/' && next == '/') {
+		Int32 end = FindLineEnd(_position);
+		_column += end - _position;
+		_position = end;
+		tok = Token(TokenType::COMMENT, startPos, end - startPos, startLine, startColumn);
+		tok.AfterSpace = hadWhitespace;
+		return tok;
 	}
 
-	// Compound assignment operators: +=, -=, *=, /=, %=, ^=
-	if (_position + 1 < _input.Length() && _input[_position + 1] == '=') {
-		TokenType compoundType = TokenType::ERROR;
-		String compoundText = "";
-		if (c == '+') { compoundType = TokenType::PLUS_ASSIGN; compoundText = "+="; }
-		else if (c == '-') { compoundType = TokenType::MINUS_ASSIGN; compoundText = "-="; }
-		else if (c == '*') { compoundType = TokenType::TIMES_ASSIGN; compoundText = "*="; }
-		else if (c == '/') { compoundType = TokenType::DIVIDE_ASSIGN; compoundText = "/="; }
-		else if (c == '%') { compoundType = TokenType::MOD_ASSIGN; compoundText = "%="; }
-		else if (c == '^') { compoundType = TokenType::POWER_ASSIGN; compoundText = "^="; }
-		if (compoundType != TokenType::ERROR) {
-			Advance(); Advance();
-			multiTok = Token(compoundType, compoundText, startLine, startColumn);
-			multiTok.AfterSpace = hadWhitespace;
-			return multiTok;
-		}
+	// Operators and punctuation.  Work out the type first; then consume it.
+	TokenType type = TokenType::ERROR;
+	Int32 size = 1;
+	if (next == '=') {
+		// Two-character operators ending in '=', including the compound
+		// assignments +=, -=, *=, /=, %=, ^=
+		size = 2;
+		if (c == '=') type = TokenType::EQUALS;
+		else if (c == '!') type = TokenType::NOT_EQUAL;
+		else if (c == '<') type = TokenType::LESS_EQUAL;
+		else if (c == '>') type = TokenType::GREATER_EQUAL;
+		else if (c == '+') type = TokenType::PLUS_ASSIGN;
+		else if (c == '-') type = TokenType::MINUS_ASSIGN;
+		else if (c == '*') type = TokenType::TIMES_ASSIGN;
+		else if (c == '/') type = TokenType::DIVIDE_ASSIGN;
+		else if (c == '%') type = TokenType::MOD_ASSIGN;
+		else if (c == '^') type = TokenType::POWER_ASSIGN;
+		else size = 1;
 	}
-
-	// Comments: // to end of line (must check before /= which is handled below)
-	if (c == '/' && _position + 1 < _input.Length() && _input[_position + 1] == '/') {
-		Int32 start = _position;
-		// Consume until end of line (but not the newline itself)
-		while (_position < _input.Length() && _input[_position] != '\n') {
-			Advance();
+	if (size == 1) {
+		switch (c) {
+			case '+': type = TokenType::PLUS; break;
+			case '-':
+				// A '-' that is preceded by whitespace but *not* followed by
+				// whitespace binds tightly to what follows, and so can only be
+				// negation, never subtraction: "f -5" is a call, while "f - 5",
+				// "f- 5" and "f-5" all subtract.  The lexer settles that here,
+				// by returning a distinct token type, so that the grammar need
+				// not know where a statement began.
+				// See notes/UNARY_MINUS_QUIRK.md.
+				if (hadWhitespace && _position + 1 < _length && !IsWhiteSpace(next)) {
+					type = TokenType::STRONG_NEGATE;
+				} else {
+					type = TokenType::MINUS;
+				}
+				break;
+			case '*': type = TokenType::TIMES; break;
+			case '/': type = TokenType::DIVIDE; break;
+			case '%': type = TokenType::MOD; break;
+			case '^': type = TokenType::CARET; break;
+			case '(': type = TokenType::LPAREN; break;
+			case ')': type = TokenType::RPAREN; break;
+			case '[': type = TokenType::LBRACKET; break;
+			case ']': type = TokenType::RBRACKET; break;
+			case '{': type = TokenType::LBRACE; break;
+			case '}': type = TokenType::RBRACE; break;
+			case '=': type = TokenType::ASSIGN; break;
+			case '<': type = TokenType::LESS_THAN; break;
+			case '>': type = TokenType::GREATER_THAN; break;
+			case ',': type = TokenType::COMMA; break;
+			case ':': type = TokenType::COLON; break;
+			case '.': type = TokenType::DOT; break;
+			case '@': type = TokenType::ADDRESS_OF; break;
+			case ';': type = TokenType::EOL; break;
+			case '\n': type = TokenType::EOL; break;
+			default: type = TokenType::ERROR; break;
 		}
-		String text = _input.Substring(start, _position - start);
-		Token commentTok = Token(TokenType::COMMENT, text, startLine, startColumn);
-		commentTok.AfterSpace = hadWhitespace;
-		return commentTok;
 	}
-
-	// A '-' that is preceded by whitespace but *not* followed by whitespace
-	// binds tightly to what follows, and so can only be negation, never
-	// subtraction: "f -5" is a call, while "f - 5", "f- 5" and "f-5" all
-	// subtract.  The lexer settles that here, by returning a distinct token
-	// type, so that the grammar need not know where a statement began.
-	// See notes/UNARY_MINUS_QUIRK.md.
-	Boolean strongNegate = (c == '-' && hadWhitespace
-		&& _position + 1 < _input.Length() && !IsWhiteSpace(_input[_position + 1]));
-
-	// Single-character operators and punctuation
 	Advance();
-	Token singleTok;
-	switch (c) {
-		case '+': singleTok = Token(TokenType::PLUS, "+", startLine, startColumn); break;
-		case '-':
-			if (strongNegate) {
-				singleTok = Token(TokenType::STRONG_NEGATE, "-", startLine, startColumn);
-			} else {
-				singleTok = Token(TokenType::MINUS, "-", startLine, startColumn);
-			}
-			break;
-		case '*': singleTok = Token(TokenType::TIMES, "*", startLine, startColumn); break;
-		case '/': singleTok = Token(TokenType::DIVIDE, "/", startLine, startColumn); break;
-		case '%': singleTok = Token(TokenType::MOD, "%", startLine, startColumn); break;
-		case '^': singleTok = Token(TokenType::CARET, "^", startLine, startColumn); break;
-		case '(': singleTok = Token(TokenType::LPAREN, "(", startLine, startColumn); break;
-		case ')': singleTok = Token(TokenType::RPAREN, ")", startLine, startColumn); break;
-		case '[': singleTok = Token(TokenType::LBRACKET, "[", startLine, startColumn); break;
-		case ']': singleTok = Token(TokenType::RBRACKET, "]", startLine, startColumn); break;
-		case '{': singleTok = Token(TokenType::LBRACE, "{", startLine, startColumn); break;
-		case '}': singleTok = Token(TokenType::RBRACE, "}", startLine, startColumn); break;
-		case '=': singleTok = Token(TokenType::ASSIGN, "=", startLine, startColumn); break;
-		case '<': singleTok = Token(TokenType::LESS_THAN, "<", startLine, startColumn); break;
-		case '>': singleTok = Token(TokenType::GREATER_THAN, ">", startLine, startColumn); break;
-		case ',': singleTok = Token(TokenType::COMMA, ",", startLine, startColumn); break;
-		case ':': singleTok = Token(TokenType::COLON, ":", startLine, startColumn); break;
-		case '.': singleTok = Token(TokenType::DOT, ".", startLine, startColumn); break;
-		case '@': singleTok = Token(TokenType::ADDRESS_OF, "@", startLine, startColumn); break;
-		case ';': singleTok = Token(TokenType::EOL, ";", startLine, startColumn); break;
-		case '\n': singleTok = Token(TokenType::EOL, "\n", startLine, startColumn); break;
-		default:
-			singleTok = Token(TokenType::ERROR, StringUtils::Str(c), startLine, startColumn); break;
-	}
-	singleTok.AfterSpace = hadWhitespace;
-	return singleTok;
+	if (size == 2) Advance();
+	tok = Token(type, startPos, _position - startPos, startLine, startColumn);
+	tok.AfterSpace = hadWhitespace;
+	return tok;
 }
 void Lexer::ReportError(String message) {
+	if (Detached) {
+		_detachedError = Boolean(true);
+		return;
+	}
 	if (Error.IsNull()) Error = ErrorTypes::CompilerError(message, FileName, _line);
 }
 Boolean Lexer::HadError() {
-	return !Error.IsNull();
+	return _detachedError || !Error.IsNull();
 }
 
 } // end of namespace MiniScript
@@ -9,45 +9,130 @@
 
 #include "LangConstants.g.h"
 #include "ErrorTypes.g.h"
+#include "lex_scan.h"
 
 namespace MiniScript {
 
 // DECLARATIONS
 
-// Represents a single token from the lexer
+// Represents a single token from the lexer.  A token is a view of the source:
+// Start and Length locate it there, and Lexer.TextOf recovers its text.  Only
+// identifiers and string literals carry a Text, since theirs is the only text
+// the parser keeps; a number carries its DoubleValue, and every other token is
+// fully described by its Type.
 struct Token {
 	public: TokenType Type;
-	public: String Text;
+	public: String Text; // identifier name or string contents; else null
 	public: Double DoubleValue;
+	public: Int32 Start; // position in the lexer's source (see Lexer)
+	public: Int32 Length; // length there, in the same units
 	public: Int32 Line;
 	public: Int32 Column;
 	public: Boolean AfterSpace; // True if whitespace preceded this token
 	public: Token() {}
 
-	public: Token(TokenType type, String text, Int32 line, Int32 column);
+	public: Token(TokenType type, Int32 start, Int32 length, Int32 line, Int32 column);
 }; // end of struct Token
 
+// Positions in the source (_position, Token.Start) count UTF-16 code units in
+// C#, and bytes of the UTF-8 text in C++, so that reading a character or
+// slicing out a token takes constant time in both.  (Counting characters from
+// the start of the string made lexing quadratic in C++.)  The C++ side also
+// scans runs of identifier characters, digits, and blanks with the helpers in
+// core/lex_scan.h.
 struct Lexer {
 	private: String _input;
+	private: Int32 _length; // length of _input, in position units
+	private: const char* _src = nullptr;  // _input's bytes
 	private: Int32 _position;
 	private: Int32 _line;
 	private: Int32 _column;
 	public: Value Error;
 	public: String FileName; // source file name, for error locations ("" if unnamed)
+	public: Boolean Detached;
+	private: Boolean _detachedError;
+	private: List<Int32> _nameSlots;
+	private: List<String> _names;
+	private: List<UInt32> _nameHashes;
+	private: List<TokenType> _nameTypes;
 	public: Lexer() {}
 
+	// Set when lexing off the VM thread (see ImportPrefetch).  An error is then
+	// only noted, not made into an error Value, since that would allocate from
+	// the GC heap, which belongs to the VM thread.
+
+	// Names seen so far, so that an identifier which recurs is returned as the
+	// same String rather than copied out of the source each time.  Keywords are
+	// entered up front, with their token types, so that recognizing a keyword
+	// needs no String at all.  Open addressing: _nameSlots (a power of two in
+	// size) holds indexes into the other three lists, or -1 if empty.
+
 	public: Lexer(String source);
 
+	// Start over on new source.  The name table is kept: the keywords, and
+	// any names already seen, serve the next source as well as the last, so a
+	// Parser fed one REPL line after another builds the table only once.
+	public: void Reset(String source);
+
+	// Return the character at the given position, or '\0' past the end.
+	private: Char CharAt(Int32 pos);
+
 	// Peek at current character without advancing
 	private: Char Peek();
 
 	// Advance to next character
 	private: Char Advance();
 
+	// Skip ahead to the given position, over characters known to be ASCII and
+	// not newlines, so that each is one position and one column.
+	private: void SkipTo(Int32 pos);
+
+	// Return the source text from start up to (not including) end.
+	private: String Slice(Int32 start, Int32 end);
+
+	// Return the source text of the given token: what it was lexed from, which
+	// for a string literal includes the quotes.
+	public: String TextOf(Token tok);
+
+	// ── Runs of ASCII characters ─────────────────────────────────────────────
+	// Each returns the end of the run starting at pos.  A character outside the
+	// class (including any non-ASCII one) ends the run.
+
+	private: Int32 ScanIdentifierRun(Int32 pos);
+
+	private: Int32 ScanDigitRun(Int32 pos);
+
+	private: Int32 ScanBlankRun(Int32 pos);
+
+	// Return the position of the next newline at or after pos, or the end of
+	// the source if there is none.
+	private: Int32 FindLineEnd(Int32 pos);
+
+	// ── Name table ───────────────────────────────────────────────────────────
+
+	// FNV-1a over the source from start up to (not including) end.
+	private: UInt32 HashRange(Int32 start, Int32 end);
+
+	// The same hash over a String, in the same units as HashRange.
+	private: static UInt32 HashText(String s);
+
+	// Return whether entry idx of the name table has the text [start, end).
+	private: Boolean NameMatches(Int32 idx, Int32 start, Int32 end);
+
+	// Return the name-table slot for the given hash and source range: the slot
+	// holding that name, or the empty slot where it belongs.
+	private: Int32 FindNameSlot(UInt32 hash, Int32 start, Int32 end);
+
+	// Add a name to the table at the given (empty) slot, growing the table
+	// when it gets half full.
+	private: void AddName(Int32 slot, String name, UInt32 hash, TokenType type);
+
+	private: void AddKeyword(String word, TokenType type);
+
 	public: static Boolean IsDigit(Char c);
-	
+
 	public: static Boolean IsWhiteSpace(Char c);
-		
+
 	public: static Boolean IsIdentifierStartChar(Char c);
 
 	public: static Boolean IsIdentifierChar(Char c);
@@ -67,6 +152,17 @@ struct Lexer {
 
 // INLINE METHODS
 
+inline Char Lexer::CharAt(Int32 pos) {
+	if (pos >= _length) return '\0';
+	return LexCharAt(_src, pos, _length);
+}
+inline Char Lexer::Peek() {
+	return CharAt(_position);
+}
+inline void Lexer::SkipTo(Int32 pos) {
+	_column += pos - _position;
+	_position = pos;
+}
 inline Boolean Lexer::IsDigit(Char c) {
 	return '0' <= c && c <= '9';
 }
@@ -81,15 +177,14 @@ inline Boolean Lexer::IsIdentifierChar(Char c) {
 	return IsIdentifierStartChar(c) || IsDigit(c);
 }
 inline Boolean Lexer::SkipWhitespace() {
-	Boolean skipped = Boolean(false);
-	while (_position < _input.Length()) {
-		Char ch = _input[_position];
-		if (ch == '\n') break;  // newlines are significant
-		if (!IsWhiteSpace(ch)) break;
+	Int32 start = _position;
+	while (Boolean(true)) {
+		SkipTo(ScanBlankRun(_position));
+		Char ch = Peek();
+		if (ch == '\n' || !IsWhiteSpace(ch)) break;  // newlines are significant
 		Advance();
-		skipped = Boolean(true);
 	}
-	return skipped;
+	return _position > start;
 }
 
 } // end of namespace MiniScript
@@ -6,11 +6,11 @@
 
 namespace MiniScript {
 
-UInt64 PRNG::_s0 = 0;
-UInt64 PRNG::_s1 = 0;
-UInt64 PRNG::_s2 = 0;
-UInt64 PRNG::_s3 = 0;
-Boolean PRNG::_seeded = Boolean(false);
+thread_local UInt64 PRNG::_s0;
+thread_local UInt64 PRNG::_s1;
+thread_local UInt64 PRNG::_s2;
+thread_local UInt64 PRNG::_s3;
+thread_local Boolean PRNG::_seeded;
 void PRNG::Seed(UInt64 seed) {
 	UInt64 x = seed;
 	x = x + 0x9E3779B97F4A7C15UL; _s0 = SplitMix64(x);
@@ -14,11 +14,14 @@ namespace MiniScript {
 // DECLARATIONS
 
 class PRNG {
-	private: static UInt64 _s0;
-	private: static UInt64 _s1;
-	private: static UInt64 _s2;
-	private: static UInt64 _s3;
-	private: static Boolean _seeded;
+	private: thread_local static UInt64 _s0;
+	private: thread_local static UInt64 _s1;
+	private: thread_local static UInt64 _s2;
+	private: thread_local static UInt64 _s3;
+	private: thread_local static Boolean _seeded;
+
+	// Generator state, per thread: each isolate (see GCManager) has its own
+	// sequence, and seeding one does not disturb another.
 
 	// Seed from a single 64-bit value, expanded to the full 256-bit
 	// state with splitmix64 as recommended by the xoshiro authors.
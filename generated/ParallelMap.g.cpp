@@ -0,0 +1,330 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: ParallelMap.cs
+
+#include "ParallelMap.g.h"
+#include "Bytecode.g.h"
+#include "GCManager.g.h"
+#include "ErrorTypes.g.h"
+#include "Interpreter.g.h"
+#include "Intrinsic.g.h"
+#include "StringUtils.g.h"
+#include "VM.g.h"
+#include <cstdlib>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MiniScript {
+
+ParallelJobStorage::ParallelJobStorage() {
+}
+
+Int32 ParallelMap::ThreadCount = -1;
+const String ParallelMap::kWorkerSource = "null";
+List<ParallelJob> ParallelMap::_jobs =  List<ParallelJob>::New();
+Int32 ParallelMap::_lastJobId = 0;
+Boolean ParallelMap::_stopping = Boolean(false);
+Int32 ParallelMap::_threadsRunning = 0;
+thread_local Boolean ParallelMap::_isWorker; // this thread is one of the workers
+static std::mutex _mutex;
+static std::condition_variable_any _changed;
+// Made on first use, so that it is destroyed (joining the workers) before
+// the job list above, which the workers may still be using.
+struct WorkerThreads {
+	std::vector<std::thread> threads;
+	~WorkerThreads() { ParallelMap::Stop(); }
+};
+static WorkerThreads& Threads() {
+	static WorkerThreads threads;
+	return threads;
+}
+Int32 ParallelMap::GetThreadCount() {
+	if (ThreadCount < 0) {
+		ThreadCount = (Int32)std::thread::hardware_concurrency() - 1;
+		const char* env = getenv("MS_PARALLEL_THREADS");
+		if (env) ThreadCount = atoi(env);
+		if (ThreadCount < 0) ThreadCount = 0;
+	}
+	return ThreadCount;
+}
+String ParallelMap::OutsideName(Value func,Globals globals) {
+	List<FuncDef> defs =  List<FuncDef>::New();
+	List<Int32> parents =  List<Int32>::New();	// per def, the index of the def it is nested in, or -1
+	defs.Add(func.FunctionDef());
+	parents.Add(-1);
+	for (Int32 d = 0; d < defs.Count(); d++) {	// (defs grows as nested functions turn up)
+		FuncDef def = defs[d];
+		def.EnsureConstants();
+		for (Int32 i = 0; i < def.Constants().Count(); i++) {
+			Value c = def.Constants()[i];
+			if (!c.IsFuncRef()) continue;
+			defs.Add(c.FunctionDef());
+			parents.Add(d);
+		}
+		Int32 codeCount = def.CodeCount();
+		for (Int32 pc = 0; pc < codeCount; pc++) {
+			UInt32 instr = def.CodeAt(pc);
+			Opcode op = (Opcode)BytecodeUtil::OP(instr);
+			if (op == Opcode::OUTER_rA) return "outer";
+			if (op == Opcode::GLOBALS_rA) return "globals";
+			if (op == Opcode::CALLINTRINSIC_rA_rB_iC) {
+				Intrinsic called = Intrinsic::GetByIndex(BytecodeUtil::Cu(instr));
+				if (globals.HasKey(Value::make_string(called.Name()))) return called.Name();
+			}
+		}
+		for (Int32 i = 0; i < def.GlobalNames().Count(); i++) {
+			Value name = def.GlobalNames()[i];
+			if (BoundByEnclosing(defs, parents, d, name)) continue;
+			if (globals.HasKey(name)) return name.AsCString();
+			Intrinsic intrinsic = Intrinsic::GetByName(name.AsCString());
+			if (IsNull(intrinsic)) return name.AsCString();
+		}
+	}
+	return nullptr;
+}
+Boolean ParallelMap::BoundByEnclosing(List<FuncDef> defs,List<Int32> parents,Int32 d,Value name) {
+	for (Int32 p = parents[d]; p >= 0; p = parents[p]) {
+		FuncDef def = defs[p];
+		for (Int32 i = 0; i < def.ParamNames().Count(); i++) {
+			if (def.ParamNames()[i] == name) return Boolean(true);
+		}
+		Int32 codeCount = def.CodeCount();
+		for (Int32 pc = 0; pc < codeCount; pc++) {
+			UInt32 instr = def.CodeAt(pc);
+			if ((Opcode)BytecodeUtil::OP(instr) != Opcode::NAME_rA_kBC) continue;
+			if (def.Constants()[BytecodeUtil::BCu(instr)] == name) return Boolean(true);
+		}
+	}
+	return Boolean(false);
+}
+IntrinsicResult ParallelMap::Start(Context ctx,Value list,Value func,Int32 chunkSize,Boolean filter) {
+	Int32 count = list.ListCount();
+	Int32 threads = _isWorker ? 0 : GetThreadCount();
+	if (chunkSize <= 0) chunkSize = (count + 4 * threads + 3) / (4 * threads + 4);	// about 4 chunks per thread
+	if (chunkSize <= 0) chunkSize = 1;
+	Value results = Value::make_list(count);
+	for (Int32 i = 0; i < count; i++) results.Push(Value::Null);
+	GCManager::AddRoot(results);		// (func may collect garbage)
+
+	IsolateFunction portable = nullptr;
+	if (threads > 0 && count > chunkSize) portable = IsolateFunction::Pack(func);
+	if (IsNull(portable)) {
+		Boolean ok = RunChunk(ctx, list, func, results, 0, count);
+		GCManager::RemoveRoot(results);
+		if (!ok) return IntrinsicResult::Null;
+		return IntrinsicResult(Finish(list, results, filter));
+	}
+
+	StartThreads();
+	ParallelJob job =  ParallelJob::New();
+	job.set_Function(portable);
+	job.set_Filter(filter);
+	Lock();
+	_lastJobId++;
+	job.set_Id(_lastJobId);
+	_jobs.Add(job);
+	Unlock();
+	for (Int32 start = 0; start < count; start += chunkSize) {
+		Int32 end = start + chunkSize;
+		if (end > count) end = count;
+		ChannelMessage msg = ChannelMessage::Pack(list.ListSlice(start, end));
+		Lock();
+		job.Chunks().Add(msg);
+		job.Claimed().Add(Boolean(false));
+		job.Results().Add(nullptr);
+		Notify();
+		Unlock();
+	}
+
+	// Run the chunks no worker has taken yet right here.
+	while (Boolean(true)) {
+		Lock();
+		Int32 chunk = ClaimChunk(job, Boolean(true));
+		Unlock();
+		if (chunk < 0) break;
+		Int32 end = (chunk + 1) * chunkSize;
+		if (end > count) end = count;
+		if (!RunChunk(ctx, list, func, results, chunk * chunkSize, end)) {
+			Lock();
+			job.set_Cancelled(Boolean(true));
+			RemoveJob(job.Id());
+			Unlock();
+			GCManager::RemoveRoot(results);
+			return IntrinsicResult::Null;
+		}
+	}
+	GCManager::RemoveRoot(results);
+
+	// From here, the partial result (on the VM's stack) holds the results.
+	Value state = Value::make_list(3);
+	state.Push(Value(job.Id()));
+	state.Push(Value(chunkSize));
+	state.Push(results);
+	return Continue(ctx, state, filter);
+}
+IntrinsicResult ParallelMap::Continue(Context ctx,Value state,Boolean filter) {
+	Int32 id = state.ListGet(0).IntValue();
+	ParallelJob job = nullptr;
+	Lock();
+	for (Int32 i = 0; i < _jobs.Count(); i++) {
+		if (_jobs[i].Id() == id) job = _jobs[i];
+	}
+	if (!IsNull(job) && job.Running() > 0 && job.WorkerError() == "") {
+		Unlock();
+		return IntrinsicResult(state, Boolean(false));	// still running: poll again
+	}
+	RemoveJob(id);
+	Unlock();
+	if (IsNull(job)) return IntrinsicResult(ErrorTypes::RuntimeError("parallelMap: job not found"));
+	if (job.WorkerError() != "") {
+		ctx.vm.RaiseRuntimeError(job.WorkerError());
+		return IntrinsicResult::Null;
+	}
+
+	Int32 chunkSize = state.ListGet(1).IntValue();
+	Value results = state.ListGet(2);
+	for (Int32 c = 0; c < job.Results().Count(); c++) {
+		ChannelMessage msg = job.Results()[c];
+		if (IsNull(msg)) continue;	// (run by the caller)
+		Value part = msg.Unpack();
+		Int32 start = c * chunkSize;
+		for (Int32 i = 0; i < part.ListCount(); i++) results.ListSet(start + i, part.ListGet(i));
+	}
+	return IntrinsicResult(Finish(ctx.GetArg(0), results, filter));
+}
+Boolean ParallelMap::RunChunk(Context ctx,Value list,Value func,Value results,Int32 start,Int32 end) {
+	List<Value> args =  List<Value>::New();
+	args.Add(Value::Null);
+	for (Int32 i = start; i < end; i++) {
+		args[0] = list.ListGet(i);
+		Value result = ctx.vm.RunFunction(func, args);
+		if (ctx.vm.Error.IsError()) return Boolean(false);
+		results.ListSet(i, result);
+	}
+	return Boolean(true);
+}
+Value ParallelMap::Finish(Value list,Value results,Boolean filter) {
+	if (!filter) return results;
+	Value kept = Value::make_list(0);
+	for (Int32 i = 0; i < results.ListCount(); i++) {
+		if (results.ListGet(i).BoolValue()) kept.Push(list.ListGet(i));
+	}
+	return kept;
+}
+void ParallelMap::RemoveJob(Int32 id) {
+	for (Int32 i = 0; i < _jobs.Count(); i++) {
+		if (_jobs[i].Id() != id) continue;
+		_jobs.RemoveAt(i);
+		return;
+	}
+}
+Int32 ParallelMap::ClaimChunk(ParallelJob job,Boolean forCaller) {
+	if (job.Cancelled() || job.WorkerError() != "") return -1;
+	for (Int32 c = 0; c < job.Chunks().Count(); c++) {
+		ChannelMessage items = job.Chunks()[c];
+		if (job.Claimed()[c] || (!forCaller && IsNull(items))) continue;
+		job.Claimed()[c] = Boolean(true);
+		return c;
+	}
+	return -1;
+}
+void ParallelMap::Stop() {
+	Lock();
+	_stopping = Boolean(true);
+	Notify();
+	Unlock();
+	std::vector<std::thread>& threads = Threads().threads;
+	for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+	threads.clear();
+	Lock();
+	_jobs.Clear();
+	_threadsRunning = 0;
+	_stopping = Boolean(false);
+	Unlock();
+}
+void ParallelMap::StartThreads() {
+	while (_threadsRunning < ThreadCount) {
+		_threadsRunning++;
+		Threads().threads.push_back(std::thread(&ParallelMap::WorkerLoop));
+	}
+}
+void ParallelMap::WorkerLoop() {
+	GCManager::Init();
+	ErrorTypes::Init();
+	_isWorker = Boolean(true);
+	Interpreter interp =  Interpreter::New(kWorkerSource);
+	interp.Compile();
+	List<Value> args =  List<Value>::New();
+	args.Add(Value::Null);
+	Int32 funcJob = 0;		// the job that func was unpacked for
+	Value func = Value::Null;
+
+	Lock();
+	while (Boolean(true)) {
+		if (_stopping) break;
+		ParallelJob job = nullptr;
+		Int32 chunk = -1;
+		for (Int32 j = 0; j < _jobs.Count() && chunk < 0; j++) {
+			job = _jobs[j];
+			chunk = ClaimChunk(job, Boolean(false));
+		}
+		if (chunk < 0) {
+			Wait();
+			continue;
+		}
+		job.set_Running(job.Running() + 1);
+		ChannelMessage msg = job.Chunks()[chunk];
+		Unlock();
+
+		if (job.Id() != funcJob) {
+			if (!func.IsNull()) GCManager::RemoveRoot(func);
+			func = job.Function().Unpack();
+			GCManager::AddRoot(func);
+			funcJob = job.Id();
+		}
+		Value items = msg.Unpack();
+		Value results = Value::make_list(items.ListCount());
+		String error = "";
+		for (Int32 i = 0; i < items.ListCount(); i++) {
+			args[0] = items.ListGet(i);
+			Value result = interp.RunFunction(func, args);
+			Value err = interp.vm().Error();
+			if (err.IsError()) {
+				String loc = ErrorTypes::ErrorLocation(err);
+				if (loc == "") error = StringUtils::Format("{0} (in a parallelMap worker)", err.Message());
+				else error = StringUtils::Format("{0} (at {1} in a parallelMap worker)", err.Message(), loc);
+				interp.Restart();
+				break;
+			}
+			if (job.Filter()) result = Value::Truth(result.BoolValue());
+			results.Push(result);
+		}
+		ChannelMessage packed = nullptr;
+		if (error == "") {
+			packed = ChannelMessage::Pack(results);
+			if (IsNull(packed)) error = "parallelMap: function result cannot be sent from a worker (it is or holds a function, error, handle, or variable map)";
+		}
+		GCManager::CollectGarbage();
+
+		Lock();
+		job.set_Running(job.Running() - 1);
+		job.Results()[chunk] = packed;
+		if (error != "" && job.WorkerError() == "") job.set_WorkerError(error);
+	}
+	Unlock();
+}
+void ParallelMap::Lock() {
+	_mutex.lock();
+}
+void ParallelMap::Unlock() {
+	_mutex.unlock();
+}
+void ParallelMap::Wait() {
+	_changed.wait(_mutex);
+}
+void ParallelMap::Notify() {
+	_changed.notify_all();
+}
+
+} // end of namespace MiniScript
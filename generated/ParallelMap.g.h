@@ -0,0 +1,201 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: ParallelMap.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// ParallelMap.cs
+// The parallelMap and parallelFilter intrinsics: call a function on each
+// item of a list, spreading the calls over a pool of worker threads.  Each
+// worker is an isolate (see GCManager) with an interpreter of its own, kept
+// for the life of the process.  The list is cut into chunks; the calling
+// thread packs each chunk as a ChannelMessage and posts it for the workers,
+// then runs whatever chunks no worker has taken yet itself (with
+// VM.RunFunction, on the original items).  Each worker unpacks the chunks it
+// takes onto its own heap, calls the function on each item, and packs the
+// results; the caller unpacks those into place, so the results come back in
+// the order of the list, whichever thread made them.
+// A function's code is shared with the workers as it is: nothing changes
+// code once it is built.  But its constants, parameter defaults and global
+// names are Values on the caller's heap, and its global-reference cache is
+// written as it runs, so a worker runs a copy of the FuncDef (and of each
+// function nested in it) made by FuncDef.CopyForIsolate and filled from a
+// message (see IsolateFunction.cs).  What the function cannot take with it is
+// its context: on a worker it runs with no outer variables and with the
+// worker's own (empty) globals, so it must work from its argument alone.
+// The calling thread runs its chunks in the caller's context as usual, so
+// that every chunk sees the same names, a function that reads anything from
+// that context is refused at the call, whoever would have run its chunks
+// (see OutsideName).
+// Where a worker cannot help, the work is simply done on the calling
+// thread: with no workers, a list of one chunk, a function whose constants
+// cannot be sent, or a chunk holding an item that cannot be sent (a
+// function, say).  A call made on a worker also runs there, serially.
+// The number of workers is ThreadCount.  Hosts may set it; if they do not, it
+// is read once from the MS_PARALLEL_THREADS environment variable, and
+// otherwise is one less than the number of hardware threads.  The workers are
+// started by the first call that can use them, so a script that never calls
+// parallelMap never pays for a second thread (see ImportPrefetch).
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+#include "IsolateFunction.g.h"
+#include "IntrinsicAPI.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class ParallelMap {
+	public: static Int32 ThreadCount;
+	private: static const String kWorkerSource;
+	private: static List<ParallelJob> _jobs;
+	private: static Int32 _lastJobId;
+	private: static Boolean _stopping;
+	private: static Int32 _threadsRunning;
+	private: thread_local static Boolean _isWorker; // this thread is one of the workers
+	// Worker threads to use; -1 until resolved (see GetThreadCount).
+
+	// What a worker's interpreter is compiled from.  It is never run; the
+	// worker only calls functions on its VM.
+
+	// The jobs posted and not yet ended, and the workers.  Guarded by the lock.
+
+	public: static Int32 GetThreadCount();
+
+	// The first name that func, or a function nested in it, reads from
+	// outside itself, or null if there is none.  On the calling thread such a
+	// name would be found in the caller's context, and on a worker it would
+	// not, so the result would depend on which thread ran each chunk.  Outside
+	// means `globals`, `outer`, a global the caller has bound (which may shadow
+	// an intrinsic), or any other name that is not an intrinsic -- except that
+	// a nested function may read the variables of the functions it is nested
+	// in, which go along with it.
+	public: static String OutsideName(Value func, Globals globals);
+
+	// Whether a function that defs[d] is nested in has a parameter or local
+	// variable with the given name.
+	private: static Boolean BoundByEnclosing(List<FuncDef> defs, List<Int32> parents, Int32 d, Value name);
+
+	// Begin a call of func on each item of list, for the parallelMap (or, if
+	// filter, parallelFilter) intrinsic, chunkSize items at a time (0 for a
+	// size to suit the number of workers).  The result is final unless some
+	// chunks are still running on workers; then pass the partial result to
+	// Continue until it is.
+	public: static IntrinsicResult Start(Context ctx, Value list, Value func, Int32 chunkSize, Boolean filter);
+
+	// Finish a call begun by Start, whose partial result is `state`, if the
+	// workers are done with it.
+	public: static IntrinsicResult Continue(Context ctx, Value state, Boolean filter);
+
+	// Call func on list[start:end] on this thread, storing the results.
+	// Returns false if it raised an error (which the VM now holds).
+	private: static Boolean RunChunk(Context ctx, Value list, Value func, Value results, Int32 start, Int32 end);
+
+	// The value of the call: the results, or for a filter, the items whose
+	// results were true.
+	private: static Value Finish(Value list, Value results, Boolean filter);
+
+	// Drop the job with the given id from the list (under the lock).  A
+	// worker still running one of its chunks finishes it, to no effect.
+	private: static void RemoveJob(Int32 id);
+
+	// Claim the next chunk of job not yet claimed (under the lock), or return
+	// -1 if there is none.  A worker cannot take a chunk that was not packed.
+	private: static Int32 ClaimChunk(ParallelJob job, Boolean forCaller);
+
+	// Stop the workers and wait for them to finish.  Happens by itself at exit.
+	public: static void Stop();
+
+	// ── Workers ──────────────────────────────────────────────────────────────
+
+	private: static void StartThreads();
+
+	// Body of each worker: claim chunks, oldest job first, until told to stop.
+	private: static void WorkerLoop();
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private: static void Lock();
+
+	private: static void Unlock();
+
+	// Wait (holding the lock) until some other thread calls Notify.
+	private: static void Wait();
+
+	private: static void Notify();
+}; // end of struct ParallelMap
+
+class ParallelJobStorage : public std::enable_shared_from_this<ParallelJobStorage> {
+	friend struct ParallelJob;
+	public: Int32 Id = 0;
+	public: IsolateFunction Function = nullptr; // set before the job is posted; never changed
+	public: Boolean Filter = Boolean(false); // results are only wanted as true or false
+	public: List<ChannelMessage> Chunks = List<ChannelMessage>::New(); // each chunk's items; null if only the caller can run it
+	public: List<Boolean> Claimed = List<Boolean>::New();
+	public: List<ChannelMessage> Results = List<ChannelMessage>::New(); // a worker's results for each chunk
+	public: Int32 Running = 0; // chunks claimed by a worker and not yet finished
+	public: String WorkerError = ""; // the first error on a worker, described
+	public: Boolean Cancelled = Boolean(false); // the caller hit an error, and wants no more
+
+	public: ParallelJobStorage();
+}; // end of class ParallelJobStorage
+
+// One parallelMap or parallelFilter call in progress.  Shared with the
+// workers, and guarded by ParallelMap's lock.
+struct ParallelJob {
+	friend class ParallelJobStorage;
+	protected: std::shared_ptr<ParallelJobStorage> storage;
+  public:
+	ParallelJob(std::shared_ptr<ParallelJobStorage> stor) : storage(stor) {}
+	ParallelJob() : storage(nullptr) {}
+	ParallelJob(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const ParallelJob& inst) { return inst.storage == nullptr; }
+	private: ParallelJobStorage* get() const;
+
+	public: Int32 Id();
+	public: void set_Id(Int32 _v);
+	public: IsolateFunction Function(); // set before the job is posted; never changed
+	public: void set_Function(IsolateFunction _v); // set before the job is posted; never changed
+	public: Boolean Filter(); // results are only wanted as true or false
+	public: void set_Filter(Boolean _v); // results are only wanted as true or false
+	public: List<ChannelMessage> Chunks(); // each chunk's items; null if only the caller can run it
+	public: void set_Chunks(List<ChannelMessage> _v); // each chunk's items; null if only the caller can run it
+	public: List<Boolean> Claimed();
+	public: void set_Claimed(List<Boolean> _v);
+	public: List<ChannelMessage> Results(); // a worker's results for each chunk
+	public: void set_Results(List<ChannelMessage> _v); // a worker's results for each chunk
+	public: Int32 Running(); // chunks claimed by a worker and not yet finished
+	public: void set_Running(Int32 _v); // chunks claimed by a worker and not yet finished
+	public: String WorkerError(); // the first error on a worker, described
+	public: void set_WorkerError(String _v); // the first error on a worker, described
+	public: Boolean Cancelled(); // the caller hit an error, and wants no more
+	public: void set_Cancelled(Boolean _v); // the caller hit an error, and wants no more
+
+	public: static ParallelJob New() {
+		return ParallelJob(std::make_shared<ParallelJobStorage>());
+	}
+}; // end of struct ParallelJob
+
+// INLINE METHODS
+
+inline ParallelJobStorage* ParallelJob::get() const { return static_cast<ParallelJobStorage*>(storage.get()); }
+inline Int32 ParallelJob::Id() { return get()->Id; }
+inline void ParallelJob::set_Id(Int32 _v) { get()->Id = _v; }
+inline IsolateFunction ParallelJob::Function() { return get()->Function; } // set before the job is posted; never changed
+inline void ParallelJob::set_Function(IsolateFunction _v) { get()->Function = _v; } // set before the job is posted; never changed
+inline Boolean ParallelJob::Filter() { return get()->Filter; } // results are only wanted as true or false
+inline void ParallelJob::set_Filter(Boolean _v) { get()->Filter = _v; } // results are only wanted as true or false
+inline List<ChannelMessage> ParallelJob::Chunks() { return get()->Chunks; } // each chunk's items; null if only the caller can run it
+inline void ParallelJob::set_Chunks(List<ChannelMessage> _v) { get()->Chunks = _v; } // each chunk's items; null if only the caller can run it
+inline List<Boolean> ParallelJob::Claimed() { return get()->Claimed; }
+inline void ParallelJob::set_Claimed(List<Boolean> _v) { get()->Claimed = _v; }
+inline List<ChannelMessage> ParallelJob::Results() { return get()->Results; } // a worker's results for each chunk
+inline void ParallelJob::set_Results(List<ChannelMessage> _v) { get()->Results = _v; } // a worker's results for each chunk
+inline Int32 ParallelJob::Running() { return get()->Running; } // chunks claimed by a worker and not yet finished
+inline void ParallelJob::set_Running(Int32 _v) { get()->Running = _v; } // chunks claimed by a worker and not yet finished
+inline String ParallelJob::WorkerError() { return get()->WorkerError; } // the first error on a worker, described
+inline void ParallelJob::set_WorkerError(String _v) { get()->WorkerError = _v; } // the first error on a worker, described
+inline Boolean ParallelJob::Cancelled() { return get()->Cancelled; } // the caller hit an error, and wants no more
+inline void ParallelJob::set_Cancelled(Boolean _v) { get()->Cancelled = _v; } // the caller hit an error, and wants no more
+
+} // end of namespace MiniScript
@@ -79,10 +79,17 @@ void ParserStorage::Init(String source) {
 	Init(source, "");
 }
 void ParserStorage::Init(String source,String fileName) {
-	_lexer = Lexer(source);
+	if (_lexerReady) {
+		_lexer.Reset(source);
+	} else {
+		_lexer = Lexer(source);
+		_lexerReady = Boolean(true);
+	}
 	_lexer.FileName = fileName;
+	_lexer.Detached = Detached;
 	FileName = fileName;
 	Error = Value::Null;
+	_detachedError = Boolean(false);
 	_needMoreInput = Boolean(false);
 	Advance();  // Prime the pump with the first token
 }
@@ -91,13 +98,20 @@ Boolean ParserStorage::NeedMoreInput() {
 }
 void ParserStorage::RequireComplete() {
 	if (!NeedMoreInput()) return;
+	if (Detached) {
+		_detachedError = Boolean(true);
+		return;
+	}
 	Error = ErrorTypes::CompilerError("unexpected end of file", FileName, _current.Line);
 }
 void ParserStorage::Advance() {
 	_previousType = _current.Type;
 	do {
 		_current = _lexer.NextToken();
-		if (Error.IsNull() && _lexer.HadError()) Error = _lexer.Error;
+		if (_lexer.HadError() && !HadError()) {
+			if (Detached) _detachedError = Boolean(true);
+			else Error = _lexer.Error;
+		}
 	} while (_current.Type == TokenType::COMMENT
 		|| (_current.Type == TokenType::EOL && AllowsLineContinuation(_previousType)));
 	// If the last meaningful token allows line continuation and we've run out
@@ -175,7 +189,9 @@ Token ParserStorage::Expect(TokenType type,String errorMessage) {
 		return tok;
 	}
 	ReportError(errorMessage);
-	return Token(TokenType::ERROR, "", _current.Line, _current.Column);
+	Token errTok = Token(TokenType::ERROR, _current.Start, 0, _current.Line, _current.Column);
+	errTok.Text = "";
+	return errTok;
 }
 Precedence ParserStorage::GetPrecedence(Boolean callStatementAllowed) {
 	// A '[' preceded by whitespace is not an index operator; it begins a
@@ -456,7 +472,7 @@ List<ASTNode> ParserStorage::ParseBlock(TokenType terminator1,TokenType terminat
 
 		// Expect EOL after statement
 		if (_current.Type != TokenType::EOL && !IsBlockTerminator(terminator1, terminator2)) {
-			ReportError(Interp("Expected end of line, got: {}", _current.Text));
+			ReportError(Interp("Expected end of line, got: {}", _lexer.TextOf(_current)));
 			// Try to recover by skipping to next line
 			while (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
 				Advance();
@@ -532,7 +548,7 @@ List<ASTNode> ParserStorage::ParseElseClause(Boolean* ateEnd) {
 	} else {
 		// plain else - expect EOL then body
 		if (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
-			ReportError(Interp("Expected end of line after 'else', got: {}", _current.Text));
+			ReportError(Interp("Expected end of line after 'else', got: {}", _lexer.TextOf(_current)));
 		}
 		elseBody = ParseBlock(TokenType::END, TokenType::END);  // only END terminates
 	}
@@ -569,7 +585,7 @@ ASTNode ParserStorage::ParseWhileStatement() {
 
 	// Expect EOL after condition
 	if (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
-		ReportError(Interp("Expected end of line after while condition, got: {}", _current.Text));
+		ReportError(Interp("Expected end of line after while condition, got: {}", _lexer.TextOf(_current)));
 	}
 
 	List<ASTNode> body = ParseBlock(TokenType::END, TokenType::END);
@@ -580,7 +596,7 @@ ASTNode ParserStorage::ParseWhileStatement() {
 ASTNode ParserStorage::ParseForStatement() {
 	// Expect identifier (loop variable)
 	if (_current.Type != TokenType::IDENTIFIER) {
-		ReportError(Interp("Expected identifier after 'for', got: {}", _current.Text));
+		ReportError(Interp("Expected identifier after 'for', got: {}", _lexer.TextOf(_current)));
 		return  ForNode::New("_",  NumberNode::New(0),  List<ASTNode>::New());
 	}
 	String varName = _current.Text;
@@ -598,7 +614,7 @@ ASTNode ParserStorage::ParseForStatement() {
 
 	// Expect EOL after expression
 	if (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
-		ReportError(Interp("Expected end of line after for expression, got: {}", _current.Text));
+		ReportError(Interp("Expected end of line after for expression, got: {}", _lexer.TextOf(_current)));
 	}
 
 	List<ASTNode> body = ParseBlock(TokenType::END, TokenType::END);
@@ -632,7 +648,7 @@ ASTNode ParserStorage::ParseFunctionExpression() {
 
 	// Expect EOL after parameter list
 	if (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
-		ReportError(Interp("Expected end of line after function parameters, got: {}", _current.Text));
+		ReportError(Interp("Expected end of line after function parameters, got: {}", _lexer.TextOf(_current)));
 	}
 
 	// Parse body until "end function"
@@ -689,7 +705,7 @@ List<ASTNode> ParserStorage::ParseProgram() {
 		// Expect EOL or EOF after statement
 		// (block statements like while handle their own EOL consumption)
 		if (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
-			ReportError(Interp("Expected end of line, got: {}", _current.Text));
+			ReportError(Interp("Expected end of line, got: {}", _lexer.TextOf(_current)));
 			// Try to recover by skipping to next line
 			while (_current.Type != TokenType::EOL && _current.Type != TokenType::END_OF_INPUT) {
 				Advance();
@@ -712,14 +728,14 @@ ASTNode ParserStorage::Parse(String source) {
 
 	// Check for trailing tokens (except END_OF_INPUT or EOL)
 	if (_current.Type != TokenType::END_OF_INPUT && _current.Type != TokenType::EOL) {
-		ReportError(Interp("Unexpected token after statement: {}", _current.Text));
+		ReportError(Interp("Unexpected token after statement: {}", _lexer.TextOf(_current)));
 	}
 
 	return result;
 }
 String ParserStorage::TokenDescription(Token tok) {
 	if (tok.Type == TokenType::EOL || tok.Type == TokenType::END_OF_INPUT) return "EOL";
-	if (tok.Type == TokenType::NUMBER) return tok.Text;
+	if (tok.Type == TokenType::NUMBER) return _lexer.TextOf(tok);
 	if (tok.Type == TokenType::STRING) return StringUtils::Format("\"{0}\"", tok.Text);
 	if (tok.Type == TokenType::IDENTIFIER) return tok.Text;
 	// Keywords
@@ -739,16 +755,20 @@ String ParserStorage::TokenDescription(Token tok) {
 	if (tok.Type == TokenType::NOT) return "Keyword(not)";
 	if (tok.Type == TokenType::NEW) return "Keyword(new)";
 	if (tok.Type == TokenType::ISA) return "Keyword(isa)";
-	return tok.Text;
+	return _lexer.TextOf(tok);
 }
 String ParserStorage::GotExpected(String expected) {
 	return StringUtils::Format("got {0} where {1} is required", TokenDescription(_current), expected);
 }
 void ParserStorage::ReportError(String message) {
+	if (Detached) {
+		_detachedError = Boolean(true);
+		return;
+	}
 	if (Error.IsNull()) Error = ErrorTypes::CompilerError(message, FileName, _current.Line);
 }
 Boolean ParserStorage::HadError() {
-	return !Error.IsNull();
+	return _detachedError || !Error.IsNull();
 }
 
 } // end of namespace MiniScript
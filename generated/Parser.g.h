@@ -25,14 +25,20 @@ namespace MiniScript {
 class ParserStorage : public std::enable_shared_from_this<ParserStorage>, public IParser {
 	friend struct Parser;
 	private: Lexer _lexer;
+	private: Boolean _lexerReady = Boolean(false); // _lexer has been made, and can be Reset
 	private: Token _current;
 	private: TokenType _previousType;
 	private: Boolean _needMoreInput;
 	public: Value Error;
 	public: String FileName; // source file name, for error locations ("" if unnamed)
+	public: Boolean Detached = Boolean(false);
+	private: Boolean _detachedError = Boolean(false);
 	private: Dictionary<TokenType, PrefixParselet> _prefixParselets;
 	private: Dictionary<TokenType, InfixParselet> _infixParselets;
 
+	// Set to parse off the VM thread (see ImportPrefetch).  As in the Lexer, an
+	// error is then only noted: HadError reports it, but Error stays null.
+
 	// Parselet tables - indexed by TokenType
 
 	public: ParserStorage();
@@ -215,6 +221,8 @@ struct Parser : public IParser {
 
 	private: Lexer _lexer();
 	private: void set__lexer(Lexer _v);
+	private: Boolean _lexerReady(); // _lexer has been made, and can be Reset
+	private: void set__lexerReady(Boolean _v); // _lexer has been made, and can be Reset
 	private: Token _current();
 	private: void set__current(Token _v);
 	private: TokenType _previousType();
@@ -225,11 +233,18 @@ struct Parser : public IParser {
 	public: void set_Error(Value _v);
 	public: String FileName(); // source file name, for error locations ("" if unnamed)
 	public: void set_FileName(String _v); // source file name, for error locations ("" if unnamed)
+	public: Boolean Detached();
+	public: void set_Detached(Boolean _v);
+	private: Boolean _detachedError();
+	private: void set__detachedError(Boolean _v);
 	private: Dictionary<TokenType, PrefixParselet> _prefixParselets();
 	private: void set__prefixParselets(Dictionary<TokenType, PrefixParselet> _v);
 	private: Dictionary<TokenType, InfixParselet> _infixParselets();
 	private: void set__infixParselets(Dictionary<TokenType, InfixParselet> _v);
 
+	// Set to parse off the VM thread (see ImportPrefetch).  As in the Lexer, an
+	// error is then only noted: HadError reports it, but Error stays null.
+
 	// Parselet tables - indexed by TokenType
 
 	public: static Parser New() {
@@ -405,6 +420,8 @@ struct Parser : public IParser {
 inline ParserStorage* Parser::get() const { return static_cast<ParserStorage*>(storage.get()); }
 inline Lexer Parser::_lexer() { return get()->_lexer; }
 inline void Parser::set__lexer(Lexer _v) { get()->_lexer = _v; }
+inline Boolean Parser::_lexerReady() { return get()->_lexerReady; } // _lexer has been made, and can be Reset
+inline void Parser::set__lexerReady(Boolean _v) { get()->_lexerReady = _v; } // _lexer has been made, and can be Reset
 inline Token Parser::_current() { return get()->_current; }
 inline void Parser::set__current(Token _v) { get()->_current = _v; }
 inline TokenType Parser::_previousType() { return get()->_previousType; }
@@ -415,6 +432,10 @@ inline Value Parser::Error() { return get()->Error; }
 inline void Parser::set_Error(Value _v) { get()->Error = _v; }
 inline String Parser::FileName() { return get()->FileName; } // source file name, for error locations ("" if unnamed)
 inline void Parser::set_FileName(String _v) { get()->FileName = _v; } // source file name, for error locations ("" if unnamed)
+inline Boolean Parser::Detached() { return get()->Detached; }
+inline void Parser::set_Detached(Boolean _v) { get()->Detached = _v; }
+inline Boolean Parser::_detachedError() { return get()->_detachedError; }
+inline void Parser::set__detachedError(Boolean _v) { get()->_detachedError = _v; }
 inline Dictionary<TokenType, PrefixParselet> Parser::_prefixParselets() { return get()->_prefixParselets; }
 inline void Parser::set__prefixParselets(Dictionary<TokenType, PrefixParselet> _v) { get()->_prefixParselets = _v; }
 inline Dictionary<TokenType, InfixParselet> Parser::_infixParselets() { return get()->_infixParselets; }
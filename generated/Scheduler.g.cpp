@@ -0,0 +1,153 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Scheduler.cs
+
+#include "Scheduler.g.h"
+#include "VM.g.h"
+#include <thread>
+
+namespace MiniScript {
+
+SchedulerStorage::SchedulerStorage() {
+	_tasks =  List<Interpreter>::New();
+	_runTime =  List<double>::New();
+	_wakeAt =  List<double>::New();
+	_ready =  List<Int32>::New();
+	_timers =  List<Int32>::New();
+	_startTime = std::chrono::steady_clock::now();
+}
+Int32 SchedulerStorage::Add(Interpreter interp) {
+	_tasks.Add(interp);
+	_runTime.Add(0);
+	_wakeAt.Add(0);
+	_ready.Add(_tasks.Count() - 1);
+	_liveCount++;
+	return _tasks.Count() - 1;
+}
+Int32 SchedulerStorage::TaskCount() {
+	return _tasks.Count();
+}
+Interpreter SchedulerStorage::GetTask(Int32 task) {
+	return _tasks[task];
+}
+Int32 SchedulerStorage::LiveCount() {
+	return _liveCount;
+}
+Int32 SchedulerStorage::WaitingCount() {
+	return _timers.Count();
+}
+double SchedulerStorage::RunTime(Int32 task) {
+	return _runTime[task];
+}
+double SchedulerStorage::SecondsToNextWake() {
+	WakeDue();
+	if (_readyHead < _ready.Count()) return 0;
+	if (_timers.Count() == 0) return -1;
+	double seconds = WakeAt(0) - Now();
+	return seconds > 0 ? seconds : 0;
+}
+Int32 SchedulerStorage::RunOnce() {
+	WakeDue();
+	_blockedCount = 0;
+	Int32 count = _ready.Count() - _readyHead;
+	for (Int32 i = 0; i < count; i++) {
+		Int32 task = _ready[_readyHead];
+		_readyHead++;
+		RunTask(task);
+	}
+	if (_readyHead == _ready.Count()) {
+		_ready.Clear();
+		_readyHead = 0;
+	} else if (_readyHead > 1024 && _readyHead * 2 > _ready.Count()) {
+		_ready.RemoveRange(0, _readyHead);
+		_readyHead = 0;
+	}
+	return count;
+}
+void SchedulerStorage::RunUntilDone(double timeLimit) {
+	double endTime = Now() + timeLimit;
+	double idleSleep = 0;
+	while (_liveCount > 0) {
+		Int32 ran = RunOnce();
+		double wait = SecondsToNextWake();
+		if (wait < 0) break;
+		double left = endTime - Now();
+		if (left <= 0) break;
+		if (wait == 0 && ran > 0 && _blockedCount == ran) {
+			// Nothing could go on; back off rather than spin, but not past
+			// the earliest wait.
+			idleSleep = idleSleep * 2;
+			if (idleSleep < minIdleSleep) idleSleep = minIdleSleep;
+			if (idleSleep > maxIdleSleep) idleSleep = maxIdleSleep;
+			wait = idleSleep;
+			if (_timers.Count() > 0 && WakeAt(0) - Now() < wait) wait = WakeAt(0) - Now();
+		} else {
+			idleSleep = 0;
+		}
+		if (wait > left) wait = left;
+		if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+	}
+}
+double SchedulerStorage::Now() {
+	auto now = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(now - _startTime).count();
+}
+void SchedulerStorage::RunTask(Int32 task) {
+	Interpreter interp = _tasks[task];
+	double start = Now();
+	interp.RunSlice(timeSlice);
+	double end = Now();
+	_runTime[task] = _runTime[task] + (end - start);
+	if (interp.Done()) {
+		_liveCount--;
+		return;
+	}
+	double wake = interp.vm().SecondsToWake();
+	if (wake > 0) {
+		_wakeAt[task] = end + wake;
+		PushTimer(task);
+	} else {
+		if (interp.vm().IsBlocked()) _blockedCount++;
+		_ready.Add(task);
+	}
+}
+void SchedulerStorage::WakeDue() {
+	if (_timers.Count() == 0) return;
+	double now = Now();
+	while (_timers.Count() > 0 && WakeAt(0) <= now) _ready.Add(PopTimer());
+}
+double SchedulerStorage::WakeAt(Int32 heapPos) {
+	Int32 task = _timers[heapPos];
+	return _wakeAt[task];
+}
+void SchedulerStorage::PushTimer(Int32 task) {
+	_timers.Add(task);
+	Int32 pos = _timers.Count() - 1;
+	while (pos > 0) {
+		Int32 parent = (pos - 1) / 2;
+		if (WakeAt(parent) <= WakeAt(pos)) break;
+		_timers[pos] = _timers[parent];
+		_timers[parent] = task;
+		pos = parent;
+	}
+}
+Int32 SchedulerStorage::PopTimer() {
+	Int32 result = _timers[0];
+	Int32 last = _timers[_timers.Count() - 1];
+	_timers.RemoveAt(_timers.Count() - 1);
+	Int32 count = _timers.Count();
+	if (count == 0) return result;
+	_timers[0] = last;
+	Int32 pos = 0;
+	while (Boolean(true)) {
+		Int32 child = pos * 2 + 1;
+		if (child >= count) break;
+		if (child + 1 < count && WakeAt(child + 1) < WakeAt(child)) child++;
+		if (WakeAt(pos) <= WakeAt(child)) break;
+		_timers[pos] = _timers[child];
+		_timers[child] = last;
+		pos = child;
+	}
+	return result;
+}
+
+} // end of namespace MiniScript
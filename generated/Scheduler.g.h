@@ -0,0 +1,232 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: Scheduler.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// Scheduler.cs
+// Runs many interpreters on one thread, taking turns -- for a host with a
+// script per game agent, say, where most scripts spend most of their time
+// in `wait`.  Driving each interpreter with RunUntilDone would have the
+// thread sit through every wait in turn; the scheduler instead runs only
+// the interpreters that have something to do.  Each gets a turn of up to
+// timeSlice seconds (Interpreter.RunSlice), which ends early if the script
+// yields or starts a wait.  One that is waiting goes into a timer heap,
+// keyed by when its wait is due (VM.SecondsToWake), and is not run again
+// until then; one that yielded goes to the back of the ready list, to run
+// in the next round.  When nothing is ready, RunUntilDone sleeps until the
+// earliest wait is due.  A task left blocked in some other intrinsic, such
+// as receive on an empty channel, has no time to wake; it stays on the
+// ready list, and when a round runs nothing but such tasks, RunUntilDone
+// backs off, sleeping a little longer each such round in a row.
+// The scheduler also keeps the time spent running each interpreter, so a
+// host can see which scripts are costing it.
+// Like the interpreters it runs, a scheduler belongs to one thread.
+
+#include "Interpreter.g.h"
+#include <chrono>
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class SchedulerStorage : public std::enable_shared_from_this<SchedulerStorage> {
+	friend struct Scheduler;
+	public: double timeSlice = 0.01;
+	public: double minIdleSleep = 0.0005;
+	public: double maxIdleSleep = 0.01;
+	private: List<Interpreter> _tasks; // every interpreter added, by task number
+	private: List<double> _runTime; // seconds spent running each task
+	private: List<double> _wakeAt; // for a task in _timers, when (by Now) its wait is due
+	private: List<Int32> _ready; // tasks to run, in order, from _readyHead on
+	private: Int32 _readyHead = 0;
+	private: List<Int32> _timers; // waiting tasks: a binary min-heap on _wakeAt
+	private: Int32 _liveCount = 0; // tasks not yet done
+	private: Int32 _blockedCount = 0; // tasks left blocked in the last round
+	private: std::chrono::steady_clock::time_point _startTime;
+
+	// Longest turn an interpreter gets before the next one runs, in seconds.
+
+	// Shortest and longest sleep after a round in which every task that ran
+	// was left blocked, in seconds.
+
+	public: SchedulerStorage();
+
+	// Add an interpreter (not yet run, or partway through), ready to run.
+	// Returns its task number.
+	public: Int32 Add(Interpreter interp);
+
+	public: Int32 TaskCount();
+
+	public: Interpreter GetTask(Int32 task);
+
+	// How many tasks have not finished.
+	public: Int32 LiveCount();
+
+	// How many tasks are in a wait that is not yet due.
+	public: Int32 WaitingCount();
+
+	// Seconds spent running the given task so far.
+	public: double RunTime(Int32 task);
+
+	// Seconds until some task is next ready to run: 0 if one is ready now,
+	// or -1 if every task has finished.
+	public: double SecondsToNextWake();
+
+	// Give each task that is ready now one turn.  Tasks that yield during
+	// this round wait for the next one.  Returns how many tasks ran.
+	public: Int32 RunOnce();
+
+	// Run until every task has finished, or timeLimit seconds have passed,
+	// sleeping whenever no task is ready, or every task that ran is blocked.
+	public: void RunUntilDone(double timeLimit=60);
+
+	// ── Internals ────────────────────────────────────────────────────────────
+
+	private: double Now();
+
+	// Run one turn of a task, then file it as done, waiting, or ready.
+	private: void RunTask(Int32 task);
+
+	// Move each waiting task whose wait is due to the ready list.
+	private: void WakeDue();
+
+	// When the task at the given position in the heap is due.
+	private: double WakeAt(Int32 heapPos);
+
+	private: void PushTimer(Int32 task);
+
+	private: Int32 PopTimer();
+}; // end of class SchedulerStorage
+
+struct Scheduler {
+	friend class SchedulerStorage;
+	protected: std::shared_ptr<SchedulerStorage> storage;
+  public:
+	Scheduler(std::shared_ptr<SchedulerStorage> stor) : storage(stor) {}
+	Scheduler() : storage(nullptr) {}
+	Scheduler(std::nullptr_t) : storage(nullptr) {}
+	friend bool IsNull(const Scheduler& inst) { return inst.storage == nullptr; }
+	private: SchedulerStorage* get() const;
+
+	public: double timeSlice();
+	public: void set_timeSlice(double _v);
+	public: double minIdleSleep();
+	public: void set_minIdleSleep(double _v);
+	public: double maxIdleSleep();
+	public: void set_maxIdleSleep(double _v);
+	private: List<Interpreter> _tasks(); // every interpreter added, by task number
+	private: void set__tasks(List<Interpreter> _v); // every interpreter added, by task number
+	private: List<double> _runTime(); // seconds spent running each task
+	private: void set__runTime(List<double> _v); // seconds spent running each task
+	private: List<double> _wakeAt(); // for a task in _timers, when (by Now) its wait is due
+	private: void set__wakeAt(List<double> _v); // for a task in _timers, when (by Now) its wait is due
+	private: List<Int32> _ready(); // tasks to run, in order, from _readyHead on
+	private: void set__ready(List<Int32> _v); // tasks to run, in order, from _readyHead on
+	private: Int32 _readyHead();
+	private: void set__readyHead(Int32 _v);
+	private: List<Int32> _timers(); // waiting tasks: a binary min-heap on _wakeAt
+	private: void set__timers(List<Int32> _v); // waiting tasks: a binary min-heap on _wakeAt
+	private: Int32 _liveCount(); // tasks not yet done
+	private: void set__liveCount(Int32 _v); // tasks not yet done
+	private: Int32 _blockedCount(); // tasks left blocked in the last round
+	private: void set__blockedCount(Int32 _v); // tasks left blocked in the last round
+
+	// Longest turn an interpreter gets before the next one runs, in seconds.
+
+	// Shortest and longest sleep after a round in which every task that ran
+	// was left blocked, in seconds.
+
+	public: static Scheduler New() {
+		return Scheduler(std::make_shared<SchedulerStorage>());
+	}
+
+	// Add an interpreter (not yet run, or partway through), ready to run.
+	// Returns its task number.
+	public: inline Int32 Add(Interpreter interp);
+
+	public: inline Int32 TaskCount();
+
+	public: inline Interpreter GetTask(Int32 task);
+
+	// How many tasks have not finished.
+	public: inline Int32 LiveCount();
+
+	// How many tasks are in a wait that is not yet due.
+	public: inline Int32 WaitingCount();
+
+	// Seconds spent running the given task so far.
+	public: inline double RunTime(Int32 task);
+
+	// Seconds until some task is next ready to run: 0 if one is ready now,
+	// or -1 if every task has finished.
+	public: inline double SecondsToNextWake();
+
+	// Give each task that is ready now one turn.  Tasks that yield during
+	// this round wait for the next one.  Returns how many tasks ran.
+	public: inline Int32 RunOnce();
+
+	// Run until every task has finished, or timeLimit seconds have passed,
+	// sleeping whenever no task is ready, or every task that ran is blocked.
+	public: inline void RunUntilDone(double timeLimit=60);
+
+	// ── Internals ────────────────────────────────────────────────────────────
+
+	private: inline double Now();
+
+	// Run one turn of a task, then file it as done, waiting, or ready.
+	private: inline void RunTask(Int32 task);
+
+	// Move each waiting task whose wait is due to the ready list.
+	private: inline void WakeDue();
+
+	// When the task at the given position in the heap is due.
+	private: inline double WakeAt(Int32 heapPos);
+
+	private: inline void PushTimer(Int32 task);
+
+	private: inline Int32 PopTimer();
+}; // end of struct Scheduler
+
+// INLINE METHODS
+
+inline SchedulerStorage* Scheduler::get() const { return static_cast<SchedulerStorage*>(storage.get()); }
+inline double Scheduler::timeSlice() { return get()->timeSlice; }
+inline void Scheduler::set_timeSlice(double _v) { get()->timeSlice = _v; }
+inline double Scheduler::minIdleSleep() { return get()->minIdleSleep; }
+inline void Scheduler::set_minIdleSleep(double _v) { get()->minIdleSleep = _v; }
+inline double Scheduler::maxIdleSleep() { return get()->maxIdleSleep; }
+inline void Scheduler::set_maxIdleSleep(double _v) { get()->maxIdleSleep = _v; }
+inline List<Interpreter> Scheduler::_tasks() { return get()->_tasks; } // every interpreter added, by task number
+inline void Scheduler::set__tasks(List<Interpreter> _v) { get()->_tasks = _v; } // every interpreter added, by task number
+inline List<double> Scheduler::_runTime() { return get()->_runTime; } // seconds spent running each task
+inline void Scheduler::set__runTime(List<double> _v) { get()->_runTime = _v; } // seconds spent running each task
+inline List<double> Scheduler::_wakeAt() { return get()->_wakeAt; } // for a task in _timers, when (by Now) its wait is due
+inline void Scheduler::set__wakeAt(List<double> _v) { get()->_wakeAt = _v; } // for a task in _timers, when (by Now) its wait is due
+inline List<Int32> Scheduler::_ready() { return get()->_ready; } // tasks to run, in order, from _readyHead on
+inline void Scheduler::set__ready(List<Int32> _v) { get()->_ready = _v; } // tasks to run, in order, from _readyHead on
+inline Int32 Scheduler::_readyHead() { return get()->_readyHead; }
+inline void Scheduler::set__readyHead(Int32 _v) { get()->_readyHead = _v; }
+inline List<Int32> Scheduler::_timers() { return get()->_timers; } // waiting tasks: a binary min-heap on _wakeAt
+inline void Scheduler::set__timers(List<Int32> _v) { get()->_timers = _v; } // waiting tasks: a binary min-heap on _wakeAt
+inline Int32 Scheduler::_liveCount() { return get()->_liveCount; } // tasks not yet done
+inline void Scheduler::set__liveCount(Int32 _v) { get()->_liveCount = _v; } // tasks not yet done
+inline Int32 Scheduler::_blockedCount() { return get()->_blockedCount; } // tasks left blocked in the last round
+inline void Scheduler::set__blockedCount(Int32 _v) { get()->_blockedCount = _v; } // tasks left blocked in the last round
+inline Int32 Scheduler::Add(Interpreter interp) { return get()->Add(interp); }
+inline Int32 Scheduler::TaskCount() { return get()->TaskCount(); }
+inline Interpreter Scheduler::GetTask(Int32 task) { return get()->GetTask(task); }
+inline Int32 Scheduler::LiveCount() { return get()->LiveCount(); }
+inline Int32 Scheduler::WaitingCount() { return get()->WaitingCount(); }
+inline double Scheduler::RunTime(Int32 task) { return get()->RunTime(task); }
+inline double Scheduler::SecondsToNextWake() { return get()->SecondsToNextWake(); }
+inline Int32 Scheduler::RunOnce() { return get()->RunOnce(); }
+inline void Scheduler::RunUntilDone(double timeLimit) { return get()->RunUntilDone(timeLimit); }
+inline double Scheduler::Now() { return get()->Now(); }
+inline void Scheduler::RunTask(Int32 task) { return get()->RunTask(task); }
+inline void Scheduler::WakeDue() { return get()->WakeDue(); }
+inline double Scheduler::WakeAt(Int32 heapPos) { return get()->WakeAt(heapPos); }
+inline void Scheduler::PushTimer(Int32 task) { return get()->PushTimer(task); }
+inline Int32 Scheduler::PopTimer() { return get()->PopTimer(); }
+
+} // end of namespace MiniScript
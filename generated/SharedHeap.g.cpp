@@ -0,0 +1,199 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: SharedHeap.cs
+
+#include "SharedHeap.g.h"
+#include "GCManager.g.h"
+#include "value.h"
+#include <mutex>
+
+namespace MiniScript {
+
+const Int32 SharedHeap::FirstIndex = 0x40000000;
+const Int32 SharedHeap::ChunkBits = 12;
+const Int32 SharedHeap::ChunkSize = 4096; // 1 << ChunkBits
+const Int32 SharedHeap::ChunkMask = 4095;
+const Int32 SharedHeap::MaxChunks = 4096; // so up to 16M items per set
+Int32 SharedHeap::SetCapacity = MaxChunks * ChunkSize;
+Int32 SharedHeap::_stringCount = 0;
+Int32 SharedHeap::_listCount = 0;
+Int32 SharedHeap::_mapCount = 0;
+Dictionary<String, Int32> SharedHeap::_stringSlots =  Dictionary<String, Int32>::New();
+static std::mutex _mutex;
+static GCString* _strings[SharedHeap::MaxChunks];
+static GCList* _lists[SharedHeap::MaxChunks];
+static GCMap* _maps[SharedHeap::MaxChunks];
+GCString SharedHeap::GetString(Int32 idx) {
+	idx -= FirstIndex;
+	return _strings[idx >> ChunkBits][idx & ChunkMask];
+}
+GCList SharedHeap::GetList(Int32 idx) {
+	idx -= FirstIndex;
+	return _lists[idx >> ChunkBits][idx & ChunkMask];
+}
+GCMap SharedHeap::GetMap(Int32 idx) {
+	idx -= FirstIndex;
+	return _maps[idx >> ChunkBits][idx & ChunkMask];
+}
+Int32 SharedHeap::ItemCount() {
+	Lock();
+	Int32 n = _stringCount + _listCount + _mapCount;
+	Unlock();
+	return n;
+}
+Boolean SharedHeap::TryPublish(Value v,Value* shared) {
+	*shared = v;
+	if (!v.IsGCObject() || v.IsShared()) return Boolean(true);
+	Dictionary<Int32, Value> lists =  Dictionary<Int32, Value>::New();
+	Dictionary<Int32, Value> maps =  Dictionary<Int32, Value>::New();
+	Dictionary<String, Boolean> strings =  Dictionary<String, Boolean>::New();
+	List<String> stringList =  List<String>::New();
+	if (!CanPublish(v, lists, maps, strings, stringList)) return Boolean(false);
+	Int32 listsNeeded = lists.Count();
+	Int32 mapsNeeded = maps.Count();
+	lists.Clear();
+	maps.Clear();
+	List<Value> made =  List<Value>::New();
+	Lock();
+	// Check for room first, so that a value too big to fit leaves the
+	// region as it was (Copy claims slots as it goes).
+	Int32 capacity = SetCapacity < MaxChunks * ChunkSize ? SetCapacity : MaxChunks * ChunkSize;
+	Int32 stringsNeeded = 0;
+	for (Int32 i = 0; i < stringList.Count(); i++) {
+		if (!_stringSlots.ContainsKey(stringList[i])) stringsNeeded++;
+	}
+	if (stringsNeeded > capacity - _stringCount || listsNeeded > capacity - _listCount
+			|| mapsNeeded > capacity - _mapCount) {
+		Unlock();
+		return Boolean(false);
+	}
+	*shared = Copy(v, lists, maps, made);
+	// Cache each new container's hash now, with the whole graph in place
+	// (a hash looks at the counts of nested containers), since a shared
+	// item is never written again.
+	for (Int32 i = 0; i < made.Count(); i++) StoreHash(made[i]);
+	Unlock();
+	return Boolean(true);
+}
+Boolean SharedHeap::Shareable(Value v) {
+	return CanPublish(v,  Dictionary<Int32, Value>::New(),  Dictionary<Int32, Value>::New(),
+		 Dictionary<String, Boolean>::New(),  List<String>::New());
+}
+Boolean SharedHeap::CanPublish(Value v,Dictionary<Int32, Value> lists,Dictionary<Int32, Value> maps,Dictionary<String, Boolean> strings,List<String> stringList) {
+	if (!v.IsGCObject() || v.IsShared()) return Boolean(true);
+	if (v.IsString()) {
+		String s = GCManager::GetString(v).Data;
+		if (!strings.ContainsKey(s)) {
+			strings[s] = Boolean(true);
+			stringList.Add(s);
+		}
+		return Boolean(true);
+	}
+	if (v.IsList()) {
+		if (lists.ContainsKey(v.ItemIndex())) return Boolean(true);
+		GCList l = GCManager::Lists.Get(v.ItemIndex());
+		if (!l.Frozen) return Boolean(false);
+		lists[v.ItemIndex()] = v;
+		Int32 count = l.Count();
+		for (Int32 i = 0; i < count; i++) {
+			if (!CanPublish(l.Get(i), lists, maps, strings, stringList)) return Boolean(false);
+		}
+		return Boolean(true);
+	}
+	if (v.IsMap()) {
+		if (maps.ContainsKey(v.ItemIndex())) return Boolean(true);
+		GCMap m = GCManager::Maps.Get(v.ItemIndex());
+		if (!m.Frozen || !IsNull(m._vmb) || !IsNull(m._gb)) return Boolean(false);
+		maps[v.ItemIndex()] = v;
+		for (Int32 i = m.NextEntry(-1); i != -1; i = m.NextEntry(i)) {
+			if (!CanPublish(m.KeyAt(i), lists, maps, strings, stringList)) return Boolean(false);
+			if (!CanPublish(m.ValueAt(i), lists, maps, strings, stringList)) return Boolean(false);
+		}
+		return Boolean(true);
+	}
+	return Boolean(false);	// function, error or handle
+}
+Value SharedHeap::Copy(Value v,Dictionary<Int32, Value> lists,Dictionary<Int32, Value> maps,List<Value> made) {
+	if (!v.IsGCObject() || v.IsShared()) return v;
+	if (v.IsString()) return ShareString(GCManager::GetString(v).Data);	// (a heap string: tiny ones are not GC objects)
+	Value copy;
+	Int32 slot;
+	if (v.IsList()) {
+		if (lists.TryGetValue(v.ItemIndex(), &copy)) return copy;
+		GCList src = GCManager::Lists.Get(v.ItemIndex());
+		Int32 count = src.Count();
+		slot = NewSlot(GCManager::ListSet);
+		copy = Value::make_gc(GCManager::ListSet, FirstIndex + slot);
+		lists[v.ItemIndex()] = copy;	// (before the items, which may lead back here)
+		made.Add(copy);
+		GCList item = GCList();
+		item.Init(count);
+		for (Int32 i = 0; i < count; i++) item.Push(Copy(src.Get(i), lists, maps, made));
+		item.Frozen = Boolean(true);
+		_lists[slot >> ChunkBits][slot & ChunkMask] = item;
+		return copy;
+	}
+	if (v.IsMap()) {
+		if (maps.TryGetValue(v.ItemIndex(), &copy)) return copy;
+		GCMap src = GCManager::Maps.Get(v.ItemIndex());
+		slot = NewSlot(GCManager::MapSet);
+		copy = Value::make_gc(GCManager::MapSet, FirstIndex + slot);
+		maps[v.ItemIndex()] = copy;
+		made.Add(copy);
+		GCMap item = GCMap();
+		item.Init(src.Count());
+		for (Int32 i = src.NextEntry(-1); i != -1; i = src.NextEntry(i)) {
+			Value key = Copy(src.KeyAt(i), lists, maps, made);
+			item.Set(key, Copy(src.ValueAt(i), lists, maps, made));
+		}
+		item.Frozen = Boolean(true);
+		_maps[slot >> ChunkBits][slot & ChunkMask] = item;
+		return copy;
+	}
+	return v;
+}
+void SharedHeap::StoreHash(Value v) {
+	UInt32 h = (UInt32)v.Hash();	// (not cached by the set: see GCListSet.SetHashCache)
+	Int32 slot = v.ItemIndex() - FirstIndex;
+	if (v.IsList()) {
+		GCList item = _lists[slot >> ChunkBits][slot & ChunkMask];
+		item.HashCache = h;
+		_lists[slot >> ChunkBits][slot & ChunkMask] = item;
+	} else {
+		GCMap item = _maps[slot >> ChunkBits][slot & ChunkMask];
+		item.HashCache = h;
+		_maps[slot >> ChunkBits][slot & ChunkMask] = item;
+	}
+}
+Value SharedHeap::ShareString(String s) {
+	Int32 slot;
+	if (!_stringSlots.TryGetValue(s, &slot)) {
+		slot = NewSlot(GCManager::BigStringSet);
+		GCString item = GCString();
+		item.Data = s;
+		_strings[slot >> ChunkBits][slot & ChunkMask] = item;
+		_stringSlots[s] = slot;
+	}
+	return Value::make_gc(GCManager::BigStringSet, FirstIndex + slot);
+}
+Int32 SharedHeap::NewSlot(Int32 setIdx) {
+	Int32 slot;
+	if (setIdx == GCManager::ListSet) {
+		slot = _listCount++;
+		if ((slot & ChunkMask) == 0) _lists[slot >> ChunkBits] = new GCList[ChunkSize];
+	} else if (setIdx == GCManager::MapSet) {
+		slot = _mapCount++;
+		if ((slot & ChunkMask) == 0) _maps[slot >> ChunkBits] = new GCMap[ChunkSize];
+	} else {
+		slot = _stringCount++;
+		if ((slot & ChunkMask) == 0) _strings[slot >> ChunkBits] = new GCString[ChunkSize];
+	}
+	return slot;
+}
+void SharedHeap::Lock() {
+	_mutex.lock();
+}
+void SharedHeap::Unlock() {
+	_mutex.unlock();
+}
+
+} // end of namespace MiniScript
@@ -0,0 +1,125 @@
+// AUTO-GENERATED FILE.  DO NOT MODIFY.
+// Transpiled from: SharedHeap.cs
+
+#pragma once
+#include "core_includes.h"
+#include "forward_decs.g.h"
+// SharedHeap.cs
+// A heap region that every isolate can read.  Each thread's GC heap is its
+// own (see GCManager), so a Value made on one thread means nothing on
+// another -- but a host often has large read-only data (config tables,
+// lookup maps, word lists) that every interpreter needs, and copying it into
+// each isolate wastes time and memory.  A frozen value can instead be
+// published here once, with TryPublish; the Value that comes back may then
+// be handed to any number of isolates, which read it in place, with no
+// copying and no locking.
+// A shared item is an item of the ordinary BigStrings, Lists or Maps set
+// whose index is FirstIndex or above.  The sets send such an index here
+// instead of to their own items (see GCSet.cs), so a shared value is a
+// string, list or map like any other to all the code that uses one.  What
+// it is not is mutable or collectable: a shared list or map is always
+// frozen, and the region is immortal -- its items are never marked, swept,
+// or freed, and live until the process exits.  So publish data that lives
+// as long as the host does, not a value per request.
+// Publishing deep-copies the value into the region (under a lock; it is
+// the only thing here that takes one).  A list or map must be frozen, and
+// so must every list or map it holds; functions, errors and handles cannot
+// be published, nor can a globals or locals map.  Strings are shared by
+// content, so a string published twice is stored once.  Numbers, null, tiny
+// strings and values already shared are their own published form.  When the
+// region has no room for a value, publishing it fails and changes nothing.
+// Reading needs no lock because nothing a reader can reach ever changes:
+// items are written once, before TryPublish returns, into chunks that never
+// move.  The host must still pass the published Value to the other thread
+// by something that synchronizes (starting the thread, a lock, a queue), as
+// with any data one thread hands another.
+// Short strings are not canonical across the region: a shared string is a
+// big heap string whatever its length, while its isolate-local twin may be
+// interned.  Equality allows for this (see Value.ScalarEqual).
+// See notes/MEMORY_SYSTEMS.md, "Isolates".
+
+#include "GCItems.g.h"
+
+namespace MiniScript {
+
+// DECLARATIONS
+
+class SharedHeap {
+	public: static const Int32 FirstIndex;
+	private: static const Int32 ChunkBits;
+	private: static const Int32 ChunkSize; // 1 << ChunkBits
+	private: static const Int32 ChunkMask;
+	public: static const Int32 MaxChunks; // so up to 16M items per set
+	public: static Int32 SetCapacity;
+	private: static Int32 _stringCount;
+	private: static Int32 _listCount;
+	private: static Int32 _mapCount;
+	private: static Dictionary<String, Int32> _stringSlots;
+
+	// Item indices from here up are shared (must match SHARED_ITEM_BASE in
+	// value.h).  No isolate's own set grows anywhere near this far.
+
+	// Items are stored in chunks of ChunkSize, each allocated when needed
+	// and never moved or resized, so a reader never sees storage reallocate.
+
+	// The most items each set may hold.  A host may lower it, before
+	// publishing anything, to bound the memory the region can take.
+
+	// Items in use in each set.  Written only under the lock.
+
+	// Shared string slot by content, so each distinct string is stored once.
+
+	// ── Reading (any thread) ──────────────────────────────────────────────────
+
+	public: static GCString GetString(Int32 idx);
+
+	public: static GCList GetList(Int32 idx);
+
+	public: static GCMap GetMap(Int32 idx);
+
+	// Number of items in the region (all three sets).
+	public: static Int32 ItemCount();
+
+	// ── Publishing ───────────────────────────────────────────────────────────
+
+	// Publish v, a value on the calling thread's heap, and set `shared` to
+	// its published form.  Returns false, publishing nothing, if v is or holds
+	// something that cannot be shared (see above), or if the region has no
+	// room for it; then `shared` is v.  Shareable tells the two apart.
+	public: static Boolean TryPublish(Value v, Value* shared);
+
+	// Whether v is or holds only things that can be published, so that
+	// TryPublish fails on it only if the region is full.
+	public: static Boolean Shareable(Value v);
+
+	// Whether v can be published; lists and maps hold those already checked.
+	// Each distinct heap string found is added to stringList (and strings).
+	private: static Boolean CanPublish(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps, Dictionary<String, Boolean> strings, List<String> stringList);
+
+	// The shared copy of v (under the lock), made at most once per list or
+	// map.  Each new list and map is added to `made`.  A computed list is
+	// stored materialized.
+	private: static Value Copy(Value v, Dictionary<Int32, Value> lists, Dictionary<Int32, Value> maps, List<Value> made);
+
+	// Compute and store the hash of a container made by Copy (under the lock).
+	private: static void StoreHash(Value v);
+
+	// The shared string with content s (under the lock).
+	private: static Value ShareString(String s);
+
+	// Claim the next slot of the given set (under the lock), allocating a
+	// new chunk when the last one is full.  Returns the slot number, counting
+	// from 0 (the item index is FirstIndex + slot).  TryPublish has already
+	// made sure there is room.
+	private: static Int32 NewSlot(Int32 setIdx);
+
+	// ── Locking ──────────────────────────────────────────────────────────────
+
+	private: static void Lock();
+
+	private: static void Unlock();
+}; // end of struct SharedHeap
+
+// INLINE METHODS
+
+} // end of namespace MiniScript
@@ -6,6 +6,7 @@
 #include "IntrinsicAPI.g.h"
 #include "VM.g.h"
 #include "Interpreter.g.h"
+#include "ImportPrefetch.g.h"
 #include "Parser.g.h"
 #include "CodeGenerator.g.h"
 #include "CodeEmitter.g.h"
@@ -59,25 +60,27 @@ extern "C" {
 namespace MiniScript {
 
 List<String> ShellIntrinsics::_shellArgStrings = nullptr;
-Value ShellIntrinsics::_shellArgs = Value::Null;
-Value ShellIntrinsics::_envMap = Value::Null;
+thread_local Value ShellIntrinsics::_shellArgs;
+thread_local Value ShellIntrinsics::_envMap;
 const String ShellIntrinsics::kDefaultImportPath = "$MS_SCRIPT_DIR:$MS_SCRIPT_DIR/lib:$MS_EXE_DIR/lib";
 // C++ exec state: parallel arrays capped at 64 concurrent jobs.
-static FILE* _cppExecPipes[64];
-static String _cppExecOutputs[64];
-static Int32 _cppExecStatus[64];
-static bool _cppExecDone[64];
-static Int32 _execJobCount = 0;
-Value ShellIntrinsics::_fileModuleMap = Value::Null;
-Value ShellIntrinsics::_fileHandleClassMap = Value::Null;
-Value ShellIntrinsics::_rawDataClassMap = Value::Null;
-Int32 ShellIntrinsics::_rdStart = -1, _fhStart = -1, _fmStart = -1;
-List<String> ShellIntrinsics::_rdKeys = nullptr;
-List<String> ShellIntrinsics::_fhKeys = nullptr;
-List<String> ShellIntrinsics::_fmKeys = nullptr;
-Value ShellIntrinsics::_keyModuleMap = Value::Null;
-Int32 ShellIntrinsics::_keyStart = -1;
-List<String> ShellIntrinsics::_keyKeys = nullptr;
+static thread_local FILE* _cppExecPipes[64];
+static thread_local String _cppExecOutputs[64];
+static thread_local Int32 _cppExecStatus[64];
+static thread_local bool _cppExecDone[64];
+static thread_local Int32 _execJobCount = 0;
+thread_local Value ShellIntrinsics::_fileModuleMap;
+thread_local Value ShellIntrinsics::_fileHandleClassMap;
+thread_local Value ShellIntrinsics::_rawDataClassMap;
+thread_local Int32 ShellIntrinsics::_rdStart;
+thread_local Int32 ShellIntrinsics::_fhStart;
+thread_local Int32 ShellIntrinsics::_fmStart;
+thread_local List<String> ShellIntrinsics::_rdKeys;
+thread_local List<String> ShellIntrinsics::_fhKeys;
+thread_local List<String> ShellIntrinsics::_fmKeys;
+thread_local Value ShellIntrinsics::_keyModuleMap;
+thread_local Int32 ShellIntrinsics::_keyStart;
+thread_local List<String> ShellIntrinsics::_keyKeys;
 struct CppFileHandle { FILE* f; };
 struct CppRawBuf    { uint8_t* bytes; int length; };
 void ShellIntrinsics::SetShellArgs(List<String> args,Int32 startIdx) {
@@ -252,6 +255,28 @@ List<String> ShellIntrinsics::SplitImportPath(String s) {
 	}
 	return result;
 }
+List<String> ShellIntrinsics::ImportSearchDirs() {
+	Value pathVal;
+	String searchPath;
+	if (!GetEnvMap().TryGet(Value::make_string("MS_IMPORT_PATH"), &pathVal) || pathVal.IsNull()) {
+		searchPath = kDefaultImportPath;	// (shouldn't happen; GetEnvMap seeds it)
+	} else {
+		searchPath = pathVal.AsCString();
+	}
+	List<String> libDirs = SplitImportPath(searchPath);
+	List<String> result =  List<String>::New();
+	for (Int32 i = 0; i < libDirs.Count(); i++) {
+		String dir = libDirs[i];
+		if (dir.Length() == 0) dir = ".";
+		else if (!dir.EndsWith("/") && !dir.EndsWith("\\")) dir += "/";
+		result.Add(ExpandVariables(dir));
+	}
+	return result;
+}
+void ShellIntrinsics::PrefetchImports(String source) {
+	if (ImportPrefetch::GetThreadCount() <= 0) return;
+	ImportPrefetch::Start(source, ImportSearchDirs());
+}
 String ShellIntrinsics::ExpandVariables(String path) {
 	Value envMap = GetEnvMap();
 	Value varVal;
@@ -292,11 +317,12 @@ String ShellIntrinsics::ExpandVariables(String path) {
 String ShellIntrinsics::TryReadSource(String path) {
 	FILE* handle = fopen(path.c_str(), "r");
 	if (!handle) return String("");
-	String result;
+	std::string text;
 	char buf[4096];
-	while (fgets(buf, sizeof(buf), handle)) result += buf;
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), handle)) > 0) text.append(buf, n);
 	fclose(handle);
-	return result;
+	return String(text.data(), text.size());
 }
 void ShellIntrinsics::FileHandleFinalizer(object userData) {
 	CppFileHandle* h = (CppFileHandle*)userData;
@@ -1510,6 +1536,7 @@ Double ShellIntrinsics::NowSeconds() {
 	return (double)t;
 }
 void ShellIntrinsics::Init() {
+	InvalidateCaches();	// (a thread-static Value starts out as 0 in C#, not null)
 	GCManager::RegisterMarkCallback(ShellIntrinsics::MarkRoots, nullptr);
 	CoreIntrinsics::RegisterInvalidateCallback(ShellIntrinsics::InvalidateCaches);
 	InitFileIntrinsics();
@@ -1645,23 +1672,12 @@ void ShellIntrinsics::Init() {
 		if (libname.Length() == 0) {
 			return IntrinsicResult(ErrorTypes::FileError("import: no library name given"));
 		}
-		// Determine the search path.
-		Value pathVal;
-		String searchPath;
-		if (!GetEnvMap().TryGet(Value::make_string("MS_IMPORT_PATH"), &pathVal) || pathVal.IsNull()) {
-			searchPath = kDefaultImportPath;	// (shouldn't happen; GetEnvMap seeds it)
-		} else {
-			searchPath = pathVal.AsCString();
-		}
-		List<String> libDirs = SplitImportPath(searchPath);
 		// Find and read the module source file.
+		List<String> libDirs = ImportSearchDirs();
 		String source = "";
 		Boolean found = Boolean(false);
 		for (Int32 i = 0; i < libDirs.Count(); i++) {
-			String dir = libDirs[i];
-			if (dir.Length() == 0) dir = ".";
-			else if (!dir.EndsWith("/") && !dir.EndsWith("\\")) dir += "/";
-			String path = ExpandVariables(dir) + libname + ".ms";
+			String path = libDirs[i] + libname + ".ms";
 			String src = TryReadSource(path);
 			if (src.LengthB() == 0) continue;
 			source = src;
@@ -1671,9 +1687,11 @@ void ShellIntrinsics::Init() {
 		if (!found) {
 			return IntrinsicResult(ErrorTypes::FileError(StringUtils::Format("import: library not found: {0}", libname)));
 		}
-		// Parse and compile the module to its @main FuncDef.
+		// Parse and compile the module to its @main FuncDef -- or only
+		// compile it, if ImportPrefetch has already parsed this source.
 		Value compileErr;
-		FuncDef moduleMain = Interpreter::CompileToFunc(source, libname + ".ms", &compileErr);
+		List<ASTNode> parsed = ImportPrefetch::Take(libname, source);
+		FuncDef moduleMain = Interpreter::CompileToFunc(source, libname + ".ms", parsed, &compileErr);
 		if (IsNull(moduleMain)) {
 			// Return the error as our result: as a bare statement (the usual
 			// form) the discarded value halts the program via ERRCHK, while
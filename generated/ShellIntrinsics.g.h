@@ -17,19 +17,25 @@ namespace MiniScript {
 
 class ShellIntrinsics {
 	private: static List<String> _shellArgStrings;
-	private: static Value _shellArgs;
-	private: static Value _envMap;
+	private: thread_local static Value _shellArgs;
+	private: thread_local static Value _envMap;
 	private: static const String kDefaultImportPath;
-	private: static Value _fileModuleMap;
-	private: static Value _fileHandleClassMap;
-	private: static Value _rawDataClassMap;
-	private: static Int32 _rdStart;
-	private: static List<String> _rdKeys;
-	private: static List<String> _fhKeys;
-	private: static List<String> _fmKeys;
-	private: static Value _keyModuleMap;
-	private: static Int32 _keyStart;
-	private: static List<String> _keyKeys;
+	private: thread_local static Value _fileModuleMap;
+	private: thread_local static Value _fileHandleClassMap;
+	private: thread_local static Value _rawDataClassMap;
+	private: thread_local static Int32 _rdStart;
+	private: thread_local static Int32 _fhStart;
+	private: thread_local static Int32 _fmStart;
+	private: thread_local static List<String> _rdKeys;
+	private: thread_local static List<String> _fhKeys;
+	private: thread_local static List<String> _fmKeys;
+	private: thread_local static Value _keyModuleMap;
+	private: thread_local static Int32 _keyStart;
+	private: thread_local static List<String> _keyKeys;
+	// The argument strings are the process's, set once before any isolate
+	// starts.  Everything else here that holds a Value, or refers to an
+	// intrinsic by index, is per thread, like the GC heap (see GCManager), and
+	// is set up by Init on each thread.
 
 	// Default import search path, used when MS_IMPORT_PATH is not already set in
 	// the environment.  Variables are expanded at import time, not here.
@@ -83,13 +89,25 @@ class ShellIntrinsics {
 	// part of the path rather than a separator.
 	private: static List<String> SplitImportPath(String s);
 
+	// The directories import searches, in order, from MS_IMPORT_PATH: each
+	// with its variables expanded and a trailing separator, so that a library
+	// file's path is the entry plus its name.  An empty entry is the current
+	// directory.
+	private: static List<String> ImportSearchDirs();
+
+	// Start parsing, in the background, the libraries the given script source
+	// imports by literal name (see ImportPrefetch).  Call once the environment
+	// (MS_SCRIPT_DIR etc.) is set up for the script, before compiling it.
+	public: static void PrefetchImports(String source);
+
 	// Expand shell variable references ($VAR, ${VAR}) in a path string,
 	// looking up values in the cached env map.
 	private: static String ExpandVariables(String path);
 
 	// Try to read a source file. Returns the file contents if the file exists,
-	// or null (empty string in C++) if it does not.  Used by the import intrinsic.
-	private: static String TryReadSource(String path);
+	// or null (empty string in C++) if it does not.  Used by the import intrinsic
+	// and by ImportPrefetch (so must not touch the GC heap).
+	public: static String TryReadSource(String path);
 
 	// ── GCHandle finalizers ───────────────────────────────────────────────────
 
@@ -255,7 +273,8 @@ class ShellIntrinsics {
 	// Current time as seconds since the Unix epoch.
 	private: static Double NowSeconds();
 
-	// Register all shell intrinsics.  Must be called before any Interpreter is Reset.
+	// Register all shell intrinsics.  Must be called before any Interpreter is
+	// Reset, once on each thread that runs one (after GCManager.Init).
 	public: static void Init();
 }; // end of struct ShellIntrinsics
 
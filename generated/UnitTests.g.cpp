@@ -15,6 +15,13 @@
 #include "Interpreter.g.h"
 #include "Intrinsic.g.h"
 #include "CoreIntrinsics.g.h"
+#include "BytecodeCache.g.h"
+#include "ErrorTypes.g.h"
+#include "InterpreterPool.g.h"
+#include "Scheduler.g.h"
+#include "SharedHeap.g.h"
+#include "ParallelMap.g.h"
+#include <thread>
 
 namespace MiniScript {
 
@@ -376,6 +383,16 @@ Boolean UnitTests::TestParser() {
 	ok = ok && CheckParse(parser, "not 0", "1");
 	ok = ok && CheckParse(parser, "not 1", "0");
 
+	ok = ok && CheckParse(parser, "not true", "0");
+	ok = ok && CheckParse(parser, "true and false", "0");
+
+	// Test strings and comparison chains
+	ok = ok && CheckParse(parser, "\"pre\" + \"fix\"", "\"prefix\"");
+	ok = ok && CheckParse(parser, "\"a\" == \"a\"", "1");
+	ok = ok && CheckParse(parser, "\"a\" != \"a\"", "0");
+	ok = ok && CheckParse(parser, "1 < 2 <= 2", "1");
+	ok = ok && CheckParse(parser, "1 < 3 < 2", "0");
+
 	// Test identifiers (these don't simplify, just return as-is)
 	ok = ok && CheckParse(parser, "x", "x");
 	ok = ok && CheckParse(parser, "foo", "foo");
@@ -384,6 +401,17 @@ Boolean UnitTests::TestParser() {
 	ok = ok && CheckParse(parser, "x + 0", "PLUS(x, 0)");
 	ok = ok && CheckParse(parser, "2 + x", "PLUS(2, x)");
 
+	// Identities apply only where the other operand must be a number
+	ok = ok && CheckParse(parser, "x * 1", "TIMES(x, 1)");
+	ok = ok && CheckParse(parser, "(x == y) * 1", "EQUALS(x, y)");
+	ok = ok && CheckParse(parser, "0 + (x < y)", "LESS_THAN(x, y)");
+	ok = ok && CheckParse(parser, "-x + 0", "PLUS(MINUS(x), 0)");
+
+	// A constant condition keeps only the arm that runs
+	ok = ok && CheckParse(parser, "if 2 > 3 then x = 1 else x = 2", "if 1 then\n  x = 2\nend if");
+	ok = ok && CheckParse(parser, "if \"yes\" then x = 1 else x = 2", "if 1 then\n  x = 1\nend if");
+	ok = ok && CheckParse(parser, "if y then x = 1 else x = 2", "if y then\n  x = 1\nelse\n  x = 2\nend if");
+
 	// Test string literals
 	ok = ok && CheckParse(parser, "\"hello\"", "\"hello\"");
 
@@ -516,60 +544,61 @@ Boolean UnitTests::TestCodeGenerator() {
 		"  RETURN"
 	}));
 
-	// Test assembly output for addition (resultReg r0 allocated first)
+	// Test assembly output for addition (operands first; the result reuses
+	// the left operand's register, r0)
 	ok = ok && CheckCodeGen(parser, "2 + 3",  List<String>::New({
-		"  LOAD_rA_iBC r1, 2",
-		"  LOAD_rA_iBC r2, 3",
-		"  ADD_rA_rB_rC r0, r1, r2",
+		"  LOAD_rA_iBC r0, 2",
+		"  LOAD_rA_iBC r1, 3",
+		"  ADD_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test subtraction
 	ok = ok && CheckCodeGen(parser, "10 - 4",  List<String>::New({
-		"  LOAD_rA_iBC r1, 10",
-		"  LOAD_rA_iBC r2, 4",
-		"  SUB_rA_rB_rC r0, r1, r2",
+		"  LOAD_rA_iBC r0, 10",
+		"  LOAD_rA_iBC r1, 4",
+		"  SUB_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test multiplication
 	ok = ok && CheckCodeGen(parser, "6 * 7",  List<String>::New({
-		"  LOAD_rA_iBC r1, 6",
-		"  LOAD_rA_iBC r2, 7",
-		"  MUL_rA_rB_rC r0, r1, r2",
+		"  LOAD_rA_iBC r0, 6",
+		"  LOAD_rA_iBC r1, 7",
+		"  MUL_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test division
 	ok = ok && CheckCodeGen(parser, "20 / 4",  List<String>::New({
-		"  LOAD_rA_iBC r1, 20",
-		"  LOAD_rA_iBC r2, 4",
-		"  DIV_rA_rB_rC r0, r1, r2",
+		"  LOAD_rA_iBC r0, 20",
+		"  LOAD_rA_iBC r1, 4",
+		"  DIV_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test comparison (less than)
 	ok = ok && CheckCodeGen(parser, "3 < 5",  List<String>::New({
-		"  LOAD_rA_iBC r1, 3",
-		"  LOAD_rA_iBC r2, 5",
-		"  LT_rA_rB_rC r0, r1, r2",
+		"  LOAD_rA_iBC r0, 3",
+		"  LOAD_rA_iBC r1, 5",
+		"  LT_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test comparison (greater than - uses swapped LT)
 	ok = ok && CheckCodeGen(parser, "5 > 3",  List<String>::New({
-		"  LOAD_rA_iBC r1, 5",
-		"  LOAD_rA_iBC r2, 3",
-		"  LT_rA_rB_rC r0, r2, r1",  // swapped: r2 < r1
+		"  LOAD_rA_iBC r0, 5",
+		"  LOAD_rA_iBC r1, 3",
+		"  LT_rA_rB_rC r0, r1, r0",  // swapped: r1 < r0
 		"  RETURN"
 	}));
 
 	// Test unary minus
-	// r0 = result, r1 = 5, r2 = 0, SUB r0, r2, r1 (result = 0 - 5)
+	// r0 = 5, r1 = 0, SUB r0, r1, r0 (result = 0 - 5, into the operand's register)
 	ok = ok && CheckCodeGen(parser, "-5",  List<String>::New({
-		"  LOAD_rA_iBC r1, 5",
-		"  LOAD_rA_iBC r2, 0",
-		"  SUB_rA_rB_rC r0, r2, r1",
+		"  LOAD_rA_iBC r0, 5",
+		"  LOAD_rA_iBC r1, 0",
+		"  SUB_rA_rB_rC r0, r1, r0",
 		"  RETURN"
 	}));
 
@@ -600,24 +629,33 @@ Boolean UnitTests::TestCodeGenerator() {
 	// Test map literal
 	ok = ok && CheckBytecodeGen(parser, "{}", 2, 0);  // MAP + RETURN
 
-	// Test index access (resultReg r0 allocated first)
+	// Test index access (the result reuses the container's register)
 	ok = ok && CheckCodeGen(parser, "x[0]",  List<String>::New({
-		"  GLOADC_rA_iBC r1, 0",   // x: free name, so a global reference
-		"  LOAD_rA_iBC r2, 0",   // index 0
-		"  IDXGET_rA_rB_rC r0, r1, r2",
+		"  GLOADC_rA_iBC r0, 0",   // x: free name, so a global reference
+		"  LOAD_rA_iBC r1, 0",   // index 0
+		"  IDXGET_rA_rB_rC r0, r0, r1",
 		"  RETURN"
 	}));
 
 	// Test nested expression (precedence)
-	// 2 + 3 * 4: outer result r0, load 2 into r1, inner mult result r2, load 3,4 into r3,r4
-	// LOAD r1,2; LOAD r3,3; LOAD r4,4; MUL r2,r3,r4; ADD r0,r1,r2; RETURN
+	// 2 + 3 * 4: load 2 into r0, 3 and 4 into r1 and r2, the product into r1
+	// LOAD r0,2; LOAD r1,3; LOAD r2,4; MUL r1,r1,r2; ADD r0,r0,r1; RETURN
 	ok = ok && CheckBytecodeGen(parser, "2 + 3 * 4", 6, 0);
 
 	// Test register reuse with nested expressions
-	// (1 + 2) + (3 + 4): outer r0, first group r1 (with r2,r3 for operands),
-	// second group r2 (reused after freeing r2,r3), with r3,r4 for operands
-	// LOAD r2,1; LOAD r3,2; ADD r1,r2,r3; LOAD r3,3; LOAD r4,4; ADD r2,r3,r4; ADD r0,r1,r2; RETURN
-	ok = ok && CheckBytecodeGen(parser, "(1 + 2) + (3 + 4)", 8, 0);
+	// (1 + 2) + (3 + 4): each sum lands in its left operand's register, so the
+	// whole expression needs only three
+	// LOAD r0,1; LOAD r1,2; ADD r0,r0,r1; LOAD r1,3; LOAD r2,4; ADD r1,r1,r2; ADD r0,r0,r1; RETURN
+	ok = ok && CheckCodeGen(parser, "(1 + 2) + (3 + 4)",  List<String>::New({
+		"  LOAD_rA_iBC r0, 1",
+		"  LOAD_rA_iBC r1, 2",
+		"  ADD_rA_rB_rC r0, r0, r1",
+		"  LOAD_rA_iBC r1, 3",
+		"  LOAD_rA_iBC r2, 4",
+		"  ADD_rA_rB_rC r1, r1, r2",
+		"  ADD_rA_rB_rC r0, r0, r1",
+		"  RETURN"
+	}));
 
 	return ok;
 }
@@ -659,14 +697,14 @@ Boolean UnitTests::TestLexer() {
 	lexer = Lexer("42");
 	tok = lexer.NextToken();
 	ok = ok && Assert(tok.Type == TokenType::NUMBER, "Expected NUMBER token");
-	ok = ok && AssertEqual(tok.Text, "42");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "42");
 	ok = ok && AssertEqual(tok.DoubleValue, 42);
 
 	// Test float
 	lexer = Lexer("3.14");
 	tok = lexer.NextToken();
 	ok = ok && Assert(tok.Type == TokenType::NUMBER, "Expected NUMBER token for float");
-	ok = ok && AssertEqual(tok.Text, "3.14");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "3.14");
 
 	// Test string
 	lexer = Lexer("\"hello\"");
@@ -680,6 +718,20 @@ Boolean UnitTests::TestLexer() {
 	ok = ok && Assert(tok.Type == TokenType::IDENTIFIER, "Expected IDENTIFIER token");
 	ok = ok && AssertEqual(tok.Text, "myVar");
 
+	// Test names: keywords only as whole words, and non-ASCII names
+	lexer = Lexer("ends end naïve x naïve");
+	tok = lexer.NextToken();
+	ok = ok && Assert(tok.Type == TokenType::IDENTIFIER, "Expected IDENTIFIER for 'ends'");
+	ok = ok && AssertEqual(tok.Text, "ends");
+	ok = ok && Assert(lexer.NextToken().Type == TokenType::END, "Expected END");
+	tok = lexer.NextToken();
+	ok = ok && AssertEqual(tok.Text, "naïve");
+	ok = ok && AssertEqual(lexer.NextToken().Text, "x");
+	tok = lexer.NextToken();
+	ok = ok && AssertEqual(tok.Text, "naïve");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "naïve");
+	ok = ok && Assert(lexer.NextToken().Type == TokenType::END_OF_INPUT, "Expected END_OF_INPUT after names");
+
 	// Test operators
 	lexer = Lexer("+ - * / %");
 	ok = ok && Assert(lexer.NextToken().Type == TokenType::PLUS, "Expected PLUS");
@@ -707,16 +759,16 @@ Boolean UnitTests::TestLexer() {
 	lexer = Lexer("42 // this is a comment");
 	tok = lexer.NextToken();
 	ok = ok && Assert(tok.Type == TokenType::NUMBER, "Expected NUMBER before comment");
-	ok = ok && AssertEqual(tok.Text, "42");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "42");
 	tok = lexer.NextToken();
 	ok = ok && Assert(tok.Type == TokenType::COMMENT, "Expected COMMENT token");
-	ok = ok && AssertEqual(tok.Text, "// this is a comment");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "// this is a comment");
 
 	// Test comment-only line
 	lexer = Lexer("// just a comment");
 	tok = lexer.NextToken();
 	ok = ok && Assert(tok.Type == TokenType::COMMENT, "Expected COMMENT token for comment-only");
-	ok = ok && AssertEqual(tok.Text, "// just a comment");
+	ok = ok && AssertEqual(lexer.TextOf(tok), "// just a comment");
 
 	// Test comment followed by newline and more code
 	lexer = Lexer("x // comment\ny");
@@ -1037,6 +1089,206 @@ Boolean UnitTests::TestHostGlobals() {
 	if (!ok) IOHelper::Print("TestHostGlobals FAILED");
 	return ok;
 }
+Boolean UnitTests::TestClone() {
+	Boolean ok = Boolean(true);
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter prelude;
+	prelude =  Interpreter::New("Counter = {\"n\": 0}\nCounter.bump = function; self.n += 1; return self.n; end function\nlog = []\ntable = frozenCopy([1, 2, 3])\naddLog = function(x); log.push x; return log.len; end function");
+	prelude.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	prelude.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	prelude.RunUntilDone(10, Boolean(false));
+	ok = ok && Assert(output.Count() == 0, "the template program should print nothing");
+
+	String job = "c = new Counter\nprint c.bump + Counter.bump\nprint addLog(\"a\")\nlog.push \"b\"\nprint log.len\nprint table[2]";
+	for (Int32 run = 0; run < 2; run++) {
+		Interpreter clone = prelude.Clone(job);
+		clone.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		clone.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		ok = ok && Assert(clone.GetGlobalValue("table").RefEquals(prelude.GetGlobalValue("table")),
+			"a frozen global should be shared, not copied");
+		// The copies must be rooted through the clone's globals alone.
+		GCManager::CollectGarbage();
+		clone.RunUntilDone(10, Boolean(false));
+		ok = ok && AssertEqual(String::Join(" ", output), "2 1 2 3");
+		output.Clear();
+		clone.Reset("");	// (releases its globals)
+	}
+
+	ok = ok && Assert(prelude.GetGlobalValue("log").ListCount() == 0,
+		"the clones' list pushes should not reach the template");
+	ok = ok && Assert(prelude.GetGlobalValue("Counter").MapGet(Value::make_string("n")) == Value(0),
+		"the clones' map changes should not reach the template");
+
+	if (!ok) IOHelper::Print("TestClone FAILED");
+	return ok;
+}
+Boolean UnitTests::TestInterpreterPool() {
+	Boolean ok = Boolean(true);
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter prelude;
+	prelude =  Interpreter::New("greeting = \"hi\"\nseen = []");
+	prelude.RunUntilDone(10, Boolean(false));
+
+	InterpreterPool pool =  InterpreterPool::New(prelude);
+	pool.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	pool.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+
+	String job = "print globals.hasIndex(\"mine\")\nseen.push 1\nprint greeting + \" \" + seen.len\nmine = 5";
+	Interpreter first = pool.Lease(job);
+	first.RunUntilDone(10, Boolean(false));
+	VM firstVM = first.vm();
+	pool.Return(first);
+	ok = ok && Assert(pool.IdleCount() == 1, "a returned interpreter should be idle");
+
+	Interpreter second = pool.Lease(job);
+	ok = ok && Assert(pool.IdleCount() == 0, "leasing should take the idle interpreter");
+	ok = ok && Assert(!second.Done(), "the same source should be ready to run without a compile");
+	VM secondVM = second.vm();
+	ok = ok && Assert((void*)secondVM == (void*)firstVM, "a recycled interpreter should keep its VM");
+	GCManager::CollectGarbage();
+	second.RunUntilDone(10, Boolean(false));
+	pool.Return(second);
+
+	Interpreter third = pool.Lease("print seen.len + mine");
+	third.RunUntilDone(10, Boolean(false));
+	secondVM = third.vm();
+	ok = ok && Assert((void*)secondVM == (void*)firstVM, "a new source should still run on the kept VM");
+	pool.Return(third);
+
+	ok = ok && AssertEqual(String::Join(" ", output),
+		"0 hi 1 0 hi 1 Runtime Error: Undefined Identifier: 'mine' is unknown in this context [line 1]");
+	ok = ok && Assert(prelude.GetGlobalValue("seen").ListCount() == 0,
+		"jobs should not change the prelude");
+	pool.Clear();
+
+	if (!ok) IOHelper::Print("TestInterpreterPool FAILED");
+	return ok;
+}
+const String UnitTests::kSchedulerTask = "n = 0\nfor i in range(1, 3)\n  wait 0.05\n  n += 1\n  yield\nend for\nprint n";
+Boolean UnitTests::TestScheduler() {
+	Boolean ok = Boolean(true);
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Scheduler scheduler =  Scheduler::New();
+	for (Int32 i = 0; i < 100; i++) {
+		Interpreter interp =  Interpreter::New(kSchedulerTask);
+		interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+		scheduler.Add(interp);
+	}
+	scheduler.RunOnce();
+	ok = ok && Assert(scheduler.WaitingCount() == 100, "every task should be waiting after its first turn");
+	scheduler.RunUntilDone(5);
+	ok = ok && Assert(scheduler.LiveCount() == 0, "all tasks should finish, their waits overlapping");
+	ok = ok && Assert(output.Count() == 100 && output[0] == "3" && output[99] == "3",
+		"each task should run to the end");
+	ok = ok && Assert(scheduler.RunTime(0) > 0 && scheduler.RunTime(0) < 1,
+		"a task's run time should count only its turns, not its waits");
+	ok = ok && Assert(scheduler.SecondsToNextWake() == -1, "a finished scheduler has nothing to wake");
+
+	// A wait cut short leaves no deadline behind for the host to sleep on.
+	Interpreter waiter =  Interpreter::New("wait 10");
+	waiter.RunSlice(0.01);
+	ok = ok && Assert(waiter.vm().SecondsToWake() > 0, "a task in a wait should have a time to wake");
+	waiter.Stop();
+	ok = ok && Assert(waiter.vm().SecondsToWake() == 0, "a stopped task should have no time to wake");
+
+	if (!ok) IOHelper::Print("TestScheduler FAILED");
+	return ok;
+}
+const String UnitTests::kSchedulerSender = "c = channel(\"schedulerTestChannel\")\nwait 0.2\nsend c, 42";
+const String UnitTests::kSchedulerReceiver = "print receive(channel(\"schedulerTestChannel\"))";
+Boolean UnitTests::TestSchedulerBlocked() {
+	Boolean ok = Boolean(true);
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Scheduler scheduler =  Scheduler::New();
+	Interpreter sender =  Interpreter::New(kSchedulerSender);
+	Interpreter receiver =  Interpreter::New(kSchedulerReceiver);
+	receiver.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	scheduler.Add(sender);
+	Int32 task = scheduler.Add(receiver);
+	scheduler.RunUntilDone(5);
+	ok = ok && Assert(scheduler.LiveCount() == 0 && output.Count() == 1 && output[0] == "42",
+		"the receiver should get what the sender sends after its wait");
+	ok = ok && Assert(scheduler.RunTime(task) < 0.1,
+		"a task blocked in receive should not be run over and over");
+
+	if (!ok) IOHelper::Print("TestSchedulerBlocked FAILED");
+	return ok;
+}
+Boolean UnitTests::TestBytecodeCache() {
+	Boolean ok = Boolean(true);
+	String source =  String::New("f = function(a, b=[1, \"two\"], c=0.25)\n")
+		+ "  return a + b[1] + c\n"
+		+ "end function\n"
+		+ "g = 123456.5\n"
+		+ "print f(\"x\") + \" \" + g\n"
+		+ "print [1,2].len / 0 + undefinedName";
+	Parser parser =  Parser::New();
+	parser.Init(source, "cached.ms");
+	List<ASTNode> statements = parser.ParseProgram();
+	BytecodeEmitter emitter =  BytecodeEmitter::New();
+	CodeGenerator generator =  CodeGenerator::New(emitter);
+	generator.set_FileName("cached.ms");
+	generator.CompileProgram(statements, "@main");
+	List<FuncDef> original = generator.GetFunctions();
+
+	UInt64 key = BytecodeCache::SourceKey(source, "cached.ms", Boolean(false));
+	List<Byte> data = BytecodeCache::Serialize(original, key);
+	ok = ok && Assert(!IsNull(data), "program should serialize");
+	if (!ok) return Boolean(false);
+	List<FuncDef> loaded = BytecodeCache::Deserialize(data, key);
+	ok = ok && Assert(!IsNull(loaded), "serialized program should deserialize");
+	if (!ok) return Boolean(false);
+	FuncDef inner = loaded[1];
+	ok = ok && Assert(inner.LazyConstantsPos() >= 0, "constants should be decoded only when needed");
+	ok = ok && AssertEqual(Disassembler::Disassemble(loaded), Disassembler::Disassemble(original));
+	// The call to f is inlined, so @main refers back to f for its guard, and
+	// has an inline range to keep.
+	FuncDef loadedMain = loaded[0];
+	FuncDef originalMain = original[0];
+	ok = ok && Assert(originalMain.InlineRangeCount() == 1, "f(\"x\") should be inlined");
+	ok = ok && Assert(loadedMain.InlineRangeCount() == 1
+		&& loadedMain.InlineRangeStart(0) == originalMain.InlineRangeStart(0)
+		&& loadedMain.InlineRangeEnd(0) == originalMain.InlineRangeEnd(0)
+		&& loadedMain.InlineRangeCallLine(0) == 5, "inline range should survive the round trip");
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter interp =  Interpreter::New();
+	interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.Reset(loaded);
+	interp.RunUntilDone(10, Boolean(false));
+	ok = ok && Assert(output.Count() == 2 && output[0] == "xtwo0.25 123456.5",
+		StringUtils::Format("deserialized program output: got '{0}'",
+			output.Count() > 0 ? output[0] : "(no output)"));
+	ok = ok && Assert(output.Count() == 2 && output[1].Contains("line 6"),
+		StringUtils::Format("runtime error should report line 6, got '{0}'",
+			output.Count() > 1 ? output[1] : "(no output)"));
+
+	// A different key, or any truncation, is a miss rather than a bad program.
+	List<FuncDef> rejected = BytecodeCache::Deserialize(data, key + 1);
+	ok = ok && Assert(IsNull(rejected), "data for another key should be rejected");
+	// So is a changed byte anywhere in the payload: here, in an operand of
+	// the last instruction, which only the checksum would notice.
+	Int32 last = data.Count() - 4;
+	data[last] = (Byte)(data[last] ^ 0x01);
+	rejected = BytecodeCache::Deserialize(data, key);
+	ok = ok && Assert(IsNull(rejected), "data with a changed instruction should be rejected");
+	data[last] = (Byte)(data[last] ^ 0x01);
+	data.RemoveAt(data.Count() - 1);
+	rejected = BytecodeCache::Deserialize(data, key);
+	ok = ok && Assert(IsNull(rejected), "truncated data should be rejected");
+
+	if (!ok) IOHelper::Print("TestBytecodeCache FAILED");
+	return ok;
+}
 Boolean UnitTests::TestGlobalsSwitch() {
 	Boolean ok = Boolean(true);
 
@@ -1123,6 +1375,10 @@ Int32 UnitTests::_handleFinalizerCallCount = 0;
 void UnitTests::TestHandleFinalizer(object userData) {
 	_handleFinalizerCallCount++;
 }
+Value UnitTests::_handleHeld = Value::Null;
+void UnitTests::TestHandleMarker(object userData) {
+	GCManager::Mark(_handleHeld);
+}
 Boolean UnitTests::TestGCHandle() {
 	Boolean ok = Boolean(true);
 	_handleFinalizerCallCount = 0;
@@ -1145,9 +1401,207 @@ Boolean UnitTests::TestGCHandle() {
 	ok = ok && Assert(_handleFinalizerCallCount == 1,
 		"callback should fire exactly once when handle is collected");
 
+	// A handle with a Marker keeps what its native object holds alive
+	// for as long as the handle is, and no longer.
+	Value held = GCManager::NewHandle(nullptr, TestHandleFinalizer, TestHandleMarker);
+	_handleHeld = Value::make_list(1);
+	_handleHeld.Push(Value::make_string("held by a handle's native object"));
+	GCManager::Handles.Retain(held.ItemIndex());
+	GCManager::CollectGarbage();
+	ok = ok && Assert(GCManager::Lists.IsLiveSlot(_handleHeld.ItemIndex()),
+		"a handle's Marker should keep what it marks alive");
+	GCManager::Handles.Release(held.ItemIndex());
+	GCManager::CollectGarbage();
+	ok = ok && Assert(!GCManager::Lists.IsLiveSlot(_handleHeld.ItemIndex()),
+		"what a swept handle marked should be swept too");
+	ok = ok && Assert(_handleFinalizerCallCount == 2, "the marked handle should be finalized");
+	_handleHeld = Value::Null;
+
 	if (!ok) IOHelper::Print("TestGCHandle FAILED");
 	return ok;
 }
+const String UnitTests::kIsolateProgram = "words = []\nfor i in range(1, 3000)\n  words.push \"word\" + i\n  if i % 500 == 0 then gc.collect true\nend for\nm = {}\nfor w in words\n  m[w] = w.len\nend for\nprint words.len + \" \" + m.len + \" \" + words[-1] + \" \" + m.word42\nprint words isa list";
+List<String> UnitTests::_isolateOutput = nullptr; // written only by the second thread
+void UnitTests::RunIsolate() {
+	GCManager::Init();
+	ErrorTypes::Init();
+	_isolateOutput =  List<String>::New();
+	Interpreter interp =  Interpreter::New(kIsolateProgram);
+	interp.set_standardOutput([](String s, Boolean) { _isolateOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { _isolateOutput.Add(s); });
+	interp.RunUntilDone(60, Boolean(false));
+}
+Boolean UnitTests::TestIsolates() {
+	Boolean ok = Boolean(true);
+
+	// An object on this thread's heap, to check afterwards.
+	Value kept = Value::make_list(1);
+	kept.Push(Value::make_string("still here after the other isolate ran"));
+	GCManager::AddRoot(kept);
+
+	std::thread other(&UnitTests::RunIsolate);
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter interp =  Interpreter::New(kIsolateProgram);
+	interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.RunUntilDone(60, Boolean(false));
+
+	other.join();
+
+	List<String> expected =  List<String>::New();
+	expected.Add("3000 3000 word3000 6");
+	expected.Add("1");
+	ok = ok && AssertEqual(output, expected);
+	ok = ok && AssertEqual(_isolateOutput, expected);
+
+	GCManager::CollectGarbage();
+	ok = ok && Assert(kept.ListCount() == 1
+		&& kept.ListGet(0) == Value::make_string("still here after the other isolate ran"),
+		"an object on this thread's heap should be untouched by the other isolate");
+	GCManager::RemoveRoot(kept);
+
+	if (!ok) IOHelper::Print("TestIsolates FAILED");
+	return ok;
+}
+const String UnitTests::kSharedProgram = "n = 0\nfor i in range(1, 200)\n  for w in data.words\n    n += data.lookup[w]\n  end for\n  if i % 50 == 0 then gc.collect true\nend for\nprint n\nprint data.words.indexOf(\"gamma_three\") + \" \" + data.lookup.epsilon_two + \" \" + data.nested[1].k\ndata.words.push 5";
+Value UnitTests::_sharedData = Value::Null; // published before the reader starts
+List<String> UnitTests::_sharedOutput = nullptr; // written only by the reader
+void UnitTests::RunSharedReader() {
+	GCManager::Init();
+	ErrorTypes::Init();
+	_sharedOutput =  List<String>::New();
+	Interpreter interp =  Interpreter::New(kSharedProgram);
+	interp.set_standardOutput([](String s, Boolean) { _sharedOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { _sharedOutput.Add(s); });
+	interp.SetGlobalValue("data", _sharedData);
+	interp.RunUntilDone(60, Boolean(false));
+}
+Boolean UnitTests::TestSharedHeap() {
+	Boolean ok = Boolean(true);
+
+	Interpreter maker;
+	maker =  Interpreter::New("long = \"abcdefghij\" * 13\ndata = {\"words\": [\"alpha\", \"epsilon_two\", \"gamma_three\", long], \"lookup\": {\"alpha\": 1, \"epsilon_two\": 2, \"gamma_three\": 3, long: 4}, \"nested\": [[1, 2], {\"k\": \"v\"}]}\nfreeze data\nscratch = [1, 2]");
+	maker.RunUntilDone(10, Boolean(false));
+	Value data = maker.GetGlobalValue("data");
+	Value shared;
+	Boolean published = SharedHeap::TryPublish(maker.GetGlobalValue("scratch"), &shared);
+	ok = ok && Assert(!published, "a list that is not frozen should not publish");
+	published = SharedHeap::TryPublish(data, &shared);
+	ok = ok && Assert(published, "a frozen map should publish");
+	ok = ok && Assert(shared.IsShared() && !data.IsShared(), "the published form should be shared");
+	ok = ok && Assert(shared == data, "the published form should equal the original");
+	Value again;
+	published = SharedHeap::TryPublish(shared, &again);
+	ok = ok && Assert(published && again.Bits() == shared.Bits(),
+		"a shared value should be its own published form");
+	_sharedData = shared;
+
+	// A full region refuses a value, and takes none of it.
+	Interpreter moreMaker =  Interpreter::New("more = [\"another long string, to make a heap string\", [3], {4: 5}]\nfreeze more");
+	moreMaker.RunUntilDone(10, Boolean(false));
+	Value more = moreMaker.GetGlobalValue("more");
+	Int32 before = SharedHeap::ItemCount();
+	Int32 capacity = SharedHeap::SetCapacity;
+	SharedHeap::SetCapacity = 0;
+	published = SharedHeap::TryPublish(more, &again);
+	ok = ok && Assert(!published && SharedHeap::Shareable(more) && SharedHeap::ItemCount() == before,
+		"a value should not publish, even in part, when the region is full");
+	SharedHeap::SetCapacity = capacity;
+	published = SharedHeap::TryPublish(more, &again);
+	ok = ok && Assert(published && SharedHeap::ItemCount() == before + 4,
+		"a value should publish once there is room");
+
+	std::thread other(&UnitTests::RunSharedReader);
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter interp =  Interpreter::New(kSharedProgram);
+	interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.SetGlobalValue("data", shared);
+	interp.RunUntilDone(60, Boolean(false));
+
+	other.join();
+
+	List<String> expected =  List<String>::New();
+	expected.Add("2000");
+	expected.Add("2 2 v");
+	expected.Add("Runtime Error: Attempt to modify a frozen list [line 10]");
+	ok = ok && AssertEqual(output, expected);
+	ok = ok && AssertEqual(_sharedOutput, expected);
+
+	if (!ok) IOHelper::Print("TestSharedHeap FAILED");
+	return ok;
+}
+const String UnitTests::kChannelSender = "c = channel(\"unitTestChannel\", 4)\nfor i in range(1, 300)\n  item = {\"i\": i, \"name\": \"item number \" + i, \"tags\": [i % 3, \"x\"]}\n  item.me = item\n  if i % 2 then freeze item\n  send c, item\nend for\nsend c, null";
+const String UnitTests::kChannelReceiver = "c = channel(\"unitTestChannel\", 4)\nn = 0\ntotal = 0\nfrozen = 0\nwhile true\n  item = receive(c)\n  if item == null then break\n  n += 1\n  total += item.i + item.tags[0]\n  if item.name != \"item number \" + item.i or not refEquals(item.me, item) then print \"bad item \" + n\n  frozen += isFrozen(item)\n  if n % 100 == 0 then gc.collect true\nend while\nprint n + \" \" + total + \" \" + frozen";
+List<String> UnitTests::_channelOutput = nullptr; // written only by the sender
+void UnitTests::RunYielding(Interpreter interp) {
+	interp.RunUntilDone(60, Boolean(true));
+	while (!interp.Done()) {
+		std::this_thread::yield();
+		interp.RunUntilDone(60, Boolean(true));
+	}
+}
+void UnitTests::RunChannelSender() {
+	GCManager::Init();
+	ErrorTypes::Init();
+	_channelOutput =  List<String>::New();
+	Interpreter interp =  Interpreter::New(kChannelSender);
+	interp.set_standardOutput([](String s, Boolean) { _channelOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { _channelOutput.Add(s); });
+	RunYielding(interp);
+}
+Boolean UnitTests::TestChannels() {
+	Boolean ok = Boolean(true);
+
+	std::thread other(&UnitTests::RunChannelSender);
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter interp =  Interpreter::New(kChannelReceiver);
+	interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	RunYielding(interp);
+
+	other.join();
+
+	List<String> expected =  List<String>::New();
+	expected.Add("300 45450 150");
+	ok = ok && AssertEqual(output, expected);
+	ok = ok && AssertEqual(_channelOutput,  List<String>::New());
+
+	if (!ok) IOHelper::Print("TestChannels FAILED");
+	return ok;
+}
+const String UnitTests::kParallelProgram = "describe = function(n)\n  s = \"abcdef\"[:n % 7]\n  return {\"n\": n, \"s\": s, \"tags\": [n % 2, s.len]}\nend function\nr = parallelMap(range(1, 400), @describe, 7)\ntotal = 0\nok = 1\nfor i in r.indexes\n  total += r[i].tags[1]\n  ok = ok and r[i].n == i + 1\nend for\nprint r.len + \" \" + total + \" \" + ok + \" \" + r[5].s\nisOdd = function(m)\n  return m.tags[0]\nend function\nodd = parallelFilter(r, @isOdd, 9)\ngc.collect true\nprint odd.len + \" \" + odd[0].n + \" \" + odd[-1].n\nbad = function(x)\n  return x.foo\nend function\nprint parallelMap(range(1, 300), @bad, 10)";
+Boolean UnitTests::TestParallelMap() {
+	Boolean ok = Boolean(true);
+	Int32 savedThreadCount = ParallelMap::ThreadCount;
+	ParallelMap::ThreadCount = 3;
+
+	List<String> output =  List<String>::New();
+	gTestOutput = output;
+	Interpreter interp =  Interpreter::New(kParallelProgram);
+	interp.set_standardOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.set_errorOutput([](String s, Boolean) { gTestOutput.Add(s); });
+	interp.RunUntilDone(60, Boolean(false));
+
+	ParallelMap::Stop();
+	ParallelMap::ThreadCount = savedThreadCount;
+
+	ok = ok && Assert(output.Count() == 3, "parallelMap test should print 3 lines");
+	ok = ok && Assert(output[0] == "400 1198 1 abcdef", "parallelMap results should be whole and in order");
+	ok = ok && Assert(output[1] == "200 1 399", "parallelFilter should keep the right items, in order");
+	// (Raised on a worker or on this thread, whichever got there first.)
+	String prefix = "Runtime Error: Key Not Found: 'foo' not found in map";
+	ok = ok && Assert(output[2].Left(prefix.Length()) == prefix, "an error in func should stop the script");
+
+	if (!ok) IOHelper::Print("TestParallelMap FAILED");
+	return ok;
+}
 Boolean UnitTests::CheckMayReadVar(Parser parser,String input,String varName,Boolean expected) {
 	ASTNode ast = parser.Parse(input);
 	if (parser.HadError()) {
@@ -1433,8 +1887,17 @@ Boolean UnitTests::RunAll() {
 		&& TestREPL()
 		&& TestResetPreservingGlobals()
 	&& TestHostGlobals()
+	&& TestClone()
+	&& TestInterpreterPool()
+	&& TestScheduler()
+	&& TestSchedulerBlocked()
 	&& TestGlobalsSwitch()
-		&& TestGCHandle();
+	&& TestBytecodeCache()
+		&& TestGCHandle()
+		&& TestIsolates()
+		&& TestSharedHeap()
+		&& TestChannels()
+		&& TestParallelMap();
 }
 
 } // end of namespace MiniScript
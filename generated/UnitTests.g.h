@@ -71,6 +71,46 @@ class UnitTests {
 	// seeding before any compile, and reading after the program has ended.
 	public: static Boolean TestHostGlobals();
 
+	// ── Cloning an interpreter ──────────────────────────────────────────────────
+
+	// A clone starts with the template's globals -- its classes, functions and
+	// data -- but changes nothing in the template, so every clone starts the
+	// same.  Frozen data is shared rather than copied, and a top-level function
+	// from the template works on the clone's globals, not the template's.
+	public: static Boolean TestClone();
+
+	// ── Interpreter pool ─────────────────────────────────────────────────────────
+
+	// A leased interpreter is a returned one, recycled: same VM, and for the
+	// same source no compile at all.  Each job still starts from a fresh copy
+	// of the prelude's globals, with nothing left over from the job before.
+	public: static Boolean TestInterpreterPool();
+	private: static const String kSchedulerTask;
+
+	// ── Scheduler ────────────────────────────────────────────────────────────────
+
+	// Each task waits three times; one after another that would take 15
+	// seconds, but waiting tasks cost the scheduler nothing, so they all
+	// wait at once.
+
+	public: static Boolean TestScheduler();
+	private: static const String kSchedulerSender;
+	private: static const String kSchedulerReceiver;
+
+	// The receiver is blocked until the sender's wait is over; the scheduler
+	// should sleep through that rather than spin on it.
+
+	public: static Boolean TestSchedulerBlocked();
+
+	// ── Binary bytecode round trip ──────────────────────────────────────────────
+
+	// BytecodeCache must reproduce a compiled program exactly: same disassembly
+	// (code, constants, nested function templates), and the same behavior when
+	// run -- including parameter defaults, a frozen-list constant, global names,
+	// an inlined call, and line numbers in a runtime error.  Damaged or edited
+	// data must be rejected.
+	public: static Boolean TestBytecodeCache();
+
 	// ── Running one program against two global namespaces ────────────────────────
 
 	// Compiled code caches its (name -> slot) resolutions in the FuncDef, guarded
@@ -97,8 +137,72 @@ class UnitTests {
 	// ── GCHandle test ────────────────────────────────────────────────────────────
 
 	private: static void TestHandleFinalizer(object userData);
+	private: static Value _handleHeld;
+
+	// What the handle in TestGCHandle's native object holds, for its Marker.
+	private: static void TestHandleMarker(object userData);
 
 	public: static Boolean TestGCHandle();
+	private: static const String kIsolateProgram;
+	private: static List<String> _isolateOutput; // written only by the second thread
+
+	// ── Isolates ─────────────────────────────────────────────────────────────────
+
+	// Run by both threads in TestIsolates: enough allocation, and full
+	// collections, that two threads sharing any GC state would trip over it.
+
+	// Body of the second thread: set up this thread's own heap, as any host
+	// thread must, then run the program there.
+	private: static void RunIsolate();
+
+	// Two interpreters, each on its own thread with its own GC heap, run at
+	// the same time and must neither see nor disturb each other's objects.
+	public: static Boolean TestIsolates();
+	private: static const String kSharedProgram;
+	private: static Value _sharedData; // published before the reader starts
+	private: static List<String> _sharedOutput; // written only by the reader
+
+	// ── Shared heap ──────────────────────────────────────────────────────────────
+
+	// Run by both threads in TestSharedHeap, on a published `data`: lookups
+	// with this isolate's own keys (tiny, interned) in a shared map, full
+	// collections while shared values are in use, and a write that must fail.
+
+	// Body of the reader thread in TestSharedHeap.
+	private: static void RunSharedReader();
+
+	// A frozen value published to the SharedHeap is read, in place, by two
+	// isolates at once; only frozen data can be published.
+	public: static Boolean TestSharedHeap();
+	private: static const String kChannelSender;
+	private: static const String kChannelReceiver;
+	private: static List<String> _channelOutput; // written only by the sender
+
+	// ── Channels ─────────────────────────────────────────────────────────────────
+
+	// The sender and receiver in TestChannels.  The channel is small, so each
+	// side often finds it full or empty and must wait for the other.
+
+	// Run an interpreter to the end, resuming it each time it yields.
+	private: static void RunYielding(Interpreter interp);
+
+	// Body of the sender thread in TestChannels.
+	private: static void RunChannelSender();
+
+	// Two isolates pass values through a channel: each arrives whole, in
+	// order, as a copy on the receiver's heap, frozen if it was sent frozen.
+	public: static Boolean TestChannels();
+	private: static const String kParallelProgram;
+
+	// ── Parallel map ─────────────────────────────────────────────────────────────
+
+	// Maps and lists on the way in and out, a nested function, a filter,
+	// garbage collected mid-run, and an error raised by func.
+
+	// parallelMap with workers forced on (whatever this machine's core
+	// count): results come back whole and in order, and an error on any
+	// thread stops the script.
+	public: static Boolean TestParallelMap();
 
 	// Helper for MayReadVar tests: parse an assignment, then ask its RHS.
 	private: static Boolean CheckMayReadVar(Parser parser, String input, String varName, Boolean expected);
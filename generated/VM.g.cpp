@@ -75,9 +75,18 @@ void VMStorage::SetGlobals(Globals globals) {
 	_globals = globals;
 	_globalsId = (!IsNull(globals)) ? globals.Id() : 0;
 }
+const Int32 VMStorage::MaxSpareCoroutines = 64;
 double VMStorage::ElapsedTime() {
 	auto now = std::chrono::steady_clock::now();
 	return std::chrono::duration<double>(now - _startTime).count();
+}
+Boolean VMStorage::IsBlocked() {
+	return !IsNull(_pendingCallback) && !_hasPendingManualCall;
+}
+double VMStorage::SecondsToWake() {
+	if (IsNull(_pendingCallback) || wakeTime <= 0) return 0;
+	double seconds = wakeTime - ElapsedTime();
+	return seconds > 0 ? seconds : 0;
 }
 	thread_local VM VMStorage::_activeVM;
 VM VMStorage::ActiveVM() {
@@ -133,6 +142,10 @@ void VMStorage::InitVM(Int32 stackSlots,Int32 callSlots) {
 	_globals = nullptr;   // created (or adopted) at Reset
 	_globalsId = 0;
 	_pendingCallStack =  List<PendingCallState>::New();
+	_coroutines =  List<Coroutine>::New();
+	_spareCoroutines =  List<Coroutine>::New();
+	_stackSlotLimit = stackSlots;
+	_callSlotLimit = callSlots;
 	Error = Value::Null;
 
 	// Initialize stack with null values
@@ -190,36 +203,57 @@ void VMStorage::CleanupVM() {
 void VMStorage::MarkRoots(object user_data) {
 	VM vm(static_cast<VMStorage*>(user_data)->shared_from_this());
 	Int32 liveTop = (!IsNull(vm.CurrentFunction())) ? vm.BaseIndex() + vm.CurrentFunction().MaxRegs() : 0;
-	for (Int32 i = 0; i < liveTop; i++) {
-		GCManager::Mark(vm.stack()[i]);
-		GCManager::Mark(vm.names()[i]);
-	}
+	MarkFrames(vm.stack(), vm.names(), liveTop, vm.callStack(), vm.callStackTop(), vm.CurrentFunction());
 	// Intrinsic funcrefs are permanent GC roots (added via GCManager.AddRoot in
 	// Intrinsic.EnsureBuilt), so they don't need to be marked here.
+	GCManager::Mark(vm.ManualCallResult());
+	// The global namespace is not on the register stack, so mark it here.
+	// (Globals.AttachMap also roots the map directly, which covers a Globals
+	// that no VM has adopted yet; this mark is what keeps it alive for a VM
+	// that outlives its creator.)
+	if (!IsNull(vm._globals())) GCManager::Mark(vm._globals().AsMap());
+	// Manual-call results saved on the pending-call stack (nested imports).
+	MarkPendingCalls(vm._pendingCallStack());
+	// While a coroutine runs, the state of whoever resumed it is kept in
+	// its Coroutine, which nothing else may reach (see Coroutine.cs).
+	for (Int32 i = 0; i < vm._coroutines().Count(); i++) MarkCoroutine(vm._coroutines()[i]);
+	GCManager::Mark(vm._coroutineYieldValue());
+}
+void VMStorage::MarkFrames(List<Value> stack,List<Value> names,Int32 liveTop,List<CallInfo> callStack,Int32 callStackTop,FuncDef currentFunc) {
+	for (Int32 i = 0; i < liveTop; i++) {
+		GCManager::Mark(stack[i]);
+		GCManager::Mark(names[i]);
+	}
 	// Mark compile-time constants of every function on the call chain.
 	// Marking a function's constants reaches its nested-function templates
 	// (themselves funcrefs), which cascade through GCFunction.MarkChildren —
 	// so this transitively keeps the whole reachable FuncDef graph alive.
-	vm.MarkFuncConstants(vm.CurrentFunction());
+	MarkFuncConstants(currentFunc);
 	// Mark LocalVarMap and OuterVarMap stored in CallInfo structs, plus the
 	// caller FuncDef recorded in each frame.  These are not reachable from
 	// the stack scan and must be marked explicitly.
-	for (Int32 ci = 0; ci < vm.callStackTop(); ci++) {
-		GCManager::Mark(vm.callStack()[ci].LocalVarMap);
-		GCManager::Mark(vm.callStack()[ci].OuterVarMap);
-		vm.MarkFuncConstants(vm.callStack()[ci].ReturnFunc);
+	for (Int32 ci = 0; ci < callStackTop; ci++) {
+		GCManager::Mark(callStack[ci].LocalVarMap);
+		GCManager::Mark(callStack[ci].OuterVarMap);
+		MarkFuncConstants(callStack[ci].ReturnFunc);
 	}
-	GCManager::Mark(vm.ManualCallResult());
-	// The global namespace is not on the register stack, so mark it here.
-	// (Globals.AttachMap also roots the map directly, which covers a Globals
-	// that no VM has adopted yet; this mark is what keeps it alive for a VM
-	// that outlives its creator.)
-	if (!IsNull(vm._globals())) GCManager::Mark(vm._globals().AsMap());
-	// Manual-call results saved on the pending-call stack (nested imports).
-	for (Int32 pi = 0; pi < vm._pendingCallStack().Count(); pi++) {
-		GCManager::Mark(vm._pendingCallStack()[pi].ManualResult);
+}
+void VMStorage::MarkPendingCalls(List<PendingCallState> pending) {
+	for (Int32 pi = 0; pi < pending.Count(); pi++) {
+		GCManager::Mark(pending[pi].ManualResult);
 	}
 }
+void VMStorage::MarkCoroutine(Coroutine co) {
+	GCManager::Mark(co.Function());
+	if (IsNull(co.Stack())) return;
+	Int32 liveTop = (!IsNull(co.CurrentFunction())) ? co.BaseIndex() + co.CurrentFunction().MaxRegs() : 0;
+	if (co.NativeFrameTop() > liveTop) liveTop = co.NativeFrameTop();
+	MarkFrames(co.Stack(), co.Names(), liveTop, co.CallStack(), co.CallStackTop(), co.CurrentFunction());
+	GCManager::Mark(co.PendingSelf());
+	GCManager::Mark(co.PendingSuper());
+	GCManager::Mark(co.ManualCallResult());
+	MarkPendingCalls(co.PendingCallStack());
+}
 void VMStorage::MarkFuncConstants(FuncDef func) {
 	if (IsNull(func)) return;
 	List<Value> consts = func.Constants();
@@ -398,6 +432,255 @@ Value VMStorage::RunFunction(Value funcRef,List<Value> args) {
 
 	return result;
 }
+const UInt32 VMStorage::CoroutineBatch = 1000;
+Value VMStorage::MakeCoroutine(Value func) {
+	Coroutine co =  Coroutine::New();
+	co.set_Function(func);
+	return GCManager::NewHandle(new Coroutine(co), VMStorage::CoroutineFinalizer, VMStorage::MarkCoroutineHandle);
+}
+Coroutine VMStorage::GetCoroutine(Value v) {
+	if (!v.IsHandle()) return nullptr;
+	GCHandle h = GCManager::GetHandle(v);
+	if (h.Marker != VMStorage::MarkCoroutineHandle) return nullptr;
+	return *static_cast<Coroutine*>(h.UserData);
+}
+void VMStorage::MarkCoroutineHandle(object userData) {
+	Coroutine co = *static_cast<Coroutine*>(userData);
+	MarkCoroutine(co);
+}
+void VMStorage::CoroutineFinalizer(object userData) {
+	delete static_cast<Coroutine*>(userData);
+}
+Boolean VMStorage::InCoroutine() {
+	return _coroutines.Count() > 0;
+}
+IntrinsicResult VMStorage::YieldCoroutine(Value value) {
+	_coroutineYielded = Boolean(true);
+	_coroutineYieldValue = value;
+	return IntrinsicResult(Value::Null, Boolean(false));
+}
+IntrinsicResult VMStorage::ResumeCoroutine(Coroutine co,Value value,Boolean continuing) {
+	if (!continuing) {
+		if (co.Status() == CoroutineStatus::Dead) {
+			return IntrinsicResult(ErrorTypes::RuntimeError("resume: the coroutine has finished"));
+		}
+		if (co.Status() == CoroutineStatus::Running || co.Status() == CoroutineStatus::Normal) {
+			return IntrinsicResult(ErrorTypes::RuntimeError("resume: the coroutine is already running"));
+		}
+		if (co.Status() == CoroutineStatus::NotStarted && !StartCoroutine(co, value)) return IntrinsicResult::Null;
+	}
+	Boolean mustFinish = _hasPendingManualCall;
+	Boolean savedRunning = IsRunning;
+	Value savedError = Error;
+
+	SwapCoroutine(co);
+	if (_coroutines.Count() > 0) {
+		Coroutine resumer = _coroutines[_coroutines.Count() - 1];
+		resumer.set_Status(CoroutineStatus::Normal);
+	}
+	_coroutines.Add(co);
+	co.set_Status(CoroutineStatus::Running);
+	IsRunning = Boolean(true);
+	Error = Value::Null;
+	if (!continuing && co.YieldResultIndex() >= 0) {
+		stack[co.YieldResultIndex()] = value;
+		co.set_YieldResultIndex(-1);
+	}
+
+	Value result = Value::Null;
+	Boolean ready = !continuing || FinishPendingCall();
+	while (Boolean(true)) {
+		if (ready) result = RunInner(mustFinish ? 0 : CoroutineBatch);
+		if (_coroutineYielded || !IsRunning || !mustFinish) break;
+		ready = FinishPendingCall();
+	}
+
+	// Now it has yielded, finished (or failed), or is to carry on later.
+	CoroutineStatus status = CoroutineStatus::Running;
+	if (_coroutineYielded) {
+		status = CoroutineStatus::Suspended;
+		result = _coroutineYieldValue;
+		_coroutineYielded = Boolean(false);
+		_coroutineYieldValue = Value::Null;
+		co.set_YieldResultIndex(_pendingResultIndex);
+		_pendingCallback = nullptr;
+	} else if (!IsRunning) {
+		status = CoroutineStatus::Dead;
+	}
+	Value coError = Error;
+
+	_coroutines.RemoveAt(_coroutines.Count() - 1);
+	SwapCoroutine(co);
+	if (_coroutines.Count() > 0) {
+		Coroutine resumer = _coroutines[_coroutines.Count() - 1];
+		resumer.set_Status(CoroutineStatus::Running);
+	}
+	co.set_Status(status);
+	IsRunning = savedRunning;
+	Error = savedError;
+
+	if (status == CoroutineStatus::Running) return IntrinsicResult(Value::Null, Boolean(false));
+	if (status == CoroutineStatus::Dead) {
+		if (coError.IsError() || ExitRequested) {
+			// Stop the resumer's run too -- surfacing the error there, as
+			// RunFunction does.
+			ReleaseCoroutine(co, Boolean(false));
+			if (coError.IsError()) Error = coError;
+			IsRunning = Boolean(false);
+			return IntrinsicResult::Null;
+		}
+		ReleaseCoroutine(co, Boolean(true));
+	}
+	return IntrinsicResult(result);
+}
+Boolean VMStorage::StartCoroutine(Coroutine co,Value value) {
+	Value func = co.Function();
+	FuncDef callee = func.FunctionDef();
+	if (callee.MaxRegs() > _stackSlotLimit) {
+		RaiseRuntimeError("Stack Overflow");
+		return Boolean(false);
+	}
+	if (IsNull(_coroutineExit)) {
+		_coroutineExit =  FuncDef::New();
+		_coroutineExit.set_Name("@coroutine");
+		_coroutineExit.AddInstruction(BytecodeUtil::INS(Opcode::RETURN), 0);
+		_coroutineExit.set_MaxRegs(1);
+	}
+	if (_spareCoroutines.Count() > 0) {
+		Coroutine spare = _spareCoroutines[_spareCoroutines.Count() - 1];
+		_spareCoroutines.RemoveAt(_spareCoroutines.Count() - 1);
+		co.set_Stack(spare.Stack());
+		co.set_Names(spare.Names());
+		co.set_CallStack(spare.CallStack());
+		co.set_PendingCallStack(spare.PendingCallStack());
+		spare.set_Stack(nullptr);
+		spare.set_Names(nullptr);
+		spare.set_CallStack(nullptr);
+		spare.set_PendingCallStack(nullptr);
+	} else {
+		List<Value> newRegs =  List<Value>::New(coroutineStackSlots);
+		List<Value> newNames =  List<Value>::New(coroutineStackSlots);
+		for (Int32 i = 0; i < coroutineStackSlots; i++) {
+			newRegs.Add(Value::Null);
+			newNames.Add(Value::Null);
+		}
+		List<CallInfo> newFrames =  List<CallInfo>::New(coroutineCallSlots);
+		for (Int32 i = 0; i < coroutineCallSlots; i++) {
+			newFrames.Add(CallInfo(0, 0, nullptr));
+		}
+		co.set_Stack(newRegs);
+		co.set_Names(newNames);
+		co.set_CallStack(newFrames);
+		co.set_PendingCallStack( List<PendingCallState>::New());
+	}
+
+	// The function's frame, at base 0, as ProcessArguments + SetupCallFrame
+	// would leave it.
+	List<Value> regs = co.Stack();
+	List<Value> regNames = co.Names();
+	List<CallInfo> frames = co.CallStack();
+	while (regs.Count() < callee.MaxRegs()) {
+		regs.Add(Value::Null);
+		regNames.Add(Value::Null);
+	}
+	regs[0] = Value::Null;
+	regNames[0] = Value::Null;
+	Int32 paramCount = callee.ParamNames().Count();
+	for (Int32 i = 0; i < paramCount; i++) {
+		regs[1 + i] = (i == 0 && !value.IsNull()) ? value : callee.ParamDefaults()[i];
+		regNames[1 + i] = callee.ParamNames()[i];
+	}
+	for (Int32 i = paramCount + 1; i < callee.MaxRegs(); i++) {
+		regs[i] = Value::Null;
+		regNames[i] = Value::Null;
+	}
+	frames[0] = CallInfo(0, 0, _coroutineExit);
+	frames[1] = CallInfo(0, 0, _coroutineExit, 0, func.OuterVars());
+	co.set_CallStackTop(2);
+	co.set_PC(0);
+	co.set_BaseIndex(0);
+	co.set_CurrentFunction(callee);
+	co.set_Status(CoroutineStatus::Suspended);
+	return Boolean(true);
+}
+void VMStorage::SwapCoroutine(Coroutine co) {
+	List<Value> regs = stack;
+	stack = co.Stack();
+	co.set_Stack(regs);
+	regs = names;
+	names = co.Names();
+	co.set_Names(regs);
+	List<CallInfo> frames = callStack;
+	callStack = co.CallStack();
+	co.set_CallStack(frames);
+	Int32 n = callStackTop;
+	callStackTop = co.CallStackTop();
+	co.set_CallStackTop(n);
+	n = PC;
+	PC = co.PC();
+	co.set_PC(n);
+	n = BaseIndex;
+	BaseIndex = co.BaseIndex();
+	co.set_BaseIndex(n);
+	FuncDef func = CurrentFunction;
+	CurrentFunction = co.CurrentFunction();
+	co.set_CurrentFunction(func);
+	n = _nativeFrameTop;
+	_nativeFrameTop = co.NativeFrameTop();
+	co.set_NativeFrameTop(n);
+	Value v = pendingSelf;
+	pendingSelf = co.PendingSelf();
+	co.set_PendingSelf(v);
+	v = pendingSuper;
+	pendingSuper = co.PendingSuper();
+	co.set_PendingSuper(v);
+	Boolean b = hasPendingContext;
+	hasPendingContext = co.HasPendingContext();
+	co.set_HasPendingContext(b);
+
+	NativeCallbackDelegate callback = _pendingCallback;
+	_pendingCallback = co.PendingCallback();
+	co.set_PendingCallback(callback);
+	func = _pendingCallee;
+	_pendingCallee = co.PendingCallee();
+	co.set_PendingCallee(func);
+	n = _pendingCalleeBase;
+	_pendingCalleeBase = co.PendingCalleeBase();
+	co.set_PendingCalleeBase(n);
+	n = _pendingArgCount;
+	_pendingArgCount = co.PendingArgCount();
+	co.set_PendingArgCount(n);
+	n = _pendingResultIndex;
+	_pendingResultIndex = co.PendingResultIndex();
+	co.set_PendingResultIndex(n);
+	b = _pendingIsManual;
+	_pendingIsManual = co.PendingIsManual();
+	co.set_PendingIsManual(b);
+	b = _hasPendingManualCall;
+	_hasPendingManualCall = co.HasPendingManualCall();
+	co.set_HasPendingManualCall(b);
+	n = _pendingManualCallDepth;
+	_pendingManualCallDepth = co.PendingManualCallDepth();
+	co.set_PendingManualCallDepth(n);
+	v = ManualCallResult;
+	ManualCallResult = co.ManualCallResult();
+	co.set_ManualCallResult(v);
+	List<PendingCallState> pending = _pendingCallStack;
+	_pendingCallStack = co.PendingCallStack();
+	co.set_PendingCallStack(pending);
+}
+void VMStorage::ReleaseCoroutine(Coroutine co,Boolean reuse) {
+	co.set_CurrentFunction(nullptr);
+	co.set_CallStackTop(0);
+	if (reuse && _spareCoroutines.Count() < MaxSpareCoroutines) {
+		_spareCoroutines.Add(co);
+	} else {
+		co.set_Stack(nullptr);
+		co.set_Names(nullptr);
+		co.set_CallStack(nullptr);
+		co.set_PendingCallStack(nullptr);
+	}
+}
 void VMStorage::Reset(List<FuncDef> allFunctions) {
 	Reset(allFunctions, nullptr);
 }
@@ -419,6 +702,15 @@ void VMStorage::Reset(List<FuncDef> allFunctions,Globals globals) {
 	if (IsNull(_intrinsics)) {
 		_intrinsics =  Dictionary<String, Value>::New();
 		Intrinsic::RegisterAll(_intrinsics);
+		_intrinsicDefs =  List<FuncDef>::New();
+		_intrinsicSlots =  List<Int32>::New();
+		Int32 intrinsicCount = Intrinsic::Count();
+		for (Int32 i = 0; i < intrinsicCount; i++) {
+			Intrinsic intr = Intrinsic::GetByIndex(i);
+			Value func = intr.GetFunc();
+			_intrinsicDefs.Add(func.FunctionDef());
+			_intrinsicSlots.Add(-1);
+		}
 	}
 
 	// Basic validation
@@ -427,7 +719,7 @@ void VMStorage::Reset(List<FuncDef> allFunctions,Globals globals) {
 		return;
 	}
 
-	if (mainFunc.Code().Count() == 0) {
+	if (mainFunc.CodeCount() == 0) {
 		IOHelper::Print("Entry function has no code");
 		return;
 	}
@@ -453,9 +745,12 @@ void VMStorage::Reset(List<FuncDef> allFunctions,Globals globals) {
 
 	// Clear any pending intrinsic/manual-call state left over from an aborted run.
 	_pendingCallback = nullptr;
+	wakeTime = 0;
 	_hasPendingManualCall = Boolean(false);
 	_pendingIsManual = Boolean(false);
 	_pendingCallStack.Clear();
+	_coroutines.Clear();
+	_coroutineYielded = Boolean(false);
 
 	EnsureFrame(BaseIndex, CurrentFunction.MaxRegs());
 
@@ -468,6 +763,21 @@ void VMStorage::Reset(List<FuncDef> allFunctions,Globals globals) {
 }
 void VMStorage::Stop() {
 	IsRunning = Boolean(false);
+	wakeTime = 0;
+}
+void VMStorage::Idle() {
+	IsRunning = Boolean(false);
+	CurrentFunction = nullptr;
+	BaseIndex = 0;
+	callStackTop = 0;
+	ManualCallResult = Value::Null;
+	_pendingCallback = nullptr;
+	wakeTime = 0;
+	_hasPendingManualCall = Boolean(false);
+	_pendingIsManual = Boolean(false);
+	_pendingCallStack.Clear();
+	_coroutines.Clear();
+	_coroutineYielded = Boolean(false);
 }
 void VMStorage::RequestExit(Int32 resultCode) {
 	ExitRequested = Boolean(true);
@@ -512,22 +822,40 @@ Value VMStorage::BuildStackTrace() {
 	Value result = Value::make_list(8);
 	Int32 callSitePC = PC - 1;
 	if (callSitePC < 0) callSitePC = 0;
-	String curFile = CurrentFunction.FileName();
-	if (curFile == "") curFile = "(current program)";
-	result.Push(Value::make_string(StringUtils::Format("{0} line {1}", curFile, CurrentFunction.GetLineNumber(callSitePC))));
-	// callStack[0] is @main's own frame (not a caller), so stop at i=1.
-	for (Int32 i = CallStackDepth() - 1; i >= 1; i--) {
-		CallInfo ci = GetCallStackFrame(i);
-		FuncDef callerFunc = ci.ReturnFunc;
-		Int32 callerPC = ci.ReturnPC - 1;
-		if (callerPC < 0) callerPC = 0;
-		String callerFile = callerFunc.FileName();
-		if (callerFile == "") callerFile = "(current program)";
-		result.Push(Value::make_string(StringUtils::Format("{0} line {1}", callerFile, callerFunc.GetLineNumber(callerPC))));
+	PushTraceLines(result, CurrentFunction, callSitePC);
+	// callStack[0] is @main's own frame (not a caller), so stop at i=1 --
+	// or, in a coroutine, at i=2, as frame 1 returns to _coroutineExit.
+	// Then go on to the frames of whoever resumed it.
+	Int32 level = _coroutines.Count();
+	PushFrameTraces(result, callStack, callStackTop, level > 0 ? 2 : 1);
+	while (level > 0) {
+		level--;
+		Coroutine resumer = _coroutines[level];
+		callSitePC = resumer.PC() - 1;
+		if (callSitePC < 0) callSitePC = 0;
+		PushTraceLines(result, resumer.CurrentFunction(), callSitePC);
+		PushFrameTraces(result, resumer.CallStack(), resumer.CallStackTop(), level > 0 ? 2 : 1);
 	}
 	result.Freeze();
 	return result;
 }
+void VMStorage::PushFrameTraces(Value result,List<CallInfo> frames,Int32 top,Int32 bottom) {
+	for (Int32 i = top - 1; i >= bottom; i--) {
+		CallInfo ci = frames[i];
+		Int32 callerPC = ci.ReturnPC - 1;
+		if (callerPC < 0) callerPC = 0;
+		PushTraceLines(result, ci.ReturnFunc, callerPC);
+	}
+}
+void VMStorage::PushTraceLines(Value result,FuncDef func,Int32 pc) {
+	String file = func.FileName();
+	if (file == "") file = "(current program)";
+	result.Push(Value::make_string(StringUtils::Format("{0} line {1}", file, func.GetLineNumber(pc))));
+	Int32 callLine = func.GetInlineCallLine(pc);
+	if (callLine > 0) {
+		result.Push(Value::make_string(StringUtils::Format("{0} line {1}", file, callLine)));
+	}
+}
 List<FuncDef> VMStorage::GetFunctions() {
 	List<FuncDef> result =  List<FuncDef>::New();
 	CollectFunctions(CurrentFunction, result);
@@ -539,6 +867,7 @@ void VMStorage::CollectFunctions(FuncDef func,List<FuncDef> outList) {
 		if (outList[i].Name() == func.Name()) return;  // already collected
 	}
 	outList.Add(func);
+	func.EnsureConstants();
 	List<Value> consts = func.Constants();
 	for (Int32 i = 0; i < consts.Count(); i++) {
 		if (consts[i].IsFuncRef()) CollectFunctions(consts[i].FunctionDef(), outList);
@@ -550,7 +879,7 @@ Int32 VMStorage::SelfParamOffset(FuncDef callee) {
 	}
 	return 0;
 }
-Int32 VMStorage::ProcessArguments(Int32 argCount,Int32 selfParam,Int32 startPC,Int32 callerBase,Int32 calleeBase,FuncDef callee,List<UInt32> code) {
+Int32 VMStorage::ProcessArguments(Int32 argCount,Int32 selfParam,Int32 startPC,Int32 callerBase,Int32 calleeBase,FuncDef callee,FuncDef caller) {
 	Int32 paramCount = callee.ParamNames().Count();
 
 	// Step 1: Validate argument count (selfParam accounts for the injected self)
@@ -566,7 +895,7 @@ Int32 VMStorage::ProcessArguments(Int32 argCount,Int32 selfParam,Int32 startPC,I
 	Int32 currentPC = startPC;
 	Value argValue = Value::Null;  // Declared outside loop for GC safety
 	for (Int32 i = 0; i < argCount; i++) {
-		UInt32 argInstruction = code[currentPC];
+		UInt32 argInstruction = caller.CodeAt(currentPC);
 		Opcode argOp = (Opcode)BytecodeUtil::OP(argInstruction);
 
 		argValue = Value::Null;
@@ -661,7 +990,7 @@ Int32 VMStorage::AutoInvokeFuncRef(Value funcRefVal,Int32 resultReg,Int32 return
 	}
 
 	// User function: push CallInfo and set up callee frame
-	if (callStackTop >= callStack.Count()) {
+	if (callStackTop >= callStack.Count() && !GrowCallStack()) {
 		RaiseRuntimeError("Call stack overflow");
 		return -1;
 	}
@@ -678,6 +1007,15 @@ Int32 VMStorage::AutoInvokeFuncRef(Value funcRefVal,Int32 resultReg,Int32 return
 	return 0;
 }
 bool VMStorage::InvokeNativeCallback(NativeCallbackDelegate callback,FuncDef callee,Int32 calleeBase,Int32 argCount,IntrinsicResult partialResult,Int32 absoluteResultIndex) {
+	// A simple intrinsic always finishes at once, and gets just its argument
+	// registers: no Context, IntrinsicResult, or CStrArena bracket.
+	SimpleCallbackDelegate simple = callee.SimpleCallback();
+	if (!IsNull(simple)) {
+		Int32 paramCount = callee.ParamNames().Count();
+		Value result = simple(&stack[calleeBase + 1], paramCount);
+		stack[absoluteResultIndex] = result;
+		return Boolean(true);
+	}
 	Context context = Context(
 		*this,
 		stack,
@@ -691,6 +1029,7 @@ bool VMStorage::InvokeNativeCallback(NativeCallbackDelegate callback,FuncDef cal
 	// Bracket the callback with a CStrArena mark/reset so any Value::c_str()
 	// the intrinsic makes is freed when it returns (C++ only; see cstr_arena.h).
 	CStrArena::Mark _cstrArenaMark = CStrArena::GetMark();
+	wakeTime = 0;
 	IntrinsicResult ir = callback(context, partialResult);
 	CStrArena::Reset(_cstrArenaMark);
 	_nativeFrameTop = savedNativeTop;
@@ -723,46 +1062,51 @@ Value VMStorage::Run(UInt32 maxCycles) {
 	VM previousVM = _activeVM;
 	_activeVM = _this;
 
-	// If we have a pending intrinsic continuation, handle it.
-	if (!IsNull(_pendingCallback)) {
-		if (_hasPendingManualCall) {
-			// A manually-pushed call (e.g. from the import intrinsic) is still
-			// running.  Fall through to RunInner so the module code can execute.
-		} else {
-			// Normal case: re-invoke the pending intrinsic callback.
-			IntrinsicResult partialResult = IntrinsicResult(stack[_pendingResultIndex], Boolean(false));
-			if (!InvokeNativeCallback(_pendingCallback, _pendingCallee, _pendingCalleeBase, _pendingArgCount, partialResult, _pendingResultIndex)) {
-				// Still not done; return without running any bytecode
-				_activeVM = previousVM;
-				return Value::Null;
-			}
-			// The continuation completed.  If it was a nested manual call
-			// (import), restore the outer pending call we saved when it was
-			// pushed, so the outer import resumes (its module keeps running,
-			// then its own continuation fires).  Otherwise, just clear.
-			if (_pendingIsManual && _pendingCallStack.Count() > 0) {
-				PendingCallState saved = _pendingCallStack[_pendingCallStack.Count() - 1];
-				_pendingCallStack.RemoveAt(_pendingCallStack.Count() - 1);
-				_pendingCallback = saved.Callback;
-				_pendingCallee = saved.Callee;
-				_pendingCalleeBase = saved.CalleeBase;
-				_pendingArgCount = saved.ArgCount;
-				_pendingResultIndex = saved.ResultIndex;
-				_pendingIsManual = saved.IsManual;
-				_hasPendingManualCall = saved.HasManual;
-				_pendingManualCallDepth = saved.ManualDepth;
-				ManualCallResult = saved.ManualResult;
-			} else {
-				_pendingCallback = nullptr;
-				_pendingIsManual = Boolean(false);
-			}
-		}
+	// If we have a pending intrinsic continuation, handle it; if it is
+	// still not done, return without running any bytecode.
+	if (!FinishPendingCall()) {
+		_activeVM = previousVM;
+		return Value::Null;
 	}
 
 	Value runResult = RunInner(maxCycles);
 	_activeVM = previousVM;
 	return runResult;
 }
+Boolean VMStorage::FinishPendingCall() {
+	if (IsNull(_pendingCallback)) return Boolean(true);
+	if (_hasPendingManualCall) {
+		// A manually-pushed call (e.g. from the import intrinsic) is still
+		// running.  Fall through to RunInner so the module code can execute.
+		return Boolean(true);
+	}
+	// Normal case: re-invoke the pending intrinsic callback.
+	IntrinsicResult partialResult = IntrinsicResult(stack[_pendingResultIndex], Boolean(false));
+	if (!InvokeNativeCallback(_pendingCallback, _pendingCallee, _pendingCalleeBase, _pendingArgCount, partialResult, _pendingResultIndex)) {
+		return Boolean(false);
+	}
+	// The continuation completed.  If it was a nested manual call
+	// (import), restore the outer pending call we saved when it was
+	// pushed, so the outer import resumes (its module keeps running,
+	// then its own continuation fires).  Otherwise, just clear.
+	if (_pendingIsManual && _pendingCallStack.Count() > 0) {
+		PendingCallState saved = _pendingCallStack[_pendingCallStack.Count() - 1];
+		_pendingCallStack.RemoveAt(_pendingCallStack.Count() - 1);
+		_pendingCallback = saved.Callback;
+		_pendingCallee = saved.Callee;
+		_pendingCalleeBase = saved.CalleeBase;
+		_pendingArgCount = saved.ArgCount;
+		_pendingResultIndex = saved.ResultIndex;
+		_pendingIsManual = saved.IsManual;
+		_hasPendingManualCall = saved.HasManual;
+		_pendingManualCallDepth = saved.ManualDepth;
+		ManualCallResult = saved.ManualResult;
+	} else {
+		_pendingCallback = nullptr;
+		_pendingIsManual = Boolean(false);
+	}
+	return Boolean(true);
+}
 Value VMStorage::RunInner(UInt32 maxCycles) {
 	VM _this(std::static_pointer_cast<VMStorage>(shared_from_this()));
 	// Copy instance variables to locals for performance
@@ -770,7 +1114,6 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 	Int32 baseIndex = BaseIndex;
 	FuncDef currentFunc = CurrentFunction;
 
-	Value* stackPtr = &stack[0];
 	// Note: CollectionsMarshal.AsSpan requires .NET 5+; not compatible with Mono.
 	// This gives us direct array access without copying, for performance.
 	
@@ -781,7 +1124,9 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 	Value* curConstants = nullptr;
 	Value* localStack = nullptr;
 	
-	SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+	SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+
+	Int32 stackMoves = _stackMoves;
 
 	UInt32 cyclesLeft = maxCycles;
 	if (maxCycles == 0) cyclesLeft--;  // wraps to MAX_UINT32
@@ -936,7 +1281,11 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 						baseIndex += curFuncRaw->MaxRegs;
 						pc = 0;
 						currentFunc = autoCallee;
-						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					} else if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					}
 				}
 				VM_NEXT();
@@ -999,7 +1348,46 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 						baseIndex += curFuncRaw->MaxRegs;
 						pc = 0;
 						currentFunc = autoCallee;
-						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					} else if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					}
+				}
+				VM_NEXT();
+			}
+
+			VM_CASE(LOADC_rA_rB) {
+				// R[A] = R[B], calling the function if the value is a function
+				// reference.  LOADC_rA_rB_kC without the name check: the code
+				// generator uses it for a register it knows holds the value (a
+				// parameter of an inlined function, bound to a temporary), where
+				// there is no variable name to verify.
+				Byte a = BytecodeUtil::Au(instruction);
+				Byte b = BytecodeUtil::Bu(instruction);
+				valB = localStack[b];
+
+				if (!valB.IsFuncRef()) {
+					// Simple case: value is not a funcref, so just copy it
+					localStack[a] = valB;
+				} else {
+					// Value is a funcref — auto-invoke with zero args
+					FuncDef autoCallee = nullptr;
+					Int32 status = AutoInvokeFuncRef(valB, a, pc, baseIndex, currentFunc, &autoCallee);
+					if (status == -2) {
+						// Native callback pending — exit RunInner
+						cyclesLeft = 0;
+					} else if (status == 0) {
+						// Frame was pushed — switch to callee
+						baseIndex += curFuncRaw->MaxRegs;
+						pc = 0;
+						currentFunc = autoCallee;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					} else if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					}
 				}
 				VM_NEXT();
@@ -1358,7 +1746,11 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 						baseIndex += curFuncRaw->MaxRegs;
 						pc = 0;
 						currentFunc = autoCallee;
-						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					} else if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 					}
 				}
 				VM_NEXT();
@@ -1788,6 +2180,21 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				VM_NEXT();
 			}
 
+			VM_CASE(IFFUNC_rA_kBC) {
+				// if R[A] is not a funcref to the function of the template at
+				// constants[BC], skip next instruction.  This guards an inlined
+				// call: the captured closure doesn't matter, only which function
+				// the name is bound to right now.
+				Byte a = BytecodeUtil::Au(instruction);
+				UInt16 constIdx = BytecodeUtil::BCu(instruction);
+				FuncDef expected = curConstants[constIdx].FunctionDef();
+				FuncDef actual = localStack[a].FunctionDef();
+				if (actual.get_storage() != expected.get_storage()) {
+					pc++; // Skip next instruction
+				}
+				VM_NEXT();
+			}
+
 			VM_CASE(NEXT_rA_rB) {
 				// Advance iterator R[A] to next entry in collection R[B].
 				// If there is a next entry, skip next instruction (the JUMP to end).
@@ -1830,7 +2237,7 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				}
 				UInt32 callInstruction = curCode[callPC];
 				Opcode callOp = (Opcode)BytecodeUtil::OP(callInstruction);
-				if (callOp != Opcode::CALL_rA_rB_rC) {
+				if (callOp != Opcode::CALL_rA_rB_rC && callOp != Opcode::CALLINTRINSIC_rA_rB_iC) {
 					RaiseRuntimeError("ARGBLK must be followed by CALL");
 					return Value::Null;
 				}
@@ -1840,7 +2247,53 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				Byte b = BytecodeUtil::Bu(callInstruction);
 				Byte c = BytecodeUtil::Cu(callInstruction);
 
-				valC = localStack[c];  // func ref
+				if (callOp == Opcode::CALLINTRINSIC_rA_rB_iC) {
+					// CALLINTRINSIC r[A], r[B], C: call intrinsic C, frame at r[B],
+					// result to r[A].  While its name still means the intrinsic
+					// here -- nothing in front of globals could shadow it (the
+					// frame test GLOADC makes), and its global slot is unassigned
+					// -- call its SimpleCallback on the arguments in place: no
+					// funcref to load, and no Context to build.  Otherwise, call
+					// whatever the name means now, as CALL would.
+					if (c >= _intrinsicDefs.Count()) {
+						RaiseRuntimeError("CALLINTRINSIC: Unknown intrinsic");
+						return Value::Null;
+					}
+					FuncDef intrinsic = _intrinsicDefs[c];
+					Int32 slot = (_intrinsicSlotsId == _globalsId) ? _intrinsicSlots[c] : -1;
+					if (slot < 0) slot = IntrinsicSlot(c);
+					Boolean frameClear = (callStackTop <= 1 || GlobalFastPath());
+					Int32 paramCount = intrinsic.ParamNames().Count();
+					if (frameClear && !hasPendingContext && argCount <= paramCount && _globals.ValueAtSlot(slot).IsUnassigned()) {
+						Int32 argBase = baseIndex + b + 1;
+						if (!EnsureFrame(baseIndex + b, intrinsic.MaxRegs())) return Value::Null;
+						if (stackMoves != _stackMoves) {
+							// Making room for the frame grew the stack; find this frame again.
+							stackMoves = _stackMoves;
+							SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+						}
+						for (Int32 i = 0; i < argCount; i++) {
+							UInt32 argInstruction = curCode[pc + i];
+							if ((Opcode)BytecodeUtil::OP(argInstruction) == Opcode::ARG_rA) {
+								stack[argBase + i] = localStack[BytecodeUtil::Au(argInstruction)];
+							} else {
+								stack[argBase + i] = Value(BytecodeUtil::ABCs(argInstruction));
+							}
+						}
+						for (Int32 i = argCount; i < paramCount; i++) {
+							stack[argBase + i] = intrinsic.ParamDefaults()[i];
+						}
+						SimpleCallbackDelegate simple = intrinsic.SimpleCallback();
+						val = simple(localStack + b + 1, paramCount);
+						localStack[a] = val;
+						pc = callPC + 1;
+						VM_NEXT();
+					}
+					valC = LookupVariable(_globals.NameAtSlot(slot));
+					if (!IsRunning) return Value::Null;
+				} else {
+					valC = localStack[c];  // func ref
+				}
 				if (!valC.IsFuncRef()) {
 					RaiseRuntimeError("ARGBLK/CALL: Not a function reference");
 					return Value::Null;
@@ -1861,7 +2314,7 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				// defaults into it (otherwise deep recursion writes out of range).
 				if (!EnsureFrame(calleeBase, callee.MaxRegs())) return Value::Null;
 				Int32 nextPC = ProcessArguments(argCount, selfParam, pc, baseIndex, calleeBase, callee,
-				  curFuncRaw->Code);
+				  currentFunc);
 				if (nextPC < 0) return Value::Null; // Error already raised
 				if (selfParam > 0) {
 					stack[calleeBase + 1] = pendingSelf;
@@ -1884,16 +2337,21 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 							pc = PC;
 							baseIndex = BaseIndex;
 							currentFunc = CurrentFunction;
-							SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+							SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 						} else {
 							cyclesLeft = 0;
 						}
 					}
+					if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					}
 					VM_NEXT();
 				}
 
 				// Now execute the CALL (step 6): push CallInfo and switch to callee
-				if (callStackTop >= callStack.Count()) {
+				if (callStackTop >= callStack.Count() && !GrowCallStack()) {
 					RaiseRuntimeError("Call stack overflow");
 					VM_NEXT();
 				}
@@ -1905,7 +2363,7 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				baseIndex = calleeBase;
 				currentFunc = callee; // Switch to callee function
 				pc = 0; // Start at beginning of callee code
-				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 				VM_NEXT();
 			}
 
@@ -1938,7 +2396,7 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				}
 
 				// Push return info
-				if (callStackTop >= callStack.Count()) {
+				if (callStackTop >= callStack.Count() && !GrowCallStack()) {
 					RaiseRuntimeError("Call stack overflow");
 					VM_NEXT();
 				}
@@ -1950,11 +2408,12 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				// Note: ApplyPendingContext skipped for CALLF (only needed for method dispatch via CALL)
 				pc = 0; // Start at beginning of callee code
 				currentFunc = callee; // Switch to callee function
-				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
 
 				// No frame writes happen before the next opcode, so just verify
-				// (it raises and halts on overflow) and fall through to break.
+				// (it raises and halts on overflow).  That may grow the stack, so
+				// switch frames after it.
 				EnsureFrame(baseIndex, callee.MaxRegs());
+				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 				VM_NEXT();
 			}
 
@@ -2002,15 +2461,20 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 							pc = PC;
 							baseIndex = BaseIndex;
 							currentFunc = CurrentFunction;
-							SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+							SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 						} else {
 							cyclesLeft = 0;
 						}
 					}
+					if (stackMoves != _stackMoves) {
+						// The intrinsic ran script code that grew the stack; find this frame again.
+						stackMoves = _stackMoves;
+						SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+					}
 					VM_NEXT();
 				}
 
-				if (callStackTop >= callStack.Count()) {
+				if (callStackTop >= callStack.Count() && !GrowCallStack()) {
 					RaiseRuntimeError("Call stack overflow");
 					VM_NEXT();
 				}
@@ -2021,7 +2485,13 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				baseIndex = calleeBase;
 				pc = 0; // Start at beginning of callee code
 				currentFunc = callee; // Switch to callee function
-				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+				VM_NEXT();
+			}
+
+			VM_CASE(CALLINTRINSIC_rA_rB_iC) {
+				// Like ARG, this is processed as part of the ARGBLK opcode.
+				RaiseRuntimeError("Internal error: CALLINTRINSIC without ARGBLK");
 				VM_NEXT();
 			}
 
@@ -2260,7 +2730,11 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 					baseIndex += curFuncRaw->MaxRegs;
 					pc = 0;
 					currentFunc = autoCallee;
-					SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+					SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
+				} else if (stackMoves != _stackMoves) {
+					// The intrinsic ran script code that grew the stack; find this frame again.
+					stackMoves = _stackMoves;
+					SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 				}
 				VM_NEXT();
 			}
@@ -2292,7 +2766,7 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				pc = callInfo.ReturnPC;
 				baseIndex = callInfo.ReturnBase;
 				currentFunc = callInfo.ReturnFunc;
-				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack, stackPtr);
+				SwitchFrame(currentFunc, baseIndex, curFuncRaw, codeCount, curCode, curConstants, localStack);
 
 				if (callInfo.CopyResultToReg >= 0) {
 					stack[baseIndex + callInfo.CopyResultToReg] = val;
@@ -2331,6 +2805,51 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 				VM_NEXT();
 			}
 
+			VM_CASE(ITERNEXT_rA_rB_rC) {
+				// NEXT and ITERGET fused: advance iterator R[C] over container
+				// R[B]; if there is a next entry, load it into R[A] and skip the
+				// next instruction (the JUMP to the end of the loop).  This is
+				// what `for` loops emit, so each iteration is one dispatch.
+				//
+				// A computed numeric list -- what `range` returns -- is stepped
+				// with plain Double arithmetic, read in place: no materializing,
+				// no copy of the GCList, no generic Value math per element.
+				Byte a = BytecodeUtil::Au(instruction);
+				Byte b = BytecodeUtil::Bu(instruction);
+				Byte c = BytecodeUtil::Cu(instruction);
+				Int32 iter = localStack[c].IntValue();
+				valB = localStack[b];  // collection
+				if (valB.IsList()) {
+					Double rangeBase;
+					Double rangeStep;
+					Int32 rangeCount;
+					iter++;
+					if (GCManager::Lists.GetRange(valB.ItemIndex(), &rangeBase, &rangeStep, &rangeCount)) {
+						if (iter < rangeCount) {
+							localStack[a] = Value(rangeBase + rangeStep * iter);
+							pc++;
+						}
+					} else if (iter < valB.ListCount()) {
+						localStack[a] = valB.ListGet(iter);
+						pc++;
+					}
+				} else if (valB.IsMap()) {
+					iter = valB.IterNext(iter);
+					if (iter != Value::MAP_ITER_DONE) {
+						localStack[a] = valB.IterEntry(iter);
+						pc++;
+					}
+				} else if (valB.IsString()) {
+					iter++;
+					if (iter < valB.Length()) {
+						localStack[a] = valB.Substring(iter, 1);
+						pc++;
+					}
+				}
+				localStack[c] = Value(iter);
+				VM_NEXT();
+			}
+
 			VM_CASE(ERRCHK_rA) {
 				// Halt if R[A] holds an error.  Emitted after any expression
 				// compiled as a bare statement: its value goes nowhere, so an
@@ -2350,29 +2869,74 @@ Value VMStorage::RunInner(UInt32 maxCycles) {
 	SaveState(pc, baseIndex, currentFunc);
 	return Value::Null;
 }
+bool VMStorage::GrowStack(Int32 needed) {
+	if (needed > _stackSlotLimit) return Boolean(false);
+	Int32 newCount = stack.Count() * 2;
+	if (newCount < needed) newCount = needed;
+	if (newCount > _stackSlotLimit) newCount = _stackSlotLimit;
+	while (stack.Count() < newCount) {
+		stack.Add(Value::Null);
+		names.Add(Value::Null);
+	}
+	_stackMoves++;
+	return Boolean(true);
+}
+bool VMStorage::GrowCallStack() {
+	if (callStack.Count() >= _callSlotLimit) return Boolean(false);
+	Int32 newCount = callStack.Count() * 2;
+	if (newCount > _callSlotLimit) newCount = _callSlotLimit;
+	while (callStack.Count() < newCount) callStack.Add(CallInfo(0, 0, nullptr));
+	return Boolean(true);
+}
 FORCE_INLINE void VMStorage::SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex,
 		FuncDefStorage* &curFuncRaw, Int32 &codeCount,
 		UInt32* &curCode, Value* &curConstants,
-		Value* &localStack, Value* stackPtr) {
+		Value* &localStack) {
 	// Keep the frame-identifying fields current at every frame switch, so
 	// BuildStackTrace is accurate at any point (paired with PC = pc in the loop).
 	CurrentFunction = currentFunc;
 	BaseIndex = baseIndex;
 	curFuncRaw = currentFunc.get_storage();
-	codeCount = curFuncRaw->Code.Count();
-	curCode = &curFuncRaw->Code[0];
+	if (curFuncRaw->LazyConstantsPos >= 0) curFuncRaw->EnsureConstants();
+	if (curFuncRaw->BorrowedCode) {
+		// Code left in place in a mapped bytecode-cache file (see FuncDef).
+		codeCount = curFuncRaw->BorrowedCount;
+		curCode = (UInt32*)curFuncRaw->BorrowedCode;
+	} else {
+		codeCount = curFuncRaw->Code.Count();
+		curCode = &curFuncRaw->Code[0];
+	}
 	curConstants = curFuncRaw->Constants.Count() > 0 ? &curFuncRaw->Constants[0] : nullptr;
-	localStack = stackPtr + baseIndex;
+	localStack = &stack[0] + baseIndex;
 }
 Int32 VMStorage::ResolveGlobalRef(FuncDef func,Int32 refIdx) {
 	_globals.ResolveRefs(func);
 	return func.GlobalSlots()[refIdx];
 }
+Int32 VMStorage::IntrinsicSlot(Int32 idx) {
+	if (_intrinsicSlotsId != _globalsId) {
+		for (Int32 i = 0; i < _intrinsicSlots.Count(); i++) _intrinsicSlots[i] = -1;
+		_intrinsicSlotsId = _globalsId;
+	}
+	Int32 slot = _intrinsicSlots[idx];
+	if (slot < 0) {
+		FuncDef def = _intrinsicDefs[idx];
+		slot = _globals.Resolve(Value::make_string(def.Name()));
+		_intrinsicSlots[idx] = slot;
+	}
+	return slot;
+}
 Value VMStorage::GlobalMiss(FuncDef func,Int32 refIdx) {
+	Value cached = func.GlobalIntrinsics()[refIdx];
+	if (!cached.IsNull()) return cached;
+
 	Value name = func.GlobalNames()[refIdx];
 	Value result;
 	String nameStr = name.AsCString();
-	if (_intrinsics.TryGetValue(nameStr, &result)) return result;
+	if (_intrinsics.TryGetValue(nameStr, &result)) {
+		func.GlobalIntrinsics()[refIdx] = result;
+		return result;
+	}
 
 	// self/super read as null outside a method, matching LookupVariable.
 	if (name == Value::selfString || name == Value::superString) return Value::Null;
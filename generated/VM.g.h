@@ -13,6 +13,7 @@
 #include <chrono>
 #include "GCManager.g.h"
 #include "Globals.g.h"
+#include "Coroutine.g.h"
 
 namespace MiniScript {
 
@@ -68,6 +69,9 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	private: List<CallInfo> callStack;
 	private: Int32 callStackTop;
 	private: Dictionary<String, Value> _intrinsics; // intrinsic name -> FuncRef Value
+	private: List<FuncDef> _intrinsicDefs;
+	private: List<Int32> _intrinsicSlots;
+	private: Int32 _intrinsicSlotsId = 0;
 	public: Int32 PC;
 	public: FuncDef CurrentFunction;
 	public: Boolean IsRunning;
@@ -84,6 +88,10 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// callStackTop is the index of the next free slot (== current depth + 1).
 	// Invariant: callStackTop >= 1 during all execution (set up in Reset).
 
+	// Intrinsics by registry index, for CALLINTRINSIC; and the slot each one's
+	// name has in _globals, or -1 if not looked up yet (valid while
+	// _intrinsicSlotsId is _globals' Id; see IntrinsicSlot).
+
 	// Execution state (persistent across RunSteps calls)
 
 	// Set by the `exit` intrinsic: this run has asked its host to shut down,
@@ -139,6 +147,18 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	private: List<PendingCallState> _pendingCallStack;
 	private: Int32 _nativeFrameTop = 0;
 	public: bool yielding = Boolean(false);
+	public: double wakeTime = 0;
+	public: Int32 coroutineStackSlots = 128;
+	public: Int32 coroutineCallSlots = 32;
+	private: List<Coroutine> _coroutines; // those running now, innermost last
+	private: List<Coroutine> _spareCoroutines; // finished ones, whose stacks are reused
+	private: Int32 _stackSlotLimit = 0;
+	private: Int32 _callSlotLimit = 0;
+	private: Int32 _stackMoves = 0;
+	private: static const Int32 MaxSpareCoroutines;
+	private: FuncDef _coroutineExit = nullptr; // a bare RETURN, below each coroutine's function
+	private: Boolean _coroutineYielded = Boolean(false); // set by yield in a coroutine
+	private: Value _coroutineYieldValue = Value::Null;
 	private: std::chrono::steady_clock::time_point _startTime;
 
 	// Pending self/super for method calls, set by METHFIND/SETSELF,
@@ -169,9 +189,35 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 
 	// Set by the "yield" intrinsic; host app can check and clear this.
 
+	// While the "wait" intrinsic is pending: the ElapsedTime at which it is
+	// due to finish.  Nothing happens in the VM before then, so a host need
+	// not run it, and may sleep instead (see SecondsToWake).  Cleared before
+	// each call of an intrinsic's callback, so it only ever describes the
+	// pending call that set it (wait sets it again on every continuation).
+
+	// Coroutines (see Coroutine.cs and ResumeCoroutine).  Each has a register
+	// stack and call stack of its own.  They start much smaller than the VM's,
+	// so that thousands can be suspended at once, and grow as the coroutine
+	// goes deeper, up to the size of the VM's own (see GrowStack).
+
+	// The most registers and call frames any stack may have: the size the
+	// VM's own stacks are made at.  Only a coroutine's stacks are smaller.
+	// How many times a stack has grown, and so moved.  RunInner holds a pointer
+	// into the stack (localStack); when anything it calls out to may have run
+	// script code, it compares this with the count it last saw, and finds its
+	// frame again if they differ.
+
 	// Wall-clock start time, set in Reset(), used by the "time" intrinsic.
 	
 	public: double ElapsedTime();
+
+	// True when an intrinsic has said it is not done yet (receive on an empty
+	// channel, say), so the next Run will only call it again.
+	public: Boolean IsBlocked();
+
+	// Seconds until a pending wait is due to finish; 0 if the VM is not in a
+	// wait, or the wait is due now.
+	public: double SecondsToWake();
 	private: thread_local static VM _activeVM;
 
 	// Thread-local active VM: set during Run(), so value operations
@@ -208,9 +254,20 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// intrinsics from collection.
 	public: static void MarkRoots(object user_data);
 
+	// Mark the live registers (below liveTop) of a register stack, and what
+	// its call frames hold.
+	private: static void MarkFrames(List<Value> stack, List<Value> names, Int32 liveTop, List<CallInfo> callStack, Int32 callStackTop, FuncDef currentFunc);
+
+	private: static void MarkPendingCalls(List<PendingCallState> pending);
+
+	// Mark the execution state held in a Coroutine: its own, if suspended,
+	// or its resumer's, if running.  (A resumer is inside the resume call, so
+	// its live registers run up to the top of that call's frame.)
+	private: static void MarkCoroutine(Coroutine co);
+
 	// Mark a function's compile-time constants (used by the GC root scan).
 	// Recursion into nested-function templates happens via GCFunction.MarkChildren.
-	private: void MarkFuncConstants(FuncDef func);
+	private: static void MarkFuncConstants(FuncDef func);
 
 	// Push a manually-constructed call to a set of compiled functions (used by import).
 	// The first function in importFunctions is treated as @main for the pushed call.
@@ -244,6 +301,67 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// defaults.  Returns the callee's result, or Value.Null on error (with the
 	// error surfaced on the outer run so RunUntilDone reports it).
 	public: Value RunFunction(Value funcRef, List<Value> args);
+	private: static const UInt32 CoroutineBatch;
+
+	// ── Coroutines ──────────────────────────────────────────────────────────
+	// A coroutine runs nested inside the resume call, much as RunFunction runs
+	// its function: ResumeCoroutine swaps the coroutine's registers, call
+	// stack and frame state into the VM (SwapCoroutine), drives RunInner until
+	// the coroutine yields or finishes, and swaps back.  Its function runs as
+	// an ordinary call at depth 1, over a bare RETURN (_coroutineExit) at
+	// depth 0 -- so when the function returns, RunInner ends just as it does
+	// at the end of @main.  A yield is an intrinsic that does not finish
+	// (YieldCoroutine): RunInner stops at once, and the value passed to the
+	// next resume is stored as its result.
+	// A coroutine that starts a wait, or runs for longer than a batch, also
+	// swaps out, and the resume call is left not done, so the interpreter
+	// waits (or takes its turn) as usual; the resume intrinsic's continuation
+	// then swaps it back in to carry on.  The exception is a resume made under
+	// RunFunction, which must finish before it returns: there, the coroutine
+	// simply runs until it yields or finishes.
+
+	// How many instructions a coroutine runs before it swaps out, letting the
+	// host see the time (see above).
+
+	// Make a new coroutine to run func, as a handle for scripts to hold.
+	public: static Value MakeCoroutine(Value func);
+
+	// The coroutine a handle made by MakeCoroutine stands for, or null if the
+	// value is not one.
+	public: static Coroutine GetCoroutine(Value v);
+
+	public: static void MarkCoroutineHandle(object userData);
+
+	public: static void CoroutineFinalizer(object userData);
+
+	// True while a coroutine is running (so yield means "back to the resumer").
+	public: Boolean InCoroutine();
+
+	// Stop the running coroutine, giving value to its resumer.  The yield
+	// intrinsic returns what this returns: a result that is not done, which
+	// stops RunInner straight after the call.
+	public: IntrinsicResult YieldCoroutine(Value value);
+
+	// Run a coroutine until it yields or finishes, and return what it yielded
+	// or returned.  value is the result of the yield it is suspended in -- or,
+	// when it first starts, its function's first argument (if not null).  The
+	// resume intrinsic passes continuing = true when it is re-invoked after a
+	// previous call was left not done (see above).
+	public: IntrinsicResult ResumeCoroutine(Coroutine co, Value value, Boolean continuing);
+
+	// Give a coroutine that has not run yet its stacks, and set up the call
+	// to its function (see above).  Returns false on error.
+	private: Boolean StartCoroutine(Coroutine co, Value value);
+
+	// Exchange the VM's registers, call stack and frame state with those
+	// held in a Coroutine (see Coroutine.cs).
+	private: void SwapCoroutine(Coroutine co);
+
+	// A coroutine has finished: let go of its stacks, or, if reuse, keep them
+	// for the next one to start (unless enough are kept already).  Reuse only
+	// those of one that returned normally, so that no frame's locals map
+	// still refers to its registers.
+	private: void ReleaseCoroutine(Coroutine co, Boolean reuse);
 
 	public: void Reset(List<FuncDef> allFunctions);
 
@@ -258,6 +376,11 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 
 	public: void Stop();
 
+	// Stop, and forget the frames of the last run, so that nothing it left in
+	// the registers or call stack is a GC root any more (MarkRoots scans only
+	// the live frames).  The stacks themselves are kept, for the next Reset.
+	public: void Idle();
+
 	// Stop the VM, recording that its code asked the host to exit and with what
 	// result code.  This is what the `exit` intrinsic calls; see ExitRequested
 	// above for why the state belongs to the VM rather than to the host.
@@ -312,6 +435,16 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// point of the call (typically vm.PC - 1 at the call site).
 	public: Value BuildStackTrace();
 
+	// Add the stack-trace entries for the callers recorded in call frames
+	// bottom..top-1, innermost first.
+	private: static void PushFrameTraces(Value result, List<CallInfo> frames, Int32 top, Int32 bottom);
+
+	// Add the stack-trace entry for one frame, stopped at the given PC.  If that
+	// PC is in the body of an inlined call, the frame stands for two: the
+	// inlined function (whose line the line table gives) and, below it, the
+	// caller at the line of the call.
+	private: static void PushTraceLines(Value result, FuncDef func, Int32 pc);
+
 	// Collect every function reachable from @main, by walking constant pools
 	// for funcref templates.  Used for disassembly and debug output.
 	public: List<FuncDef> GetFunctions();
@@ -325,7 +458,7 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// Returns 1 if the callee's first param is named "self" and we have pending context, else 0.
 	private: Int32 SelfParamOffset(FuncDef callee);
 
-	private: Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, List<UInt32> code);
+	private: Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, FuncDef caller);
 
 	// Apply pending self/super context to a callee's frame, if any.
 	// Called after SetupCallFrame to populate the callee's self/super registers.
@@ -358,6 +491,10 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 
 	public: Value Run(UInt32 maxCycles=0);
 
+	// Re-invoke the pending intrinsic continuation, if there is one.  Returns
+	// false if it is still not done.
+	private: Boolean FinishPendingCall();
+
 	private: Value RunInner(UInt32 maxCycles);
 
 	// Verify that the callee frame [baseIndex, baseIndex + neededRegs) fits within
@@ -366,7 +503,16 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// when this returns false, since RaiseRuntimeError does not stop the current
 	// opcode handler on its own.
 	private: bool EnsureFrame(Int32 baseIndex, UInt16 neededRegs);
-	void SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex, FuncDefStorage* &curFuncRaw, Int32 &codeCount, UInt32* &curCode, Value* &curConstants, Value* &localStack, Value* stackPtr);
+
+	// Make the register stack at least `needed` slots long, if that is within
+	// _stackSlotLimit (so this only ever grows a coroutine's).  It at least
+	// doubles, so a deepening recursion moves it only a few times; each move
+	// bumps _stackMoves.  Returns false if the limit is in the way.
+	private: bool GrowStack(Int32 needed);
+
+	// Likewise for the call stack, which nothing holds a pointer into.
+	private: bool GrowCallStack();
+	void SwitchFrame(const FuncDef& currentFunc, Int32 baseIndex, FuncDefStorage* &curFuncRaw, Int32 &codeCount, UInt32* &curCode, Value* &curConstants, Value* &localStack);
 
 	// Switch all frame-local execution state to the given function.
 
@@ -394,11 +540,19 @@ class VMStorage : public std::enable_shared_from_this<VMStorage> {
 	// back to LookupVariable, which handles every case.
 	private: Boolean GlobalFastPath();
 
+	// The slot the name of intrinsic idx has in _globals (made, unassigned, if
+	// the name has none yet), for CALLINTRINSIC to check that no global has
+	// taken the name.  Looked up once per intrinsic per namespace, as
+	// ResolveGlobalRef does for a function's references.
+	private: Int32 IntrinsicSlot(Int32 idx);
+
 	// A global reference whose slot is unassigned: either the name has never been
 	// bound, or it was removed.  Intrinsics deliberately do not occupy slots (so
 	// `globals.indexes` does not list 150 built-ins), so this is where they are
-	// found -- one never-taken branch on the hot path, and the same cost as the
-	// intrinsic step of LookupVariable when it is taken.
+	// found.  The name is looked up only the first time: the function remembers
+	// the intrinsic the reference resolved to (FuncDef.GlobalIntrinsics), so
+	// calling `len` in a loop costs the slot check and a list index per iteration
+	// rather than a string hash.
 	private: Value GlobalMiss(FuncDef func, Int32 refIdx);
 
 	// The `globals` map: an ordinary map whose entire storage is this VM's global
@@ -454,6 +608,12 @@ struct VM {
 	private: void set_callStackTop(Int32 _v);
 	private: Dictionary<String, Value> _intrinsics(); // intrinsic name -> FuncRef Value
 	private: void set__intrinsics(Dictionary<String, Value> _v); // intrinsic name -> FuncRef Value
+	private: List<FuncDef> _intrinsicDefs();
+	private: void set__intrinsicDefs(List<FuncDef> _v);
+	private: List<Int32> _intrinsicSlots();
+	private: void set__intrinsicSlots(List<Int32> _v);
+	private: Int32 _intrinsicSlotsId();
+	private: void set__intrinsicSlotsId(Int32 _v);
 	public: Int32 PC();
 	public: void set_PC(Int32 _v);
 	public: FuncDef CurrentFunction();
@@ -480,6 +640,10 @@ struct VM {
 	// callStackTop is the index of the next free slot (== current depth + 1).
 	// Invariant: callStackTop >= 1 during all execution (set up in Reset).
 
+	// Intrinsics by registry index, for CALLINTRINSIC; and the slot each one's
+	// name has in _globals, or -1 if not looked up yet (valid while
+	// _intrinsicSlotsId is _globals' Id; see IntrinsicSlot).
+
 	// Execution state (persistent across RunSteps calls)
 
 	// Set by the `exit` intrinsic: this run has asked its host to shut down,
@@ -550,6 +714,29 @@ struct VM {
 	private: void set__nativeFrameTop(Int32 _v);
 	public: bool yielding();
 	public: void set_yielding(bool _v);
+	public: double wakeTime();
+	public: void set_wakeTime(double _v);
+	public: Int32 coroutineStackSlots();
+	public: void set_coroutineStackSlots(Int32 _v);
+	public: Int32 coroutineCallSlots();
+	public: void set_coroutineCallSlots(Int32 _v);
+	private: List<Coroutine> _coroutines(); // those running now, innermost last
+	private: void set__coroutines(List<Coroutine> _v); // those running now, innermost last
+	private: List<Coroutine> _spareCoroutines(); // finished ones, whose stacks are reused
+	private: void set__spareCoroutines(List<Coroutine> _v); // finished ones, whose stacks are reused
+	private: Int32 _stackSlotLimit();
+	private: void set__stackSlotLimit(Int32 _v);
+	private: Int32 _callSlotLimit();
+	private: void set__callSlotLimit(Int32 _v);
+	private: Int32 _stackMoves();
+	private: void set__stackMoves(Int32 _v);
+	private: Int32 MaxSpareCoroutines();
+	private: FuncDef _coroutineExit(); // a bare RETURN, below each coroutine's function
+	private: void set__coroutineExit(FuncDef _v); // a bare RETURN, below each coroutine's function
+	private: Boolean _coroutineYielded(); // set by yield in a coroutine
+	private: void set__coroutineYielded(Boolean _v); // set by yield in a coroutine
+	private: Value _coroutineYieldValue();
+	private: void set__coroutineYieldValue(Value _v);
 
 	// Pending self/super for method calls, set by METHFIND/SETSELF,
 	// consumed by the next CALL instruction
@@ -579,9 +766,35 @@ struct VM {
 
 	// Set by the "yield" intrinsic; host app can check and clear this.
 
+	// While the "wait" intrinsic is pending: the ElapsedTime at which it is
+	// due to finish.  Nothing happens in the VM before then, so a host need
+	// not run it, and may sleep instead (see SecondsToWake).  Cleared before
+	// each call of an intrinsic's callback, so it only ever describes the
+	// pending call that set it (wait sets it again on every continuation).
+
+	// Coroutines (see Coroutine.cs and ResumeCoroutine).  Each has a register
+	// stack and call stack of its own.  They start much smaller than the VM's,
+	// so that thousands can be suspended at once, and grow as the coroutine
+	// goes deeper, up to the size of the VM's own (see GrowStack).
+
+	// The most registers and call frames any stack may have: the size the
+	// VM's own stacks are made at.  Only a coroutine's stacks are smaller.
+	// How many times a stack has grown, and so moved.  RunInner holds a pointer
+	// into the stack (localStack); when anything it calls out to may have run
+	// script code, it compares this with the count it last saw, and finds its
+	// frame again if they differ.
+
 	// Wall-clock start time, set in Reset(), used by the "time" intrinsic.
 	
 	public: inline double ElapsedTime();
+
+	// True when an intrinsic has said it is not done yet (receive on an empty
+	// channel, say), so the next Run will only call it again.
+	public: inline Boolean IsBlocked();
+
+	// Seconds until a pending wait is due to finish; 0 if the VM is not in a
+	// wait, or the wait is due now.
+	public: inline double SecondsToWake();
 	private: VM _activeVM();
 	private: void set__activeVM(VM _v);
 
@@ -617,9 +830,20 @@ struct VM {
 	// intrinsics from collection.
 	public: static void MarkRoots(object user_data) { return VMStorage::MarkRoots(user_data); }
 
+	// Mark the live registers (below liveTop) of a register stack, and what
+	// its call frames hold.
+	private: static void MarkFrames(List<Value> stack, List<Value> names, Int32 liveTop, List<CallInfo> callStack, Int32 callStackTop, FuncDef currentFunc) { return VMStorage::MarkFrames(stack, names, liveTop, callStack, callStackTop, currentFunc); }
+
+	private: static void MarkPendingCalls(List<PendingCallState> pending) { return VMStorage::MarkPendingCalls(pending); }
+
+	// Mark the execution state held in a Coroutine: its own, if suspended,
+	// or its resumer's, if running.  (A resumer is inside the resume call, so
+	// its live registers run up to the top of that call's frame.)
+	private: static void MarkCoroutine(Coroutine co) { return VMStorage::MarkCoroutine(co); }
+
 	// Mark a function's compile-time constants (used by the GC root scan).
 	// Recursion into nested-function templates happens via GCFunction.MarkChildren.
-	private: inline void MarkFuncConstants(FuncDef func);
+	private: static void MarkFuncConstants(FuncDef func) { return VMStorage::MarkFuncConstants(func); }
 
 	// Push a manually-constructed call to a set of compiled functions (used by import).
 	// The first function in importFunctions is treated as @main for the pushed call.
@@ -653,6 +877,67 @@ struct VM {
 	// defaults.  Returns the callee's result, or Value.Null on error (with the
 	// error surfaced on the outer run so RunUntilDone reports it).
 	public: inline Value RunFunction(Value funcRef, List<Value> args);
+	private: UInt32 CoroutineBatch();
+
+	// ── Coroutines ──────────────────────────────────────────────────────────
+	// A coroutine runs nested inside the resume call, much as RunFunction runs
+	// its function: ResumeCoroutine swaps the coroutine's registers, call
+	// stack and frame state into the VM (SwapCoroutine), drives RunInner until
+	// the coroutine yields or finishes, and swaps back.  Its function runs as
+	// an ordinary call at depth 1, over a bare RETURN (_coroutineExit) at
+	// depth 0 -- so when the function returns, RunInner ends just as it does
+	// at the end of @main.  A yield is an intrinsic that does not finish
+	// (YieldCoroutine): RunInner stops at once, and the value passed to the
+	// next resume is stored as its result.
+	// A coroutine that starts a wait, or runs for longer than a batch, also
+	// swaps out, and the resume call is left not done, so the interpreter
+	// waits (or takes its turn) as usual; the resume intrinsic's continuation
+	// then swaps it back in to carry on.  The exception is a resume made under
+	// RunFunction, which must finish before it returns: there, the coroutine
+	// simply runs until it yields or finishes.
+
+	// How many instructions a coroutine runs before it swaps out, letting the
+	// host see the time (see above).
+
+	// Make a new coroutine to run func, as a handle for scripts to hold.
+	public: static Value MakeCoroutine(Value func) { return VMStorage::MakeCoroutine(func); }
+
+	// The coroutine a handle made by MakeCoroutine stands for, or null if the
+	// value is not one.
+	public: static Coroutine GetCoroutine(Value v) { return VMStorage::GetCoroutine(v); }
+
+	public: static void MarkCoroutineHandle(object userData) { return VMStorage::MarkCoroutineHandle(userData); }
+
+	public: static void CoroutineFinalizer(object userData) { return VMStorage::CoroutineFinalizer(userData); }
+
+	// True while a coroutine is running (so yield means "back to the resumer").
+	public: inline Boolean InCoroutine();
+
+	// Stop the running coroutine, giving value to its resumer.  The yield
+	// intrinsic returns what this returns: a result that is not done, which
+	// stops RunInner straight after the call.
+	public: inline IntrinsicResult YieldCoroutine(Value value);
+
+	// Run a coroutine until it yields or finishes, and return what it yielded
+	// or returned.  value is the result of the yield it is suspended in -- or,
+	// when it first starts, its function's first argument (if not null).  The
+	// resume intrinsic passes continuing = true when it is re-invoked after a
+	// previous call was left not done (see above).
+	public: inline IntrinsicResult ResumeCoroutine(Coroutine co, Value value, Boolean continuing);
+
+	// Give a coroutine that has not run yet its stacks, and set up the call
+	// to its function (see above).  Returns false on error.
+	private: inline Boolean StartCoroutine(Coroutine co, Value value);
+
+	// Exchange the VM's registers, call stack and frame state with those
+	// held in a Coroutine (see Coroutine.cs).
+	private: inline void SwapCoroutine(Coroutine co);
+
+	// A coroutine has finished: let go of its stacks, or, if reuse, keep them
+	// for the next one to start (unless enough are kept already).  Reuse only
+	// those of one that returned normally, so that no frame's locals map
+	// still refers to its registers.
+	private: inline void ReleaseCoroutine(Coroutine co, Boolean reuse);
 
 	public: inline void Reset(List<FuncDef> allFunctions);
 
@@ -667,6 +952,11 @@ struct VM {
 
 	public: inline void Stop();
 
+	// Stop, and forget the frames of the last run, so that nothing it left in
+	// the registers or call stack is a GC root any more (MarkRoots scans only
+	// the live frames).  The stacks themselves are kept, for the next Reset.
+	public: inline void Idle();
+
 	// Stop the VM, recording that its code asked the host to exit and with what
 	// result code.  This is what the `exit` intrinsic calls; see ExitRequested
 	// above for why the state belongs to the VM rather than to the host.
@@ -713,6 +1003,16 @@ struct VM {
 	// point of the call (typically vm.PC - 1 at the call site).
 	public: inline Value BuildStackTrace();
 
+	// Add the stack-trace entries for the callers recorded in call frames
+	// bottom..top-1, innermost first.
+	private: static void PushFrameTraces(Value result, List<CallInfo> frames, Int32 top, Int32 bottom) { return VMStorage::PushFrameTraces(result, frames, top, bottom); }
+
+	// Add the stack-trace entry for one frame, stopped at the given PC.  If that
+	// PC is in the body of an inlined call, the frame stands for two: the
+	// inlined function (whose line the line table gives) and, below it, the
+	// caller at the line of the call.
+	private: static void PushTraceLines(Value result, FuncDef func, Int32 pc) { return VMStorage::PushTraceLines(result, func, pc); }
+
 	// Collect every function reachable from @main, by walking constant pools
 	// for funcref templates.  Used for disassembly and debug output.
 	public: inline List<FuncDef> GetFunctions();
@@ -726,7 +1026,7 @@ struct VM {
 	// Returns 1 if the callee's first param is named "self" and we have pending context, else 0.
 	private: inline Int32 SelfParamOffset(FuncDef callee);
 
-	private: inline Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, List<UInt32> code);
+	private: inline Int32 ProcessArguments(Int32 argCount, Int32 selfParam, Int32 startPC, Int32 callerBase, Int32 calleeBase, FuncDef callee, FuncDef caller);
 
 	// Apply pending self/super context to a callee's frame, if any.
 	// Called after SetupCallFrame to populate the callee's self/super registers.
@@ -759,6 +1059,10 @@ struct VM {
 
 	public: inline Value Run(UInt32 maxCycles=0);
 
+	// Re-invoke the pending intrinsic continuation, if there is one.  Returns
+	// false if it is still not done.
+	private: inline Boolean FinishPendingCall();
+
 	private: inline Value RunInner(UInt32 maxCycles);
 
 	// Verify that the callee frame [baseIndex, baseIndex + neededRegs) fits within
@@ -768,6 +1072,15 @@ struct VM {
 	// opcode handler on its own.
 	private: inline bool EnsureFrame(Int32 baseIndex, UInt16 neededRegs);
 
+	// Make the register stack at least `needed` slots long, if that is within
+	// _stackSlotLimit (so this only ever grows a coroutine's).  It at least
+	// doubles, so a deepening recursion moves it only a few times; each move
+	// bumps _stackMoves.  Returns false if the limit is in the way.
+	private: inline bool GrowStack(Int32 needed);
+
+	// Likewise for the call stack, which nothing holds a pointer into.
+	private: inline bool GrowCallStack();
+
 	// Switch all frame-local execution state to the given function.
 
 	// ── Global-reference resolution (GLOADC / GLOADV / GSTORE) ────────────────
@@ -794,11 +1107,19 @@ struct VM {
 	// back to LookupVariable, which handles every case.
 	private: inline Boolean GlobalFastPath();
 
+	// The slot the name of intrinsic idx has in _globals (made, unassigned, if
+	// the name has none yet), for CALLINTRINSIC to check that no global has
+	// taken the name.  Looked up once per intrinsic per namespace, as
+	// ResolveGlobalRef does for a function's references.
+	private: inline Int32 IntrinsicSlot(Int32 idx);
+
 	// A global reference whose slot is unassigned: either the name has never been
 	// bound, or it was removed.  Intrinsics deliberately do not occupy slots (so
 	// `globals.indexes` does not list 150 built-ins), so this is where they are
-	// found -- one never-taken branch on the hot path, and the same cost as the
-	// intrinsic step of LookupVariable when it is taken.
+	// found.  The name is looked up only the first time: the function remembers
+	// the intrinsic the reference resolved to (FuncDef.GlobalIntrinsics), so
+	// calling `len` in a loop costs the slot check and a list index per iteration
+	// rather than a string hash.
 	private: inline Value GlobalMiss(FuncDef func, Int32 refIdx);
 
 	// The `globals` map: an ordinary map whose entire storage is this VM's global
@@ -837,6 +1158,12 @@ inline Int32 VM::callStackTop() { return get()->callStackTop; }
 inline void VM::set_callStackTop(Int32 _v) { get()->callStackTop = _v; }
 inline Dictionary<String, Value> VM::_intrinsics() { return get()->_intrinsics; } // intrinsic name -> FuncRef Value
 inline void VM::set__intrinsics(Dictionary<String, Value> _v) { get()->_intrinsics = _v; } // intrinsic name -> FuncRef Value
+inline List<FuncDef> VM::_intrinsicDefs() { return get()->_intrinsicDefs; }
+inline void VM::set__intrinsicDefs(List<FuncDef> _v) { get()->_intrinsicDefs = _v; }
+inline List<Int32> VM::_intrinsicSlots() { return get()->_intrinsicSlots; }
+inline void VM::set__intrinsicSlots(List<Int32> _v) { get()->_intrinsicSlots = _v; }
+inline Int32 VM::_intrinsicSlotsId() { return get()->_intrinsicSlotsId; }
+inline void VM::set__intrinsicSlotsId(Int32 _v) { get()->_intrinsicSlotsId = _v; }
 inline Int32 VM::PC() { return get()->PC; }
 inline void VM::set_PC(Int32 _v) { get()->PC = _v; }
 inline FuncDef VM::CurrentFunction() { return get()->CurrentFunction; }
@@ -889,7 +1216,32 @@ inline Int32 VM::_nativeFrameTop() { return get()->_nativeFrameTop; }
 inline void VM::set__nativeFrameTop(Int32 _v) { get()->_nativeFrameTop = _v; }
 inline bool VM::yielding() { return get()->yielding; }
 inline void VM::set_yielding(bool _v) { get()->yielding = _v; }
+inline double VM::wakeTime() { return get()->wakeTime; }
+inline void VM::set_wakeTime(double _v) { get()->wakeTime = _v; }
+inline Int32 VM::coroutineStackSlots() { return get()->coroutineStackSlots; }
+inline void VM::set_coroutineStackSlots(Int32 _v) { get()->coroutineStackSlots = _v; }
+inline Int32 VM::coroutineCallSlots() { return get()->coroutineCallSlots; }
+inline void VM::set_coroutineCallSlots(Int32 _v) { get()->coroutineCallSlots = _v; }
+inline List<Coroutine> VM::_coroutines() { return get()->_coroutines; } // those running now, innermost last
+inline void VM::set__coroutines(List<Coroutine> _v) { get()->_coroutines = _v; } // those running now, innermost last
+inline List<Coroutine> VM::_spareCoroutines() { return get()->_spareCoroutines; } // finished ones, whose stacks are reused
+inline void VM::set__spareCoroutines(List<Coroutine> _v) { get()->_spareCoroutines = _v; } // finished ones, whose stacks are reused
+inline Int32 VM::_stackSlotLimit() { return get()->_stackSlotLimit; }
+inline void VM::set__stackSlotLimit(Int32 _v) { get()->_stackSlotLimit = _v; }
+inline Int32 VM::_callSlotLimit() { return get()->_callSlotLimit; }
+inline void VM::set__callSlotLimit(Int32 _v) { get()->_callSlotLimit = _v; }
+inline Int32 VM::_stackMoves() { return get()->_stackMoves; }
+inline void VM::set__stackMoves(Int32 _v) { get()->_stackMoves = _v; }
+inline Int32 VM::MaxSpareCoroutines() { return get()->MaxSpareCoroutines; }
+inline FuncDef VM::_coroutineExit() { return get()->_coroutineExit; } // a bare RETURN, below each coroutine's function
+inline void VM::set__coroutineExit(FuncDef _v) { get()->_coroutineExit = _v; } // a bare RETURN, below each coroutine's function
+inline Boolean VM::_coroutineYielded() { return get()->_coroutineYielded; } // set by yield in a coroutine
+inline void VM::set__coroutineYielded(Boolean _v) { get()->_coroutineYielded = _v; } // set by yield in a coroutine
+inline Value VM::_coroutineYieldValue() { return get()->_coroutineYieldValue; }
+inline void VM::set__coroutineYieldValue(Value _v) { get()->_coroutineYieldValue = _v; }
 inline double VM::ElapsedTime() { return get()->ElapsedTime(); }
+inline Boolean VM::IsBlocked() { return get()->IsBlocked(); }
+inline double VM::SecondsToWake() { return get()->SecondsToWake(); }
 inline VM VM::_activeVM() { return get()->_activeVM; }
 inline void VM::set__activeVM(VM _v) { get()->_activeVM = _v; }
 inline Int32 VM::StackSize() { return get()->StackSize(); }
@@ -902,13 +1254,20 @@ inline CallInfo VM::GetCallStackFrame(Int32 index) { return get()->GetCallStackF
 inline String VM::FindShortName(Value v) { return get()->FindShortName(v); }
 inline void VM::InitVM(Int32 stackSlots,Int32 callSlots) { return get()->InitVM(stackSlots, callSlots); }
 inline void VM::CleanupVM() { return get()->CleanupVM(); }
-inline void VM::MarkFuncConstants(FuncDef func) { return get()->MarkFuncConstants(func); }
 inline void VM::ManuallyPushCall(Int32 intrinsicCalleeBase,FuncDef importMain) { return get()->ManuallyPushCall(intrinsicCalleeBase, importMain); }
 inline void VM::SetVar(String varName,Value value) { return get()->SetVar(varName, value); }
 inline Value VM::RunFunction(Value funcRef,List<Value> args) { return get()->RunFunction(funcRef, args); }
+inline UInt32 VM::CoroutineBatch() { return get()->CoroutineBatch; }
+inline Boolean VM::InCoroutine() { return get()->InCoroutine(); }
+inline IntrinsicResult VM::YieldCoroutine(Value value) { return get()->YieldCoroutine(value); }
+inline IntrinsicResult VM::ResumeCoroutine(Coroutine co,Value value,Boolean continuing) { return get()->ResumeCoroutine(co, value, continuing); }
+inline Boolean VM::StartCoroutine(Coroutine co,Value value) { return get()->StartCoroutine(co, value); }
+inline void VM::SwapCoroutine(Coroutine co) { return get()->SwapCoroutine(co); }
+inline void VM::ReleaseCoroutine(Coroutine co,Boolean reuse) { return get()->ReleaseCoroutine(co, reuse); }
 inline void VM::Reset(List<FuncDef> allFunctions) { return get()->Reset(allFunctions); }
 inline void VM::Reset(List<FuncDef> allFunctions,Globals globals) { return get()->Reset(allFunctions, globals); }
 inline void VM::Stop() { return get()->Stop(); }
+inline void VM::Idle() { return get()->Idle(); }
 inline void VM::RequestExit(Int32 resultCode) { return get()->RequestExit(resultCode); }
 inline void VM::RaiseRuntimeError(String message) { return get()->RaiseRuntimeError(message); }
 inline void VM::FinalizeErrorStackTrace() { return get()->FinalizeErrorStackTrace(); }
@@ -920,7 +1279,7 @@ inline bool VM::ReportRuntimeError() { return get()->ReportRuntimeError(); }
 inline Value VM::BuildStackTrace() { return get()->BuildStackTrace(); }
 inline List<FuncDef> VM::GetFunctions() { return get()->GetFunctions(); }
 inline Int32 VM::SelfParamOffset(FuncDef callee) { return get()->SelfParamOffset(callee); }
-inline Int32 VM::ProcessArguments(Int32 argCount,Int32 selfParam,Int32 startPC,Int32 callerBase,Int32 calleeBase,FuncDef callee,List<UInt32> code) { return get()->ProcessArguments(argCount, selfParam, startPC, callerBase, calleeBase, callee, code); }
+inline Int32 VM::ProcessArguments(Int32 argCount,Int32 selfParam,Int32 startPC,Int32 callerBase,Int32 calleeBase,FuncDef callee,FuncDef caller) { return get()->ProcessArguments(argCount, selfParam, startPC, callerBase, calleeBase, callee, caller); }
 inline void VM::ApplyPendingContext(Int32 calleeBase,FuncDef callee) { return get()->ApplyPendingContext(calleeBase, callee); }
 inline void VM::SetupCallFrame(Int32 argCount,Int32 selfParam,Int32 calleeBase,FuncDef callee) { return get()->SetupCallFrame(argCount, selfParam, calleeBase, callee); }
 inline Int32 VM::AutoInvokeFuncRef(Value funcRefVal,Int32 resultReg,Int32 returnPC,Int32 baseIndex,FuncDef currentFunc,FuncDef* calleeOut) { return get()->AutoInvokeFuncRef(funcRefVal, resultReg, returnPC, baseIndex, currentFunc, calleeOut); }
@@ -928,15 +1287,18 @@ inline bool VM::InvokeNativeCallback(NativeCallbackDelegate callback,FuncDef cal
 inline Value VM::Execute(FuncDef entry) { return get()->Execute(entry); }
 inline Value VM::Execute(FuncDef entry,UInt32 maxCycles) { return get()->Execute(entry, maxCycles); }
 inline Value VM::Run(UInt32 maxCycles) { return get()->Run(maxCycles); }
+inline Boolean VM::FinishPendingCall() { return get()->FinishPendingCall(); }
 inline Value VM::RunInner(UInt32 maxCycles) { return get()->RunInner(maxCycles); }
 inline bool VM::EnsureFrame(Int32 baseIndex,UInt16 neededRegs) { return get()->EnsureFrame(baseIndex, neededRegs); }
 inline bool VMStorage::EnsureFrame(Int32 baseIndex,UInt16 neededRegs) {
-	if (baseIndex + neededRegs > stack.Count()) {
+	if (baseIndex + neededRegs > stack.Count() && !GrowStack(baseIndex + neededRegs)) {
 		RaiseRuntimeError("Stack Overflow");
 		return Boolean(false);
 	}
 	return Boolean(true);
 }
+inline bool VM::GrowStack(Int32 needed) { return get()->GrowStack(needed); }
+inline bool VM::GrowCallStack() { return get()->GrowCallStack(); }
 inline Int32 VM::ResolveGlobalRef(FuncDef func,Int32 refIdx) { return get()->ResolveGlobalRef(func, refIdx); }
 inline Boolean VM::GlobalFastPath() { return get()->GlobalFastPath(); }
 inline Boolean VMStorage::GlobalFastPath() {
@@ -945,6 +1307,7 @@ inline Boolean VMStorage::GlobalFastPath() {
 	if (frame.OuterVarMap.IsNull()) return Boolean(true);
 	return frame.OuterVarMap.RefEquals(_globals.AsMap());
 }
+inline Int32 VM::IntrinsicSlot(Int32 idx) { return get()->IntrinsicSlot(idx); }
 inline Value VM::GlobalMiss(FuncDef func,Int32 refIdx) { return get()->GlobalMiss(func, refIdx); }
 inline Value VM::GetGlobalsVarMap() { return get()->GetGlobalsVarMap(); }
 inline Value VM::GetCurrentLocalVarMap(Int32 baseIndex,UInt16 maxRegs) { return get()->GetCurrentLocalVarMap(baseIndex, maxRegs); }
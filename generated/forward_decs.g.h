@@ -1,6 +1,10 @@
 // FORWARD DECLARATIONS
 
 namespace MiniScript {
+struct ByteWriter;
+class ByteWriterStorage;
+struct ByteReader;
+class ByteReaderStorage;
 struct CodeGenerator;
 class CodeGeneratorStorage;
 struct CallInfo;
@@ -85,6 +89,8 @@ struct GCFunction;
 struct GCHandle;
 struct Interpreter;
 class InterpreterStorage;
+struct InterpreterPool;
+class InterpreterPoolStorage;
 struct FuncDef;
 class FuncDefStorage;
 struct ASTNode;
@@ -143,9 +149,23 @@ struct ScopeNode;
 class ScopeNodeStorage;
 struct ReturnNode;
 class ReturnNodeStorage;
+struct InlineCandidate;
+class InlineCandidateStorage;
 struct App;
 struct VarMapBacking;
 class VarMapBackingStorage;
 struct Token;
 struct Lexer;
+struct ChannelMessage;
+class ChannelMessageStorage;
+struct Channel;
+class ChannelStorage;
+struct IsolateFunction;
+class IsolateFunctionStorage;
+struct ParallelJob;
+class ParallelJobStorage;
+struct Scheduler;
+class SchedulerStorage;
+struct Coroutine;
+class CoroutineStorage;
 }
@@ -84,11 +84,16 @@ EXPECTED_RECUR_FIB="3524578"              # fib(33)
 EXPECTED_GLOBAL_LOOP="21534"              # see tools/benchmarks/global_loop.ms
 EXPECTED_GLOBAL_CHURN="160238"            # see tools/benchmarks/global_churn.ms
 EXPECTED_GLOBAL_FROM_FN="21000000"        # see tools/benchmarks/global_from_fn.ms
+EXPECTED_REPL_EVAL="86"                   # see tools/benchmarks/repl_eval.ms
+
+# How many times the "repl" kind feeds its file to the REPL.
+REPL_REPEATS=30000
 
 # Benchmark definitions: file:Name:expected[:kinds]
 #   kinds  "all" (default, when the field is absent) runs both the .msa and the
 #          .ms form; "src" runs only the .ms form, for benchmarks that have no
-#          hand-written assembly counterpart.
+#          hand-written assembly counterpart; "repl" feeds the .ms file to the
+#          REPL on stdin REPL_REPEATS times, MS2 builds only.
 BENCHMARKS=(
     "factorial_iterative:Iterative Factorial:unused"
     "iter_fib:Iterative Fibonacci:$EXPECTED_ITER_FIB"
@@ -97,11 +102,22 @@ BENCHMARKS=(
     "global_loop_fn:Global Loop (locals):$EXPECTED_GLOBAL_LOOP:src"
     "global_churn:Global Churn:$EXPECTED_GLOBAL_CHURN:src"
     "global_from_fn:Globals From Function:$EXPECTED_GLOBAL_FROM_FN:src"
+    "repl_eval:REPL Evaluation:$EXPECTED_REPL_EVAL:repl"
 )
 
 # True if this benchmark has an assembly (.msa) form.
 has_asm() {
-    [[ "$1" != "src" ]]
+    [[ "$1" != "src" && "$1" != "repl" ]]
+}
+
+# True if this benchmark only runs through the MS2 REPL (see "repl" above).
+is_repl() {
+    [[ "$1" == "repl" ]]
+}
+
+# The run_benchmark extension for an MS2 source run: "repl" or "ms".
+src_ext() {
+    if is_repl "$1"; then echo "repl"; else echo "ms"; fi
 }
 
 # Render a timing for the summary table: "1.23s", or "-" for a skipped cell.
@@ -124,7 +140,19 @@ run_benchmark() {
     local benchmark_path="tools/benchmarks/$benchmark_file.$file_ext"
 
     # Run benchmark and capture timing and result
-    if [[ "$build_type" == "dotnet" ]]; then
+    if [[ "$file_ext" == "repl" ]]; then
+        # Feed the source to the REPL on stdin, many times over; the result is
+        # the last implicit output ("_out[N]: value").
+        local input="build/$benchmark_file.repl-input"
+        local source
+        source=$(grep -v '^//' "tools/benchmarks/$benchmark_file.ms")
+        for ((r = 0; r < REPL_REPEATS; r++)); do printf '%s\n' "$source"; done > "$input"
+        local cmd=("$executable" -q)
+        if [[ "$build_type" == "dotnet" ]]; then cmd=(dotnet "$executable" -q); fi
+        TIME_OUTPUT=$(time ("${cmd[@]}" < "$input" > /dev/null 2>&1) 2>&1)
+        RESULT=$("${cmd[@]}" < "$input" 2>/dev/null | sed 's/\x1b\[[0-9;]*m//g' | grep "_out\[" | tail -1 | sed 's/^.*\]: //')
+        rm -f "$input"
+    elif [[ "$build_type" == "dotnet" ]]; then
         TIME_OUTPUT=$(time (dotnet "$executable" "$benchmark_path" 2>/dev/null) 2>&1)
         RESULT=$(dotnet "$executable" "$benchmark_path" 2>/dev/null | grep -m1 "Result in r0:" -A1 | tail -1 | sed 's/\x1b\[[0-9;]*m//g')
     else
@@ -195,7 +223,7 @@ if should_run_language "cs"; then
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
 
         echo -e "${BLUE}  $name...${NC}"
-        cs_time=$(run_benchmark "$file" "$name" "$expected" "dotnet" "build/cs/miniscript2.dll" "ms")
+        cs_time=$(run_benchmark "$file" "$name" "$expected" "dotnet" "build/cs/miniscript2.dll" "$(src_ext "$kinds")")
         CS_SRC_TIMES+=("$cs_time")
     done
     echo ""
@@ -226,7 +254,7 @@ if should_run_language "cpp-switch"; then
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
 
         echo -e "${BLUE}  $name...${NC}"
-        t=$(run_benchmark "$file" "$name" "$expected" "direct" "build/cpp/miniscript2" "ms")
+        t=$(run_benchmark "$file" "$name" "$expected" "direct" "build/cpp/miniscript2" "$(src_ext "$kinds")")
         CPP_SWITCH_SRC_TIMES+=("$t")
     done
     echo ""
@@ -257,7 +285,7 @@ if should_run_language "cpp-goto" || should_run_language "msa"; then
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
 
         echo -e "${BLUE}  $name...${NC}"
-        t=$(run_benchmark "$file" "$name" "$expected" "direct" "build/cpp/miniscript2" "ms")
+        t=$(run_benchmark "$file" "$name" "$expected" "direct" "build/cpp/miniscript2" "$(src_ext "$kinds")")
         CPP_GOTO_SRC_TIMES+=("$t")
     done
     echo ""
@@ -269,6 +297,7 @@ if should_run_language "ms1"; then
     for i in "${!BENCHMARKS[@]}"; do
         benchmark_def="${BENCHMARKS[i]}"
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
+        if is_repl "$kinds"; then MS1_TIMES+=("-"); continue; fi
 
         echo -e "${BLUE}  $name...${NC}"
         t=$(run_benchmark "$file" "$name" "$expected" "direct" "miniscript" "ms")
@@ -283,6 +312,7 @@ if should_run_language "python"; then
     for i in "${!BENCHMARKS[@]}"; do
         benchmark_def="${BENCHMARKS[i]}"
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
+        if is_repl "$kinds"; then PY_TIMES+=("-"); continue; fi
 
         echo -e "${BLUE}  $name...${NC}"
         t=$(run_benchmark "$file" "$name" "$expected" "direct" "python" "py")
@@ -297,6 +327,7 @@ if should_run_language "lua"; then
     for i in "${!BENCHMARKS[@]}"; do
         benchmark_def="${BENCHMARKS[i]}"
         IFS=':' read -r file name expected kinds <<< "$benchmark_def"
+        if is_repl "$kinds"; then LUA_TIMES+=("-"); continue; fi
 
         echo -e "${BLUE}  $name...${NC}"
         t=$(run_benchmark "$file" "$name" "$expected" "direct" "lua" "lua")